@@ -20,6 +20,8 @@
 
 // APPLICATION INCLUDES
 #include <os/OsMsgDispatcher.h>
+#include <os/OsMutex.h>
+#include <utl/UtlHashMap.h>
 #include <cp/CpCallManager.h>
 #include <cp/Connection.h>
 #include <mi/CpMediaInterfaceFactoryImpl.h>
@@ -39,6 +41,9 @@
 #endif
 
 #define CP_CALL_HISTORY_LENGTH 50
+// Maximum number of calls sharing a Call-ID that are resolved through the
+// Call-ID index; beyond that findHandlingCall() falls back to scanning.
+#define CP_MAX_CALLS_PER_CALL_ID 8
 
 #define CP_MAXIMUM_RINGING_EXPIRE_SECONDS 180
 // MACROS
@@ -423,6 +428,7 @@ public:
    int getTotalNumberIncomingCalls() { return mnTotalIncomingCalls;}
 
    virtual void onCallDestroy(CpCall* pCall);
+   virtual void onCallIdAdded(CpCall* pCall, const char* callId);
    virtual void yieldFocus(CpCall* call);
 
 /* //////////////////////////// PROTECTED ///////////////////////////////// */
@@ -470,6 +476,19 @@ private:
     CpMediaInterfaceFactory* mpMediaFactory;
     OsMsgDispatcher mDispatcher;
 
+    // Index of the calls in infocusCall and callStack, so that messages can
+    // be dispatched without asking every call whether it handles them.
+    // Entries are only ever added while a call is indexed, so a Call-ID
+    // that is not in mCallIdIndex is not known to any call.  An entry may
+    // be stale (e.g. the connection has since gone), so hits are still
+    // checked with CpCall::hasCallId()/willHandleMessage().
+    // mCallIndexMutex is only held while touching the maps, never while
+    // calling into a call, as calls update the index from their own tasks.
+    OsMutex mCallIndexMutex;
+    UtlHashMap mCallIdIndex;     // Call-ID -> UtlSList of UtlVoidPtr(CpCall*)
+    UtlHashMap mIndexedCalls;    // UtlVoidPtr(CpCall*) -> UtlSList of Call-IDs
+    UtlHashMap mCallsByIndex;    // UtlInt(call index) -> UtlVoidPtr(CpCall*)
+
     // Private accessors
     void pushCall(CpCall* call);
     CpCall* popCall();
@@ -480,6 +499,12 @@ private:
     CpCall* findHandlingCall(int callIndex);
     CpCall* findHandlingCall(const OsMsg& eventMessage);
     CpCall* findFirstQueuedCall();
+    void indexCall(CpCall* call);
+    void unindexCall(CpCall* call);
+    void addCallIdToIndex(CpCall* call, const char* callId);
+    int findIndexedCalls(const char* callId, CpCall* calls[], int numCalls,
+                         int maxCalls);
+    void sortByCallStackOrder(CpCall* calls[], int numCalls);
     void getCodecs(int& numCodecs, SdpCodec**& codecArray);
     void addHistoryEvent(const char* messageLogString);
 
@@ -163,6 +163,10 @@ public:
     virtual void setCallId(const char* callId);
     //: Sets the main call Id for this call
 
+    virtual void getCallIds(UtlSList& callIds);
+    //: Appends (as UtlStrings) all of the call Ids for which hasCallId is true
+    // Note: the caller must destroy the entries appended to callIds
+
     void setLocalConnectionState(int newState);
     //: Sets the local connection state for this call
 
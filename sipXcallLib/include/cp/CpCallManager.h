@@ -788,6 +788,9 @@ public:
 /* ============================ INQUIRY =================================== */
 
     virtual void onCallDestroy(CpCall* pCall) = 0;
+
+    /// Called by a call (or one of its connections) when it gains a Call-ID
+    virtual void onCallIdAdded(CpCall* pCall, const char* callId) = 0;
     
    virtual void yieldFocus(CpCall* call) = 0;
     
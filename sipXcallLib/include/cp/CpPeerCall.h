@@ -158,6 +158,9 @@ public:
 
     virtual void printCall();
 
+    virtual void getCallIds(UtlSList& callIds);
+    //: Appends the main call Id and the call Ids of all connections
+
     virtual void getLocalAddress(char* address, int len);
 
     virtual void getLocalTerminalId(char* terminal, int len);
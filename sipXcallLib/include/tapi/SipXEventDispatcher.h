@@ -25,11 +25,14 @@
 // CONSTANTS
 // STRUCTS
 // TYPEDEFS
+class SipXEventListenerTask ;
+
 typedef struct
 {   
     SIPX_INST                   hInst ;
     SIPX_EVENT_CALLBACK_PROC    pCallbackProc ;
     void*                       pUserData ;
+    SipXEventListenerTask*      pQueueTask ;    /**< Own queue and thread, or NULL */
 } SIPX_EVENT_LISTENER_CONTEXT ;
 
 // MACROS
@@ -37,6 +40,56 @@ typedef struct
 // FORWARD DECLARATIONS
 class OsEventMsg ;
 
+/**
+ * The SipXEventListenerTask delivers events to one listener from a queue of
+ * its own, so that a listener which is slow to return from its callback
+ * does not hold up the events of other listeners.  Events are posted as
+ * copies made by sipxDuplicateEvent, which the task frees once delivered
+ * or dropped.
+ */
+class SipXEventListenerTask : public OsServerTask
+{
+public:
+/* ============================ CREATORS ================================== */
+
+    SipXEventListenerTask(SIPX_EVENT_LISTENER_CONTEXT* pContext,
+                          int                          queueSize,
+                          SIPX_EVENT_OVERFLOW_POLICY   policy) ;
+
+    /**
+     * Stops the task.  Events still in the queue are freed, not delivered.
+     */
+    virtual ~SipXEventListenerTask(void) ;
+
+/* ============================ MANIPULATORS ============================== */
+
+    /**
+     * Implementation of OsServerTask's pure virtual method
+     */
+    UtlBoolean handleMessage(OsMsg& rMsg) ;
+
+    /**
+     * Queue a copy of an event, applying the overflow policy if the queue
+     * is full.  The task owns pEventCopy from now on.
+     */
+    void postEvent(SIPX_EVENT_CATEGORY category, void* pEventCopy) ;
+
+/* ============================ ACCESSORS ================================= */
+
+    /**
+     * Number of events dropped because the queue was full.
+     */
+    int getDroppedEvents() ;
+
+private:
+    void dropEvent(OsMsg* pMsg) ;
+
+    SIPX_EVENT_LISTENER_CONTEXT* mpContext ;
+    SIPX_EVENT_OVERFLOW_POLICY   mPolicy ;
+    int                          mDroppedEvents ;
+    OsMutex                      mDropLock ;    /**< Serializes dropping and mDroppedEvents */
+};
+
 /**
  * The SipXEventDispatcher adds a listener to sipXtapi and then redispatches
  * all of the sipXtapi events on its own callback.  Ideally, this should be 
@@ -88,15 +141,40 @@ public:
 
     void setInstanceHandle(SIPX_INST hNew) ;
 
+    /**
+     * Give each listener a queue and a thread of its own (queueSize > 0) or
+     * call all listeners from this task (queueSize == 0).
+     */
+    void setListenerQueues(int queueSize, SIPX_EVENT_OVERFLOW_POLICY policy) ;
+
+    /**
+     * Number of events the listener's queue dropped, -1 if there is no
+     * such listener.
+     */
+    int getDroppedEvents(SIPX_EVENT_CALLBACK_PROC  pCallbackProc,
+                         void*                     pUserData) ;
+
+    /**
+     * Call the callback of a listener, logging it if it is slow to return.
+     */
+    static void invokeListener(SIPX_EVENT_LISTENER_CONTEXT* pContext,
+                               SIPX_EVENT_CATEGORY          category,
+                               void*                        pInfo) ;
+
 protected:
     static bool SIPX_CALLING_CONVENTION EventCallBack(SIPX_EVENT_CATEGORY category, 
                                                       void*               pInfo, 
                                                       void*               pUserData);
         
 private:
+    void startListenerQueue(SIPX_EVENT_LISTENER_CONTEXT* pContext) ;
+    void stopListenerQueue(SIPX_EVENT_LISTENER_CONTEXT* pContext) ;
+
     SIPX_INST  mhInst ;
     UtlHashMap mListeners ;
     OsRWMutex  mListenerLock;
+    int        mListenerQueueSize ;     /**< 0 if listeners have no queues */
+    SIPX_EVENT_OVERFLOW_POLICY mOverflowPolicy ;
 };
 
 #endif // _SIPXEVENTDISPATCHER_H_
@@ -837,6 +837,21 @@ typedef enum SIPX_SUBSCRIPTION_CAUSE
     SUBSCRIPTION_CAUSE_NORMAL     /**< Normal cause for state change. */
 } SIPX_SUBSCRIPTION_CAUSE;
 
+/**
+ * What to do with an event for a listener whose event queue is full.
+ *
+ * @see sipxEventListenerSetQueues
+ */
+typedef enum SIPX_EVENT_OVERFLOW_POLICY
+{
+    EVENT_OVERFLOW_BLOCK,           /**< Wait until the listener takes an event from
+                                         its queue.  Nothing is dropped, but events
+                                         for all listeners wait as well. */
+    EVENT_OVERFLOW_DROP_NEWEST,     /**< Drop the new event for this listener. */
+    EVENT_OVERFLOW_DROP_OLDEST      /**< Drop the oldest event waiting in the queue
+                                         of this listener to make room. */
+} SIPX_EVENT_OVERFLOW_POLICY;
+
 /**
  * An SUBSTATUS event informs that application layer of the status
  * of an outbound SUBSCRIPTION requests;
@@ -991,6 +1006,49 @@ SIPXTAPI_API SIPX_RESULT sipxEventListenerRemove(const SIPX_INST hInst,
                                                  SIPX_EVENT_CALLBACK_PROC pCallbackProc, 
                                                  void* pUserData) ;
 
+/**
+ * Deliver the events of an instance to each listener on its own thread.
+ * 
+ * By default the callbacks of all listeners of an instance are called one
+ * after the other on one dispatch thread, so a listener which is slow to
+ * return delays the events of all others, and once the events pile up,
+ * the sipXtapi threads which fire them.  With listener queues, every
+ * listener gets a copy of each event on a queue of its own, served by a
+ * thread of its own.  When a queue is full, the overflow policy decides
+ * what happens to the event.  Events dropped by a listener queue are
+ * counted, see sipxEventListenerGetDroppedEvents.
+ * 
+ * Listeners whose events may be dropped must not rely on seeing every
+ * event of a call or line (e.g. CALLSTATE_DESTROYED).
+ * 
+ * The setting applies to the listeners already added and to the ones added
+ * later.  Events waiting in the queues when it is changed are not delivered.
+ *
+ * @param hInst Instance pointer obtained by sipxInitialize.
+ * @param queueSize Maximum number of events waiting for each listener, or
+ *        0 to deliver all events on the single dispatch thread again.
+ * @param policy What to do with an event for a listener whose queue is full.
+ */
+SIPXTAPI_API SIPX_RESULT sipxEventListenerSetQueues(const SIPX_INST hInst,
+                                                    int queueSize,
+                                                    SIPX_EVENT_OVERFLOW_POLICY policy) ;
+
+/**
+ * Get the number of events dropped for a listener because its queue was
+ * full.  Supply the same pCallbackProc and pUserData values as 
+ * sipxEventListenerAdd.
+ *
+ * @param hInst Instance pointer obtained by sipxInitialize.
+ * @param pCallbackProc Function used to receive sipx events
+ * @param pUserData user data specified as part of sipxListenerAdd
+ * @param pDroppedEvents Number of events dropped since the listener queue
+ *        was created.  0 if the listener has no queue.
+ */
+SIPXTAPI_API SIPX_RESULT sipxEventListenerGetDroppedEvents(const SIPX_INST hInst,
+                                                           SIPX_EVENT_CALLBACK_PROC pCallbackProc,
+                                                           void* pUserData,
+                                                           int* pDroppedEvents) ;
+
 /* ============================ FUNCTIONS ================================= */
 
 /**
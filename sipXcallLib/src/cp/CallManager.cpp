@@ -34,12 +34,15 @@
 #include <cp/Connection.h>
 #include <mi/CpMediaInterfaceFactory.h>
 #include <utl/UtlRegex.h>
+#include <utl/UtlInt.h>
+#include <utl/UtlVoidPtr.h>
 #include <os/OsUtil.h>
 #include <os/OsConfigDb.h>
 #include <os/OsEventMsg.h>
 #include <os/OsTimer.h>
 #include <os/OsQueuedEvent.h>
 #include <os/OsEvent.h>
+#include <os/OsLock.h>
 #include <os/OsReadLock.h>
 #include <os/OsWriteLock.h>
 #include <utl/UtlNameValueTokenizer.h>
@@ -118,6 +121,7 @@ CallManager::CallManager(UtlBoolean isRequredUserIdMatch,
 , mIsEarlyMediaFor180(TRUE)
 , mpMediaFactory(NULL)
 , mDispatcher(&mIncomingQ) // Dispatch to this CallManagers message queue
+, mCallIndexMutex(OsMutex::Q_FIFO)
 {
     OsStackTraceLogger(FAC_CP, PRI_DEBUG, "CallManager");
 
@@ -275,7 +279,8 @@ CallManager::CallManager(UtlBoolean isRequredUserIdMatch,
 
 // Copy constructor
 CallManager::CallManager(const CallManager& rCallManager) :
-CpCallManager("CallManager-%d", "call")
+CpCallManager("CallManager-%d", "call"),
+mCallIndexMutex(OsMutex::Q_FIFO)
 {
 }
 
@@ -290,6 +295,11 @@ CallManager::~CallManager()
 
     waitUntilShutDown();   
 
+    // The calls have removed themselves from the index as they were deleted
+    mCallIdIndex.destroyAll();
+    mIndexedCalls.destroyAll();
+    mCallsByIndex.destroyAll();
+
     // do not delete the codecFactory it is not owned here
 
 }
@@ -539,6 +549,7 @@ UtlBoolean CallManager::handleMessage(OsMsg& eventMessage)
 
                 mCallListMutex.acquireWrite() ;                                                
                 releaseCallIndex(call->getCallIndex());
+                unindexCall(call);
                 if(infocusCall == call)
                 {
                     // The infocus call is not in the mCallList -- no need to 
@@ -3454,6 +3465,7 @@ UtlBoolean CallManager::changeCallFocus(CpCall* callToTakeFocus)
 void CallManager::pushCall(CpCall* call)
 {
     callStack.insertAt(0, new UtlVoidPtr((void*)call));
+    indexCall(call);
 }
 
 CpCall* CallManager::popCall()
@@ -3516,21 +3528,42 @@ CpCall* CallManager::findHandlingCall(const char* callId)
 
     if(!handlingCall)
     {
-        UtlSListIterator iterator(callStack);
-        UtlVoidPtr* callCollectable;
-        CpCall* call;
-        callCollectable = (UtlVoidPtr*)iterator();
-        while(callCollectable &&
-            !handlingCall)
+        CpCall* candidates[CP_MAX_CALLS_PER_CALL_ID];
+        int numCandidates = findIndexedCalls(callId, candidates, 0,
+                                             CP_MAX_CALLS_PER_CALL_ID);
+
+        if(numCandidates <= CP_MAX_CALLS_PER_CALL_ID)
         {
-            call = (CpCall*)callCollectable->getValue();
-            if(call && call->hasCallId(callId))
+            sortByCallStackOrder(candidates, numCandidates);
+            for(int candidateIndex = 0;
+                candidateIndex < numCandidates && !handlingCall;
+                candidateIndex++)
             {
-                handlingCall = call;
+                if(candidates[candidateIndex]->hasCallId(callId))
+                {
+                    handlingCall = candidates[candidateIndex];
+                }
             }
+        }
+        else
+        {
+            // Too many calls share this Call-ID to sort them cheaply,
+            // so ask every call on the stack.
+            UtlSListIterator iterator(callStack);
+            UtlVoidPtr* callCollectable;
+            CpCall* call;
             callCollectable = (UtlVoidPtr*)iterator();
+            while(callCollectable &&
+                !handlingCall)
+            {
+                call = (CpCall*)callCollectable->getValue();
+                if(call && call->hasCallId(callId))
+                {
+                    handlingCall = call;
+                }
+                callCollectable = (UtlVoidPtr*)iterator();
+            }
         }
-
     }
 
     return(handlingCall);
@@ -3550,21 +3583,14 @@ CpCall* CallManager::findHandlingCall(int callIndex)
 
     if(!handlingCall)
     {
-        UtlSListIterator iterator(callStack);
-        UtlVoidPtr* callCollectable;
-        CpCall* call;
-        callCollectable = (UtlVoidPtr*)iterator();
-        while(callCollectable &&
-            !handlingCall)
+        OsLock lock(mCallIndexMutex);
+        UtlInt callIndexKey(callIndex);
+        UtlVoidPtr* callCollectable =
+            (UtlVoidPtr*) mCallsByIndex.findValue(&callIndexKey);
+        if(callCollectable)
         {
-            call = (CpCall*)callCollectable->getValue();
-            if(call && call->getCallIndex() == callIndex)
-            {
-                handlingCall = call;
-            }
-            callCollectable = (UtlVoidPtr*)iterator();
+            handlingCall = (CpCall*) callCollectable->getValue();
         }
-
     }
 
     return(handlingCall);
@@ -3588,17 +3614,55 @@ CpCall* CallManager::findHandlingCall(const OsMsg& eventMessage)
 
     if(handlingWeight != CpCall::CP_DEFINITELY_WILL_HANDLE)
     {
-        UtlSListIterator iterator(callStack);
-        UtlVoidPtr* callCollectable;
-        CpCall* call;
-        callCollectable = (UtlVoidPtr*)iterator();
-        while(callCollectable)
+        // A call only takes a SIP message if it has the message's Call-ID,
+        // or the Call-ID in the Replaces header of an INVITE, so only the
+        // calls indexed under those need to be asked.
+        CpCall* candidates[CP_MAX_CALLS_PER_CALL_ID];
+        int numCandidates = CP_MAX_CALLS_PER_CALL_ID + 1;
+        const SipMessage* sipMsg = NULL;
+
+        if(eventMessage.getMsgType() == OsMsg::PHONE_APP &&
+           eventMessage.getMsgSubType() == CP_SIP_MESSAGE)
+        {
+            sipMsg = ((SipMessageEvent&)eventMessage).getMessage();
+        }
+
+        if(sipMsg)
         {
-            call = (CpCall*)callCollectable->getValue();
-            if(call)
+            UtlString callId;
+            sipMsg->getCallIdField(&callId);
+            numCandidates = findIndexedCalls(callId, candidates, 0,
+                                             CP_MAX_CALLS_PER_CALL_ID);
+
+            UtlString method;
+            if(!sipMsg->isResponse())
+            {
+                sipMsg->getRequestMethod(&method);
+            }
+            if(numCandidates <= CP_MAX_CALLS_PER_CALL_ID &&
+               method.compareTo(SIP_INVITE_METHOD) == 0)
             {
-                thisCallHandlingWeight =
-                    call->willHandleMessage(eventMessage);
+                UtlString replacesCallId;
+                UtlString toTag;
+                UtlString fromTag;
+                if(sipMsg->getReplacesData(replacesCallId, toTag, fromTag))
+                {
+                    numCandidates = findIndexedCalls(replacesCallId,
+                                                     candidates,
+                                                     numCandidates,
+                                                     CP_MAX_CALLS_PER_CALL_ID);
+                }
+            }
+        }
+
+        if(numCandidates <= CP_MAX_CALLS_PER_CALL_ID)
+        {
+            sortByCallStackOrder(candidates, numCandidates);
+            for(int candidateIndex = 0; candidateIndex < numCandidates;
+                candidateIndex++)
+            {
+                CpCall* call = candidates[candidateIndex];
+                thisCallHandlingWeight = call->willHandleMessage(eventMessage);
 
                 if(thisCallHandlingWeight > handlingWeight)
                 {
@@ -3611,14 +3675,189 @@ CpCall* CallManager::findHandlingCall(const OsMsg& eventMessage)
                     break;
                 }
             }
-            callCollectable = (UtlVoidPtr*)iterator();
         }
+        else
+        {
+            // Not a SIP message, or too many calls share the Call-ID:
+            // ask every call on the stack.
+            UtlSListIterator iterator(callStack);
+            UtlVoidPtr* callCollectable;
+            CpCall* call;
+            callCollectable = (UtlVoidPtr*)iterator();
+            while(callCollectable)
+            {
+                call = (CpCall*)callCollectable->getValue();
+                if(call)
+                {
+                    thisCallHandlingWeight =
+                        call->willHandleMessage(eventMessage);
+
+                    if(thisCallHandlingWeight > handlingWeight)
+                    {
+                        handlingWeight = thisCallHandlingWeight;
+                        handlingCall = call;
+                    }
 
+                    if(handlingWeight == CpCall::CP_DEFINITELY_WILL_HANDLE)
+                    {
+                        break;
+                    }
+                }
+                callCollectable = (UtlVoidPtr*)iterator();
+            }
+        }
     }
 
     return(handlingCall);
 }
 
+void CallManager::indexCall(CpCall* call)
+{
+    UtlVoidPtr callKey(call);
+    {
+        OsLock lock(mCallIndexMutex);
+        if(mIndexedCalls.contains(&callKey))
+        {
+            // Already indexed, e.g. the infocus call going back on the stack
+            return;
+        }
+        mIndexedCalls.insertKeyAndValue(new UtlVoidPtr(call), new UtlSList());
+
+        UtlInt callIndexKey(call->getCallIndex());
+        mCallsByIndex.destroy(&callIndexKey);
+        mCallsByIndex.insertKeyAndValue(new UtlInt(call->getCallIndex()),
+                                        new UtlVoidPtr(call));
+    }
+
+    // From here on the call reports new Call-IDs through onCallIdAdded(),
+    // so collecting the ones it already has (without holding
+    // mCallIndexMutex) cannot miss any.
+    UtlSList callIds;
+    call->getCallIds(callIds);
+
+    OsLock lock(mCallIndexMutex);
+    UtlString* callId;
+    while((callId = (UtlString*) callIds.get()))
+    {
+        addCallIdToIndex(call, callId->data());
+        delete callId;
+    }
+}
+
+void CallManager::unindexCall(CpCall* call)
+{
+    OsLock lock(mCallIndexMutex);
+    UtlVoidPtr callKey(call);
+    UtlContainable* callIds = NULL;
+    UtlContainable* key = mIndexedCalls.removeKeyAndValue(&callKey, callIds);
+    if(key)
+    {
+        UtlSList* callIdList = (UtlSList*) callIds;
+        UtlString* callId;
+        while((callId = (UtlString*) callIdList->get()))
+        {
+            UtlSList* calls = (UtlSList*) mCallIdIndex.findValue(callId);
+            if(calls)
+            {
+                calls->destroy(&callKey);
+                if(calls->isEmpty())
+                {
+                    mCallIdIndex.destroy(callId);
+                }
+            }
+            delete callId;
+        }
+        delete callIdList;
+        delete key;
+
+        UtlInt callIndexKey(call->getCallIndex());
+        mCallsByIndex.destroy(&callIndexKey);
+    }
+}
+
+void CallManager::addCallIdToIndex(CpCall* call, const char* callId)
+{
+    // mCallIndexMutex is locked by the caller
+    UtlVoidPtr callKey(call);
+    UtlSList* callIdList = (UtlSList*) mIndexedCalls.findValue(&callKey);
+    UtlString callIdKey(callId);
+    if(callIdList && !callIdList->contains(&callIdKey))
+    {
+        callIdList->append(new UtlString(callIdKey));
+
+        UtlSList* calls = (UtlSList*) mCallIdIndex.findValue(&callIdKey);
+        if(!calls)
+        {
+            calls = new UtlSList();
+            mCallIdIndex.insertKeyAndValue(new UtlString(callIdKey), calls);
+        }
+        calls->append(new UtlVoidPtr(call));
+    }
+}
+
+int CallManager::findIndexedCalls(const char* callId, CpCall* calls[],
+                                  int numCalls, int maxCalls)
+{
+    OsLock lock(mCallIndexMutex);
+    UtlString callIdKey(callId);
+    UtlSList* indexedCalls = (UtlSList*) mCallIdIndex.findValue(&callIdKey);
+    if(indexedCalls)
+    {
+        UtlSListIterator iterator(*indexedCalls);
+        UtlVoidPtr* callCollectable;
+        while((callCollectable = (UtlVoidPtr*)iterator()))
+        {
+            CpCall* call = (CpCall*) callCollectable->getValue();
+            UtlBoolean alreadyFound = (call == infocusCall);
+            for(int callIndex = 0;
+                callIndex < numCalls && callIndex < maxCalls && !alreadyFound;
+                callIndex++)
+            {
+                alreadyFound = (calls[callIndex] == call);
+            }
+
+            if(!alreadyFound)
+            {
+                // Keep counting past maxCalls so the caller can tell
+                // that the candidates did not fit.
+                if(numCalls < maxCalls)
+                {
+                    calls[numCalls] = call;
+                }
+                numCalls++;
+            }
+        }
+    }
+    return(numCalls);
+}
+
+void CallManager::sortByCallStackOrder(CpCall* calls[], int numCalls)
+{
+    // Only calls sharing a Call-ID (e.g. during a transfer) need this,
+    // so it is fine to walk the stack here.
+    if(numCalls > 1)
+    {
+        int sortedCalls = 0;
+        UtlSListIterator iterator(callStack);
+        UtlVoidPtr* callCollectable;
+        while(sortedCalls < numCalls &&
+              (callCollectable = (UtlVoidPtr*)iterator()))
+        {
+            CpCall* call = (CpCall*)callCollectable->getValue();
+            for(int callIndex = sortedCalls; callIndex < numCalls; callIndex++)
+            {
+                if(calls[callIndex] == call)
+                {
+                    calls[callIndex] = calls[sortedCalls];
+                    calls[sortedCalls] = call;
+                    sortedCalls++;
+                    break;
+                }
+            }
+        }
+    }
+}
+
 CpCall* CallManager::findFirstQueuedCall()
 {
     CpCall* queuedCall = NULL;
@@ -4113,6 +4352,7 @@ OsStatus CallManager::doCreateCall(const char* callId,
             if(!infocusCall && assumeFocusIfNoInfocusCall)
             {
                 infocusCall = call;
+                indexCall(infocusCall);
                 infocusCall->inFocus(0);
             }
             // Other wise add this call to the stack
@@ -4298,6 +4538,7 @@ void CallManager::onCallDestroy(CpCall* call)
 
         mCallListMutex.acquireWrite() ;                                                
         releaseCallIndex(call->getCallIndex());
+        unindexCall(call);
         if(infocusCall == call)
         {
             // The infocus call is not in the mCallList -- no need to 
@@ -4313,6 +4554,14 @@ void CallManager::onCallDestroy(CpCall* call)
     }
 }
 
+void CallManager::onCallIdAdded(CpCall* call, const char* callId)
+{
+    // Called from the call's own task: calls that are not (or no longer)
+    // indexed are ignored, indexCall() picks up their Call-IDs itself.
+    OsLock lock(mCallIndexMutex);
+    addCallIdToIndex(call, callId);
+}
+
 void CallManager::yieldFocus(CpCall* call)
 {
     OsWriteLock lock(mCallListMutex);
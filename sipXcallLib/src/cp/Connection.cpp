@@ -557,6 +557,12 @@ void Connection::setCallId(const char* callId)
 
     connectionCallId = callId;
 
+    // Let the call manager route messages with this Call-ID to our call
+    if(mpCallManager && mpCall && callId && callId[0])
+    {
+        mpCallManager->onCallIdAdded(mpCall, callId);
+    }
+
     UtlString callCallId;
     if(mpCall)
     {
@@ -646,6 +646,20 @@ void CpCall::setCallId(const char* callId)
     OsWriteLock lock(mCallIdMutex);
     mCallId.remove(0);
     if(callId) mCallId.append(callId);
+
+    if(mpManager && callId && callId[0])
+    {
+        mpManager->onCallIdAdded(this, callId);
+    }
+}
+
+void CpCall::getCallIds(UtlSList& callIds)
+{
+    OsReadLock lock(mCallIdMutex);
+    if(!mCallId.isNull())
+    {
+        callIds.append(new UtlString(mCallId));
+    }
 }
 
 void CpCall::enableDtmf()
@@ -4583,6 +4583,25 @@ void CpPeerCall::printCall()
     }
 }
 
+void CpPeerCall::getCallIds(UtlSList& callIds)
+{
+    Connection* connection = NULL;
+    OsReadLock lock(mConnectionMutex);
+    UtlDListIterator iterator(mConnections);
+    UtlString connectionCallId;
+
+    CpCall::getCallIds(callIds);
+
+    while ((connection = (Connection*) iterator()))
+    {
+        connection->getCallId(&connectionCallId);
+        if(!connectionCallId.isNull())
+        {
+            callIds.append(new UtlString(connectionCallId));
+        }
+    }
+}
+
 void CpPeerCall::getLocalAddress(char* address, int maxLen)
 {
     int len = mLocalAddress.length();
@@ -4934,6 +4953,16 @@ void CpPeerCall::addConnection(Connection* connection)
     
 	OsWriteLock lock(mConnectionMutex);
     mConnections.append(connection);
+
+    if(mpManager)
+    {
+        UtlString connectionCallId;
+        connection->getCallId(&connectionCallId);
+        if(!connectionCallId.isNull())
+        {
+            mpManager->onCallIdAdded(this, connectionCallId.data());
+        }
+    }
 }
 
 // Assumed lock is head externally
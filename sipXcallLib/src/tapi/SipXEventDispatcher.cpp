@@ -17,6 +17,7 @@
 #include "tapi/sipXtapiEvents.h"
 #include "tapi/sipXtapiInternal.h"
 #include "utl/UtlVoidPtr.h"
+#include "os/OsLock.h"
 #include "os/OsPtrMsg.h"
 #include "os/OsReadLock.h"
 #include "os/OsWriteLock.h"
@@ -35,9 +36,42 @@
 /* ============================ CREATORS ================================== */
 
 
+SipXEventListenerTask::SipXEventListenerTask(SIPX_EVENT_LISTENER_CONTEXT* pContext,
+                                             int                          queueSize,
+                                             SIPX_EVENT_OVERFLOW_POLICY   policy)
+    : OsServerTask("SipXEventListener-%d", NULL, queueSize)
+    , mpContext(pContext)
+    , mPolicy(policy)
+    , mDroppedEvents(0)
+    , mDropLock(OsMutex::Q_FIFO)
+{
+}
+
+
+SipXEventListenerTask::~SipXEventListenerTask(void)
+{
+    OsMsg* pMsg ;
+
+    waitUntilShutDown() ;
+
+    // Free the event copies of the messages which were not handled
+    while (mIncomingQ.receive(pMsg, OsTime::NO_WAIT_TIME) == OS_SUCCESS)
+    {
+        if (pMsg->getMsgType() == SIPX_EVENT_MSG)
+        {
+            sipxFreeDuplicatedEvent((SIPX_EVENT_CATEGORY) pMsg->getMsgSubType(),
+                                    ((OsPtrMsg*) pMsg)->getPtr()) ;
+        }
+        pMsg->releaseMsg() ;
+    }
+}
+
+
 SipXEventDispatcher::SipXEventDispatcher(SIPX_INST hInst) 
     : OsServerTask("SipXEventDispatcher-%d")
     , mListenerLock(OsMutex::Q_FIFO)
+    , mListenerQueueSize(0)
+    , mOverflowPolicy(EVENT_OVERFLOW_BLOCK)
 {
     mhInst = hInst ;
 
@@ -54,6 +88,68 @@ SipXEventDispatcher::~SipXEventDispatcher(void)
 
 /* ============================ MANIPULATORS ============================== */
 
+UtlBoolean SipXEventListenerTask::handleMessage(OsMsg& rMsg)
+{
+    UtlBoolean bRet = false ;
+
+    if (rMsg.getMsgType() == SIPX_EVENT_MSG)
+    {
+        SIPX_EVENT_CATEGORY category = (SIPX_EVENT_CATEGORY) rMsg.getMsgSubType() ;
+        void* pDataCopy = ((OsPtrMsg&) rMsg).getPtr() ;
+
+        SipXEventDispatcher::invokeListener(mpContext, category, pDataCopy) ;
+
+        SIPX_RESULT rc = sipxFreeDuplicatedEvent(category, pDataCopy) ;
+        assert(rc == SIPX_RESULT_SUCCESS) ;
+        bRet = true ;
+    }
+    return bRet ;
+}
+
+
+void SipXEventListenerTask::postEvent(SIPX_EVENT_CATEGORY category, void* pEventCopy)
+{
+    OsPtrMsg msg(SIPX_EVENT_MSG, (unsigned char) category, pEventCopy) ;
+
+    if (mPolicy == EVENT_OVERFLOW_BLOCK)
+    {
+        if (postMessage(msg) != OS_SUCCESS)
+        {
+            OsLock lock(mDropLock) ;
+            dropEvent(&msg) ;
+        }
+        return ;
+    }
+
+    OsLock lock(mDropLock) ;
+    while (postMessage(msg, OsTime::NO_WAIT_TIME) != OS_SUCCESS)
+    {
+        OsMsg* pOldest = NULL ;
+        if (mPolicy == EVENT_OVERFLOW_DROP_NEWEST ||
+            mIncomingQ.receive(pOldest, OsTime::NO_WAIT_TIME) != OS_SUCCESS)
+        {
+            dropEvent(&msg) ;
+            break ;
+        }
+
+        // Make room by dropping the oldest event.  Only the dispatcher posts
+        // here until the task is shut down, so this is not another message.
+        assert(pOldest->getMsgType() == SIPX_EVENT_MSG) ;
+        dropEvent(pOldest) ;
+        pOldest->releaseMsg() ;
+    }
+}
+
+
+// Called with mDropLock held
+void SipXEventListenerTask::dropEvent(OsMsg* pMsg)
+{
+    sipxFreeDuplicatedEvent((SIPX_EVENT_CATEGORY) pMsg->getMsgSubType(),
+                            ((OsPtrMsg*) pMsg)->getPtr()) ;
+    mDroppedEvents++ ;
+}
+
+
 UtlBoolean SipXEventDispatcher::handleMessage(OsMsg& rMsg)
 {
     UtlBoolean bRet = false ;
@@ -93,6 +189,8 @@ bool SipXEventDispatcher::addListener(SIPX_EVENT_CALLBACK_PROC  pCallbackProc,
     SIPX_EVENT_LISTENER_CONTEXT* pContext = new SIPX_EVENT_LISTENER_CONTEXT ;
     pContext->pCallbackProc = pCallbackProc ;
     pContext->pUserData = pUserData ;
+    pContext->pQueueTask = NULL ;
+    startListenerQueue(pContext) ;
 
     mListeners.insert(new UtlVoidPtr(pContext)) ;
 
@@ -123,6 +221,7 @@ bool SipXEventDispatcher::removeListener(SIPX_EVENT_CALLBACK_PROC  pCallbackProc
             {
                 mListeners.destroy(pValue) ;
                 // mListeners.destroy will only delete the UtlVoidPtr object, not pContext
+                stopListenerQueue(pContext) ;
                 delete pContext;
                 bRC = true ;
                 break ;
@@ -144,6 +243,10 @@ void SipXEventDispatcher::removeAllListeners()
     while ((pValue = (UtlVoidPtr*) itor()))
     {
        pContext = (SIPX_EVENT_LISTENER_CONTEXT*) pValue->getValue() ;
+       if (pContext)
+       {
+          stopListenerQueue(pContext) ;
+       }
        // delete tests for NULL value automatically
        delete pContext;
     }
@@ -167,33 +270,53 @@ void SipXEventDispatcher::serviceListeners(SIPX_EVENT_CATEGORY category,
         assert(pContext != NULL) ;
         if (pContext)
         {
-            assert(pContext->pCallbackProc) ;
-            if (pContext->pCallbackProc)
+            if (pContext->pQueueTask)
             {
-                OsTime before;
-                OsDateTime::getCurTime(before);
-                pContext->pCallbackProc(category, pInfo, pContext->pUserData) ;
-                OsTime after;
-                OsDateTime::getCurTime(after);
-                OsTime lapse = after - before;
-                if(lapse.seconds() || lapse.usecs() > 100000) // more than 0.1 seconds
+                // The listener's own task frees its copy of the event
+                void* pDataCopy = NULL ;
+                if (sipxDuplicateEvent(category, pInfo, &pDataCopy) == SIPX_RESULT_SUCCESS)
                 {
-                    OsSysLogPriority priority = PRI_DEBUG;
-                    if(lapse.seconds())
-                    {
-                        priority = PRI_ERR;
-                    }
-                    else //if(lapse.usecs() > 10000)
-                    {
-                        priority = PRI_WARNING;
-                    }
-                    OsSysLog::add(FAC_SIPXTAPI, priority,
-                                  "sipXtapi callback event handler(%p) was slow to return (%f seconds)."
-                                  "  Care should be taken not to block in the callback for so long.",
-                                  pContext->pCallbackProc,
-                                  ((double) lapse.seconds()) + (((double) lapse.usecs()) / 1000000.0));
+                    pContext->pQueueTask->postEvent(category, pDataCopy) ;
                 }
             }
+            else
+            {
+                invokeListener(pContext, category, pInfo) ;
+            }
+        }
+    }
+}
+
+
+void SipXEventDispatcher::invokeListener(SIPX_EVENT_LISTENER_CONTEXT* pContext,
+                                         SIPX_EVENT_CATEGORY          category,
+                                         void*                        pInfo)
+{
+    assert(pContext->pCallbackProc) ;
+    if (pContext->pCallbackProc)
+    {
+        OsTime before;
+        OsDateTime::getCurTime(before);
+        pContext->pCallbackProc(category, pInfo, pContext->pUserData) ;
+        OsTime after;
+        OsDateTime::getCurTime(after);
+        OsTime lapse = after - before;
+        if(lapse.seconds() || lapse.usecs() > 100000) // more than 0.1 seconds
+        {
+            OsSysLogPriority priority = PRI_DEBUG;
+            if(lapse.seconds())
+            {
+                priority = PRI_ERR;
+            }
+            else //if(lapse.usecs() > 10000)
+            {
+                priority = PRI_WARNING;
+            }
+            OsSysLog::add(FAC_SIPXTAPI, priority,
+                          "sipXtapi callback event handler(%p) was slow to return (%f seconds)."
+                          "  Care should be taken not to block in the callback for so long.",
+                          pContext->pCallbackProc,
+                          ((double) lapse.seconds()) + (((double) lapse.usecs()) / 1000000.0));
         }
     }
 }
@@ -205,6 +328,60 @@ void SipXEventDispatcher::setInstanceHandle(SIPX_INST hNew)
 }
 
 
+void SipXEventDispatcher::setListenerQueues(int                        queueSize,
+                                            SIPX_EVENT_OVERFLOW_POLICY policy)
+{
+    OsWriteLock lock(mListenerLock) ;
+
+    mListenerQueueSize = queueSize ;
+    mOverflowPolicy = policy ;
+
+    UtlHashMapIterator itor(mListeners) ;
+    UtlVoidPtr* pValue ;
+    while ((pValue = (UtlVoidPtr*) itor()))
+    {
+        SIPX_EVENT_LISTENER_CONTEXT* pContext =
+            (SIPX_EVENT_LISTENER_CONTEXT*) pValue->getValue() ;
+        if (pContext)
+        {
+            stopListenerQueue(pContext) ;
+            startListenerQueue(pContext) ;
+        }
+    }
+}
+
+
+int SipXEventDispatcher::getDroppedEvents(SIPX_EVENT_CALLBACK_PROC  pCallbackProc,
+                                          void*                     pUserData) 
+{
+    OsReadLock lock(mListenerLock) ;
+
+    UtlHashMapIterator itor(mListeners) ;
+    UtlVoidPtr* pValue ;
+    while ((pValue = (UtlVoidPtr*) itor()))
+    {
+        SIPX_EVENT_LISTENER_CONTEXT* pContext =
+            (SIPX_EVENT_LISTENER_CONTEXT*) pValue->getValue() ;
+        if (pContext &&
+            pContext->pCallbackProc == pCallbackProc &&
+            pContext->pUserData == pUserData)
+        {
+            return pContext->pQueueTask ? pContext->pQueueTask->getDroppedEvents() : 0 ;
+        }
+    }
+
+    return -1 ;
+}
+
+
+int SipXEventListenerTask::getDroppedEvents()
+{
+    OsLock lock(mDropLock) ;
+
+    return mDroppedEvents ;
+}
+
+
 bool SIPX_CALLING_CONVENTION SipXEventDispatcher::EventCallBack(SIPX_EVENT_CATEGORY category, 
                                                                 void*               pInfo, 
                                                                 void*               pUserData)
@@ -229,3 +406,28 @@ bool SIPX_CALLING_CONVENTION SipXEventDispatcher::EventCallBack(SIPX_EVENT_CATEG
        
     return true ;
 }
+
+
+/* //////////////////////////// PRIVATE /////////////////////////////////// */
+
+void SipXEventDispatcher::startListenerQueue(SIPX_EVENT_LISTENER_CONTEXT* pContext)
+{
+    if (mListenerQueueSize > 0)
+    {
+        pContext->pQueueTask = new SipXEventListenerTask(pContext,
+                                                         mListenerQueueSize,
+                                                         mOverflowPolicy) ;
+        pContext->pQueueTask->start() ;
+    }
+}
+
+
+void SipXEventDispatcher::stopListenerQueue(SIPX_EVENT_LISTENER_CONTEXT* pContext)
+{
+    if (pContext->pQueueTask)
+    {
+        pContext->pQueueTask->requestShutdown() ;
+        delete pContext->pQueueTask ;
+        pContext->pQueueTask = NULL ;
+    }
+}
@@ -1831,6 +1831,54 @@ SIPXTAPI_API SIPX_RESULT sipxEventListenerRemove(const SIPX_INST hInst,
     return rc ;
 }
 
+SIPXTAPI_API SIPX_RESULT sipxEventListenerSetQueues(const SIPX_INST hInst,
+                                                    int queueSize,
+                                                    SIPX_EVENT_OVERFLOW_POLICY policy)
+{
+    OsSysLog::add(FAC_SIPXTAPI, PRI_INFO,
+            "sipxEventListenerSetQueues hInst=%p queueSize=%d policy=%d",
+            hInst, queueSize, policy);
+
+    SIPX_RESULT rc = SIPX_RESULT_INVALID_ARGS;
+    if (hInst && queueSize >= 0 &&
+        policy >= EVENT_OVERFLOW_BLOCK && policy <= EVENT_OVERFLOW_DROP_OLDEST)
+    {
+        rc = SIPX_RESULT_FAILURE ;
+        SIPX_INSTANCE_DATA* pInst = (SIPX_INSTANCE_DATA*) hInst;
+        if (pInst && pInst->pEventDispatcher)
+        {
+            pInst->pEventDispatcher->setListenerQueues(queueSize, policy) ;
+            rc = SIPX_RESULT_SUCCESS ;
+        }
+    }
+
+    return rc ;
+}
+
+SIPXTAPI_API SIPX_RESULT sipxEventListenerGetDroppedEvents(const SIPX_INST hInst,
+                                                           SIPX_EVENT_CALLBACK_PROC pCallbackProc,
+                                                           void* pUserData,
+                                                           int* pDroppedEvents)
+{
+    SIPX_RESULT rc = SIPX_RESULT_INVALID_ARGS;
+    if (hInst && pCallbackProc && pDroppedEvents)
+    {
+        rc = SIPX_RESULT_FAILURE ;
+        SIPX_INSTANCE_DATA* pInst = (SIPX_INSTANCE_DATA*) hInst;
+        if (pInst && pInst->pEventDispatcher)
+        {
+            int droppedEvents = pInst->pEventDispatcher->getDroppedEvents(pCallbackProc, pUserData) ;
+            if (droppedEvents >= 0)
+            {
+                *pDroppedEvents = droppedEvents ;
+                rc = SIPX_RESULT_SUCCESS ;
+            }
+        }
+    }
+
+    return rc ;
+}
+
 
 SIPX_RESULT __sipxEventListenerAdd(const SIPX_INST hInst,
                                    SIPX_EVENT_CALLBACK_PROC pCallbackProc,
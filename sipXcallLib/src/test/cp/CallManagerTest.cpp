@@ -18,9 +18,11 @@
 #include <net/SipUserAgent.h>
 #include <cp/CpTestSupport.h>
 #include <net/SipMessage.h>
+#include <net/SipMessageEvent.h>
 #include <net/SipLineMgr.h>
 #include <net/SipRefreshMgr.h>
 #include <mi/CpMediaInterfaceFactoryFactory.h>
+#include <os/OsDateTime.h>
 
 #if defined _WIN32 && !defined WINCE
   #define _CRTDBG_MAP_ALLOC
@@ -36,6 +38,9 @@ _CrtMemState MemStateDiff;
 #define SAMPLE_RATE    8000
 
 #define NUM_OF_RUNS 10
+
+#define NUM_DISPATCH_CALLS 5000
+#define NUM_DISPATCH_MESSAGES 1000
 /**
  * Unittest for CallManager
  */
@@ -52,6 +57,7 @@ class CallManangerTest : public SIPX_UNIT_BASE_CLASS
   //CPPUNIT_TEST(testLineMgrUATeardown);
   //CPPUNIT_TEST(testRefreshMgrUATeardown);
     CPPUNIT_TEST(testGetNewCallId);
+    CPPUNIT_TEST(testCallDispatchCost);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -498,6 +504,98 @@ public:
          }
       }
 
+    static double elapsedUsecs(const OsTime& start)
+    {
+        OsTime now;
+        OsDateTime::getCurTimeSinceBoot(now);
+        OsTime elapsed = now - start;
+        return elapsed.seconds() * 1000000.0 + elapsed.usecs();
+    }
+
+    /* Time how long CallManager takes to route a message to one of
+     * NUM_DISPATCH_CALLS calls, or to find out that no call takes it.
+     * This should not depend on the number of calls.
+     */
+    void testCallDispatchCost()
+    {
+        SipUserAgent* ua = CpTestSupport::newSipUserAgent();
+        ua->start();
+        CallManager* callmgr = CpTestSupport::newCallManager(ua);
+        callmgr->setMaxCalls(NUM_DISPATCH_CALLS + 1);
+        callmgr->start();
+
+        UtlString* callIds = new UtlString[NUM_DISPATCH_CALLS];
+        int i;
+        for (i = 0; i < NUM_DISPATCH_CALLS; i++)
+        {
+            callmgr->createCall(&callIds[i]);
+        }
+
+        // Calls are created asynchronously, in order, so once the last one
+        // answers all of them exist.  The first call is in focus and the
+        // second one is at the bottom of the call stack.
+        int numConnections = -1;
+        callmgr->getNumConnections(callIds[NUM_DISPATCH_CALLS - 1],
+                                   numConnections);
+        CPPUNIT_ASSERT_EQUAL(0, numConnections);
+        int currentCalls;
+        int maxCalls;
+        callmgr->getCalls(currentCalls, maxCalls);
+        CPPUNIT_ASSERT_EQUAL(NUM_DISPATCH_CALLS - 1, currentCalls);
+
+        const char* targets[] = {
+            callIds[NUM_DISPATCH_CALLS - 1].data(),  // top of the call stack
+            callIds[1].data(),                       // bottom of the call stack
+            "unknown-call-id@127.0.0.1"              // no such call
+        };
+        const char* targetNames[] = { "newest call", "oldest call", "no call" };
+        for (unsigned t = 0; t < sizeof(targets) / sizeof(targets[0]); t++)
+        {
+            OsTime start;
+            OsDateTime::getCurTimeSinceBoot(start);
+            for (i = 0; i < NUM_DISPATCH_MESSAGES; i++)
+            {
+                callmgr->getNumConnections(targets[t], numConnections);
+                CPPUNIT_ASSERT_EQUAL(0, numConnections);
+            }
+            printf("\nCallManager API request to %s with %d calls: %.2f usec\n",
+                   targetNames[t], NUM_DISPATCH_CALLS,
+                   elapsedUsecs(start) / NUM_DISPATCH_MESSAGES);
+        }
+
+        // SIP responses nobody wants have to be checked against all calls
+        // which could take them.
+        OsTime start;
+        OsDateTime::getCurTimeSinceBoot(start);
+        for (i = 0; i < NUM_DISPATCH_MESSAGES; i++)
+        {
+            SipMessage* response = new SipMessage();
+            response->setResponseFirstHeaderLine(SIP_PROTOCOL_VERSION,
+                                                 SIP_OK_CODE, SIP_OK_TEXT);
+            char callId[64];
+            sprintf(callId, "unknown-call-id-%d@127.0.0.1", i);
+            response->setCallIdField(callId);
+            response->setCSeqField(1, SIP_INFO_METHOD);
+            SipMessageEvent responseEvent(response);
+            callmgr->postMessage(responseEvent);
+        }
+        // Wait until the CallManager has gone through the queue.
+        callmgr->getNumConnections(callIds[1], numConnections);
+        printf("CallManager SIP message dispatch with %d calls: %.2f usec\n",
+               NUM_DISPATCH_CALLS, elapsedUsecs(start) / NUM_DISPATCH_MESSAGES);
+
+        for (i = 0; i < NUM_DISPATCH_CALLS; i++)
+        {
+            callmgr->drop(callIds[i]);
+        }
+        delete[] callIds;
+
+        callmgr->requestShutdown();
+        delete callmgr;
+        ua->shutdown(TRUE);
+        delete ua;
+    }
+
     /* Some basic tests on the CpCallManager::getNewCallId methods. */
     void testGetNewCallId()
     {
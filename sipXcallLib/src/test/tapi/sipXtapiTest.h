@@ -274,6 +274,7 @@ class sipXtapiTestSuite : public SIPX_UNIT_BASE_CLASS
     CPPUNIT_TEST(testConfigLog) ;
 #endif
     CPPUNIT_TEST(testConfigEnableShortNames);
+    CPPUNIT_TEST(testEventListenerQueues);
     CPPUNIT_TEST(testTeardown);
     CPPUNIT_TEST(testTeardown);
     CPPUNIT_TEST(testTeardown);
@@ -543,6 +544,7 @@ public:
     void testConfigKeepAliveNoStop() ;
 
     void testConfigEnableShortNames();
+    void testEventListenerQueues();
     
     void testPublishAndSubscribe(bool bCallContext, bool bCustomTransport, const char* szTestName);
     void testPublishAndSubscribeCall();
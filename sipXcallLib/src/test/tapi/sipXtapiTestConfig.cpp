@@ -18,6 +18,7 @@
 #include "EventRecorder.h"
 #include "EventValidator.h"
 #include "callbacks.h"
+#include "os/OsBSem.h"
 
 extern EventRecorder g_recorder ;
 bool g_bCallbackCalled = false;
@@ -1655,6 +1656,89 @@ void sipXtapiTestSuite::testConfigEnableShortNames()
 }
 
 
+static int s_iSlowListenerEvents = 0 ;
+static bool s_bSlowListenerHold = false ;
+static OsBSem s_slowListenerEntered(OsBSem::Q_FIFO, OsBSem::EMPTY) ;
+static OsBSem s_slowListenerRelease(OsBSem::Q_FIFO, OsBSem::EMPTY) ;
+
+// Listener which, while s_bSlowListenerHold is set, does not return from
+// its callback until the test releases it
+static bool SIPX_CALLING_CONVENTION SlowEventListener(SIPX_EVENT_CATEGORY category, 
+                                                      void* pInfo, 
+                                                      void* pUserData)
+{
+    s_iSlowListenerEvents++ ;
+    s_slowListenerEntered.release() ;
+    if (s_bSlowListenerHold)
+    {
+        s_slowListenerRelease.acquire() ;
+    }
+    return true ;
+}
+
+void sipXtapiTestSuite::testEventListenerQueues()
+{
+    bool bRC ;
+    int  iDropped ;
+    char szLine[64] ;
+    SIPX_LINE hLines[5] ;
+    EventValidator validator("testEventListenerQueues") ;
+
+    printf("\ntestEventListenerQueues") ;
+
+    // At most one event waits for each listener, newer ones are dropped
+    CPPUNIT_ASSERT_EQUAL(sipxEventListenerSetQueues(g_hInst, 1, EVENT_OVERFLOW_DROP_NEWEST), SIPX_RESULT_SUCCESS) ;
+    s_iSlowListenerEvents = 0 ;
+    s_bSlowListenerHold = true ;
+    CPPUNIT_ASSERT_EQUAL(sipxEventListenerAdd(g_hInst, SlowEventListener, NULL), SIPX_RESULT_SUCCESS) ;
+    CPPUNIT_ASSERT_EQUAL(sipxEventListenerAdd(g_hInst, UniversalEventValidatorCallback, &validator), SIPX_RESULT_SUCCESS) ;
+
+    // The slow listener holds on to the event of the first line, so the
+    // second one waits in its queue and the last three are dropped.  The
+    // validator takes each event before the next line is added, so its
+    // queue never overflows.
+    int i ;
+    for (i = 0; i < 5; i++)
+    {
+        sprintf(szLine, "sip:queue%d@127.0.0.1:8000", i) ;
+        CPPUNIT_ASSERT_EQUAL(sipxLineAdd(g_hInst, szLine, &hLines[i], CONTACT_LOCAL), SIPX_RESULT_SUCCESS) ;
+        bRC = validator.waitForLineEvent(hLines[i], LINESTATE_PROVISIONED, LINESTATE_PROVISIONED_NORMAL, true) ;
+        CPPUNIT_ASSERT(bRC) ;
+        if (i == 0)
+        {
+            CPPUNIT_ASSERT_EQUAL(s_slowListenerEntered.acquire(OsTime(5, 0)), OS_SUCCESS) ;
+        }
+    }
+    CPPUNIT_ASSERT_EQUAL(s_iSlowListenerEvents, 1) ;
+
+    CPPUNIT_ASSERT_EQUAL(sipxEventListenerGetDroppedEvents(g_hInst, UniversalEventValidatorCallback, &validator, &iDropped), SIPX_RESULT_SUCCESS) ;
+    CPPUNIT_ASSERT_EQUAL(iDropped, 0) ;
+    CPPUNIT_ASSERT_EQUAL(sipxEventListenerGetDroppedEvents(g_hInst, SlowEventListener, NULL, &iDropped), SIPX_RESULT_SUCCESS) ;
+    CPPUNIT_ASSERT_EQUAL(iDropped, 3) ;
+
+    // Once released, the slow listener gets the event which was queued
+    s_bSlowListenerHold = false ;
+    s_slowListenerRelease.release() ;
+    CPPUNIT_ASSERT_EQUAL(s_slowListenerEntered.acquire(OsTime(5, 0)), OS_SUCCESS) ;
+    CPPUNIT_ASSERT_EQUAL(s_iSlowListenerEvents, 2) ;
+
+    CPPUNIT_ASSERT_EQUAL(sipxEventListenerRemove(g_hInst, SlowEventListener, NULL), SIPX_RESULT_SUCCESS) ;
+    CPPUNIT_ASSERT_EQUAL(sipxEventListenerRemove(g_hInst, UniversalEventValidatorCallback, &validator), SIPX_RESULT_SUCCESS) ;
+    CPPUNIT_ASSERT_EQUAL(sipxEventListenerGetDroppedEvents(g_hInst, SlowEventListener, NULL, &iDropped), SIPX_RESULT_FAILURE) ;
+
+    for (i = 0; i < 5; i++)
+    {
+        CPPUNIT_ASSERT_EQUAL(sipxLineRemove(hLines[i]), SIPX_RESULT_SUCCESS) ;
+    }
+
+    CPPUNIT_ASSERT_EQUAL(sipxEventListenerSetQueues(g_hInst, 0, EVENT_OVERFLOW_BLOCK), SIPX_RESULT_SUCCESS) ;
+
+    OsTask::delay(TEST_DELAY) ;
+
+    checkForLeaks();
+}
+
+
 void sipXtapiTestSuite::testUtilUrlParse() 
 {
     char szUsername[100] ;
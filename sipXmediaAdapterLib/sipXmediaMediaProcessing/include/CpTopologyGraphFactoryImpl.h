@@ -12,10 +12,13 @@
 
 // SYSTEM INCLUDES
 // APPLICATION INCLUDES
+#include <os/OsMutex.h>
 #include <sipXmediaFactoryImpl.h>
 #include <MaNotfTranslatorDispatcher.h>
 
 // DEFINES
+#define DEFAULT_PREBUILT_CONNECTIONS 4  ///< Unicast connections kept ready
+#define MAX_PREBUILT_CONNECTIONS 32
 // MACROS
 // EXTERNAL FUNCTIONS
 // EXTERNAL VARIABLES
@@ -28,6 +31,7 @@ class MpResourceFactory;
 class MpInputDeviceManager;
 class MpOutputDeviceManager;
 class MpMMTimer;
+class MpResourceSet;
 
 /** 
 *  @brief Subsystem manager and creator of CpTopologyGraphInterfaces
@@ -169,6 +173,33 @@ public:
     inline
     int getNumMcastRtpStreams() const;
 
+      /// @brief Take the resources of an unicast RTP connection out of the
+      /// pool of pre-built connections.
+    MpResourceSet* getPrebuiltConnection();
+      /**<
+      *  The resources are built from the connection resource topology, and
+      *  are to be added with MpTopologyGraph::addPrebuiltResources().
+      *
+      *  @returns NULL if the pool is empty.
+      */
+
+      /// Fill the pool of pre-built unicast RTP connections.
+    void prebuildConnections();
+      /**<
+      *  Called when a connection is deleted, to replace the one taken from
+      *  the pool when it was created.  The resources are constructed and
+      *  linked in the calling thread, without holding the pool lock.
+      */
+
+      /// Set the number of unicast RTP connections to keep pre-built.
+    void setPrebuiltConnections(int numConnections);
+      /**<
+      *  0 disables the pool.  At most MAX_PREBUILT_CONNECTIONS.
+      */
+
+      /// Get the number of unicast RTP connections to keep pre-built.
+    int getPrebuiltConnections() const;
+
     MpInputDeviceManager* getInputDeviceManager() const;
 
       /// Build a resource factory with the default set of resource constructors.
@@ -211,6 +242,10 @@ protected:
    MpInputDeviceHandle    mDefaultToInputDevice;
    int                    mNumMcastStreams;
    MaNotfTranslatorDispatcher mTranslatorDispatcher;
+   mutable OsMutex        mPrebuiltConnectionsMutex;
+   MpResourceSet         *mpPrebuiltConnections[MAX_PREBUILT_CONNECTIONS];
+   int                    mNumPrebuiltConnections;
+   int                    mMaxPrebuiltConnections; ///< Pool size to keep
 
      /// Add RTP output connection to topology
    static void addOutputConnectionTopology(MpResourceTopology* resourceTopology,
@@ -219,6 +254,9 @@ protected:
      /// Add local input and local output connections to topology
    static void addLocalConnectionTopology(MpResourceTopology* resourceTopology);
 
+     /// Destroy the pre-built connections, e.g. as their topology changed
+   void flushPrebuiltConnections();
+
 /* //////////////////////////// PRIVATE /////////////////////////////////// */
 private:
 
@@ -18,6 +18,8 @@
 #include <mp/MpMisc.h>
 #include <mp/MpResourceFactory.h>
 #include <mp/MpResourceTopology.h>
+#include <mp/MpResourceSet.h>
+#include <mp/MpTopologyGraph.h>
 #include <mp/MprFromInputDeviceConstructor.h>
 #include <mp/MprToOutputDeviceConstructor.h>
 #include <mp/MprToneDetectConstructor.h>
@@ -45,6 +47,7 @@
 #include "CpTopologyGraphInterface.h"
 #include <os/OsSysLog.h>
 #include <os/OsFS.h>
+#include <os/OsLock.h>
 
 #ifdef USE_SPEEX_AEC // [
 #  include <mp/MprToOutputDeviceWithAecConstructor.h>
@@ -210,6 +213,9 @@ CpTopologyGraphFactoryImpl::CpTopologyGraphFactoryImpl(OsConfigDb* pConfigDb,
 , mDefaultToOutputDevice(MP_INVALID_OUTPUT_DEVICE_HANDLE)
 , mDefaultToInputDevice(MP_INVALID_INPUT_DEVICE_HANDLE)
 , mNumMcastStreams(3)
+, mPrebuiltConnectionsMutex(OsMutex::Q_FIFO)
+, mNumPrebuiltConnections(0)
+, mMaxPrebuiltConnections(DEFAULT_PREBUILT_CONNECTIONS)
 {
     assert(MpMisc.RawAudioPool);
 #ifdef ANDROID
@@ -355,6 +361,9 @@ CpTopologyGraphFactoryImpl::CpTopologyGraphFactoryImpl(OsConfigDb* pConfigDb,
 
     mpConnectionResourceTopology = buildUnicastConnectionResourceTopology();
     mpMcastConnectionResourceTopology = buildMulticastConnectionResourceTopology();
+
+    // Have the first connections ready before the first call.
+    prebuildConnections();
 }
 
 
@@ -409,6 +418,9 @@ CpTopologyGraphFactoryImpl::~CpTopologyGraphFactoryImpl()
       mpMediaTaskTicker = NULL;
    }
 
+   // Pre-built connections were made by the factory, free them first.
+   flushPrebuiltConnections();
+
    // Free factory and topologies.
    delete mpResourceFactory;
    mpResourceFactory = NULL;
@@ -1368,6 +1380,7 @@ MpResourceTopology* CpTopologyGraphFactoryImpl::getInitialResourceTopology() con
 
 void CpTopologyGraphFactoryImpl::setResourceFactory(MpResourceFactory& resourceFactory)
 {
+    flushPrebuiltConnections();
     mpResourceFactory = &resourceFactory;
 }
 
@@ -1378,6 +1391,7 @@ MpResourceFactory* CpTopologyGraphFactoryImpl::getResourceFactory() const
 
 void CpTopologyGraphFactoryImpl::setConnectionResourceTopology(MpResourceTopology& connectionResourceTopology)
 {
+    flushPrebuiltConnections();
     mpConnectionResourceTopology = &connectionResourceTopology;
 }
 
@@ -1413,6 +1427,93 @@ MpResourceTopology* CpTopologyGraphFactoryImpl::getMcastConnectionResourceTopolo
     return(mpMcastConnectionResourceTopology);
 }
 
+MpResourceSet* CpTopologyGraphFactoryImpl::getPrebuiltConnection()
+{
+    OsLock lock(mPrebuiltConnectionsMutex);
+    if(mNumPrebuiltConnections == 0)
+    {
+        return(NULL);
+    }
+    mNumPrebuiltConnections--;
+    MpResourceSet* pResourceSet = mpPrebuiltConnections[mNumPrebuiltConnections];
+    mpPrebuiltConnections[mNumPrebuiltConnections] = NULL;
+    return(pResourceSet);
+}
+
+void CpTopologyGraphFactoryImpl::prebuildConnections()
+{
+    if(mpConnectionResourceTopology == NULL || mpResourceFactory == NULL)
+    {
+        return;
+    }
+
+    for(;;)
+    {
+        {
+            OsLock lock(mPrebuiltConnectionsMutex);
+            if(mNumPrebuiltConnections >= mMaxPrebuiltConnections)
+            {
+                return;
+            }
+        }
+
+        // Construct the resources without holding the lock, so that
+        // calls being set up in other threads are not held up.
+        MpResourceSet* pResourceSet = NULL;
+        OsStatus result =
+            MpTopologyGraph::prebuildResources(*mpConnectionResourceTopology,
+                                               *mpResourceFactory,
+                                               pResourceSet);
+        if(result != OS_SUCCESS)
+        {
+            OsSysLog::add(FAC_CP, PRI_ERR,
+                          "CpTopologyGraphFactoryImpl::prebuildConnections prebuildResources returned: %d",
+                          result);
+            return;
+        }
+
+        OsLock lock(mPrebuiltConnectionsMutex);
+        if(mNumPrebuiltConnections >= mMaxPrebuiltConnections)
+        {
+            // Another thread filled the pool meanwhile.
+            delete pResourceSet;
+            return;
+        }
+        mpPrebuiltConnections[mNumPrebuiltConnections++] = pResourceSet;
+    }
+}
+
+void CpTopologyGraphFactoryImpl::setPrebuiltConnections(int numConnections)
+{
+    if(numConnections < 0)
+    {
+        numConnections = 0;
+    }
+    else if(numConnections > MAX_PREBUILT_CONNECTIONS)
+    {
+        numConnections = MAX_PREBUILT_CONNECTIONS;
+    }
+
+    {
+        OsLock lock(mPrebuiltConnectionsMutex);
+        mMaxPrebuiltConnections = numConnections;
+        while(mNumPrebuiltConnections > mMaxPrebuiltConnections)
+        {
+            mNumPrebuiltConnections--;
+            delete mpPrebuiltConnections[mNumPrebuiltConnections];
+            mpPrebuiltConnections[mNumPrebuiltConnections] = NULL;
+        }
+    }
+
+    prebuildConnections();
+}
+
+int CpTopologyGraphFactoryImpl::getPrebuiltConnections() const
+{
+    OsLock lock(mPrebuiltConnectionsMutex);
+    return(mMaxPrebuiltConnections);
+}
+
 MpInputDeviceManager* CpTopologyGraphFactoryImpl::getInputDeviceManager() const
 {
     return(mpInputDeviceManager);
@@ -1465,6 +1566,17 @@ void CpTopologyGraphFactoryImpl::addOutputConnectionTopology(MpResourceTopology*
     assert(result == OS_SUCCESS);
 }
 
+void CpTopologyGraphFactoryImpl::flushPrebuiltConnections()
+{
+    OsLock lock(mPrebuiltConnectionsMutex);
+    while(mNumPrebuiltConnections > 0)
+    {
+        mNumPrebuiltConnections--;
+        delete mpPrebuiltConnections[mNumPrebuiltConnections];
+        mpPrebuiltConnections[mNumPrebuiltConnections] = NULL;
+    }
+}
+
 void CpTopologyGraphFactoryImpl::addLocalConnectionTopology(MpResourceTopology* resourceTopology)
 {
     OsStatus result;
@@ -30,6 +30,7 @@
 #include <os/OsStatus.h>
 #include <mp/MpTopologyGraph.h>
 #include <mp/MpResourceTopology.h>
+#include <mp/MpResourceSet.h>
 #include <mp/MpInputDeviceManager.h>
 #include <mp/MpOutputDeviceManager.h>
 #include <mp/MprToneGen.h>
@@ -4041,9 +4042,24 @@ CpTopologyMediaConnection* CpTopologyGraphInterface::createMediaConnection(int&
    }
    pResourceTopology = isMcast ? pTopologyFactoryImpl->getMcastConnectionResourceTopology()
                                : pTopologyFactoryImpl->getConnectionResourceTopology();
-   mpTopologyGraph->addResources(*pResourceTopology,
-                                 pTopologyFactoryImpl->getResourceFactory(),
-                                 connectionId);
+
+   // Unicast connections are taken ready-made from the factory's pool
+   // when there is one left, which saves constructing and linking
+   // the resources one message at a time.
+   MpResourceSet* pResourceSet = isMcast ? NULL
+                                         : pTopologyFactoryImpl->getPrebuiltConnection();
+   if (pResourceSet)
+   {
+      mpTopologyGraph->addPrebuiltResources(*pResourceTopology,
+                                            pResourceSet,
+                                            connectionId);
+   }
+   else
+   {
+      mpTopologyGraph->addResources(*pResourceTopology,
+                                    pTopologyFactoryImpl->getResourceFactory(),
+                                    connectionId);
+   }
 
    mediaConnection = new CpTopologyMediaConnection(connectionId);
    OsSysLog::add(FAC_CP, PRI_DEBUG,
@@ -4143,6 +4159,14 @@ OsStatus CpTopologyGraphInterface::deleteMediaConnection(CpTopologyMediaConnecti
        mediaConnection->setValue(-1);
        // I don't think this fence is required.
 //       mpTopologyGraph->synchronize();
+
+       // Build the resources for a future connection now, rather than
+       // while the next call is being set up.
+       if (mediaConnection->mpResourceTopology ==
+           ((CpTopologyGraphFactoryImpl*)mpFactoryImpl)->getConnectionResourceTopology())
+       {
+          ((CpTopologyGraphFactoryImpl*)mpFactoryImpl)->prebuildConnections();
+       }
    }
 
    if(!mediaConnection->mIsCustomSockets && mediaConnection->mpRtpAudioSocket)
@@ -9,21 +9,26 @@
 
 // Author: Dan Petrie (dpetrie AT SIPez DOT com)
 
+#include <time.h>
 #include <os/OsIntTypes.h>
 #include <os/OsFS.h>
 #include <sipxunittests.h>
 #include <mi/CpMediaInterfaceFactory.h>
 #include <mi/CpMediaInterfaceFactoryFactory.h>
 #include <CpTopologyGraphInterface.h>
+#include <CpTopologyGraphFactoryImpl.h>
 #include <mi/CpMediaInterface.h>
 #include <mi/MiNotification.h>
 #include <mi/MiDtmfNotf.h>
 #include <mi/MiRtpStreamActivityNotf.h>
 #include <mi/MiIntNotf.h>
 #include <os/OsTask.h>
+#include <os/OsDateTime.h>
+#include <os/OsDatagramSocket.h>
 #include <utl/UtlSList.h>
 #include <utl/UtlInt.h>
 #include <utl/UtlHashBag.h>
+#include <utl/UtlVoidPtr.h>
 #include <os/OsMsgDispatcher.h>
 #include <mp/MpResourceTopology.h>
 #include <mp/MprVoiceActivityNotifier.h>
@@ -58,6 +63,10 @@
 #define TEST_RTP_PORT_RANGE_START 9500
 #define TEST_RTP_PORT_RANGE_END 9900
 
+// Connections created at once and number of times, for call setup latency
+#define SETUP_LATENCY_BURST_SIZE 4
+#define SETUP_LATENCY_BURSTS 10
+
 class StoreSignalNotification : public OsNotification
 {
 public:
@@ -108,6 +117,7 @@ class CpPhoneMediaInterfaceTest : public SIPX_UNIT_BASE_CLASS
     CPPUNIT_TEST(testThreeGraphs);
     CPPUNIT_TEST(testStreamNotifications);
     CPPUNIT_TEST(testVoiceNotifications);
+    CPPUNIT_TEST(testConnectionSetupLatency);
     CPPUNIT_TEST_SUITE_END();
 
     public:
@@ -3598,6 +3608,137 @@ class CpPhoneMediaInterfaceTest : public SIPX_UNIT_BASE_CLASS
         }
         delete[] codecArray2;
     };
+
+#ifdef ENABLE_TOPOLOGY_FLOWGRAPH_INTERFACE_FACTORY
+    // Create and delete SETUP_LATENCY_BURSTS bursts of connections, as in
+    // a burst of calls, and get the average time and CPU time in
+    // microseconds to create one.  The sockets are made beforehand, as
+    // probing ports for them would hide the cost of the media resources.
+    void measureConnectionSetup(CpTopologyGraphInterface* mediaInterface,
+                                UtlSList& sockets,
+                                double& latencyUsecs,
+                                double& cpuUsecs)
+    {
+        latencyUsecs = 0;
+        cpuUsecs = 0;
+        for (int burst = 0; burst < SETUP_LATENCY_BURSTS; burst++)
+        {
+            int connectionIds[SETUP_LATENCY_BURST_SIZE];
+            OsSocket* rtpSockets[SETUP_LATENCY_BURST_SIZE];
+            OsSocket* rtcpSockets[SETUP_LATENCY_BURST_SIZE];
+            int i;
+            for (i = 0; i < SETUP_LATENCY_BURST_SIZE; i++)
+            {
+                rtpSockets[i] = new OsDatagramSocket(0, NULL, PORT_DEFAULT, "127.0.0.1");
+                rtcpSockets[i] = new OsDatagramSocket(0, NULL, PORT_DEFAULT, "127.0.0.1");
+                // Deleted at the end of the test, as the interface does not
+                // own them and may still be releasing them.
+                sockets.append(new UtlVoidPtr(rtpSockets[i]));
+                sockets.append(new UtlVoidPtr(rtcpSockets[i]));
+            }
+
+            OsTime start;
+            OsTime end;
+            clock_t cpuStart = clock();
+            OsDateTime::getCurTime(start);
+            for (i = 0; i < SETUP_LATENCY_BURST_SIZE; i++)
+            {
+                OsStatus result = mediaInterface->createConnection(connectionIds[i],
+                                                                   rtpSockets[i],
+                                                                   rtcpSockets[i],
+                                                                   FALSE);
+                CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, result);
+                CPPUNIT_ASSERT(connectionIds[i] > 0);
+            }
+            OsDateTime::getCurTime(end);
+            clock_t cpuEnd = clock();
+
+            OsTime elapsed = end - start;
+            latencyUsecs += elapsed.seconds() * 1000000.0 + elapsed.usecs();
+            cpuUsecs += (cpuEnd - cpuStart) * 1000000.0 / CLOCKS_PER_SEC;
+
+            // The connections must be linked to the bridge either way.
+            for (i = 0; i < SETUP_LATENCY_BURST_SIZE; i++)
+            {
+                int portOnBridge = -1;
+                mediaInterface->getConnectionPortOnBridge(connectionIds[i], 0,
+                                                          portOnBridge);
+                CPPUNIT_ASSERT(portOnBridge >= 0);
+            }
+
+            for (i = 0; i < SETUP_LATENCY_BURST_SIZE; i++)
+            {
+                CPPUNIT_ASSERT_EQUAL(OS_SUCCESS,
+                                     mediaInterface->deleteConnection(connectionIds[i]));
+            }
+        }
+
+        latencyUsecs /= SETUP_LATENCY_BURSTS * SETUP_LATENCY_BURST_SIZE;
+        cpuUsecs /= SETUP_LATENCY_BURSTS * SETUP_LATENCY_BURST_SIZE;
+    }
+#endif
+
+    void testConnectionSetupLatency()
+    {
+        CPPUNIT_ASSERT(mpMediaFactory);
+
+        CpMediaInterface* mediaInterface = 
+            mpMediaFactory->createMediaInterface(NULL, "127.0.0.1", 0, NULL, 
+                                                 "", 0, "", 0, 0, "",
+                                                 0, "", "", 0, false);
+        // Add created media interface to the list, to allow it be
+        // freed in tearDown() if assertion occurs.
+        mMediaInterfaces.append(mediaInterface);
+
+#ifdef ENABLE_TOPOLOGY_FLOWGRAPH_INTERFACE_FACTORY
+        UtlString miType = mediaInterface->getType();
+        CPPUNIT_ASSERT(miType == "CpTopologyGraphInterface");
+        CpTopologyGraphFactoryImpl* pFactoryImpl =
+            (CpTopologyGraphFactoryImpl*)mpMediaFactory->getFactoryImplementation();
+        int defaultPrebuilt = pFactoryImpl->getPrebuiltConnections();
+        UtlSList sockets;
+        double noPoolLatency;
+        double noPoolCpu;
+        double poolLatency;
+        double poolCpu;
+
+        // Resources constructed and linked as the connection is created
+        pFactoryImpl->setPrebuiltConnections(0);
+        measureConnectionSetup((CpTopologyGraphInterface*)mediaInterface,
+                               sockets, noPoolLatency, noPoolCpu);
+
+        // Resources taken from the pool, which is refilled on delete
+        pFactoryImpl->setPrebuiltConnections(SETUP_LATENCY_BURST_SIZE);
+        measureConnectionSetup((CpTopologyGraphInterface*)mediaInterface,
+                               sockets, poolLatency, poolCpu);
+
+        pFactoryImpl->setPrebuiltConnections(defaultPrebuilt);
+
+        printf("connection setup, %d connections in bursts of %d:\n"
+               "                  latency      CPU (usecs per connection)\n"
+               "   without pool: %8.0f %8.0f\n"
+               "   with pool:    %8.0f %8.0f\n",
+               SETUP_LATENCY_BURST_SIZE * SETUP_LATENCY_BURSTS,
+               SETUP_LATENCY_BURST_SIZE,
+               noPoolLatency, noPoolCpu, poolLatency, poolCpu);
+#else
+        printf("testConnectionSetupLatency: the connection pool is only used "
+               "by CpTopologyGraphInterface\n");
+#endif
+
+        // delete interface
+        mMediaInterfaces.remove(mediaInterface);
+        mediaInterface->release(); 
+
+#ifdef ENABLE_TOPOLOGY_FLOWGRAPH_INTERFACE_FACTORY
+        UtlVoidPtr* pSocket;
+        while ((pSocket = (UtlVoidPtr*)sockets.get()))
+        {
+            delete (OsSocket*)pSocket->getValue();
+            delete pSocket;
+        }
+#endif
+    }
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(CpPhoneMediaInterfaceTest);
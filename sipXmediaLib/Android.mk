@@ -51,6 +51,7 @@ LOCAL_SRC_FILES := \
     src/mp/MpAudioOutputConnection.cpp \
     src/mp/MpAudioResource.cpp \
     src/mp/MpAudioUtils.cpp \
+    src/mp/MpBridgeAlgCommonMix.cpp \
     src/mp/MpBridgeAlgLinear.cpp \
     src/mp/MpBridgeAlgSimple.cpp \
     src/mp/MpBuf.cpp \
@@ -63,6 +64,7 @@ LOCAL_SRC_FILES := \
     src/mp/MpDecoderBase.cpp \
     src/mp/MpDecoderPayloadMap.cpp \
     src/mp/MpDspUtils.cpp \
+    src/mp/MpDspUtilsSimd.cpp \
     src/mp/MpDTMFDetector.cpp \
     src/mp/MpEncoderBase.cpp \
     src/mp/MpFlowGraphBase.cpp \
@@ -79,6 +81,7 @@ LOCAL_SRC_FILES := \
     src/mp/MpMediaTaskMsg.cpp \
     src/mp/MpMisc.cpp \
     src/mp/MpMMTimer.cpp \
+    src/mp/MpMMTimerMonotonic.cpp \
     src/mp/MpMMTimerPosix.cpp \
     src/mp/MpodAndroid.cpp \
     src/mp/MpodBufferRecorder.cpp \
@@ -97,6 +100,7 @@ LOCAL_SRC_FILES := \
     src/mp/MpResource.cpp \
     src/mp/MpResourceFactory.cpp \
     src/mp/MpResourceMsg.cpp \
+    src/mp/MpResourceSet.cpp \
     src/mp/MpResourceSortAlg.cpp \
     src/mp/MpResourceTopology.cpp \
     src/mp/MpResNotificationMsg.cpp \
@@ -140,6 +144,7 @@ LOCAL_SRC_FILES := \
     src/mp/MpStreamQueuePlayer.cpp \
     src/mp/MpSpeakerSelectBase.cpp \
     src/mp/MpPlcBase.cpp \
+    src/mp/MpPlcPitch.cpp \
     src/mp/MpPlcSilence.cpp \
     src/mp/MpPlgStaffV1.cpp \
     src/mp/MpTopologyGraph.cpp \
@@ -477,6 +482,7 @@ LOCAL_SRC_FILES := \
     src/test/mp/MprSplitterTest.cpp \
     src/test/mp/MprToSpkrTest.cpp \
     src/test/mp/MprToneGenTest.cpp \
+    src/test/mp/NetInTaskTest.cpp \
 
 
 LOCAL_CFLAGS += -DDISABLE_STREAM_PLAYER
@@ -565,6 +571,7 @@ LOCAL_SRC_FILES := \
     src/mp/codecs/plgpcmapcmu/CodecPcmaWrapper.c \
     src/mp/codecs/plgpcmapcmu/CodecPcmuWrapper.c \
     src/mp/codecs/plgpcmapcmu/G711.c \
+    src/mp/codecs/plgpcmapcmu/G711Tables.c \
     src/mp/codecs/plgpcmapcmu/PlgPcmaPcmu.c \
     contrib/libspandsp/src/g711.c
 
@@ -744,6 +751,7 @@ LOCAL_SRC_FILES := \
     src/test/mp/MprSplitterTest.cpp \
     src/test/mp/MprToSpkrTest.cpp \
     src/test/mp/MprToneGenTest.cpp \
+    src/test/mp/NetInTaskTest.cpp \
 
 Unit_tests_crash := \
     src/test/mp/MpMMTimerTest.cpp \
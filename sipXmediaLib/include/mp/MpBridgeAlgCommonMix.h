@@ -0,0 +1,171 @@
+//
+// Copyright (C) 2026 SIPez LLC. All rights reserved.
+//
+//
+// $$
+//////////////////////////////////////////////////////////////////////////////
+
+#ifndef _MpBridgeAlgCommonMix_h_
+#define _MpBridgeAlgCommonMix_h_
+
+// SYSTEM INCLUDES
+// APPLICATION INCLUDES
+#include "mp/MpBridgeAlgBase.h"
+
+// DEFINES
+// MACROS
+// EXTERNAL FUNCTIONS
+// EXTERNAL VARIABLES
+// STRUCTS
+// TYPEDEFS
+// FORWARD DECLARATIONS
+
+/**
+*  @brief Bridge mixing algorithm which mixes all inputs once and derives
+*         every output from this common mix.
+*
+*  In a conference nearly every output is "sum of all inputs minus own
+*  input", so nearly every column of the gain matrix holds the same gain
+*  for all outputs. For every input we choose the gain used by most of the
+*  outputs as the common gain of the input and keep only the matrix
+*  elements which differ from it in a sparse deviation list per output.
+*
+*  doMix() mixes every active input into a common accumulator once with
+*  its common gain, using the vector functions of MpDspUtils. Then every
+*  output starts from a copy of the common accumulator and only its
+*  deviations are corrected: the input is subtracted with its common gain
+*  and added with the output's own gain. Outputs without deviations share
+*  a single buffer. Thus a conference of N parties takes O(N) vector
+*  operations per frame instead of O(N^2) for MpBridgeAlgSimple.
+*
+*  Silent inputs (if mixSilence is FALSE), muted and missing inputs are
+*  skipped entirely, as in MpBridgeAlgLinear, and outputs which have no
+*  inputs mixed to them get no buffer.
+*
+*  Amplitude scaling, output amplitude and speech type are the same as
+*  with MpBridgeAlgSimple and the produced samples are bit-exact with it,
+*  unless the 32-bit common accumulator itself saturates.
+*/
+class MpBridgeAlgCommonMix : public MpBridgeAlgBase
+{
+/* //////////////////////////////// PUBLIC //////////////////////////////// */
+public:
+
+/* =============================== CREATORS =============================== */
+///@name Creators
+//@{
+
+     /// Constructor.
+   MpBridgeAlgCommonMix(int maxInputs, int maxOutputs, UtlBoolean mixSilence,
+                        int samplesPerFrame);
+
+     /// Destructor.
+   ~MpBridgeAlgCommonMix();
+
+//@}
+
+/* ============================= MANIPULATORS ============================= */
+///@name Manipulators
+//@{
+
+     /// @copydoc MpBridgeAlgBase::doMix()
+   UtlBoolean doMix(MpBufPtr inBufs[], int inBufsSize,
+                    MpBufPtr outBufs[], int outBufsSize,
+                    int samplesPerFrame);
+
+     /// @copydoc MpBridgeAlgBase::setGainMatrixValue()
+   void setGainMatrixValue(int column, int row, MpBridgeGain val);
+
+     /// @copydoc MpBridgeAlgBase::setGainMatrixRow()
+   void setGainMatrixRow(int row, int numValues, const MpBridgeGain val[]);
+
+     /// @copydoc MpBridgeAlgBase::setGainMatrixColumn()
+   void setGainMatrixColumn(int column, int numValues, const MpBridgeGain val[]);
+
+//@}
+
+/* ============================== ACCESSORS =============================== */
+///@name Accessors
+//@{
+
+
+//@}
+
+/* =============================== INQUIRY ================================ */
+///@name Inquiry
+//@{
+
+
+//@}
+
+/* ////////////////////////////// PROTECTED /////////////////////////////// */
+protected:
+
+     /// Element of the gain matrix which differs from the common gain.
+   struct GainDeviation
+   {
+      int mInput;           ///< Input (column) of the element.
+      MpBridgeGain mGain;   ///< Gain of the element.
+   };
+
+   enum {
+      NUM_SPEECH_TYPES = MP_SPEECH_TONE+1 ///< Size of the speech type counters.
+   };
+
+     /// Find common gains and deviations from the gain matrix.
+   void updateDeviations();
+
+     /// Mix one input frame into accumulator as MpBridgeAlgSimple does.
+   static
+   int32_t mixInput(const MpAudioSample *pSrc, MpBridgeGain gain,
+                    MpAudioSample prevAmplitude, MpAudioSample curAmplitude,
+                    UtlBoolean subtract,
+                    MpBridgeAccum *pAccum, int samplesPerFrame);
+     /**<
+     *  @param[in] subtract - if TRUE, scaled input is subtracted from
+     *             accumulator instead of being added to it.
+     *  @returns Contribution of the input to the output amplitude.
+     */
+
+     /// Speech type of the mix of inputs with given speech types.
+   static
+   MpSpeechType mixedSpeechType(const int speechTypeCount[]);
+
+     /// Get output buffer and fill it with data from accumulator.
+   static
+   MpAudioBufPtr makeOutput(const MpBridgeAccum *pAccum, int32_t amplitude,
+                            MpSpeechType speechType, int samplesPerFrame);
+
+   MpBridgeGain*  mpGainMatrix;        ///< mMaxOutputs x mMaxInputs array
+                    ///< of inputs to outputs gains.
+   MpBridgeGain*  mpCommonGains;       ///< Gain used by most of outputs
+                    ///< for every input. Have size of mMaxInputs.
+   int*           mpDeviationStart;    ///< Index of the first deviation of
+                    ///< every output in mpDeviations. Have size of
+                    ///< mMaxOutputs+1, last element is the end of the list.
+   GainDeviation* mpDeviations;        ///< Deviations from common gains
+                    ///< sorted by output. Have size of mMaxInputs*mMaxOutputs.
+   UtlBoolean     mDeviationsValid;    ///< Are mpCommonGains and mpDeviations
+                    ///< up to date with mpGainMatrix?
+   MpBridgeAccum* mpCommonAccumulator; ///< Accumulator to store the common mix.
+                    ///< Have size of mSamplesPerFrame.
+   MpBridgeAccum* mpMixAccumulator;    ///< Accumulator to store an output mix.
+                    ///< Have size of mSamplesPerFrame.
+   UtlBoolean*    mpActiveInputs;      ///< Is an input mixed in this frame?
+                    ///< Have size of mMaxInputs. Used in doMix() only.
+   int32_t*       mpCommonAmplitudes;  ///< Contribution of every active input
+                    ///< to the common mix amplitude. Used in doMix() only.
+
+/* /////////////////////////////// PRIVATE //////////////////////////////// */
+private:
+
+     /// Copy constructor (not implemented for this class)
+   MpBridgeAlgCommonMix(const MpBridgeAlgCommonMix& rMpBridgeAlgCommonMix);
+
+     /// Assignment operator (not implemented for this class)
+   MpBridgeAlgCommonMix& operator=(const MpBridgeAlgCommonMix& rhs);
+};
+
+/* ============================ INLINE METHODS ============================ */
+
+#endif  // _MpBridgeAlgCommonMix_h_
@@ -27,6 +27,23 @@
 // messages and more asserts.
 //#define MPBUF_DEBUG
 
+// Reference counter updates are atomic where the compiler provides atomic
+// builtins, so copies of one MpBufPtr may be released by different threads.
+// MPBUF_REF_ATOMIC is defined then.
+#if defined(__ATOMIC_ACQ_REL) // [
+#  define MPBUF_REF_ATOMIC
+#  define MPBUF_REF_INCREMENT(pCounter) __atomic_add_fetch((pCounter), 1, __ATOMIC_RELAXED)
+#  define MPBUF_REF_DECREMENT(pCounter) __atomic_sub_fetch((pCounter), 1, __ATOMIC_ACQ_REL)
+#elif defined(_MSC_VER) // __ATOMIC_ACQ_REL ][
+#  include <intrin.h>
+#  define MPBUF_REF_ATOMIC
+#  define MPBUF_REF_INCREMENT(pCounter) _InterlockedIncrement((volatile long*)(pCounter))
+#  define MPBUF_REF_DECREMENT(pCounter) _InterlockedDecrement((volatile long*)(pCounter))
+#else // _MSC_VER ][
+#  define MPBUF_REF_INCREMENT(pCounter) (++*(pCounter))
+#  define MPBUF_REF_DECREMENT(pCounter) (--*(pCounter))
+#endif // !_MSC_VER ]
+
 // EXTERNAL FUNCTIONS
 // EXTERNAL VARIABLES
 // FORWARD DECLARATIONS
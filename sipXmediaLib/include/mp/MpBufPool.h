@@ -12,10 +12,21 @@
 
 // SYSTEM INCLUDES
 // APPLICATION INCLUDES
+#include <os/OsIntTypes.h>
 #include <os/OsMutex.h>
 #include <utl/UtlString.h>
 
 // DEFINES
+
+// Take and return buffers with atomic compare and exchange where the compiler
+// provides it for 8 byte values.  Define MPBUFPOOL_USE_MUTEX to always use
+// the pool mutex instead.
+#if !defined(MPBUFPOOL_USE_MUTEX) && defined(__GCC_ATOMIC_LLONG_LOCK_FREE) // [
+#  if __GCC_ATOMIC_LLONG_LOCK_FREE == 2 && __GCC_ATOMIC_POINTER_LOCK_FREE == 2
+#     define MPBUFPOOL_LOCK_FREE
+#  endif
+#endif // !MPBUFPOOL_USE_MUTEX && __GCC_ATOMIC_LLONG_LOCK_FREE ]
+
 // MACROS
 // EXTERNAL FUNCTIONS
 // EXTERNAL VARIABLES
@@ -24,11 +35,19 @@
 // TYPEDEFS
 
 struct MpBuf;
-struct MpBufList;
 class MpFlowGraphBase;
 class UtlString;
 
 /// Pool of buffers.
+/**
+*  Free blocks are kept in a stack.  Where MPBUFPOOL_LOCK_FREE is defined
+*  getBuffer() and releaseBuffer() pop and push it with compare and exchange,
+*  so the media task and the network tasks do not wait for each other.
+*  The top of the stack is the index of the block, which is tagged with a
+*  counter changed by every push and pop, so a pop never succeeds with a top
+*  taken and returned by other threads meanwhile (the ABA problem).
+*  Otherwise the stack is guarded by mMutex.
+*/
 class MpBufPool {
 
 /* //////////////////////////// PUBLIC //////////////////////////////////// */
@@ -102,8 +121,12 @@ protected:
 
     /// Return pointer to the block, next to this.
     char *getNextBlock(char *pBlock) {return pBlock + mBlockSpan;}
-    
-    void appendFreeList(MpBuf *pBuf);
+
+    /// Take the block from the top of the free stack, NULL if it is empty.
+    MpBuf *popFreeList();
+
+    /// Put the block on the top of the free stack.
+    void pushFreeList(MpBuf *pBuf);
 
     UtlString  mPoolName;      ///< label or name for debug
     unsigned   mBlockSize;     ///< Requested size of each block in pool (in bytes).
@@ -112,9 +135,13 @@ protected:
     unsigned   mPoolBytes;     ///< Size of all pool in bytes.
     char      *mpPoolData;     ///< Pointer to allocated memory.
                                ///<  May be padded to match align rules.
-    MpBufList *mpFreeList;     ///< Begin of the free blocks list.
-                               ///<  NULL if there are no free blocks availiable.
-    OsMutex    mMutex;         ///< Mutex to avoid concurrent access to the pool.
+    uint64_t   mFreeTop;       ///< Top of the free block stack: number of the
+                               ///<  block plus one in the low 32 bits (0 if there
+                               ///<  are no free blocks) and the tag in the high ones.
+    unsigned  *mpNextFree;     ///< Number plus one of the free block below each
+                               ///<  block in the stack.
+    OsMutex    mMutex;         ///< Mutex to avoid concurrent access to the pool
+                               ///<  where MPBUFPOOL_LOCK_FREE is not defined.
 
 /* //////////////////////////// PRIVATE /////////////////////////////////// */
 private:
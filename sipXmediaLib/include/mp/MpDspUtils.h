@@ -23,6 +23,17 @@
 #  define MP_DSP_VECTOR_API
 #endif // MP_DSP_INLINE_VECTOR_FUNCTIONS ]
 
+/// Use SSE2/AVX2 versions of fixed-point vector functions when CPU has them.
+/**
+*  Define MP_DSP_NO_SIMD (configure --disable-dsp-simd) to always use the
+*  generic C versions. Instruction set is detected at runtime, so no special
+*  compiler flags are needed to build optimized versions.
+*/
+#if defined(MP_FIXED_POINT) && !defined(MP_DSP_NO_SIMD) && \
+    defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+#  define MP_DSP_SIMD
+#endif
+
 // SYSTEM INCLUDES
 // APPLICATION INCLUDES
 #include <os/OsStatus.h>
@@ -115,6 +126,14 @@
 *  When creating new function, do not forget to provide clean C implementation
 *  for convenience.
 *
+*  <H3>SIMD versions.</H3>
+*
+*  When MP_DSP_SIMD is defined, fixed-point vector functions used for mixing
+*  are dispatched at runtime to SSE2 or AVX2 versions, depending on what
+*  the CPU supports (see setSimdLevel()). Generic C versions stay available
+*  with \c _C suffix and are the reference optimized versions must match
+*  bit-exactly.
+*
 *  @warning Please, keep all methods of this class static and stateless!
 */
 class MpDspUtils
@@ -122,6 +141,14 @@ class MpDspUtils
 /* //////////////////////////////// PUBLIC //////////////////////////////// */
 public:
 
+     /// Instruction set extensions, used by vector functions.
+   enum SimdLevel
+   {
+      SIMD_NONE = 0, ///< Generic C versions only.
+      SIMD_SSE2,     ///< SSE2 versions.
+      SIMD_AVX2      ///< AVX2 versions (SSE2 for functions without AVX2 version).
+   };
+
 /* ========================= Arithmetic Functions ========================= */
 ///@name Arithmetic Functions
 //@{
@@ -331,6 +358,29 @@ public:
      *        further discussion.
      */
 
+     /// @name Generic C versions of above functions.
+     /// These are reference implementations for SIMD versions of functions.
+   //@{
+   static MP_DSP_VECTOR_API
+   OsStatus add_I_C(const int16_t *pSrc1, int32_t *pSrc2Dst, int dataLength);
+   static MP_DSP_VECTOR_API
+   OsStatus add_IGain_C(const int16_t *pSrc1, int32_t *pSrc2Dst, int dataLength, unsigned src1ScaleFactor);
+   static MP_DSP_VECTOR_API
+   OsStatus add_IAtt_C(const int16_t *pSrc1, int32_t *pSrc2Dst, int dataLength, unsigned src1ScaleFactor);
+   static MP_DSP_VECTOR_API
+   OsStatus add_C(const int32_t *pSrc1, const int32_t *pSrc2, int32_t *pDst, int dataLength);
+   static MP_DSP_VECTOR_API
+   OsStatus addMul_I_C(const int16_t *pSrc1, int16_t val, int32_t *pSrc2Dst, int dataLength);
+   static MP_DSP_VECTOR_API
+   OsStatus addMulLinear_I_C(const int16_t *pSrc1, int16_t valStart, int16_t valEnd,
+                             int32_t *pSrc2Dst, int dataLength);
+   static MP_DSP_VECTOR_API
+   OsStatus mul_C(const int16_t *pSrc, const int16_t val, int32_t *pDst, int dataLength);
+   static MP_DSP_VECTOR_API
+   OsStatus mulLinear_C(const int16_t *pSrc, int16_t valStart, int16_t valEnd,
+                        int32_t *pDst, int dataLength);
+   //@}
+
 #else  // MP_FIXED_POINT ][
 
      /// Add source vector to accumulator.
@@ -460,6 +510,23 @@ public:
      *  @todo Write unittest!!!
      */
 
+     /// @name Generic C versions of above functions.
+     /// These are reference implementations for SIMD versions of functions.
+   //@{
+   static MP_DSP_VECTOR_API
+   OsStatus convert_C(const int32_t *pSrc, int16_t *pDst, int dataLength);
+   static MP_DSP_VECTOR_API
+   OsStatus convert_Gain_C(const int32_t *pSrc, int16_t *pDst, int dataLength, unsigned srcScaleFactor);
+   static MP_DSP_VECTOR_API
+   OsStatus convert_Att_C(const int32_t *pSrc, int16_t *pDst, int dataLength, unsigned srcScaleFactor);
+   static MP_DSP_VECTOR_API
+   OsStatus convert_C(const int16_t *pSrc, int32_t *pDst, int dataLength);
+   static MP_DSP_VECTOR_API
+   OsStatus convert_Gain_C(const int16_t *pSrc, int32_t *pDst, int dataLength, unsigned srcScaleFactor);
+   static MP_DSP_VECTOR_API
+   OsStatus convert_Att_C(const int16_t *pSrc, int32_t *pDst, int dataLength, unsigned srcScaleFactor);
+   //@}
+
 #else  // MP_FIXED_POINT ][
 
      /// Convert type of source vector.
@@ -516,6 +583,58 @@ public:
 
 //@}
 
+/* ======================== SIMD Dispatch Control ========================= */
+///@name SIMD Dispatch Control
+//@{
+
+     /// Best instruction set extension supported by this CPU and build.
+   static SimdLevel getMaxSimdLevel();
+
+     /// Instruction set extension currently used by vector functions.
+   static SimdLevel getSimdLevel();
+
+     /// Select instruction set extension used by vector functions.
+   static SimdLevel setSimdLevel(SimdLevel level);
+     /**<
+     *  By default best supported level is used. This is meant for unittests
+     *  and benchmarks, and should not be called while media is processed.
+     *
+     *  @param[in] level - requested level. It is lowered to
+     *             getMaxSimdLevel() if it is not supported.
+     *  @returns Level actually set.
+     */
+
+//@}
+
+/* ////////////////////////////// PRIVATE /////////////////////////////// */
+private:
+
+#ifdef MP_DSP_SIMD // [
+     /// Implementations of vector functions for one instruction set.
+   struct VectorKernels
+   {
+      OsStatus (*add_I)(const int16_t*, int32_t*, int);
+      OsStatus (*add_IGain)(const int16_t*, int32_t*, int, unsigned);
+      OsStatus (*add_IAtt)(const int16_t*, int32_t*, int, unsigned);
+      OsStatus (*add)(const int32_t*, const int32_t*, int32_t*, int);
+      OsStatus (*addMul_I)(const int16_t*, int16_t, int32_t*, int);
+      OsStatus (*addMulLinear_I)(const int16_t*, int16_t, int16_t, int32_t*, int);
+      OsStatus (*mul)(const int16_t*, const int16_t, int32_t*, int);
+      OsStatus (*mulLinear)(const int16_t*, int16_t, int16_t, int32_t*, int);
+      OsStatus (*convert32to16)(const int32_t*, int16_t*, int);
+      OsStatus (*convert_Gain32to16)(const int32_t*, int16_t*, int, unsigned);
+      OsStatus (*convert_Att32to16)(const int32_t*, int16_t*, int, unsigned);
+      OsStatus (*convert16to32)(const int16_t*, int32_t*, int);
+      OsStatus (*convert_Gain16to32)(const int16_t*, int32_t*, int, unsigned);
+      OsStatus (*convert_Att16to32)(const int16_t*, int32_t*, int, unsigned);
+   };
+
+   static const VectorKernels smCKernels;    ///< Generic C versions.
+   static const VectorKernels smSse2Kernels; ///< SSE2 versions.
+   static const VectorKernels smAvx2Kernels; ///< AVX2 versions.
+   static const VectorKernels *smpVectorKernels; ///< Versions in use.
+#endif // MP_DSP_SIMD ]
+
 };
 
 /* ============================ INLINE METHODS ============================ */
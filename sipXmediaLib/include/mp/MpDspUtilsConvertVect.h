@@ -24,7 +24,7 @@
 
 #ifdef MP_FIXED_POINT // [
 
-OsStatus MpDspUtils::convert(const int32_t *pSrc, int16_t *pDst, int dataLength)
+OsStatus MpDspUtils::convert_C(const int32_t *pSrc, int16_t *pDst, int dataLength)
 {
    for (int i=0; i<dataLength; i++)
    {
@@ -33,7 +33,7 @@ OsStatus MpDspUtils::convert(const int32_t *pSrc, int16_t *pDst, int dataLength)
    return OS_SUCCESS;
 }
 
-OsStatus MpDspUtils::convert_Gain(const int32_t *pSrc, int16_t *pDst, int dataLength, unsigned srcScaleFactor)
+OsStatus MpDspUtils::convert_Gain_C(const int32_t *pSrc, int16_t *pDst, int dataLength, unsigned srcScaleFactor)
 {
    for (int i=0; i<dataLength; i++)
    {
@@ -42,7 +42,7 @@ OsStatus MpDspUtils::convert_Gain(const int32_t *pSrc, int16_t *pDst, int dataLe
    return OS_SUCCESS;
 }
 
-OsStatus MpDspUtils::convert_Att(const int32_t *pSrc, int16_t *pDst, int dataLength, unsigned srcScaleFactor)
+OsStatus MpDspUtils::convert_Att_C(const int32_t *pSrc, int16_t *pDst, int dataLength, unsigned srcScaleFactor)
 {
    for (int i=0; i<dataLength; i++)
    {
@@ -51,7 +51,7 @@ OsStatus MpDspUtils::convert_Att(const int32_t *pSrc, int16_t *pDst, int dataLen
    return OS_SUCCESS;
 }
 
-OsStatus MpDspUtils::convert(const int16_t *pSrc, int32_t *pDst, int dataLength)
+OsStatus MpDspUtils::convert_C(const int16_t *pSrc, int32_t *pDst, int dataLength)
 {
    for (int i=0; i<dataLength; i++)
    {
@@ -60,7 +60,7 @@ OsStatus MpDspUtils::convert(const int16_t *pSrc, int32_t *pDst, int dataLength)
    return OS_SUCCESS;
 }
 
-OsStatus MpDspUtils::convert_Gain(const int16_t *pSrc, int32_t *pDst, int dataLength, unsigned srcScaleFactor)
+OsStatus MpDspUtils::convert_Gain_C(const int16_t *pSrc, int32_t *pDst, int dataLength, unsigned srcScaleFactor)
 {
    for (int i=0; i<dataLength; i++)
    {
@@ -69,7 +69,7 @@ OsStatus MpDspUtils::convert_Gain(const int16_t *pSrc, int32_t *pDst, int dataLe
    return OS_SUCCESS;
 }
 
-OsStatus MpDspUtils::convert_Att(const int16_t *pSrc, int32_t *pDst, int dataLength, unsigned srcScaleFactor)
+OsStatus MpDspUtils::convert_Att_C(const int16_t *pSrc, int32_t *pDst, int dataLength, unsigned srcScaleFactor)
 {
    for (int i=0; i<dataLength; i++)
    {
@@ -78,6 +78,60 @@ OsStatus MpDspUtils::convert_Att(const int16_t *pSrc, int32_t *pDst, int dataLen
    return OS_SUCCESS;
 }
 
+OsStatus MpDspUtils::convert(const int32_t *pSrc, int16_t *pDst, int dataLength)
+{
+#ifdef MP_DSP_SIMD // [
+   return smpVectorKernels->convert32to16(pSrc, pDst, dataLength);
+#else  // MP_DSP_SIMD ][
+   return convert_C(pSrc, pDst, dataLength);
+#endif // MP_DSP_SIMD ]
+}
+
+OsStatus MpDspUtils::convert_Gain(const int32_t *pSrc, int16_t *pDst, int dataLength, unsigned srcScaleFactor)
+{
+#ifdef MP_DSP_SIMD // [
+   return smpVectorKernels->convert_Gain32to16(pSrc, pDst, dataLength, srcScaleFactor);
+#else  // MP_DSP_SIMD ][
+   return convert_Gain_C(pSrc, pDst, dataLength, srcScaleFactor);
+#endif // MP_DSP_SIMD ]
+}
+
+OsStatus MpDspUtils::convert_Att(const int32_t *pSrc, int16_t *pDst, int dataLength, unsigned srcScaleFactor)
+{
+#ifdef MP_DSP_SIMD // [
+   return smpVectorKernels->convert_Att32to16(pSrc, pDst, dataLength, srcScaleFactor);
+#else  // MP_DSP_SIMD ][
+   return convert_Att_C(pSrc, pDst, dataLength, srcScaleFactor);
+#endif // MP_DSP_SIMD ]
+}
+
+OsStatus MpDspUtils::convert(const int16_t *pSrc, int32_t *pDst, int dataLength)
+{
+#ifdef MP_DSP_SIMD // [
+   return smpVectorKernels->convert16to32(pSrc, pDst, dataLength);
+#else  // MP_DSP_SIMD ][
+   return convert_C(pSrc, pDst, dataLength);
+#endif // MP_DSP_SIMD ]
+}
+
+OsStatus MpDspUtils::convert_Gain(const int16_t *pSrc, int32_t *pDst, int dataLength, unsigned srcScaleFactor)
+{
+#ifdef MP_DSP_SIMD // [
+   return smpVectorKernels->convert_Gain16to32(pSrc, pDst, dataLength, srcScaleFactor);
+#else  // MP_DSP_SIMD ][
+   return convert_Gain_C(pSrc, pDst, dataLength, srcScaleFactor);
+#endif // MP_DSP_SIMD ]
+}
+
+OsStatus MpDspUtils::convert_Att(const int16_t *pSrc, int32_t *pDst, int dataLength, unsigned srcScaleFactor)
+{
+#ifdef MP_DSP_SIMD // [
+   return smpVectorKernels->convert_Att16to32(pSrc, pDst, dataLength, srcScaleFactor);
+#else  // MP_DSP_SIMD ][
+   return convert_Att_C(pSrc, pDst, dataLength, srcScaleFactor);
+#endif // MP_DSP_SIMD ]
+}
+
 #else  // MP_FIXED_POINT ][
 
 OsStatus MpDspUtils::convert(const float *pSrc, int16_t *pDst, int dataLength)
@@ -23,7 +23,7 @@
 
 #ifdef MP_FIXED_POINT // [
 
-OsStatus MpDspUtils::add_I(const int16_t *pSrc1, int32_t *pSrc2Dst, int dataLength)
+OsStatus MpDspUtils::add_I_C(const int16_t *pSrc1, int32_t *pSrc2Dst, int dataLength)
 {
    for (int i=0; i<dataLength; i++)
    {
@@ -32,7 +32,7 @@ OsStatus MpDspUtils::add_I(const int16_t *pSrc1, int32_t *pSrc2Dst, int dataLeng
    return OS_SUCCESS;
 }
 
-OsStatus MpDspUtils::add_IGain(const int16_t *pSrc1, int32_t *pSrc2Dst, int dataLength, unsigned src1ScaleFactor)
+OsStatus MpDspUtils::add_IGain_C(const int16_t *pSrc1, int32_t *pSrc2Dst, int dataLength, unsigned src1ScaleFactor)
 {
    for (int i=0; i<dataLength; i++)
    {
@@ -42,7 +42,7 @@ OsStatus MpDspUtils::add_IGain(const int16_t *pSrc1, int32_t *pSrc2Dst, int data
    return OS_SUCCESS;
 }
 
-OsStatus MpDspUtils::add_IAtt(const int16_t *pSrc1, int32_t *pSrc2Dst, int dataLength, unsigned src1ScaleFactor)
+OsStatus MpDspUtils::add_IAtt_C(const int16_t *pSrc1, int32_t *pSrc2Dst, int dataLength, unsigned src1ScaleFactor)
 {
    for (int i=0; i<dataLength; i++)
    {
@@ -52,7 +52,7 @@ OsStatus MpDspUtils::add_IAtt(const int16_t *pSrc1, int32_t *pSrc2Dst, int dataL
    return OS_SUCCESS;
 }
 
-OsStatus MpDspUtils::add(const int32_t *pSrc1, const int32_t *pSrc2, int32_t *pDst, int dataLength)
+OsStatus MpDspUtils::add_C(const int32_t *pSrc1, const int32_t *pSrc2, int32_t *pDst, int dataLength)
 {
    for (int i=0; i<dataLength; i++)
    {
@@ -61,7 +61,7 @@ OsStatus MpDspUtils::add(const int32_t *pSrc1, const int32_t *pSrc2, int32_t *pD
    return OS_SUCCESS;
 }
 
-OsStatus MpDspUtils::addMul_I(const int16_t *pSrc1, int16_t val, int32_t *pSrc2Dst, int dataLength)
+OsStatus MpDspUtils::addMul_I_C(const int16_t *pSrc1, int16_t val, int32_t *pSrc2Dst, int dataLength)
 {
    for (int i=0; i<dataLength; i++)
    {
@@ -71,7 +71,7 @@ OsStatus MpDspUtils::addMul_I(const int16_t *pSrc1, int16_t val, int32_t *pSrc2D
    return OS_SUCCESS;
 }
 
-OsStatus MpDspUtils::addMulLinear_I(const int16_t *pSrc1, int16_t valStart, int16_t valEnd,
+OsStatus MpDspUtils::addMulLinear_I_C(const int16_t *pSrc1, int16_t valStart, int16_t valEnd,
                                     int32_t *pSrc2Dst, int dataLength)
 {
    // TODO:: This works fine only when (dataLength << (valStart - valEnd)).
@@ -89,7 +89,7 @@ OsStatus MpDspUtils::addMulLinear_I(const int16_t *pSrc1, int16_t valStart, int1
    return OS_SUCCESS;
 }
 
-OsStatus MpDspUtils::mul(const int16_t *pSrc, const int16_t val, int32_t *pDst, int dataLength)
+OsStatus MpDspUtils::mul_C(const int16_t *pSrc, const int16_t val, int32_t *pDst, int dataLength)
 {
    for (int i=0; i<dataLength; i++)
    {
@@ -121,7 +121,7 @@ OsStatus MpDspUtils::mul_I(int16_t *pSrcDst, const int16_t val, int dataLength)
    return OS_SUCCESS;
 }
 
-OsStatus MpDspUtils::mulLinear(const int16_t *pSrc, int16_t valStart, int16_t valEnd,
+OsStatus MpDspUtils::mulLinear_C(const int16_t *pSrc, int16_t valStart, int16_t valEnd,
                                int32_t *pDst, int dataLength)
 {
    // TODO:: This works fine only when (dataLength << (valStart - valEnd)).
@@ -139,6 +139,80 @@ OsStatus MpDspUtils::mulLinear(const int16_t *pSrc, int16_t valStart, int16_t va
    return OS_SUCCESS;
 }
 
+OsStatus MpDspUtils::add_I(const int16_t *pSrc1, int32_t *pSrc2Dst, int dataLength)
+{
+#ifdef MP_DSP_SIMD // [
+   return smpVectorKernels->add_I(pSrc1, pSrc2Dst, dataLength);
+#else  // MP_DSP_SIMD ][
+   return add_I_C(pSrc1, pSrc2Dst, dataLength);
+#endif // MP_DSP_SIMD ]
+}
+
+OsStatus MpDspUtils::add_IGain(const int16_t *pSrc1, int32_t *pSrc2Dst, int dataLength, unsigned src1ScaleFactor)
+{
+#ifdef MP_DSP_SIMD // [
+   return smpVectorKernels->add_IGain(pSrc1, pSrc2Dst, dataLength, src1ScaleFactor);
+#else  // MP_DSP_SIMD ][
+   return add_IGain_C(pSrc1, pSrc2Dst, dataLength, src1ScaleFactor);
+#endif // MP_DSP_SIMD ]
+}
+
+OsStatus MpDspUtils::add_IAtt(const int16_t *pSrc1, int32_t *pSrc2Dst, int dataLength, unsigned src1ScaleFactor)
+{
+#ifdef MP_DSP_SIMD // [
+   return smpVectorKernels->add_IAtt(pSrc1, pSrc2Dst, dataLength, src1ScaleFactor);
+#else  // MP_DSP_SIMD ][
+   return add_IAtt_C(pSrc1, pSrc2Dst, dataLength, src1ScaleFactor);
+#endif // MP_DSP_SIMD ]
+}
+
+OsStatus MpDspUtils::add(const int32_t *pSrc1, const int32_t *pSrc2, int32_t *pDst, int dataLength)
+{
+#ifdef MP_DSP_SIMD // [
+   return smpVectorKernels->add(pSrc1, pSrc2, pDst, dataLength);
+#else  // MP_DSP_SIMD ][
+   return add_C(pSrc1, pSrc2, pDst, dataLength);
+#endif // MP_DSP_SIMD ]
+}
+
+OsStatus MpDspUtils::addMul_I(const int16_t *pSrc1, int16_t val, int32_t *pSrc2Dst, int dataLength)
+{
+#ifdef MP_DSP_SIMD // [
+   return smpVectorKernels->addMul_I(pSrc1, val, pSrc2Dst, dataLength);
+#else  // MP_DSP_SIMD ][
+   return addMul_I_C(pSrc1, val, pSrc2Dst, dataLength);
+#endif // MP_DSP_SIMD ]
+}
+
+OsStatus MpDspUtils::addMulLinear_I(const int16_t *pSrc1, int16_t valStart, int16_t valEnd,
+                                    int32_t *pSrc2Dst, int dataLength)
+{
+#ifdef MP_DSP_SIMD // [
+   return smpVectorKernels->addMulLinear_I(pSrc1, valStart, valEnd, pSrc2Dst, dataLength);
+#else  // MP_DSP_SIMD ][
+   return addMulLinear_I_C(pSrc1, valStart, valEnd, pSrc2Dst, dataLength);
+#endif // MP_DSP_SIMD ]
+}
+
+OsStatus MpDspUtils::mul(const int16_t *pSrc, const int16_t val, int32_t *pDst, int dataLength)
+{
+#ifdef MP_DSP_SIMD // [
+   return smpVectorKernels->mul(pSrc, val, pDst, dataLength);
+#else  // MP_DSP_SIMD ][
+   return mul_C(pSrc, val, pDst, dataLength);
+#endif // MP_DSP_SIMD ]
+}
+
+OsStatus MpDspUtils::mulLinear(const int16_t *pSrc, int16_t valStart, int16_t valEnd,
+                               int32_t *pDst, int dataLength)
+{
+#ifdef MP_DSP_SIMD // [
+   return smpVectorKernels->mulLinear(pSrc, valStart, valEnd, pDst, dataLength);
+#else  // MP_DSP_SIMD ][
+   return mulLinear_C(pSrc, valStart, valEnd, pDst, dataLength);
+#endif // MP_DSP_SIMD ]
+}
+
 #else  // MP_FIXED_POINT ][
 
 OsStatus MpDspUtils::add_I(const int16_t *pSrc1, float *pSrc2Dst, int dataLength)
@@ -44,6 +44,7 @@
 
 // FORWARD DECLARATIONS
 class MpFlowGraphMsg;
+class MpResourceSet;
 class OsMsg;
 
 /**
@@ -178,6 +179,27 @@ public:
      *  @retval OS_UNSPECIFIED - add resource attempt failed.
      */
 
+     /// Adds the resources of the set and their links to the flow graph.
+   OsStatus addResourceSet(MpResourceSet* pResourceSet);
+     /**<
+     *  All of the resources and links are added at once, with a single
+     *  message if the flow graph is "started", so the frame processing
+     *  never sees a part of the set.  The links between the resources of
+     *  the set were made before, the links to other resources of the flow
+     *  graph are made with them.
+     *
+     *  The flow graph takes ownership of \p pResourceSet, and destroys it
+     *  once the resources are added.  If they cannot be added (too many
+     *  resources, or a name already in use), the set destroys them.
+     *
+     *  If the flow graph is not "started", this call takes effect
+     *  immediately.  Otherwise, the call takes effect at the start of the
+     *  next frame processing interval.
+     *
+     *  @retval OS_SUCCESS - success.
+     *  @retval OS_UNSPECIFIED - add resource set attempt failed.
+     */
+
      /// @brief Stops the flow graph, removes all of the resources in the flow
      /// graph and destroys them.
    OsStatus destroyResources(void);
@@ -714,6 +736,13 @@ private:
      * @retval FALSE - otherwise.
      */
 
+     /// Handle the @link MpFlowGraphMsg::FLOWGRAPH_ADD_RESOURCE_SET FLOWGRAPH_ADD_RESOURCE_SET @endlink message.
+   UtlBoolean handleAddResourceSet(MpResourceSet* pResourceSet);
+     /**<
+     * @retval TRUE - if the message was handled.
+     * @retval FALSE - otherwise.
+     */
+
      /// Handle the @link MpFlowGraphMsg::FLOWGRAPH_DESTROY_RESOURCES FLOWGRAPH_DESTROY_RESOURCES @endlink message.
    UtlBoolean handleDestroyResources(void);
      /**<
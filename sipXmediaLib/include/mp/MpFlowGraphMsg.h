@@ -64,6 +64,8 @@ public:
 
       FLOWGRAPH_GET_LATENCY_FOR_PATH,
 
+      FLOWGRAPH_ADD_RESOURCE_SET,
+
       RESOURCE_SPECIFIC_START = 100     ///< start of resource-specific messages
    } MpFlowGraphMsgType;
 
@@ -61,7 +61,9 @@ public:
      *  @param[in] type = Do we want linear timer or notifications timer?
      *  @param[in] name - type of a timer to create. Empty string means default
      *             timer for this platform. To date we support "Windows Multimedia"
-     *             timers on Windows and "Posix" timers on Linux.
+     *             timers on Windows, "POSIX Timer" timers on POSIX systems and
+     *             "Monotonic Timer" timers on Linux, which are the default
+     *             there (see MpMMTimerMonotonic).
      */
 
      /// Destructor
@@ -0,0 +1,166 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _MpMMTimerMonotonic_h_
+#define _MpMMTimerMonotonic_h_
+
+// SYSTEM INCLUDES
+#include <time.h>
+#include <semaphore.h>
+#include <pthread.h>
+
+// APPLICATION INCLUDES
+#include <os/OsIntTypes.h>
+#include <os/OsMutex.h>
+#include <utl/UtlDefs.h>
+#include "mp/MpMMTimer.h"
+
+// DEFINES
+#define MMTIMER_MONOTONIC_MAX_PERIOD_USECS 1000000 ///< Longest period accepted by run().
+#define MMTIMER_MONOTONIC_MAX_BURST 10   ///< Most missed ticks delivered at once by CATCH_UP_BURST.
+
+// MACROS
+// EXTERNAL FUNCTIONS
+// EXTERNAL VARIABLES
+// CONSTANTS
+// STRUCTS
+// TYPEDEFS
+// FORWARD DECLARATIONS
+
+/**
+*  @brief Periodic timer sleeping to absolute deadlines on CLOCK_MONOTONIC.
+*
+*  A thread of the timer sleeps with clock_nanosleep(TIMER_ABSTIME) until
+*  the deadline of the next tick, and then delivers it.  Deadlines are
+*  computed from the time run() was called and the period, never from the
+*  time the thread woke up, so the ticks do not drift however late each
+*  wake-up is.  No signal is used, so unlike MpMMTimerPosix several timers
+*  may exist at once and other users of real-time signals are not disturbed.
+*
+*  When the thread wakes up a whole period or more after a deadline (an
+*  overrun), the ticks missed are handled according to the catch-up policy:
+*  they are either delivered right away, up to MMTIMER_MONOTONIC_MAX_BURST
+*  of them, or skipped.  Either way the next deadline stays on the grid of
+*  the period.
+*
+*  The timer keeps statistics of the wake-up lateness and of the overruns,
+*  see getStatistics().
+*/
+class MpMMTimerMonotonic : public MpMMTimer
+{
+/* //////////////////////////////// PUBLIC //////////////////////////////// */
+public:
+
+   static const char * const TYPE;
+
+   typedef enum
+   {
+      CATCH_UP_BURST, ///< Deliver the missed ticks at once, to keep the tick count.
+      CATCH_UP_SKIP   ///< Drop the missed ticks, to keep the tick spacing.
+   } CatchUpPolicy;
+
+     /// Timer statistics since run() or resetStatistics().
+   struct Statistics
+   {
+      uint64_t mWakeups;         ///< Wake-ups of the timer thread.
+      uint64_t mTicks;           ///< Ticks delivered.
+      uint64_t mOverruns;        ///< Wake-ups a whole period or more late.
+      uint64_t mSkippedTicks;    ///< Ticks dropped by the catch-up policy.
+      uint64_t mTotalLatenessUs; ///< Sum of the wake-up lateness.
+      unsigned mMaxLatenessUs;   ///< Latest wake-up after its deadline.
+   };
+
+/* =============================== CREATORS =============================== */
+///@name Creators
+//@{
+
+   MpMMTimerMonotonic(MpMMTimer::MMTimerType type);
+
+   ~MpMMTimerMonotonic();
+
+//@}
+
+/* ============================= MANIPULATORS ============================= */
+///@name Manipulators
+//@{
+
+     /// @copydoc MpMMTimer::setNotification()
+   OsStatus setNotification(OsNotification* notification);
+
+     /// @copydoc MpMMTimer::run()
+   OsStatus run(unsigned usecPeriodic);
+
+     /// @copydoc MpMMTimer::stop()
+   OsStatus stop();
+
+     /// @copydoc MpMMTimer::waitForNextTick()
+   OsStatus waitForNextTick();
+
+     /// Set what to do with the ticks missed by a late wake-up.
+   void setCatchUpPolicy(CatchUpPolicy policy);
+     /**<
+     *  The default is CATCH_UP_BURST, which is what MpMMTimerPosix does.
+     *  May be called while the timer runs.
+     */
+
+     /// Clear the statistics.
+   void resetStatistics();
+
+//@}
+
+/* ============================== ACCESSORS =============================== */
+///@name Accessors
+//@{
+
+     /// @copydoc MpMMTimer::getResolution()
+   OsStatus getResolution(unsigned& resolution);
+
+     /// @copydoc MpMMTimer::getPeriodRange()
+   OsStatus getPeriodRange(unsigned* pMinUSecs, unsigned* pMaxUSecs = NULL);
+
+     /// Get the catch-up policy.
+   CatchUpPolicy getCatchUpPolicy() const;
+
+     /// Get a copy of the statistics.
+   void getStatistics(Statistics& rStatistics) const;
+
+//@}
+
+/* ////////////////////////////// PROTECTED /////////////////////////////// */
+protected:
+   OsNotification* mpNotification; ///< Notification object used to signal a tick of the timer.
+   volatile UtlBoolean mbTimerStarted; ///< Is timer started.
+   sem_t mSyncSemaphore;           ///< Synchronization semaphore for linear operation.
+
+     /// Deliver the given number of ticks.
+   void fireTicks(unsigned numTicks);
+
+/* /////////////////////////////// PRIVATE //////////////////////////////// */
+private:
+   pthread_t mThread;              ///< Timer thread.
+   struct timespec mStartTime;     ///< Time run() was called.
+   unsigned mPeriodUSecs;          ///< Period given to run().
+   volatile CatchUpPolicy mCatchUpPolicy; ///< What to do with missed ticks.
+   mutable OsMutex mStatisticsMutex; ///< Guards mStatistics.
+   Statistics mStatistics;         ///< Statistics since run() or resetStatistics().
+
+     /// Timer thread main loop.
+   void runThread();
+
+     /// Timer thread function.
+   static void* threadWrapper(void* arg);
+
+     /// Copy constructor (not implemented for this class)
+   MpMMTimerMonotonic(const MpMMTimerMonotonic& rTimer);
+
+     /// Assignment operator (not implemented for this class)
+   MpMMTimerMonotonic& operator=(const MpMMTimerMonotonic& rhs);
+};
+
+/* ============================ INLINE METHODS ============================ */
+
+#endif //_MpMMTimerMonotonic_h_
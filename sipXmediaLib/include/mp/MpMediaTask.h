@@ -22,6 +22,8 @@
 #include "os/OsServerTask.h"
 #include "os/OsMsgPool.h"
 #include "os/OsCallback.h"
+#include "os/OsCSem.h"
+#include "os/OsAtomics.h"
 #include "mp/MpMediaTaskMsg.h"
 
 // DEFINES
@@ -38,6 +40,7 @@
 // FORWARD DECLARATIONS
 class MpFlowGraphBase;
 class OsNotification;
+class MpMediaTaskWorker;
 
 /**
 *  @brief Object responsible for coordinating the execution of media processing
@@ -91,6 +94,17 @@ class OsNotification;
 *  time to finish the frame processing for the current interval and then wait
 *  for the "start" signal for the next frame before processing any more messages.
 *
+*  <H3>Worker threads</H3>
+*  By default all started flow graphs are processed one after another in the
+*  media processing task.  <i>setWorkerThreads()</i> switches to processing
+*  them in parallel: the media processing task and a pool of worker tasks take
+*  flow graphs off a shared frame counter until none are left, and the frame
+*  completes when all of them are done.  Only flow graphs which do not share
+*  unprotected state may be run this way.  The time each flow graph took for
+*  its last frame is available from <i>getFlowGraphProcessingTime()</i>, and
+*  frames that completed later than the time limit after their "frame start"
+*  signal are counted by <i>getDeadlineMissCnt()</i>.
+*
 *  @nosubgrouping
 */
 class MpMediaTask : public OsServerTask
@@ -100,7 +114,8 @@ public:
    enum {
        DEF_TIME_LIMIT_USECS    = 6000,  ///< processing limit  = 6 msecs
        DEF_SEM_WAIT_MSECS      = 500,   ///< semaphore timeout = 0.5 secs
-       MEDIA_TASK_PRIORITY     = 0      ///< media task execution priority
+       MEDIA_TASK_PRIORITY     = 0,     ///< media task execution priority
+       MAX_WORKER_THREADS      = 16     ///< max threads processing flow graphs
    };
 
 
@@ -189,6 +204,29 @@ public:
      *  interval. For now, this method always returns OS_SUCCESS.
      */
 
+     /// @brief Sets the number of threads that process the managed flow graphs
+     /// each frame.
+   OsStatus setWorkerThreads(int numThreads);
+     /**<
+     *  A value of 1 (the default) processes all flow graphs sequentially in
+     *  the media processing task.  Larger values start numThreads-1 worker
+     *  tasks which process flow graphs in parallel with the media processing
+     *  task.  Flow graphs may share media buffers, like the silence frame
+     *  MpMisc.mpFgSilence, as buffer reference counts are atomic.  They
+     *  must not share any other state, e.g. resources or data written by
+     *  resources, to be processed by more than one thread.
+     *
+     *  The new number of threads will take effect at the beginning of the
+     *  next frame interval.
+     *
+     *  @returns <b>OS_SUCCESS</b> - the change has been queued.
+     *  @returns <b>OS_INVALID_ARGUMENT</b> - numThreads is less than 1 or
+     *           greater than MAX_WORKER_THREADS.
+     *  @returns <b>OS_NOT_SUPPORTED</b> - numThreads is more than 1, and
+     *           buffer reference counts are not atomic with this compiler
+     *           (MPBUF_REF_ATOMIC is not defined).
+     */
+
      /// Directs the media processing task to start the specified flow graph.
    OsStatus startFlowGraph(MpFlowGraphBase& rFlowGraph);
      /**<
@@ -242,6 +280,28 @@ public:
      /// has been exceeded.
    int getLimitExceededCnt(void) const;
 
+     /// @brief Returns the number of frames that completed more than the time
+     /// limit after their "frame start" signal.
+   int getDeadlineMissCnt(void) const;
+     /**<
+     *  Unlike getLimitExceededCnt(), this includes the time the frame start
+     *  signal waited in the message queue.  Frames processed in debug mode
+     *  are not counted.
+     */
+
+     /// @brief Returns the time (in microseconds) the given flow graph took to
+     /// process its last frame, and the longest time it has taken so far.
+   OsStatus getFlowGraphProcessingTime(MpFlowGraphBase* pFlowGraph,
+                                       int& lastUsecs, int& maxUsecs);
+     /**<
+     *  Both values are zero until the flow graph has been started and
+     *  processed a frame.
+     *
+     *  @returns <b>OS_SUCCESS</b> - the values have been filled in.
+     *  @returns <b>OS_NOT_FOUND</b> - the flow graph is not managed by the
+     *           media processing task.
+     */
+
      /// @brief Returns an array of MpFlowGraphBase pointers that are presently
      /// managed by the media processing task.
    OsStatus getManagedFlowGraphs(MpFlowGraphBase* flowGraphs[], const int size,
@@ -267,6 +327,10 @@ public:
      /// "frame start" signal has been exceeded.
    int getWaitTimeoutCnt(void) const;
 
+     /// @brief Returns the number of threads that process the managed flow
+     /// graphs each frame.
+   int getWorkerThreads(void) const;
+
      /// @brief Returns the number of flow graphs currently being managed by the 
      /// media processing task.
    int numManagedFlowGraphs(void) const;
@@ -339,6 +403,8 @@ private:
    UtlBoolean mDebugEnabled; ///< TRUE if debug mode is enabled, FALSE otherwise
 
    int       mTimeLimitCnt;  ///< Number of frames where time limit was exceeded
+   int       mDeadlineMissCnt; ///< @brief Number of frames completed later than
+                             ///< the time limit after their frame start signal
    unsigned  mProcessedCnt;  ///< Number of frames that have been processed
    int       mManagedCnt;    ///< Number of flow graphs presently managed
    int       mStartedCnt;    ///< Number of flow graphs presently started
@@ -348,6 +414,16 @@ private:
                              ///< msgs until a FrameStart signal has been received
    MpFlowGraphBase* mpFocus; ///< FlowGraph that has the focus (may be NULL)
    MpFlowGraphBase** mManagedFGs; ///< The set of flow graphs presently managed
+   int*      mpLastUsecs;    ///< @brief Last frame processing time of each
+                             ///< flow graph in mManagedFGs
+   int*      mpMaxUsecs;     ///< @brief Longest frame processing time of each
+                             ///< flow graph in mManagedFGs
+   int       mNumThreads;    ///< Number of threads processing flow graphs
+   MpMediaTaskWorker** mpWorkers; ///< The mNumThreads-1 worker tasks
+   OsCSem    mWorkersDoneSem; ///< Released by each worker when it is done
+                             ///< with the current frame
+   OsAtomicInt mNextFGIndex; ///< Next entry of mManagedFGs to be processed
+                             ///< in the current frame
    static int mMaxFlowGraph;
    int       mLimitUsecs;    ///< Frame processing time limit (in usecs)
    int       mHandleMsgErrs; ///< @brief Number of message handling problems
@@ -442,6 +518,22 @@ private:
      *  @returns <b>FALSE</b> - otherwise.
      */
 
+     /// Handles the @link MpMediaTaskMsg::SET_WORKER_THREADS SET_WORKER_THREADS @endlink message.
+   UtlBoolean handleSetWorkerThreads(int numThreads);
+     /**<
+     *  @returns <b>TRUE</b> - if the message was handled,
+     *  @returns <b>FALSE</b> - otherwise.
+     */
+
+     /// @brief Process flow graphs of the current frame until none are left.
+   void processFlowGraphs();
+     /**<
+     *  Called by the media processing task and every worker task; each flow
+     *  graph is taken by exactly one of them.
+     */
+
+   friend class MpMediaTaskWorker;
+
      /// Callback for flowgraph ticker.
    static
    void flowgraphTickerCallback(const intptr_t userData, const  intptr_t eventData);
@@ -46,7 +46,8 @@ public:
       START_SEND_RTP,
       STOP_SEND_RTP,
       START_RECEIVE_RTP,
-      STOP_RECEIVE_RTP
+      STOP_RECEIVE_RTP,
+      SET_WORKER_THREADS
    } MpMediaTaskMsgType;
 
 /* ============================ CREATORS ================================== */
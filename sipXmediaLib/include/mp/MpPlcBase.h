@@ -50,7 +50,8 @@ public:
    static MpPlcBase *createPlc(const UtlString &name = "");
      /**<
      *  @param[in] name - name of PLC algorithm to use. Use empty string
-     *             to get default algorithm.
+     *             to get default algorithm. Built-in algorithms are
+     *             MpPlcSilence::name and MpPlcPitch::name.
      *
      *  @returns Method never returns NULL. If appropriate PLC algorithm is
      *           not found, default one is returned.
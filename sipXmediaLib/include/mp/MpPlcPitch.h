@@ -0,0 +1,172 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _MpPlcPitch_h_
+#define _MpPlcPitch_h_
+
+// SYSTEM INCLUDES
+// APPLICATION INCLUDES
+#include <mp/MpPlcBase.h>
+
+// DEFINES
+// MACROS
+// EXTERNAL FUNCTIONS
+// EXTERNAL VARIABLES
+// CONSTANTS
+// STRUCTS
+// TYPEDEFS
+// FORWARD DECLARATIONS
+
+/**
+*  Pitch waveform substitution PLC.
+*
+*  Implements the packet loss concealment of ITU-T G.711 Appendix I.  When
+*  the first frame is lost, the pitch period of the last 48.75 ms of history
+*  is estimated by normalized cross-correlation, and the last pitch period is
+*  repeated in place of the lost audio.  The junction of the repeated periods
+*  is smoothed by an overlap-add over a quarter of the period.  After 10 ms
+*  of loss the second and the third pitch periods back are repeated too, so
+*  a long loss does not sound tonal, and the signal is attenuated by 20% per
+*  10 ms, down to silence after 60 ms.  The first good frame after a loss
+*  is overlap-added with the end of the synthetic signal, the longer the
+*  loss the longer the overlap.
+*
+*  The output is delayed by 3.75 ms (getAlgorithmicDelay()), which leaves
+*  room for the smoothing at the start of a loss.  The constants of the
+*  algorithm are defined for 8 kHz and scaled to the sample rate passed to
+*  init().  The audio is processed in blocks of 10 ms, so frames of any size
+*  may be passed to processFrame().
+*/
+class MpPlcPitch : public MpPlcBase
+{
+/* //////////////////////////// PUBLIC //////////////////////////////////// */
+public:
+
+   static const char *name;
+
+/* ============================ CREATORS ================================== */
+///@name Creators
+//@{
+
+     /// Constructor
+   MpPlcPitch();
+
+     /// @copydoc MpPlcBase::init()
+   OsStatus init(int samplesPerSec);
+
+     /// Destructor
+   ~MpPlcPitch();
+
+     /// @copydoc MpPlcBase::reset()
+   void reset();
+
+     /// @copydoc MpPlcBase::fullReset()
+   void fullReset();
+
+//@}
+
+/* ============================ MANIPULATORS ============================== */
+///@name Manipulators
+//@{
+
+     /// @copydoc MpPlcBase::insertToHistory()
+   OsStatus insertToHistory(int frameNum,
+                            const MpSpeechParams &speechParams,
+                            MpAudioSample* pBuf,
+                            unsigned inSamplesNum);
+
+     /// @copydoc MpPlcBase::processFrame()
+   OsStatus processFrame(MpSpeechParams &speechParams,
+                         MpAudioSample* pBuf,
+                         unsigned bufferSize,
+                         unsigned inSamplesNum,
+                         unsigned outSamplesNum,
+                         int wantedAdjustment,
+                         int &madeAdjustment);
+
+//@}
+
+/* ============================ ACCESSORS ================================= */
+///@name Accessors
+//@{
+
+     /// @copydoc MpPlcBase::getMaxDelayedFramesNum()
+   int getMaxDelayedFramesNum() const;
+
+     /// @copydoc MpPlcBase::getMaxFutureFramesNum()
+   int getMaxFutureFramesNum() const;
+
+     /// @copydoc MpPlcBase::getAlgorithmicDelay()
+   int getAlgorithmicDelay() const;
+
+//@}
+
+/* ============================ INQUIRY =================================== */
+///@name Inquiry
+//@{
+
+//@}
+
+/* //////////////////////////// PROTECTED ///////////////////////////////// */
+protected:
+
+/* //////////////////////////// PRIVATE /////////////////////////////////// */
+private:
+
+   int mSamplesPerSec;     ///< Sample rate given to init(), 0 before.
+   int mBlockSize;         ///< Samples in a 10 ms processing block.
+   int mPitchMin;          ///< Shortest pitch period searched.
+   int mPitchMax;          ///< Longest pitch period searched.
+   int mOverlapMax;        ///< Longest overlap, the output delay too.
+   int mHistoryLen;        ///< Samples of history kept.
+   int mCorrLen;           ///< Samples correlated by the pitch search.
+   int mOverlapIncr;       ///< Overlap added at the end of a loss per lost block.
+   float mCorrMinPower;    ///< Lowest energy a correlation is normalized by.
+
+   MpAudioSample* mpHistory; ///< Last mHistoryLen samples received.
+   float* mpPitchBuf;      ///< History copied at the start of a loss.
+   float* mpLastQ;         ///< Last quarter period before the loss.
+   MpAudioSample* mpOverlapBuf; ///< Scratch block for the overlaps.
+
+   int mEraseCount;        ///< Blocks lost in a row.
+   int mPitch;             ///< Pitch period of the current loss.
+   int mPitchOverlap;      ///< Overlap of the current loss (quarter period).
+   int mPitchBufLen;       ///< Length of the periods repeated.
+   int mPitchOffset;       ///< Position in the periods repeated.
+   MpSpeechType mLastSpeechType; ///< Speech type of the last good frame.
+
+     /// Free the buffers.
+   void freeBuffers();
+
+     /// Conceal a lost block of \p numSamples samples, at most mBlockSize.
+   void concealBlock(MpAudioSample* pOut, int numSamples);
+
+     /// Pass a good block of \p numSamples samples, at most mBlockSize.
+   void addToHistory(MpAudioSample* pBuf, int numSamples);
+
+     /// Put a block in history and replace it with the delayed output.
+   void saveSpeech(MpAudioSample* pBuf, int numSamples);
+
+     /// Copy \p numSamples samples of the repeated periods to \p pOut.
+   void getSynthetic(MpAudioSample* pOut, int numSamples);
+
+     /// Attenuate a concealed block according to the loss length.
+   void scaleSpeech(MpAudioSample* pOut, int numSamples);
+
+     /// Estimate the pitch period at the end of mpPitchBuf.
+   int findPitch();
+
+     /// Copy constructor (not implemented for this class)
+   MpPlcPitch(const MpPlcPitch& rPlc);
+
+     /// Assignment operator (not implemented for this class)
+   MpPlcPitch& operator=(const MpPlcPitch& rhs);
+};
+
+/* ============================ INLINE METHODS ============================ */
+
+#endif  // _MpPlcPitch_h_
@@ -68,7 +68,8 @@ public:
       MPRNM_INPUT_DEVICE_NOT_PRESENT,
       MPRNM_OUTPUT_DEVICE_NOT_PRESENT,
       MPRNM_INPUT_DEVICE_NOW_PRESENT,
-      MPRNM_OUTPUT_DEVICE_NOW_PRESENT
+      MPRNM_OUTPUT_DEVICE_NOW_PRESENT,
+      MPRNM_RECORDER_FRAMES_DROPPED ///< Recorder writer queue full (MprnIntMsg bears number of dropped frames).
    } RNMsgType;
 
    /* ============================ CREATORS ================================== */
@@ -62,6 +62,7 @@ class MpResource : public UtlString
 public:
 
    friend class MpFlowGraphBase;
+   friend class MpResourceSet;
 
    /// @brief Graph traversal states that are used when running a topological 
    /// sort to order resources within a flow graph.
@@ -597,7 +598,11 @@ protected:
      */
 
      /// Sets the name that is associated with this resource.
-   void setName(const UtlString& rName);
+   virtual void setName(const UtlString& rName);
+     /**<
+     *  Resources which pass their name on to the objects they own must
+     *  override this to rename them too.
+     */
 
 /* //////////////////////////// PRIVATE /////////////////////////////////// */
 private:
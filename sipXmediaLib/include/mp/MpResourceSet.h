@@ -0,0 +1,196 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _MpResourceSet_h_
+#define _MpResourceSet_h_
+
+// SYSTEM INCLUDES
+// APPLICATION INCLUDES
+#include "os/OsStatus.h"
+#include "utl/UtlHashBag.h"
+#include "mp/MpResource.h"
+
+// DEFINES
+// MACROS
+// EXTERNAL FUNCTIONS
+// EXTERNAL VARIABLES
+// CONSTANTS
+// STRUCTS
+// TYPEDEFS
+// FORWARD DECLARATIONS
+
+/**
+*  @brief A group of resources constructed and linked outside of any
+*         flowgraph, to be added to one with a single message.
+*
+*  The links between the resources of the set are made as soon as they are
+*  requested, as nothing processes the resources yet.  Links to resources
+*  already in a flowgraph are only recorded, and made by the flowgraph when
+*  the set is added to it (see MpFlowGraphBase::addResourceSet()).
+*
+*  Resource names may hold a "%d" placeholder (see
+*  MpResourceTopology::replaceNumInName()), so that a set may be built before
+*  it is known which connection it will serve.
+*
+*  The set owns its resources until they are added to a flowgraph.
+*  Destroying the set destroys the resources which are not in a flowgraph.
+*
+*  @nosubgrouping
+*/
+class MpResourceSet
+{
+/* //////////////////////////// PUBLIC //////////////////////////////////// */
+public:
+
+   enum
+   {
+      MAX_RESOURCES = 20, ///< Maximum number of resources in a set.
+      MAX_LINKS = 20      ///< Maximum number of links to other resources.
+   };
+
+/* ============================ CREATORS ================================== */
+///@name Creators
+//@{
+
+     /// Constructor
+   MpResourceSet();
+
+     /// Destructor
+   ~MpResourceSet();
+     /**<
+     *  Destroys the resources of the set which were not added to a flowgraph.
+     */
+
+//@}
+
+/* ============================ MANIPULATORS ============================== */
+///@name Manipulators
+//@{
+
+     /// Add a resource to the set, which takes ownership of it.
+   OsStatus addResource(MpResource& rResource);
+     /**<
+     *  @retval OS_SUCCESS - the resource was added.
+     *  @retval OS_INVALID_ARGUMENT - the resource is already part of
+     *          a flowgraph.
+     *  @retval OS_LIMIT_REACHED - the set holds MAX_RESOURCES resources.
+     */
+
+     /// Link two resources of the set right away.
+   OsStatus linkResources(MpResource& rFrom, int outPortIdx,
+                          MpResource& rTo,   int inPortIdx);
+     /**<
+     *  @retval OS_SUCCESS - the link was made.
+     *  @retval OS_NOT_FOUND - one of the resources is not in the set.
+     *  @retval OS_INVALID_ARGUMENT - invalid or busy port index.
+     */
+
+     /// Record a link to or from a resource outside of the set.
+   OsStatus addLink(MpResource& rFrom, int outPortIdx,
+                    MpResource& rTo,   int inPortIdx);
+     /**<
+     *  The link is made when the set is added to the flowgraph, which the
+     *  other resource must belong to by then.
+     *
+     *  @retval OS_SUCCESS - the link was recorded.
+     *  @retval OS_INVALID_ARGUMENT - invalid port index.
+     *  @retval OS_LIMIT_REACHED - the set holds MAX_LINKS links.
+     */
+
+     /// Give the resources the names and connection ID of an instance.
+   void setResourceNum(int resourceNum);
+     /**<
+     *  Replaces the "%d" placeholder in the resource names with
+     *  \p resourceNum, and sets it as the connection ID of the resources
+     *  whose connection ID is MP_INVALID_CONNECTION_ID.  Must be called
+     *  before the set is added to a flowgraph.
+     */
+
+//@}
+
+/* ============================ ACCESSORS ================================= */
+///@name Accessors
+//@{
+
+     /// Get the number of resources in the set.
+   inline int numResources() const;
+
+     /// Get a resource of the set by its index.
+   inline MpResource* getResource(int index) const;
+
+     /// Get the resources of the set, to look them up by name.
+   inline UtlHashBag& getResources();
+
+     /// Get the number of links between resources of the set.
+   inline int numInternalLinks() const;
+
+     /// Get the number of recorded links to other resources.
+   inline int numLinks() const;
+
+     /// Get a recorded link to another resource by its index.
+   void getLink(int index,
+                MpResource*& rpFrom, int& outPortIdx,
+                MpResource*& rpTo,   int& inPortIdx) const;
+
+//@}
+
+/* //////////////////////////// PROTECTED ///////////////////////////////// */
+protected:
+
+/* //////////////////////////// PRIVATE /////////////////////////////////// */
+private:
+
+   struct Link
+   {
+      MpResource* mpFrom;
+      int mOutPortIdx;
+      MpResource* mpTo;
+      int mInPortIdx;
+   };
+
+   MpResource* mpResources[MAX_RESOURCES]; ///< Resources in the order added.
+   int mNumResources;
+   UtlHashBag mResourceBag;     ///< The same resources, for lookups by name.
+   int mNumInternalLinks;       ///< Links made by linkResources().
+   Link mLinks[MAX_LINKS];      ///< Links recorded by addLink().
+   int mNumLinks;
+
+     /// Copy constructor (not implemented for this class)
+   MpResourceSet(const MpResourceSet& rMpResourceSet);
+
+     /// Assignment operator (not implemented for this class)
+   MpResourceSet& operator=(const MpResourceSet& rhs);
+};
+
+/* ============================ INLINE METHODS ============================ */
+
+int MpResourceSet::numResources() const
+{
+   return mNumResources;
+}
+
+MpResource* MpResourceSet::getResource(int index) const
+{
+   return (index >= 0 && index < mNumResources) ? mpResources[index] : NULL;
+}
+
+UtlHashBag& MpResourceSet::getResources()
+{
+   return mResourceBag;
+}
+
+int MpResourceSet::numInternalLinks() const
+{
+   return mNumInternalLinks;
+}
+
+int MpResourceSet::numLinks() const
+{
+   return mNumLinks;
+}
+
+#endif  // _MpResourceSet_h_
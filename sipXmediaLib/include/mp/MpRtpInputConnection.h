@@ -154,6 +154,9 @@ protected:
      /// @copydoc MpResource::setFlowGraph()
    OsStatus setFlowGraph(MpFlowGraphBase* pFlowGraph);
 
+     /// @copydoc MpResource::setName()
+   void setName(const UtlString& rName);
+
      /// Handle resource messages for this resource.
    virtual UtlBoolean handleMessage(MpResourceMsg& rMsg);
 
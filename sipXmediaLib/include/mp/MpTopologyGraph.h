@@ -27,6 +27,7 @@
 // FORWARD DECLARATIONS
 class MpResourceTopology;
 class MpResourceFactory;
+class MpResourceSet;
 
 /**
 *  @brief Flowgraph with resources wired as defined in given topology and factory.
@@ -90,6 +91,48 @@ public:
      */
 
 
+     /// @brief Construct and link the resources defined by given topology
+     /// outside of any flowgraph.
+   static OsStatus prebuildResources(MpResourceTopology& incrementalTopology,
+                                     MpResourceFactory& resourceFactory,
+                                     MpResourceSet*& rpResourceSet);
+     /**<
+     *  Does the costly part of addResources() ahead of time: the resources
+     *  are constructed and the links between them are made.  The "%d"
+     *  placeholder is kept in their names until addPrebuiltResources().
+     *  Links to resources which are not in the topology are left for
+     *  addPrebuiltResources() as well.
+     *
+     *  @param[in] incrementalTopology - defines the resources to construct
+     *             and the links between them.
+     *  @param[in] resourceFactory - factory to construct the resources.
+     *  @param[out] rpResourceSet - the new set of resources, to be passed to
+     *              addPrebuiltResources() or deleted.  NULL on failure.
+     *
+     *  @retval OS_SUCCESS if all of the resources were constructed and linked.
+     *  @retval OS_FAILED if a resource could not be constructed or linked.
+     */
+
+     /// @brief Add resources constructed by prebuildResources() to the existing
+     /// flowgraph.
+   OsStatus addPrebuiltResources(MpResourceTopology& incrementalTopology,
+                                 MpResourceSet* pResourceSet,
+                                 int resourceInstanceId);
+     /**<
+     *  Has the same effect as addResources() with the topology the set was
+     *  built from, but the resources and all of their links are added with
+     *  a single flowgraph message.
+     *
+     *  @param[in] incrementalTopology - the topology \p pResourceSet was
+     *             built from.
+     *  @param[in] pResourceSet - the resources to add.  The flowgraph takes
+     *             ownership of it.
+     *  @param[in] resourceInstanceId - instance ID to be used to make resource
+     *             names unique in the flowgraph.
+     *
+     *  @returns the result of MpFlowGraphBase::addResourceSet().
+     */
+
      /// @brief Delete resources from existing flowgraph as defined by
      /// given topology.
    OsStatus destroyResources(MpResourceTopology& resourceTopology,
@@ -264,7 +307,25 @@ private:
    int linkTopologyResources(MpResourceTopology& resourceTopology,
                              UtlHashBag& newResources,
                              UtlBoolean replaceNumInName = FALSE,
-                             int resourceNum = -1);
+                             int resourceNum = -1,
+                             MpResourceSet* pResourceSet = NULL);
+     /**<
+     *  If \p pResourceSet is not NULL, \p newResources are its resources.
+     *  The links between them are skipped, as prebuildResources() made them,
+     *  and the other links are recorded in the set instead of being added.
+     */
+
+     /// Get the real port index to link for a port index of a topology.
+   static int reservePort(MpResource& resource,
+                          int portIndex,
+                          UtlBoolean isOutput,
+                          UtlHashMap& logicalPorts);
+     /**<
+     *  Reserves a free port of \p resource for
+     *  MpResourceTopology::MP_TOPOLOGY_NEXT_AVAILABLE_PORT, and for a logical
+     *  port number the first time it is seen.  \p logicalPorts maps the
+     *  logical port numbers to the real ones.
+     */
 
 
      ///Disabled copy constructor.
@@ -63,7 +63,8 @@ public:
    enum AlgType
    {
       ALG_SIMPLE, ///< Simple O(n^2) algorithm (MpBridgeAlgSimple)
-      ALG_LINEAR  ///< Linear O(n) algorithm (MpBridgeAlgLinear)
+      ALG_LINEAR, ///< Linear O(n) algorithm (MpBridgeAlgLinear)
+      ALG_COMMON_MIX ///< Common mix with sparse gains (MpBridgeAlgCommonMix)
    };
 
 /* ============================ CREATORS ================================== */
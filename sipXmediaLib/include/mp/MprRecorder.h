@@ -38,6 +38,32 @@
 #  define MAXIMUM_RECORDER_CHANNELS 4
 #endif
 
+#define MPR_RECORDER_MAX_WRITER_THREADS 16
+
+// Frames a recording to file may have waiting for its writer thread
+#ifndef MPR_RECORDER_QUEUE_FRAMES
+#  define MPR_RECORDER_QUEUE_FRAMES 256
+#endif
+
+// Bytes of encoded audio a writer thread collects before writing to the file
+#ifndef MPR_RECORDER_WRITE_SIZE
+#  define MPR_RECORDER_WRITE_SIZE (1024 * 32)
+#endif
+
+// Writer threads end each write at a file offset multiple of this
+#ifndef MPR_RECORDER_WRITE_ALIGNMENT
+#  define MPR_RECORDER_WRITE_ALIGNMENT 4096
+#endif
+
+// Pass frames to the writer threads with atomic loads and stores where the
+// compiler provides them.  Define MPRRECORDER_USE_MUTEX to always use the
+// queue mutex instead.
+#if !defined(MPRRECORDER_USE_MUTEX) && defined(__GCC_ATOMIC_INT_LOCK_FREE) // [
+#  if __GCC_ATOMIC_INT_LOCK_FREE == 2
+#     define MPRRECORDER_LOCK_FREE
+#  endif
+#endif // !MPRRECORDER_USE_MUTEX && __GCC_ATOMIC_INT_LOCK_FREE ]
+
 // MACROS
 // EXTERNAL FUNCTIONS
 // EXTERNAL VARIABLES
@@ -46,14 +72,29 @@
 // TYPEDEFS
 
 // FORWARD DECLARATIONS
-class MpEncoderBase;
-class MpResamplerBase;
-struct SipxOpusWriteObject;
+class MprRecorderJob;
 struct OpusHead;
 
 /// The "Recorder" media processing resource
+/**
+*  By default a recording to a file is encoded and written in the frame
+*  processing of the media task.  When setWriterThreads() has started writer
+*  threads, the media task only copies each frame into a queue of the
+*  recording and a writer thread takes the frames from it, encodes them,
+*  writes them to the file in large writes, and closes the file at the end.
+*  A frame that finds the queue full is dropped rather than holding up the
+*  media task.
+*
+*  Each recording to a file or a circular buffer has its own job with its
+*  encoder, file descriptor and queue.  Once a recording given to a writer
+*  thread finishes, its job belongs to the writer, which frees it after
+*  closing the file, so a new recording can start without waiting for the
+*  last one to be written out.
+*/
 class MprRecorder : public MpAudioResource
 {
+   friend class MprRecorderJob;
+
 /* //////////////////////////// PUBLIC //////////////////////////////////// */
 public:
 
@@ -190,10 +231,44 @@ public:
 
    static OsStatus validateOpusHeader(int inFileFd, OpusHead& opusHeader);
 
+     /// Set the number of threads that encode and write recordings to files.
+   static OsStatus setWriterThreads(int numThreads);
+     /**<
+     *  Each recording to a file started afterwards is given to the writer
+     *  thread with the fewest recordings, which does all of its encoding and
+     *  writing.  With 0 writer threads (the default) recordings are written
+     *  by the media task.
+     *
+     *  @param[in] numThreads - number of writer threads, from 0 to
+     *             MPR_RECORDER_MAX_WRITER_THREADS.
+     *
+     *  @returns OS_SUCCESS if the writer threads were started or stopped,
+     *           OS_INVALID_ARGUMENT if \p numThreads is out of range,
+     *           OS_BUSY if a writer thread still has a recording to write.
+     */
+
 /* ============================ ACCESSORS ================================= */
 ///@name Accessors
 //@{
 
+     /// Get the number of threads writing recordings to files.
+   static int getWriterThreads();
+
+     /// Get the number of frames dropped because the writer queue was full.
+   int getDroppedFrames() const;
+     /**<
+     *  Counts the frames of the current or last recording to a file.  The
+     *  first frame dropped after the queue had room is also notified with
+     *  MPRNM_RECORDER_FRAMES_DROPPED.
+     */
+
+     /// Get the most frames the writer queue has held.
+   int getMaxQueuedFrames() const;
+     /**<
+     *  For the current or last recording to a file, out of
+     *  MPR_RECORDER_QUEUE_FRAMES.
+     */
+
 //@}
 
 /* ============================ INQUIRY =================================== */
@@ -254,12 +329,6 @@ protected:
    int mConsecutiveInactive;
    int mSilenceLength;
 
-///@name File-related variables
-//@{
-   int mFileDescriptor;     ///< File descriptor to write to.
-   RecordFileFormat mRecFormat; ///< Should data be written in WAV or RAW PCM format.
-//@}
-
 ///@name Buffer-related variables
 //@{
    MpAudioSample *mpBuffer; ///< Buffer to write data to. End of the buffer
@@ -267,19 +336,9 @@ protected:
    int mBufferSize;         ///< mpBuffer size.
 //@}
 
-   MpEncoderBase* mpEncoder; ///< encoder for non-PCM formats saved to file
-   int mEncodedFrames;      ///< number of audio (flowgraph) frames encoded
-   int mLastEncodedFrameSize;///< Size in bytes of last encoded frame recorded
+   MprRecorderJob* mpJob;   ///< Encoding and output of the current recording
+                            ///< to a file or a circular buffer.
 
-   void* mpOpusEncoder;
-   void* mpOpusComments;
-   struct SipxOpusWriteObject* mpOpusStreamObject;
-
-   SampleInterlaceStage mWhenToInterlace;
-
-   MpResamplerBase* mpResampler; ///< Resampler for encoding to file
-
-   
 ///@name Circular buffer related variables
 //@{
    CircularBufferPtr * mpCircularBuffer;
@@ -289,6 +348,17 @@ protected:
    int mSamplesPerLastFrame; ///< Cache frame size of last processed buffer
    int mSamplesPerSecond;    ///< Cache sample rate of last processed buffer
 
+///@name Writer thread related variables
+//@{
+   MprRecorderJob* mpWriterJobs; ///< Jobs given to writer threads that send
+                            ///< their finish notification through this
+                            ///< recorder, guarded by the writers mutex.
+   int mDroppedFrames;      ///< Frames dropped because the queue was full.
+   int mDroppedSamples;     ///< Samples per channel in the dropped frames.
+   int mMaxQueuedFrames;    ///< Most frames queued at once.
+   UtlBoolean mDropping;    ///< Last frame was dropped.
+//@}
+
    virtual UtlBoolean doProcessFrame(MpBufPtr inBufs[],
                                     MpBufPtr outBufs[],
                                     int inBufsSize,
@@ -335,29 +405,31 @@ protected:
      /// Handle messages for this resource.
    virtual UtlBoolean handleMessage(MpResourceMsg& rMsg);
 
+     /// @copydoc MpResource::setFlowGraph()
+   virtual OsStatus setFlowGraph(MpFlowGraphBase* pFlowGraph);
+
      /// Prepare for recording.
    void startRecording(int time, int silenceLength);
 
      /// Recording has been stopped with given cause.
    UtlBoolean finish(FinishCause cause);
 
-     /// Close file if it is opened and  update WAV header if needed.
-   void closeFile(const char* fromWhereLabel);
-
-   typedef int (MprRecorder::*WriteMethod)(const char * channelBuffers[], int);
+     /// Close the file or buffer of a recording that has not finished.
+   void abandonJob();
+     /**<
+     *  A job given to a writer thread is left to the writer to close, without
+     *  a finish notification.
+     */
 
-     /// Write silence to the file
-   inline int writeFileSilence(int numSamples);
+     /// Stop the jobs given to writer threads from notifying this recorder.
+   void detachWriterJobs();
 
-     /// Write given data to the specified target
-   inline int writeSamples(const MpAudioSample *pBuffer[], int numSamples, WriteMethod writeMethod);
+     /// Send the notification for a recording finished with given cause.
+   void sendFinishNotification(FinishCause cause, int samplesRecorded);
 
      /// Write silence to the buffer
    inline int writeBufferSilence(int numSamples);
 
-     /// Write silence to the circular buffer
-   inline int writeCircularBufferSilence(int numSamples);
-
      /// Write given speech data to the buffer
    inline int writeBufferSpeech(const MpAudioSample *pBuffer, int numSamples);
 
@@ -394,16 +466,16 @@ private:
      /// Assignment operator (not implemented for this class)
    MprRecorder& operator=(const MprRecorder& rhs);
 
-   int writeFile(const char* channelData[], int dataSize);
-   int writeCircularBuffer(const char* channelData[], int dataSize);
    void notifyCircularBufferWatermark();
-   void createEncoder(const char * mimeSubtype, unsigned int codecSampleRate);
-   void prepareEncoder(RecordFileFormat recFormat, unsigned int & codecSampleRate);
-   OsStatus createOpusEncoder(int channels,
-                              const char* artist, 
-                              const char* title);
-   void deleteOpusEncoder();
-   void trimSilenceFromEndOfRecording();
+
+     /// Create the job of a new recording with its encoder.
+   void prepareEncoder(RecordFileFormat recFormat, int file, unsigned int & codecSampleRate);
+
+     /// Give the recording to file just started to a writer thread, if any.
+   void startWriter();
+
+     /// Copy a frame into the writer queue, NULL buffers for silence.
+   int queueFrame(const MpAudioSample* pBuffers[], int numSamples);
 
    static int16_t getBytesPerSample(RecordFileFormat format);
    static int interlaceSamples(const char* samplesArrays[], int samplesPerChannel, int bytesPerSample, int channels, char* interlacedChannelSamplesArray, int interlacedArrayMaximum);
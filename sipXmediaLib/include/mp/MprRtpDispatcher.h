@@ -95,6 +95,9 @@ public:
      /// Set ID of the connection to which this resource belongs.
    inline void setConnectionId(MpConnectionID connectionId);
 
+     /// Set name to be used in event notifications.
+   inline void setResourceName(const UtlString& rName);
+
      /// Set stream activity timeout.
    inline void setRtpInactivityTimeout(const OsTime &inactiveTime);
      /**<
@@ -254,6 +257,12 @@ void MprRtpDispatcher::setConnectionId(MpConnectionID connectionId)
    mConnectionId = connectionId;
 }
 
+void MprRtpDispatcher::setResourceName(const UtlString& rName)
+{
+   OsLock lock(mMutex);
+   mResourceName = rName;
+}
+
 void MprRtpDispatcher::setRtpInactivityTimeout(const OsTime &inactiveTime)
 {
    OsLock lock(mMutex);
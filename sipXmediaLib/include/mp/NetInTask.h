@@ -26,6 +26,7 @@
 #include "os/OsSocket.h"
 #include "os/OsRWMutex.h"
 #include "os/OsMutex.h"
+#include "utl/UtlHashMap.h"
 #include "mp/MpTypes.h"
 #include "mp/MpRtpBuf.h"
 #include "mp/MpMisc.h"
@@ -43,12 +44,24 @@
 #define RTP_DIR_OUT 2
 #define RTP_DIR_NEW 4
 
+// Define NET_IN_TASK_USE_EPOLL (configure --enable-netin-epoll) to make
+// NetInTask wait for packets with an edge-triggered epoll set and read them
+// in batches with recvmmsg().  Unlike select() this has no limit on the
+// number or value of socket descriptors.  Linux only.
+#if defined(NET_IN_TASK_USE_EPOLL) && !defined(__linux__)
+#  undef NET_IN_TASK_USE_EPOLL
+#endif
+
 // MACROS
 // EXTERNAL FUNCTIONS
 // EXTERNAL VARIABLES
 // CONSTANTS
 #define NET_TASK_MAX_MSG_LEN sizeof(netInTaskMsg)
-#define NET_TASK_MAX_FD_PAIRS 300
+#define NET_TASK_MAX_FD_PAIRS 300  ///< Socket pairs served by the select() loop
+#define NET_TASK_RECV_BATCH 16     ///< Datagrams read by one recvmmsg() call
+#define NET_TASK_RECV_QUOTA 64     ///< Datagrams read from one socket per turn,
+                                   ///<  so a busy socket cannot starve others
+#define NET_TASK_EPOLL_EVENTS 64   ///< Events fetched by one epoll_wait() call
 
 // FORWARD DECLARATIONS
 class MprFromNet;
@@ -199,6 +212,57 @@ protected:
    OsStatus get1Msg(OsSocket* pRxpSkt, MprFromNet* fwdTo, bool isRtcp, int ostc);
    int findPoisonFds(int pipeFD);
 
+#ifdef NET_IN_TASK_USE_EPOLL // [
+     /// One RTP or RTCP socket in the epoll set.
+   struct NetInSource
+   {
+      OsSocket*    pSocket;       ///< NULL once the socket has been dropped.
+      MprFromNet*  fwdTo;
+      bool         isRtcp;
+      bool         rawReads;      ///< Socket may be read with recvmmsg().
+      int          fd;
+      bool         inBacklog;
+      NetInSource* pNextInBacklog;
+   };
+
+     /// The sockets registered by one addNetInputSources() call.
+   struct NetInSourcePair
+   {
+      NetInSource rtp;
+      NetInSource rtcp;
+   };
+
+   int          mEpollFd;         ///< epoll set of all sockets we listen to.
+   UtlHashMap   mSourcePairs;     ///< MprFromNet* -> NetInSourcePair*, both
+                                  ///<  as UtlVoidPtr.
+   NetInSource* mpBacklog;        ///< Sources that used up their quota before
+                                  ///<  the socket was drained.
+
+     /// Task loop using epoll.
+   int runEpoll();
+
+     /// Handle one message from the command socket.
+   void handleEpollCommand(const netInTaskMsg& msg);
+
+     /// Add a socket to the epoll set.
+   void addSource(NetInSource& rSource, OsSocket* pSocket,
+                  MprFromNet* fwdTo, bool isRtcp);
+
+     /// Take a socket out of the epoll set and the backlog.
+   void removeSource(NetInSource& rSource);
+
+     /// Read up to NET_TASK_RECV_QUOTA packets from a socket.
+   void readSource(NetInSource& rSource, int ostc);
+     /**<
+     *  If the socket still has packets afterwards, it is put in the backlog
+     *  to be read again after the other ready sockets.
+     */
+
+     /// Read one batch of packets with OsDatagramSocket::recvBatch().
+   OsStatus recvBatch(NetInSource& rSource, int maxPackets, int ostc,
+                      int& numRead, bool& drained);
+#endif // NET_IN_TASK_USE_EPOLL ]
+
 /* //////////////////////////// PRIVATE /////////////////////////////////// */
 private:
 
@@ -0,0 +1,437 @@
+//
+// Copyright (C) 2026 SIPez LLC. All rights reserved.
+//
+//
+// $$
+//////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <string.h>
+
+// APPLICATION INCLUDES
+#include "mp/MpBridgeAlgCommonMix.h"
+#include "mp/MpMisc.h"
+
+// EXTERNAL FUNCTIONS
+// EXTERNAL VARIABLES
+// CONSTANTS
+// TYPEDEFS
+// DEFINES
+// MACROS
+// STATIC VARIABLE INITIALIZATIONS
+
+/* //////////////////////////////// PUBLIC //////////////////////////////// */
+
+/* =============================== CREATORS =============================== */
+
+MpBridgeAlgCommonMix::MpBridgeAlgCommonMix(int inputs, int outputs,
+                                           UtlBoolean mixSilence,
+                                           int samplesPerFrame)
+: MpBridgeAlgBase(inputs, outputs, mixSilence)
+, mpGainMatrix(NULL)
+, mpCommonGains(NULL)
+, mpDeviationStart(NULL)
+, mpDeviations(NULL)
+, mDeviationsValid(FALSE)
+, mpCommonAccumulator(NULL)
+, mpMixAccumulator(NULL)
+, mpActiveInputs(NULL)
+, mpCommonAmplitudes(NULL)
+{
+   // Allocate mix matrix.
+   mpGainMatrix = new MpBridgeGain[maxInputs()*maxOutputs()];
+   assert(mpGainMatrix != NULL);
+
+   // Initially set matrix to inversed unity matrix, with zeros along
+   // main diagonal.
+   for (int row=0; row<maxOutputs(); row++)
+   {
+      for (int i=0; i<maxInputs(); i++)
+      {
+         mpGainMatrix[row*maxInputs() + i] = (i == row) ? MP_BRIDGE_GAIN_MUTED
+                                                        : MP_BRIDGE_GAIN_PASSTHROUGH;
+      }
+   }
+
+   // Allocate sparse representation of the matrix. It is filled
+   // in the first doMix() call.
+   mpCommonGains = new MpBridgeGain[maxInputs()];
+   mpDeviationStart = new int[maxOutputs()+1];
+   mpDeviations = new GainDeviation[maxInputs()*maxOutputs()];
+
+   // Allocate temporary storage for mixing data.
+   mpCommonAccumulator = new MpBridgeAccum[samplesPerFrame];
+   mpMixAccumulator = new MpBridgeAccum[samplesPerFrame];
+   mpActiveInputs = new UtlBoolean[maxInputs()];
+   mpCommonAmplitudes = new int32_t[maxInputs()];
+}
+
+MpBridgeAlgCommonMix::~MpBridgeAlgCommonMix()
+{
+   delete[] mpGainMatrix;
+   delete[] mpCommonGains;
+   delete[] mpDeviationStart;
+   delete[] mpDeviations;
+   delete[] mpCommonAccumulator;
+   delete[] mpMixAccumulator;
+   delete[] mpActiveInputs;
+   delete[] mpCommonAmplitudes;
+}
+
+/* ============================= MANIPULATORS ============================= */
+
+UtlBoolean MpBridgeAlgCommonMix::doMix(MpBufPtr inBufs[], int inBufsSize,
+                                       MpBufPtr outBufs[], int outBufsSize,
+                                       int samplesPerFrame)
+{
+   if (!mDeviationsValid)
+   {
+      updateDeviations();
+   }
+
+   // Initialize amplitudes if they haven't been initialized yet.
+   for (int i=0; i<inBufsSize; i++)
+   {
+      if (mpPrevAmplitudes[i] < 0 && inBufs[i].isValid())
+      {
+         MpAudioBufPtr pAudioBuf = inBufs[i];
+         MpAudioSample amplitude = pAudioBuf->getAmplitude();
+         mpPrevAmplitudes[i] = amplitude == 0 ? 1 : amplitude;
+      }
+   }
+
+   // Mix all active inputs with their common gains.
+   int32_t commonAmplitude = 0;
+   int commonSpeechTypes[NUM_SPEECH_TYPES] = {0};
+   int commonContributors = 0;
+   memset(mpCommonAccumulator, 0, samplesPerFrame*sizeof(MpBridgeAccum));
+   for (int inputNum=0; inputNum<inBufsSize; inputNum++)
+   {
+      mpActiveInputs[inputNum] = FALSE;
+      if (!inBufs[inputNum].isValid())
+      {
+         continue;
+      }
+
+      MpAudioBufPtr pFrame = inBufs[inputNum];
+      assert((int)(pFrame->getSamplesNumber()) == samplesPerFrame);
+      MpSpeechType speechType = pFrame->getSpeechType();
+      if (  (!mMixSilence && !isActiveAudio(speechType))
+         || speechType == MP_SPEECH_MUTED)
+      {
+         continue;
+      }
+      mpActiveInputs[inputNum] = TRUE;
+
+      if (mpCommonGains[inputNum] != MP_BRIDGE_GAIN_MUTED)
+      {
+         mpCommonAmplitudes[inputNum] =
+            mixInput(pFrame->getSamplesPtr(), mpCommonGains[inputNum],
+                     mpPrevAmplitudes[inputNum], pFrame->getAmplitude(),
+                     FALSE, mpCommonAccumulator, samplesPerFrame);
+         commonAmplitude += mpCommonAmplitudes[inputNum];
+         commonSpeechTypes[speechType]++;
+         commonContributors++;
+      }
+   }
+
+   // Derive outputs from the common mix.
+   MpAudioBufPtr pCommonBuf;
+   for (int outputNum=0; outputNum<outBufsSize; outputNum++)
+   {
+      const GainDeviation *pDevBegin = &mpDeviations[mpDeviationStart[outputNum]];
+      const GainDeviation *pDevEnd = &mpDeviations[mpDeviationStart[outputNum+1]];
+      const GainDeviation *pDev;
+
+      // Skip deviations of inputs which are not mixed in this frame.
+      while (  pDevBegin < pDevEnd
+            && (  pDevBegin->mInput >= inBufsSize
+               || !mpActiveInputs[pDevBegin->mInput]))
+      {
+         pDevBegin++;
+      }
+
+      if (pDevBegin == pDevEnd)
+      {
+         // This output is the common mix itself.
+         if (commonContributors == 0)
+         {
+            outBufs[outputNum].release();
+            continue;
+         }
+         if (!pCommonBuf.isValid())
+         {
+            pCommonBuf = makeOutput(mpCommonAccumulator, commonAmplitude,
+                                    mixedSpeechType(commonSpeechTypes),
+                                    samplesPerFrame);
+         }
+         outBufs[outputNum] = pCommonBuf;
+         continue;
+      }
+
+      // Correct the common mix for inputs whose gain for this output
+      // differs from their common gain.
+      int32_t amplitude = commonAmplitude;
+      int speechTypes[NUM_SPEECH_TYPES];
+      memcpy(speechTypes, commonSpeechTypes, sizeof(speechTypes));
+      int contributors = commonContributors;
+      memcpy(mpMixAccumulator, mpCommonAccumulator,
+             samplesPerFrame*sizeof(MpBridgeAccum));
+      for (pDev=pDevBegin; pDev<pDevEnd; pDev++)
+      {
+         int inputNum = pDev->mInput;
+         if (inputNum >= inBufsSize || !mpActiveInputs[inputNum])
+         {
+            continue;
+         }
+
+         MpAudioBufPtr pFrame = inBufs[inputNum];
+         MpSpeechType speechType = pFrame->getSpeechType();
+         if (mpCommonGains[inputNum] != MP_BRIDGE_GAIN_MUTED)
+         {
+            mixInput(pFrame->getSamplesPtr(), mpCommonGains[inputNum],
+                     mpPrevAmplitudes[inputNum], pFrame->getAmplitude(),
+                     TRUE, mpMixAccumulator, samplesPerFrame);
+            amplitude -= mpCommonAmplitudes[inputNum];
+            speechTypes[speechType]--;
+            contributors--;
+         }
+         if (pDev->mGain != MP_BRIDGE_GAIN_MUTED)
+         {
+            amplitude += mixInput(pFrame->getSamplesPtr(), pDev->mGain,
+                                  mpPrevAmplitudes[inputNum],
+                                  pFrame->getAmplitude(),
+                                  FALSE, mpMixAccumulator, samplesPerFrame);
+            speechTypes[speechType]++;
+            contributors++;
+         }
+      }
+
+      if (contributors == 0)
+      {
+         outBufs[outputNum].release();
+         continue;
+      }
+
+      MpAudioBufPtr pOutBuf = makeOutput(mpMixAccumulator, amplitude,
+                                         mixedSpeechType(speechTypes),
+                                         samplesPerFrame);
+      outBufs[outputNum].swap(pOutBuf);
+   }
+
+   // Save input amplitudes for later use.
+   saveAmplitudes(inBufs, inBufsSize);
+
+   return TRUE;
+}
+
+void MpBridgeAlgCommonMix::setGainMatrixValue(int column, int row, MpBridgeGain val)
+{
+   mpGainMatrix[row*maxInputs() + column] = val;
+   mDeviationsValid = FALSE;
+}
+
+void MpBridgeAlgCommonMix::setGainMatrixRow(int row, int numValues, const MpBridgeGain val[])
+{
+   // Copy gain data to mix matrix row.
+   MpBridgeGain *pCurGain = &mpGainMatrix[row*maxInputs()];
+   for (int i=0; i<numValues; i++)
+   {
+      if (val[i] != MP_BRIDGE_GAIN_UNDEFINED)
+      {
+         *pCurGain = val[i];
+      }
+      pCurGain++;
+   }
+   mDeviationsValid = FALSE;
+}
+
+void MpBridgeAlgCommonMix::setGainMatrixColumn(int column, int numValues, const MpBridgeGain val[])
+{
+   // Copy gain data to mix matrix column.
+   MpBridgeGain *pCurGain = &mpGainMatrix[column];
+   for (int i=0; i<numValues; i++)
+   {
+      if (val[i] != MP_BRIDGE_GAIN_UNDEFINED)
+      {
+         *pCurGain = val[i];
+      }
+      pCurGain += maxInputs();
+   }
+   mDeviationsValid = FALSE;
+}
+
+/* ============================== ACCESSORS =============================== */
+
+/* =============================== INQUIRY ================================ */
+
+
+/* ////////////////////////////// PROTECTED /////////////////////////////// */
+
+void MpBridgeAlgCommonMix::updateDeviations()
+{
+   // Find the most used gain of every input with majority vote. If there is
+   // no majority the result is still a valid common gain, just not the best.
+   for (int inputNum=0; inputNum<maxInputs(); inputNum++)
+   {
+      MpBridgeGain candidate = MP_BRIDGE_GAIN_MUTED;
+      int votes = 0;
+      for (int outputNum=0; outputNum<maxOutputs(); outputNum++)
+      {
+         MpBridgeGain gain = mpGainMatrix[outputNum*maxInputs() + inputNum];
+         if (votes == 0)
+         {
+            candidate = gain;
+            votes = 1;
+         }
+         else if (gain == candidate)
+         {
+            votes++;
+         }
+         else
+         {
+            votes--;
+         }
+      }
+      mpCommonGains[inputNum] = candidate;
+   }
+
+   // Store all other gains as deviations.
+   int numDeviations = 0;
+   for (int outputNum=0; outputNum<maxOutputs(); outputNum++)
+   {
+      mpDeviationStart[outputNum] = numDeviations;
+      MpBridgeGain *pInputGains = &mpGainMatrix[outputNum*maxInputs()];
+      for (int inputNum=0; inputNum<maxInputs(); inputNum++)
+      {
+         if (pInputGains[inputNum] != mpCommonGains[inputNum])
+         {
+            mpDeviations[numDeviations].mInput = inputNum;
+            mpDeviations[numDeviations].mGain = pInputGains[inputNum];
+            numDeviations++;
+         }
+      }
+   }
+   mpDeviationStart[maxOutputs()] = numDeviations;
+
+   mDeviationsValid = TRUE;
+}
+
+int32_t MpBridgeAlgCommonMix::mixInput(const MpAudioSample *pSrc,
+                                       MpBridgeGain gain,
+                                       MpAudioSample prevAmplitude,
+                                       MpAudioSample curAmplitude,
+                                       UtlBoolean subtract,
+                                       MpBridgeAccum *pAccum,
+                                       int samplesPerFrame)
+{
+   // This is the mixing code of MpBridgeAlgSimple::doMix(). Subtraction
+   // negates the gains, which gives exactly negated products, as the
+   // linear gain step is calculated with division rounding to zero.
+   if (curAmplitude == 0)
+   {
+      curAmplitude = 1;
+   }
+
+   if (  gain == MP_BRIDGE_GAIN_PASSTHROUGH
+      && prevAmplitude == MpSpeechParams::MAX_AMPLITUDE
+      && curAmplitude == MpSpeechParams::MAX_AMPLITUDE)
+   {
+      if (subtract)
+      {
+         MpDspUtils::addMul_I(pSrc, -MP_BRIDGE_GAIN_PASSTHROUGH,
+                              pAccum, samplesPerFrame);
+      }
+      else
+      {
+         MpDspUtils::add_IGain(pSrc, pAccum, samplesPerFrame,
+                               MP_BRIDGE_FRAC_LENGTH);
+      }
+      return MpSpeechParams::MAX_AMPLITUDE;
+   }
+   else if (curAmplitude == prevAmplitude)
+   {
+      // Calculate gain taking into account input amplitude.
+      MpBridgeGain scaledGain = (MpBridgeGain)
+         ((gain*MAX_AMPLITUDE_ROUND)/curAmplitude);
+
+      MpDspUtils::addMul_I(pSrc, subtract ? -scaledGain : scaledGain,
+                           pAccum, samplesPerFrame);
+      return ((int)(curAmplitude*scaledGain))>>MP_BRIDGE_FRAC_LENGTH;
+   }
+   else
+   {
+      // Calculate gain start and end taking into account previous
+      // and current input amplitudes.
+      MpBridgeGain scaledGainStart = (MpBridgeGain)
+         ((gain*MAX_AMPLITUDE_ROUND)/prevAmplitude);
+      MpBridgeGain scaledGainEnd = (MpBridgeGain)
+         ((gain*MAX_AMPLITUDE_ROUND)/curAmplitude);
+
+      if (subtract)
+      {
+         MpDspUtils::addMulLinear_I(pSrc, -scaledGainStart, -scaledGainEnd,
+                                    pAccum, samplesPerFrame);
+      }
+      else
+      {
+         MpDspUtils::addMulLinear_I(pSrc, scaledGainStart, scaledGainEnd,
+                                    pAccum, samplesPerFrame);
+      }
+      MpBridgeGain scaledGainMax = MpDspUtils::maximum(scaledGainStart, scaledGainEnd);
+      return ((int)(curAmplitude*scaledGainMax)) >> MP_BRIDGE_FRAC_LENGTH;
+   }
+}
+
+MpSpeechType MpBridgeAlgCommonMix::mixedSpeechType(const int speechTypeCount[])
+{
+   // Same precedence as mixSpeechTypes() applied to all mixed frames.
+   if (speechTypeCount[MP_SPEECH_TONE] > 0)
+   {
+      return MP_SPEECH_TONE;
+   }
+   if (speechTypeCount[MP_SPEECH_ACTIVE] > 0)
+   {
+      return MP_SPEECH_ACTIVE;
+   }
+   if (speechTypeCount[MP_SPEECH_UNKNOWN] > 0)
+   {
+      return MP_SPEECH_UNKNOWN;
+   }
+   if (speechTypeCount[MP_SPEECH_COMFORT_NOISE] > 0)
+   {
+      return MP_SPEECH_COMFORT_NOISE;
+   }
+   return MP_SPEECH_SILENT;
+}
+
+MpAudioBufPtr MpBridgeAlgCommonMix::makeOutput(const MpBridgeAccum *pAccum,
+                                               int32_t amplitude,
+                                               MpSpeechType speechType,
+                                               int samplesPerFrame)
+{
+   // Get buffer for output data.
+   MpAudioBufPtr pOutBuf = MpMisc.RawAudioPool->getBuffer();
+   assert(pOutBuf.isValid());
+   pOutBuf->setSamplesNumber(samplesPerFrame);
+   pOutBuf->setSpeechType(speechType);
+   pOutBuf->setEnergy(-1);
+
+   // Set amplitude and clipping flag of the output frame.
+   pOutBuf->setAmplitude(MPF_SATURATE16(amplitude));
+   if (amplitude >= MpSpeechParams::MAX_AMPLITUDE)
+   {
+      pOutBuf->setClipping(TRUE);
+   }
+
+   // Move data from accumulator to output.
+   MpDspUtils::convert_Att(pAccum, pOutBuf->getSamplesWritePtr(),
+                           samplesPerFrame, MP_BRIDGE_FRAC_LENGTH);
+
+   return pOutBuf;
+}
+
+/* /////////////////////////////// PRIVATE //////////////////////////////// */
+
+
+/* ============================== FUNCTIONS =============================== */
@@ -22,7 +22,7 @@
 
 void MpBuf::attach()
 {
-    mRefCounter++;
+    MPBUF_REF_INCREMENT(&mRefCounter);
 #ifdef MPBUF_DEBUG
     osPrintf( "Buffer %d from pool %x have %d references now (++)\n"
             , mpPool->getBufferNumber(this)
@@ -40,11 +40,8 @@ void MpBuf::detach()
             , mRefCounter-1);
 #endif
 
-    mRefCounter--;
-    // If other thread decremented mRefCounter in this execution point then
-    // buffer will be freed twice. We try to fix this in the releaseBuffer()
-    // code checking is buffer already free or not.
-    if (mRefCounter == 0) 
+    // Only the thread which drops the last reference sees zero here.
+    if (MPBUF_REF_DECREMENT(&mRefCounter) == 0) 
     {
         if (mpDestroy != NULL) {
             mpDestroy(this);
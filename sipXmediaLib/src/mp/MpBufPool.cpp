@@ -39,53 +39,25 @@
 #  define MP_ALIGN_SIZE 4
 #endif // !(__x86_64__ || _M_X64) ]
 
+#ifdef MPBUFPOOL_LOCK_FREE // [
+   /// Update statistics counters shared by all threads using the pool.
+#  define MPBUFPOOL_ADD(pVal, val) __atomic_add_fetch((pVal), (val), __ATOMIC_RELAXED)
+#  define MPBUFPOOL_SUB(pVal, val) __atomic_sub_fetch((pVal), (val), __ATOMIC_RELAXED)
+#else // MPBUFPOOL_LOCK_FREE ][
+#  define MPBUFPOOL_ADD(pVal, val) (*(pVal) += (val))
+#  define MPBUFPOOL_SUB(pVal, val) (*(pVal) -= (val))
+#endif // MPBUFPOOL_LOCK_FREE ]
+
+/// Free stack top with the block number plus one and the tag.
+#define MPBUFPOOL_TOP(tag, blockPlusOne) ((((uint64_t)(tag)) << 32) | (blockPlusOne))
+#define MPBUFPOOL_TOP_TAG(top) ((uint32_t)((top) >> 32))
+#define MPBUFPOOL_TOP_BLOCK(top) ((unsigned)((top) & 0xffffffff))
+
 // EXTERNAL FUNCTIONS
 // EXTERNAL VARIABLES
 // CONSTANTS
 // STATIC VARIABLE INITIALIZATIONS
 
-/// Class for internal MpBufPool use.
-/**
-*  This class provides single linked list interface for MpBuf class. It uses
-*  MpBuf::mpPool to store pointer to next buffer.
-*/
-struct MpBufList : public MpBuf {
-    friend class MpBufPool;
-public:
-
-    /// Get buffer next to current.
-    MpBufList *getNextBuf() {return (MpBufList*)mpPool;}
-
-    /// Set buffer next to current.
-    void setNextBuf(MpBuf *pNext) {mpPool = (MpBufPool*)pNext;}
-
-    int length() const
-    {
-        int length = 0;
-        MpBufList* next = (MpBufList*) mpPool;
-        while(next)
-        {
-            length++;
-            next = (MpBufList*) next->mpPool;
-        }
-        return(length);
-    }
-
-private:
-
-    /// Disable copy (and other) constructor.
-    MpBufList(const MpBuf &);
-    /**<
-    * This struct will be initialized by init() member.
-    */
-
-    /// Disable assignment operator.
-    MpBufList &operator=(const MpBuf &);
-    /**<
-    * Buffers may be copied. But do we need this?
-    */
-};
-
 /* //////////////////////////// PUBLIC //////////////////////////////////// */
 
 /* ============================ CREATORS ================================== */
@@ -97,7 +69,8 @@ MpBufPool::MpBufPool(unsigned blockSize, unsigned numBlocks, const UtlString& po
 , mNumBlocks(numBlocks)
 , mPoolBytes(mBlockSpan*mNumBlocks)
 , mpPoolData(new char[mPoolBytes])
-, mpFreeList(NULL)
+, mFreeTop(MPBUFPOOL_TOP(0, 0))
+, mpNextFree(new unsigned[numBlocks])
 , mMutex(OsMutex::Q_PRIORITY)
 , mNumGets(0)
 , mNumFrees(0)
@@ -110,13 +83,13 @@ MpBufPool::MpBufPool(unsigned blockSize, unsigned numBlocks, const UtlString& po
     // Init buffers
     char *pBlock = mpPoolData;
     for (int i=mNumBlocks; i>0; i--) {
-        MpBuf *pBuf = (MpBufList *)pBlock;
+        MpBuf *pBuf = (MpBuf *)pBlock;
         pBuf->mRefCounter = 0;
-        // Don't set mpPool cause it is used by current implementation of free list
-        //pBuf->mpPool = this;
+        // Free buffers do not belong to the pool until they are taken
+        pBuf->mpPool = NULL;
 
-        // Add buffer to the end of free list
-        appendFreeList(pBuf);
+        // Put buffer on the top of free stack
+        pushFreeList(pBuf);
         
         // Jump to next block
         pBlock = getNextBlock(pBlock);
@@ -142,6 +115,7 @@ MpBufPool::~MpBufPool()
     }
 #endif
 
+    delete[] mpNextFree;
     delete[] mpPoolData;
 }
 
@@ -149,10 +123,14 @@ MpBufPool::~MpBufPool()
 
 MpBuf *MpBufPool::getBuffer()
 {
+#ifndef MPBUFPOOL_LOCK_FREE
     OsLock lock(mMutex);
+#endif
+
+    MpBuf *pFreeBuffer = popFreeList();
 
     // No free blocks found.
-    if (mpFreeList == NULL) 
+    if (pFreeBuffer == NULL) 
     {
         profileFlowgraphPoolUsage();
         OsSysLog::add(FAC_MP, PRI_ERR,
@@ -164,20 +142,20 @@ MpBuf *MpBufPool::getBuffer()
         return NULL;
     }
     
-    MpBuf *pFreeBuffer = mpFreeList;
-    mpFreeList = mpFreeList->getNextBuf();
     pFreeBuffer->mpPool = this;
     pFreeBuffer->mpFlowGraph = NULL;
-    mNumGets++;
-    mNumFree--;
-    if (mNumFree < mMinFree)
+    MPBUFPOOL_ADD(&mNumGets, 1);
+    unsigned numFree = MPBUFPOOL_SUB(&mNumFree, 1);
+    // Without the mutex two threads may both lower mMinFree, which only
+    // matters to the log below.
+    if (numFree < mMinFree)
     {
-        mMinFree = mNumFree;
-        if (0 == (0x3f&mNumFree))
+        mMinFree = numFree;
+        if (0 == (0x3f&numFree))
         {
             OsSysLog::add(FAC_MP, PRI_DEBUG,
                 "MpBufPool::getBuffer pool: %s (%p), NumFree dropped to %d",
-                mPoolName.data(), this, mNumFree); 
+                mPoolName.data(), this, numFree); 
         }
     }
 
@@ -192,20 +170,33 @@ MpBuf *MpBufPool::getBuffer()
 
 void MpBufPool::releaseBuffer(MpBuf *pBuffer)
 {
-    OsLock lock(mMutex);
 #ifdef MPBUF_DEBUG
     osPrintf("Buffer %d from pool %x have been freed.\n",
              getBufferNumber(pBuffer), this);
 #endif
     assert(pBuffer->mRefCounter == 0);
 
-    // This check is need cause we don't synchronize MpBuf's reference counter.
-    // See note in MpBuf::detach().
-    if (pBuffer->mpPool == this) {
-        appendFreeList(pBuffer);
+    // Buffers in use point to their pool and free ones do not, so a buffer
+    // freed twice or to the wrong pool is not put on the free stack.
+    MpBufPool *pOwner = this;
+#ifdef MPBUFPOOL_LOCK_FREE
+    UtlBoolean owned =
+       __atomic_compare_exchange_n(&pBuffer->mpPool, &pOwner, (MpBufPool*)NULL,
+                                   false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+#else
+    OsLock lock(mMutex);
+    UtlBoolean owned = (pBuffer->mpPool == pOwner);
+    if (owned) {
+        pBuffer->mpPool = NULL;
+    }
+#endif
+
+    if (owned) {
+        // Clear it before any other thread may take the buffer again.
         pBuffer->mpFlowGraph = NULL;
-        mNumFrees++;
-        mNumFree++;
+        pushFreeList(pBuffer);
+        MPBUFPOOL_ADD(&mNumFrees, 1);
+        MPBUFPOOL_ADD(&mNumFree, 1);
     } else {
 #ifdef MPBUF_DEBUG
         osPrintf("Error: freeing buffer with wrong pool or freeing buffer twice!");
@@ -222,14 +213,12 @@ int MpBufPool::getBufferNumber(MpBuf *pBuf) const
 
 int MpBufPool::getFreeBufferCount()
 {
+#ifdef MPBUFPOOL_LOCK_FREE
+    return __atomic_load_n(&mNumFree, __ATOMIC_RELAXED);
+#else
     OsLock lock(mMutex);
-    int count = 0;
-    if(mpFreeList)
-    {
-       count = mpFreeList->length();
-    }
-
-    return(count);
+    return(mNumFree);
+#endif
 }
 
 int MpBufPool::scanBufPool(MpFlowGraphBase *pFG)
@@ -307,10 +296,54 @@ const UtlString& MpBufPool::getName()
 
 /* //////////////////////////// PROTECTED ///////////////////////////////// */
 
-void MpBufPool::appendFreeList(MpBuf *pBuffer)
+MpBuf *MpBufPool::popFreeList()
+{
+#ifdef MPBUFPOOL_LOCK_FREE
+    uint64_t top = __atomic_load_n(&mFreeTop, __ATOMIC_ACQUIRE);
+    uint64_t newTop;
+    do {
+        if (MPBUFPOOL_TOP_BLOCK(top) == 0)
+        {
+            return NULL;
+        }
+        // If another thread takes this block meanwhile, the next free block
+        // read here may be wrong, but then the tag has changed and the
+        // exchange fails.
+        newTop = MPBUFPOOL_TOP(MPBUFPOOL_TOP_TAG(top) + 1,
+                               __atomic_load_n(&mpNextFree[MPBUFPOOL_TOP_BLOCK(top) - 1],
+                                               __ATOMIC_RELAXED));
+    } while (!__atomic_compare_exchange_n(&mFreeTop, &top, newTop, true,
+                                          __ATOMIC_ACQUIRE, __ATOMIC_ACQUIRE));
+#else
+    uint64_t top = mFreeTop;
+    if (MPBUFPOOL_TOP_BLOCK(top) == 0)
+    {
+        return NULL;
+    }
+    mFreeTop = MPBUFPOOL_TOP(MPBUFPOOL_TOP_TAG(top) + 1,
+                             mpNextFree[MPBUFPOOL_TOP_BLOCK(top) - 1]);
+#endif
+
+    return (MpBuf*)(mpPoolData + (MPBUFPOOL_TOP_BLOCK(top) - 1)*mBlockSpan);
+}
+
+void MpBufPool::pushFreeList(MpBuf *pBuffer)
 {
-    ((MpBufList*)pBuffer)->setNextBuf(mpFreeList);
-    mpFreeList = (MpBufList*)pBuffer;
+    unsigned blockPlusOne = getBufferNumber(pBuffer) + 1;
+
+#ifdef MPBUFPOOL_LOCK_FREE
+    uint64_t top = __atomic_load_n(&mFreeTop, __ATOMIC_RELAXED);
+    do {
+        __atomic_store_n(&mpNextFree[blockPlusOne - 1], MPBUFPOOL_TOP_BLOCK(top),
+                         __ATOMIC_RELAXED);
+    } while (!__atomic_compare_exchange_n(&mFreeTop, &top,
+                                          MPBUFPOOL_TOP(MPBUFPOOL_TOP_TAG(top) + 1,
+                                                        blockPlusOne),
+                                          true, __ATOMIC_RELEASE, __ATOMIC_RELAXED));
+#else
+    mpNextFree[blockPlusOne - 1] = MPBUFPOOL_TOP_BLOCK(mFreeTop);
+    mFreeTop = MPBUFPOOL_TOP(MPBUFPOOL_TOP_TAG(mFreeTop) + 1, blockPlusOne);
+#endif
 }
 
 
@@ -18,6 +18,29 @@
 // EXTERNAL VARIABLES
 // CONSTANTS
 // STATIC VARIABLE INITIALIZATIONS
+#ifdef MP_DSP_SIMD // [
+const MpDspUtils::VectorKernels MpDspUtils::smCKernels =
+{
+   MpDspUtils::add_I_C,
+   MpDspUtils::add_IGain_C,
+   MpDspUtils::add_IAtt_C,
+   MpDspUtils::add_C,
+   MpDspUtils::addMul_I_C,
+   MpDspUtils::addMulLinear_I_C,
+   MpDspUtils::mul_C,
+   MpDspUtils::mulLinear_C,
+   MpDspUtils::convert_C,
+   MpDspUtils::convert_Gain_C,
+   MpDspUtils::convert_Att_C,
+   MpDspUtils::convert_C,
+   MpDspUtils::convert_Gain_C,
+   MpDspUtils::convert_Att_C
+};
+// Generic versions are used until CPU is checked during static initialization.
+const MpDspUtils::VectorKernels *MpDspUtils::smpVectorKernels = &MpDspUtils::smCKernels;
+static MpDspUtils::SimdLevel sInitialSimdLevel =
+   MpDspUtils::setSimdLevel(MpDspUtils::getMaxSimdLevel());
+#endif // MP_DSP_SIMD ]
 
 /* //////////////////////////////// PUBLIC //////////////////////////////// */
 
@@ -26,6 +49,64 @@
 #  include <mp/MpDspUtilsSumVect.h>
 #endif // !MP_DSP_INLINE_VECTOR_FUNCTIONS ]
 
+MpDspUtils::SimdLevel MpDspUtils::getMaxSimdLevel()
+{
+#ifdef MP_DSP_SIMD // [
+   // May be called before main(), so CPU info must be initialized manually.
+   __builtin_cpu_init();
+   if (__builtin_cpu_supports("avx2"))
+   {
+      return SIMD_AVX2;
+   }
+   if (__builtin_cpu_supports("sse2"))
+   {
+      return SIMD_SSE2;
+   }
+#endif // MP_DSP_SIMD ]
+   return SIMD_NONE;
+}
+
+MpDspUtils::SimdLevel MpDspUtils::getSimdLevel()
+{
+#ifdef MP_DSP_SIMD // [
+   if (smpVectorKernels == &smAvx2Kernels)
+   {
+      return SIMD_AVX2;
+   }
+   if (smpVectorKernels == &smSse2Kernels)
+   {
+      return SIMD_SSE2;
+   }
+#endif // MP_DSP_SIMD ]
+   return SIMD_NONE;
+}
+
+MpDspUtils::SimdLevel MpDspUtils::setSimdLevel(SimdLevel level)
+{
+   SimdLevel maxLevel = getMaxSimdLevel();
+   if (level > maxLevel)
+   {
+      level = maxLevel;
+   }
+
+#ifdef MP_DSP_SIMD // [
+   switch (level)
+   {
+   case SIMD_AVX2:
+      smpVectorKernels = &smAvx2Kernels;
+      break;
+   case SIMD_SSE2:
+      smpVectorKernels = &smSse2Kernels;
+      break;
+   default:
+      smpVectorKernels = &smCKernels;
+      break;
+   }
+#endif // MP_DSP_SIMD ]
+
+   return level;
+}
+
 /* ////////////////////////////// PROTECTED /////////////////////////////// */
 
 
@@ -0,0 +1,617 @@
+//
+// Copyright (C) 2026 SIPez LLC. All rights reserved.
+//
+//
+// $$
+//////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+// APPLICATION INCLUDES
+#include <mp/MpDspUtils.h>
+
+#ifdef MP_DSP_SIMD // [
+
+#include <immintrin.h>
+
+// EXTERNAL FUNCTIONS
+// EXTERNAL VARIABLES
+// CONSTANTS
+// DEFINES
+// Compile functions for given instruction set without global compiler flags.
+// Functions are called only after CPU support is checked in runtime.
+#define MP_SSE2_FUNC __attribute__((target("sse2")))
+#define MP_AVX2_FUNC __attribute__((target("avx2")))
+
+// STATIC VARIABLE INITIALIZATIONS
+
+/* ============================== FUNCTIONS =============================== */
+
+/*
+ * All functions below must give exactly the same results as the generic
+ * C versions in MpDspUtilsSumVect.h and MpDspUtilsConvertVect.h, including
+ * their saturation to [-MAX;MAX] range. Vector tails are processed by
+ * the next simpler version. AVX2 versions clear upper halves of registers
+ * before that, to avoid AVX-SSE transition penalty.
+ */
+
+/* ------------------------------- SSE2 ----------------------------------- */
+
+/// Sign extend 8 16-bit integers to two vectors of 32-bit integers.
+static inline MP_SSE2_FUNC
+void sse2Extend16(__m128i src, __m128i &lo, __m128i &hi)
+{
+   lo = _mm_srai_epi32(_mm_unpacklo_epi16(src, src), 16);
+   hi = _mm_srai_epi32(_mm_unpackhi_epi16(src, src), 16);
+}
+
+/// Full 32-bit products of 8 16-bit integers and \p val.
+static inline MP_SSE2_FUNC
+void sse2Mul16(__m128i src, __m128i val, __m128i &lo, __m128i &hi)
+{
+   __m128i prodLo = _mm_mullo_epi16(src, val);
+   __m128i prodHi = _mm_mulhi_epi16(src, val);
+   lo = _mm_unpacklo_epi16(prodLo, prodHi);
+   hi = _mm_unpackhi_epi16(prodLo, prodHi);
+}
+
+/// Select \p a where \p mask is set and \p b elsewhere.
+static inline MP_SSE2_FUNC
+__m128i sse2Select(__m128i mask, __m128i a, __m128i b)
+{
+   return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+}
+
+/// Saturated 32-bit addition, as MpDspUtils::add(int32_t, int32_t).
+static inline MP_SSE2_FUNC
+__m128i sse2AddSat32(__m128i a, __m128i b)
+{
+   __m128i sum = _mm_add_epi32(a, b);
+   // Addition wrapped if a and b have the same sign and sum has other one.
+   __m128i wrapped = _mm_srai_epi32(_mm_andnot_si128(_mm_xor_si128(a, b),
+                                                     _mm_xor_si128(a, sum)),
+                                    31);
+   __m128i saturated = _mm_xor_si128(_mm_srai_epi32(a, 31),
+                                     _mm_set1_epi32(INT32_MAX));
+   sum = sse2Select(wrapped, saturated, sum);
+   // Saturate INT32_MIN to (INT32_MIN+1).
+   return _mm_sub_epi32(sum, _mm_cmpeq_epi32(sum, _mm_set1_epi32(INT32_MIN)));
+}
+
+/// Pack 32-bit integers to 16-bit ones saturating to [-INT16_MAX;INT16_MAX].
+static inline MP_SSE2_FUNC
+__m128i sse2Pack32(__m128i lo, __m128i hi)
+{
+   return _mm_max_epi16(_mm_packs_epi32(lo, hi), _mm_set1_epi16(-INT16_MAX));
+}
+
+/// Shift left with saturation, as MpDspUtils::shl16() and shl32().
+static inline MP_SSE2_FUNC
+__m128i sse2ShlSat(__m128i a, __m128i count, int32_t thresold, int32_t maxVal)
+{
+   __m128i isMax = _mm_cmpgt_epi32(a, _mm_set1_epi32(thresold-1));
+   __m128i isMin = _mm_cmplt_epi32(a, _mm_set1_epi32(-thresold));
+   return sse2Select(isMax, _mm_set1_epi32(maxVal),
+                     sse2Select(isMin, _mm_set1_epi32(-maxVal),
+                                _mm_sll_epi32(a, count)));
+}
+
+static MP_SSE2_FUNC
+OsStatus add_I_Sse2(const int16_t *pSrc1, int32_t *pSrc2Dst, int dataLength)
+{
+   int i = 0;
+   for (; i+8 <= dataLength; i += 8)
+   {
+      __m128i lo, hi;
+      sse2Extend16(_mm_loadu_si128((const __m128i*)(pSrc1+i)), lo, hi);
+      __m128i *pDst = (__m128i*)(pSrc2Dst+i);
+      _mm_storeu_si128(pDst, sse2AddSat32(_mm_loadu_si128(pDst), lo));
+      _mm_storeu_si128(pDst+1, sse2AddSat32(_mm_loadu_si128(pDst+1), hi));
+   }
+   return MpDspUtils::add_I_C(pSrc1+i, pSrc2Dst+i, dataLength-i);
+}
+
+static MP_SSE2_FUNC
+OsStatus add_IGain_Sse2(const int16_t *pSrc1, int32_t *pSrc2Dst, int dataLength,
+                        unsigned src1ScaleFactor)
+{
+   const __m128i count = _mm_cvtsi32_si128(src1ScaleFactor);
+   int i = 0;
+   for (; i+8 <= dataLength; i += 8)
+   {
+      __m128i lo, hi;
+      sse2Extend16(_mm_loadu_si128((const __m128i*)(pSrc1+i)), lo, hi);
+      __m128i *pDst = (__m128i*)(pSrc2Dst+i);
+      _mm_storeu_si128(pDst, sse2AddSat32(_mm_loadu_si128(pDst),
+                                          _mm_sll_epi32(lo, count)));
+      _mm_storeu_si128(pDst+1, sse2AddSat32(_mm_loadu_si128(pDst+1),
+                                            _mm_sll_epi32(hi, count)));
+   }
+   return MpDspUtils::add_IGain_C(pSrc1+i, pSrc2Dst+i, dataLength-i,
+                                  src1ScaleFactor);
+}
+
+static MP_SSE2_FUNC
+OsStatus add_IAtt_Sse2(const int16_t *pSrc1, int32_t *pSrc2Dst, int dataLength,
+                       unsigned src1ScaleFactor)
+{
+   const __m128i count = _mm_cvtsi32_si128(src1ScaleFactor);
+   int i = 0;
+   for (; i+8 <= dataLength; i += 8)
+   {
+      __m128i lo, hi;
+      sse2Extend16(_mm_loadu_si128((const __m128i*)(pSrc1+i)), lo, hi);
+      __m128i *pDst = (__m128i*)(pSrc2Dst+i);
+      _mm_storeu_si128(pDst, sse2AddSat32(_mm_loadu_si128(pDst),
+                                          _mm_sra_epi32(lo, count)));
+      _mm_storeu_si128(pDst+1, sse2AddSat32(_mm_loadu_si128(pDst+1),
+                                            _mm_sra_epi32(hi, count)));
+   }
+   return MpDspUtils::add_IAtt_C(pSrc1+i, pSrc2Dst+i, dataLength-i,
+                                 src1ScaleFactor);
+}
+
+static MP_SSE2_FUNC
+OsStatus add_Sse2(const int32_t *pSrc1, const int32_t *pSrc2, int32_t *pDst,
+                  int dataLength)
+{
+   int i = 0;
+   for (; i+4 <= dataLength; i += 4)
+   {
+      _mm_storeu_si128((__m128i*)(pDst+i),
+                       sse2AddSat32(_mm_loadu_si128((const __m128i*)(pSrc1+i)),
+                                    _mm_loadu_si128((const __m128i*)(pSrc2+i))));
+   }
+   return MpDspUtils::add_C(pSrc1+i, pSrc2+i, pDst+i, dataLength-i);
+}
+
+static MP_SSE2_FUNC
+OsStatus addMul_I_Sse2(const int16_t *pSrc1, int16_t val, int32_t *pSrc2Dst,
+                       int dataLength)
+{
+   const __m128i vVal = _mm_set1_epi16(val);
+   int i = 0;
+   for (; i+8 <= dataLength; i += 8)
+   {
+      __m128i lo, hi;
+      sse2Mul16(_mm_loadu_si128((const __m128i*)(pSrc1+i)), vVal, lo, hi);
+      __m128i *pDst = (__m128i*)(pSrc2Dst+i);
+      _mm_storeu_si128(pDst, sse2AddSat32(_mm_loadu_si128(pDst), lo));
+      _mm_storeu_si128(pDst+1, sse2AddSat32(_mm_loadu_si128(pDst+1), hi));
+   }
+   return MpDspUtils::addMul_I_C(pSrc1+i, val, pSrc2Dst+i, dataLength-i);
+}
+
+static MP_SSE2_FUNC
+OsStatus addMulLinear_I_Sse2(const int16_t *pSrc1, int16_t valStart, int16_t valEnd,
+                             int32_t *pSrc2Dst, int dataLength)
+{
+   // Values must wrap exactly as in addMulLinear_I_C(), so step and
+   // multipliers are calculated in 16 bits.
+   const int16_t step = (valEnd - valStart) / dataLength;
+   int16_t val = valStart;
+   int i = 0;
+   if (dataLength >= 8)
+   {
+      int16_t vals[8];
+      for (int j=0; j<8; j++)
+      {
+         vals[j] = val + j*step;
+      }
+      __m128i vVal = _mm_loadu_si128((const __m128i*)vals);
+      const int16_t step8 = 8*step;
+      const __m128i vStep8 = _mm_set1_epi16(step8);
+
+      for (; i+8 <= dataLength; i += 8, val += step8)
+      {
+         __m128i lo, hi;
+         sse2Mul16(_mm_loadu_si128((const __m128i*)(pSrc1+i)), vVal, lo, hi);
+         __m128i *pDst = (__m128i*)(pSrc2Dst+i);
+         _mm_storeu_si128(pDst, sse2AddSat32(_mm_loadu_si128(pDst), lo));
+         _mm_storeu_si128(pDst+1, sse2AddSat32(_mm_loadu_si128(pDst+1), hi));
+         vVal = _mm_add_epi16(vVal, vStep8);
+      }
+   }
+   for (; i<dataLength; i++, val += step)
+   {
+      MpDspUtils::addMul_I(pSrc2Dst[i], pSrc1[i], val);
+   }
+   return OS_SUCCESS;
+}
+
+static MP_SSE2_FUNC
+OsStatus mul_Sse2(const int16_t *pSrc, const int16_t val, int32_t *pDst,
+                  int dataLength)
+{
+   const __m128i vVal = _mm_set1_epi16(val);
+   int i = 0;
+   for (; i+8 <= dataLength; i += 8)
+   {
+      __m128i lo, hi;
+      sse2Mul16(_mm_loadu_si128((const __m128i*)(pSrc+i)), vVal, lo, hi);
+      _mm_storeu_si128((__m128i*)(pDst+i), lo);
+      _mm_storeu_si128((__m128i*)(pDst+i+4), hi);
+   }
+   return MpDspUtils::mul_C(pSrc+i, val, pDst+i, dataLength-i);
+}
+
+static MP_SSE2_FUNC
+OsStatus mulLinear_Sse2(const int16_t *pSrc, int16_t valStart, int16_t valEnd,
+                        int32_t *pDst, int dataLength)
+{
+   // See addMulLinear_I_Sse2() for wrapping notes.
+   const int16_t step = (valEnd - valStart) / dataLength;
+   int16_t val = valStart;
+   int i = 0;
+   if (dataLength >= 8)
+   {
+      int16_t vals[8];
+      for (int j=0; j<8; j++)
+      {
+         vals[j] = val + j*step;
+      }
+      __m128i vVal = _mm_loadu_si128((const __m128i*)vals);
+      const int16_t step8 = 8*step;
+      const __m128i vStep8 = _mm_set1_epi16(step8);
+
+      for (; i+8 <= dataLength; i += 8, val += step8)
+      {
+         __m128i lo, hi;
+         sse2Mul16(_mm_loadu_si128((const __m128i*)(pSrc+i)), vVal, lo, hi);
+         _mm_storeu_si128((__m128i*)(pDst+i), lo);
+         _mm_storeu_si128((__m128i*)(pDst+i+4), hi);
+         vVal = _mm_add_epi16(vVal, vStep8);
+      }
+   }
+   for (; i<dataLength; i++, val += step)
+   {
+      pDst[i] = pSrc[i] * val;
+   }
+   return OS_SUCCESS;
+}
+
+static MP_SSE2_FUNC
+OsStatus convert32to16_Sse2(const int32_t *pSrc, int16_t *pDst, int dataLength)
+{
+   int i = 0;
+   for (; i+8 <= dataLength; i += 8)
+   {
+      _mm_storeu_si128((__m128i*)(pDst+i),
+                       sse2Pack32(_mm_loadu_si128((const __m128i*)(pSrc+i)),
+                                  _mm_loadu_si128((const __m128i*)(pSrc+i+4))));
+   }
+   return MpDspUtils::convert_C(pSrc+i, pDst+i, dataLength-i);
+}
+
+static MP_SSE2_FUNC
+OsStatus convert_Gain32to16_Sse2(const int32_t *pSrc, int16_t *pDst, int dataLength,
+                                 unsigned srcScaleFactor)
+{
+   const __m128i count = _mm_cvtsi32_si128(srcScaleFactor);
+   const int32_t thresold = INT16_MAX>>srcScaleFactor;
+   int i = 0;
+   for (; i+8 <= dataLength; i += 8)
+   {
+      __m128i lo = sse2ShlSat(_mm_loadu_si128((const __m128i*)(pSrc+i)),
+                              count, thresold, INT16_MAX);
+      __m128i hi = sse2ShlSat(_mm_loadu_si128((const __m128i*)(pSrc+i+4)),
+                              count, thresold, INT16_MAX);
+      _mm_storeu_si128((__m128i*)(pDst+i), _mm_packs_epi32(lo, hi));
+   }
+   return MpDspUtils::convert_Gain_C(pSrc+i, pDst+i, dataLength-i, srcScaleFactor);
+}
+
+static MP_SSE2_FUNC
+OsStatus convert_Att32to16_Sse2(const int32_t *pSrc, int16_t *pDst, int dataLength,
+                                unsigned srcScaleFactor)
+{
+   const __m128i count = _mm_cvtsi32_si128(srcScaleFactor);
+   int i = 0;
+   for (; i+8 <= dataLength; i += 8)
+   {
+      __m128i lo = _mm_sra_epi32(_mm_loadu_si128((const __m128i*)(pSrc+i)), count);
+      __m128i hi = _mm_sra_epi32(_mm_loadu_si128((const __m128i*)(pSrc+i+4)), count);
+      _mm_storeu_si128((__m128i*)(pDst+i), sse2Pack32(lo, hi));
+   }
+   return MpDspUtils::convert_Att_C(pSrc+i, pDst+i, dataLength-i, srcScaleFactor);
+}
+
+static MP_SSE2_FUNC
+OsStatus convert16to32_Sse2(const int16_t *pSrc, int32_t *pDst, int dataLength)
+{
+   int i = 0;
+   for (; i+8 <= dataLength; i += 8)
+   {
+      __m128i lo, hi;
+      sse2Extend16(_mm_loadu_si128((const __m128i*)(pSrc+i)), lo, hi);
+      _mm_storeu_si128((__m128i*)(pDst+i), lo);
+      _mm_storeu_si128((__m128i*)(pDst+i+4), hi);
+   }
+   return MpDspUtils::convert_C(pSrc+i, pDst+i, dataLength-i);
+}
+
+static MP_SSE2_FUNC
+OsStatus convert_Gain16to32_Sse2(const int16_t *pSrc, int32_t *pDst, int dataLength,
+                                 unsigned srcScaleFactor)
+{
+   const __m128i count = _mm_cvtsi32_si128(srcScaleFactor);
+   const int32_t thresold = INT32_MAX>>srcScaleFactor;
+   int i = 0;
+   for (; i+8 <= dataLength; i += 8)
+   {
+      __m128i lo, hi;
+      sse2Extend16(_mm_loadu_si128((const __m128i*)(pSrc+i)), lo, hi);
+      _mm_storeu_si128((__m128i*)(pDst+i),
+                       sse2ShlSat(lo, count, thresold, INT32_MAX));
+      _mm_storeu_si128((__m128i*)(pDst+i+4),
+                       sse2ShlSat(hi, count, thresold, INT32_MAX));
+   }
+   return MpDspUtils::convert_Gain_C(pSrc+i, pDst+i, dataLength-i, srcScaleFactor);
+}
+
+static MP_SSE2_FUNC
+OsStatus convert_Att16to32_Sse2(const int16_t *pSrc, int32_t *pDst, int dataLength,
+                                unsigned srcScaleFactor)
+{
+   const __m128i count = _mm_cvtsi32_si128(srcScaleFactor);
+   int i = 0;
+   for (; i+8 <= dataLength; i += 8)
+   {
+      __m128i lo, hi;
+      sse2Extend16(_mm_loadu_si128((const __m128i*)(pSrc+i)), lo, hi);
+      _mm_storeu_si128((__m128i*)(pDst+i), _mm_sra_epi32(lo, count));
+      _mm_storeu_si128((__m128i*)(pDst+i+4), _mm_sra_epi32(hi, count));
+   }
+   return MpDspUtils::convert_Att_C(pSrc+i, pDst+i, dataLength-i, srcScaleFactor);
+}
+
+/* ------------------------------- AVX2 ----------------------------------- */
+
+/// Load 8 16-bit integers sign extended to 32 bits.
+static inline MP_AVX2_FUNC
+__m256i avx2Load16(const int16_t *pSrc)
+{
+   return _mm256_cvtepi16_epi32(_mm_loadu_si128((const __m128i*)pSrc));
+}
+
+/// Select \p a where \p mask is set and \p b elsewhere.
+static inline MP_AVX2_FUNC
+__m256i avx2Select(__m256i mask, __m256i a, __m256i b)
+{
+   return _mm256_blendv_epi8(b, a, mask);
+}
+
+/// @copydoc sse2AddSat32()
+static inline MP_AVX2_FUNC
+__m256i avx2AddSat32(__m256i a, __m256i b)
+{
+   __m256i sum = _mm256_add_epi32(a, b);
+   __m256i wrapped = _mm256_srai_epi32(_mm256_andnot_si256(_mm256_xor_si256(a, b),
+                                                           _mm256_xor_si256(a, sum)),
+                                       31);
+   __m256i saturated = _mm256_xor_si256(_mm256_srai_epi32(a, 31),
+                                        _mm256_set1_epi32(INT32_MAX));
+   sum = avx2Select(wrapped, saturated, sum);
+   return _mm256_max_epi32(sum, _mm256_set1_epi32(INT32_MIN+1));
+}
+
+/// @copydoc sse2Pack32()
+static inline MP_AVX2_FUNC
+__m256i avx2Pack32(__m256i lo, __m256i hi)
+{
+   // Packing works inside 128-bit lanes, so restore order of elements.
+   __m256i packed = _mm256_permute4x64_epi64(_mm256_packs_epi32(lo, hi), 0xD8);
+   return _mm256_max_epi16(packed, _mm256_set1_epi16(-INT16_MAX));
+}
+
+/// @copydoc sse2ShlSat()
+static inline MP_AVX2_FUNC
+__m256i avx2ShlSat(__m256i a, __m128i count, int32_t thresold, int32_t maxVal)
+{
+   __m256i isMax = _mm256_cmpgt_epi32(a, _mm256_set1_epi32(thresold-1));
+   __m256i isMin = _mm256_cmpgt_epi32(_mm256_set1_epi32(-thresold), a);
+   return avx2Select(isMax, _mm256_set1_epi32(maxVal),
+                     avx2Select(isMin, _mm256_set1_epi32(-maxVal),
+                                _mm256_sll_epi32(a, count)));
+}
+
+static MP_AVX2_FUNC
+OsStatus add_I_Avx2(const int16_t *pSrc1, int32_t *pSrc2Dst, int dataLength)
+{
+   int i = 0;
+   for (; i+8 <= dataLength; i += 8)
+   {
+      __m256i *pDst = (__m256i*)(pSrc2Dst+i);
+      _mm256_storeu_si256(pDst, avx2AddSat32(_mm256_loadu_si256(pDst),
+                                             avx2Load16(pSrc1+i)));
+   }
+   _mm256_zeroupper();
+   return MpDspUtils::add_I_C(pSrc1+i, pSrc2Dst+i, dataLength-i);
+}
+
+static MP_AVX2_FUNC
+OsStatus add_IGain_Avx2(const int16_t *pSrc1, int32_t *pSrc2Dst, int dataLength,
+                        unsigned src1ScaleFactor)
+{
+   const __m128i count = _mm_cvtsi32_si128(src1ScaleFactor);
+   int i = 0;
+   for (; i+8 <= dataLength; i += 8)
+   {
+      __m256i *pDst = (__m256i*)(pSrc2Dst+i);
+      _mm256_storeu_si256(pDst,
+                          avx2AddSat32(_mm256_loadu_si256(pDst),
+                                       _mm256_sll_epi32(avx2Load16(pSrc1+i), count)));
+   }
+   _mm256_zeroupper();
+   return MpDspUtils::add_IGain_C(pSrc1+i, pSrc2Dst+i, dataLength-i,
+                                  src1ScaleFactor);
+}
+
+static MP_AVX2_FUNC
+OsStatus add_IAtt_Avx2(const int16_t *pSrc1, int32_t *pSrc2Dst, int dataLength,
+                       unsigned src1ScaleFactor)
+{
+   const __m128i count = _mm_cvtsi32_si128(src1ScaleFactor);
+   int i = 0;
+   for (; i+8 <= dataLength; i += 8)
+   {
+      __m256i *pDst = (__m256i*)(pSrc2Dst+i);
+      _mm256_storeu_si256(pDst,
+                          avx2AddSat32(_mm256_loadu_si256(pDst),
+                                       _mm256_sra_epi32(avx2Load16(pSrc1+i), count)));
+   }
+   _mm256_zeroupper();
+   return MpDspUtils::add_IAtt_C(pSrc1+i, pSrc2Dst+i, dataLength-i,
+                                 src1ScaleFactor);
+}
+
+static MP_AVX2_FUNC
+OsStatus add_Avx2(const int32_t *pSrc1, const int32_t *pSrc2, int32_t *pDst,
+                  int dataLength)
+{
+   int i = 0;
+   for (; i+8 <= dataLength; i += 8)
+   {
+      _mm256_storeu_si256((__m256i*)(pDst+i),
+                          avx2AddSat32(_mm256_loadu_si256((const __m256i*)(pSrc1+i)),
+                                       _mm256_loadu_si256((const __m256i*)(pSrc2+i))));
+   }
+   _mm256_zeroupper();
+   return MpDspUtils::add_C(pSrc1+i, pSrc2+i, pDst+i, dataLength-i);
+}
+
+static MP_AVX2_FUNC
+OsStatus addMul_I_Avx2(const int16_t *pSrc1, int16_t val, int32_t *pSrc2Dst,
+                       int dataLength)
+{
+   const __m256i vVal = _mm256_set1_epi32(val);
+   int i = 0;
+   for (; i+8 <= dataLength; i += 8)
+   {
+      __m256i *pDst = (__m256i*)(pSrc2Dst+i);
+      _mm256_storeu_si256(pDst,
+                          avx2AddSat32(_mm256_loadu_si256(pDst),
+                                       _mm256_mullo_epi32(avx2Load16(pSrc1+i), vVal)));
+   }
+   _mm256_zeroupper();
+   return MpDspUtils::addMul_I_C(pSrc1+i, val, pSrc2Dst+i, dataLength-i);
+}
+
+static MP_AVX2_FUNC
+OsStatus mul_Avx2(const int16_t *pSrc, const int16_t val, int32_t *pDst,
+                  int dataLength)
+{
+   const __m256i vVal = _mm256_set1_epi32(val);
+   int i = 0;
+   for (; i+8 <= dataLength; i += 8)
+   {
+      _mm256_storeu_si256((__m256i*)(pDst+i),
+                          _mm256_mullo_epi32(avx2Load16(pSrc+i), vVal));
+   }
+   _mm256_zeroupper();
+   return MpDspUtils::mul_C(pSrc+i, val, pDst+i, dataLength-i);
+}
+
+static MP_AVX2_FUNC
+OsStatus convert32to16_Avx2(const int32_t *pSrc, int16_t *pDst, int dataLength)
+{
+   int i = 0;
+   for (; i+16 <= dataLength; i += 16)
+   {
+      _mm256_storeu_si256((__m256i*)(pDst+i),
+                          avx2Pack32(_mm256_loadu_si256((const __m256i*)(pSrc+i)),
+                                     _mm256_loadu_si256((const __m256i*)(pSrc+i+8))));
+   }
+   _mm256_zeroupper();
+   return convert32to16_Sse2(pSrc+i, pDst+i, dataLength-i);
+}
+
+static MP_AVX2_FUNC
+OsStatus convert_Gain32to16_Avx2(const int32_t *pSrc, int16_t *pDst, int dataLength,
+                                 unsigned srcScaleFactor)
+{
+   const __m128i count = _mm_cvtsi32_si128(srcScaleFactor);
+   const int32_t thresold = INT16_MAX>>srcScaleFactor;
+   int i = 0;
+   for (; i+16 <= dataLength; i += 16)
+   {
+      __m256i lo = avx2ShlSat(_mm256_loadu_si256((const __m256i*)(pSrc+i)),
+                              count, thresold, INT16_MAX);
+      __m256i hi = avx2ShlSat(_mm256_loadu_si256((const __m256i*)(pSrc+i+8)),
+                              count, thresold, INT16_MAX);
+      _mm256_storeu_si256((__m256i*)(pDst+i), avx2Pack32(lo, hi));
+   }
+   _mm256_zeroupper();
+   return convert_Gain32to16_Sse2(pSrc+i, pDst+i, dataLength-i, srcScaleFactor);
+}
+
+static MP_AVX2_FUNC
+OsStatus convert_Att32to16_Avx2(const int32_t *pSrc, int16_t *pDst, int dataLength,
+                                unsigned srcScaleFactor)
+{
+   const __m128i count = _mm_cvtsi32_si128(srcScaleFactor);
+   int i = 0;
+   for (; i+16 <= dataLength; i += 16)
+   {
+      __m256i lo = _mm256_sra_epi32(_mm256_loadu_si256((const __m256i*)(pSrc+i)), count);
+      __m256i hi = _mm256_sra_epi32(_mm256_loadu_si256((const __m256i*)(pSrc+i+8)), count);
+      _mm256_storeu_si256((__m256i*)(pDst+i), avx2Pack32(lo, hi));
+   }
+   _mm256_zeroupper();
+   return convert_Att32to16_Sse2(pSrc+i, pDst+i, dataLength-i, srcScaleFactor);
+}
+
+static MP_AVX2_FUNC
+OsStatus convert_Gain16to32_Avx2(const int16_t *pSrc, int32_t *pDst, int dataLength,
+                                 unsigned srcScaleFactor)
+{
+   const __m128i count = _mm_cvtsi32_si128(srcScaleFactor);
+   const int32_t thresold = INT32_MAX>>srcScaleFactor;
+   int i = 0;
+   for (; i+8 <= dataLength; i += 8)
+   {
+      _mm256_storeu_si256((__m256i*)(pDst+i),
+                          avx2ShlSat(avx2Load16(pSrc+i), count, thresold, INT32_MAX));
+   }
+   _mm256_zeroupper();
+   return MpDspUtils::convert_Gain_C(pSrc+i, pDst+i, dataLength-i, srcScaleFactor);
+}
+
+/* ============================ KERNEL TABLES ============================= */
+
+const MpDspUtils::VectorKernels MpDspUtils::smSse2Kernels =
+{
+   add_I_Sse2,
+   add_IGain_Sse2,
+   add_IAtt_Sse2,
+   add_Sse2,
+   addMul_I_Sse2,
+   addMulLinear_I_Sse2,
+   mul_Sse2,
+   mulLinear_Sse2,
+   convert32to16_Sse2,
+   convert_Gain32to16_Sse2,
+   convert_Att32to16_Sse2,
+   convert16to32_Sse2,
+   convert_Gain16to32_Sse2,
+   convert_Att16to32_Sse2
+};
+
+const MpDspUtils::VectorKernels MpDspUtils::smAvx2Kernels =
+{
+   add_I_Avx2,
+   add_IGain_Avx2,
+   add_IAtt_Avx2,
+   add_Avx2,
+   addMul_I_Avx2,
+   addMulLinear_I_Sse2,
+   mul_Avx2,
+   mulLinear_Sse2,
+   convert32to16_Avx2,
+   convert_Gain32to16_Avx2,
+   convert_Att32to16_Avx2,
+   convert16to32_Sse2,
+   convert_Gain16to32_Avx2,
+   convert_Att16to32_Sse2
+};
+
+#endif // MP_DSP_SIMD ]
@@ -27,6 +27,7 @@
 #include "mp/MpFlowGraphBase.h"
 #include "mp/MpFlowGraphMsg.h"
 #include "mp/MpResourceMsg.h"
+#include "mp/MpResourceSet.h"
 #include "mp/MpSyncFlowgraphMsg.h"
 #include "mp/MpResourceSortAlg.h"
 #include "mp/MpMediaTask.h"
@@ -261,6 +262,49 @@ OsStatus MpFlowGraphBase::addResource(MpResource& rResource,
       return OS_UNSPECIFIED;
 }
 
+// Adds the resources of the set and the links recorded in it to the flow
+// graph, all in one go.  The flow graph takes ownership of the set.
+// If the flow graph is not "started", this call takes effect immediately.
+// Otherwise, the call takes effect at the start of the next frame processing
+// interval.
+// Returns OS_SUCCESS if the resources were successfully added.  Otherwise
+// returns OS_UNSPECIFIED.
+OsStatus MpFlowGraphBase::addResourceSet(MpResourceSet* pResourceSet)
+{
+   OsWriteLock    lock(mRWMutex);
+
+   UtlBoolean      handled;
+   MpFlowGraphMsg msg(MpFlowGraphMsg::FLOWGRAPH_ADD_RESOURCE_SET, NULL,
+                      pResourceSet);
+
+   // Set the notification enabled/disabled state of the new resources
+   // as addResource() does.
+   if(numResources() > 0)
+   {
+      UtlBoolean notfState = mUnsorted[0]->areNotificationsEnabled();
+      for (int i = 0; i < pResourceSet->numResources(); i++)
+      {
+         pResourceSet->getResource(i)->setNotificationsEnabled(notfState);
+      }
+   }
+
+   if (mCurState == STARTED)
+   {
+      OsStatus res = postMessage(msg);
+      if (res != OS_SUCCESS)
+      {
+         delete pResourceSet;
+      }
+      return res;
+   }
+
+   handled = handleMessage(msg);
+   if (handled)
+      return OS_SUCCESS;
+   else
+      return OS_UNSPECIFIED;
+}
+
 // Stops the flow graph, removes all of the resources in the flow graph 
 // and destroys them.  If the flow graph is not "started", this call takes
 // effect immediately.  Otherwise, the call takes effect at the start of
@@ -1204,6 +1248,9 @@ UtlBoolean MpFlowGraphBase::handleMessage(OsMsg& rMsg)
    case MpFlowGraphMsg::FLOWGRAPH_ADD_RESOURCE:
       retCode = handleAddResource(ptr1, int1);
       break;
+   case MpFlowGraphMsg::FLOWGRAPH_ADD_RESOURCE_SET:
+      retCode = handleAddResourceSet((MpResourceSet*) pMsg->getPtr1());
+      break;
    case MpFlowGraphMsg::FLOWGRAPH_DESTROY_RESOURCES:
       retCode = handleDestroyResources();
       break;
@@ -1434,6 +1481,69 @@ UtlBoolean MpFlowGraphBase::handleAddResource(MpResource* pResource,
    return TRUE;
 }
 
+// Handle the FLOWGRAPH_ADD_RESOURCE_SET message.
+// Returns TRUE if the message was handled, otherwise FALSE.
+UtlBoolean MpFlowGraphBase::handleAddResourceSet(MpResourceSet* pResourceSet)
+{
+   int         i;
+   int         numSetResources = pResourceSet->numResources();
+   MpResource* pResource;
+   MpResource* pFound;
+
+   // Check what could make handleAddResource() fail first, so that the
+   // set is added either whole or not at all.  The resources of a set which
+   // is not added are destroyed with it.
+   if (mResourceCnt + numSetResources > MAX_FLOWGRAPH_RESOURCES)
+   {
+      assert(FALSE);
+      delete pResourceSet;
+      return FALSE;
+   }
+   for (i = 0; i < numSetResources; i++)
+   {
+      pResource = pResourceSet->getResource(i);
+      if (pResource->getFlowGraph() != NULL ||
+          lookupResourcePrivate(*pResource, pFound) == OS_SUCCESS)
+      {
+         OsSysLog::add(FAC_MP, PRI_ERR,
+                       "MpFlowGraphBase::handleAddResourceSet can not add resource: %s",
+                       pResource->getName().data());
+         assert(FALSE);
+         delete pResourceSet;
+         return FALSE;
+      }
+   }
+
+   for (i = 0; i < numSetResources; i++)
+   {
+      UtlBoolean added = handleAddResource(pResourceSet->getResource(i), FALSE);
+      assert(added);
+   }
+
+   // The links between the resources of the set are already made.
+   mLinkCnt += pResourceSet->numInternalLinks();
+
+   UtlBoolean result = TRUE;
+   for (i = 0; i < pResourceSet->numLinks(); i++)
+   {
+      MpResource* pFrom;
+      MpResource* pTo;
+      int         outPortIdx;
+      int         inPortIdx;
+
+      pResourceSet->getLink(i, pFrom, outPortIdx, pTo, inPortIdx);
+      if (!handleAddLink(pFrom, outPortIdx, pTo, inPortIdx))
+      {
+         result = FALSE;
+      }
+   }
+
+   // The resources belong to the flow graph now, the set is not needed.
+   delete pResourceSet;
+
+   return result;
+}
+
 // Handle the FLOWGRAPH_DESTROY_RESOURCES message.
 // Returns TRUE if the message was handled, otherwise FALSE.
 UtlBoolean MpFlowGraphBase::handleDestroyResources(void)
@@ -500,7 +500,7 @@ void MpJitterBuffer::setPlc(const UtlString &plcName)
       // If (mStreamSampleRate > 0), then we've got first RTP packet
       // and know stream sample rate. In other case PLC will be initialized
       // when first packet will be received.
-      mpPlc->init(mOutputSampleRate);
+      mpPlc->init(mStreamSampleRate);
    }
 }
 
@@ -21,6 +21,10 @@
 #if defined(WIN32) // [ WIN32
 #  include "mp/MpMMTimerWnt.h"
 #  define DEFAULT_TIMER_CLASS MpMMTimerWnt
+#elif defined(__linux__) // ][ Linux
+#  include "mp/MpMMTimerPosix.h"
+#  include "mp/MpMMTimerMonotonic.h"
+#  define DEFAULT_TIMER_CLASS MpMMTimerMonotonic
 #elif defined(__pingtel_on_posix__) // ][ POSIX
 #  include "mp/MpMMTimerPosix.h"
 #  define DEFAULT_TIMER_CLASS MpMMTimerPosix
@@ -47,17 +51,23 @@ MpMMTimer *MpMMTimer::create(MMTimerType type, const UtlString &name)
       return new DEFAULT_TIMER_CLASS(type);
    }
 #ifdef WIN32 // [
-   else if (name.compareTo(MpMMTimerWnt::TYPE, UtlString::ignoreCase))
+   else if (name.compareTo(MpMMTimerWnt::TYPE, UtlString::ignoreCase) == 0)
    {
       return new MpMMTimerWnt(type);
    }
 #endif // WIN32 ]
 #ifdef __pingtel_on_posix__ // [
-   else if (name.compareTo(MpMMTimerPosix::TYPE, UtlString::ignoreCase))
+   else if (name.compareTo(MpMMTimerPosix::TYPE, UtlString::ignoreCase) == 0)
    {
       return new MpMMTimerPosix(type);
    }
 #endif // __pingtel_on_posix__ ]
+#ifdef __linux__ // [
+   else if (name.compareTo(MpMMTimerMonotonic::TYPE, UtlString::ignoreCase) == 0)
+   {
+      return new MpMMTimerMonotonic(type);
+   }
+#endif // __linux__ ]
    return NULL;
 }
 
@@ -0,0 +1,348 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <os/OsIntTypes.h>
+#include <os/OsSysLog.h>
+
+#include <assert.h>
+#include <errno.h>
+#include <signal.h>
+#include <sched.h>
+#include <unistd.h>
+#include <sys/prctl.h>
+
+// APPLICATION INCLUDES
+#include "mp/MpMMTimerMonotonic.h"
+
+// DEFINES
+#define NSECS_PER_SEC  1000000000
+#define NSECS_PER_USEC 1000
+
+// MACROS
+// EXTERNAL FUNCTIONS
+// EXTERNAL VARIABLES
+// CONSTANTS
+// STRUCTS
+// TYPEDEFS
+
+// STATIC VARIABLE INITIALIZATIONS
+const char * const MpMMTimerMonotonic::TYPE = "Monotonic Timer";
+
+/* ============================== FUNCTIONS =============================== */
+
+static int64_t timespecToNsecs(const struct timespec& ts)
+{
+   return (int64_t)ts.tv_sec*NSECS_PER_SEC + ts.tv_nsec;
+}
+
+static struct timespec nsecsToTimespec(int64_t nsecs)
+{
+   struct timespec ts;
+   ts.tv_sec = (time_t)(nsecs / NSECS_PER_SEC);
+   ts.tv_nsec = (long)(nsecs % NSECS_PER_SEC);
+   return ts;
+}
+
+/* //////////////////////////////// PUBLIC //////////////////////////////// */
+
+/* =============================== CREATORS =============================== */
+
+MpMMTimerMonotonic::MpMMTimerMonotonic(MpMMTimer::MMTimerType type)
+: MpMMTimer(type)
+, mpNotification(NULL)
+, mbTimerStarted(FALSE)
+, mPeriodUSecs(0)
+, mCatchUpPolicy(CATCH_UP_BURST)
+, mStatisticsMutex(OsMutex::Q_FIFO)
+{
+   if (mTimerType == Linear)
+   {
+      int res = sem_init(&mSyncSemaphore, 0, 0);
+      assert(res == 0);
+   }
+   mStartTime.tv_sec = 0;
+   mStartTime.tv_nsec = 0;
+   resetStatistics();
+}
+
+MpMMTimerMonotonic::~MpMMTimerMonotonic()
+{
+   if (mbTimerStarted)
+   {
+      stop();
+   }
+   if (mTimerType == Linear)
+   {
+      sem_destroy(&mSyncSemaphore);
+   }
+}
+
+/* ============================= MANIPULATORS ============================= */
+
+OsStatus MpMMTimerMonotonic::setNotification(OsNotification* notification)
+{
+   if (mTimerType != Notification)
+   {
+      return OS_INVALID_STATE;
+   }
+   mpNotification = notification;
+   return OS_SUCCESS;
+}
+
+OsStatus MpMMTimerMonotonic::run(unsigned usecPeriodic)
+{
+   if (mbTimerStarted)
+   {
+      return OS_INVALID_STATE;
+   }
+
+   unsigned minPeriod;
+   if (getResolution(minPeriod) != OS_SUCCESS)
+   {
+      return OS_FAILED;
+   }
+   if (usecPeriodic < minPeriod ||
+       usecPeriodic > MMTIMER_MONOTONIC_MAX_PERIOD_USECS)
+   {
+      OsSysLog::add(FAC_MP, PRI_WARNING,
+                    "MpMMTimerMonotonic::run - unsupported period of %u us",
+                    usecPeriodic);
+      return OS_INVALID_ARGUMENT;
+   }
+
+   mPeriodUSecs = usecPeriodic;
+   resetStatistics();
+   clock_gettime(CLOCK_MONOTONIC, &mStartTime);
+
+   mbTimerStarted = TRUE;
+   int res = pthread_create(&mThread, NULL, threadWrapper, this);
+   if (res != 0)
+   {
+      mbTimerStarted = FALSE;
+      OsSysLog::add(FAC_MP, PRI_ERR,
+                    "MpMMTimerMonotonic::run - couldn't create timer thread: %d",
+                    res);
+      return OS_LIMIT_REACHED;
+   }
+
+   return OS_SUCCESS;
+}
+
+OsStatus MpMMTimerMonotonic::stop()
+{
+   if (!mbTimerStarted)
+   {
+      return OS_INVALID_STATE;
+   }
+
+   // The thread sees the flag at its next deadline, at most a period away.
+   mbTimerStarted = FALSE;
+   pthread_join(mThread, NULL);
+
+   Statistics stats;
+   getStatistics(stats);
+   OsSysLog::add(FAC_MP, PRI_INFO,
+                 "MpMMTimerMonotonic::stop - %u us period: %" PRIu64 " ticks, "
+                 "%" PRIu64 " overruns, %" PRIu64 " skipped, "
+                 "mean lateness %" PRIu64 " us, max %u us",
+                 mPeriodUSecs, stats.mTicks, stats.mOverruns,
+                 stats.mSkippedTicks,
+                 stats.mWakeups ? stats.mTotalLatenessUs/stats.mWakeups : 0,
+                 stats.mMaxLatenessUs);
+
+   return OS_SUCCESS;
+}
+
+OsStatus MpMMTimerMonotonic::waitForNextTick()
+{
+   if (mTimerType != Linear)
+   {
+      return OS_INVALID_STATE;
+   }
+
+   if (mbTimerStarted == FALSE)
+   {
+      OsSysLog::add(FAC_MP, PRI_ERR,
+                    "MpMMTimerMonotonic::waitForNextTick "
+                    "- Timer not started or timer not initialized!");
+      return OS_FAILED;
+   }
+
+   int res;
+   do
+   {
+      res = sem_wait(&mSyncSemaphore);
+   } while (res != 0 && errno == EINTR);
+
+   return (res == 0) ? OS_SUCCESS : OS_FAILED;
+}
+
+void MpMMTimerMonotonic::setCatchUpPolicy(CatchUpPolicy policy)
+{
+   mCatchUpPolicy = policy;
+}
+
+void MpMMTimerMonotonic::resetStatistics()
+{
+   OsLock lock(mStatisticsMutex);
+   mStatistics.mWakeups = 0;
+   mStatistics.mTicks = 0;
+   mStatistics.mOverruns = 0;
+   mStatistics.mSkippedTicks = 0;
+   mStatistics.mTotalLatenessUs = 0;
+   mStatistics.mMaxLatenessUs = 0;
+}
+
+/* ============================== ACCESSORS =============================== */
+
+OsStatus MpMMTimerMonotonic::getResolution(unsigned& resolution)
+{
+   struct timespec ts;
+   int res = clock_getres(CLOCK_MONOTONIC, &ts);
+   if (res != 0)
+     return OS_FAILED;
+
+   resolution = ts.tv_nsec / NSECS_PER_USEC;
+   if (resolution == 0)
+      resolution++;
+
+   return OS_SUCCESS;
+}
+
+OsStatus MpMMTimerMonotonic::getPeriodRange(unsigned* pMinUSecs,
+                                            unsigned* pMaxUSecs)
+{
+   if (pMaxUSecs)
+      *pMaxUSecs = MMTIMER_MONOTONIC_MAX_PERIOD_USECS;
+
+   if (pMinUSecs)
+      return getResolution(*pMinUSecs);
+
+   return OS_SUCCESS;
+}
+
+MpMMTimerMonotonic::CatchUpPolicy MpMMTimerMonotonic::getCatchUpPolicy() const
+{
+   return mCatchUpPolicy;
+}
+
+void MpMMTimerMonotonic::getStatistics(Statistics& rStatistics) const
+{
+   OsLock lock(mStatisticsMutex);
+   rStatistics = mStatistics;
+}
+
+/* =============================== INQUIRY ================================ */
+
+/* ////////////////////////////// PROTECTED /////////////////////////////// */
+
+void MpMMTimerMonotonic::fireTicks(unsigned numTicks)
+{
+   for (unsigned i = 0; i < numTicks; i++)
+   {
+      if (mTimerType == Notification)
+      {
+         OsNotification* pNotification = mpNotification;
+         if (pNotification != NULL)
+         {
+            pNotification->signal((intptr_t)this);
+         }
+      }
+      else
+      {
+         sem_post(&mSyncSemaphore);
+      }
+   }
+}
+
+/* /////////////////////////////// PRIVATE //////////////////////////////// */
+
+void MpMMTimerMonotonic::runThread()
+{
+   const int64_t periodNs = (int64_t)mPeriodUSecs*NSECS_PER_USEC;
+   const int64_t startNs = timespecToNsecs(mStartTime);
+   uint64_t tickNum = 1;
+
+   while (mbTimerStarted)
+   {
+      // The deadline is on the grid of the period from the start time, so
+      // the lateness of a wake-up does not move the following ones.
+      int64_t deadlineNs = startNs + (int64_t)tickNum*periodNs;
+      struct timespec deadline = nsecsToTimespec(deadlineNs);
+      int res = clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &deadline, NULL);
+      if (res == EINTR)
+      {
+         continue;
+      }
+      if (!mbTimerStarted)
+      {
+         break;
+      }
+
+      struct timespec now;
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      int64_t latenessNs = timespecToNsecs(now) - deadlineNs;
+      if (latenessNs < 0)
+      {
+         latenessNs = 0;
+      }
+
+      // Deadlines passed while we slept past this one.
+      uint64_t missed = (uint64_t)(latenessNs / periodNs);
+      uint64_t burst = 0;
+      if (missed > 0 && mCatchUpPolicy == CATCH_UP_BURST)
+      {
+         burst = (missed < MMTIMER_MONOTONIC_MAX_BURST)
+                 ? missed : MMTIMER_MONOTONIC_MAX_BURST;
+      }
+      tickNum += missed + 1;
+
+      {
+         OsLock lock(mStatisticsMutex);
+         unsigned latenessUs = (unsigned)(latenessNs / NSECS_PER_USEC);
+         mStatistics.mWakeups++;
+         mStatistics.mTicks += 1 + burst;
+         mStatistics.mSkippedTicks += missed - burst;
+         if (missed > 0)
+         {
+            mStatistics.mOverruns++;
+         }
+         mStatistics.mTotalLatenessUs += latenessUs;
+         if (latenessUs > mStatistics.mMaxLatenessUs)
+         {
+            mStatistics.mMaxLatenessUs = latenessUs;
+         }
+      }
+
+      fireTicks((unsigned)(1 + burst));
+   }
+}
+
+void* MpMMTimerMonotonic::threadWrapper(void* arg)
+{
+   MpMMTimerMonotonic* obj = (MpMMTimerMonotonic*)arg;
+
+   // Signals for the process are none of this thread's business.
+   sigset_t fmask;
+   sigfillset(&fmask);
+   pthread_sigmask(SIG_SETMASK, &fmask, NULL);
+
+   // Wake up as close to the deadline as the kernel can.  Real-time threads
+   // get no slack anyway.
+   prctl(PR_SET_TIMERSLACK, 1, 0, 0, 0);
+
+   struct sched_param realtime;
+   if (geteuid() == 0)
+   {
+       realtime.sched_priority = sched_get_priority_max(SCHED_FIFO);
+       pthread_setschedparam(pthread_self(), SCHED_FIFO, &realtime);
+   }
+
+   obj->runThread();
+   return NULL;
+}
@@ -84,6 +84,9 @@ MpMMTimerPosix::~MpMMTimerPosix()
 #ifndef ANDROID // [
    // Under Android this leads to hang. Not sure why.
    // Maybe not anymore with checkins on 20180130 to clean up the teardown of this object
+   // The thread sits in sigwait() and the timer may be stopped already,
+   // so send it the signal to see mbTerminate.
+   pthread_kill(mThread, gPosixTimerReg.getSignalNum());
    pthread_join(mThread, NULL);
 #endif // ANDROID ]
    if (mTimerType == Linear)
@@ -67,6 +67,80 @@ int sSignalStartsQueued = 0;
    static unsigned long long sMaxTicks;
 #endif /* _PROFILE ] */
 
+/**
+*  @brief Task processing flow graphs in parallel with the media task.
+*
+*  The media task releases the start semaphore of every worker at the
+*  beginning of frame processing.  The worker then takes flow graphs with
+*  MpMediaTask::processFlowGraphs() like the media task does, and releases
+*  MpMediaTask::mWorkersDoneSem when there are none left.
+*/
+class MpMediaTaskWorker : public OsTask
+{
+public:
+   MpMediaTaskWorker(MpMediaTask* pMediaTask);
+   ~MpMediaTaskWorker();
+
+     /// Do the task.
+   virtual int run(void* pArg);
+
+     /// Let the worker process the current frame.
+   inline void startFrame();
+
+     /// Ask the worker to exit and wait until it has.
+   void stop();
+
+private:
+   MpMediaTask* mpMediaTask;
+   OsBSem       mStartSem;
+};
+
+MpMediaTaskWorker::MpMediaTaskWorker(MpMediaTask* pMediaTask)
+: OsTask("MpMediaWorker-%d", NULL, MpMediaTask::MEDIA_TASK_PRIORITY)
+, mpMediaTask(pMediaTask)
+, mStartSem(OsBSem::Q_PRIORITY, OsBSem::EMPTY)
+{
+}
+
+MpMediaTaskWorker::~MpMediaTaskWorker()
+{
+   stop();
+}
+
+int MpMediaTaskWorker::run(void*)
+{
+   for (;;)
+   {
+      mStartSem.acquire();
+      if (isShuttingDown())
+      {
+         break;
+      }
+
+      mpMediaTask->processFlowGraphs();
+      mpMediaTask->mWorkersDoneSem.release();
+   }
+
+   return 0;
+}
+
+void MpMediaTaskWorker::startFrame()
+{
+   mStartSem.release();
+}
+
+void MpMediaTaskWorker::stop()
+{
+   if (isStarted())
+   {
+      requestShutdown();
+      mStartSem.release();
+   }
+   // The worker exits as soon as it wakes up, so poll for it often to keep
+   // the media task from stalling (the default polls every 100ms).
+   waitUntilShutDown(1000);
+}
+
 /* //////////////////////////// PUBLIC //////////////////////////////////// */
 
 /* ============================ CREATORS ================================== */
@@ -112,7 +186,11 @@ MpMediaTask::~MpMediaTask()
    // $$$ need to figure out how to cleanly shut down this task after
    // $$$ unmanaging and destroying all of its flow graphs
 
+   handleSetWorkerThreads(1);
+
    delete[] mManagedFGs;
+   delete[] mpLastUsecs;
+   delete[] mpMaxUsecs;
 
    if (mpBufferMsgPool != NULL)
       delete mpBufferMsgPool;
@@ -292,6 +370,34 @@ OsStatus MpMediaTask::signalFrameStart(const OsTime &timeout)
    return ret;
 }
 
+// Sets the number of threads that process the managed flow graphs each
+// frame.  The new number of threads will take effect at the beginning of
+// the next frame interval.
+OsStatus MpMediaTask::setWorkerThreads(int numThreads)
+{
+   if (numThreads < 1 || numThreads > MAX_WORKER_THREADS)
+   {
+      return OS_INVALID_ARGUMENT;
+   }
+#ifndef MPBUF_REF_ATOMIC // [
+   // Flow graphs share buffers (e.g. MpMisc.mpFgSilence), which threads
+   // could not release safely.
+   if (numThreads > 1)
+   {
+      return OS_NOT_SUPPORTED;
+   }
+#endif // MPBUF_REF_ATOMIC ]
+
+   MpMediaTaskMsg msg(MpMediaTaskMsg::SET_WORKER_THREADS, NULL, NULL,
+                      numThreads);
+   OsStatus       res;
+
+   res = postMessage(msg, smOperationQueueTimeout);
+   assert(res == OS_SUCCESS);
+
+   return OS_SUCCESS;
+}
+
 // Directs the media processing task to start the specified flow 
 // graph.  A flow graph must be started in order for it to process 
 // the media stream.
@@ -408,6 +514,34 @@ int MpMediaTask::getLimitExceededCnt(void) const
    return mTimeLimitCnt;
 }
 
+// Returns the number of frames that completed more than the time limit
+// after their "frame start" signal.
+int MpMediaTask::getDeadlineMissCnt(void) const
+{
+   return mDeadlineMissCnt;
+}
+
+// Returns the time (in microseconds) the given flow graph took to process
+// its last frame, and the longest time it has taken so far.
+OsStatus MpMediaTask::getFlowGraphProcessingTime(MpFlowGraphBase* pFlowGraph,
+                                                 int& lastUsecs, int& maxUsecs)
+{
+   int    i;
+   OsLock lock(mMutex);
+
+   for (i=0; i < mManagedCnt; i++)
+   {
+      if (mManagedFGs[i] == pFlowGraph)
+      {
+         lastUsecs = mpLastUsecs[i];
+         maxUsecs = mpMaxUsecs[i];
+         return OS_SUCCESS;
+      }
+   }
+
+   return OS_NOT_FOUND;
+}
+
 // Returns an array of MpFlowGraphBase pointers that are presently managed 
 // by the media processing task.
 // The caller is responsible for allocating the flowGraphs array
@@ -453,6 +587,13 @@ int MpMediaTask::getWaitTimeoutCnt(void) const
    return mSemTimeoutCnt;
 }
 
+// Returns the number of threads that process the managed flow graphs
+// each frame.
+int MpMediaTask::getWorkerThreads(void) const
+{
+   return mNumThreads;
+}
+
 // (static) Displays information on the console about the media processing
 // task.
 MpFlowGraphBase* MpMediaTask::mediaInfo(void)
@@ -567,6 +708,7 @@ MpMediaTask::MpMediaTask(int maxFlowGraph, UtlBoolean enableLocalAudio)
 , mMutex(OsMutex::Q_PRIORITY)  // create mutex for protecting data
 , mDebugEnabled(FALSE)
 , mTimeLimitCnt(0)
+, mDeadlineMissCnt(0)
 , mProcessedCnt(0)
 , mManagedCnt(0)
 , mStartedCnt(0)
@@ -574,6 +716,13 @@ MpMediaTask::MpMediaTask(int maxFlowGraph, UtlBoolean enableLocalAudio)
 , mSemTimeoutCnt(0)
 , mWaitForSignal(TRUE)
 , mpFocus(NULL)
+, mManagedFGs(NULL)
+, mpLastUsecs(NULL)
+, mpMaxUsecs(NULL)
+, mNumThreads(1)
+, mpWorkers(NULL)
+, mWorkersDoneSem(OsCSem::Q_PRIORITY, MAX_WORKER_THREADS, 0)
+, mNextFGIndex(0)
 , mHandleMsgErrs(0)
 , mpBufferMsgPool(NULL)
 //, numQueuedMsgs(0)
@@ -601,11 +750,15 @@ MpMediaTask::MpMediaTask(int maxFlowGraph, UtlBoolean enableLocalAudio)
    if (mMaxFlowGraph > 0)
    {
       mManagedFGs = new MpFlowGraphBase*[mMaxFlowGraph];
+      mpLastUsecs = new int[mMaxFlowGraph];
+      mpMaxUsecs = new int[mMaxFlowGraph];
       if (mManagedFGs)
       {
          for (i=0; i < mMaxFlowGraph; i++)
          {
             mManagedFGs[i] = NULL;
+            mpLastUsecs[i] = 0;
+            mpMaxUsecs[i] = 0;
          }
       }
    }
@@ -724,6 +877,10 @@ UtlBoolean MpMediaTask::handleMessage(OsMsg& rMsg)
       if (!handleWaitForSignal(pMsg))
          mHandleMsgErrs++;
       break;
+   case MpMediaTaskMsg::SET_WORKER_THREADS:
+      if (!handleSetWorkerThreads(pMsg->getInt1()))
+         mHandleMsgErrs++;
+      break;
    default:
       handled = FALSE; // we didn't handle the message after all
       break;
@@ -763,6 +920,8 @@ UtlBoolean MpMediaTask::handleManage(MpFlowGraphBase* pFlowGraph)
 
    // PRINTF("MpMediaTask::handleManage: Adding flow graph # %d!\n", mManagedCnt, 0,0,0,0,0);
    mManagedFGs[mManagedCnt] = pFlowGraph;
+   mpLastUsecs[mManagedCnt] = 0;
+   mpMaxUsecs[mManagedCnt] = 0;
    mManagedCnt++;
 
    return TRUE;
@@ -885,6 +1044,8 @@ UtlBoolean MpMediaTask::handleUnmanage(MpFlowGraphBase* pFlowGraph)
       if (found)
       {                           // compact the managed flow graphs array
          mManagedFGs[i-1] = mManagedFGs[i];
+         mpLastUsecs[i-1] = mpLastUsecs[i];
+         mpMaxUsecs[i-1] = mpMaxUsecs[i];
       }
 
       if (mManagedFGs[i] == pFlowGraph)
@@ -912,7 +1073,6 @@ UtlBoolean MpMediaTask::handleWaitForSignal(MpMediaTaskMsg* pMsg)
    OsDateTime::getCurTime(startTime);
    OsTime signaledTime(pMsg->getInt1(), pMsg->getInt2());
    int              i;
-   MpFlowGraphBase* pFlowGraph;
    OsStatus         res;
 
 #ifdef MEDIA_VERBOSE /* [ */
@@ -965,23 +1125,31 @@ UtlBoolean MpMediaTask::handleWaitForSignal(MpMediaTaskMsg* pMsg)
          mManagedCnt);
 #endif
 
-   // Call processNextFrame() for each of the "started" flow graphs
-   for (i=0; i < mManagedCnt; i++)
+   // Call processNextFrame() for each of the "started" flow graphs, sharing
+   // them out among the worker tasks if there are any.
+   mNextFGIndex = 0;
+   for (i=0; i < mNumThreads-1; i++)
    {
-#ifdef TEST_PRINT
-      OsSysLog::add(FAC_MP, PRI_DEBUG,
-         "MpMediaTask::handleWaitForSignal about to processNextFrame on flowgraph: %d",
-         i);
-#endif
-      RTL_EVENT("MpMediaTask::handleWaitForSignal", i+1);
-      pFlowGraph = mManagedFGs[i];
-      if (pFlowGraph->isStarted())
+      mpWorkers[i]->startFrame();
+   }
+   processFlowGraphs();
+   for (i=0; i < mNumThreads-1; i++)
+   {
+      res = mWorkersDoneSem.acquire();
+      assert(res == OS_SUCCESS);
+   }
+   RTL_EVENT("MpMediaTask::handleWaitForSignal", 0);
+
+   if (!mDebugEnabled)
+   {
+      OsTime frameEndTime;
+      OsDateTime::getCurTime(frameEndTime);
+      OsTime sinceSignal = frameEndTime - signaledTime;
+      if (sinceSignal.seconds() > 0 || sinceSignal.usecs() > mLimitUsecs)
       {
-         res = pFlowGraph->processNextFrame();
-         assert(res == OS_SUCCESS);
+         mDeadlineMissCnt++;
       }
    }
-   RTL_EVENT("MpMediaTask::handleWaitForSignal", 0);
 #ifdef TEST_PRINT
       OsSysLog::add(FAC_MP, PRI_DEBUG,
          "MpMediaTask::handleWaitForSignal done with all flowgraphs");
@@ -1090,6 +1258,76 @@ UtlBoolean MpMediaTask::handleWaitForSignal(MpMediaTaskMsg* pMsg)
    return TRUE;
 }
 
+// Handles the SET_WORKER_THREADS message.
+// Returns TRUE if the message was handled, otherwise FALSE.
+UtlBoolean MpMediaTask::handleSetWorkerThreads(int numThreads)
+{
+   int i;
+
+   if (numThreads < 1 || numThreads > MAX_WORKER_THREADS)
+      return FALSE;
+
+   if (numThreads == mNumThreads)
+      return TRUE;
+
+   // Workers are idle between frames, so the pool can simply be replaced.
+   for (i=0; i < mNumThreads-1; i++)
+   {
+      delete mpWorkers[i];
+   }
+   delete[] mpWorkers;
+   mpWorkers = NULL;
+
+   if (numThreads > 1)
+   {
+      mpWorkers = new MpMediaTaskWorker*[numThreads-1];
+      for (i=0; i < numThreads-1; i++)
+      {
+         mpWorkers[i] = new MpMediaTaskWorker(this);
+         UtlBoolean isStarted = mpWorkers[i]->start();
+         assert(isStarted);
+      }
+   }
+   mNumThreads = numThreads;
+
+   return TRUE;
+}
+
+// Process flow graphs of the current frame until none are left.
+void MpMediaTask::processFlowGraphs()
+{
+   int i;
+
+   while ((i = mNextFGIndex.fetch_add(1)) < mManagedCnt)
+   {
+#ifdef TEST_PRINT
+      OsSysLog::add(FAC_MP, PRI_DEBUG,
+         "MpMediaTask::processFlowGraphs about to processNextFrame on flowgraph: %d",
+         i);
+#endif
+      RTL_EVENT("MpMediaTask::handleWaitForSignal", i+1);
+      MpFlowGraphBase* pFlowGraph = mManagedFGs[i];
+      if (pFlowGraph->isStarted())
+      {
+         OsTime startTime;
+         OsTime endTime;
+         OsDateTime::getCurTime(startTime);
+
+         OsStatus res = pFlowGraph->processNextFrame();
+         assert(res == OS_SUCCESS);
+
+         OsDateTime::getCurTime(endTime);
+         OsTime processTime = endTime - startTime;
+         int usecs = processTime.seconds() * 1000000 + processTime.usecs();
+         mpLastUsecs[i] = usecs;
+         if (usecs > mpMaxUsecs[i])
+         {
+            mpMaxUsecs[i] = usecs;
+         }
+      }
+   }
+}
+
 // Returns TRUE if the indicated flow graph is presently being managed 
 // by the media processing task, otherwise FALSE.
 UtlBoolean MpMediaTask::isManagedFlowGraph(MpFlowGraphBase* pFlowGraph)
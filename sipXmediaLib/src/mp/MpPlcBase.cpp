@@ -14,6 +14,7 @@
 // APPLICATION INCLUDES
 #include "mp/MpPlcBase.h"
 #include "mp/MpPlcSilence.h"
+#include "mp/MpPlcPitch.h"
 #include <os/OsSysLog.h>
 
 // EXTERNAL FUNCTIONS
@@ -38,6 +39,10 @@ MpPlcBase *MpPlcBase::createPlc(const UtlString &name)
    {
       return new MpPlcSilence();
    } 
+   else if (algName == MpPlcPitch::name)
+   {
+      return new MpPlcPitch();
+   }
    else
    {
 #ifdef EXTERNAL_PLC // [
@@ -0,0 +1,490 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <string.h>
+#include <math.h>
+
+// APPLICATION INCLUDES
+#include "mp/MpPlcPitch.h"
+#include "mp/MpDspUtils.h"
+
+// DEFINES
+// The constants of G.711 Appendix I, at 8 kHz.
+#define PITCH_MIN_8K        40    ///< 200 Hz
+#define PITCH_MAX_8K        120   ///< 66.6 Hz
+#define CORR_LEN_8K         160   ///< 20 ms
+#define CORR_MIN_POWER_8K   250.0f
+#define OVERLAP_INCR_8K     32    ///< 4 ms
+#define PITCH_DECIMATION    2     ///< Lag step of the coarse pitch search.
+#define ATTENUATION_FACTOR  0.2f  ///< Attenuation per 10 ms of loss.
+#define BLOCKS_TO_SILENCE   6     ///< Lost blocks before silence (60 ms).
+
+// MACROS
+// EXTERNAL FUNCTIONS
+// EXTERNAL VARIABLES
+// CONSTANTS
+// STATIC VARIABLE INITIALIZATIONS
+const char *MpPlcPitch::name = "Pitch waveform substitution";
+
+/* ============================== FUNCTIONS =============================== */
+
+static inline MpAudioSample clipSample(float sample)
+{
+   if (sample > INT16_MAX)
+   {
+      return INT16_MAX;
+   }
+   if (sample < INT16_MIN)
+   {
+      return INT16_MIN;
+   }
+   return (MpAudioSample)sample;
+}
+
+/// Cross-fade from \p pLeft to \p pRight into \p pOut.
+static void overlapAdd(const float* pLeft, const float* pRight, float* pOut,
+                       int count)
+{
+   float incr = 1.0f / count;
+   float leftWeight = 1.0f - incr;
+   float rightWeight = incr;
+   for (int i = 0; i < count; i++)
+   {
+      pOut[i] = leftWeight*pLeft[i] + rightWeight*pRight[i];
+      leftWeight -= incr;
+      rightWeight += incr;
+   }
+}
+
+/// Cross-fade from \p pLeft to \p pRight into \p pOut.
+static void overlapAdd(const MpAudioSample* pLeft, const MpAudioSample* pRight,
+                       MpAudioSample* pOut, int count)
+{
+   float incr = 1.0f / count;
+   float leftWeight = 1.0f - incr;
+   float rightWeight = incr;
+   for (int i = 0; i < count; i++)
+   {
+      pOut[i] = clipSample(leftWeight*pLeft[i] + rightWeight*pRight[i]);
+      leftWeight -= incr;
+      rightWeight += incr;
+   }
+}
+
+/* //////////////////////////// PUBLIC //////////////////////////////////// */
+
+/* ============================ CREATORS ================================== */
+
+MpPlcPitch::MpPlcPitch()
+: mSamplesPerSec(0)
+, mBlockSize(0)
+, mPitchMin(0)
+, mPitchMax(0)
+, mOverlapMax(0)
+, mHistoryLen(0)
+, mCorrLen(0)
+, mOverlapIncr(0)
+, mCorrMinPower(0.0f)
+, mpHistory(NULL)
+, mpPitchBuf(NULL)
+, mpLastQ(NULL)
+, mpOverlapBuf(NULL)
+, mEraseCount(0)
+, mPitch(0)
+, mPitchOverlap(0)
+, mPitchBufLen(0)
+, mPitchOffset(0)
+, mLastSpeechType(MP_SPEECH_UNKNOWN)
+{
+}
+
+OsStatus MpPlcPitch::init(int samplesPerSec)
+{
+   if (samplesPerSec < 8000)
+   {
+      return OS_INVALID_ARGUMENT;
+   }
+
+   if (samplesPerSec != mSamplesPerSec)
+   {
+      freeBuffers();
+
+      mSamplesPerSec = samplesPerSec;
+      mBlockSize = samplesPerSec / 100;
+      mPitchMin = PITCH_MIN_8K*samplesPerSec/8000;
+      mPitchMax = PITCH_MAX_8K*samplesPerSec/8000;
+      mOverlapMax = mPitchMax/4;
+      // Room for three periods and the overlap before them.
+      mHistoryLen = 3*mPitchMax + mOverlapMax;
+      mCorrLen = CORR_LEN_8K*samplesPerSec/8000;
+      mOverlapIncr = OVERLAP_INCR_8K*samplesPerSec/8000;
+      mCorrMinPower = CORR_MIN_POWER_8K*samplesPerSec/8000;
+
+      mpHistory = new MpAudioSample[mHistoryLen];
+      mpPitchBuf = new float[mHistoryLen];
+      mpLastQ = new float[mOverlapMax];
+      mpOverlapBuf = new MpAudioSample[sipx_max(mBlockSize, mOverlapMax)];
+   }
+
+   fullReset();
+   return OS_SUCCESS;
+}
+
+MpPlcPitch::~MpPlcPitch()
+{
+   freeBuffers();
+}
+
+void MpPlcPitch::reset()
+{
+   mEraseCount = 0;
+}
+
+void MpPlcPitch::fullReset()
+{
+   if (mpHistory != NULL)
+   {
+      memset(mpHistory, 0, mHistoryLen*sizeof(MpAudioSample));
+   }
+   mEraseCount = 0;
+   mPitch = 0;
+   mPitchOverlap = 0;
+   mPitchBufLen = 0;
+   mPitchOffset = 0;
+   mLastSpeechType = MP_SPEECH_UNKNOWN;
+}
+
+/* ============================ MANIPULATORS ============================== */
+
+OsStatus MpPlcPitch::insertToHistory(int frameNum,
+                                     const MpSpeechParams &speechParams,
+                                     MpAudioSample* pBuf,
+                                     unsigned inSamplesNum)
+{
+   return OS_NOT_SUPPORTED;
+}
+
+OsStatus MpPlcPitch::processFrame(MpSpeechParams &speechParams,
+                                  MpAudioSample* pBuf,
+                                  unsigned bufferSize,
+                                  unsigned inSamplesNum,
+                                  unsigned outSamplesNum,
+                                  int wantedAdjustment,
+                                  int &madeAdjustment)
+{
+   unsigned wantedOutSamplesNum = sipx_min(outSamplesNum, bufferSize);
+   madeAdjustment = wantedOutSamplesNum - outSamplesNum;
+
+   if (mpHistory == NULL)
+   {
+      // Not initialized yet, nothing to conceal with.
+      if (inSamplesNum < wantedOutSamplesNum)
+      {
+         memset(pBuf+inSamplesNum, 0,
+                (wantedOutSamplesNum-inSamplesNum)*sizeof(MpAudioSample));
+      }
+      return OS_INVALID_STATE;
+   }
+
+   if (inSamplesNum > 0)
+   {
+      mLastSpeechType = speechParams.mSpeechType;
+      unsigned samplesNum = sipx_min(inSamplesNum, bufferSize);
+      for (unsigned pos = 0; pos < samplesNum; pos += mBlockSize)
+      {
+         addToHistory(pBuf+pos, sipx_min(mBlockSize, (int)(samplesNum-pos)));
+      }
+
+      // Conceal the end of a frame shorter than asked for.
+      for (unsigned pos = samplesNum; pos < wantedOutSamplesNum; pos += mBlockSize)
+      {
+         concealBlock(pBuf+pos, sipx_min(mBlockSize, (int)(wantedOutSamplesNum-pos)));
+      }
+      return OS_SUCCESS;
+   }
+
+   // This is pure PLC, i.e. frame is entirely lost.
+   for (unsigned pos = 0; pos < wantedOutSamplesNum; pos += mBlockSize)
+   {
+      concealBlock(pBuf+pos, sipx_min(mBlockSize, (int)(wantedOutSamplesNum-pos)));
+   }
+
+   MpAudioSample amplitude = (MpAudioSample)
+      sipx_min(MpDspUtils::maxAbs(pBuf, wantedOutSamplesNum), INT16_MAX);
+   speechParams.mAmplitude = amplitude;
+   speechParams.mIsClipped = FALSE;
+   if (amplitude == 0)
+   {
+      speechParams.mSpeechType = MP_SPEECH_SILENT;
+      speechParams.mFrameEnergy = 0;
+   }
+   else
+   {
+      // The synthetic signal continues the last one received.
+      speechParams.mSpeechType = mLastSpeechType;
+      speechParams.mFrameEnergy = -1;
+   }
+
+   return OS_SUCCESS;
+}
+
+/* ============================ ACCESSORS ================================= */
+
+int MpPlcPitch::getMaxDelayedFramesNum() const
+{
+   return 0;
+}
+
+int MpPlcPitch::getMaxFutureFramesNum() const
+{
+   return 0;
+}
+
+int MpPlcPitch::getAlgorithmicDelay() const
+{
+   return mOverlapMax;
+}
+
+/* ============================ INQUIRY =================================== */
+
+/* //////////////////////////// PROTECTED ///////////////////////////////// */
+
+/* //////////////////////////// PRIVATE /////////////////////////////////// */
+
+void MpPlcPitch::freeBuffers()
+{
+   delete[] mpHistory;
+   mpHistory = NULL;
+   delete[] mpPitchBuf;
+   mpPitchBuf = NULL;
+   delete[] mpLastQ;
+   mpLastQ = NULL;
+   delete[] mpOverlapBuf;
+   mpOverlapBuf = NULL;
+   mSamplesPerSec = 0;
+}
+
+void MpPlcPitch::concealBlock(MpAudioSample* pOut, int numSamples)
+{
+   float* pPitchBufEnd = mpPitchBuf + mHistoryLen;
+
+   if (mEraseCount == 0)
+   {
+      // First lost block: find the pitch period in the history.
+      for (int i = 0; i < mHistoryLen; i++)
+      {
+         mpPitchBuf[i] = mpHistory[i];
+      }
+      mPitch = findPitch();
+      mPitchOverlap = mPitch >> 2;
+
+      // Keep the last quarter period as it is, and cross-fade it with the
+      // period before, so the end of the period repeated runs smoothly
+      // into its start.
+      memcpy(mpLastQ, pPitchBufEnd - mPitchOverlap,
+             mPitchOverlap*sizeof(float));
+      mPitchOffset = 0;
+      mPitchBufLen = mPitch;
+      overlapAdd(mpLastQ, pPitchBufEnd - mPitchBufLen - mPitchOverlap,
+                 pPitchBufEnd - mPitchOverlap, mPitchOverlap);
+
+      // The output is delayed by more than the overlap, so the end of the
+      // history is not played yet and gets the same cross-fade.
+      for (int i = 0; i < mPitchOverlap; i++)
+      {
+         mpHistory[mHistoryLen-mPitchOverlap+i] =
+            clipSample(pPitchBufEnd[i-mPitchOverlap]);
+      }
+
+      getSynthetic(pOut, numSamples);
+   }
+   else if (mEraseCount == 1 || mEraseCount == 2)
+   {
+      // Repeat one more period back, not to sound tonal, cross-fading from
+      // the periods repeated so far.
+      int saveOffset = mPitchOffset;
+      getSynthetic(mpOverlapBuf, mPitchOverlap);
+      mPitchOffset = saveOffset;
+      while (mPitchOffset > mPitch)
+      {
+         mPitchOffset -= mPitch;
+      }
+      mPitchBufLen += mPitch;
+      overlapAdd(mpLastQ, pPitchBufEnd - mPitchBufLen - mPitchOverlap,
+                 pPitchBufEnd - mPitchOverlap, mPitchOverlap);
+
+      getSynthetic(pOut, numSamples);
+      overlapAdd(mpOverlapBuf, pOut, pOut,
+                 sipx_min(mPitchOverlap, numSamples));
+      scaleSpeech(pOut, numSamples);
+   }
+   else if (mEraseCount < BLOCKS_TO_SILENCE)
+   {
+      getSynthetic(pOut, numSamples);
+      scaleSpeech(pOut, numSamples);
+   }
+   else
+   {
+      memset(pOut, 0, numSamples*sizeof(MpAudioSample));
+   }
+
+   mEraseCount++;
+   saveSpeech(pOut, numSamples);
+}
+
+void MpPlcPitch::addToHistory(MpAudioSample* pBuf, int numSamples)
+{
+   if (mEraseCount > 0)
+   {
+      // Fade from the synthetic signal into the real one.  Longer losses
+      // get longer fades.
+      int overlapLen = mPitchOverlap + (mEraseCount - 1)*mOverlapIncr;
+      overlapLen = sipx_min(overlapLen, numSamples);
+      getSynthetic(mpOverlapBuf, overlapLen);
+
+      float incr = 1.0f / overlapLen;
+      float gain = 1.0f - (mEraseCount - 1)*ATTENUATION_FACTOR;
+      if (gain < 0.0f)
+      {
+         gain = 0.0f;
+      }
+      float gainIncr = incr*gain;
+      float leftWeight = (1.0f - incr)*gain;
+      float rightWeight = incr;
+      for (int i = 0; i < overlapLen; i++)
+      {
+         pBuf[i] = clipSample(leftWeight*mpOverlapBuf[i] + rightWeight*pBuf[i]);
+         leftWeight -= gainIncr;
+         rightWeight += incr;
+      }
+
+      mEraseCount = 0;
+   }
+
+   saveSpeech(pBuf, numSamples);
+}
+
+void MpPlcPitch::saveSpeech(MpAudioSample* pBuf, int numSamples)
+{
+   memmove(mpHistory, mpHistory + numSamples,
+           (mHistoryLen - numSamples)*sizeof(MpAudioSample));
+   memcpy(mpHistory + mHistoryLen - numSamples, pBuf,
+          numSamples*sizeof(MpAudioSample));
+   memcpy(pBuf, mpHistory + mHistoryLen - numSamples - mOverlapMax,
+          numSamples*sizeof(MpAudioSample));
+}
+
+void MpPlcPitch::getSynthetic(MpAudioSample* pOut, int numSamples)
+{
+   const float* pStart = mpPitchBuf + mHistoryLen - mPitchBufLen;
+   while (numSamples > 0)
+   {
+      int count = sipx_min(mPitchBufLen - mPitchOffset, numSamples);
+      for (int i = 0; i < count; i++)
+      {
+         pOut[i] = (MpAudioSample)pStart[mPitchOffset + i];
+      }
+      mPitchOffset += count;
+      if (mPitchOffset == mPitchBufLen)
+      {
+         mPitchOffset = 0;
+      }
+      pOut += count;
+      numSamples -= count;
+   }
+}
+
+void MpPlcPitch::scaleSpeech(MpAudioSample* pOut, int numSamples)
+{
+   float gain = 1.0f - (mEraseCount - 1)*ATTENUATION_FACTOR;
+   float gainDecr = ATTENUATION_FACTOR / mBlockSize;
+   for (int i = 0; i < numSamples; i++)
+   {
+      pOut[i] = (MpAudioSample)(pOut[i]*gain);
+      gain -= gainDecr;
+   }
+}
+
+int MpPlcPitch::findPitch()
+{
+   const int pitchDiff = mPitchMax - mPitchMin;
+   // The end of the history is matched against the lags before it.
+   const float* pLeft = mpPitchBuf + mHistoryLen - mCorrLen;
+   const float* pRight = pLeft - mPitchMax;
+   const float* pLag;
+   float energy;
+   float corr;
+   float bestCorr;
+   int bestMatch;
+   int i;
+   int j;
+
+   // Coarse search, over every other sample and every other lag.
+   pLag = pRight;
+   energy = 0.0f;
+   corr = 0.0f;
+   for (i = 0; i < mCorrLen; i += PITCH_DECIMATION)
+   {
+      energy += pLag[i]*pLag[i];
+      corr += pLag[i]*pLeft[i];
+   }
+   bestCorr = corr / sqrtf(sipx_max(energy, mCorrMinPower));
+   bestMatch = 0;
+   for (j = PITCH_DECIMATION; j <= pitchDiff; j += PITCH_DECIMATION)
+   {
+      energy -= pLag[0]*pLag[0];
+      energy += pLag[mCorrLen]*pLag[mCorrLen];
+      pLag += PITCH_DECIMATION;
+      corr = 0.0f;
+      for (i = 0; i < mCorrLen; i += PITCH_DECIMATION)
+      {
+         corr += pLag[i]*pLeft[i];
+      }
+      corr /= sqrtf(sipx_max(energy, mCorrMinPower));
+      if (corr >= bestCorr)
+      {
+         bestCorr = corr;
+         bestMatch = j;
+      }
+   }
+
+   // Fine search around the coarse match.
+   j = sipx_max(bestMatch - (PITCH_DECIMATION - 1), 0);
+   int lastLag = sipx_min(bestMatch + (PITCH_DECIMATION - 1), pitchDiff);
+   pLag = pRight + j;
+   energy = 0.0f;
+   corr = 0.0f;
+   for (i = 0; i < mCorrLen; i++)
+   {
+      energy += pLag[i]*pLag[i];
+      corr += pLag[i]*pLeft[i];
+   }
+   bestCorr = corr / sqrtf(sipx_max(energy, mCorrMinPower));
+   bestMatch = j;
+   for (j++; j <= lastLag; j++)
+   {
+      energy -= pLag[0]*pLag[0];
+      energy += pLag[mCorrLen]*pLag[mCorrLen];
+      pLag++;
+      corr = 0.0f;
+      for (i = 0; i < mCorrLen; i++)
+      {
+         corr += pLag[i]*pLeft[i];
+      }
+      corr /= sqrtf(sipx_max(energy, mCorrMinPower));
+      if (corr > bestCorr)
+      {
+         bestCorr = corr;
+         bestMatch = j;
+      }
+   }
+
+   return mPitchMax - bestMatch;
+}
+
+/* ============================ FUNCTIONS ================================= */
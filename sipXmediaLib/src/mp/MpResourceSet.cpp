@@ -0,0 +1,163 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <assert.h>
+
+// APPLICATION INCLUDES
+#include "mp/MpResourceSet.h"
+#include "mp/MpResourceTopology.h"
+
+// EXTERNAL FUNCTIONS
+// EXTERNAL VARIABLES
+// CONSTANTS
+// STATIC VARIABLE INITIALIZATIONS
+
+/* //////////////////////////// PUBLIC //////////////////////////////////// */
+
+/* ============================ CREATORS ================================== */
+
+MpResourceSet::MpResourceSet()
+: mNumResources(0)
+, mNumInternalLinks(0)
+, mNumLinks(0)
+{
+}
+
+MpResourceSet::~MpResourceSet()
+{
+   // The bag does not own the resources.
+   mResourceBag.removeAll();
+
+   // Resources added to a flowgraph belong to it now.  The links between
+   // the others do not matter, as they are all destroyed together.
+   for (int i = 0; i < mNumResources; i++)
+   {
+      if (mpResources[i]->getFlowGraph() == NULL)
+      {
+         delete mpResources[i];
+      }
+      mpResources[i] = NULL;
+   }
+}
+
+/* ============================ MANIPULATORS ============================== */
+
+OsStatus MpResourceSet::addResource(MpResource& rResource)
+{
+   if (rResource.getFlowGraph() != NULL)
+   {
+      return OS_INVALID_ARGUMENT;
+   }
+   if (mNumResources >= MAX_RESOURCES)
+   {
+      return OS_LIMIT_REACHED;
+   }
+
+   mpResources[mNumResources++] = &rResource;
+   mResourceBag.insert(&rResource);
+
+   return OS_SUCCESS;
+}
+
+OsStatus MpResourceSet::linkResources(MpResource& rFrom, int outPortIdx,
+                                      MpResource& rTo,   int inPortIdx)
+{
+   if (mResourceBag.find(&rFrom) != &rFrom ||
+       mResourceBag.find(&rTo) != &rTo)
+   {
+      return OS_NOT_FOUND;
+   }
+   if (outPortIdx < 0 || outPortIdx >= rFrom.maxOutputs() ||
+       inPortIdx < 0 || inPortIdx >= rTo.maxInputs() ||
+       rFrom.isOutputConnected(outPortIdx) || rTo.isInputConnected(inPortIdx))
+   {
+      return OS_INVALID_ARGUMENT;
+   }
+
+   // Same order as MpFlowGraphBase::handleAddLink()
+   if (!rTo.connectInput(rFrom, outPortIdx, inPortIdx))
+   {
+      return OS_INVALID_ARGUMENT;
+   }
+   if (!rFrom.connectOutput(rTo, inPortIdx, outPortIdx))
+   {
+      rTo.disconnectInput(inPortIdx);
+      return OS_INVALID_ARGUMENT;
+   }
+
+   mNumInternalLinks++;
+   return OS_SUCCESS;
+}
+
+OsStatus MpResourceSet::addLink(MpResource& rFrom, int outPortIdx,
+                                MpResource& rTo,   int inPortIdx)
+{
+   if (outPortIdx < 0 || outPortIdx >= rFrom.maxOutputs() ||
+       inPortIdx < 0 || inPortIdx >= rTo.maxInputs())
+   {
+      return OS_INVALID_ARGUMENT;
+   }
+   if (mNumLinks >= MAX_LINKS)
+   {
+      return OS_LIMIT_REACHED;
+   }
+
+   Link& link = mLinks[mNumLinks++];
+   link.mpFrom = &rFrom;
+   link.mOutPortIdx = outPortIdx;
+   link.mpTo = &rTo;
+   link.mInPortIdx = inPortIdx;
+
+   return OS_SUCCESS;
+}
+
+void MpResourceSet::setResourceNum(int resourceNum)
+{
+   // Names are the hash keys of the bag, so it is filled again.
+   mResourceBag.removeAll();
+
+   for (int i = 0; i < mNumResources; i++)
+   {
+      MpResource* pResource = mpResources[i];
+      assert(pResource->getFlowGraph() == NULL);
+
+      UtlString name(*pResource);
+      MpResourceTopology::replaceNumInName(name, resourceNum);
+      pResource->setName(name);
+
+      if (pResource->getConnectionId() == MP_INVALID_CONNECTION_ID)
+      {
+         pResource->setConnectionId(resourceNum);
+      }
+
+      mResourceBag.insert(pResource);
+   }
+}
+
+/* ============================ ACCESSORS ================================= */
+
+void MpResourceSet::getLink(int index,
+                            MpResource*& rpFrom, int& outPortIdx,
+                            MpResource*& rpTo,   int& inPortIdx) const
+{
+   assert(index >= 0 && index < mNumLinks);
+
+   const Link& link = mLinks[index];
+   rpFrom = link.mpFrom;
+   outPortIdx = link.mOutPortIdx;
+   rpTo = link.mpTo;
+   inPortIdx = link.mInPortIdx;
+}
+
+/* ============================ INQUIRY =================================== */
+
+/* //////////////////////////// PROTECTED ///////////////////////////////// */
+
+/* //////////////////////////// PRIVATE /////////////////////////////////// */
+
+/* ============================ FUNCTIONS ================================= */
@@ -38,6 +38,7 @@
 // EXTERNAL FUNCTIONS
 // EXTERNAL VARIABLES
 // CONSTANTS
+#define RTP_DISPATCHER_NAME_SUFFIX "-RtpDispatcher"
 // STATIC VARIABLE INITIALIZATIONS
 
 /* //////////////////////////// PUBLIC //////////////////////////////////// */
@@ -65,7 +66,7 @@ MpRtpInputConnection::MpRtpInputConnection(const UtlString& resourceName,
 
    // Create our resources
    {
-      UtlString name = getName() + "-RtpDispatcher";
+      UtlString name = getName() + RTP_DISPATCHER_NAME_SUFFIX;
       switch (mRtpStreamAffinity)
       {
       case MprRtpDispatcher::ADDRESS_AND_PORT:
@@ -238,6 +239,13 @@ OsStatus MpRtpInputConnection::setFlowGraph(MpFlowGraphBase* pFlowGraph)
    return stat;
 }
 
+void MpRtpInputConnection::setName(const UtlString& rName)
+{
+   MpResource::setName(rName);
+
+   // Keep notifications from the dispatcher named after this resource.
+   mpRtpDispatcher->setResourceName(rName + RTP_DISPATCHER_NAME_SUFFIX);
+}
 
 UtlBoolean MpRtpInputConnection::handleMessage(MpResourceMsg& rMsg)
 {
@@ -20,6 +20,7 @@
 #include <mp/MpMediaTask.h>
 #include <mp/MpResourceFactory.h>
 #include <mp/MpResourceTopology.h>
+#include <mp/MpResourceSet.h>
 
 
 //  REMOVE THESE WHEN MpResourceFactory and MpResourceTopology are implemented
@@ -140,6 +141,128 @@ OsStatus MpTopologyGraph::addResources(MpResourceTopology& incrementalTopology,
     return OS_SUCCESS;
 }
 
+OsStatus MpTopologyGraph::prebuildResources(MpResourceTopology& incrementalTopology,
+                                           MpResourceFactory& resourceFactory,
+                                           MpResourceSet*& rpResourceSet)
+{
+    MpResourceSet* pResourceSet = new MpResourceSet();
+    OsStatus status = OS_SUCCESS;
+
+    // Construct the resources.  Their names keep the "%d" placeholder.
+    int resourceIndex = 0;
+    MpResource* resourceArray[MAX_CONSTRUCTED_RESOURCES];
+    UtlString resourceType;
+    UtlString resourceName;
+    MpConnectionID resourceConnId;
+    int resourceStreamId;
+    while(status == OS_SUCCESS &&
+          incrementalTopology.getResource(resourceIndex, resourceType, resourceName,
+                                          resourceConnId, resourceStreamId) == OS_SUCCESS)
+    {
+        int numConstructorResources = 0;
+        status = resourceFactory.newResource(resourceType, resourceName, MAX_CONSTRUCTED_RESOURCES,
+                                             numConstructorResources, resourceArray);
+        if(status != OS_SUCCESS)
+        {
+           OsSysLog::add(FAC_MP, PRI_ERR,
+              "MpTopologyGraph::prebuildResources failed to create resource type: %s name: %s status: %d",
+              resourceType.data(), resourceName.data(), status);
+        }
+        for(int arrayIndex = 0; arrayIndex < numConstructorResources; arrayIndex++)
+        {
+           MpResource* resourcePtr = resourceArray[arrayIndex];
+           assert(resourcePtr);
+           resourcePtr->setConnectionId(resourceConnId);
+           resourcePtr->setStreamId(resourceStreamId);
+           if(pResourceSet->addResource(*resourcePtr) != OS_SUCCESS)
+           {
+              delete resourcePtr;
+              status = OS_FAILED;
+           }
+        }
+        resourceIndex++;
+    }
+
+    // Link the resources to each other.  The links to other resources
+    // are left for addPrebuiltResources().
+    int connectionIndex = 0;
+    UtlString outputResourceName;
+    UtlString inputResourceName;
+    int outputResourcePortIndex;
+    int inputResourcePortIndex;
+    UtlHashMap newConnectionIds;
+    UtlHashBag& newResources = pResourceSet->getResources();
+    while(status == OS_SUCCESS &&
+          incrementalTopology.getConnection(connectionIndex,
+                                            outputResourceName,
+                                            outputResourcePortIndex,
+                                            inputResourceName,
+                                            inputResourcePortIndex) == OS_SUCCESS)
+    {
+        MpResource* outputResource = (MpResource*) newResources.find(&outputResourceName);
+        MpResource* inputResource = (MpResource*) newResources.find(&inputResourceName);
+        if(outputResource && inputResource)
+        {
+            outputResourcePortIndex = reservePort(*outputResource, outputResourcePortIndex,
+                                                  TRUE, newConnectionIds);
+            inputResourcePortIndex = reservePort(*inputResource, inputResourcePortIndex,
+                                                 FALSE, newConnectionIds);
+            status = pResourceSet->linkResources(*outputResource, outputResourcePortIndex,
+                                                 *inputResource, inputResourcePortIndex);
+            if(status != OS_SUCCESS)
+            {
+               OsSysLog::add(FAC_MP, PRI_ERR,
+                  "MpTopologyGraph::prebuildResources failed to link %s:%d -> %s:%d status: %d",
+                  outputResourceName.data(), outputResourcePortIndex,
+                  inputResourceName.data(), inputResourcePortIndex, status);
+            }
+        }
+        connectionIndex++;
+    }
+    newConnectionIds.destroyAll();
+
+    if(status != OS_SUCCESS)
+    {
+        delete pResourceSet;
+        pResourceSet = NULL;
+        status = OS_FAILED;
+    }
+
+    rpResourceSet = pResourceSet;
+    return status;
+}
+
+OsStatus MpTopologyGraph::addPrebuiltResources(MpResourceTopology& incrementalTopology,
+                                               MpResourceSet* pResourceSet,
+                                               int resourceInstanceId)
+{
+    assert(pResourceSet);
+
+    // Give the resources their final names, which the virtual ports and
+    // links below refer to.
+    pResourceSet->setResourceNum(resourceInstanceId);
+    UtlHashBag& newResources = pResourceSet->getResources();
+
+    // Add new virtual ports
+    addVirtualInputs(incrementalTopology,
+                     newResources,
+                     TRUE,
+                     resourceInstanceId);
+    addVirtualOutputs(incrementalTopology,
+                      newResources,
+                      TRUE,
+                      resourceInstanceId);
+
+    // Record the links to the rest of the flowgraph
+    linkTopologyResources(incrementalTopology,
+                          newResources,
+                          TRUE,
+                          resourceInstanceId,
+                          pResourceSet);
+
+    return addResourceSet(pResourceSet);
+}
+
 OsStatus MpTopologyGraph::destroyResources(MpResourceTopology& resourceTopology,
                                           int resourceInstanceId)
 {
@@ -694,7 +817,8 @@ int MpTopologyGraph::removeVirtualOutputs(MpResourceTopology& resourceTopology,
 int MpTopologyGraph::linkTopologyResources(MpResourceTopology& resourceTopology,
                                            UtlHashBag& newResources,
                                            UtlBoolean replaceNumInName,
-                                           int resourceNum)
+                                           int resourceNum,
+                                           MpResourceSet* pResourceSet)
 {
     // Link the resources
     int connectionIndex = 0;
@@ -770,64 +894,29 @@ int MpTopologyGraph::linkTopologyResources(MpResourceTopology& resourceTopology,
         assert(outputResource);
         assert(inputResource);
 
-        if(outputResource && inputResource)
+        if(pResourceSet && outputResource && inputResource &&
+           newResources.find(outputResource) == outputResource &&
+           newResources.find(inputResource) == inputResource)
         {
-            if(outputResourcePortIndex == MpResourceTopology::MP_TOPOLOGY_NEXT_AVAILABLE_PORT)
-            {
-                outputResourcePortIndex = outputResource->reserveFirstUnconnectedOutput();
-                assert(outputResourcePortIndex >= 0);
-            }
-            else if(outputResourcePortIndex < MpResourceTopology::MP_TOPOLOGY_NEXT_AVAILABLE_PORT)
-            {
-                // First see if a real port is already in the dictionary
-                UtlInt searchKey(outputResourcePortIndex);
-                UtlInt* foundValue = NULL;
-                if((foundValue = (UtlInt*) newConnectionIds.findValue(&searchKey)))
-                {
-                    // Use the mapped index
-                    outputResourcePortIndex = foundValue->getValue();
-                }
-                else
-                {
-                    // Find an available port and add it to the map
-                    int realPortNum = outputResource->reserveFirstUnconnectedOutput();
-                    assert(realPortNum >= 0);
-                    UtlInt* portKey = new UtlInt(outputResourcePortIndex);
-                    UtlInt* portValue = new UtlInt(realPortNum);
-                    newConnectionIds.insertKeyAndValue(portKey, portValue);
-                    outputResourcePortIndex = realPortNum;
-                }
-            }
+            // Linked already by prebuildResources()
+        }
+        else if(outputResource && inputResource)
+        {
+            outputResourcePortIndex = reservePort(*outputResource, outputResourcePortIndex,
+                                                  TRUE, newConnectionIds);
+            inputResourcePortIndex = reservePort(*inputResource, inputResourcePortIndex,
+                                                 FALSE, newConnectionIds);
 
-            if(inputResourcePortIndex == MpResourceTopology::MP_TOPOLOGY_NEXT_AVAILABLE_PORT)
+            if(pResourceSet)
             {
-                inputResourcePortIndex = inputResource->reserveFirstUnconnectedInput();
-                assert(inputResourcePortIndex >= 0);
+                result = pResourceSet->addLink(*outputResource, outputResourcePortIndex,
+                                               *inputResource, inputResourcePortIndex);
             }
-            else if(inputResourcePortIndex < MpResourceTopology::MP_TOPOLOGY_NEXT_AVAILABLE_PORT)
+            else
             {
-                // First see if a real port is already in the dictionary
-                UtlInt searchKey(inputResourcePortIndex);
-                UtlInt* foundValue = NULL;
-                if((foundValue = (UtlInt*) newConnectionIds.findValue(&searchKey)))
-                {
-                    // Use the mapped index
-                    inputResourcePortIndex = foundValue->getValue();
-                }
-                else
-                {
-                    // Find an available port and add it to the map
-                    int realPortNum = inputResource->reserveFirstUnconnectedInput();
-                    assert(realPortNum >= 0);
-                    UtlInt* portKey = new UtlInt(inputResourcePortIndex);
-                    UtlInt* portValue = new UtlInt(realPortNum);
-                    newConnectionIds.insertKeyAndValue(portKey, portValue);
-                    inputResourcePortIndex = realPortNum;
-                }
+                result = addLink(*outputResource, outputResourcePortIndex,
+                                 *inputResource, inputResourcePortIndex);
             }
-
-
-            result = addLink(*outputResource, outputResourcePortIndex, *inputResource, inputResourcePortIndex);
             assert(result == OS_SUCCESS);
         }
         connectionIndex++;
@@ -836,6 +925,42 @@ int MpTopologyGraph::linkTopologyResources(MpResourceTopology& resourceTopology,
     newConnectionIds.destroyAll();
     return(connectionIndex);
 }
+
+int MpTopologyGraph::reservePort(MpResource& resource,
+                                 int portIndex,
+                                 UtlBoolean isOutput,
+                                 UtlHashMap& logicalPorts)
+{
+    if(portIndex == MpResourceTopology::MP_TOPOLOGY_NEXT_AVAILABLE_PORT)
+    {
+        portIndex = isOutput ? resource.reserveFirstUnconnectedOutput()
+                             : resource.reserveFirstUnconnectedInput();
+        assert(portIndex >= 0);
+    }
+    else if(portIndex < MpResourceTopology::MP_TOPOLOGY_NEXT_AVAILABLE_PORT)
+    {
+        // First see if a real port is already in the dictionary
+        UtlInt searchKey(portIndex);
+        UtlInt* foundValue = NULL;
+        if((foundValue = (UtlInt*) logicalPorts.findValue(&searchKey)))
+        {
+            // Use the mapped index
+            portIndex = foundValue->getValue();
+        }
+        else
+        {
+            // Find an available port and add it to the map
+            int realPortNum = isOutput ? resource.reserveFirstUnconnectedOutput()
+                                       : resource.reserveFirstUnconnectedInput();
+            assert(realPortNum >= 0);
+            UtlInt* portKey = new UtlInt(portIndex);
+            UtlInt* portValue = new UtlInt(realPortNum);
+            logicalPorts.insertKeyAndValue(portKey, portValue);
+            portIndex = realPortNum;
+        }
+    }
+    return portIndex;
+}
     
 /* ============================ FUNCTIONS ================================= */
 
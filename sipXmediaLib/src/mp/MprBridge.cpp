@@ -25,6 +25,7 @@
 #include <mp/MprBridgeSetGainsMsg.h>
 #include <mp/MpBridgeAlgSimple.h>
 #include <mp/MpBridgeAlgLinear.h>
+#include <mp/MpBridgeAlgCommonMix.h>
 
 #ifdef PRINT_CLIPPING_STATS
 #  include <os/OsSysLog.h>
@@ -323,6 +324,11 @@ OsStatus MprBridge::setFlowGraph(MpFlowGraphBase* pFlowGraph)
                                                 mMixSilence,
                                                 mpFlowGraph->getSamplesPerFrame());
             break;
+         case ALG_COMMON_MIX:
+            mpBridgeAlg = new MpBridgeAlgCommonMix(maxInputs(), maxOutputs(),
+                                                   mMixSilence,
+                                                   mpFlowGraph->getSamplesPerFrame());
+            break;
          default:
             assert(!"Unknown bridge algorithm type!");
             return OS_FAILED;
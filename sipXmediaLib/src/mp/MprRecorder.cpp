@@ -50,56 +50,297 @@
 // CONSTANTS
 #define ETHERNET_MTU_BYTES 1500
 
+#define MPR_RECORDER_WRITE_BATCH_SIZE (2 * MPR_RECORDER_WRITE_SIZE)
+
+struct SipxOpusWriteObject;
+class MprRecorderWriter;
+
+/// Encoding and output of one recording to a file or a circular buffer.
+/**
+*  The media task writes through the job itself, unless the recording to
+*  file is given to a writer thread.  Then the media task only queues frames
+*  until it sets closing, and from then on the job belongs to the writer,
+*  which closes the file, sends the finish notification if the recorder is
+*  still attached and frees the job.  The encoder and file state are only
+*  used by one thread at a time.
+*/
+class MprRecorderJob
+{
+public:
+   typedef int (MprRecorderJob::*WriteMethod)(const char * channelBuffers[], int);
+
+   MprRecorderJob(MprRecorder* pRecorder, int channels,
+                  int samplesPerFrame, int samplesPerSecond);
+   ~MprRecorderJob();
+
+     /// Create the encoder and resampler for the recording format.
+   void prepareEncoder(MprRecorder::RecordFileFormat recFormat, unsigned int & codecSampleRate);
+
+   void createEncoder(const char * mimeSubtype, unsigned int codecSampleRate);
+   OsStatus createOpusEncoder(int channels,
+                              const char* artist, 
+                              const char* title);
+   void deleteOpusEncoder();
+
+     /// Write silence to the file
+   int writeFileSilence(int numSamples);
+
+     /// Write silence to the circular buffer
+   int writeCircularBufferSilence(int numSamples);
+
+     /// Write given data to the specified target
+   int writeSamples(const MpAudioSample *pBuffer[], int numSamples, WriteMethod writeMethod);
+
+   int writeFile(const char* channelData[], int dataSize);
+   int writeCircularBuffer(const char* channelData[], int dataSize);
+
+     /// Close file if it is opened and  update WAV header if needed.
+   void closeFile(const char* fromWhereLabel);
+
+   void trimSilenceFromEndOfRecording();
+
+     /// Create the queue and give the job to a writer thread.
+   void startWriter(MprRecorderWriter* pWriter);
+     /**<
+     *  Called with sWritersMutex held.
+     */
+
+     /// Encode and write the queued frames, in the writer thread.
+   UtlBoolean writeQueuedFrames();
+     /**<
+     *  @returns TRUE once the recording is finished and its file closed.
+     */
+
+     /// Let the writer thread close the file once the queue is empty.
+   void wakeWriterToClose();
+
+     /// Write out the batched data, all of it or up to an aligned offset.
+   UtlBoolean flushWriteBatch(UtlBoolean all);
+
+   unsigned loadShared(const volatile unsigned& value);
+   void storeShared(volatile unsigned& value, unsigned newValue);
+
+   MprRecorder* mpRecorder; ///< Recorder to notify, guarded by sWritersMutex
+                            ///< once the job is given to a writer.
+   UtlString mName;         ///< Name of the recorder, for the writer logs.
+   int mChannels;
+   int mSamplesPerFrame;    ///< Flowgraph frame size.
+   int mSamplesPerSecond;   ///< Flowgraph sample rate.
+   int mConsecutiveInactive; ///< Frames of silence to trim when closing.
+
+   int mFileDescriptor;     ///< File descriptor to write to.
+   MprRecorder::RecordFileFormat mRecFormat; ///< Should data be written in WAV or RAW PCM format.
+
+   CircularBufferPtr * mpCircularBuffer;
+   unsigned long mRecordingBufferNotificationWatermark;
+
+   MpEncoderBase* mpEncoder; ///< encoder for non-PCM formats saved to file
+   int mEncodedFrames;      ///< number of audio (flowgraph) frames encoded
+   int mLastEncodedFrameSize;///< Size in bytes of last encoded frame recorded
+
+   void* mpOpusEncoder;
+   void* mpOpusComments;
+   struct SipxOpusWriteObject* mpOpusStreamObject;
+
+   MprRecorder::SampleInterlaceStage mWhenToInterlace;
+
+   MpResamplerBase* mpResampler; ///< Resampler for encoding to file
+
+   MprRecorderWriter* mpWriter; ///< Writer thread of the recording,
+                            ///< or NULL if the media task writes the file.
+   MpAudioSample* mpQueueSamples; ///< MPR_RECORDER_QUEUE_FRAMES frames of
+                            ///< mChannels times mSamplesPerFrame samples.
+   int* mpQueueLengths;     ///< Samples per channel of each queued frame,
+                            ///< negative for a frame of silence.
+   volatile unsigned mQueueHead; ///< Count of frames taken by the writer.
+   volatile unsigned mQueueTail; ///< Count of frames queued by the media task.
+   volatile unsigned mWriterClosing; ///< No more frames, close the file.
+   volatile unsigned mWriterFailed;  ///< Writer thread could not write.
+   OsMutex mQueueMutex;     ///< Guards the variables above shared with the
+                            ///< writer where MPRRECORDER_LOCK_FREE is not defined.
+   UtlBoolean mWriteWaveHeader; ///< Writer starts the file with a WAV header.
+   unsigned int mWaveHeaderSampleRate; ///< Sample rate for the WAV header.
+   UtlBoolean mWriterStarted; ///< Writer has written the header if any.
+   UtlBoolean mWriterNotify; ///< Writer sends the finish notification.
+   MprRecorder::FinishCause mWriterFinishCause; ///< Cause of the finish for the writer.
+   int mWriterSamplesRecorded; ///< Samples for the finish notification.
+   MprRecorderJob* mpNextWriterJob; ///< Next job of the same writer.
+   MprRecorderJob* mpNextRecorderJob; ///< Next job in MprRecorder::mpWriterJobs.
+   char* mpWriteBatch;      ///< Encoded data waiting to be written.
+   int mWriteBatchLength;   ///< Bytes in mpWriteBatch.
+   int64_t mWriteBatchOffset; ///< File offset of mpWriteBatch.
+};
+
+/// Thread that encodes and writes recordings to files for the media task.
+class MprRecorderWriter : public OsTask
+{
+public:
+   MprRecorderWriter();
+   ~MprRecorderWriter();
+
+     /// Do the task.
+   virtual int run(void* pArg);
+
+     /// Give a recording to the writer.
+   void addJob(MprRecorderJob* pJob);
+
+     /// Let the writer look at its recordings.
+   inline void wake();
+
+     /// Ask the writer to exit and wait until it has.
+   void stop();
+
+   volatile unsigned mNumJobs; ///< Recordings the writer has, guarded by
+                               ///< sWritersMutex.
+
+private:
+   OsBSem          mWakeSem;
+   OsMutex         mNewJobsMutex;
+   MprRecorderJob* mpNewJobs;  ///< Recordings added, guarded by mNewJobsMutex.
+   MprRecorderJob* mpJobs;     ///< Recordings being written.
+};
+
 // STATIC VARIABLE INITIALIZATIONS
+static OsMutex sWritersMutex(OsMutex::Q_PRIORITY);
+static MprRecorderWriter* spWriters[MPR_RECORDER_MAX_WRITER_THREADS];
+static int sNumWriters = 0;
+
+MprRecorderWriter::MprRecorderWriter()
+: OsTask("MprRecWriter-%d")
+, mNumJobs(0)
+, mWakeSem(OsBSem::Q_PRIORITY, OsBSem::EMPTY)
+, mNewJobsMutex(OsMutex::Q_PRIORITY)
+, mpNewJobs(NULL)
+, mpJobs(NULL)
+{
+}
 
-/* //////////////////////////// PUBLIC //////////////////////////////////// */
+MprRecorderWriter::~MprRecorderWriter()
+{
+   stop();
+}
 
-/* ============================ CREATORS ================================== */
+int MprRecorderWriter::run(void*)
+{
+   for (;;)
+   {
+      mWakeSem.acquire();
+      if (isShuttingDown())
+      {
+         break;
+      }
 
-// Constructor
-MprRecorder::MprRecorder(const UtlString& rName)
-: MpAudioResource(rName, 1, MAXIMUM_RECORDER_CHANNELS, 0, MAXIMUM_RECORDER_CHANNELS)
-, mState(STATE_IDLE)
-, mRecordDestination(TO_UNDEFINED)
-, mChannels(1)
-, mFramesToRecord(0)
-, mNumFramesProcessed(0)
-, mSamplesRecorded(0)
+      // Take the recordings added since the last time round
+      MprRecorderJob* pNewJobs;
+      {
+         OsLock lock(mNewJobsMutex);
+         pNewJobs = mpNewJobs;
+         mpNewJobs = NULL;
+      }
+      while (pNewJobs)
+      {
+         MprRecorderJob* pJob = pNewJobs;
+         pNewJobs = pJob->mpNextWriterJob;
+         pJob->mpNextWriterJob = mpJobs;
+         mpJobs = pJob;
+      }
+
+      MprRecorderJob** ppJob = &mpJobs;
+      while (*ppJob)
+      {
+         MprRecorderJob* pJob = *ppJob;
+         if (pJob->writeQueuedFrames())
+         {
+            // Nothing else refers to the job once its file is closed
+            *ppJob = pJob->mpNextWriterJob;
+            delete pJob;
+         }
+         else
+         {
+            ppJob = &pJob->mpNextWriterJob;
+         }
+      }
+   }
+
+   return 0;
+}
+
+void MprRecorderWriter::addJob(MprRecorderJob* pJob)
+{
+   {
+      OsLock lock(mNewJobsMutex);
+      pJob->mpNextWriterJob = mpNewJobs;
+      mpNewJobs = pJob;
+   }
+   wake();
+}
+
+void MprRecorderWriter::wake()
+{
+   mWakeSem.release();
+}
+
+void MprRecorderWriter::stop()
+{
+   if (isStarted())
+   {
+      requestShutdown();
+      mWakeSem.release();
+   }
+   waitUntilShutDown();
+}
+
+MprRecorderJob::MprRecorderJob(MprRecorder* pRecorder, int channels,
+                               int samplesPerFrame, int samplesPerSecond)
+: mpRecorder(pRecorder)
+, mName(pRecorder->getName())
+, mChannels(channels)
+, mSamplesPerFrame(samplesPerFrame)
+, mSamplesPerSecond(samplesPerSecond)
 , mConsecutiveInactive(0)
-, mSilenceLength(0)
 , mFileDescriptor(-1)
-, mRecFormat(UNINITIALIZED_FORMAT)
-, mpBuffer(NULL)
-, mBufferSize(0)
+, mRecFormat(MprRecorder::UNINITIALIZED_FORMAT)
+, mpCircularBuffer(NULL)
+, mRecordingBufferNotificationWatermark(0)
 , mpEncoder(NULL)
 , mEncodedFrames(0)
 , mLastEncodedFrameSize(0)
 , mpOpusEncoder(NULL)
 , mpOpusComments(NULL)
 , mpOpusStreamObject(NULL)
-, mWhenToInterlace(NO_INTERLACE)
+, mWhenToInterlace(MprRecorder::NO_INTERLACE)
 , mpResampler(NULL)
-, mpCircularBuffer(NULL)
-, mRecordingBufferNotificationWatermark(0)
-, mSamplesPerLastFrame(0)
-, mSamplesPerSecond(0)
+, mpWriter(NULL)
+, mpQueueSamples(NULL)
+, mpQueueLengths(NULL)
+, mQueueHead(0)
+, mQueueTail(0)
+, mWriterClosing(FALSE)
+, mWriterFailed(FALSE)
+, mQueueMutex(OsMutex::Q_PRIORITY)
+, mWriteWaveHeader(FALSE)
+, mWaveHeaderSampleRate(0)
+, mWriterStarted(FALSE)
+, mWriterNotify(TRUE)
+, mWriterFinishCause(MprRecorder::FINISHED_MANUAL)
+, mWriterSamplesRecorded(0)
+, mpNextWriterJob(NULL)
+, mpNextRecorderJob(NULL)
+, mpWriteBatch(NULL)
+, mWriteBatchLength(0)
+, mWriteBatchOffset(0)
 {
 }
 
-// Destructor
-MprRecorder::~MprRecorder()
+MprRecorderJob::~MprRecorderJob()
 {
-    // If when we get to the destructor and our file descriptor is not set to -1
-    // then close it now.
-    closeFile("~MprRecorder");
-
     if(mpEncoder)
     {
         delete mpEncoder;
         mpEncoder = NULL;
     }
 
-    if(mpOpusEncoder)
+    if(mpOpusEncoder || mpOpusComments)
     {
         deleteOpusEncoder();
     }
@@ -110,6 +351,50 @@ MprRecorder::~MprRecorder()
         mpResampler = NULL;
     }
 
+    delete[] mpQueueSamples;
+    delete[] mpQueueLengths;
+    delete[] mpWriteBatch;
+}
+
+/* //////////////////////////// PUBLIC //////////////////////////////////// */
+
+/* ============================ CREATORS ================================== */
+
+// Constructor
+MprRecorder::MprRecorder(const UtlString& rName)
+: MpAudioResource(rName, 1, MAXIMUM_RECORDER_CHANNELS, 0, MAXIMUM_RECORDER_CHANNELS)
+, mState(STATE_IDLE)
+, mRecordDestination(TO_UNDEFINED)
+, mChannels(1)
+, mFramesToRecord(0)
+, mNumFramesProcessed(0)
+, mSamplesRecorded(0)
+, mConsecutiveInactive(0)
+, mSilenceLength(0)
+, mpBuffer(NULL)
+, mBufferSize(0)
+, mpJob(NULL)
+, mpCircularBuffer(NULL)
+, mRecordingBufferNotificationWatermark(0)
+, mSamplesPerLastFrame(0)
+, mSamplesPerSecond(0)
+, mpWriterJobs(NULL)
+, mDroppedFrames(0)
+, mDroppedSamples(0)
+, mMaxQueuedFrames(0)
+, mDropping(FALSE)
+{
+}
+
+// Destructor
+MprRecorder::~MprRecorder()
+{
+    // If the recording has not finished, close its file now.  A writer
+    // thread may still be writing the last recordings, which it finishes
+    // on its own.
+    abandonJob();
+    detachWriterJobs();
+
     if (mpCircularBuffer)
         mpCircularBuffer->release();
 }
@@ -470,8 +755,56 @@ OsStatus MprRecorder::stop(const UtlString& namedResource, OsMsgQ& fgQ)
    return(status);
 }
 
+OsStatus MprRecorder::setWriterThreads(int numThreads)
+{
+   if (numThreads < 0 || numThreads > MPR_RECORDER_MAX_WRITER_THREADS)
+   {
+      return OS_INVALID_ARGUMENT;
+   }
+
+   OsLock lock(sWritersMutex);
+   int i;
+   for (i = numThreads; i < sNumWriters; i++)
+   {
+      if (spWriters[i]->mNumJobs > 0)
+      {
+         return OS_BUSY;
+      }
+   }
+
+   for (i = numThreads; i < sNumWriters; i++)
+   {
+      delete spWriters[i];
+      spWriters[i] = NULL;
+   }
+   for (i = sNumWriters; i < numThreads; i++)
+   {
+      spWriters[i] = new MprRecorderWriter();
+      spWriters[i]->start();
+   }
+   sNumWriters = numThreads;
+
+   return OS_SUCCESS;
+}
+
 /* ============================ ACCESSORS ================================= */
 
+int MprRecorder::getWriterThreads()
+{
+   OsLock lock(sWritersMutex);
+   return sNumWriters;
+}
+
+int MprRecorder::getDroppedFrames() const
+{
+   return mDroppedFrames;
+}
+
+int MprRecorder::getMaxQueuedFrames() const
+{
+   return mMaxQueuedFrames;
+}
+
 /* ============================ INQUIRY =================================== */
 
 /* //////////////////////////// PROTECTED ///////////////////////////////// */
@@ -517,6 +850,23 @@ UtlBoolean MprRecorder::doProcessFrame(MpBufPtr inBufs[],
        return TRUE;
    }
 
+   // The writer thread could not encode or write the file.
+   if (mRecordDestination == TO_FILE && mpJob->mpWriter &&
+       mpJob->loadShared(mpJob->mWriterFailed))
+   {
+      OsSysLog::add(FAC_MP, PRI_ERR,
+         "MprRecorder::doProcessFrame to finish recording because"
+         " the writer thread failed");
+      finish(FINISHED_ERROR);
+
+      // Push data further downstream
+      for(channelIndex = 0; channelIndex < inBufsSize; channelIndex++)
+      {
+         outBufs[channelIndex].swap(in[channelIndex]);
+      }
+      return TRUE;
+   }
+
    // maximum record time reached or final silence timeout.
    if (  (mFramesToRecord >= 0 && mFramesToRecord-- == 0)
       || (mSilenceLength >= 0 && mConsecutiveInactive >= mSilenceLength))
@@ -543,7 +893,8 @@ UtlBoolean MprRecorder::doProcessFrame(MpBufPtr inBufs[],
       int numRecorded;
       if (mRecordDestination == TO_FILE)
       {
-         numRecorded = writeFileSilence(samplesPerFrame);
+         numRecorded = mpJob->mpWriter ? queueFrame(NULL, samplesPerFrame)
+                                       : mpJob->writeFileSilence(samplesPerFrame);
       }
       else if (mRecordDestination == TO_BUFFER)
       {
@@ -551,7 +902,7 @@ UtlBoolean MprRecorder::doProcessFrame(MpBufPtr inBufs[],
       }
       else if (mRecordDestination == TO_CIRCULAR_BUFFER)
       {
-          numRecorded = writeCircularBufferSilence(samplesPerFrame);
+          numRecorded = mpJob->writeCircularBufferSilence(samplesPerFrame);
       }
       mSamplesRecorded += numRecorded;
       mConsecutiveInactive++;
@@ -609,7 +960,8 @@ UtlBoolean MprRecorder::doProcessFrame(MpBufPtr inBufs[],
       int numRecorded;
       if (mRecordDestination == TO_FILE)
       {
-         numRecorded = writeSamples(inputSamplesPtrArray, samplesPerFrame, &MprRecorder::writeFile);
+         numRecorded = mpJob->mpWriter ? queueFrame(inputSamplesPtrArray, samplesPerFrame)
+                                       : mpJob->writeSamples(inputSamplesPtrArray, samplesPerFrame, &MprRecorderJob::writeFile);
       }
       else if (mRecordDestination == TO_BUFFER)
       {
@@ -617,7 +969,7 @@ UtlBoolean MprRecorder::doProcessFrame(MpBufPtr inBufs[],
       }
       else if (mRecordDestination == TO_CIRCULAR_BUFFER)
       {
-         numRecorded = writeSamples(inputSamplesPtrArray, samplesPerFrame, &MprRecorder::writeCircularBuffer);
+         numRecorded = mpJob->writeSamples(inputSamplesPtrArray, samplesPerFrame, &MprRecorderJob::writeCircularBuffer);
       }
       mSamplesRecorded += numRecorded;
 
@@ -645,12 +997,12 @@ UtlBoolean MprRecorder::doProcessFrame(MpBufPtr inBufs[],
    return TRUE;
 }
 
-int MprRecorder::writeCircularBuffer(const char* channelData[], int dataSize)
+int MprRecorderJob::writeCircularBuffer(const char* channelData[], int dataSize)
 {
     OsSysLog::add(FAC_MP, PRI_INFO, "MprRecorder::doProcessFrame - TO_CIRCULAR_BUFFER, non-silence");
     
     unsigned long newSize, previousSize, iterPreviousSize;
-    int bytesPerSample = getBytesPerSample(mRecFormat);
+    int bytesPerSample = MprRecorder::getBytesPerSample(mRecFormat);
     assert(bytesPerSample > 0);
 
     int dataIndex;
@@ -671,7 +1023,7 @@ int MprRecorder::writeCircularBuffer(const char* channelData[], int dataSize)
     }
 
     if (previousSize < mRecordingBufferNotificationWatermark && newSize >= mRecordingBufferNotificationWatermark)
-        notifyCircularBufferWatermark();
+        mpRecorder->notifyCircularBufferWatermark();
 
     // the circular buffer is endless, so we can say we have written all in
     return dataSize * mChannels;
@@ -686,7 +1038,7 @@ void MprRecorder::notifyCircularBufferWatermark()
     sendNotification(msg);
 }
 
-void MprRecorder::createEncoder(const char * mimeSubtype, unsigned int codecSampleRate)
+void MprRecorderJob::createEncoder(const char * mimeSubtype, unsigned int codecSampleRate)
 {
     OsStatus status = OS_INVALID_ARGUMENT;
 
@@ -864,7 +1216,7 @@ OsStatus MprRecorder::validateOpusHeader(int inFileFd, OpusHead& opusHeader)
 
 #endif
 
-OsStatus MprRecorder::createOpusEncoder(int channels,
+OsStatus MprRecorderJob::createOpusEncoder(int channels,
                                         const char* artist, 
                                         const char* title)
 {
@@ -957,7 +1309,7 @@ OsStatus MprRecorder::createOpusEncoder(int channels,
     return(status);
 }
 
-void MprRecorder::deleteOpusEncoder()
+void MprRecorderJob::deleteOpusEncoder()
 {
 #ifdef OPUS_FILE_RECORD_ENABLED
     if(mpOpusEncoder)
@@ -1019,7 +1371,7 @@ void MprRecorder::deleteOpusEncoder()
 #endif
 }
 
-void MprRecorder::trimSilenceFromEndOfRecording()
+void MprRecorderJob::trimSilenceFromEndOfRecording()
 {
     if (mConsecutiveInactive > 0)
     {
@@ -1028,7 +1380,7 @@ void MprRecorder::trimSilenceFromEndOfRecording()
 
         // resize with mConsecutiveInactive less samples
         uint32_t sizeToReduceBy;
-        if (mRecFormat == WAV_GSM)
+        if (mRecFormat == MprRecorder::WAV_GSM)
         {
             // GSM writes in sets of 2.  First write contains 32 bytes of data per channel for 20ms of audio, next write contains
             // 33 bytes of data per channel for 20ms of audio.  So we have 65 bytes of data per channel for 20ms of audio.  Audio
@@ -1041,7 +1393,7 @@ void MprRecorder::trimSilenceFromEndOfRecording()
                 "MprRecorder::trimSilenceFromEndOfRecording: reducing GSM file by framesOfSilence=%d, channels=%d, gsmBlockstoTrim=%d, curLength=%d, sizeToReduceBy=%d", 
                 mConsecutiveInactive, mChannels, gsmBlockstoTrim, curLength, sizeToReduceBy);
         }
-        else if(mRecFormat == OGG_OPUS)
+        else if(mRecFormat == MprRecorder::OGG_OPUS)
         {
             sizeToReduceBy = 0;  // Disabled
         }
@@ -1065,70 +1417,52 @@ void MprRecorder::trimSilenceFromEndOfRecording()
     }
 }
 
-void MprRecorder::prepareEncoder(RecordFileFormat recFormat, unsigned int & codecSampleRate)
+void MprRecorder::prepareEncoder(RecordFileFormat recFormat, int file, unsigned int & codecSampleRate)
 {
-    codecSampleRate = 0;
     OsSysLog::add(FAC_MP, PRI_DEBUG,
-            "MprRecorder::prepareEncoder format: %d media frame size: %d sample rate: %d processed frames: %d encoded frames: %d last encoded size: %d",
-            mRecFormat, mSamplesPerLastFrame, mSamplesPerSecond, mNumFramesProcessed, mEncodedFrames, mLastEncodedFrameSize);
+            "MprRecorder::prepareEncoder format: %d media frame size: %d sample rate: %d processed frames: %d",
+            recFormat, mSamplesPerLastFrame, mSamplesPerSecond, mNumFramesProcessed);
     assert(mpFlowGraph);
-    unsigned int flowgraphSampleRate = mpFlowGraph->getSamplesPerSec();
-
-    if (mpEncoder)
-    {
-        // Should always be even number of GSM frames (alternating between 32 and 33 bytes).
-        // If last frame written is not 33, something went wrong.
-        if(mRecFormat == WAV_GSM && 
-           (mEncodedFrames % 2 || (mLastEncodedFrameSize != 0 && mLastEncodedFrameSize != 33)))
-        {
-            OsSysLog::add(FAC_MP, PRI_ERR,
-                    "MprRecord::prepareEncoder deleting GSM codec, last of %d frames written was: %d bytes, should be 33",
-                    mEncodedFrames, mLastEncodedFrameSize);
-        }
-
-        delete mpEncoder;
-        mpEncoder = NULL;
-    }
-
-    if(mpOpusEncoder || mpOpusComments)
-    {
-        deleteOpusEncoder();
-    }
+    assert(mpJob == NULL);
 
     mNumFramesProcessed = 0;
+    mpJob = new MprRecorderJob(this, mChannels,
+                               mpFlowGraph->getSamplesPerFrame(),
+                               mpFlowGraph->getSamplesPerSec());
+    mpJob->mFileDescriptor = file;
+    mpJob->prepareEncoder(recFormat, codecSampleRate);
+}
+
+void MprRecorderJob::prepareEncoder(MprRecorder::RecordFileFormat recFormat, unsigned int & codecSampleRate)
+{
+    codecSampleRate = 0;
+    unsigned int flowgraphSampleRate = mSamplesPerSecond;
     mRecFormat = recFormat;
-    mEncodedFrames = 0;
-    mLastEncodedFrameSize = 0;
-    if (mpResampler)
-    {
-        delete mpResampler;
-        mpResampler = NULL;
-    }
 
     switch (mRecFormat)
     {
         // Encoder needed
     case MprRecorder::WAV_GSM:
         codecSampleRate = 8000;
-        mWhenToInterlace = NO_INTERLACE;
+        mWhenToInterlace = MprRecorder::NO_INTERLACE;
         createEncoder(MIME_SUBTYPE_GSM_WAVE, codecSampleRate);
         break;
 
     case MprRecorder::WAV_ALAW:
         codecSampleRate = 8000;
-        mWhenToInterlace = (mChannels > 1) ? POST_ENCODE_INTERLACE : NO_INTERLACE;
+        mWhenToInterlace = (mChannels > 1) ? MprRecorder::POST_ENCODE_INTERLACE : MprRecorder::NO_INTERLACE;
         createEncoder(MIME_SUBTYPE_PCMA, codecSampleRate);
         break;
 
     case MprRecorder::WAV_MULAW:
         codecSampleRate = 8000;
-        mWhenToInterlace = (mChannels > 1) ? POST_ENCODE_INTERLACE : NO_INTERLACE;
+        mWhenToInterlace = (mChannels > 1) ? MprRecorder::POST_ENCODE_INTERLACE : MprRecorder::NO_INTERLACE;
         createEncoder(MIME_SUBTYPE_PCMU, codecSampleRate);
         break;
 
     case MprRecorder::UNINITIALIZED_FORMAT:
         OsSysLog::add(FAC_MP, PRI_ERR,
-            "MprRecorder::prepareEncoder unset recording format");
+            "MprRecorderJob::prepareEncoder unset recording format");
         OsSysLog::flush();
         assert(mRecFormat > MprRecorder::UNINITIALIZED_FORMAT);
         break;
@@ -1138,12 +1472,12 @@ void MprRecorder::prepareEncoder(RecordFileFormat recFormat, unsigned int & code
     case MprRecorder::WAV_PCM_16:
         //mEncoder = NULL;
         codecSampleRate = flowgraphSampleRate;
-        mWhenToInterlace = (mChannels > 1) ? POST_ENCODE_INTERLACE : NO_INTERLACE;
+        mWhenToInterlace = (mChannels > 1) ? MprRecorder::POST_ENCODE_INTERLACE : MprRecorder::NO_INTERLACE;
         break;
 
     case MprRecorder::OGG_OPUS:
         codecSampleRate = 48000;
-        mWhenToInterlace = (mChannels > 1) ? PRE_ENCODE_INTERLACE : NO_INTERLACE;
+        mWhenToInterlace = (mChannels > 1) ? MprRecorder::PRE_ENCODE_INTERLACE : MprRecorder::NO_INTERLACE;
         {
             UtlString trackName;
             // TODO get artist as local URI
@@ -1156,7 +1490,7 @@ void MprRecorder::prepareEncoder(RecordFileFormat recFormat, unsigned int & code
 
     default:
         OsSysLog::add(FAC_MP, PRI_ERR,
-            "MprRecorder::prepareEncoder invalid recording format: %d",
+            "MprRecorderJob::prepareEncoder invalid recording format: %d",
             mRecFormat);
         OsSysLog::flush();
         assert(0);
@@ -1185,14 +1519,9 @@ UtlBoolean MprRecorder::handleStartFile(int file,
         "MprRecorder::handleStartFile numChannels: %d MAXIMUM_RECORDER_CHANNELS: %d",
         numChannels,
         MAXIMUM_RECORDER_CHANNELS);
-    // If the file descriptor is already set, its busy already recording.
-    if(mFileDescriptor > -1)
-    {
-        OsSysLog::add(FAC_MP, PRI_ERR,
-                "MprRecord::handleFileStart this: %p file already set: %d new: %d",
-                this, mFileDescriptor, file);
-    }
-    mFileDescriptor = file;
+
+    // If there is a job already, its busy already recording.
+    abandonJob();
     mRecordDestination = TO_FILE;
 
     mChannels = numChannels;
@@ -1212,14 +1541,19 @@ UtlBoolean MprRecorder::handleStartFile(int file,
                 numChannels, MAXIMUM_RECORDER_CHANNELS);
     }
    unsigned int codecSampleRate;
-   prepareEncoder(recFormat, codecSampleRate);
+   prepareEncoder(recFormat, file, codecSampleRate);
 
    // If we are creating a WAV file, write the header.
    // Otherwise we are writing raw PCM data to file.
    // If we are appending, the wave file header already exists
-   if (mRecFormat != MprRecorder::RAW_PCM_16 && 
-       mRecFormat != MprRecorder::OGG_OPUS && 
-       !append)
+   mpJob->mWriteWaveHeader = (recFormat != MprRecorder::RAW_PCM_16 &&
+                              recFormat != MprRecorder::OGG_OPUS &&
+                              !append);
+   mpJob->mWaveHeaderSampleRate = codecSampleRate;
+
+   // A writer thread writes the header itself
+   startWriter();
+   if (mpJob->mWriteWaveHeader && mpJob->mpWriter == NULL)
    {
       writeWaveHeader(file, recFormat, codecSampleRate, numChannels);
    }
@@ -1238,6 +1572,8 @@ UtlBoolean MprRecorder::handleStartBuffer(MpAudioSample *pBuffer,
                                           int silenceLength,
                                           int numChannels)
 {
+   abandonJob();
+
    mpBuffer = pBuffer;
    mBufferSize = bufferSize;
    mRecordDestination = TO_BUFFER;
@@ -1265,6 +1601,8 @@ UtlBoolean MprRecorder::handleStartCircularBuffer(CircularBufferPtr * buffer,
                                                   int silenceLength,
                                                   int numChannels)
 {
+   abandonJob();
+
    if (mpCircularBuffer)
        mpCircularBuffer->release();
 
@@ -1281,7 +1619,9 @@ UtlBoolean MprRecorder::handleStartCircularBuffer(CircularBufferPtr * buffer,
    }
 
    unsigned int codecSampleRate;
-   prepareEncoder(recordingFormat, codecSampleRate);
+   prepareEncoder(recordingFormat, -1, codecSampleRate);
+   mpJob->mpCircularBuffer = mpCircularBuffer;
+   mpJob->mRecordingBufferNotificationWatermark = mRecordingBufferNotificationWatermark;
 
    startRecording(time, silenceLength);
 
@@ -1435,6 +1775,19 @@ UtlBoolean MprRecorder::handleMessage(MpResourceMsg& rMsg)
    return MpAudioResource::handleMessage(rMsg);
 }
 
+OsStatus MprRecorder::setFlowGraph(MpFlowGraphBase* pFlowGraph)
+{
+   // The writer threads send their notifications through the flowgraph,
+   // so they are left to finish their jobs without them.
+   if (mpJob && mpJob->mpWriter)
+   {
+      abandonJob();
+   }
+   detachWriterJobs();
+
+   return MpAudioResource::setFlowGraph(pFlowGraph);
+}
+
 void MprRecorder::startRecording(int time, int silenceLength)
 {
    assert(mpFlowGraph);
@@ -1479,8 +1832,28 @@ UtlBoolean MprRecorder::finish(FinishCause cause)
 
    if (mRecordDestination == TO_FILE)
    {
+      mpJob->mConsecutiveInactive = mConsecutiveInactive;
+      if (mpJob->mpWriter)
+      {
+         // The writer thread writes the frames still queued, closes the
+         // file, sends the notification and frees the job.
+         mpJob->mWriterFinishCause = cause;
+         mpJob->mWriterSamplesRecorded = mSamplesRecorded - mDroppedSamples;
+         mpJob->wakeWriterToClose();
+         mpJob = NULL;
+         mRecordDestination = TO_UNDEFINED;
+         return res;
+      }
+
       // Update WAV-header and close file.
-      closeFile("finish");
+      mpJob->closeFile("finish");
+      delete mpJob;
+      mpJob = NULL;
+   }
+   else if (mRecordDestination == TO_CIRCULAR_BUFFER)
+   {
+      delete mpJob;
+      mpJob = NULL;
    }
    else if (mRecordDestination == TO_BUFFER)
    {
@@ -1489,6 +1862,13 @@ UtlBoolean MprRecorder::finish(FinishCause cause)
    }
    mRecordDestination = TO_UNDEFINED;
 
+   sendFinishNotification(cause, mSamplesRecorded);
+
+   return res;
+}
+
+void MprRecorder::sendFinishNotification(FinishCause cause, int samplesRecorded)
+{
    // New style notification.
    switch (cause)
    {
@@ -1496,7 +1876,7 @@ UtlBoolean MprRecorder::finish(FinishCause cause)
       {
          MprnIntMsg msg(MpResNotificationMsg::MPRNM_RECORDER_FINISHED,
                         getName(),
-                        mSamplesRecorded);
+                        samplesRecorded);
          sendNotification(msg);
       }
       break;
@@ -1504,7 +1884,7 @@ UtlBoolean MprRecorder::finish(FinishCause cause)
       {
          MprnIntMsg msg(MpResNotificationMsg::MPRNM_RECORDER_STOPPED,
                         getName(),
-                        mSamplesRecorded);
+                        samplesRecorded);
          sendNotification(msg);
       }
       break;
@@ -1512,26 +1892,27 @@ UtlBoolean MprRecorder::finish(FinishCause cause)
       sendNotification(MpResNotificationMsg::MPRNM_RECORDER_ERROR);
       break;
    }
-
-   return res;
 }
 
-void MprRecorder::closeFile(const char* fromWhereLabel)
+void MprRecorderJob::closeFile(const char* fromWhereLabel)
 {
     if (mFileDescriptor > -1)
     {
         OsSysLog::add(FAC_MP, PRI_DEBUG,
-                "MprRecorder::closeFile(%s) this: %p fd: %d format: %d channels: %d media frame size: %d sample rate: %d processed frames: %d",
-                fromWhereLabel, this, mFileDescriptor,  mRecFormat, mChannels, mSamplesPerLastFrame, mSamplesPerSecond, mNumFramesProcessed);
+                "MprRecorderJob::closeFile(%s) this: %p fd: %d format: %d channels: %d media frame size: %d sample rate: %d",
+                fromWhereLabel, this, mFileDescriptor,  mRecFormat, mChannels, mSamplesPerFrame, mSamplesPerSecond);
 
-        if (mRecFormat == RAW_PCM_16)
+        if (mRecFormat == MprRecorder::RAW_PCM_16)
         {
+            flushWriteBatch(TRUE);
+
             // See if we should trim silence from end of recording
             trimSilenceFromEndOfRecording();
         }
-        else if (mRecFormat == OGG_OPUS)
+        else if (mRecFormat == MprRecorder::OGG_OPUS)
         {
             deleteOpusEncoder();
+            flushWriteBatch(TRUE);
         }
         // Any WAVE file needs header updates on closing
         else
@@ -1552,10 +1933,10 @@ void MprRecorder::closeFile(const char* fromWhereLabel)
                                    "MprRecorder::closeFile adding even numbered GSM frame (%d + 1) added %d media frames, last frame size: %d",
                                    mEncodedFrames, extraFrameIndex + 1, mLastEncodedFrameSize);
                            // Add an extra frame of silence
-                           writeFileSilence(mSamplesPerLastFrame ? mSamplesPerLastFrame : 80);
+                           writeFileSilence(mSamplesPerFrame ? mSamplesPerFrame : 80);
                            OsSysLog::add(FAC_MP, PRI_DEBUG,
                                    "MprRecorder::closeFile added %d samples, total GSM frames: %d, last frame size: %d",
-                                   (mSamplesPerLastFrame ? mSamplesPerLastFrame : 80), mEncodedFrames, mLastEncodedFrameSize);
+                                   (mSamplesPerFrame ? mSamplesPerFrame : 80), mEncodedFrames, mLastEncodedFrameSize);
                        }
                    }
 #ifdef TEST_PRINT
@@ -1573,11 +1954,13 @@ void MprRecorder::closeFile(const char* fromWhereLabel)
                    break;
            }
 
+           flushWriteBatch(TRUE);
+
            // See if we should trim silence from end of recording
            trimSilenceFromEndOfRecording();
 
-           updateWaveHeaderLengths(mFileDescriptor, mRecFormat);
-           if(mRecFormat == WAV_GSM && mLastEncodedFrameSize != 33)
+           MprRecorder::updateWaveHeaderLengths(mFileDescriptor, mRecFormat);
+           if(mRecFormat == MprRecorder::WAV_GSM && mLastEncodedFrameSize != 33)
            {
                    OsSysLog::add(FAC_MP, PRI_ERR,
                            "MprRecord::updateWaveHeaderLength last GSM frame written was: %d bytes, should be 33",
@@ -1592,14 +1975,14 @@ void MprRecorder::closeFile(const char* fromWhereLabel)
     else
     {
         OsSysLog::add(FAC_MP, PRI_DEBUG,
-                "MprRecorder::closeFile(%s) this: %p fd: %d already closed",
+                "MprRecorderJob::closeFile(%s) this: %p fd: %d already closed",
                 fromWhereLabel, this, mFileDescriptor);
     }
 
 }
 
 
-int MprRecorder::writeFileSilence(int numSamples)
+int MprRecorderJob::writeFileSilence(int numSamples)
 {
     assert(((int)MpMisc.mpFgSilence->getSamplesNumber()) >= numSamples);
     const MpAudioSample* silence[MAXIMUM_RECORDER_CHANNELS];
@@ -1608,10 +1991,10 @@ int MprRecorder::writeFileSilence(int numSamples)
     {
        silence[channelIndex] = MpMisc.mpFgSilence->getSamplesPtr();
     }
-    return(writeSamples(silence, numSamples, &MprRecorder::writeFile));
+    return(writeSamples(silence, numSamples, &MprRecorderJob::writeFile));
 }
 
-int MprRecorder::writeSamples(const MpAudioSample *pBuffers[], int numSamples, WriteMethod writeMethod)
+int MprRecorderJob::writeSamples(const MpAudioSample *pBuffers[], int numSamples, WriteMethod writeMethod)
 {
 #ifdef TEST_PRINT
     OsSysLog::add(FAC_MP, PRI_DEBUG,
@@ -1721,7 +2104,7 @@ int MprRecorder::writeSamples(const MpAudioSample *pBuffers[], int numSamples, W
 
         MpAudioSample interlacedBuffer[localBufferSize * MAXIMUM_RECORDER_CHANNELS];
         assert(sizeof(interlacedBuffer) >= (numResampled * sizeof(MpAudioSample) * mChannels));
-        int interlacedSize = interlaceSamples((const char**)resampledBufferPtrArray, numResampled, sizeof(MpAudioSample), mChannels, (char*)interlacedBuffer, sizeof(interlacedBuffer));
+        int interlacedSize = MprRecorder::interlaceSamples((const char**)resampledBufferPtrArray, numResampled, sizeof(MpAudioSample), mChannels, (char*)interlacedBuffer, sizeof(interlacedBuffer));
 
         assert(interlacedSize == (int)( numResampled * sizeof(MpAudioSample) * mChannels));
 
@@ -1737,7 +2120,7 @@ int MprRecorder::writeSamples(const MpAudioSample *pBuffers[], int numSamples, W
             // Opus encoder also does up/down sampling.  So we need
             // to correct the sample count for up/down sampling.  Opus
             // encodes at 48000.
-            numSamplesEncoded = numResampled * mpFlowGraph->getSamplesPerSec() / 48000;
+            numSamplesEncoded = numResampled * mSamplesPerSecond / 48000;
         }
 
         if(mpOpusStreamObject && mpOpusStreamObject->mBytesWritten > 0)
@@ -1771,7 +2154,7 @@ int MprRecorder::writeSamples(const MpAudioSample *pBuffers[], int numSamples, W
     // Depending upon the encoder framing, there may not always be stuff to write
     if(dataSize)
     {
-        if(mRecFormat == WAV_GSM)
+        if(mRecFormat == MprRecorder::WAV_GSM)
         {
             if(mLastEncodedFrameSize == 32 && dataSize == 32)
             {
@@ -1809,10 +2192,10 @@ int MprRecorder::writeSamples(const MpAudioSample *pBuffers[], int numSamples, W
     return(numSamplesEncoded);
 }
 
-int MprRecorder::writeFile(const char* channelData[], int dataSize)
+int MprRecorderJob::writeFile(const char* channelData[], int dataSize)
 {
     int bytesWritten = 0;
-    int bytesPerSample = getBytesPerSample(mRecFormat);
+    int bytesPerSample = MprRecorder::getBytesPerSample(mRecFormat);
 
     OsSysLog::add(FAC_MP, PRI_DEBUG,
             "MprRecorder::writeFile %d record format: %d mChannels: %d dataSize: %d bytes/sample: %d bytesPerSample",
@@ -1822,14 +2205,38 @@ int MprRecorder::writeFile(const char* channelData[], int dataSize)
              dataSize,
              bytesPerSample);
 
-    if(mWhenToInterlace == POST_ENCODE_INTERLACE)
+    if(mpWriter)
+    {
+        // In the writer thread, collect the data for a large write
+        char* batchEnd = mpWriteBatch + mWriteBatchLength;
+        int batchSpace = MPR_RECORDER_WRITE_BATCH_SIZE - mWriteBatchLength;
+        if(mWhenToInterlace == MprRecorder::POST_ENCODE_INTERLACE)
+        {
+            assert(bytesPerSample > 0 || mChannels == 1);
+            assert(batchSpace >= (dataSize * mChannels));
+            bytesWritten = MprRecorder::interlaceSamples(channelData, dataSize / bytesPerSample, bytesPerSample, mChannels, batchEnd, batchSpace);
+        }
+        else
+        {
+            assert(batchSpace >= dataSize);
+            memcpy(batchEnd, channelData[0], dataSize);
+            bytesWritten = dataSize;
+        }
+        mWriteBatchLength += bytesWritten;
+
+        if(mWriteBatchLength >= MPR_RECORDER_WRITE_SIZE && !flushWriteBatch(FALSE))
+        {
+            bytesWritten = -1;
+        }
+    }
+    else if(mWhenToInterlace == MprRecorder::POST_ENCODE_INTERLACE)
     {
         assert(bytesPerSample > 0 || mChannels == 1);
         char interlacedBuffer[1 << 14];
         assert(((int)sizeof(interlacedBuffer)) >= (dataSize * mChannels));
 
         // Interlace a sample from each channel
-        int interlacedSize = interlaceSamples(channelData, dataSize / bytesPerSample , bytesPerSample, mChannels, interlacedBuffer, sizeof(interlacedBuffer));
+        int interlacedSize = MprRecorder::interlaceSamples(channelData, dataSize / bytesPerSample , bytesPerSample, mChannels, interlacedBuffer, sizeof(interlacedBuffer));
 
 
         bytesWritten = write(mFileDescriptor, interlacedBuffer, interlacedSize);
@@ -1859,6 +2266,313 @@ int MprRecorder::writeFile(const char* channelData[], int dataSize)
     return(bytesWritten);
 }
 
+void MprRecorder::startWriter()
+{
+    mDroppedFrames = 0;
+    mDroppedSamples = 0;
+    mMaxQueuedFrames = 0;
+    mDropping = FALSE;
+
+    OsLock lock(sWritersMutex);
+    if(sNumWriters == 0)
+    {
+        return;
+    }
+
+    // Give the recording to the writer with the fewest
+    int writerIndex = 0;
+    for(int i = 1; i < sNumWriters; i++)
+    {
+        if(spWriters[i]->mNumJobs < spWriters[writerIndex]->mNumJobs)
+        {
+            writerIndex = i;
+        }
+    }
+
+    // Until detached, the writer sends the finish notification through us
+    mpJob->mpNextRecorderJob = mpWriterJobs;
+    mpWriterJobs = mpJob;
+    mpJob->startWriter(spWriters[writerIndex]);
+}
+
+void MprRecorderJob::startWriter(MprRecorderWriter* pWriter)
+{
+    // Each queued frame has room for a flowgraph frame of every channel
+    mpQueueSamples = new MpAudioSample[MPR_RECORDER_QUEUE_FRAMES * mChannels * mSamplesPerFrame];
+    mpQueueLengths = new int[MPR_RECORDER_QUEUE_FRAMES];
+    mpWriteBatch = new char[MPR_RECORDER_WRITE_BATCH_SIZE];
+
+    mpWriter = pWriter;
+    mpWriter->mNumJobs++;
+    mpWriter->addJob(this);
+}
+
+int MprRecorder::queueFrame(const MpAudioSample* pBuffers[], int numSamples)
+{
+    // Only the media task changes the tail
+    unsigned tail = mpJob->mQueueTail;
+    unsigned queued = tail - mpJob->loadShared(mpJob->mQueueHead);
+
+    if(queued >= MPR_RECORDER_QUEUE_FRAMES || numSamples > mpJob->mSamplesPerFrame)
+    {
+        mDroppedFrames++;
+        mDroppedSamples += numSamples;
+        if(!mDropping)
+        {
+            mDropping = TRUE;
+            OsSysLog::add(FAC_MP, PRI_WARNING,
+                          "MprRecorder::queueFrame %s dropping frames, writer queue has %u frames, %d dropped",
+                          getName().data(), queued, mDroppedFrames);
+            MprnIntMsg msg(MpResNotificationMsg::MPRNM_RECORDER_FRAMES_DROPPED,
+                           getName(),
+                           mDroppedFrames);
+            sendNotification(msg);
+        }
+
+        // The frame is not an error, the recording goes on
+        return(numSamples);
+    }
+    mDropping = FALSE;
+
+    int slot = tail % MPR_RECORDER_QUEUE_FRAMES;
+    int frameSamples = mpJob->mSamplesPerFrame;
+    if(pBuffers)
+    {
+        MpAudioSample* slotSamples = mpJob->mpQueueSamples + slot * mpJob->mChannels * frameSamples;
+        for(int channelIndex = 0; channelIndex < mpJob->mChannels; channelIndex++)
+        {
+            memcpy(slotSamples + channelIndex * frameSamples,
+                   pBuffers[channelIndex],
+                   numSamples * sizeof(MpAudioSample));
+        }
+        mpJob->mpQueueLengths[slot] = numSamples;
+    }
+    else
+    {
+        mpJob->mpQueueLengths[slot] = -numSamples;
+    }
+    mpJob->storeShared(mpJob->mQueueTail, tail + 1);
+
+    if((int)queued + 1 > mMaxQueuedFrames)
+    {
+        mMaxQueuedFrames = queued + 1;
+    }
+
+    // The writer only needs waking if it may have found the queue empty.
+    // The head is loaded again after the tail is stored, so either this
+    // sees the last head stored by the writer or the writer sees this frame.
+    if(mpJob->loadShared(mpJob->mQueueHead) == tail)
+    {
+        mpJob->mpWriter->wake();
+    }
+
+    return(numSamples);
+}
+
+UtlBoolean MprRecorderJob::writeQueuedFrames()
+{
+    if(!mWriterStarted)
+    {
+        mWriterStarted = TRUE;
+        if(mWriteWaveHeader &&
+           !MprRecorder::writeWaveHeader(mFileDescriptor, mRecFormat, mWaveHeaderSampleRate, mChannels))
+        {
+            storeShared(mWriterFailed, TRUE);
+        }
+        mWriteBatchOffset = lseek(mFileDescriptor, 0, SEEK_CUR);
+    }
+
+    // All frames are queued once closing is set, so load it before the tail
+    UtlBoolean closing = loadShared(mWriterClosing);
+    UtlBoolean failed = loadShared(mWriterFailed);
+    unsigned head = mQueueHead;
+    unsigned tail;
+    while(head != (tail = loadShared(mQueueTail)))
+    {
+        for(; head != tail; head++)
+        {
+            // After a failure the frames are only taken off the queue
+            int slot = head % MPR_RECORDER_QUEUE_FRAMES;
+            int numSamples = mpQueueLengths[slot];
+            if(failed)
+            {
+                continue;
+            }
+
+            int numWritten;
+            if(numSamples < 0)
+            {
+                numSamples = -numSamples;
+                numWritten = writeFileSilence(numSamples);
+            }
+            else
+            {
+                const MpAudioSample* samplesPtrArray[MAXIMUM_RECORDER_CHANNELS];
+                const MpAudioSample* slotSamples = mpQueueSamples + slot * mChannels * mSamplesPerFrame;
+                for(int channelIndex = 0; channelIndex < mChannels; channelIndex++)
+                {
+                    samplesPtrArray[channelIndex] = slotSamples + channelIndex * mSamplesPerFrame;
+                }
+                numWritten = writeSamples(samplesPtrArray, numSamples, &MprRecorderJob::writeFile);
+            }
+
+            if(numWritten != numSamples || loadShared(mWriterFailed))
+            {
+                OsSysLog::add(FAC_MP, PRI_ERR,
+                              "MprRecorderJob::writeQueuedFrames %s numWritten (%d) != numSamples (%d) channels=%d",
+                              mName.data(), numWritten, numSamples, mChannels);
+                storeShared(mWriterFailed, TRUE);
+                failed = TRUE;
+            }
+        }
+        storeShared(mQueueHead, head);
+    }
+
+    if(!closing)
+    {
+        return(FALSE);
+    }
+
+    closeFile("writer");
+
+    // The recorder cannot be detached, and so destroyed, while notifying.
+    // The job is no longer counted once notified, so setWriterThreads()
+    // can stop the writer as soon as the recording is seen to finish.
+    OsLock lock(sWritersMutex);
+    mpWriter->mNumJobs--;
+    if(mpRecorder)
+    {
+        if(mWriterNotify)
+        {
+            mpRecorder->sendFinishNotification(loadShared(mWriterFailed) ? MprRecorder::FINISHED_ERROR : mWriterFinishCause,
+                                               mWriterSamplesRecorded);
+        }
+
+        MprRecorderJob** ppJob = &mpRecorder->mpWriterJobs;
+        while(*ppJob != this)
+        {
+            ppJob = &(*ppJob)->mpNextRecorderJob;
+        }
+        *ppJob = mpNextRecorderJob;
+        mpRecorder = NULL;
+    }
+
+    return(TRUE);
+}
+
+void MprRecorder::abandonJob()
+{
+    if(mpJob == NULL)
+    {
+        return;
+    }
+
+    OsSysLog::add(FAC_MP, PRI_WARNING,
+                  "MprRecorder::abandonJob %s closing unfinished recording",
+                  getName().data());
+    mState = STATE_IDLE;
+    mRecordDestination = TO_UNDEFINED;
+
+    mpJob->mConsecutiveInactive = mConsecutiveInactive;
+    if(mpJob->mpWriter)
+    {
+        // Only the media task reads the notify flag before closing is set
+        mpJob->mWriterNotify = FALSE;
+        mpJob->wakeWriterToClose();
+    }
+    else
+    {
+        mpJob->closeFile("abandonJob");
+        delete mpJob;
+    }
+    mpJob = NULL;
+}
+
+void MprRecorder::detachWriterJobs()
+{
+    OsLock lock(sWritersMutex);
+    while(mpWriterJobs)
+    {
+        MprRecorderJob* pJob = mpWriterJobs;
+        mpWriterJobs = pJob->mpNextRecorderJob;
+        pJob->mpNextRecorderJob = NULL;
+        pJob->mpRecorder = NULL;
+    }
+}
+
+void MprRecorderJob::wakeWriterToClose()
+{
+    // The writer cannot be stopped by setWriterThreads() before it is woken,
+    // as it keeps the recording until it has seen closing.
+    OsLock lock(sWritersMutex);
+    storeShared(mWriterClosing, TRUE);
+    mpWriter->wake();
+}
+
+UtlBoolean MprRecorderJob::flushWriteBatch(UtlBoolean all)
+{
+    if(mpWriter == NULL || mWriteBatchLength == 0)
+    {
+        return(TRUE);
+    }
+
+    // Unless all is written, stop at the last aligned offset and keep the
+    // rest to start the next write with.
+    int length = mWriteBatchLength;
+    if(!all)
+    {
+        int64_t alignedEnd = (mWriteBatchOffset + mWriteBatchLength) -
+                             (mWriteBatchOffset + mWriteBatchLength) % MPR_RECORDER_WRITE_ALIGNMENT;
+        length = (int)(alignedEnd - mWriteBatchOffset);
+        if(length <= 0)
+        {
+            return(TRUE);
+        }
+    }
+
+    int written = 0;
+    while(written < length)
+    {
+        int result = write(mFileDescriptor, mpWriteBatch + written, length - written);
+        if(result <= 0)
+        {
+            OsSysLog::add(FAC_MP, PRI_ERR,
+                          "MprRecorderJob::flushWriteBatch write fd: %d returned: %d errno: %d (%s)",
+                          mFileDescriptor, result, errno, strerror(errno));
+            storeShared(mWriterFailed, TRUE);
+            mWriteBatchLength = 0;
+            return(FALSE);
+        }
+        written += result;
+    }
+
+    memmove(mpWriteBatch, mpWriteBatch + length, mWriteBatchLength - length);
+    mWriteBatchLength -= length;
+    mWriteBatchOffset += length;
+
+    return(TRUE);
+}
+
+unsigned MprRecorderJob::loadShared(const volatile unsigned& value)
+{
+#ifdef MPRRECORDER_LOCK_FREE
+    return(__atomic_load_n(&value, __ATOMIC_SEQ_CST));
+#else
+    OsLock lock(mQueueMutex);
+    return(value);
+#endif
+}
+
+void MprRecorderJob::storeShared(volatile unsigned& value, unsigned newValue)
+{
+#ifdef MPRRECORDER_LOCK_FREE
+    __atomic_store_n(&value, newValue, __ATOMIC_SEQ_CST);
+#else
+    OsLock lock(mQueueMutex);
+    value = newValue;
+#endif
+}
+
 int MprRecorder::interlaceSamples(const char* samplesArrays[], int samplesPerChannel, int bytesPerSample, int channels, char* interlacedChannelSamplesArray, int interlacedArrayMaximum)
 {
     int totalWritten = 0;
@@ -1907,7 +2621,7 @@ int MprRecorder::writeBufferSpeech(const MpAudioSample *pBuffer, int numSamples)
    return toWrite;
 }
 
-int MprRecorder::writeCircularBufferSilence(int numSamples)
+int MprRecorderJob::writeCircularBufferSilence(int numSamples)
 {
     assert(((int)MpMisc.mpFgSilence->getSamplesNumber()) >= numSamples);
     const MpAudioSample* silence[MAXIMUM_RECORDER_CHANNELS];
@@ -1916,7 +2630,7 @@ int MprRecorder::writeCircularBufferSilence(int numSamples)
     {
        silence[channelIndex] = MpMisc.mpFgSilence->getSamplesPtr();
     }
-    return writeSamples(silence, numSamples, &MprRecorder::writeCircularBuffer);
+    return writeSamples(silence, numSamples, &MprRecorderJob::writeCircularBuffer);
 }
 
 int16_t MprRecorder::getBytesPerSample(RecordFileFormat format)
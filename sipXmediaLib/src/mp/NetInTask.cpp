@@ -45,11 +45,21 @@
 #include <sys/time.h>
 #endif /* __pingtel_on_posix__ ] */
 
+#ifdef NET_IN_TASK_USE_EPOLL /* [ */
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <utl/UtlVoidPtr.h>
+#include <utl/UtlHashMapIterator.h>
+#endif /* NET_IN_TASK_USE_EPOLL ] */
+
 // APPLICATION INCLUDES
 #include <os/OsDefs.h>
 #include <os/OsTask.h>
 #include <os/OsServerSocket.h>
 #include <os/OsConnectionSocket.h>
+#include <os/OsDatagramSocket.h>
 #include <os/OsEvent.h>
 #include <mp/NetInTask.h>
 #include <mp/MpUdpBuf.h>
@@ -367,6 +377,9 @@ OsStatus NetInTask::destroy()
 
 int NetInTask::run(void *pNotUsed)
 {
+#ifdef NET_IN_TASK_USE_EPOLL /* [ */
+        return runEpoll();
+#else /* NET_IN_TASK_USE_EPOLL ] [ */
         fd_set fdset;
         fd_set *fds;
         int     last;
@@ -657,8 +670,393 @@ int NetInTask::run(void *pNotUsed)
                 "NetInTask::run exiting mpReadSocket: %p mpReadSocket->isOk() = %s",
                 mpReadSocket, mpReadSocket ? (mpReadSocket->isOk() ? "true" : "false") : "N/A");
         return 0;
+#endif /* NET_IN_TASK_USE_EPOLL ] */
+}
+
+#ifdef NET_IN_TASK_USE_EPOLL /* [ */
+
+int NetInTask::runEpoll()
+{
+   struct epoll_event events[NET_TASK_EPOLL_EVENTS];
+   struct epoll_event cmdEvent;
+   netInTaskMsg msg;
+   int ostc;
+
+   mNumFdPairs = 0;
+
+   // The command socket is level-triggered and marked by a NULL source:
+   // one message is read per wakeup, as reading it dry would close it.
+   memset(&cmdEvent, 0, sizeof(cmdEvent));
+   cmdEvent.events = EPOLLIN;
+   cmdEvent.data.ptr = NULL;
+   if (mEpollFd < 0 ||
+       epoll_ctl(mEpollFd, EPOLL_CTL_ADD,
+                 mpReadSocket->getSocketDescriptor(), &cmdEvent) < 0)
+   {
+      OsSysLog::add(FAC_MP, PRI_ERR,
+                    " *** NetInTask: cannot set up epoll (fd %d), errno=%d. Quitting!",
+                    mEpollFd, errno);
+      return 0;
+   }
+
+   while (mpReadSocket && mpReadSocket->isOk())
+   {
+      // Do not sleep while some sockets are known to hold packets.
+      RTL_EVENT("NetInTask.run", 0);
+      int numReady = epoll_wait(mEpollFd, events, NET_TASK_EPOLL_EVENTS,
+                                mpBacklog ? 0 : -1);
+      RTL_EVENT("NetInTask.run", 1);
+      ostc = *pOsTC;
+      if (0 > numReady)
+      {
+         if (EINTR == errno)
+         {
+            continue;
+         }
+         OsSysLog::add(FAC_MP, PRI_ERR,
+                       " *** NetInTask: epoll_wait returned %d, errno=%d. Quitting!",
+                       numReady, errno);
+         break;
+      }
+
+      // Sockets left with packets on the previous pass go first.  Sockets
+      // which still are not drained afterwards go back in the backlog.
+      NetInSource* pSource = mpBacklog;
+      mpBacklog = NULL;
+      while (pSource)
+      {
+         NetInSource* pNext = pSource->pNextInBacklog;
+         pSource->inBacklog = false;
+         pSource->pNextInBacklog = NULL;
+         if (pSource->pSocket)
+         {
+            readSource(*pSource, ostc);
+         }
+         pSource = pNext;
+      }
+
+      // Pairs are only freed when a command is handled, so every source
+      // returned by epoll_wait() is still valid here.
+      UtlBoolean commandReady = FALSE;
+      for (int i = 0; i < numReady; i++)
+      {
+         pSource = (NetInSource*) events[i].data.ptr;
+         if (NULL == pSource)
+         {
+            commandReady = TRUE;
+         }
+         else if (pSource->pSocket && !pSource->inBacklog)
+         {
+            readSource(*pSource, ostc);
+         }
+      }
+
+      if (commandReady)
+      {
+         int readBytes;
+
+         getLockObj().acquireWrite();
+         readBytes = mpReadSocket->read((char *) &msg, NET_TASK_MAX_MSG_LEN);
+         getLockObj().releaseWrite();
+
+         if (NET_TASK_MAX_MSG_LEN != readBytes)
+         {
+            OsSysLog::add(FAC_MP, PRI_DEBUG,
+                          "NetInTask::runEpoll read %d from mpReadSocket socket: %p descriptor: %d errno: %d",
+                          readBytes, mpReadSocket, mpReadSocket ? mpReadSocket->getSocketDescriptor() : -111, errno);
+         }
+         else
+         {
+            handleEpollCommand(msg);
+         }
+      }
+   }
+
+   OsSysLog::add(FAC_MP, PRI_DEBUG,
+                 "NetInTask::runEpoll exiting mpReadSocket: %p mpReadSocket->isOk() = %s",
+                 mpReadSocket, mpReadSocket ? (mpReadSocket->isOk() ? "true" : "false") : "N/A");
+   return 0;
 }
 
+void NetInTask::handleEpollCommand(const netInTaskMsg& msg)
+{
+   if (-2 == (intptr_t) msg.pRtpSocket)
+   {
+      /* request to exit... */
+      OsSysLog::add(FAC_MP, PRI_DEBUG, " *** NetInTask: closing pipeFd (%d)\n",
+                    mpReadSocket->getSocketDescriptor());
+      getLockObj().acquireWrite();
+      if (mpReadSocket)
+      {
+         epoll_ctl(mEpollFd, EPOLL_CTL_DEL,
+                   mpReadSocket->getSocketDescriptor(), NULL);
+         mpReadSocket->close();
+         delete mpReadSocket;
+         mpReadSocket = NULL;
+      }
+      getLockObj().releaseWrite();
+   }
+   else if (NULL == msg.fwdTo)
+   {
+      osPrintf("NetInTask::run msg with NULL FromNet\n");
+   }
+   else if ((NULL != msg.pRtpSocket) || (NULL != msg.pRtcpSocket))
+   {
+      /* add a new pair of sockets */
+      UtlVoidPtr key(msg.fwdTo);
+      if (mSourcePairs.contains(&key))
+      {
+         OsSysLog::add(FAC_MP, PRI_ERR,
+                       " *** NetInTask: receiver %p already has RTP/RTCP sockets, not adding (RTP:%p, RTCP:%p)",
+                       msg.fwdTo, msg.pRtpSocket, msg.pRtcpSocket);
+      }
+      else
+      {
+         NetInSourcePair* pPair = new NetInSourcePair;
+         memset(pPair, 0, sizeof(NetInSourcePair));
+
+         // Clear out any packets residing in the socket's buffer to
+         // prevent our dejitter from a burst of packets on startup.
+         if (msg.pRtpSocket)
+         {
+            flushReadQueue(msg.pRtpSocket);
+            addSource(pPair->rtp, msg.pRtpSocket, msg.fwdTo, false);
+         }
+         if (msg.pRtcpSocket)
+         {
+            flushReadQueue(msg.pRtcpSocket);
+            addSource(pPair->rtcp, msg.pRtcpSocket, msg.fwdTo, true);
+         }
+         mSourcePairs.insertKeyAndValue(new UtlVoidPtr(msg.fwdTo),
+                                        new UtlVoidPtr(pPair));
+         mNumFdPairs++;
+
+         OsSysLog::add(FAC_MP, PRI_DEBUG,
+                       " *** NetInTask: Add socket Fds:"
+                       " RTP=%p, RTCP=%p, receiver=%p\n",
+                       msg.pRtpSocket, msg.pRtcpSocket, msg.fwdTo);
+      }
+
+      if (NULL != msg.notify)
+      {
+         msg.notify->signal(0);
+      }
+   }
+   else
+   {
+      /* remove a pair of sockets */
+      UtlVoidPtr key(msg.fwdTo);
+      UtlContainable* pPairValue = NULL;
+      UtlContainable* pKey = mSourcePairs.removeKeyAndValue(&key, pPairValue);
+      if (pKey)
+      {
+         NetInSourcePair* pPair =
+            (NetInSourcePair*) ((UtlVoidPtr*) pPairValue)->getValue();
+         OsSysLog::add(FAC_MP, PRI_DEBUG,
+                       " *** NetInTask: Remove socket Fds:"
+                       " RTP=%p, RTCP=%p, receiver=%p\n",
+                       pPair->rtp.pSocket, pPair->rtcp.pSocket, msg.fwdTo);
+         removeSource(pPair->rtp);
+         removeSource(pPair->rtcp);
+         delete pPair;
+         delete pPairValue;
+         delete pKey;
+         mNumFdPairs--;
+      }
+
+      if (NULL != msg.notify)
+      {
+         msg.notify->signal(0);
+      }
+   }
+}
+
+void NetInTask::addSource(NetInSource& rSource, OsSocket* pSocket,
+                          MprFromNet* fwdTo, bool isRtcp)
+{
+   struct epoll_event event;
+
+   rSource.pSocket = pSocket;
+   rSource.fwdTo = fwdTo;
+   rSource.isRtcp = isRtcp;
+   rSource.rawReads = pSocket->hasRawReads();
+   rSource.fd = pSocket->getSocketDescriptor();
+   rSource.inBacklog = false;
+   rSource.pNextInBacklog = NULL;
+
+   memset(&event, 0, sizeof(event));
+   event.events = EPOLLIN | EPOLLET;
+   event.data.ptr = &rSource;
+   if (0 > rSource.fd ||
+       0 > epoll_ctl(mEpollFd, EPOLL_CTL_ADD, rSource.fd, &event))
+   {
+      OsSysLog::add(FAC_MP, PRI_ERR,
+                    " *** NetInTask: cannot listen to %s socket %p, descriptor %d, errno=%d",
+                    isRtcp ? "RTCP" : "RTP", pSocket, rSource.fd, errno);
+      rSource.pSocket = NULL;
+      return;
+   }
+
+   // Packets which arrived since the flush will not raise an edge, so
+   // give the socket a first turn right away.
+   rSource.inBacklog = true;
+   rSource.pNextInBacklog = mpBacklog;
+   mpBacklog = &rSource;
+}
+
+void NetInTask::removeSource(NetInSource& rSource)
+{
+   if (rSource.pSocket)
+   {
+      // The socket may already be closed, so errors are expected here.
+      epoll_ctl(mEpollFd, EPOLL_CTL_DEL, rSource.fd, NULL);
+      rSource.pSocket = NULL;
+   }
+
+   if (rSource.inBacklog)
+   {
+      NetInSource** ppLink = &mpBacklog;
+      while (*ppLink != &rSource)
+      {
+         ppLink = &(*ppLink)->pNextInBacklog;
+      }
+      *ppLink = rSource.pNextInBacklog;
+      rSource.inBacklog = false;
+      rSource.pNextInBacklog = NULL;
+   }
+}
+
+void NetInTask::readSource(NetInSource& rSource, int ostc)
+{
+   OsStatus stat = OS_SUCCESS;
+   bool drained = false;
+   int quota = NET_TASK_RECV_QUOTA;
+
+   // The socket is edge-triggered, so it must be read until it is empty
+   // or it must go in the backlog.
+   while (OS_SUCCESS == stat && !drained && 0 < quota)
+   {
+      int numRead = 1;
+      if (rSource.rawReads)
+      {
+         stat = recvBatch(rSource, sipx_min(quota, NET_TASK_RECV_BATCH), ostc,
+                          numRead, drained);
+      }
+      else if (rSource.pSocket->isReadyToRead(0))
+      {
+         // read() has to see every packet (STUN, TURN, SRTP...).
+         stat = get1Msg(rSource.pSocket, rSource.fwdTo, rSource.isRtcp, ostc);
+      }
+      else
+      {
+         drained = true;
+      }
+      quota -= numRead;
+   }
+
+   if (OS_SUCCESS != stat)
+   {
+      OsSysLog::add(FAC_MP, PRI_ERR,
+                    " *** NetInTask: removing %s pSkt=%p due to read error.\n",
+                    rSource.isRtcp ? "RTCP" : "RTP", rSource.pSocket);
+      removeSource(rSource);
+   }
+   else if (!drained && !rSource.inBacklog)
+   {
+      rSource.inBacklog = true;
+      rSource.pNextInBacklog = mpBacklog;
+      mpBacklog = &rSource;
+   }
+}
+
+OsStatus NetInTask::recvBatch(NetInSource& rSource, int maxPackets, int ostc,
+                              int& numRead, bool& drained)
+{
+   MpUdpBufPtr buffers[NET_TASK_RECV_BATCH];
+   char* packetBuffers[NET_TASK_RECV_BATCH];
+   int packetLengths[NET_TASK_RECV_BATCH];
+   struct in_addr fromIps[NET_TASK_RECV_BATCH];
+   int fromPorts[NET_TASK_RECV_BATCH];
+   int numBuffers;
+   int received;
+
+   numRead = 0;
+   drained = false;
+
+   // Get buffers for incoming packets
+   for (numBuffers = 0; numBuffers < maxPackets; numBuffers++)
+   {
+      buffers[numBuffers] = MpMisc.UdpPool->getBuffer();
+      if (!buffers[numBuffers].isValid())
+      {
+         break;
+      }
+      packetBuffers[numBuffers] = buffers[numBuffers]->getDataWritePtr();
+   }
+
+   if (0 == numBuffers)
+   {
+      // Flush packet if could not get buffer for it.
+      char junk[UDP_MTU];
+      do
+      {
+         received = recv(rSource.fd, junk, UDP_MTU, MSG_DONTWAIT);
+      } while (0 > received && EINTR == errno);
+
+      if (0 <= received)
+      {
+         numRead = 1;
+         if (mNumFlushed++ < 10)
+         {
+            Zprintf("recvBatch: flushing a packet! (%d, %d, %d)"
+                    " (after %d DMA frames).\n",
+                    received, errno, (int) rSource.fd, showFrameCount(1), 0,0);
+         }
+         return OS_SUCCESS;
+      }
+      if (EAGAIN == errno || EWOULDBLOCK == errno)
+      {
+         drained = true;
+         return OS_SUCCESS;
+      }
+   }
+   else
+   {
+      // The buffers all come from the same pool, so are all the same size.
+      received = OsDatagramSocket::recvBatch(rSource.fd, packetBuffers,
+                                             buffers[0]->getMaximumPacketSize(),
+                                             numBuffers, packetLengths,
+                                             fromIps, fromPorts);
+      if (0 <= received)
+      {
+         for (int i = 0; i < received; i++)
+         {
+            if (0 < packetLengths[i])
+            {
+               buffers[i]->setPacketSize(packetLengths[i]);
+               buffers[i]->setIP(fromIps[i]);
+               buffers[i]->setUdpPort(fromPorts[i]);
+               buffers[i]->setTimecode(ostc);
+
+               RTL_BLOCK("NetInTask.pushPacket");
+               rSource.fwdTo->pushPacket(buffers[i], rSource.isRtcp);
+            }
+         }
+         // A short batch means the socket ran out of packets.
+         numRead = received;
+         drained = (received < numBuffers);
+         return OS_SUCCESS;
+      }
+   }
+
+   OsSysLog::add(FAC_MP, PRI_DEBUG,
+                 "NetInTask::recvBatch read error from socket: %p descriptor: %d errno: %d",
+                 rSource.pSocket, rSource.fd, errno);
+   return OS_NO_MORE_DATA;
+}
+
+#endif /* NET_IN_TASK_USE_EPOLL ] */
+
 NetInTask* NetInTask::getNetInTask()
 {
    UtlBoolean isStarted;
@@ -722,6 +1120,11 @@ NetInTask::NetInTask(int prio, int options, int stack)
    mFlushedLimit(DEFAULT_FLUSHED_LIMIT),
    mUseInstanceLock(false)
 {
+#ifdef NET_IN_TASK_USE_EPOLL /* [ */
+    mEpollFd = epoll_create1(EPOLL_CLOEXEC);
+    mpBacklog = NULL;
+#endif /* NET_IN_TASK_USE_EPOLL ] */
+
     // Create temporary listening socket.
     OsServerSocket *pBindSocket = new OsServerSocket(1, PORT_DEFAULT, "127.0.0.1");
     RTL_EVENT("NetInTask::NetInTask", 1);
@@ -759,6 +1162,20 @@ NetInTask::~NetInTask()
 {
    waitUntilShutDown();
    spInstance = NULL;
+
+#ifdef NET_IN_TASK_USE_EPOLL /* [ */
+   UtlHashMapIterator iterator(mSourcePairs);
+   while (iterator())
+   {
+      delete (NetInSourcePair*) ((UtlVoidPtr*) iterator.value())->getValue();
+   }
+   mSourcePairs.destroyAll();
+
+   if (0 <= mEpollFd)
+   {
+      ::close(mEpollFd);
+   }
+#endif /* NET_IN_TASK_USE_EPOLL ] */
 }
 
 OsStatus NetInTask::addNetInputSources(OsSocket* pRtpSocket, OsSocket* pRtcpSocket,
@@ -12,10 +12,7 @@
 // APPLICATION INCLUDES
 #include <mp/codecs/PlgDefsV1.h>
 #ifndef USE_BUGGY_G711 // [
-#  ifdef _MSC_VER // [
-#     define __inline__ __inline // For gcc compatibility
-#   endif // _MSC_VER ]
-#  include <spandsp/g711.h>
+#  include "G711Tables.h"
 #endif // !USE_BUGGY_G711 ]
 
 // EXTERNAL VARIABLES
@@ -81,6 +78,10 @@ CODEC_API void *PLG_INIT_V1_2(sipxPcma)(const char* fmtp, int isDecoder,
    pCodecInfo->vadCng = CODEC_CNG_NONE;
    pCodecInfo->algorithmicDelay = 0;
 
+#ifndef USE_BUGGY_G711 // [
+   sipxG711TablesInit();
+#endif // !USE_BUGGY_G711 ]
+
    if (isDecoder)
       return DECODER_HANDLE;
    else
@@ -114,15 +115,7 @@ CODEC_API int PLG_DECODE_V1(sipxPcma)(void* handle, const void* pCodedData,
 #ifdef USE_BUGGY_G711 // [
    G711A_Decoder(samples, (uint8_t*)pCodedData, (MpAudioSample *)pAudioBuffer);
 #else // USE_BUGGY_G711 ][
-   {
-      int16_t *pSamples = (int16_t*)pAudioBuffer;
-      uint8_t *pEncoded = (uint8_t*)pCodedData;
-      int i;
-      for (i=0; i<samples; i++)
-      {
-         pSamples[i] = alaw_to_linear(pEncoded[i]);
-      }
-   }
+   sipxG711AlawToLinear((const uint8_t*)pCodedData, (int16_t*)pAudioBuffer, samples);
 #endif // USE_BUGGY_G711 ]
    *pcbCodedSize = samples;
 
@@ -140,15 +133,7 @@ CODEC_API int PLG_ENCODE_V1(sipxPcma)(void* handle, const void* pAudioBuffer,
 #ifdef USE_BUGGY_G711 // [
    G711A_Encoder(cbAudioSamples, (MpAudioSample *)pAudioBuffer, (uint8_t*)pCodedData);
 #else // USE_BUGGY_G711 ][
-   {
-      int16_t *pSamples = (int16_t*)pAudioBuffer;
-      uint8_t *pEncoded = (uint8_t*)pCodedData;
-      unsigned i;
-      for (i=0; i<cbAudioSamples; i++)
-      {
-         pEncoded[i] = linear_to_alaw(pSamples[i]);
-      }
-   }
+   sipxG711LinearToAlaw((const int16_t*)pAudioBuffer, (uint8_t*)pCodedData, cbAudioSamples);
 #endif // USE_BUGGY_G711 ]
    *pcbCodedSize = cbAudioSamples;
 
@@ -0,0 +1,110 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+// APPLICATION INCLUDES
+#include "G711Tables.h"
+#ifdef _MSC_VER // [
+#  define __inline__ __inline // For gcc compatibility
+#endif // _MSC_VER ]
+#include <spandsp/g711.h>
+
+// DEFINES
+// u-law quantizes the biased magnitude in steps of 8 or more, and the bias
+// (0x84) is a multiple of 4, so the two low bits of the magnitude never
+// matter.  With the sign taken out that leaves 13 bits (and 32768 itself).
+#define ULAW_INDEX_SHIFT   2
+#define ULAW_TABLE_SIZE    ((32768 >> ULAW_INDEX_SHIFT) + 1)
+// A-law quantizes the one's complement magnitude in steps of 16 or more.
+#define ALAW_INDEX_SHIFT   4
+#define ALAW_TABLE_SIZE    (32768 >> ALAW_INDEX_SHIFT)
+
+// STATIC VARIABLE INITIALIZATIONS
+static volatile int sTablesInitialized = 0;
+static uint8_t sUlawEncode[ULAW_TABLE_SIZE]; ///< u-law code of a positive magnitude, before the sign mask.
+static uint8_t sAlawEncode[ALAW_TABLE_SIZE]; ///< A-law code of a positive magnitude, before the sign mask.
+static int16_t sUlawDecode[256];
+static int16_t sAlawDecode[256];
+
+/* ============================== FUNCTIONS =============================== */
+
+void sipxG711TablesInit(void)
+{
+   int i;
+
+   if (sTablesInitialized)
+   {
+      return;
+   }
+
+   // The tables are filled from the SpanDSP functions, so the codes are the
+   // same as they were one sample at a time.
+   for (i = 0; i < ULAW_TABLE_SIZE; i++)
+   {
+      sUlawEncode[i] = linear_to_ulaw(i << ULAW_INDEX_SHIFT) ^ 0xFF;
+   }
+   for (i = 0; i < ALAW_TABLE_SIZE; i++)
+   {
+      sAlawEncode[i] = linear_to_alaw(i << ALAW_INDEX_SHIFT) ^ (ALAW_AMI_MASK | 0x80);
+   }
+   for (i = 0; i < 256; i++)
+   {
+      sUlawDecode[i] = ulaw_to_linear((uint8_t)i);
+      sAlawDecode[i] = alaw_to_linear((uint8_t)i);
+   }
+
+   sTablesInitialized = 1;
+}
+
+void sipxG711LinearToUlaw(const int16_t* pSamples, uint8_t* pEncoded,
+                          unsigned numSamples)
+{
+   unsigned i;
+   for (i = 0; i < numSamples; i++)
+   {
+      // sign is 0 for positive samples and -1 for negative ones, so this
+      // has no branch to mispredict on audio.
+      int sample = pSamples[i];
+      int sign = sample >> 15;
+      int magnitude = (sample ^ sign) - sign;
+      pEncoded[i] = sUlawEncode[magnitude >> ULAW_INDEX_SHIFT] ^ (0xFF ^ (sign & 0x80));
+   }
+}
+
+void sipxG711UlawToLinear(const uint8_t* pEncoded, int16_t* pSamples,
+                          unsigned numSamples)
+{
+   unsigned i;
+   for (i = 0; i < numSamples; i++)
+   {
+      pSamples[i] = sUlawDecode[pEncoded[i]];
+   }
+}
+
+void sipxG711LinearToAlaw(const int16_t* pSamples, uint8_t* pEncoded,
+                          unsigned numSamples)
+{
+   unsigned i;
+   for (i = 0; i < numSamples; i++)
+   {
+      // A-law takes the one's complement of negative samples.
+      int sample = pSamples[i];
+      int sign = sample >> 15;
+      int magnitude = sample ^ sign;
+      pEncoded[i] = sAlawEncode[magnitude >> ALAW_INDEX_SHIFT] ^ (ALAW_AMI_MASK | (~sign & 0x80));
+   }
+}
+
+void sipxG711AlawToLinear(const uint8_t* pEncoded, int16_t* pSamples,
+                          unsigned numSamples)
+{
+   unsigned i;
+   for (i = 0; i < numSamples; i++)
+   {
+      pSamples[i] = sAlawDecode[pEncoded[i]];
+   }
+}
@@ -0,0 +1,70 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _G711Tables_h_
+#define _G711Tables_h_
+
+// SYSTEM INCLUDES
+// APPLICATION INCLUDES
+#include <mp/codecs/PlgDefsV1.h>
+
+// DEFINES
+// MACROS
+// EXTERNAL FUNCTIONS
+// EXTERNAL VARIABLES
+// CONSTANTS
+// STRUCTS
+// TYPEDEFS
+// FORWARD DECLARATIONS
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+*  @brief Fill the G.711 conversion tables, if not done yet.
+*
+*  Must be called before any of the frame conversion functions below, when
+*  a codec instance is created.
+*/
+void sipxG711TablesInit(void);
+
+/**
+*  @brief Convert a frame of 16-bit linear samples to u-law.
+*
+*  Gives the same codes as linear_to_ulaw() of SpanDSP, which is the per
+*  sample version.
+*/
+void sipxG711LinearToUlaw(const int16_t* pSamples, uint8_t* pEncoded,
+                          unsigned numSamples);
+
+/**
+*  @brief Convert a frame of u-law codes to 16-bit linear samples.
+*/
+void sipxG711UlawToLinear(const uint8_t* pEncoded, int16_t* pSamples,
+                          unsigned numSamples);
+
+/**
+*  @brief Convert a frame of 16-bit linear samples to A-law.
+*
+*  Gives the same codes as linear_to_alaw() of SpanDSP, which is the per
+*  sample version.
+*/
+void sipxG711LinearToAlaw(const int16_t* pSamples, uint8_t* pEncoded,
+                          unsigned numSamples);
+
+/**
+*  @brief Convert a frame of A-law codes to 16-bit linear samples.
+*/
+void sipxG711AlawToLinear(const uint8_t* pEncoded, int16_t* pSamples,
+                          unsigned numSamples);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // _G711Tables_h_
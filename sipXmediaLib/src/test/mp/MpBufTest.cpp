@@ -12,11 +12,78 @@
 
 #include <sipxunittests.h>
 
+#include <os/OsTask.h>
+#include <os/OsDateTime.h>
 #include <mp/MpBuf.h>
 #include <mp/MpArrayBuf.h>
 #include <mp/MpDataBuf.h>
 #include <mp/MpAudioBuf.h>
 
+#define CONTENTION_BUFFERS_PER_ITERATION  4
+#define CONTENTION_ITERATIONS             50000
+#define CONTENTION_MAX_THREADS            8
+
+/// Task getting and releasing buffers of a pool shared with other tasks.
+class MpBufTestTask : public OsTask
+{
+public:
+   MpBufTestTask(MpBufPool *pPool, int iterations, const MpBufPtr *pShared)
+   : mpPool(pPool)
+   , mIterations(iterations)
+   , mpShared(pShared)
+   , mFailures(0)
+   {
+   }
+
+   ~MpBufTestTask()
+   {
+      waitUntilShutDown();
+   }
+
+   UtlBoolean waitUntilShutDown()
+   {
+      return OsTask::waitUntilShutDown();
+   }
+
+   int run(void* pArg)
+   {
+      OsDateTime::getCurTime(mStart);
+      for (int i = 0; i < mIterations; i++)
+      {
+         if (mpShared)
+         {
+            // Add and drop references to a buffer used by other threads.
+            MpBufPtr copy1 = *mpShared;
+            MpBufPtr copy2 = copy1;
+            if (!copy2.isValid())
+            {
+               mFailures++;
+            }
+            continue;
+         }
+
+         MpBufPtr bufs[CONTENTION_BUFFERS_PER_ITERATION];
+         for (int j = 0; j < CONTENTION_BUFFERS_PER_ITERATION; j++)
+         {
+            bufs[j] = mpPool->getBuffer();
+            if (!bufs[j].isValid())
+            {
+               mFailures++;
+            }
+         }
+      }
+      OsDateTime::getCurTime(mStop);
+      return 0;
+   }
+
+   MpBufPool *mpPool;
+   int mIterations;
+   const MpBufPtr *mpShared;
+   int mFailures;
+   OsTime mStart;
+   OsTime mStop;
+};
+
 /**
  * Unittest for MpBuf and its successors
  */
@@ -31,6 +98,8 @@ class MpBufTest : public SIPX_UNIT_BASE_CLASS
    CPPUNIT_TEST(testCloningAllTypes);
    CPPUNIT_TEST(testCloningWithDataCheck);
    CPPUNIT_TEST(testRequestWrite);
+   CPPUNIT_TEST(testSharedReferences);
+   CPPUNIT_TEST(testPoolContention);
    CPPUNIT_TEST_SUITE_END();
 
 #define BUFFER_SIZE   100
@@ -287,6 +356,93 @@ public:
       CPPUNIT_ASSERT(buf1 != buf2);
    }
 
+   void testSharedReferences()
+   {
+      MpBufTestTask *tasks[CONTENTION_MAX_THREADS];
+      int i;
+
+      MpBufPtr shared = mpPool->getBuffer();
+      CPPUNIT_ASSERT(shared.isValid());
+
+      // Copies of the pointer are made and released by all tasks at once.
+      for (i = 0; i < CONTENTION_MAX_THREADS; i++)
+      {
+         tasks[i] = new MpBufTestTask(mpPool, CONTENTION_ITERATIONS, &shared);
+         tasks[i]->start();
+      }
+      for (i = 0; i < CONTENTION_MAX_THREADS; i++)
+      {
+         tasks[i]->waitUntilShutDown();
+         CPPUNIT_ASSERT_EQUAL(0, tasks[i]->mFailures);
+         delete tasks[i];
+      }
+
+      // The buffer must not have been freed by any of them.
+      CPPUNIT_ASSERT_EQUAL(BUFFER_NUM-1, mpPool->getFreeBufferCount());
+      shared.release();
+      CPPUNIT_ASSERT_EQUAL(BUFFER_NUM, mpPool->getFreeBufferCount());
+   }
+
+   void testPoolContention()
+   {
+      MpBufTestTask *tasks[CONTENTION_MAX_THREADS];
+      int poolSize = CONTENTION_MAX_THREADS*CONTENTION_BUFFERS_PER_ITERATION;
+      MpBufPool pool(BUFFER_SIZE, poolSize, "MpBufTestContention");
+
+      for (int numThreads = 1; numThreads <= CONTENTION_MAX_THREADS; numThreads *= 2)
+      {
+         int i;
+         for (i = 0; i < numThreads; i++)
+         {
+            tasks[i] = new MpBufTestTask(&pool, CONTENTION_ITERATIONS, NULL);
+         }
+         for (i = 0; i < numThreads; i++)
+         {
+            tasks[i]->start();
+         }
+
+         // Time from the first start to the last stop as seen by the tasks.
+         OsTime start;
+         OsTime stop;
+         for (i = 0; i < numThreads; i++)
+         {
+            tasks[i]->waitUntilShutDown();
+            CPPUNIT_ASSERT_EQUAL(0, tasks[i]->mFailures);
+            if (i == 0 || tasks[i]->mStart < start)
+            {
+               start = tasks[i]->mStart;
+            }
+            if (i == 0 || tasks[i]->mStop > stop)
+            {
+               stop = tasks[i]->mStop;
+            }
+            delete tasks[i];
+         }
+
+         OsTime diff = stop - start;
+         double seconds = diff.seconds() + diff.usecs()/1000000.0;
+         printf("MpBufPool contention: %d threads, %.0f buffers/sec\n",
+                numThreads,
+                numThreads*CONTENTION_ITERATIONS*CONTENTION_BUFFERS_PER_ITERATION
+                / (seconds > 0 ? seconds : 1e-6));
+
+         CPPUNIT_ASSERT_EQUAL(poolSize, pool.getFreeBufferCount());
+      }
+
+      // All buffers must still be there and different.
+      MpBufPtr bufs[CONTENTION_MAX_THREADS*CONTENTION_BUFFERS_PER_ITERATION];
+      for (int i = 0; i < poolSize; i++)
+      {
+         bufs[i] = pool.getBuffer();
+         CPPUNIT_ASSERT(bufs[i].isValid());
+         for (int j = 0; j < i; j++)
+         {
+            CPPUNIT_ASSERT(bufs[i] != bufs[j]);
+         }
+      }
+      CPPUNIT_ASSERT_EQUAL(0, pool.getFreeBufferCount());
+   }
+
 protected:
    MpBufPool *mpPool;         ///< Pool for data buffers
    MpBufPool *mpHeadersPool;  ///< Pool for buffers headers
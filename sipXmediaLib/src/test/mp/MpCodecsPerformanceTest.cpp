@@ -30,6 +30,8 @@
 #define NUM_PACKETS_TO_TEST      3
 /// Maximum number of milliseconds in packet.
 #define MAX_PACKET_TIME          20
+/// Number of frames to encode and to decode to time one frame.
+#define NUM_FRAMES_TO_TIME       1000
 
 ///  Unit test for testing performance of supported codecs.
 class MpCodecsPerformanceTest : public SIPX_UNIT_BASE_CLASS
@@ -86,6 +88,7 @@ public:
       }
 
       printf("mediaFrame size: %d mSec\n", FRAME_MS);
+      mFrameTimes.remove(0);
 
       // Get list of loaded codecs
       pCodecFactory->getCodecInfoArray(codecInfoNum, pCodecInfo);
@@ -123,6 +126,11 @@ public:
          }
       }
 
+      // Summary, to compare codecs and builds.
+      printf("Time per %d ms frame, in ns:\n"
+             "codec                          encode     decode\n"
+             "%s", FRAME_MS, mFrameTimes.data());
+
       // Free codec factory
       MpCodecFactory::freeSingletonHandle();
    }
@@ -130,6 +138,65 @@ public:
 protected:
    MpBufPool *mpPool;         ///< Pool for data buffers
    MpBufPool *mpHeadersPool;  ///< Pool for buffers headers
+   UtlString  mFrameTimes;    ///< One line of encode and decode times per codec
+
+   /// Encode and decode NUM_FRAMES_TO_TIME frames and give the time per frame.
+   void timeFrames(MpEncoderBase *pEncoder, MpDecoderBase *pDecoder,
+                   const MpAudioSample *pOriginal, int frameSize,
+                   const MpRtpBufPtr &pPacket, int packetSamples,
+                   long &encodeNs, long &decodeNs)
+   {
+      unsigned char  encoded[ENCODED_FRAME_MAX_SIZE];
+      MpAudioSample  decoded[DECODED_FRAME_MAX_SIZE];
+      int            payloadSize = 0;
+      OsTime         start;
+      OsTime         stop;
+      OsTime         diff;
+      int            i;
+
+      OsDateTime::getCurTime(start);
+      for (i = 0; i < NUM_FRAMES_TO_TIME; i++)
+      {
+         int        samplesConsumed;
+         int        encodedSize;
+         UtlBoolean isPacketReady;
+         UtlBoolean isPacketSilent;
+         UtlBoolean setMarkerBit;
+         pEncoder->encode(pOriginal, frameSize, samplesConsumed,
+                          encoded + payloadSize,
+                          ENCODED_FRAME_MAX_SIZE - payloadSize,
+                          encodedSize, isPacketReady, isPacketSilent,
+                          setMarkerBit);
+         payloadSize += encodedSize;
+         // Start over when the packet would be sent.
+         if (isPacketReady || payloadSize > ENCODED_FRAME_MAX_SIZE/2)
+         {
+            payloadSize = 0;
+         }
+      }
+      OsDateTime::getCurTime(stop);
+      diff = stop - start;
+      encodeNs = (long)((diff.seconds()*1000000.0 + diff.usecs()) * 1000
+                        / NUM_FRAMES_TO_TIME);
+
+      // Decode the same packet over, as many times as it makes
+      // NUM_FRAMES_TO_TIME frames.
+      int framesPerPacket = packetSamples / frameSize;
+      if (framesPerPacket < 1)
+      {
+         framesPerPacket = 1;
+      }
+      int numPackets = NUM_FRAMES_TO_TIME / framesPerPacket;
+      OsDateTime::getCurTime(start);
+      for (i = 0; i < numPackets; i++)
+      {
+         pDecoder->decode(pPacket, DECODED_FRAME_MAX_SIZE, decoded);
+      }
+      OsDateTime::getCurTime(stop);
+      diff = stop - start;
+      decodeNs = (long)((diff.seconds()*1000000.0 + diff.usecs()) * 1000
+                        / (numPackets * framesPerPacket));
+   }
 
    void testOneCodecPreformance(MpCodecFactory *pCodecFactory,
                                 const UtlString &codecMime,
@@ -209,6 +276,8 @@ protected:
 
       unsigned char* rtpDataStart = NULL;
       int algorithmicDelaySamplesCount = 0;
+      MpRtpBufPtr    pLastPacket;
+      int            lastPacketSamples = 0;
 
       for (int i=0; i<NUM_PACKETS_TO_TEST; i++)
       {
@@ -356,8 +425,29 @@ protected:
                 i,
                 start.seconds(), start.usecs(),
                 diff.seconds(), diff.usecs());
+
+         // Keep the last packet to time decoding, the pool has one buffer.
+         if (i == NUM_PACKETS_TO_TEST-1)
+         {
+            pLastPacket = pRtpPacket;
+            lastPacketSamples = samplesInPacket;
+         }
       }
 
+      long encodeNs;
+      long decodeNs;
+      timeFrames(pEncoder, pDecoder, pOriginal, frameSize,
+                 pLastPacket, lastPacketSamples, encodeNs, decodeNs);
+      pLastPacket.release();
+      printf("frame-time %s/%d/%d %s;%ld;%ld\n",
+             codecMime.data(), sampleRate, numChannels, codecFmtp.data(),
+             encodeNs, decodeNs);
+      UtlString codecName;
+      codecName.appendFormat("%s/%d/%d %s", codecMime.data(), sampleRate,
+                             numChannels, codecFmtp.data());
+      mFrameTimes.appendFormat("%-28s %8ld   %8ld\n",
+                               codecName.data(), encodeNs, decodeNs);
+
       printf("algorithmic-delay %s/%d/%d %s;%d;%f\n",
              codecMime.data(), sampleRate, numChannels, codecFmtp.data(),
              algorithmicDelaySamplesCount, 
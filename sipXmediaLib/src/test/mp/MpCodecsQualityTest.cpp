@@ -25,6 +25,8 @@
 #include <mp/MprToNet.h>
 #include <mp/MpCodecFactory.h>
 #include <mp/MprnRtpStreamActivityMsg.h>
+#include <mp/MpPlcSilence.h>
+#include <mp/MpPlcPitch.h>
 #include <sdp/SdpCodec.h>
 #include <sdp/SdpDefaultCodecFactory.h>
 
@@ -35,6 +37,10 @@
 #define RECORDER_RESOURCE_NAME "Recorder"
 #define ENCODER_RESOURCE_NAME "Encoder"
 #define MAX_TEST_SAMPLE_COUNT ((1<<16) * 2)
+#define PLC_TEST_SECONDS 4
+#define PLC_PACKET_MS 20
+#define PLC_MAX_PACKET_SAMPLES (48000 * PLC_PACKET_MS / 1000)
+#define PLC_SNR_NO_ERROR 1000.0
 
 //#define CHECK_SILENCE 1
 #ifdef CHECK_SILENCE
@@ -633,6 +639,8 @@ class MpCodecsQualityTest : public SIPX_UNIT_BASE_CLASS
 {
    CPPUNIT_TEST_SUITE(MpCodecsQualityTest);
    CPPUNIT_TEST(testEncodeDecodeToFile);
+   CPPUNIT_TEST(testPlcLossPatterns);
+   CPPUNIT_TEST(testPlcShortFrame);
    CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -766,6 +774,116 @@ public:
       CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, mpShutdown());
    }
 
+   /// Loss pattern of testPlcLossPatterns().
+   struct PlcLossPattern
+   {
+      const char* mpName;
+      int mBurstPercent;   ///< Chance of a loss to start at a packet.
+      int mBurstLength;    ///< Packets lost in a row from there.
+   };
+
+   /// How close the PLC output is to the signal without loss.
+   struct PlcQuality
+   {
+      double mSnr;          ///< Waveform SNR in dB.
+      double mGapDepth;     ///< Mean energy missing from 10 ms segments in dB.
+   };
+
+   /// Fill \p pSamples with a voiced, speech like signal.
+   static void makeVoicedSignal(MpAudioSample* pSamples, int numSamples,
+                                int sampleRate)
+   {
+      // Harmonics of a pitch gliding between 80 and 160 Hz, with loudness
+      // going up and down at a syllable rate.  There are no pauses, as
+      // nothing could conceal a loss at the start of a talk spurt.
+      double phase = 0.0;
+      for (int i = 0; i < numSamples; i++)
+      {
+         double t = (double)i / sampleRate;
+         double pitch = 120.0 + 40.0*sin(2.0*M_PI*0.7*t);
+         double envelope = 0.6 + 0.4*sin(2.0*M_PI*2.5*t);
+         phase += 2.0*M_PI*pitch/sampleRate;
+         double sample = 0.0;
+         for (int k = 1; k*pitch < 3400.0; k++)
+         {
+            sample += sin(k*phase)/k;
+         }
+         pSamples[i] = (MpAudioSample)(6000.0*envelope*sample);
+      }
+   }
+
+   /// Pass decoded packets through the PLC, dropping the lost ones.
+   /**
+   *  The SNR is PLC_SNR_NO_ERROR if the output is the same as \p pDecoded.
+   *  Waveform substitution drifts out of phase with the lost signal, so for
+   *  long losses its SNR says little.  The gap depth shows how much quieter
+   *  than the signal the output is, i.e. how much of the loss is heard as
+   *  a gap.
+   */
+   PlcQuality runPlc(const char* plcName, int sampleRate,
+                     const MpAudioSample* pDecoded, int numPackets,
+                     int packetSamples, const UtlBoolean* pLost)
+   {
+      MpPlcBase* pPlc = MpPlcBase::createPlc(plcName);
+      CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, pPlc->init(sampleRate));
+      int delay = pPlc->getAlgorithmicDelay();
+      int numSamples = numPackets*packetSamples;
+      MpAudioSample* pOutput = new MpAudioSample[numSamples];
+
+      for (int packetNum = 0; packetNum < numPackets; packetNum++)
+      {
+         MpAudioSample frame[PLC_MAX_PACKET_SAMPLES];
+         MpSpeechParams speechParams;
+         unsigned inSamplesNum = 0;
+         if (!pLost[packetNum])
+         {
+            memcpy(frame, pDecoded + packetNum*packetSamples,
+                   packetSamples*sizeof(MpAudioSample));
+            inSamplesNum = packetSamples;
+            speechParams.mSpeechType = MP_SPEECH_ACTIVE;
+         }
+         int madeAdjustment;
+         pPlc->processFrame(speechParams, frame, PLC_MAX_PACKET_SAMPLES,
+                            inSamplesNum, packetSamples, 0, madeAdjustment);
+         CPPUNIT_ASSERT_EQUAL(0, madeAdjustment);
+         memcpy(pOutput + packetNum*packetSamples, frame,
+                packetSamples*sizeof(MpAudioSample));
+      }
+      delete pPlc;
+
+      PlcQuality quality;
+      double signalEnergy = 0.0;
+      double errorEnergy = 0.0;
+      double gapDepth = 0.0;
+      int segmentSamples = sampleRate / 100;
+      int numSegments = (numSamples - delay) / segmentSamples;
+      for (int segment = 0; segment < numSegments; segment++)
+      {
+         // Mean energies are floored at 0 dB, so silence is not infinitely
+         // far from anything.
+         double decodedEnergy = 1.0;
+         double outputEnergy = 1.0;
+         for (int i = segment*segmentSamples; i < (segment + 1)*segmentSamples; i++)
+         {
+            double error = pOutput[i + delay] - pDecoded[i];
+            signalEnergy += (double)pDecoded[i]*pDecoded[i];
+            errorEnergy += error*error;
+            decodedEnergy += (double)pDecoded[i]*pDecoded[i]/segmentSamples;
+            outputEnergy += (double)pOutput[i + delay]*pOutput[i + delay]/segmentSamples;
+         }
+         if (outputEnergy < decodedEnergy)
+         {
+            gapDepth += 10.0*log10(decodedEnergy/outputEnergy);
+         }
+      }
+      delete[] pOutput;
+
+      quality.mSnr = (errorEnergy == 0.0) ? PLC_SNR_NO_ERROR
+                                          : 10.0*log10(signalEnergy/errorEnergy);
+      quality.mGapDepth = gapDepth / numSegments;
+      return quality;
+   }
+
     void testEncodeDecodeToFile()
     {
         //  Create dir where results/recorded files will be stored
@@ -1162,6 +1280,231 @@ public:
         } // end loop over codecs
     }
 
+    void testPlcLossPatterns()
+    {
+        // Losses start at random packets and go on for a fixed number of
+        // packets.  The same packets are lost for every PLC.
+        static const PlcLossPattern lossPatterns[] =
+        {
+            {"random 5%",     5, 1},
+            {"random 10%",   10, 1},
+            {"random 20%",   20, 1},
+            {"bursts 40ms",   4, 2},
+            {"bursts 60ms",   3, 3},
+            {"bursts 100ms",  2, 5}
+        };
+        const int numLossPatterns = sizeof(lossPatterns)/sizeof(lossPatterns[0]);
+        UtlString summary;
+
+        unsigned codecInfoNum;
+        const MppCodecInfoV1_1** codecInfoArray;
+        MpCodecFactory* codecFactory = MpCodecFactory::getMpCodecFactory();
+        CPPUNIT_ASSERT(codecFactory != NULL);
+        codecFactory->getCodecInfoArray(codecInfoNum, codecInfoArray);
+
+        for (unsigned codecIndex = 0; codecIndex < codecInfoNum; codecIndex++)
+        {
+            // Only codecs concealed by the jitter buffer PLC, i.e. G.711,
+            // G.722, G.726 and such.
+            const MppCodecInfoV1_1* codecInfo = codecInfoArray[codecIndex];
+            UtlString mimeSubtype(codecInfo->mimeSubtype);
+            UtlString fmtp(codecInfo->fmtpsNum ? codecInfo->fmtps[0] : "");
+            int sampleRate = codecInfo->sampleRate;
+            if (codecInfo->codecType != CODEC_TYPE_SAMPLE_BASED ||
+                codecInfo->numChannels != 1 ||
+                sampleRate > 16000 ||
+                mimeSubtype.compareTo("telephone-event", UtlString::ignoreCase) == 0)
+            {
+                continue;
+            }
+
+            MpDecoderBase* pDecoder = NULL;
+            CPPUNIT_ASSERT_EQUAL(OS_SUCCESS,
+                                 codecFactory->createDecoder(mimeSubtype, fmtp,
+                                                             sampleRate, 1,
+                                                             0, pDecoder));
+            CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, pDecoder->initDecode(fmtp));
+            if (pDecoder->getInfo()->haveInternalPLC())
+            {
+                pDecoder->freeDecode();
+                delete pDecoder;
+                continue;
+            }
+            MpEncoderBase* pEncoder = NULL;
+            CPPUNIT_ASSERT_EQUAL(OS_SUCCESS,
+                                 codecFactory->createEncoder(mimeSubtype, fmtp,
+                                                             sampleRate, 1,
+                                                             0, pEncoder));
+            CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, pEncoder->initEncode());
+
+            // Encode and decode the whole signal without loss first.  The
+            // PLC output is compared with this, to leave the codec noise out.
+            int packetSamples = sampleRate * PLC_PACKET_MS / 1000;
+            int numPackets = PLC_TEST_SECONDS * 1000 / PLC_PACKET_MS;
+            int numSamples = numPackets * packetSamples;
+            MpAudioSample* pOriginal = new MpAudioSample[numSamples];
+            MpAudioSample* pDecoded = new MpAudioSample[numSamples];
+            makeVoicedSignal(pOriginal, numSamples, sampleRate);
+            for (int packetNum = 0; packetNum < numPackets; packetNum++)
+            {
+                unsigned char payload[PLC_MAX_PACKET_SAMPLES*sizeof(MpAudioSample)];
+                int samplesConsumed;
+                int encodedSize;
+                UtlBoolean isPacketReady;
+                UtlBoolean isPacketSilent;
+                UtlBoolean setMarkerBit;
+                CPPUNIT_ASSERT_EQUAL(OS_SUCCESS,
+                    pEncoder->encode(pOriginal + packetNum*packetSamples,
+                                     packetSamples, samplesConsumed,
+                                     payload, sizeof(payload),
+                                     encodedSize, isPacketReady,
+                                     isPacketSilent, setMarkerBit));
+                CPPUNIT_ASSERT_EQUAL(packetSamples, samplesConsumed);
+                CPPUNIT_ASSERT(encodedSize > 0);
+                MpRtpBufPtr pRtpPacket = MpMisc.RtpPool->getBuffer();
+                CPPUNIT_ASSERT(pRtpPacket.isValid());
+                memcpy(pRtpPacket->getDataWritePtr(), payload, encodedSize);
+                pRtpPacket->setPayloadSize(encodedSize);
+                CPPUNIT_ASSERT_EQUAL(packetSamples,
+                    pDecoder->decode(pRtpPacket, packetSamples,
+                                     pDecoded + packetNum*packetSamples));
+            }
+            pEncoder->freeEncode();
+            delete pEncoder;
+            pDecoder->freeDecode();
+            delete pDecoder;
+
+            UtlString codecName;
+            codecName.appendFormat("%s/%d", mimeSubtype.data(), sampleRate);
+
+            // Without loss both PLCs give the signal back as it was, only
+            // delayed.
+            UtlBoolean* pLost = new UtlBoolean[numPackets];
+            memset(pLost, 0, numPackets*sizeof(UtlBoolean));
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(codecName.data(), PLC_SNR_NO_ERROR,
+                                         runPlc(MpPlcSilence::name, sampleRate,
+                                                pDecoded, numPackets,
+                                                packetSamples, pLost).mSnr);
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(codecName.data(), PLC_SNR_NO_ERROR,
+                                         runPlc(MpPlcPitch::name, sampleRate,
+                                                pDecoded, numPackets,
+                                                packetSamples, pLost).mSnr);
+
+            for (int patternNum = 0; patternNum < numLossPatterns; patternNum++)
+            {
+                const PlcLossPattern& pattern = lossPatterns[patternNum];
+                unsigned randState = 1;
+                int burstLeft = 0;
+                int numLost = 0;
+                for (int packetNum = 0; packetNum < numPackets; packetNum++)
+                {
+                    randState = randState*1103515245 + 12345;
+                    if (burstLeft == 0 &&
+                        (int)((randState >> 16) % 100) < pattern.mBurstPercent)
+                    {
+                        burstLeft = pattern.mBurstLength;
+                    }
+                    pLost[packetNum] = burstLeft > 0;
+                    if (burstLeft > 0)
+                    {
+                        burstLeft--;
+                        numLost++;
+                    }
+                }
+
+                PlcQuality silence = runPlc(MpPlcSilence::name, sampleRate,
+                                            pDecoded, numPackets,
+                                            packetSamples, pLost);
+                PlcQuality pitch = runPlc(MpPlcPitch::name, sampleRate,
+                                          pDecoded, numPackets,
+                                          packetSamples, pLost);
+                UtlString line;
+                line.appendFormat("%-12s %-13s %3d lost: "
+                                  "SNR silence %5.1f dB, pitch %5.1f dB; "
+                                  "gap depth silence %5.2f dB, pitch %5.2f dB\n",
+                                  codecName.data(), pattern.mpName, numLost,
+                                  silence.mSnr, pitch.mSnr,
+                                  silence.mGapDepth, pitch.mGapDepth);
+                summary.append(line);
+
+                // Repeating the pitch period has to fill the gaps, and to
+                // match the waveform of isolated lost packets better than
+                // silence.
+                CPPUNIT_ASSERT_MESSAGE(line.data(),
+                                       pitch.mGapDepth < silence.mGapDepth);
+                if (pattern.mBurstLength == 1)
+                {
+                    CPPUNIT_ASSERT_MESSAGE(line.data(), pitch.mSnr > silence.mSnr);
+                }
+            }
+
+            delete[] pLost;
+            delete[] pDecoded;
+            delete[] pOriginal;
+        }
+
+        printf("PLC output against the signal without loss:\n%s",
+               summary.data());
+    }
+
+    void testPlcShortFrame()
+    {
+        // The samples missing at the end of a short frame are output
+        // like the rest, so none of what was in the buffer may be left.
+        static const char* plcNames[] = {MpPlcSilence::name, MpPlcPitch::name};
+        const int numPlcs = sizeof(plcNames)/sizeof(plcNames[0]);
+        const int sampleRate = 8000;
+        const int packetSamples = sampleRate * PLC_PACKET_MS / 1000;
+        const int numPackets = 10;
+        const int shortSamples = 4;
+        const MpAudioSample stale = INT16_MIN;
+        MpAudioSample signal[(numPackets + 1)*packetSamples];
+        makeVoicedSignal(signal, (numPackets + 1)*packetSamples, sampleRate);
+
+        for (int plcNum = 0; plcNum < numPlcs; plcNum++)
+        {
+            MpPlcBase* pPlc = MpPlcBase::createPlc(plcNames[plcNum]);
+            CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, pPlc->init(sampleRate));
+
+            MpAudioSample frame[PLC_MAX_PACKET_SAMPLES];
+            MpSpeechParams speechParams;
+            int madeAdjustment;
+            for (int packetNum = 0; packetNum < numPackets; packetNum++)
+            {
+                memcpy(frame, signal + packetNum*packetSamples,
+                       packetSamples*sizeof(MpAudioSample));
+                speechParams.mSpeechType = MP_SPEECH_ACTIVE;
+                pPlc->processFrame(speechParams, frame, PLC_MAX_PACKET_SAMPLES,
+                                   packetSamples, packetSamples, 0,
+                                   madeAdjustment);
+            }
+
+            memcpy(frame, signal + numPackets*packetSamples,
+                   shortSamples*sizeof(MpAudioSample));
+            for (int i = shortSamples; i < PLC_MAX_PACKET_SAMPLES; i++)
+            {
+                frame[i] = stale;
+            }
+            speechParams.mSpeechType = MP_SPEECH_ACTIVE;
+            CPPUNIT_ASSERT_EQUAL(OS_SUCCESS,
+                pPlc->processFrame(speechParams, frame, PLC_MAX_PACKET_SAMPLES,
+                                   shortSamples, packetSamples, 0,
+                                   madeAdjustment));
+            CPPUNIT_ASSERT_EQUAL(0, madeAdjustment);
+
+            int numStale = 0;
+            for (int i = shortSamples; i < packetSamples; i++)
+            {
+                if (frame[i] == stale)
+                {
+                    numStale++;
+                }
+            }
+            CPPUNIT_ASSERT_EQUAL_MESSAGE(plcNames[plcNum], 0, numStale);
+            delete pPlc;
+        }
+    }
+
 private:
    MpFlowGraphBase* mpFlowGraph; 
    MprFromFile* mprFromFile;
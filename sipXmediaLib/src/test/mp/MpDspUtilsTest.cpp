@@ -10,8 +10,20 @@
 
 #include <sipxunittests.h>
 
+#include <stdio.h>
+#include <string.h>
+#include <os/OsDateTime.h>
 #include <mp/MpDspUtils.h>
 
+/// Length of vectors used to compare SIMD versions with C ones.
+#define SIMD_TEST_MAX_LENGTH     70
+/// Number of random vectors compared for each length.
+#define SIMD_TEST_ITERATIONS     200
+/// Number of samples in a benchmarked vector (20ms at 8kHz).
+#define SIMD_BENCHMARK_LENGTH    160
+/// Number of times each function is called in benchmark.
+#define SIMD_BENCHMARK_ITERATIONS 100000
+
 /**
  * Unittest for MpDspUtils
  */
@@ -42,6 +54,8 @@ class MpDspUtilsTest : public SIPX_UNIT_BASE_CLASS
    CPPUNIT_TEST(testConvert_int32_int16);
    CPPUNIT_TEST(testConvert_Gain_int32_int16);
    CPPUNIT_TEST(testConvert_Att_int32_int16);
+   CPPUNIT_TEST(testSimd_bitExact);
+   CPPUNIT_TEST(testSimd_benchmark);
 #else  // MP_FIXED_POINT ][
    CPPUNIT_TEST(testConvert_float_int16);
 #endif // MP_FIXED_POINT ]
@@ -49,6 +63,11 @@ class MpDspUtilsTest : public SIPX_UNIT_BASE_CLASS
 
 public:
 
+   void setUp()
+   {
+      mRandomState = 1;
+   }
+
    void testNegate_int16()
    {
       // Try to negate minimum 16-bit integer.
@@ -323,6 +342,147 @@ public:
 //      printf("};\n");
    }
 
+   void testSimd_bitExact()
+   {
+      const MpDspUtils::SimdLevel savedLevel = MpDspUtils::getSimdLevel();
+      const MpDspUtils::SimdLevel maxLevel = MpDspUtils::getMaxSimdLevel();
+
+      int16_t src16[SIMD_TEST_MAX_LENGTH];
+      int32_t src32[SIMD_TEST_MAX_LENGTH];
+      int32_t src32b[SIMD_TEST_MAX_LENGTH];
+      int32_t dst32[SIMD_TEST_MAX_LENGTH];
+      int32_t ref32[SIMD_TEST_MAX_LENGTH];
+      int16_t dst16[SIMD_TEST_MAX_LENGTH];
+      int16_t ref16[SIMD_TEST_MAX_LENGTH];
+
+      // Compare results of vector function with its C version. Destination
+      // is pre-filled with random data, as some functions accumulate to it.
+#define CHECK_INT32_RESULT(func, funcC)                                   \
+      memcpy(dst32, src32b, sizeof(dst32));                                \
+      memcpy(ref32, src32b, sizeof(ref32));                                \
+      MpDspUtils::func;                                                    \
+      MpDspUtils::funcC;                                                   \
+      CPPUNIT_ASSERT_MESSAGE(#func, memcmp(dst32, ref32, sizeof(dst32)) == 0)
+#define CHECK_INT16_RESULT(func, funcC)                                   \
+      memset(dst16, 0, sizeof(dst16));                                     \
+      memset(ref16, 0, sizeof(ref16));                                     \
+      MpDspUtils::func;                                                    \
+      MpDspUtils::funcC;                                                   \
+      CPPUNIT_ASSERT_MESSAGE(#func, memcmp(dst16, ref16, sizeof(dst16)) == 0)
+
+      for (int level = MpDspUtils::SIMD_NONE; level <= maxLevel; level++)
+      {
+         MpDspUtils::setSimdLevel((MpDspUtils::SimdLevel)level);
+         CPPUNIT_ASSERT_EQUAL(level, (int)MpDspUtils::getSimdLevel());
+
+         for (int len = 1; len <= SIMD_TEST_MAX_LENGTH; len++)
+         {
+            for (int iter = 0; iter < SIMD_TEST_ITERATIONS; iter++)
+            {
+               for (int i = 0; i < SIMD_TEST_MAX_LENGTH; i++)
+               {
+                  src16[i] = randomInt16();
+                  src32[i] = randomInt32();
+                  src32b[i] = randomInt32();
+               }
+               const int16_t val = randomInt16();
+               const int16_t valEnd = randomInt16();
+               const unsigned scale = nextRandom() % 17;
+
+               CHECK_INT32_RESULT(add_I(src16, dst32, len),
+                                  add_I_C(src16, ref32, len));
+               CHECK_INT32_RESULT(add_IGain(src16, dst32, len, scale),
+                                  add_IGain_C(src16, ref32, len, scale));
+               CHECK_INT32_RESULT(add_IAtt(src16, dst32, len, scale),
+                                  add_IAtt_C(src16, ref32, len, scale));
+               CHECK_INT32_RESULT(add(src32, src32b, dst32, len),
+                                  add_C(src32, src32b, ref32, len));
+               CHECK_INT32_RESULT(addMul_I(src16, val, dst32, len),
+                                  addMul_I_C(src16, val, ref32, len));
+               CHECK_INT32_RESULT(addMulLinear_I(src16, val, valEnd, dst32, len),
+                                  addMulLinear_I_C(src16, val, valEnd, ref32, len));
+               CHECK_INT32_RESULT(mul(src16, val, dst32, len),
+                                  mul_C(src16, val, ref32, len));
+               CHECK_INT32_RESULT(mulLinear(src16, val, valEnd, dst32, len),
+                                  mulLinear_C(src16, val, valEnd, ref32, len));
+               CHECK_INT32_RESULT(convert(src16, dst32, len),
+                                  convert_C(src16, ref32, len));
+               CHECK_INT32_RESULT(convert_Gain(src16, dst32, len, scale),
+                                  convert_Gain_C(src16, ref32, len, scale));
+               CHECK_INT32_RESULT(convert_Att(src16, dst32, len, scale),
+                                  convert_Att_C(src16, ref32, len, scale));
+               CHECK_INT16_RESULT(convert(src32, dst16, len),
+                                  convert_C(src32, ref16, len));
+               CHECK_INT16_RESULT(convert_Gain(src32, dst16, len, scale),
+                                  convert_Gain_C(src32, ref16, len, scale));
+               CHECK_INT16_RESULT(convert_Att(src32, dst16, len, scale),
+                                  convert_Att_C(src32, ref16, len, scale));
+            }
+         }
+      }
+
+#undef CHECK_INT32_RESULT
+#undef CHECK_INT16_RESULT
+
+      MpDspUtils::setSimdLevel(savedLevel);
+   }
+
+   void testSimd_benchmark()
+   {
+      const MpDspUtils::SimdLevel savedLevel = MpDspUtils::getSimdLevel();
+      const MpDspUtils::SimdLevel maxLevel = MpDspUtils::getMaxSimdLevel();
+      static const char *levelNames[] = {"C", "SSE2", "AVX2"};
+
+      int16_t src16[SIMD_BENCHMARK_LENGTH];
+      int32_t src32[SIMD_BENCHMARK_LENGTH];
+      int32_t dst32[SIMD_BENCHMARK_LENGTH];
+      int16_t dst16[SIMD_BENCHMARK_LENGTH];
+      for (int i = 0; i < SIMD_BENCHMARK_LENGTH; i++)
+      {
+         src16[i] = randomInt16();
+         src32[i] = randomInt16() * 4;
+         dst32[i] = 0;
+      }
+
+      // Print time in nanoseconds per sample for each level.
+#define BENCHMARK(name, func)                                              \
+      printf("%-16s", name);                                               \
+      for (int level = MpDspUtils::SIMD_NONE; level <= maxLevel; level++)  \
+      {                                                                    \
+         MpDspUtils::setSimdLevel((MpDspUtils::SimdLevel)level);           \
+         OsTime start;                                                     \
+         OsTime stop;                                                      \
+         OsDateTime::getCurTime(start);                                    \
+         for (int iter = 0; iter < SIMD_BENCHMARK_ITERATIONS; iter++)      \
+         {                                                                 \
+            MpDspUtils::func;                                              \
+         }                                                                 \
+         OsDateTime::getCurTime(stop);                                     \
+         stop -= start;                                                    \
+         printf(" %s: %6.3f", levelNames[level],                           \
+                stop.seconds()*1.0e9/SIMD_BENCHMARK_ITERATIONS/SIMD_BENCHMARK_LENGTH \
+                + stop.usecs()*1.0e3/SIMD_BENCHMARK_ITERATIONS/SIMD_BENCHMARK_LENGTH); \
+      }                                                                    \
+      printf(" ns/sample\n")
+
+      printf("\nMpDspUtils vector functions, %d samples:\n", SIMD_BENCHMARK_LENGTH);
+      BENCHMARK("add_I", add_I(src16, dst32, SIMD_BENCHMARK_LENGTH));
+      BENCHMARK("add_IGain", add_IGain(src16, dst32, SIMD_BENCHMARK_LENGTH, 2));
+      BENCHMARK("add_IAtt", add_IAtt(src16, dst32, SIMD_BENCHMARK_LENGTH, 2));
+      BENCHMARK("add", add(src32, dst32, dst32, SIMD_BENCHMARK_LENGTH));
+      BENCHMARK("addMul_I", addMul_I(src16, 1234, dst32, SIMD_BENCHMARK_LENGTH));
+      BENCHMARK("addMulLinear_I", addMulLinear_I(src16, 0, 8192, dst32, SIMD_BENCHMARK_LENGTH));
+      BENCHMARK("mul", mul(src16, 1234, dst32, SIMD_BENCHMARK_LENGTH));
+      BENCHMARK("mulLinear", mulLinear(src16, 0, 8192, dst32, SIMD_BENCHMARK_LENGTH));
+      BENCHMARK("convert", convert(src32, dst16, SIMD_BENCHMARK_LENGTH));
+      BENCHMARK("convert_Gain", convert_Gain(src32, dst16, SIMD_BENCHMARK_LENGTH, 2));
+      BENCHMARK("convert_Att", convert_Att(src32, dst16, SIMD_BENCHMARK_LENGTH, 2));
+
+#undef BENCHMARK
+
+      MpDspUtils::setSimdLevel(savedLevel);
+   }
+
 #else  // MP_FIXED_POINT ][
 
    void testConvert_float_int16()
@@ -342,6 +502,40 @@ public:
 
 protected:
 
+   // Pseudo-random generator, so failures of SIMD tests are reproducible.
+   uint32_t mRandomState;
+
+   uint32_t nextRandom()
+   {
+      mRandomState = mRandomState*1103515245 + 12345;
+      return mRandomState >> 8;
+   }
+
+   // Random 16-bit value, biased towards saturation boundaries.
+   int16_t randomInt16()
+   {
+      switch (nextRandom() % 8)
+      {
+      case 0: return INT16_MIN;
+      case 1: return INT16_MAX;
+      case 2: return -INT16_MAX;
+      default: return (int16_t)nextRandom();
+      }
+   }
+
+   // Random 32-bit value, biased towards saturation boundaries.
+   int32_t randomInt32()
+   {
+      switch (nextRandom() % 8)
+      {
+      case 0: return INT32_MIN;
+      case 1: return INT32_MAX;
+      case 2: return INT32_MIN+1;
+      case 3: return (int32_t)(nextRandom() % 131072) - 65536;
+      default: return (int32_t)((nextRandom() << 16) ^ nextRandom());
+      }
+   }
+
    // Data set for 16-bit integer addition test.
    enum {ADD_INT16_TEST_LENGTH=12};
    static const int16_t add_int16_src[ADD_INT16_TEST_LENGTH];
@@ -10,6 +10,8 @@
 
 #include <os/OsIntTypes.h>
 
+#include <stdlib.h>
+
 #include <sipxunittests.h>
 #include <sipxunit/TestUtilities.h>
 
@@ -19,6 +21,20 @@
 #include <os/OsNotification.h>
 #include <os/OsTask.h>
 
+#ifdef __linux__ // [
+#  include <mp/MpMMTimerPosix.h>
+#  include <mp/MpMMTimerMonotonic.h>
+#endif // __linux__ ]
+
+/// Default length of testJitterHistogram() runs, see JITTER_SECONDS_ENV.
+#define JITTER_DEFAULT_SECONDS 2
+/// Environment variable with the length of testJitterHistogram() runs,
+/// e.g. 60 to record the histograms over a minute.
+#define JITTER_SECONDS_ENV "SIPX_MMTIMER_JITTER_SECONDS"
+/// Upper bounds of the tick jitter histogram buckets, in microseconds.
+static const long sJitterBuckets[] = {10, 20, 50, 100, 200, 500, 1000, 2000, 5000};
+#define JITTER_NUM_BUCKETS (sizeof(sJitterBuckets)/sizeof(sJitterBuckets[0]) + 1)
+
 // Forward Decl's
 class MpMMTimerTest;
 
@@ -45,6 +61,7 @@ class MpMMTimerTest : public SIPX_UNIT_BASE_CLASS
    CPPUNIT_TEST(testPeriodRange);
    CPPUNIT_TEST(testLinearTimer);
    CPPUNIT_TEST(testNotificationTimer);
+   CPPUNIT_TEST(testJitterHistogram);
    CPPUNIT_TEST_SUITE_END();
 
 
@@ -334,6 +351,127 @@ public:
       mPerfTimesSz = 0;
    }
 
+   void printJitterHistogram(const long deltas[], unsigned nDeltas,
+                             unsigned targetDelta)
+   {
+      unsigned counts[JITTER_NUM_BUCKETS] = {0};
+      long maxJitter = 0;
+      unsigned i;
+      for(i = 1; i < nDeltas; i++) // the first value is always high
+      {
+         long jitter = labs(deltas[i] - (long)targetDelta);
+         unsigned bucket = 0;
+         while(bucket < JITTER_NUM_BUCKETS-1 && jitter >= sJitterBuckets[bucket])
+         {
+            bucket++;
+         }
+         counts[bucket]++;
+         if(jitter > maxJitter)
+         {
+            maxJitter = jitter;
+         }
+      }
+
+      printf("Tick jitter histogram, %u ticks, max %ld us:\n", nDeltas-1, maxJitter);
+      for(i = 0; i < JITTER_NUM_BUCKETS; i++)
+      {
+         if(i < JITTER_NUM_BUCKETS-1)
+         {
+            printf("   < %5ld us: %8u  %6.2f%%\n", sJitterBuckets[i], counts[i],
+                   counts[i]*100.0/(nDeltas-1));
+         }
+         else
+         {
+            printf("  >= %5ld us: %8u  %6.2f%%\n", sJitterBuckets[i-1], counts[i],
+                   counts[i]*100.0/(nDeltas-1));
+         }
+      }
+   }
+
+   void recordJitterHistogram(const UtlString& timerName, unsigned seconds)
+   {
+      unsigned periodUSecs = 10000;
+      long lowerMeanThresh = -50;
+      long upperMeanThresh = 50;
+      mPerfTimesSz = seconds*1000000/periodUSecs;
+
+      TimerNotification timerNotification(this);
+      MpMMTimer* pMMTimer = MpMMTimer::create(MpMMTimer::Notification, timerName);
+      if (pMMTimer == NULL)
+      {
+         printf("MpMMTimer \"%s\" is not available on this platform, excluding it.\n",
+                timerName.data());
+         return;
+      }
+      printf("%s timer firing every %d usecs for %u seconds\n",
+             timerName.isNull() ? "Default" : timerName.data(),
+             periodUSecs, seconds);
+
+      pMMTimer->setNotification(&timerNotification);
+      mpPerfTimes = new OsTime[mPerfTimesSz];
+      mCurNPerfTimes = 0;
+      CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, pMMTimer->run(periodUSecs));
+
+      OsTask::delay(periodUSecs*mPerfTimesSz/1000 + 50);
+      unsigned nPerfTimes = mCurNPerfTimes;
+      pMMTimer->setNotification(NULL);
+      CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, pMMTimer->stop());
+      CPPUNIT_ASSERT_EQUAL(mPerfTimesSz, nPerfTimes);
+
+#ifdef __linux__ // [
+      MpMMTimerMonotonic* pMonotonicTimer = dynamic_cast<MpMMTimerMonotonic*>(pMMTimer);
+      if (pMonotonicTimer != NULL)
+      {
+         MpMMTimerMonotonic::Statistics stats;
+         pMonotonicTimer->getStatistics(stats);
+         printf("Timer statistics: %" PRIu64 " ticks, %" PRIu64 " overruns, "
+                "%" PRIu64 " skipped, wake-up lateness mean %.1f us, max %u us\n",
+                stats.mTicks, stats.mOverruns, stats.mSkippedTicks,
+                stats.mWakeups ? stats.mTotalLatenessUs/(double)stats.mWakeups : 0.0,
+                stats.mMaxLatenessUs);
+      }
+#endif // __linux__ ]
+      delete pMMTimer;
+
+      long* pDeltas = new long[mPerfTimesSz-1];
+      unsigned i;
+      for(i = 0; i < mPerfTimesSz-1; i++)
+      {
+         OsTime delta = mpPerfTimes[i+1] - mpPerfTimes[i];
+         pDeltas[i] = delta.seconds()*1000*1000 + delta.usecs();
+      }
+
+      printJitterHistogram(pDeltas, mPerfTimesSz-1, periodUSecs);
+      checkMeanAgainstThresholds(mpPerfTimes[0], mpPerfTimes[mPerfTimesSz-1],
+                                 mPerfTimesSz-1,
+                                 periodUSecs,
+                                 lowerMeanThresh, upperMeanThresh);
+
+      delete[] pDeltas;
+      delete[] mpPerfTimes;
+      mpPerfTimes = NULL;
+      mCurNPerfTimes = 0;
+      mPerfTimesSz = 0;
+   }
+
+   void testJitterHistogram()
+   {
+      // Short runs by default, to keep the suite quick.  Set
+      // SIPX_MMTIMER_JITTER_SECONDS=60 to compare timers on a loaded server.
+      unsigned seconds = JITTER_DEFAULT_SECONDS;
+      const char* secondsStr = getenv(JITTER_SECONDS_ENV);
+      if (secondsStr != NULL && atoi(secondsStr) > 0)
+      {
+         seconds = atoi(secondsStr);
+      }
+
+      recordJitterHistogram("", seconds);
+#ifdef __linux__ // [
+      // The default timer is the monotonic one, compare with the old one.
+      recordJitterHistogram(MpMMTimerPosix::TYPE, seconds);
+#endif // __linux__ ]
+   }
+
 protected:
 
    OsTime* mpPerfTimes;
@@ -36,6 +36,7 @@ class MpMediaTaskTest : public SIPX_UNIT_BASE_CLASS
     CPPUNIT_TEST(testStartAndStopFlowGraph);
     CPPUNIT_TEST(testTimeLimitAndTimeout);
     CPPUNIT_TEST(testMultipleManagedAndUnmanagedFlowgraph);
+    CPPUNIT_TEST(testWorkerThreads);
     CPPUNIT_TEST_SUITE_END();
 
 /// Number of frames in one frame
@@ -470,6 +471,91 @@ public:
         delete pFlowGraph2;
     }
 
+    void testWorkerThreads()
+    {
+#define NUM_WORKER_TEST_GRAPHS 4
+        MpFlowGraphBase* flowGraphs[NUM_WORKER_TEST_GRAPHS];
+        MpFlowGraphBase* pUnmanaged;
+        int              lastUsecs;
+        int              maxUsecs;
+        int              startFrames;
+        int              i;
+        OsStatus         res;
+
+        CPPUNIT_ASSERT_EQUAL(1, mpMediaTask->getWorkerThreads());
+        CPPUNIT_ASSERT_EQUAL(0, mpMediaTask->getDeadlineMissCnt());
+        CPPUNIT_ASSERT(mpMediaTask->setWorkerThreads(0) == OS_INVALID_ARGUMENT);
+        CPPUNIT_ASSERT(mpMediaTask->setWorkerThreads(MpMediaTask::MAX_WORKER_THREADS+1)
+                       == OS_INVALID_ARGUMENT);
+
+        // Test 1: Start several flow graphs and process them on 3 threads
+        for (i = 0; i < NUM_WORKER_TEST_GRAPHS; i++)
+        {
+            flowGraphs[i] = new MpFlowGraphBase(30, 30);
+            res = mpMediaTask->manageFlowGraph(*flowGraphs[i]);
+            CPPUNIT_ASSERT(res == OS_SUCCESS);
+            res = mpMediaTask->startFlowGraph(*flowGraphs[i]);
+            CPPUNIT_ASSERT(res == OS_SUCCESS);
+        }
+        res = mpMediaTask->setWorkerThreads(3);
+        CPPUNIT_ASSERT(res == OS_SUCCESS);
+        res = MpMediaTask::signalFrameStart();  // signal the media task and
+        CPPUNIT_ASSERT(res == OS_SUCCESS);      // give it a chance to run
+        OsTask::delay(100);
+
+        CPPUNIT_ASSERT_EQUAL(3, mpMediaTask->getWorkerThreads());
+        CPPUNIT_ASSERT_EQUAL(NUM_WORKER_TEST_GRAPHS,
+                             mpMediaTask->numStartedFlowGraphs());
+
+        startFrames = mpMediaTask->numProcessedFrames();
+        for (i = 0; i < 10; i++)
+        {
+            res = MpMediaTask::signalFrameStart();
+            CPPUNIT_ASSERT(res == OS_SUCCESS);
+            OsTask::delay(10);
+        }
+        OsTask::delay(20);
+        CPPUNIT_ASSERT_EQUAL(startFrames + 10, mpMediaTask->numProcessedFrames());
+
+        // Every flow graph must have been processed by one of the threads
+        for (i = 0; i < NUM_WORKER_TEST_GRAPHS; i++)
+        {
+            CPPUNIT_ASSERT(flowGraphs[i]->numFramesProcessed() >= 10);
+            res = mpMediaTask->getFlowGraphProcessingTime(flowGraphs[i],
+                                                          lastUsecs, maxUsecs);
+            CPPUNIT_ASSERT(res == OS_SUCCESS);
+            CPPUNIT_ASSERT(lastUsecs >= 0);
+            CPPUNIT_ASSERT(maxUsecs >= lastUsecs);
+        }
+
+        pUnmanaged = new MpFlowGraphBase(30, 30);
+        res = mpMediaTask->getFlowGraphProcessingTime(pUnmanaged,
+                                                      lastUsecs, maxUsecs);
+        CPPUNIT_ASSERT(res == OS_NOT_FOUND);
+        delete pUnmanaged;
+
+        // Test 2: Go back to a single thread and clean up
+        res = mpMediaTask->setWorkerThreads(1);
+        CPPUNIT_ASSERT(res == OS_SUCCESS);
+        for (i = 0; i < NUM_WORKER_TEST_GRAPHS; i++)
+        {
+            res = mpMediaTask->unmanageFlowGraph(*flowGraphs[i]);
+            CPPUNIT_ASSERT(res == OS_SUCCESS);
+        }
+        res = MpMediaTask::signalFrameStart();  // signal the media task and
+        CPPUNIT_ASSERT(res == OS_SUCCESS);      // give it a chance to run
+        OsTask::delay(100);
+
+        CPPUNIT_ASSERT_EQUAL(1, mpMediaTask->getWorkerThreads());
+        CPPUNIT_ASSERT_EQUAL(0, mpMediaTask->numManagedFlowGraphs());
+
+        for (i = 0; i < NUM_WORKER_TEST_GRAPHS; i++)
+        {
+            delete flowGraphs[i];
+        }
+#undef NUM_WORKER_TEST_GRAPHS
+    }
+
 protected:
    MpMediaTask *mpMediaTask;
 };
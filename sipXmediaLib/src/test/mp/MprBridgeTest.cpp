@@ -13,6 +13,9 @@
 #include <mp/MpTestResource.h>
 #include <mp/MpMisc.h>
 #include <mp/MprBridge.h>
+#include <mp/MpBridgeAlgSimple.h>
+#include <mp/MpBridgeAlgLinear.h>
+#include <mp/MpBridgeAlgCommonMix.h>
 #include <mp/MpBufferMsg.h>
 #include <os/OsDateTime.h>
 
@@ -41,10 +44,18 @@ class MprBridgeTest : public MpGenericResourceTest
     CPPUNIT_TEST(testMixNormalWeights);
     CPPUNIT_TEST(testSimpleMixPerformance);
     CPPUNIT_TEST(testWBCommonTests);
+    CPPUNIT_TEST(testCommonMixAlgorithm);
+    CPPUNIT_TEST(testCommonMixMatchesSimple);
+    CPPUNIT_TEST(testBridgeAlgPerformance);
     CPPUNIT_TEST_SUITE_END();
 
 public:
 
+   MprBridgeTest()
+   : mAlgType(MprBridge::ALG_LINEAR)
+   {
+   }
+
    void testCreators()
    {
        MprBridge*        pBridge    = NULL;
@@ -201,7 +212,7 @@ public:
        const int         numParticipants = 4;
        MprBridge*        pBridge    = NULL;
 
-       pBridge = new MprBridge("MprBridge", numParticipants);
+       pBridge = new MprBridge("MprBridge", numParticipants, TRUE, mAlgType);
        CPPUNIT_ASSERT(pBridge != NULL);
 
        setupFramework(pBridge);
@@ -336,7 +347,7 @@ public:
        MprBridge*        pBridge    = NULL;
 
        CPPUNIT_ASSERT(numParticipants < 16);
-       pBridge = new MprBridge("MprBridge", numParticipants);
+       pBridge = new MprBridge("MprBridge", numParticipants, TRUE, mAlgType);
        CPPUNIT_ASSERT(pBridge != NULL);
 
        setupFramework(pBridge);
@@ -565,6 +576,210 @@ public:
          testSideBar();
       }
    } // end testWBCommonTests()
+
+   void testCommonMixAlgorithm()
+   {
+      // Mixing results of the common mix algorithm must be the same as
+      // of the other algorithms.
+      mAlgType = MprBridge::ALG_COMMON_MIX;
+      testMixNormalWeights();
+      testSideBar();
+      mAlgType = MprBridge::ALG_LINEAR;
+   }
+
+   void testCommonMixMatchesSimple()
+   {
+      // Compare the common mix algorithm with MpBridgeAlgSimple for random
+      // gain matrices and changing input amplitudes. Signals are kept low
+      // enough to not saturate accumulators.
+      const int numPorts = 12;
+      const int numFrames = 20;
+      const int samplesPerFrame = getSamplesPerFrame();
+      const MpBridgeGain gains[] = {MP_BRIDGE_GAIN_MUTED,
+                                    MP_BRIDGE_GAIN_PASSTHROUGH,
+                                    MPF_BRIDGE_FLOAT(0.5f),
+                                    MPF_BRIDGE_FLOAT(1.5f)};
+      const int numGains = sizeof(gains)/sizeof(gains[0]);
+      unsigned randomState = 1;
+
+      MpBridgeAlgSimple simpleAlg(numPorts, numPorts, TRUE, samplesPerFrame);
+      MpBridgeAlgCommonMix commonMixAlg(numPorts, numPorts, TRUE, samplesPerFrame);
+      MpBufPtr inBufs[numPorts];
+      MpBufPtr simpleOutBufs[numPorts];
+      MpBufPtr commonMixOutBufs[numPorts];
+
+      for (int frame=0; frame<numFrames; frame++)
+      {
+         // Change a few gains every few frames, so that both sparse and
+         // dense gain matrices are tested.
+         if (frame % 4 == 0)
+         {
+            for (int i=0; i<numPorts*(frame/4+1); i++)
+            {
+               int row = nextRandom(randomState) % numPorts;
+               int column = nextRandom(randomState) % numPorts;
+               MpBridgeGain gain = gains[nextRandom(randomState) % numGains];
+               simpleAlg.setGainMatrixValue(column, row, gain);
+               commonMixAlg.setGainMatrixValue(column, row, gain);
+            }
+         }
+
+         // Generate inputs. Some of them are missing or muted.
+         for (int in=0; in<numPorts; in++)
+         {
+            unsigned kind = nextRandom(randomState) % 8;
+            if (kind == 0)
+            {
+               inBufs[in].release();
+               continue;
+            }
+
+            MpAudioBufPtr pBuf = MpMisc.RawAudioPool->getBuffer();
+            CPPUNIT_ASSERT(pBuf.isValid());
+            pBuf->setSamplesNumber(samplesPerFrame);
+            pBuf->setSpeechType(kind == 1 ? MP_SPEECH_MUTED :
+                                kind == 2 ? MP_SPEECH_SILENT :
+                                            MP_SPEECH_ACTIVE);
+            pBuf->setAmplitude(kind == 3 ? MpSpeechParams::MAX_AMPLITUDE :
+               (MpAudioSample)(16384 + nextRandom(randomState) % 16384));
+            MpAudioSample *pSamples = pBuf->getSamplesWritePtr();
+            for (int i=0; i<samplesPerFrame; i++)
+            {
+               pSamples[i] = (MpAudioSample)(nextRandom(randomState) % 2001) - 1000;
+            }
+            inBufs[in] = pBuf;
+         }
+
+         CPPUNIT_ASSERT(simpleAlg.doMix(inBufs, numPorts, simpleOutBufs,
+                                        numPorts, samplesPerFrame));
+         CPPUNIT_ASSERT(commonMixAlg.doMix(inBufs, numPorts, commonMixOutBufs,
+                                           numPorts, samplesPerFrame));
+
+         for (int out=0; out<numPorts; out++)
+         {
+            MpAudioBufPtr pSimpleBuf = simpleOutBufs[out];
+            MpAudioBufPtr pCommonMixBuf = commonMixOutBufs[out];
+            CPPUNIT_ASSERT(pSimpleBuf.isValid());
+            const MpAudioSample *pSimpleSamples = pSimpleBuf->getSamplesPtr();
+
+            if (!pCommonMixBuf.isValid())
+            {
+               // Nothing was mixed to this output.
+               for (int i=0; i<samplesPerFrame; i++)
+               {
+                  CPPUNIT_ASSERT_EQUAL((MpAudioSample)0, pSimpleSamples[i]);
+               }
+               continue;
+            }
+
+            const MpAudioSample *pCommonMixSamples = pCommonMixBuf->getSamplesPtr();
+            CPPUNIT_ASSERT_EQUAL(pSimpleBuf->getAmplitude(),
+                                 pCommonMixBuf->getAmplitude());
+            CPPUNIT_ASSERT_EQUAL(pSimpleBuf->getSpeechType(),
+                                 pCommonMixBuf->getSpeechType());
+            for (int i=0; i<samplesPerFrame; i++)
+            {
+               CPPUNIT_ASSERT_EQUAL(pSimpleSamples[i], pCommonMixSamples[i]);
+            }
+         }
+      }
+   }
+
+   void testBridgeAlgPerformance()
+   {
+      // Compare mixing speed of all bridge algorithms for a conference,
+      // where every party hears all other parties.
+      const int numPortsList[] = {8, 32, 128};
+      const int numPortsListSize = sizeof(numPortsList)/sizeof(numPortsList[0]);
+      const int framesToProcess = 500;
+      const int samplesPerFrame = getSamplesPerFrame();
+      unsigned randomState = 1;
+
+      for (int n=0; n<numPortsListSize; n++)
+      {
+         const int numPorts = numPortsList[n];
+         MpBufPtr *inBufs = new MpBufPtr[numPorts];
+         MpBufPtr *outBufs = new MpBufPtr[numPorts];
+
+         for (int in=0; in<numPorts; in++)
+         {
+            MpAudioBufPtr pBuf = MpMisc.RawAudioPool->getBuffer();
+            CPPUNIT_ASSERT(pBuf.isValid());
+            pBuf->setSamplesNumber(samplesPerFrame);
+            pBuf->setSpeechType(MP_SPEECH_ACTIVE);
+            MpAudioSample *pSamples = pBuf->getSamplesWritePtr();
+            for (int i=0; i<samplesPerFrame; i++)
+            {
+               pSamples[i] = (MpAudioSample)(nextRandom(randomState) % 201) - 100;
+            }
+            inBufs[in] = pBuf;
+         }
+
+         for (int alg=MprBridge::ALG_SIMPLE; alg<=MprBridge::ALG_COMMON_MIX; alg++)
+         {
+            MpBridgeAlgBase *pAlg = NULL;
+            const char *algName = NULL;
+            switch (alg)
+            {
+            case MprBridge::ALG_SIMPLE:
+               pAlg = new MpBridgeAlgSimple(numPorts, numPorts, TRUE, samplesPerFrame);
+               algName = "simple";
+               break;
+            case MprBridge::ALG_LINEAR:
+               // Memory used by the linear algorithm grows as O(n^4).
+               if (numPorts <= 32)
+               {
+                  pAlg = new MpBridgeAlgLinear(numPorts, numPorts, TRUE, samplesPerFrame);
+               }
+               algName = "linear";
+               break;
+            case MprBridge::ALG_COMMON_MIX:
+               pAlg = new MpBridgeAlgCommonMix(numPorts, numPorts, TRUE, samplesPerFrame);
+               algName = "common mix";
+               break;
+            }
+            if (pAlg == NULL)
+            {
+               printf("%3d ports, %-10s: skipped\n", numPorts, algName);
+               continue;
+            }
+
+            OsTime start;
+            OsTime end;
+            OsDateTime::getCurTime(start);
+            for (int frameCount=0; frameCount<framesToProcess; frameCount++)
+            {
+               pAlg->doMix(inBufs, numPorts, outBufs, numPorts, samplesPerFrame);
+            }
+            OsDateTime::getCurTime(end);
+
+            OsTime lapse = end - start;
+            printf("%3d ports, %-10s: %6ld usec per frame\n",
+                   numPorts, algName,
+                   (lapse.seconds()*1000000 + lapse.usecs())/framesToProcess);
+
+            for (int out=0; out<numPorts; out++)
+            {
+               outBufs[out].release();
+            }
+            delete pAlg;
+         }
+
+         delete[] inBufs;
+         delete[] outBufs;
+      }
+   }
+
+protected:
+
+   MprBridge::AlgType mAlgType; ///< Bridge algorithm used by the tests
+                                ///< running a flowgraph.
+
+   static unsigned nextRandom(unsigned &state)
+   {
+      state = state*1103515245 + 12345;
+      return (state >> 16) & 0x7FFF;
+   }
 };
 
 
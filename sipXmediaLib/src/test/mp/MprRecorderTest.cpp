@@ -188,6 +188,8 @@ class MprRecorderTest : public MpGenericResourceTest
     CPPUNIT_TEST(testRecordToFileAppend);
     CPPUNIT_TEST(testRecordChannelToFileAppend);
     CPPUNIT_TEST(testRecordToPauseResumeFile);
+    CPPUNIT_TEST(testRecordToFileWriterThreads);
+    CPPUNIT_TEST(testRestartRecordToFileWriterThreads);
     CPPUNIT_TEST_SUITE_END();
 
     long getFileSize(const UtlString recordFileName)
@@ -1754,6 +1756,245 @@ class MprRecorderTest : public MpGenericResourceTest
 
     } // end testRecordToPauseResumeFile method
 
+    void testRecordToFileWriterThreads()
+    {
+        int numberOfTestFileTypes = sizeof(testFileTypes) / sizeof(MprRecorder::RecordFileFormat);
+        int framesPerSecond = 100; // 10 mSec frames
+        int sampleRate = 8000;
+
+        CPPUNIT_ASSERT_EQUAL(OS_INVALID_ARGUMENT, MprRecorder::setWriterThreads(-1));
+        CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, MprRecorder::setWriterThreads(2));
+        CPPUNIT_ASSERT_EQUAL(2, MprRecorder::getWriterThreads());
+
+        for(int fileTypeIndex = 0; fileTypeIndex < numberOfTestFileTypes; fileTypeIndex++)
+        {
+            MprRecorder::RecordFileFormat fileFormat = testFileTypes[fileTypeIndex];
+            UtlString loopLabel;
+            loopLabel.appendFormat("%s(%d) writer threads",
+                                   testFileTypeStrings[fileTypeIndex],
+                                   testFileTypes[fileTypeIndex]);
+
+            UtlString recordFilename;
+            UtlString recordFileExtension;
+            getFileExtension(fileFormat, recordFileExtension);
+            recordFilename.appendFormat("testRecordToFileWriter_%d.%s",
+                                        fileFormat,
+                                        recordFileExtension.data());
+
+            // Incase prior test left junk around
+            tearDown();
+
+            setSamplesPerSec(sampleRate);
+            setSamplesPerFrame(sampleRate/framesPerSecond);
+            setUp();
+
+            int framesToProcess = 500; // 5 seconds
+            UtlString recorderResourceName = "MprRecorder";
+            MprRecorder* recorder = new MprRecorder(recorderResourceName);
+            CPPUNIT_ASSERT(recorder);
+
+            // Build flowgraph with source, MprRecorder and sink resources
+            setupFramework(recorder);
+
+            mpSourceResource->setSignalAmplitude(0, 0x1 << 12);
+            mpSourceResource->setSignalPeriod(0, sampleRate / 250);
+            mpSourceResource->setOutSignalType(MpTestResource::MP_SINE);
+
+            // Add the notifier so that we get resource events
+            OsMsgQ resourceEventQueue;
+            OsMsgDispatcher messageDispatcher(&resourceEventQueue);
+            mpFlowGraph->setNotificationDispatcher(&messageDispatcher);
+
+            CPPUNIT_ASSERT_EQUAL(OS_SUCCESS,
+                                 MprRecorder::startFile(recorderResourceName,
+                                                        *mpFlowGraph->getMsgQ(),
+                                                        recordFilename,
+                                                        fileFormat));
+
+            CPPUNIT_ASSERT(mpSourceResource->enable());
+            CPPUNIT_ASSERT(recorder->enable());
+
+            for(int frameIndex = 0; frameIndex < framesToProcess; frameIndex++)
+            {
+                OsStatus frameStatus = mpFlowGraph->processNextFrame();
+                CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, frameStatus);
+            }
+
+            CPPUNIT_ASSERT_EQUAL(OS_SUCCESS,
+                                 MprRecorder::stop(recorderResourceName,
+                                                   *mpFlowGraph->getMsgQ()));
+            CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, mpFlowGraph->processNextFrame());
+
+            // The writer thread sends the stop notification once the file
+            // is closed.  Frames may have been dropped if it fell behind.
+            OsTime notificationWait(5, 0);
+            OsMsg* messagePtr = NULL;
+            int droppedNotifications = 0;
+            int samplesRecorded = -1;
+            while(samplesRecorded < 0 &&
+                  messageDispatcher.receive(messagePtr, notificationWait) == OS_SUCCESS)
+            {
+                CPPUNIT_ASSERT_EQUAL(OsMsg::MP_RES_NOTF_MSG, (OsMsg::MsgTypes) messagePtr->getMsgType());
+                int subType = messagePtr->getMsgSubType();
+                if(subType == MpResNotificationMsg::MPRNM_RECORDER_FRAMES_DROPPED)
+                {
+                    droppedNotifications++;
+                }
+                else if(subType == MpResNotificationMsg::MPRNM_RECORDER_STOPPED)
+                {
+                    samplesRecorded = ((MprnIntMsg*) messagePtr)->getValue();
+                }
+                else
+                {
+                    CPPUNIT_ASSERT_EQUAL((int) MpResNotificationMsg::MPRNM_RECORDER_STARTED, subType);
+                }
+                messagePtr->releaseMsg();
+            }
+
+            int droppedFrames = recorder->getDroppedFrames();
+            CPPUNIT_ASSERT_EQUAL((droppedFrames > 0), (droppedNotifications > 0));
+            CPPUNIT_ASSERT(recorder->getMaxQueuedFrames() > 0);
+            CPPUNIT_ASSERT(recorder->getMaxQueuedFrames() <= MPR_RECORDER_QUEUE_FRAMES);
+            CPPUNIT_ASSERT_EQUAL((framesToProcess - droppedFrames) * sampleRate / framesPerSecond,
+                                 samplesRecorded);
+
+            unsigned long headerSize = 0;
+            unsigned long audioDataSize = 0;
+            unsigned long fileSizeSlop = 0;
+            getFileSizeParameters(fileFormat, 1, samplesRecorded, framesToProcess - droppedFrames, framesPerSecond, sampleRate,
+                                  headerSize, audioDataSize, fileSizeSlop);
+            validateFileSize(recordFilename, headerSize, audioDataSize, fileSizeSlop, loopLabel);
+
+            haltFramework();
+
+        }  // end for iteration over file formats
+
+        CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, MprRecorder::setWriterThreads(0));
+        CPPUNIT_ASSERT_EQUAL(0, MprRecorder::getWriterThreads());
+
+    } // end testRecordToFileWriterThreads method
+
+    void testRestartRecordToFileWriterThreads()
+    {
+        int framesPerSecond = 100; // 10 mSec frames
+        int sampleRate = 8000;
+        int framesToProcess = 100; // Less than MPR_RECORDER_QUEUE_FRAMES, so none are dropped
+        const int numRecordings = 3;
+        MprRecorder::RecordFileFormat fileFormat = MprRecorder::WAV_PCM_16;
+
+        CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, MprRecorder::setWriterThreads(1));
+
+        // Incase prior test left junk around
+        tearDown();
+
+        setSamplesPerSec(sampleRate);
+        setSamplesPerFrame(sampleRate/framesPerSecond);
+        setUp();
+
+        UtlString recorderResourceName = "MprRecorder";
+        MprRecorder* recorder = new MprRecorder(recorderResourceName);
+        CPPUNIT_ASSERT(recorder);
+
+        // Build flowgraph with source, MprRecorder and sink resources
+        setupFramework(recorder);
+
+        mpSourceResource->setSignalAmplitude(0, 0x1 << 12);
+        mpSourceResource->setSignalPeriod(0, sampleRate / 250);
+        mpSourceResource->setOutSignalType(MpTestResource::MP_SINE);
+
+        // Add the notifier so that we get resource events
+        OsMsgQ resourceEventQueue;
+        OsMsgDispatcher messageDispatcher(&resourceEventQueue);
+        mpFlowGraph->setNotificationDispatcher(&messageDispatcher);
+
+        UtlString recordFilenames[numRecordings];
+        for(int recordingIndex = 0; recordingIndex < numRecordings; recordingIndex++)
+        {
+            recordFilenames[recordingIndex].appendFormat("testRestartRecordToFileWriter_%d.wav",
+                                                         recordingIndex);
+
+            // The first recording is replaced before it is stopped, the
+            // second is stopped in the same frame the third starts in.
+            if(recordingIndex == 2)
+            {
+                CPPUNIT_ASSERT_EQUAL(OS_SUCCESS,
+                                     MprRecorder::stop(recorderResourceName,
+                                                       *mpFlowGraph->getMsgQ()));
+            }
+            CPPUNIT_ASSERT_EQUAL(OS_SUCCESS,
+                                 MprRecorder::startFile(recorderResourceName,
+                                                        *mpFlowGraph->getMsgQ(),
+                                                        recordFilenames[recordingIndex],
+                                                        fileFormat));
+            if(recordingIndex == 0)
+            {
+                CPPUNIT_ASSERT(mpSourceResource->enable());
+                CPPUNIT_ASSERT(recorder->enable());
+            }
+
+            for(int frameIndex = 0; frameIndex < framesToProcess; frameIndex++)
+            {
+                CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, mpFlowGraph->processNextFrame());
+            }
+        }
+
+        CPPUNIT_ASSERT_EQUAL(OS_SUCCESS,
+                             MprRecorder::stop(recorderResourceName,
+                                               *mpFlowGraph->getMsgQ()));
+        CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, mpFlowGraph->processNextFrame());
+
+        // Only the two recordings that were stopped notify it, and the
+        // replaced one was closed without waiting for the writer.
+        OsTime notificationWait(5, 0);
+        OsMsg* messagePtr = NULL;
+        int startedNotifications = 0;
+        int stoppedNotifications = 0;
+        while(stoppedNotifications < 2 &&
+              messageDispatcher.receive(messagePtr, notificationWait) == OS_SUCCESS)
+        {
+            CPPUNIT_ASSERT_EQUAL(OsMsg::MP_RES_NOTF_MSG, (OsMsg::MsgTypes) messagePtr->getMsgType());
+            int subType = messagePtr->getMsgSubType();
+            if(subType == MpResNotificationMsg::MPRNM_RECORDER_STOPPED)
+            {
+                stoppedNotifications++;
+                CPPUNIT_ASSERT_EQUAL(framesToProcess * sampleRate / framesPerSecond,
+                                     ((MprnIntMsg*) messagePtr)->getValue());
+            }
+            else
+            {
+                CPPUNIT_ASSERT_EQUAL((int) MpResNotificationMsg::MPRNM_RECORDER_STARTED, subType);
+                startedNotifications++;
+            }
+            messagePtr->releaseMsg();
+        }
+        CPPUNIT_ASSERT_EQUAL(numRecordings, startedNotifications);
+        CPPUNIT_ASSERT_EQUAL(2, stoppedNotifications);
+        CPPUNIT_ASSERT_EQUAL(0, recorder->getDroppedFrames());
+
+        haltFramework();
+
+        // The writer may still be closing the replaced recording
+        OsStatus stopStatus;
+        for(int waitIndex = 0;
+            (stopStatus = MprRecorder::setWriterThreads(0)) == OS_BUSY && waitIndex < 500;
+            waitIndex++)
+        {
+            OsTask::delay(10);
+        }
+        CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, stopStatus);
+
+        for(int recordingIndex = 0; recordingIndex < numRecordings; recordingIndex++)
+        {
+            unsigned long headerSize = 0;
+            unsigned long audioDataSize = 0;
+            unsigned long fileSizeSlop = 0;
+            getFileSizeParameters(fileFormat, 1, framesToProcess * sampleRate / framesPerSecond, framesToProcess, framesPerSecond, sampleRate,
+                                  headerSize, audioDataSize, fileSizeSlop);
+            validateFileSize(recordFilenames[recordingIndex], headerSize, audioDataSize, fileSizeSlop, recordFilenames[recordingIndex]);
+        }
+
+    } // end testRestartRecordToFileWriterThreads method
+
 }; // end MprRecorderTest class
            
 
@@ -0,0 +1,235 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+#include <os/OsIntTypes.h>
+#include <sipxunittests.h>
+
+// Setup codec paths..
+#include <../test/mp/MpTestCodecPaths.h>
+
+#include <os/OsDatagramSocket.h>
+#include <os/OsLock.h>
+#include <os/OsMutex.h>
+#include <os/OsTask.h>
+#include <mp/MpMisc.h>
+#include <mp/MprFromNet.h>
+#include <mp/MprRtpDispatcher.h>
+#include <mp/NetInTask.h>
+
+#define TEST_SAMPLES_PER_FRAME   80     ///< in samples
+#define TEST_SAMPLES_PER_SECOND  8000   ///< in samples/sec (Hz)
+#define TEST_PAIRS               4      ///< RTP/RTCP socket pairs
+#define TEST_BURST_PACKETS       100    ///< More than NET_TASK_RECV_QUOTA
+#define TEST_WAIT_MS             5000
+#define TEST_PAYLOAD_SIZE        20
+
+/// RTP dispatcher counting the packets NetInTask delivers to its MprFromNet.
+class NetInTestDispatcher : public MprRtpDispatcher
+{
+public:
+   NetInTestDispatcher()
+   : MprRtpDispatcher("NetInTest", 0)
+   , mMutex(OsMutex::Q_FIFO)
+   , mNumPackets(0)
+   , mNextSeq(0)
+   , mInOrder(TRUE)
+   {
+   }
+
+   OsStatus pushPacket(MpRtpBufPtr &pRtp)
+   {
+      OsLock lock(mMutex);
+      if (pRtp->getRtpSequenceNumber() != mNextSeq)
+      {
+         mInOrder = FALSE;
+      }
+      mNextSeq = pRtp->getRtpSequenceNumber() + 1;
+      mNumPackets++;
+      pRtp.release();
+      return OS_SUCCESS;
+   }
+
+   void checkRtpStreamsActivity() {}
+   UtlBoolean connectOutput(int outputIdx, MpResource* pushRtpToResource)
+   {
+      return FALSE;
+   }
+   UtlBoolean disconnectOutput(int outputIdx) { return FALSE; }
+
+   int numPackets()
+   {
+      OsLock lock(mMutex);
+      return mNumPackets;
+   }
+
+   UtlBoolean isInOrder()
+   {
+      OsLock lock(mMutex);
+      return mInOrder;
+   }
+
+   // Wait until the dispatcher has got the given number of packets.
+   UtlBoolean waitForPackets(int numPackets)
+   {
+      for (int i = 0; i < TEST_WAIT_MS/10 && this->numPackets() < numPackets; i++)
+      {
+         OsTask::delay(10);
+      }
+      return this->numPackets() >= numPackets;
+   }
+
+   OsMutex mMutex;
+   int mNumPackets;
+   RtpSeq mNextSeq;
+   UtlBoolean mInOrder;
+};
+
+/**
+ * Unit test for NetInTask: RTP/RTCP socket pairs added to and removed from
+ * the task, and packets delivered to the MprFromNet of each pair.  Covers
+ * the epoll loop with NET_IN_TASK_USE_EPOLL, the select() loop otherwise.
+ */
+class NetInTaskTest : public SIPX_UNIT_BASE_CLASS
+{
+   CPPUNIT_TEST_SUITE(NetInTaskTest);
+   CPPUNIT_TEST(testBurst);
+   CPPUNIT_TEST(testAddRemove);
+   CPPUNIT_TEST_SUITE_END();
+
+public:
+
+   void setUp()
+   {
+      CPPUNIT_ASSERT_EQUAL(OS_SUCCESS,
+                           mpStartUp(TEST_SAMPLES_PER_SECOND,
+                                     TEST_SAMPLES_PER_FRAME, 6*10, 0,
+                                     sNumCodecPaths, sCodecPaths));
+      for (int i = 0; i < TEST_PAIRS; i++)
+      {
+         mpRtpSockets[i] = new OsDatagramSocket(0, NULL, PORT_DEFAULT,
+                                                "127.0.0.1");
+         CPPUNIT_ASSERT(mpRtpSockets[i]->isOk());
+         mpRtcpSockets[i] = new OsDatagramSocket(0, NULL, PORT_DEFAULT,
+                                                 "127.0.0.1");
+         CPPUNIT_ASSERT(mpRtcpSockets[i]->isOk());
+         mpSenders[i] = new OsDatagramSocket(mpRtpSockets[i]->getLocalHostPort(),
+                                             "127.0.0.1");
+         CPPUNIT_ASSERT(mpSenders[i]->isOk());
+         mpDispatchers[i] = new NetInTestDispatcher();
+         mpFromNets[i] = new MprFromNet();
+         mpFromNets[i]->setRtpDispatcher(mpDispatchers[i]);
+         mSeqs[i] = 0;
+      }
+   }
+
+   void tearDown()
+   {
+      for (int i = 0; i < TEST_PAIRS; i++)
+      {
+         // Takes the sockets out of NetInTask before they are deleted.
+         delete mpFromNets[i];
+         delete mpDispatchers[i];
+         delete mpSenders[i];
+         delete mpRtcpSockets[i];
+         delete mpRtpSockets[i];
+      }
+      CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, mpShutdown());
+   }
+
+   // Send RTP packets to the RTP socket of a pair, numbered in sequence.
+   void sendPackets(int pair, int numPackets)
+   {
+      unsigned char packet[12 + TEST_PAYLOAD_SIZE];
+      memset(packet, 0, sizeof(packet));
+      packet[0] = 0x80;          // version 2
+      packet[11] = (unsigned char) (pair + 1); // SSRC
+
+      for (int i = 0; i < numPackets; i++)
+      {
+         packet[2] = (unsigned char) (mSeqs[pair] >> 8);
+         packet[3] = (unsigned char) mSeqs[pair];
+         mSeqs[pair]++;
+         CPPUNIT_ASSERT_EQUAL((int) sizeof(packet),
+                              mpSenders[pair]->write((char*) packet,
+                                                     sizeof(packet)));
+      }
+   }
+
+   void testBurst()
+   {
+      int i;
+      for (i = 0; i < TEST_PAIRS; i++)
+      {
+         CPPUNIT_ASSERT_EQUAL(OS_SUCCESS,
+                              mpFromNets[i]->setSockets(*mpRtpSockets[i],
+                                                        *mpRtcpSockets[i]));
+      }
+
+      // Bursts to all the pairs at once, each more than one socket may be
+      // read for in a turn, so the sockets are read in several turns.
+      for (int packetNum = 0; packetNum < TEST_BURST_PACKETS; packetNum += 10)
+      {
+         for (i = 0; i < TEST_PAIRS; i++)
+         {
+            sendPackets(i, 10);
+         }
+      }
+
+      for (i = 0; i < TEST_PAIRS; i++)
+      {
+         CPPUNIT_ASSERT(mpDispatchers[i]->waitForPackets(TEST_BURST_PACKETS));
+         CPPUNIT_ASSERT_EQUAL(TEST_BURST_PACKETS, mpDispatchers[i]->numPackets());
+         CPPUNIT_ASSERT(mpDispatchers[i]->isInOrder());
+      }
+   }
+
+   void testAddRemove()
+   {
+      CPPUNIT_ASSERT_EQUAL(OS_SUCCESS,
+                           mpFromNets[0]->setSockets(*mpRtpSockets[0],
+                                                     *mpRtcpSockets[0]));
+      CPPUNIT_ASSERT_EQUAL(OS_SUCCESS,
+                           mpFromNets[1]->setSockets(*mpRtpSockets[1],
+                                                     *mpRtcpSockets[1]));
+      sendPackets(0, TEST_BURST_PACKETS);
+      sendPackets(1, TEST_BURST_PACKETS);
+      CPPUNIT_ASSERT(mpDispatchers[0]->waitForPackets(TEST_BURST_PACKETS));
+      CPPUNIT_ASSERT(mpDispatchers[1]->waitForPackets(TEST_BURST_PACKETS));
+
+      // Nothing is delivered for a pair once it is removed, while the
+      // other pair goes on receiving.
+      CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, mpFromNets[0]->resetSockets());
+      sendPackets(0, TEST_BURST_PACKETS);
+      sendPackets(1, TEST_BURST_PACKETS);
+      CPPUNIT_ASSERT(mpDispatchers[1]->waitForPackets(2*TEST_BURST_PACKETS));
+      OsTask::delay(100);
+      CPPUNIT_ASSERT_EQUAL(TEST_BURST_PACKETS, mpDispatchers[0]->numPackets());
+      CPPUNIT_ASSERT_EQUAL(2*TEST_BURST_PACKETS, mpDispatchers[1]->numPackets());
+      CPPUNIT_ASSERT(mpDispatchers[1]->isInOrder());
+
+      // Adding the pair again drops what arrived meanwhile, and delivers
+      // what comes after.
+      CPPUNIT_ASSERT_EQUAL(OS_SUCCESS,
+                           mpFromNets[0]->setSockets(*mpRtpSockets[0],
+                                                     *mpRtcpSockets[0]));
+      mpDispatchers[0]->mNextSeq = mSeqs[0];
+      sendPackets(0, TEST_BURST_PACKETS);
+      CPPUNIT_ASSERT(mpDispatchers[0]->waitForPackets(2*TEST_BURST_PACKETS));
+      CPPUNIT_ASSERT_EQUAL(2*TEST_BURST_PACKETS, mpDispatchers[0]->numPackets());
+      CPPUNIT_ASSERT(mpDispatchers[0]->isInOrder());
+   }
+
+private:
+   OsDatagramSocket* mpRtpSockets[TEST_PAIRS];
+   OsDatagramSocket* mpRtcpSockets[TEST_PAIRS];
+   OsDatagramSocket* mpSenders[TEST_PAIRS];
+   MprFromNet* mpFromNets[TEST_PAIRS];
+   NetInTestDispatcher* mpDispatchers[TEST_PAIRS];
+   RtpSeq mSeqs[TEST_PAIRS];
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(NetInTaskTest);
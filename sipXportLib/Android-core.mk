@@ -125,6 +125,7 @@ LOCAL_SRC_FILES := \
     src/os/StunMessage.cpp \
     src/os/StunUtils.cpp \
     src/os/TurnMessage.cpp \
+    src/os/shared/OsMsgQLockFree.cpp \
     src/os/shared/OsMsgQShared.cpp \
     src/os/shared/OsTimerMessage.cpp \
     src/os/linux/clock_gettime.c \
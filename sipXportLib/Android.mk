@@ -129,6 +129,7 @@ LOCAL_SRC_FILES := \
     src/os/OsSysLog.cpp \
     src/os/OsSysLogFacilities.cpp \
     src/os/OsSysLogMsg.cpp \
+    src/os/OsSysLogRecordBuffer.cpp \
     src/os/OsSysLogTask.cpp \
     src/os/OsTask.cpp \
     src/os/OsTime.cpp \
@@ -144,6 +145,7 @@ LOCAL_SRC_FILES := \
     src/os/StunMessage.cpp \
     src/os/StunUtils.cpp \
     src/os/TurnMessage.cpp \
+    src/os/shared/OsMsgQLockFree.cpp \
     src/os/shared/OsMsgQShared.cpp \
     src/os/shared/OsTimerMessage.cpp \
     src/os/linux/clock_gettime.c \
@@ -313,6 +315,7 @@ LOCAL_SRC_FILES := \
   src/test/os/OsServerTaskTest.cpp \
   src/test/os/OsSharedLibMgrTest.cpp \
   src/test/os/OsSocketTest.cpp \
+  src/test/os/OsSysLogTest.cpp \
   src/test/os/OsTestUtilities.cpp \
   src/test/os/OsTimeTest.cpp \
   src/test/os/OsTimerTaskTest.cpp \
@@ -410,6 +413,7 @@ LOCAL_SRC_FILES := \
   src/test/os/OsServerTaskTest.cpp \
   src/test/os/OsSharedLibMgrTest.cpp \
   src/test/os/OsSocketTest.cpp \
+  src/test/os/OsSysLogTest.cpp \
   src/test/os/OsTestUtilities.cpp \
   src/test/os/OsTimeTest.cpp \
   src/test/os/OsTimerTaskTest.cpp \
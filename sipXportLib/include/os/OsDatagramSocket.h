@@ -22,6 +22,11 @@
 #include <os/OsSocket.h>
 
 // DEFINES
+#if defined(__linux__)
+#  define OS_DATAGRAM_BATCH_READS   // readBatch() uses recvmmsg()
+#endif
+#define OS_DATAGRAM_MAX_BATCH 64    // Most datagrams returned by a readBatch()
+
 // MACROS
 // EXTERNAL FUNCTIONS
 // EXTERNAL VARIABLES
@@ -43,8 +48,12 @@ public:
    
    OsDatagramSocket(int remoteHostPort, const char* remoteHostName,
                     int localHostPort = PORT_DEFAULT,
-                    const char* localHostName = NULL);
+                    const char* localHostName = NULL,
+                    UtlBoolean reusePort = FALSE);
      //:Constructor
+     //!param: reusePort - set SO_REUSEPORT before binding, so that several
+     //        sockets can share the local port and the kernel spreads the
+     //        incoming datagrams over them (where supported).
 
    virtual
    ~OsDatagramSocket();
@@ -84,6 +93,35 @@ public:
 
    virtual int read(char* buffer, int bufferLength);
 
+   virtual int readBatch(char* buffers, int bufferLength, int maxPackets,
+                         int* packetLengths,
+                         UtlString* fromAddresses, int* fromPorts);
+   //: Read the datagrams waiting on the socket, without blocking
+   // Reads at most maxPackets (and at most OS_DATAGRAM_MAX_BATCH)
+   // datagrams, the i-th one into buffers + i * bufferLength.  With
+   // OS_DATAGRAM_BATCH_READS this takes a single recvmmsg() call.
+   //! param: packetLengths - receives the length of each datagram
+   //! param: fromAddresses - receives the source of each datagram, or NULL
+   //! param: fromPorts - receives the source port of each datagram, or NULL
+   //! returns: the number of datagrams read, 0 if none were waiting,
+   //!          -1 on error
+
+#ifdef OS_DATAGRAM_BATCH_READS
+   static int recvBatch(int socketDescriptor, char* const* buffers,
+                        int bufferLength, int maxPackets, int* packetLengths,
+                        struct in_addr* fromIps, int* fromPorts);
+   //: Read the datagrams waiting on a descriptor with one recvmmsg() call
+   // For callers which read into buffers of their own, as readBatch() does.
+   // Reads at most maxPackets (and at most OS_DATAGRAM_MAX_BATCH)
+   // datagrams, the i-th one into buffers[i].
+   //! param: bufferLength - the size of each of the buffers
+   //! param: packetLengths - receives the length of each datagram
+   //! param: fromIps - receives the source of each datagram, or NULL
+   //! param: fromPorts - receives the source port of each datagram, or NULL
+   //! returns: the number of datagrams read, 0 if none were waiting,
+   //!          -1 on error (with errno set)
+#endif
+
 /* ============================ ACCESSORS ================================= */
    virtual OsSocket::IpProtocolSocketType getIpProtocol() const;
    //: Returns the protocol type of this socket
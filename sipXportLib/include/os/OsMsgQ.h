@@ -48,7 +48,9 @@ public:
    enum Options
    {
       Q_FIFO     = 0x0, ///< queue blocked tasks on a first-in, first-out basis
-      Q_PRIORITY = 0x1  ///< queue blocked tasks based on their priority
+      Q_PRIORITY = 0x1, ///< queue blocked tasks based on their priority
+      Q_LOCK_FREE = 0x2 ///< use the lock-free single-receiver implementation
+                        ///<  (OsMsgQLockFree) where it is available
    };
 
 
@@ -119,12 +119,15 @@ public:
      *        to bind on.
      * @param pNotification Optional notification event that is signaled upon
      *        the initial successful stun response or on failure.
+     * @param reusePort Share the local port with other sockets created
+     *        with reusePort (SO_REUSEPORT).
      */
     OsNatDatagramSocket(int remoteHostPort, 
                         const char* remoteHostName, 
                         int localHostPort = PORT_DEFAULT,
                         const char* localHostName = NULL,
-                        OsNotification* pNotification = NULL) ;
+                        OsNotification* pNotification = NULL,
+                        UtlBoolean reusePort = FALSE) ;
 
     /**
      * Standard Destructor
@@ -157,6 +160,15 @@ public:
      */
     virtual int read(char* buffer, int bufferLength, long waitMilliseconds);
 
+    /**
+     * Batch read, see OsDatagramSocket for details.  STUN and TURN packets
+     * are handled as by read(): unless reads are transparent, their
+     * length is set to 0.
+     */
+    virtual int readBatch(char* buffers, int bufferLength, int maxPackets,
+                          int* packetLengths,
+                          UtlString* fromAddresses, int* fromPorts);
+
 
     /**
      * Standard write, see OsDatagramSocket for details.
@@ -351,6 +363,8 @@ public:
 
 /* ============================ INQUIRY =================================== */
 
+    /// STUN and TURN packets are consumed by read().
+    virtual UtlBoolean hasRawReads() const;
 
 /* //////////////////////////// PROTECTED ///////////////////////////////// */
 protected:
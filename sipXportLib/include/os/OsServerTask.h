@@ -46,7 +46,8 @@ public:
                 const int maxRequestQMsgs=DEF_MAX_MSGS,
                 const int priority=DEF_PRIO,
                 const int options=DEF_OPTIONS,
-                const int stackSize=DEF_STACKSIZE);
+                const int stackSize=DEF_STACKSIZE,
+                const int queueOptions=OsMsgQBase::Q_PRIORITY);
      /**<
      *  @param[in] name - the name of this OsServerTask
      *  @param[in] pArg - argument that is passed to the new thread as a
@@ -56,6 +57,8 @@ public:
      *  @param[in] options - Thread execution options to set, such as whether
      *             to allow breakpoint debugging.
      *  @param[in] stackSize - The stack size to use for this task.
+     *  @param[in] queueOptions - Options for the request message queue.
+     *             Add OsMsgQBase::Q_LOCK_FREE to use the lock-free queue.
      */
 
    virtual
@@ -288,6 +288,12 @@ public:
    virtual UtlBoolean isReadyToWrite(long waitMilliseconds = 0) const;
    //:Poll if socket is able to write without blocking
 
+   virtual UtlBoolean hasRawReads() const;
+   //:Returns TRUE if read() returns data exactly as received by the descriptor
+   // Sockets which consume or transform data in read() (e.g. STUN/TURN
+   // handling or decryption) return FALSE.  Callers must not receive
+   // directly from the descriptor of such a socket.
+
    static UtlBoolean isIp4Address(const char* address);
    //:Is the address a dotted IP4 address
    // (i.e., nnn.nnn.nnn.nnn where 0 <= nnn <= 255)
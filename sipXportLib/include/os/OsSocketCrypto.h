@@ -238,6 +238,12 @@ public:
       return mCryptoProxy.read(buffer, bufferLength, waitMilliseconds);
    }
 
+   UtlBoolean hasRawReads() const
+   {
+      // Data is decrypted by read().
+      return FALSE;
+   }
+
 protected:
    int writeProxy1(const char* buffer, int bufferLength)
    {
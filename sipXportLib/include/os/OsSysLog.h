@@ -204,7 +204,8 @@ public:
    enum OsSysLogOptions
    {
         OPT_NONE           = 0x00000000,     // No Options
-        OPT_SHARED_LOGFILE = 0x00000001      // Assume a shared log file
+        OPT_SHARED_LOGFILE = 0x00000001,     // Assume a shared log file
+        OPT_RECORD_BUFFERS = 0x00000002      // Format log events in the log task
 
      // NOTE: Options are designed to be used as bitmasks (and ORed together).
      //       Make sure new additions are defined as power of twos (0x01,
@@ -218,6 +219,13 @@ public:
   //           multiple loggers (processes) to write to the same log file.
   //           This option should only be set if required to avoid
   //           performance hits.
+  //
+  //!enumcode: OPT_RECORD_BUFFERS - Log events are not formatted by the
+  //           thread adding them.  Their format strings and arguments are
+  //           stored in a buffer of the thread, and the OsSysLogTask formats
+  //           them.  If the buffer of a thread is full, its events are
+  //           dropped (see getDroppedRecords()).  Ignored if a pre-queue
+  //           callback is set.  See OsSysLogRecordBuffer.
 
 /* ============================ CREATORS ================================== */
 
@@ -411,6 +419,10 @@ public:
 
 /* ============================ ACCESSORS ================================= */
 
+   static unsigned long getDroppedRecords() ;
+     //:Number of log events dropped because the record buffer of their
+     //:thread was full (OPT_RECORD_BUFFERS only).
+
    static OsStatus getMaxInMemoryLogEntries(int& maxEntries) ;
      //:Obtains the maximum number of in-memory log entries.
      // This value is specified as part of initialize() process and cannot
@@ -475,9 +487,11 @@ public:
      // allow developers to dynamically increase verbosity for a specific
      // facility.
 
-   static UtlBoolean willLog(OsSysLogFacility facility, OsSysLogPriority priority) ;
+   static inline UtlBoolean willLog(OsSysLogFacility facility, OsSysLogPriority priority) ;
      //:Determine if a message of a given facility/priority will be logged or
      //:digarded.
+     // Inline, so that callers can test it before building log arguments
+     // at the cost of a comparison.
 
    static int getNumFacilities();
      //:Return the number of available facilities.
@@ -488,6 +502,8 @@ public:
 
 /* //////////////////////////// PROTECTED ///////////////////////////////// */
 protected:
+   friend class OsSysLogRecordBuffer;
+
    static OsAtomicLightPtr<OsSysLogTask> spOsSysLogTask;
 
    static OsAtomicULong sEventCount;
@@ -496,6 +512,7 @@ protected:
    static UtlString sProcessId;
    static UtlString sHostname;
    static UtlBoolean bPrioritiesInitialized;
+   static UtlBoolean sRecordBuffers;
 
    OsSysLog(const OsSysLog& rOsSysLog);
      //:Copy constructor
@@ -518,6 +535,15 @@ protected:
    static void getTaskInfo(UtlString& taskName, OsTaskId_t& taskId);
      //:Get current task name and id
 
+   static void formatEntry(UtlString& logEntry,
+                           const OsTime& time,
+                           const OsSysLogFacility facility,
+                           const OsSysLogPriority priority,
+                           const char* taskName,
+                           const OsTaskId_t taskId,
+                           const UtlString& logData);
+     //:Build a log entry from its escaped data, numbering it
+
 /* //////////////////////////// PRIVATE /////////////////////////////////// */
 private:
 
@@ -563,4 +589,19 @@ private:
 
 /* ============================ INLINE METHODS ============================ */
 
+// Determine if a message will be logged given a facility and priority
+inline UtlBoolean OsSysLog::willLog(OsSysLogFacility facility,
+                                    OsSysLogPriority priority)
+{
+   if ((unsigned int) facility >= (unsigned int) FAC_MAX_FACILITY)
+   {
+      return FALSE;
+   }
+   if (!bPrioritiesInitialized)
+   {
+      initializePriorities();
+   }
+   return (spPriorities[facility] <= priority);
+}
+
 #endif  // _OsSysLog_h_
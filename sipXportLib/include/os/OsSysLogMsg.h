@@ -46,7 +46,8 @@ public:
       ADD_SOCKET,       // Add a target output socket
       SET_FLUSH_PERIOD, // Set the flush period
       FLUSH_LOG,        // Flush the log (write to disk)
-      SET_CALLBACK      // Set the callback function
+      SET_CALLBACK,     // Set the callback function
+      DRAIN_RECORDS     // Format the records of the record buffers
    } ;
   //: Defines the various SysLog Msg Subtypes
   //
@@ -60,6 +61,8 @@ public:
   //!enumcode: ADD_SOCKET - Add a target output socket
   //!enumcode: SET_FLUSH_PERIOD - Set the flush period
   //!enumcode: FLUSH_LOG - Flush the log (write to disk)
+  //!enumcode: SET_CALLBACK - Set the callback function
+  //!enumcode: DRAIN_RECORDS - Format the records of the record buffers
 
 
 /* ============================ CREATORS ================================== */
@@ -0,0 +1,112 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+#ifndef _OsSysLogRecordBuffer_h_
+#define _OsSysLogRecordBuffer_h_
+
+// SYSTEM INCLUDES
+#include <stdarg.h>
+
+// APPLICATION INCLUDES
+#include <os/OsSysLog.h>
+
+// DEFINES
+#if defined(__pingtel_on_posix__) && defined(__GNUC__) && !defined(ANDROID) \
+    && !defined(OSSYSLOG_NO_RECORD_BUFFERS)
+#  define OSSYSLOG_RECORD_BUFFERS
+#endif
+
+#ifndef OSSYSLOG_RECORD_BUFFER_SIZE
+#  define OSSYSLOG_RECORD_BUFFER_SIZE 65536   // Bytes per thread, a power of two
+#endif
+
+// MACROS
+// EXTERNAL FUNCTIONS
+// EXTERNAL VARIABLES
+// CONSTANTS
+// STRUCTS
+// TYPEDEFS
+// FORWARD DECLARATIONS
+
+//:Per-thread buffers of binary log records, formatted by the OsSysLogTask
+// When OsSysLog is initialized with OPT_RECORD_BUFFERS, a log event is not
+// formatted by the thread adding it.  The format string and the arguments
+// are copied as they are into a record in a ring buffer owned by the
+// thread: numbers in binary and strings up to their terminating null.
+// The OsSysLogTask takes the records out of all the buffers, oldest first,
+// formats them and adds them to the log as if they had been posted to it.
+//
+// A buffer has one writer, its thread, and one reader, the OsSysLogTask,
+// so neither side takes a lock.  The OsSysLogTask is only sent a message
+// when it is not already going to look at the buffers.  A buffer is
+// allocated the first time its thread logs a record, and it is freed once
+// the thread has exited and the OsSysLogTask has emptied it.
+//
+// When the buffer of a thread is full, records are dropped rather than
+// waiting for the OsSysLogTask.  Dropped records are counted, and the
+// count is logged once the buffers have been emptied.
+//
+// Events which cannot be recorded are formatted and posted as before:
+// events larger than a quarter of a buffer and format strings with
+// conversions the recorder does not know (%n, %m, %ls, %lc).
+//
+// Record buffers are only built with GCC on POSIX systems; elsewhere
+// add() always returns OS_NOT_SUPPORTED.
+class OsSysLogRecordBuffer
+{
+/* //////////////////////////// PUBLIC //////////////////////////////////// */
+public:
+
+/* ============================ MANIPULATORS ============================== */
+
+   static OsStatus add(const char*            taskName,
+                       const OsTaskId_t       taskId,
+                       const OsSysLogFacility facility,
+                       const OsSysLogPriority priority,
+                       const char*            format,
+                       va_list                ap);
+     //:Store a log event in the buffer of the calling thread
+     // ap is not used up, so the caller can still format it.
+     //
+     //!param: taskName - The name of the task, or NULL to use the name and
+     //        id of the task of the calling thread.  They are looked up
+     //        once per thread.
+     //!returns: OS_SUCCESS if the event was recorded (or discarded because
+     //          it is from the syslog task), OS_LIMIT_REACHED if the buffer
+     //          was full and the event was dropped, OS_NOT_SUPPORTED if the
+     //          event cannot be recorded and the caller must format it.
+
+   static char* getNextEntry();
+     //:Format the oldest record of all the buffers as a log entry
+     // Only the OsSysLogTask may call this.
+     //!returns: The log entry allocated with malloc(), or NULL if the
+     //          buffers are empty.
+
+/* ============================ ACCESSORS ================================= */
+
+   static unsigned long getDroppedCount();
+     //:Number of records dropped because the buffer of their thread was full
+
+/* //////////////////////////// PROTECTED ///////////////////////////////// */
+protected:
+
+/* //////////////////////////// PRIVATE /////////////////////////////////// */
+private:
+
+   OsSysLogRecordBuffer();
+     //:Default constructor (static class)
+
+   OsSysLogRecordBuffer(const OsSysLogRecordBuffer& rOsSysLogRecordBuffer);
+     //:Copy constructor (not implemented for this class)
+
+   OsSysLogRecordBuffer& operator=(const OsSysLogRecordBuffer& rhs);
+     //:Assignment operator (not implemented for this class)
+};
+
+/* ============================ INLINE METHODS ============================ */
+
+#endif  // _OsSysLogRecordBuffer_h_
@@ -118,6 +118,8 @@ protected:
 
    OsStatus processAdd(char* pEntry);
      //:Handlers adding a new log entry
+   OsStatus processRecords();
+     //:Handles adding the log entries of the record buffers
    OsStatus processAddTail(char* pEntry);
      //:Handlers adding a log entry to the "tail" of the list
    OsStatus processConsoleEnable(const UtlBoolean enable);
@@ -279,7 +279,8 @@ protected:
    int             mOutstandingMessages; ///< Number of messages for this timer
                                ///< in the timer task's queue.
 
-   OsTimer*        mTimerQueueLink; ///< To chain together timers.
+   int             mTimerQueueIndex; ///< Position of this timer in the
+                               ///< timer task's heap, or -1 if not queued.
 
    /// Start a timer.
    OsStatus startTimer(OsTime start,
@@ -104,17 +104,48 @@ private:
    /// Semaphore used to protect manipulations of spInstance.
    static OsBSem *sLock;
 
-   /// The queue of timer requests, ordered by increasing firing time.
-   OsTimer* mTimerQueue;
+   /// Number of children of each node of the timer heap.
+   static const int TIMER_HEAP_ARITY;
+   /**< A 4-ary heap is shallower than a binary one, and the four children
+    *   of a node are adjacent in memory, so sifting down touches fewer
+    *   cache lines.
+    */
+
+   /// Initial number of slots allocated for the timer heap.
+   static const int TIMER_HEAP_INITIAL_CAPACITY;
+
+   /// The queue of timer requests, kept as a 4-ary min-heap on firing time.
+   OsTimer** mpTimerHeap;
+   /**< mpTimerHeap[0] is the timer that will fire next.  Every queued timer
+    *   records its own position in OsTimer::mTimerQueueIndex, so it can be
+    *   removed without searching the queue.
+    */
+
+   /// Number of timers in mpTimerHeap.
+   int mTimerHeapSize;
+
+   /// Number of slots allocated for mpTimerHeap.
+   int mTimerHeapCapacity;
 
    /// Timeout to use when signalling
    OsTime mSignalTimeout;
 
    /// Insert a timer into the timer queue.
    void insertTimer(OsTimer* timer);
+   /**< O(log n) in the number of queued timers. */
 
    /// Remove a timer from the timer queue.
    void removeTimer(OsTimer* timer);
+   /**< O(log n) in the number of queued timers. */
+
+   /// Store a timer into a heap slot, updating its recorded position.
+   void setHeapSlot(int index, OsTimer* timer);
+
+   /// Move the timer in slot index toward the root until the heap is ordered.
+   void siftUp(int index);
+
+   /// Move the timer in slot index toward the leaves until the heap is ordered.
+   void siftDown(int index);
 
    /// Copy constructor (not implemented for this class)
    OsTimerTask(const OsTimerTask& rOsTimerTask);
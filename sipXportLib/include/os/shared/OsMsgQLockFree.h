@@ -0,0 +1,203 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _OsMsgQLockFree_h_
+#define _OsMsgQLockFree_h_
+
+// SYSTEM INCLUDES
+#include <stddef.h>
+
+// APPLICATION INCLUDES
+#include "os/OsDefs.h"
+#include "os/OsMsg.h"
+#include "os/OsMsgQ.h"
+#include "os/OsTime.h"
+
+// DEFINES
+// The lock-free queue blocks on futexes, so it is only available on Linux.
+#if defined(__linux__) && defined(__GNUC__)
+#  define OS_MSGQ_LOCK_FREE_SUPPORTED
+#endif
+
+// MACROS
+// EXTERNAL FUNCTIONS
+// EXTERNAL VARIABLES
+// CONSTANTS
+// STRUCTS
+// TYPEDEFS
+class UtlString;
+
+// FORWARD DECLARATIONS
+
+#ifdef OS_MSGQ_LOCK_FREE_SUPPORTED // [
+
+/**
+*  Message queue for many senders and a single receiver, which takes no locks
+*  on the send or receive path.
+*
+*  Messages are stored in two bounded rings of cells (one for normal and one
+*  for urgent messages), each cell carrying a sequence number that tells
+*  senders and the receiver whether the cell is free or filled.  A sender
+*  claims a cell with one compare-and-swap and publishes the message by
+*  advancing the cell's sequence number; the receiver drains the urgent ring
+*  before the normal one.  See Dmitry Vyukov's bounded MPMC queue for the
+*  underlying algorithm.
+*
+*  The queue only enters the kernel when it has to block: the receiver waits
+*  on a futex when the queue is empty, and senders wait on another futex when
+*  it is full.  A sender or receiver that finds no one waiting does not make
+*  any system call.
+*
+*  Semantics differ from OsMsgQShared in two ways:
+*  <pre>
+*    - Only one task may receive from the queue at a time.  This is always
+*      the case for the incoming queue of an OsServerTask.
+*    - Urgent messages are received before all normal messages, but in the
+*      order they were sent among themselves (OsMsgQShared delivers the most
+*      recent urgent message first).
+*  </pre>
+*
+*  Usually this class is not used directly, but selected by passing
+*  OsMsgQBase::Q_LOCK_FREE in the options of the OsMsgQ constructor.
+*/
+class OsMsgQLockFree : public OsMsgQBase
+{
+/* //////////////////////////// PUBLIC //////////////////////////////////// */
+public:
+
+/* ============================ CREATORS ================================== */
+
+     /// Constructor
+   OsMsgQLockFree(
+      const int       maxMsgs=DEF_MAX_MSGS,      ///< Max number of messages.
+      const UtlString& name=""                   ///< Global name for this queue.
+      );
+     /**<
+     *  If name is specified but is already in use, throw an exception.
+     */
+
+     /// Destructor
+   virtual ~OsMsgQLockFree();
+
+/* ============================ MANIPULATORS ============================== */
+
+     /// @copydoc OsMsgQBase::send()
+   virtual OsStatus send(const OsMsg& rMsg,
+                         const OsTime& rTimeout=OsTime::OS_INFINITY);
+
+     /// @copydoc OsMsgQBase::sendNoCopy()
+   virtual OsStatus sendNoCopy(OsMsg *pMsg,
+                               const OsTime& rTimeout=OsTime::OS_INFINITY);
+
+     /// @copydoc OsMsgQBase::sendUrgent()
+   virtual OsStatus sendUrgent(const OsMsg& rMsg,
+                               const OsTime& rTimeout=OsTime::OS_INFINITY);
+
+     /// @copydoc OsMsgQBase::sendFromISR()
+   virtual OsStatus sendFromISR(OsMsg& rMsg);
+
+     /// @copydoc OsMsgQBase::receive()
+   virtual OsStatus receive(OsMsg*& rpMsg,
+                            const OsTime& rTimeout=OsTime::OS_INFINITY);
+
+/* ============================ ACCESSORS ================================= */
+
+     /// @copydoc OsMsgQBase::numMsgs()
+   virtual int numMsgs();
+     /**<
+     *  Messages whose senders are still in the middle of send() are counted.
+     */
+
+/* ============================ INQUIRY =================================== */
+
+/* //////////////////////////// PROTECTED ///////////////////////////////// */
+protected:
+
+#ifdef MSGQ_IS_VALID_CHECK
+   virtual void testMessageQ();
+#endif
+
+/* //////////////////////////// PRIVATE /////////////////////////////////// */
+private:
+
+     /// One slot of a ring.
+   struct Cell
+   {
+      size_t mSequence;     ///< Ring position this cell is ready for.
+      OsMsg* mpMsg;         ///< Message stored in the cell.
+   };
+
+     /// Bounded ring of cells, with independent sender and receiver positions.
+   struct Ring
+   {
+      Cell*  mpCells;       ///< Array of mMask+1 cells.
+      size_t mMask;         ///< Number of cells minus one (power of 2 minus 1).
+      char   mPad1[64];     ///< Keep the positions in separate cache lines.
+      size_t mSendPos;      ///< Next position to be claimed by a sender.
+      char   mPad2[64];
+      size_t mReceivePos;   ///< Next position to be read by the receiver.
+   };
+
+   Ring mNormal;            ///< Ring for messages sent with send()/sendNoCopy().
+   Ring mUrgent;            ///< Ring for messages sent with sendUrgent().
+
+   int  mNumMsgs;           ///< Messages queued or being queued; never more
+                            ///<  than mMaxMsgs.
+   int  mNotEmptySeq;       ///< Futex word the receiver waits on.
+   int  mNotEmptyWaiters;   ///< Number of receivers blocked on mNotEmptySeq.
+   int  mNotFullSeq;        ///< Futex word senders wait on.
+   int  mNotFullWaiters;    ///< Number of senders blocked on mNotFullSeq.
+
+     /// Helper function for sending messages
+   OsStatus doSend(const OsMsg& rMsg, const OsTime& rTimeout,
+                   const UtlBoolean isUrgent, const UtlBoolean needCopy);
+
+     /// Reserve room for one message, blocking up to rTimeout.
+   OsStatus reserveSlot(const OsTime& rTimeout);
+
+     /// Remove a message from the head of the queue without blocking.
+   OsMsg* tryReceive();
+
+     /// Convert a timeout to an absolute CLOCK_MONOTONIC deadline in nsec.
+   static long long getDeadline(const OsTime& rTimeout);
+     /**<
+     *  Returns -1 for an infinite timeout.
+     */
+
+     /// Wait on a futex word while it still holds expectedValue.
+   static OsStatus waitOn(int* pWord, int expectedValue, long long deadline);
+     /**<
+     *  Returns OS_WAIT_TIMEOUT if the deadline has passed, otherwise
+     *  OS_SUCCESS (which includes spurious wakeups).
+     */
+
+     /// Wake one task blocked on a futex word, if any are waiting.
+   static void wakeOne(int* pWord, int* pWaiters);
+
+     /// Allocate the cells of a ring holding at least size messages.
+   static void initRing(Ring& rRing, int size);
+
+     /// Store a message in a ring.  There must be a free cell.
+   static void pushRing(Ring& rRing, OsMsg* pMsg);
+
+     /// Take the oldest message from a ring, or NULL if it is empty.
+   static OsMsg* popRing(Ring& rRing);
+
+     /// Copy constructor (not implemented for this class)
+   OsMsgQLockFree(const OsMsgQLockFree& rOsMsgQLockFree);
+
+     /// Assignment operator (not implemented for this class)
+   OsMsgQLockFree& operator=(const OsMsgQLockFree& rhs);
+
+};
+
+#endif // OS_MSGQ_LOCK_FREE_SUPPORTED ]
+
+/* ============================ INLINE METHODS ============================ */
+
+#endif  // _OsMsgQLockFree_h_
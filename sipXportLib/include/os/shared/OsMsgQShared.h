@@ -33,6 +33,7 @@
 class UtlString;
 
 // FORWARD DECLARATIONS
+class OsMsgQLockFree;
 
 // #define OS_MSGQ_DEBUG
 // #define OS_MSGQ_REPORTING
@@ -76,6 +77,11 @@ class DebugMutex
 *    - a binary semaphore (mGuard) to ensure against concurrent access to
 *      internal object data
 *  </pre>
+*
+*  If the queue is constructed with the Q_LOCK_FREE option on a platform
+*  that supports it, all operations are instead forwarded to an
+*  OsMsgQLockFree, which needs no locks or semaphores but allows only one
+*  receiving task.
 */
 class OsMsgQShared : public OsMsgQBase
 {
@@ -88,7 +94,9 @@ public:
    OsMsgQShared(
       const int       maxMsgs=DEF_MAX_MSGS,      ///< Max number of messages.
       const int       maxMsgLen=DEF_MAX_MSG_LEN, ///< Max msg length (bytes).
-      const int       options=Q_PRIORITY,        ///< How to queue blocked tasks.
+      const int       options=Q_PRIORITY,        ///< How to queue blocked tasks,
+                                                 ///<  and whether to use
+                                                 ///<  Q_LOCK_FREE.
       const UtlString& name=""                   ///< Global name for this queue.
       );
      /**<
@@ -130,13 +138,16 @@ public:
      /// @copydoc OsMsgQBase::numMsgs()
    virtual int numMsgs();
 
+/* ============================ INQUIRY =================================== */
+
+     /// Return TRUE if operations are forwarded to an OsMsgQLockFree.
+   UtlBoolean isLockFree() const { return mpLockFree != NULL; }
+
 #ifdef MSGQ_IS_VALID_CHECK 
      /// Print information on the message queue to the console
    virtual void show();
 #endif
 
-/* ============================ INQUIRY =================================== */
-
 /* //////////////////////////// PROTECTED ///////////////////////////////// */
 protected:
 
@@ -155,6 +166,8 @@ private:
                      ///<  from the queue and blocking receivers when there are
                      ///<  no messages to receive.
    UtlDList mDlist;  ///< Doubly-linked list used to store messages.
+   OsMsgQLockFree* mpLockFree; ///< Queue all operations are forwarded to,
+                     ///<  if Q_LOCK_FREE was requested; otherwise NULL.
 
 #ifdef MSGQ_IS_VALID_CHECK
    int      mOptions; ///< Message queue options.
@@ -16,6 +16,19 @@
 #include "utl/UtlLink.h"
 
 // DEFINES
+
+// Keep a cache of free instances for each thread where thread specific
+// data is available.
+#if defined(__pingtel_on_posix__) && !defined(UTLCHAINPOOL_NO_THREAD_CACHE)
+#  define UTLCHAINPOOL_THREAD_CACHE
+#  include <pthread.h>
+#endif
+
+/// Number of instances moved between the pool and a thread cache at a time.
+#ifndef UTLCHAINPOOL_CACHE_BATCH
+#define UTLCHAINPOOL_CACHE_BATCH 64
+#endif
+
 // MACROS
 // EXTERNAL FUNCTIONS
 // EXTERNAL VARIABLES
@@ -33,6 +46,13 @@
  *
  * The actual allocation of the blocks and initial chaining is done by the allocator
  * function supplied by the UtlChain subclass.
+ *
+ * Where UTLCHAINPOOL_THREAD_CACHE is defined, each thread keeps its own short list
+ * of free instances, so that get() and release() take mLock only once for every
+ * UTLCHAINPOOL_CACHE_BATCH instances: an empty cache is refilled with a batch from
+ * mPool, and a batch is returned to mPool when a cache has twice that many.
+ * The cache of a thread is returned to mPool when the thread exits.  The caches
+ * of threads still running when the pool is destroyed are deleted with it.
  */
 class UtlChainPool
 {
@@ -77,12 +97,44 @@ protected:
       return mAllocations * (mBlockSize-1); // one per block is overhead
    }
 
+   /// Returns the number of instances the calling thread got from this pool.
+   /**
+    * Returns 0 where UTLCHAINPOOL_THREAD_CACHE is not defined.
+    */
+   size_t threadAllocated();
+
 /* //////////////////////////// PRIVATE /////////////////////////////////// */
 private:
 
    /// Release all dynamic memory used by the UtlLinkPool.
    ~UtlChainPool();
 
+#ifdef UTLCHAINPOOL_THREAD_CACHE
+   /// Free instances and counts of one thread, chained on mCaches.
+   struct ThreadCache : public UtlChain
+   {
+      UtlChainPool* mpPool;
+      UtlChain      mFree;       ///< list of available instances, like mPool
+      size_t        mFreeCount;
+      size_t        mGets;       ///< instances the thread got from the pool
+   };
+
+   /// Get the cache of the calling thread, creating it if need be.
+   ThreadCache* threadCache();
+
+   /// Move a batch of instances from mPool to the cache.
+   void refill(ThreadCache* cache);
+
+   /// Move all but the last keep instances from the cache to mPool.
+   void drain(ThreadCache* cache, size_t keep);
+
+   /// Thread specific data destructor: return the cache to its pool.
+   static void destroyThreadCache(void* cache);
+
+   pthread_key_t mCacheKey;
+   UtlChain      mCaches;   ///< caches of the threads which have one
+#endif
+
    OsBSem        mLock; ///< lock for all the other member variables
    size_t        mBlockSize;
    size_t        mAllocations;
@@ -305,6 +305,14 @@ class UtlLink : public UtlChain
     */
    static size_t totalAllocated();
 
+   /// Get the number of UtlLinks and UtlPairs the calling thread has taken from the pools.
+   /**
+    * Each thread takes instances from a cache of its own, so these counts show how
+    * much each thread uses the containers.  Both are 0 on platforms where the pools
+    * have no thread caches (see UtlChainPool).
+    */
+   static void threadAllocated(size_t& links, size_t& pairs);
+
    ///@}
    
 /* //////////////////////////// PROTECTED ///////////////////////////////// */
@@ -457,6 +465,7 @@ class UtlLink : public UtlChain
 class UtlPair : public UtlLink
 {
   protected:
+   friend class UtlLink;
    friend class UtlHashMap;
    friend class UtlHashMapIterator;
    friend class UtlHashBagIterator;
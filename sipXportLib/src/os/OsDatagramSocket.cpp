@@ -39,6 +39,7 @@
 #   include <netdb.h>
 #   include <netinet/in.h>
 #   include <arpa/inet.h>
+#   include <errno.h>
 #else
 #error Unsupported target platform.
 #endif
@@ -68,7 +69,8 @@
 
 // Constructor
 OsDatagramSocket::OsDatagramSocket(int remoteHostPortNum, const char* remoteHost,
-                                   int localHostPortNum, const char* localHost)
+                                   int localHostPortNum, const char* localHost,
+                                   UtlBoolean reusePort)
 : mNumTotalWriteErrors(0)
 , mNumRecentWriteErrors(0)
 , mSimulatedConnect(FALSE)     // Simulated connection is off until
@@ -84,6 +86,23 @@ OsDatagramSocket::OsDatagramSocket(int remoteHostPortNum, const char* remoteHost
         goto EXIT;
     }
 
+    if (reusePort)
+    {
+#ifdef SO_REUSEPORT
+        int one = 1;
+        if (setsockopt(socketDescriptor, SOL_SOCKET, SO_REUSEPORT,
+                       (char*) &one, sizeof(one)) != 0)
+        {
+            OsSysLog::add(FAC_KERNEL, PRI_ERR,
+                          "OsDatagramSocket::OsDatagramSocket SO_REUSEPORT failed w/ errno %d",
+                          OsSocketGetERRNO());
+        }
+#else
+        OsSysLog::add(FAC_KERNEL, PRI_ERR,
+                      "OsDatagramSocket::OsDatagramSocket SO_REUSEPORT not supported");
+#endif
+    }
+
     // Bind to the socket
     bind(localHostPortNum, localHost);
     if (!isOk())
@@ -524,6 +543,109 @@ int OsDatagramSocket::read(char* buffer, int bufferLength)
     return(bytesRead);
 }
 
+int OsDatagramSocket::readBatch(char* buffers, int bufferLength, int maxPackets,
+                                int* packetLengths,
+                                UtlString* fromAddresses, int* fromPorts)
+{
+    if (maxPackets > OS_DATAGRAM_MAX_BATCH)
+    {
+        maxPackets = OS_DATAGRAM_MAX_BATCH;
+    }
+
+#ifdef OS_DATAGRAM_BATCH_READS /* [ */
+    char* packetBuffers[OS_DATAGRAM_MAX_BATCH];
+    struct in_addr fromIps[OS_DATAGRAM_MAX_BATCH];
+    int received;
+
+    for (int i = 0; i < maxPackets; i++)
+    {
+        packetBuffers[i] = buffers + i * bufferLength;
+    }
+
+    received = recvBatch(socketDescriptor, packetBuffers, bufferLength,
+                         maxPackets, packetLengths,
+                         fromAddresses ? fromIps : NULL, fromPorts);
+
+    for (int i = 0; i < received && fromAddresses; i++)
+    {
+        inet_ntoa_pt(fromIps[i], fromAddresses[i]);
+    }
+
+    return received;
+#else /* OS_DATAGRAM_BATCH_READS ] [ */
+    int numRead = 0;
+
+    while (numRead < maxPackets && isReadyToRead(0))
+    {
+        int bytesRead = OsSocket::read(buffers + numRead * bufferLength,
+                                       bufferLength,
+                                       fromAddresses ? &fromAddresses[numRead] : NULL,
+                                       fromPorts ? &fromPorts[numRead] : NULL);
+        if (bytesRead < 0)
+        {
+            return (numRead > 0) ? numRead : -1;
+        }
+        packetLengths[numRead++] = bytesRead;
+    }
+
+    return numRead;
+#endif /* OS_DATAGRAM_BATCH_READS ] */
+}
+
+#ifdef OS_DATAGRAM_BATCH_READS /* [ */
+int OsDatagramSocket::recvBatch(int socketDescriptor, char* const* buffers,
+                                int bufferLength, int maxPackets,
+                                int* packetLengths,
+                                struct in_addr* fromIps, int* fromPorts)
+{
+    struct mmsghdr msgs[OS_DATAGRAM_MAX_BATCH];
+    struct iovec iovs[OS_DATAGRAM_MAX_BATCH];
+    struct sockaddr_in fromSockAddresses[OS_DATAGRAM_MAX_BATCH];
+    int received;
+
+    if (maxPackets > OS_DATAGRAM_MAX_BATCH)
+    {
+        maxPackets = OS_DATAGRAM_MAX_BATCH;
+    }
+
+    for (int i = 0; i < maxPackets; i++)
+    {
+        iovs[i].iov_base = buffers[i];
+        iovs[i].iov_len = bufferLength;
+        memset(&msgs[i], 0, sizeof(msgs[i]));
+        msgs[i].msg_hdr.msg_name = &fromSockAddresses[i];
+        msgs[i].msg_hdr.msg_namelen = sizeof(fromSockAddresses[i]);
+        msgs[i].msg_hdr.msg_iov = &iovs[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    do
+    {
+        received = recvmmsg(socketDescriptor, msgs, maxPackets, MSG_DONTWAIT, NULL);
+    } while (received < 0 && errno == EINTR);
+
+    if (received < 0)
+    {
+        return (errno == EAGAIN || errno == EWOULDBLOCK) ? 0 : -1;
+    }
+
+    for (int i = 0; i < received; i++)
+    {
+        packetLengths[i] = msgs[i].msg_len;
+        if (fromIps)
+        {
+            fromIps[i] = fromSockAddresses[i].sin_addr;
+        }
+        if (fromPorts)
+        {
+            fromPorts[i] = ntohs(fromSockAddresses[i].sin_port);
+        }
+    }
+
+    return received;
+}
+#endif /* OS_DATAGRAM_BATCH_READS ] */
+
 /* ============================ ACCESSORS ================================= */
 OsSocket::IpProtocolSocketType OsDatagramSocket::getIpProtocol() const
 {
@@ -51,8 +51,10 @@ OsNatDatagramSocket::OsNatDatagramSocket(int remoteHostPortNum,
                                          const char* remoteHost, 
                                          int localHostPortNum, 
                                          const char* localHost,
-                                         OsNotification *pNotification) 
-        : OsDatagramSocket(remoteHostPortNum, remoteHost, localHostPortNum, localHost)
+                                         OsNotification *pNotification,
+                                         UtlBoolean reusePort) 
+        : OsDatagramSocket(remoteHostPortNum, remoteHost, localHostPortNum,
+                           localHost, reusePort)
 {    
     miRecordTimes = ONDS_MARK_NONE ;
     mpReadNotification = NULL ;
@@ -225,6 +227,50 @@ int OsNatDatagramSocket::read(char* buffer, int bufferLength, long waitMilliseco
     return iRC ;    
 }
 
+int OsNatDatagramSocket::readBatch(char* buffers, int bufferLength,
+                                   int maxPackets, int* packetLengths,
+                                   UtlString* fromAddresses, int* fromPorts)
+{
+    UtlString receivedIps[OS_DATAGRAM_MAX_BATCH];
+    int receivedPorts[OS_DATAGRAM_MAX_BATCH];
+    UtlBoolean bDataRead = FALSE;
+
+    // The source is needed to handle STUN and TURN packets
+    if (fromAddresses == NULL)
+    {
+        fromAddresses = receivedIps;
+    }
+    if (fromPorts == NULL)
+    {
+        fromPorts = receivedPorts;
+    }
+
+    int numRead = OsDatagramSocket::readBatch(buffers, bufferLength, maxPackets,
+                                              packetLengths,
+                                              fromAddresses, fromPorts);
+    for (int i = 0; i < numRead; i++)
+    {
+        if (handleSturnData(buffers + i * bufferLength, packetLengths[i],
+                            fromAddresses[i], fromPorts[i]))
+        {
+            if (!mbTransparentReads)
+                packetLengths[i] = 0 ;
+        }
+        else if (packetLengths[i] > 0)
+        {
+            bDataRead = TRUE ;
+        }
+    }
+
+    // Make read time for non-NAT packets
+    if (bDataRead)
+    {
+        markReadTime() ;
+    }
+
+    return numRead ;
+}
+
 int OsNatDatagramSocket::socketWrite(const char* buffer, int bufferLength,
                                const char* ipAddress, int port, PacketType packetType)
 {
@@ -586,6 +632,11 @@ void OsNatDatagramSocket::setNotifier(OsNotification* pNotification)
 
 /* ============================ INQUIRY =================================== */
 
+UtlBoolean OsNatDatagramSocket::hasRawReads() const
+{
+    return FALSE;
+}
+
 /* //////////////////////////// PROTECTED ///////////////////////////////// */
 
 void OsNatDatagramSocket::setStunAddress(const UtlString& address, 
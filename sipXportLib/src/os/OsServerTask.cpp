@@ -34,9 +34,10 @@ OsServerTask::OsServerTask(const UtlString& name,
                            const int maxRequestQMsgs,
                            const int priority,
                            const int options,
-                           const int stackSize)
+                           const int stackSize,
+                           const int queueOptions)
 :  OsTask(name, pArg, priority, options, stackSize),
-   mIncomingQ(maxRequestQMsgs, OsMsgQ::DEF_MAX_MSG_LEN, OsMsgQ::Q_PRIORITY)
+   mIncomingQ(maxRequestQMsgs, OsMsgQ::DEF_MAX_MSG_LEN, queueOptions)
 
    // other than initialization, no work required
 {
@@ -578,6 +578,11 @@ UtlBoolean OsSocket::isReadyToRead(long waitMilliseconds) const
    return isReadyToReadEx(waitMilliseconds,bSocketError);
 }
 
+UtlBoolean OsSocket::hasRawReads() const
+{
+   return TRUE;
+}
+
 UtlBoolean OsSocket::isReadyToWrite(long waitMilliseconds) const
 {
    int tempSocketDescr = OS_INVALID_SOCKET_DESCRIPTOR;
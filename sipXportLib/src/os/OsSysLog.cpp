@@ -36,6 +36,7 @@
 #include "utl/UtlDefs.h"
 #include "os/OsSysLog.h"
 #include "os/OsSysLogMsg.h"
+#include "os/OsSysLogRecordBuffer.h"
 #include "os/OsSysLogTask.h"
 #include "os/OsStatus.h"
 #include "os/OsServerTask.h"
@@ -63,6 +64,7 @@ OsSysLogPriority OsSysLog::spPriorities[FAC_MAX_FACILITY] ;
 // Initial logging level is PRI_ERR.
 OsSysLogPriority OsSysLog::sLoggingPriority = PRI_ERR ;
 UtlBoolean OsSysLog::bPrioritiesInitialized = FALSE ;
+UtlBoolean OsSysLog::sRecordBuffers = FALSE ;
 OsSysLogPreQueueCallback OsSysLog::mPreQueueCallback = 0;
 
 // A static array of priority names uses for displaying log entries
@@ -134,6 +136,7 @@ OsStatus OsSysLog::initialize(const int   maxInMemoryLogEntries,
       }
       sProcessId = processId ;
       OsSocket::getHostName(&sHostname) ;  
+      sRecordBuffers = (options & OPT_RECORD_BUFFERS) != 0 ;
    }
    else
       rc = OS_UNSPECIFIED ;  
@@ -144,6 +147,10 @@ OsStatus OsSysLog::initialize(const int   maxInMemoryLogEntries,
 // Shutdown log
 OsStatus OsSysLog::shutdown()
 {
+   // Events added from now on are formatted and printed by the caller;
+   // the flush formats the records still in the buffers.
+   sRecordBuffers = FALSE ;
+
    OsSysLogTask* pTask = spOsSysLogTask ;
    spOsSysLogTask = NULL ;
    if (pTask != NULL)
@@ -374,15 +381,9 @@ OsStatus OsSysLog::add(const OsSysLogFacility facility,
    {
       if (willLog(facility, priority))
       {
-         UtlString taskName ;
-         OsTaskId_t taskId = 0 ;
-
          va_list ap;
          va_start(ap, format);
-
-         getTaskInfo(taskName, taskId);
-
-         rc = vadd(taskName.data(), taskId, facility, priority, format, ap);         
+         rc = vadd(facility, priority, format, ap);
          va_end(ap);
       }  
    }
@@ -398,6 +399,19 @@ OsStatus OsSysLog::vadd(const OsSysLogFacility facility,
                         const char*            format,
                         va_list                ap)
 {
+    if (isTaskPtrNull() || !willLog(facility, priority))
+    {
+        return OS_SUCCESS;
+    }
+
+    // Record the event without looking up the task, the record buffer of
+    // the thread knows it.
+    if (sRecordBuffers && mPreQueueCallback == NULL &&
+        OsSysLogRecordBuffer::add(NULL, 0, facility, priority, format, ap) != OS_NOT_SUPPORTED)
+    {
+        return OS_SUCCESS;
+    }
+
     UtlString taskName;
     OsTaskId_t taskId = 0;
 
@@ -419,6 +433,13 @@ OsStatus OsSysLog::vadd(const char*            taskName,
    {
       if (willLog(facility, priority))
       {
+         if (sRecordBuffers && mPreQueueCallback == NULL &&
+             OsSysLogRecordBuffer::add((taskName == NULL) ? "" : taskName, taskId,
+                                       facility, priority, format, ap) != OS_NOT_SUPPORTED)
+         {
+            return OS_SUCCESS;
+         }
+
          UtlString logData;
          UtlString logEntry;
          myvsprintf(logData, format, ap) ;
@@ -440,28 +461,8 @@ OsStatus OsSysLog::vadd(const char*            taskName,
 
          OsTime timeNow;
          OsDateTime::getCurTime(timeNow); 
-         OsDateTime logTime(timeNow);
-         
-         UtlString   strTime ;
-         logTime.getIsoTimeStringZus(strTime) ;
-         UtlString   taskHex;
-         // TODO: Should get abstracted into a OsTaskBase method
-#ifdef __pingtel_on_posix__
-         OsTaskLinux::getIdString_X(taskHex, taskId);
-#else
-         taskHex.appendFormat("%d", taskId);
-#endif
-
-         mysprintf(logEntry, "\"%s\":%d:%s:%s:%s:%s:%s:%s:\"%s\"",
-               strTime.data(),
-               ++sEventCount,
-               OsSysLog::sFacilityNames[facility], 
-               OsSysLog::sPriorityNames[priority],
-               sHostname.data(),
-               (taskName == NULL) ? "" : taskName,
-               taskHex.data(),
-               sProcessId.data(),
-               logData.data()) ;         
+         formatEntry(logEntry, timeNow, facility, priority, taskName, taskId,
+                     logData);
 
          // If the logger for some reason trys to log a message
          // there is a recursive problem.  Drop the message on the
@@ -577,6 +578,12 @@ OsSysLog::initSysLog(const OsSysLogFacility facility,
 
 /* ============================ ACCESSORS ================================= */
 
+// Get the number of log events dropped by the record buffers
+unsigned long OsSysLog::getDroppedRecords()
+{
+   return OsSysLogRecordBuffer::getDroppedCount() ;
+}
+
 // Get the max number of in memory log entries
 OsStatus OsSysLog::getMaxInMemoryLogEntries(int& maxEntries)
 {
@@ -801,20 +808,6 @@ OsSysLogPriority OsSysLog::getLoggingPriorityForFacility(const OsSysLogFacility
 }
 
 
-// Determine if a message will be logged given a facility and priority
-UtlBoolean OsSysLog::willLog(OsSysLogFacility facility, 
-                            OsSysLogPriority priority) 
-{
-   UtlBoolean bwillLog = false ;
-   if ((facility >=0) && (facility < getNumFacilities()))
-   {
-      initializePriorities();
-      bwillLog = (spPriorities[facility] <= priority) ;
-   }
-
-   return bwillLog ;
-}
-
 void OsSysLog::initializePriorities()
 {
     if (bPrioritiesInitialized == FALSE)
@@ -857,6 +850,39 @@ OsSysLog::~OsSysLog()
 {
 }
 
+// Build a log entry
+void OsSysLog::formatEntry(UtlString& logEntry,
+                           const OsTime& time,
+                           const OsSysLogFacility facility,
+                           const OsSysLogPriority priority,
+                           const char* taskName,
+                           const OsTaskId_t taskId,
+                           const UtlString& logData)
+{
+   OsDateTime logTime(time);
+
+   UtlString   strTime ;
+   logTime.getIsoTimeStringZus(strTime) ;
+   UtlString   taskHex;
+   // TODO: Should get abstracted into a OsTaskBase method
+#ifdef __pingtel_on_posix__
+   OsTaskLinux::getIdString_X(taskHex, taskId);
+#else
+   taskHex.appendFormat("%d", taskId);
+#endif
+
+   mysprintf(logEntry, "\"%s\":%d:%s:%s:%s:%s:%s:%s:\"%s\"",
+         strTime.data(),
+         ++sEventCount,
+         OsSysLog::sFacilityNames[facility], 
+         OsSysLog::sPriorityNames[priority],
+         sHostname.data(),
+         (taskName == NULL) ? "" : taskName,
+         taskHex.data(),
+         sProcessId.data(),
+         logData.data()) ;         
+}
+
 // Returns an escaped version of the specified source string
 UtlString OsSysLog::escape(const UtlString& source)
 {
@@ -0,0 +1,759 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+
+// SYSTEM INCLUDES
+#include "os/OsIntTypes.h"
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+
+// APPLICATION INCLUDES
+#include "os/OsSysLogRecordBuffer.h"
+
+#ifdef OSSYSLOG_RECORD_BUFFERS // [
+#include <pthread.h>
+#include <sys/types.h>
+#include "os/OsSysLogMsg.h"
+#include "os/OsSysLogTask.h"
+#include "os/OsDateTime.h"
+#include "utl/UtlString.h"
+
+// EXTERNAL FUNCTIONS
+// EXTERNAL VARIABLES
+// CONSTANTS
+#define RECORD_ALIGNMENT        8
+#define RECORD_ALIGN(size)      (((size) + RECORD_ALIGNMENT - 1) & ~(size_t)(RECORD_ALIGNMENT - 1))
+#define RECORD_MAX_SIZE         (OSSYSLOG_RECORD_BUFFER_SIZE / 4)
+#define RECORD_MAX_SPEC         32      // Longest conversion specification recorded
+
+#define RECORD_FLAG_PADDING     0x01    // Skip to the end of the buffer
+#define RECORD_FLAG_TASK_NAME   0x02    // The first string is the task name
+
+// STRUCTS
+
+// Kind of argument taken by a printf conversion
+enum RecordArgType
+{
+   ARG_NONE,            // %%
+   ARG_SIGNED,          // Stored as a long long
+   ARG_UNSIGNED,        // Stored as an unsigned long long
+   ARG_DOUBLE,          // Stored as a double, also for %L
+   ARG_POINTER,         // Stored as an unsigned long long
+   ARG_STRING,          // Copied with its null, padded to RECORD_ALIGNMENT
+   ARG_UNSUPPORTED
+};
+
+// One printf conversion specification of a format string
+struct RecordConversion
+{
+   const char*   mpStart;          // The '%'
+   int           mLength;          // Through the conversion character
+   int           mStars;           // '*' widths and precisions
+   char          mLengthModifier;  // 'H' for hh, 'q' for ll, h l L j z t or 0
+   char          mConversion;
+   RecordArgType mType;
+};
+
+// Header of a record, followed by its strings and arguments
+struct RecordHeader
+{
+   size_t     mSize;               // Bytes of the record, RECORD_ALIGNMENT multiple
+   long       mSeconds;            // Time the event was added
+   long       mMicroseconds;
+   OsTaskId_t mTaskId;
+   int        mFacility;
+   int        mPriority;
+   int        mFlags;
+};
+
+// Ring buffer of records of one thread
+struct RecordBuffer
+{
+   char          mData[OSSYSLOG_RECORD_BUFFER_SIZE];
+   size_t        mHead;            // Bytes read, written by the OsSysLogTask
+   size_t        mTail;            // Bytes written, written by the owning thread
+   unsigned long mDropped;         // Written by the owning thread
+   int           mExited;          // The owning thread has exited
+   UtlBoolean    mDiscard;         // The owning thread is the syslog task
+   UtlString     mTaskName;
+   OsTaskId_t    mTaskId;
+   RecordBuffer* mpNext;           // Next buffer in sBuffers
+
+   RecordBuffer()
+   : mHead(0)
+   , mTail(0)
+   , mDropped(0)
+   , mExited(0)
+   , mDiscard(FALSE)
+   , mTaskId(0)
+   , mpNext(NULL)
+   {
+   }
+};
+
+// STATIC VARIABLE INITIALIZATIONS
+static pthread_once_t sBufferKeyOnce = PTHREAD_ONCE_INIT;
+static pthread_key_t sBufferKey;
+static pthread_mutex_t sBuffersMutex = PTHREAD_MUTEX_INITIALIZER;  // Guards the list
+static RecordBuffer* sBuffers = NULL;
+static unsigned long sFreedDropped = 0;   // Dropped by buffers already freed
+static unsigned long sReportedDropped = 0;
+static int sDrainPending = 0;             // The OsSysLogTask will look at the buffers
+
+// LOCAL FUNCTIONS
+
+// Mark the buffer of an exiting thread, the OsSysLogTask frees it when empty
+static void releaseBuffer(void* pData)
+{
+   RecordBuffer* pBuffer = (RecordBuffer*) pData;
+   __atomic_store_n(&pBuffer->mExited, 1, __ATOMIC_RELEASE);
+}
+
+static void createBufferKey()
+{
+   pthread_key_create(&sBufferKey, releaseBuffer);
+}
+
+// Parse the conversion specification starting at the '%' at pFormat
+// Returns the character following the specification.
+static const char* parseConversion(const char* pFormat, RecordConversion& conversion)
+{
+   const char* p = pFormat + 1;
+
+   conversion.mpStart = pFormat;
+   conversion.mStars = 0;
+   conversion.mLengthModifier = 0;
+
+   // Flags, field width and precision
+   while (*p == '-' || *p == '+' || *p == ' ' || *p == '#' || *p == '0' || *p == '\'')
+   {
+      p++;
+   }
+   if (*p == '*')
+   {
+      conversion.mStars++;
+      p++;
+   }
+   while (isdigit(*p))
+   {
+      p++;
+   }
+   if (*p == '.')
+   {
+      p++;
+      if (*p == '*')
+      {
+         conversion.mStars++;
+         p++;
+      }
+      while (isdigit(*p))
+      {
+         p++;
+      }
+   }
+
+   // Length modifier
+   switch (*p)
+   {
+   case 'h':
+      conversion.mLengthModifier = (p[1] == 'h') ? 'H' : 'h';
+      p += (p[1] == 'h') ? 2 : 1;
+      break;
+   case 'l':
+      conversion.mLengthModifier = (p[1] == 'l') ? 'q' : 'l';
+      p += (p[1] == 'l') ? 2 : 1;
+      break;
+   case 'q':
+   case 'L':
+   case 'j':
+   case 'z':
+   case 't':
+      conversion.mLengthModifier = *p;
+      p++;
+      break;
+   default:
+      break;
+   }
+
+   conversion.mConversion = *p;
+   switch (*p)
+   {
+   case 'd':
+   case 'i':
+      conversion.mType = ARG_SIGNED;
+      break;
+   case 'c':
+      conversion.mType = (conversion.mLengthModifier == 'l') ? ARG_UNSUPPORTED : ARG_SIGNED;
+      break;
+   case 'o':
+   case 'u':
+   case 'x':
+   case 'X':
+      conversion.mType = ARG_UNSIGNED;
+      break;
+   case 'e':
+   case 'E':
+   case 'f':
+   case 'F':
+   case 'g':
+   case 'G':
+   case 'a':
+   case 'A':
+      conversion.mType = ARG_DOUBLE;
+      break;
+   case 'p':
+      conversion.mType = ARG_POINTER;
+      break;
+   case 's':
+      conversion.mType = (conversion.mLengthModifier == 'l') ? ARG_UNSUPPORTED : ARG_STRING;
+      break;
+   case '%':
+      conversion.mType = ARG_NONE;
+      break;
+   default:
+      // %n, %m, or a broken format string
+      conversion.mType = ARG_UNSUPPORTED;
+      break;
+   }
+
+   if (*p != '\0')
+   {
+      p++;
+   }
+   conversion.mLength = (int)(p - pFormat);
+   if (conversion.mLength > RECORD_MAX_SPEC)
+   {
+      conversion.mType = ARG_UNSUPPORTED;
+   }
+
+   return p;
+}
+
+static void putNumber(char* pArgs, size_t& size, unsigned long long value)
+{
+   if (pArgs)
+   {
+      memcpy(pArgs + size, &value, sizeof(value));
+   }
+   size += RECORD_ALIGN(sizeof(value));
+}
+
+static void putString(char* pArgs, size_t& size, const char* pString)
+{
+   size_t length = strlen(pString) + 1;
+   if (pArgs)
+   {
+      memcpy(pArgs + size, pString, length);
+   }
+   size += RECORD_ALIGN(length);
+}
+
+static unsigned long long getNumber(const char*& pArgs)
+{
+   unsigned long long value;
+   memcpy(&value, pArgs, sizeof(value));
+   pArgs += RECORD_ALIGN(sizeof(value));
+   return value;
+}
+
+static const char* getString(const char*& pArgs)
+{
+   const char* pString = pArgs;
+   pArgs += RECORD_ALIGN(strlen(pString) + 1);
+   return pString;
+}
+
+// Size the arguments of a format string, and store them if pArgs is not NULL
+// Integers are converted to the type of their conversion first, so e.g.
+// %hhu prints the same when the record is formatted as it would have here.
+// Returns FALSE if the format string has a conversion which is not supported.
+static UtlBoolean recordArguments(const char* format, va_list args,
+                                  char* pArgs, size_t& size)
+{
+   RecordConversion conversion;
+   const char* p = format;
+
+   while ((p = strchr(p, '%')) != NULL)
+   {
+      p = parseConversion(p, conversion);
+      if (conversion.mType == ARG_UNSUPPORTED)
+      {
+         return FALSE;
+      }
+
+      for (int star = 0; star < conversion.mStars; star++)
+      {
+         putNumber(pArgs, size, (long long) va_arg(args, int));
+      }
+
+      switch (conversion.mType)
+      {
+      case ARG_SIGNED:
+         switch (conversion.mLengthModifier)
+         {
+         case 'H': putNumber(pArgs, size, (long long)(signed char) va_arg(args, int)); break;
+         case 'h': putNumber(pArgs, size, (long long)(short) va_arg(args, int)); break;
+         case 'l': putNumber(pArgs, size, (long long) va_arg(args, long)); break;
+         case 'q':
+         case 'L': putNumber(pArgs, size, va_arg(args, long long)); break;
+         case 'j': putNumber(pArgs, size, (long long) va_arg(args, intmax_t)); break;
+         case 'z': putNumber(pArgs, size, (long long) va_arg(args, ssize_t)); break;
+         case 't': putNumber(pArgs, size, (long long) va_arg(args, ptrdiff_t)); break;
+         default:  putNumber(pArgs, size, (long long) va_arg(args, int)); break;
+         }
+         break;
+      case ARG_UNSIGNED:
+         switch (conversion.mLengthModifier)
+         {
+         case 'H': putNumber(pArgs, size, (unsigned char) va_arg(args, unsigned int)); break;
+         case 'h': putNumber(pArgs, size, (unsigned short) va_arg(args, unsigned int)); break;
+         case 'l': putNumber(pArgs, size, va_arg(args, unsigned long)); break;
+         case 'q':
+         case 'L': putNumber(pArgs, size, va_arg(args, unsigned long long)); break;
+         case 'j': putNumber(pArgs, size, va_arg(args, uintmax_t)); break;
+         case 'z': putNumber(pArgs, size, va_arg(args, size_t)); break;
+         case 't': putNumber(pArgs, size, (unsigned long long) va_arg(args, ptrdiff_t)); break;
+         default:  putNumber(pArgs, size, va_arg(args, unsigned int)); break;
+         }
+         break;
+      case ARG_DOUBLE:
+         {
+            double value = (conversion.mLengthModifier == 'L')
+                           ? (double) va_arg(args, long double)
+                           : va_arg(args, double);
+            unsigned long long bits;
+            memcpy(&bits, &value, sizeof(bits));
+            putNumber(pArgs, size, bits);
+         }
+         break;
+      case ARG_POINTER:
+         putNumber(pArgs, size, (uintptr_t) va_arg(args, void*));
+         break;
+      case ARG_STRING:
+         {
+            const char* pString = va_arg(args, const char*);
+            putString(pArgs, size, pString ? pString : "(null)");
+         }
+         break;
+      default:
+         break;
+      }
+   }
+
+   return TRUE;
+}
+
+// Build the printf specification for a recorded argument
+// The length modifier is replaced by the one of the recorded type and the
+// '*' by the recorded field width and precision.
+static void buildSpecification(const RecordConversion& conversion,
+                               const long long* stars, char* spec)
+{
+   int star = 0;
+   char* pSpec = spec;
+
+   for (int i = 0; i < conversion.mLength - 1; i++)
+   {
+      char c = conversion.mpStart[i];
+      if (c == '*')
+      {
+         pSpec += sprintf(pSpec, "%d", (int) stars[star++]);
+      }
+      else if (strchr("hlqLjzt", c) == NULL)
+      {
+         *pSpec++ = c;
+      }
+   }
+   if ((conversion.mType == ARG_SIGNED || conversion.mType == ARG_UNSIGNED) &&
+       conversion.mConversion != 'c')
+   {
+      *pSpec++ = 'l';
+      *pSpec++ = 'l';
+   }
+   *pSpec++ = conversion.mConversion;
+   *pSpec = '\0';
+}
+
+// Format the recorded arguments of a format string
+static void formatArguments(UtlString& data, const char* format, const char* pArgs)
+{
+   RecordConversion conversion;
+   const char* p = format;
+   const char* pPercent;
+
+   while ((pPercent = strchr(p, '%')) != NULL)
+   {
+      data.append(p, pPercent - p);
+      p = parseConversion(pPercent, conversion);
+
+      long long stars[2];
+      for (int star = 0; star < conversion.mStars; star++)
+      {
+         stars[star] = (long long) getNumber(pArgs);
+      }
+
+      char spec[RECORD_MAX_SPEC * 2];
+      switch (conversion.mType)
+      {
+      case ARG_NONE:
+         data.append('%');
+         break;
+      case ARG_SIGNED:
+      case ARG_UNSIGNED:
+         buildSpecification(conversion, stars, spec);
+         if (conversion.mConversion == 'c')
+         {
+            data.appendFormat(spec, (int) getNumber(pArgs));
+         }
+         else
+         {
+            data.appendFormat(spec, getNumber(pArgs));
+         }
+         break;
+      case ARG_DOUBLE:
+         {
+            unsigned long long bits = getNumber(pArgs);
+            double value;
+            memcpy(&value, &bits, sizeof(value));
+            buildSpecification(conversion, stars, spec);
+            data.appendFormat(spec, value);
+         }
+         break;
+      case ARG_POINTER:
+         buildSpecification(conversion, stars, spec);
+         data.appendFormat(spec, (void*)(uintptr_t) getNumber(pArgs));
+         break;
+      case ARG_STRING:
+         if (conversion.mLength == 2)
+         {
+            data.append(getString(pArgs));
+         }
+         else
+         {
+            buildSpecification(conversion, stars, spec);
+            data.appendFormat(spec, getString(pArgs));
+         }
+         break;
+      default:
+         break;
+      }
+   }
+
+   data.append(p);
+}
+
+// Find the next record of a buffer, skipping the padding at its end
+// Called by the OsSysLogTask only.
+static const RecordHeader* peekRecord(RecordBuffer* pBuffer)
+{
+   size_t head = pBuffer->mHead;
+   size_t tail = __atomic_load_n(&pBuffer->mTail, __ATOMIC_SEQ_CST);
+   const RecordHeader* pRecord = NULL;
+
+   while (head != tail && pRecord == NULL)
+   {
+      size_t offset = head & (OSSYSLOG_RECORD_BUFFER_SIZE - 1);
+      if (OSSYSLOG_RECORD_BUFFER_SIZE - offset < sizeof(RecordHeader))
+      {
+         // Too short for a header, the writer skipped it
+         head += OSSYSLOG_RECORD_BUFFER_SIZE - offset;
+      }
+      else
+      {
+         const RecordHeader* pHeader = (const RecordHeader*) &pBuffer->mData[offset];
+         if (pHeader->mFlags & RECORD_FLAG_PADDING)
+         {
+            head += pHeader->mSize;
+         }
+         else
+         {
+            pRecord = pHeader;
+         }
+      }
+   }
+
+   if (head != pBuffer->mHead)
+   {
+      __atomic_store_n(&pBuffer->mHead, head, __ATOMIC_RELEASE);
+   }
+
+   return pRecord;
+}
+
+// Sum the dropped records, sBuffersMutex must be held
+static unsigned long countDropped()
+{
+   unsigned long dropped = sFreedDropped;
+   for (RecordBuffer* pBuffer = sBuffers; pBuffer; pBuffer = pBuffer->mpNext)
+   {
+      dropped += __atomic_load_n(&pBuffer->mDropped, __ATOMIC_RELAXED);
+   }
+   return dropped;
+}
+
+#endif // OSSYSLOG_RECORD_BUFFERS ]
+
+/* //////////////////////////// PUBLIC //////////////////////////////////// */
+
+/* ============================ CREATORS ================================== */
+
+/* ============================ MANIPULATORS ============================== */
+
+#ifdef OSSYSLOG_RECORD_BUFFERS // [
+
+OsStatus OsSysLogRecordBuffer::add(const char*            taskName,
+                                   const OsTaskId_t       taskId,
+                                   const OsSysLogFacility facility,
+                                   const OsSysLogPriority priority,
+                                   const char*            format,
+                                   va_list                ap)
+{
+   pthread_once(&sBufferKeyOnce, createBufferKey);
+   RecordBuffer* pBuffer = (RecordBuffer*) pthread_getspecific(sBufferKey);
+   if (pBuffer == NULL)
+   {
+      pBuffer = new RecordBuffer();
+      OsSysLog::getTaskInfo(pBuffer->mTaskName, pBuffer->mTaskId);
+      pBuffer->mDiscard = (pBuffer->mTaskName == "syslog");
+      if (pthread_setspecific(sBufferKey, pBuffer) != 0)
+      {
+         delete pBuffer;
+         return OS_NOT_SUPPORTED;
+      }
+
+      pthread_mutex_lock(&sBuffersMutex);
+      pBuffer->mpNext = sBuffers;
+      sBuffers = pBuffer;
+      pthread_mutex_unlock(&sBuffersMutex);
+   }
+
+   // Events of the syslog task itself are discarded, as OsSysLog::vadd() does
+   if (taskName == NULL ? pBuffer->mDiscard : strcmp(taskName, "syslog") == 0)
+   {
+      return OS_SUCCESS;
+   }
+
+   // Size the record.  Format strings are copied too: not all of them are
+   // literals which outlive the record.
+   size_t size = sizeof(RecordHeader);
+   if (taskName != NULL)
+   {
+      putString(NULL, size, taskName);
+   }
+   putString(NULL, size, format);
+
+   va_list args;
+   va_copy(args, ap);
+   UtlBoolean supported = recordArguments(format, args, NULL, size);
+   va_end(args);
+   if (!supported || size > RECORD_MAX_SIZE)
+   {
+      return OS_NOT_SUPPORTED;
+   }
+
+   // Make room, skipping the end of the buffer if the record does not fit
+   size_t tail = pBuffer->mTail;
+   size_t head = __atomic_load_n(&pBuffer->mHead, __ATOMIC_ACQUIRE);
+   size_t offset = tail & (OSSYSLOG_RECORD_BUFFER_SIZE - 1);
+   size_t padding = 0;
+   if (offset + size > OSSYSLOG_RECORD_BUFFER_SIZE)
+   {
+      padding = OSSYSLOG_RECORD_BUFFER_SIZE - offset;
+   }
+   if (tail + padding + size - head > OSSYSLOG_RECORD_BUFFER_SIZE)
+   {
+      __atomic_store_n(&pBuffer->mDropped, pBuffer->mDropped + 1, __ATOMIC_RELAXED);
+      return OS_LIMIT_REACHED;
+   }
+   if (padding > 0)
+   {
+      if (padding >= sizeof(RecordHeader))
+      {
+         RecordHeader* pPadding = (RecordHeader*) &pBuffer->mData[offset];
+         pPadding->mSize = padding;
+         pPadding->mFlags = RECORD_FLAG_PADDING;
+      }
+      tail += padding;
+      offset = 0;
+   }
+
+   // Write it
+   OsTime now;
+   OsDateTime::getCurTime(now);
+
+   RecordHeader* pRecord = (RecordHeader*) &pBuffer->mData[offset];
+   pRecord->mSize = size;
+   pRecord->mSeconds = now.seconds();
+   pRecord->mMicroseconds = now.usecs();
+   pRecord->mTaskId = (taskName != NULL) ? taskId : pBuffer->mTaskId;
+   pRecord->mFacility = facility;
+   pRecord->mPriority = priority;
+   pRecord->mFlags = (taskName != NULL) ? RECORD_FLAG_TASK_NAME : 0;
+
+   char* pArgs = (char*) (pRecord + 1);
+   size_t argsSize = 0;
+   if (taskName != NULL)
+   {
+      putString(pArgs, argsSize, taskName);
+   }
+   putString(pArgs, argsSize, format);
+
+   va_copy(args, ap);
+   recordArguments(format, args, pArgs, argsSize);
+   va_end(args);
+
+   __atomic_store_n(&pBuffer->mTail, tail + size, __ATOMIC_SEQ_CST);
+
+   // Wake up the OsSysLogTask unless it is already going to look
+   if (!__atomic_load_n(&sDrainPending, __ATOMIC_SEQ_CST) &&
+       !__atomic_exchange_n(&sDrainPending, 1, __ATOMIC_SEQ_CST))
+   {
+      OsSysLogTask* pTask = OsSysLog::spOsSysLogTask;
+      OsSysLogMsg msg(OsSysLogMsg::DRAIN_RECORDS, NULL);
+      if (pTask == NULL ||
+          pTask->postMessage(msg, OsTime(OsTime::NO_WAIT_TIME)) != OS_SUCCESS)
+      {
+         __atomic_store_n(&sDrainPending, 0, __ATOMIC_SEQ_CST);
+      }
+   }
+
+   return OS_SUCCESS;
+}
+
+char* OsSysLogRecordBuffer::getNextEntry()
+{
+   // Records added from now on must wake us up again
+   __atomic_store_n(&sDrainPending, 0, __ATOMIC_SEQ_CST);
+
+   // Find the oldest record, freeing the empty buffers of exited threads
+   RecordBuffer* pOldest = NULL;
+   const RecordHeader* pOldestRecord = NULL;
+   unsigned long dropped = 0;
+
+   pthread_mutex_lock(&sBuffersMutex);
+   RecordBuffer** ppBuffer = &sBuffers;
+   while (*ppBuffer != NULL)
+   {
+      RecordBuffer* pBuffer = *ppBuffer;
+      int exited = __atomic_load_n(&pBuffer->mExited, __ATOMIC_ACQUIRE);
+      const RecordHeader* pRecord = peekRecord(pBuffer);
+
+      if (pRecord == NULL && exited)
+      {
+         *ppBuffer = pBuffer->mpNext;
+         sFreedDropped += pBuffer->mDropped;
+         delete pBuffer;
+         continue;
+      }
+
+      if (pRecord != NULL &&
+          (pOldestRecord == NULL ||
+           pRecord->mSeconds < pOldestRecord->mSeconds ||
+           (pRecord->mSeconds == pOldestRecord->mSeconds &&
+            pRecord->mMicroseconds < pOldestRecord->mMicroseconds)))
+      {
+         pOldest = pBuffer;
+         pOldestRecord = pRecord;
+      }
+      ppBuffer = &pBuffer->mpNext;
+   }
+   if (pOldestRecord == NULL)
+   {
+      dropped = countDropped();
+   }
+   pthread_mutex_unlock(&sBuffersMutex);
+
+   UtlString logData;
+   UtlString logEntry;
+   if (pOldestRecord != NULL)
+   {
+      const char* pArgs = (const char*) (pOldestRecord + 1);
+      const char* taskName = pOldest->mTaskName.data();
+      if (pOldestRecord->mFlags & RECORD_FLAG_TASK_NAME)
+      {
+         taskName = getString(pArgs);
+      }
+      const char* format = getString(pArgs);
+      formatArguments(logData, format, pArgs);
+
+      OsSysLog::formatEntry(logEntry,
+                            OsTime(pOldestRecord->mSeconds, pOldestRecord->mMicroseconds),
+                            (OsSysLogFacility) pOldestRecord->mFacility,
+                            (OsSysLogPriority) pOldestRecord->mPriority,
+                            taskName, pOldestRecord->mTaskId,
+                            OsSysLog::escape(logData));
+
+      __atomic_store_n(&pOldest->mHead, pOldest->mHead + pOldestRecord->mSize,
+                       __ATOMIC_RELEASE);
+   }
+   else if (dropped != sReportedDropped)
+   {
+      // The buffers are empty, tell what was lost
+      logData.appendFormat("OsSysLog dropped %lu records because record buffers were full",
+                           dropped - sReportedDropped);
+      sReportedDropped = dropped;
+
+      OsTime now;
+      OsDateTime::getCurTime(now);
+      OsTaskId_t taskId = 0;
+      OsTask::getCurrentTaskId(taskId);
+      OsSysLog::formatEntry(logEntry, now, FAC_LOG, PRI_WARNING,
+                            "syslog", taskId, logData);
+   }
+   else
+   {
+      return NULL;
+   }
+
+   return strdup(logEntry.data());
+}
+
+/* ============================ ACCESSORS ================================= */
+
+unsigned long OsSysLogRecordBuffer::getDroppedCount()
+{
+   pthread_mutex_lock(&sBuffersMutex);
+   unsigned long dropped = countDropped();
+   pthread_mutex_unlock(&sBuffersMutex);
+
+   return dropped;
+}
+
+#else // OSSYSLOG_RECORD_BUFFERS ][
+
+OsStatus OsSysLogRecordBuffer::add(const char*            taskName,
+                                   const OsTaskId_t       taskId,
+                                   const OsSysLogFacility facility,
+                                   const OsSysLogPriority priority,
+                                   const char*            format,
+                                   va_list                ap)
+{
+   return OS_NOT_SUPPORTED;
+}
+
+char* OsSysLogRecordBuffer::getNextEntry()
+{
+   return NULL;
+}
+
+unsigned long OsSysLogRecordBuffer::getDroppedCount()
+{
+   return 0;
+}
+
+#endif // OSSYSLOG_RECORD_BUFFERS ]
+
+/* ============================ INQUIRY =================================== */
+
+/* //////////////////////////// PROTECTED ///////////////////////////////// */
+
+/* //////////////////////////// PRIVATE /////////////////////////////////// */
+
+/* ============================ FUNCTIONS ================================= */
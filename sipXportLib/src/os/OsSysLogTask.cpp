@@ -28,6 +28,7 @@
 // APPLICATION INCLUDES
 #include "os/OsSysLogTask.h"
 #include "os/OsSysLogMsg.h"
+#include "os/OsSysLogRecordBuffer.h"
 #include "os/OsStatus.h"
 #include "os/OsServerTask.h"
 #include "os/OsDateTime.h"
@@ -274,6 +275,8 @@ UtlBoolean OsSysLogTask::handleMessage(OsMsg& eventMessage)
          switch (pSysLogMsg->getMsgSubType())
          {
             case OsSysLogMsg::LOG:
+               // Earlier records of the thread go first
+               processRecords();
                data = (char*) pSysLogMsg->getData();
                processAdd(data);
                mLogCount++;
@@ -313,8 +316,12 @@ UtlBoolean OsSysLogTask::handleMessage(OsMsg& eventMessage)
                processSetFlushPeriod((intptr_t) pSysLogMsg->getData()) ;
                break ;
             case OsSysLogMsg::FLUSH_LOG:
+               processRecords();
                processFlushLog((OsEvent*) pSysLogMsg->getData());
                break ;
+            case OsSysLogMsg::DRAIN_RECORDS:
+               processRecords();
+               break ;
             default:
                break ;
          }
@@ -520,6 +527,22 @@ OsStatus OsSysLogTask::processAdd(char* pEntry)
    return status ;
 }
 
+// Formats and adds the records of the record buffers, oldest first
+OsStatus OsSysLogTask::processRecords()
+{
+   if (mOptions & OsSysLog::OPT_RECORD_BUFFERS)
+   {
+      char* pEntry ;
+      while ((pEntry = OsSysLogRecordBuffer::getNextEntry()) != NULL)
+      {
+         processAdd(pEntry) ;
+         mLogCount++ ;
+      }
+   }
+
+   return OS_SUCCESS ;
+}
+
 
 // Process a console enable/disable command
 OsStatus OsSysLogTask::processConsoleEnable(const UtlBoolean enable)
@@ -52,7 +52,7 @@ OsTimer::OsTimer(OsMsgQ* pQueue, intptr_t userData) :
    mpNotifier(new OsQueuedEvent(*pQueue, userData)) ,
    mbManagedNotifier(TRUE),
    mOutstandingMessages(0),
-   mTimerQueueLink(0)
+   mTimerQueueIndex(-1)
 {
 #ifdef VALGRIND_TIMER_ERROR
    // Initialize the variables for tracking timer access.
@@ -73,7 +73,7 @@ OsTimer::OsTimer(OsNotification& rNotifier) :
    mpNotifier(&rNotifier) ,
    mbManagedNotifier(FALSE),
    mOutstandingMessages(0),
-   mTimerQueueLink(0)
+   mTimerQueueIndex(-1)
 {
 #ifdef VALGRIND_TIMER_ERROR
    // Initialize the variables for tracking timer access.
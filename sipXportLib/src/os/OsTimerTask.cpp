@@ -13,6 +13,7 @@
 
 // SYSTEM INCLUDES
 #include <assert.h>
+#include <string.h>
 
 // APPLICATION INCLUDES
 #include "os/OsEvent.h"
@@ -34,6 +35,8 @@ volatile OsTimerTask* OsTimerTask::spInstance = 0;
 // which can lead to problems with the ordering of destructors.
 OsBSem*      OsTimerTask::sLock = new OsBSem(OsBSem::Q_PRIORITY, OsBSem::FULL);
 const int    OsTimerTask::TIMER_MAX_REQUEST_MSGS = 10000;
+const int    OsTimerTask::TIMER_HEAP_ARITY = 4;
+const int    OsTimerTask::TIMER_HEAP_INITIAL_CAPACITY = 1024;
 
 /* //////////////////////////// PUBLIC //////////////////////////////////// */
 
@@ -98,6 +101,10 @@ OsTimerTask::~OsTimerTask()
    // been added to the incoming queue while we were waiting for the
    // OS_TIMER_SHUTDOWN message to get through the queue, as getTimerTask would
    // have waited for sLock.
+   waitUntilShutDown();
+
+   // The timer queue was emptied when OS_TIMER_SHUTDOWN was processed.
+   delete[] mpTimerHeap;
 }
 
 /* ============================ MANIPULATORS ============================== */
@@ -115,7 +122,9 @@ OsTimerTask::OsTimerTask(void)
 : OsServerTask("OsTimer-%d", NULL, TIMER_MAX_REQUEST_MSGS
               , 5 // high priority so that we get reasonable clock heartbeats for media
               )
-, mTimerQueue(0)
+, mpTimerHeap(new OsTimer*[TIMER_HEAP_INITIAL_CAPACITY])
+, mTimerHeapSize(0)
+, mTimerHeapCapacity(TIMER_HEAP_INITIAL_CAPACITY)
 , mSignalTimeout(0, 50000)
 {
 }
@@ -138,13 +147,13 @@ int OsTimerTask::run(void* pArg)
       // Do not attempt to receive message if a timer has already fired.
       // (This also avoids an edge case if the timeout value is zero
       // or negative.)
-      if (!mTimerQueue || (now < mTimerQueue->mQueuedExpiresAt))
+      if (mTimerHeapSize == 0 || (now < mpTimerHeap[0]->mQueuedExpiresAt))
       {
          // Set the timeout till the next timer fires.
          OsTime timeout;
-         if (mTimerQueue)
+         if (mTimerHeapSize > 0)
          {
-            timeout = mTimerQueue->mQueuedExpiresAt - now;
+            timeout = mpTimerHeap[0]->mQueuedExpiresAt - now;
          }
          else
          {
@@ -178,15 +187,12 @@ int OsTimerTask::run(void* pArg)
       }
 
       // Now check for timers that have expired.
-      while (mTimerQueue &&
-             now >= mTimerQueue->mQueuedExpiresAt)
+      while (mTimerHeapSize > 0 &&
+             now >= mpTimerHeap[0]->mQueuedExpiresAt)
       {
          // Fire the the timer (and remove it from the queue).
-         OsTimer* timer = mTimerQueue;
-         mTimerQueue = timer->mTimerQueueLink;
-         // Clear the timer's mTimerQueueLink to indicate it is not
-         // in the timer queue.
-         timer->mTimerQueueLink = 0;
+         OsTimer* timer = mpTimerHeap[0];
+         removeTimer(timer);
          fireTimer(timer);
       }
 
@@ -242,9 +248,10 @@ UtlBoolean OsTimerTask::handleMessage(OsMsg& rMsg)
       assert(getMessageQueue()->isEmpty());
 
       // Stop all the timers in the timer queue.
-      OsTimer* link;
-      for (OsTimer* timer = mTimerQueue; timer; timer = link)
+      for (int i = 0; i < mTimerHeapSize; i++)
       {
+         OsTimer* timer = mpTimerHeap[i];
+
          // This lock should never block, since the application should not
          // be accessing the timer.
          OsLock lock(timer->mBSem);
@@ -256,14 +263,11 @@ UtlBoolean OsTimerTask::handleMessage(OsMsg& rMsg)
          timer->mTaskState =
             timer->mApplicationState = timer->mApplicationState + 1;
 
-         // Get the link field.
-         link = timer->mTimerQueueLink;
-
-         // Clear the link field of the timer.
-         timer->mTimerQueueLink = 0;
+         // Mark the timer as not being in the timer queue.
+         timer->mTimerQueueIndex = -1;
       }
       // Empty the timer queue.
-      mTimerQueue = 0;
+      mTimerHeapSize = 0;
 
       // Change mState so the main loop will exit.
       requestShutdown();
@@ -443,9 +447,7 @@ void OsTimerTask::fireTimer(OsTimer* timer)
 // Insert a timer into the timer queue.
 void OsTimerTask::insertTimer(OsTimer* timer)
 {
-   OsTimer** previous_ptr;
-   OsTimer* current;
-   assert(timer->mTimerQueueLink == 0);
+   assert(timer->mTimerQueueIndex == -1);
    // Check to see if the firing time is in the past.
    // This is not an error, but is unusual and probably indicates a backlog
    // in processing.
@@ -465,62 +467,127 @@ void OsTimerTask::insertTimer(OsTimer* timer)
       }
    }
 
-   // Scan through the timer queue, looking for the right place to
-   // insert the timer.
-   for (previous_ptr = &mTimerQueue, current = mTimerQueue;
-        current && (timer->mQueuedExpiresAt > current->mQueuedExpiresAt);
-        previous_ptr = &current->mTimerQueueLink,
-           current = current->mTimerQueueLink)
+   // Grow the heap if it is full.
+   if (mTimerHeapSize == mTimerHeapCapacity)
    {
-      /* null */
+      int newCapacity = 2 * mTimerHeapCapacity;
+      OsTimer** newHeap = new OsTimer*[newCapacity];
+      memcpy(newHeap, mpTimerHeap, mTimerHeapSize * sizeof(OsTimer*));
+      delete[] mpTimerHeap;
+      mpTimerHeap = newHeap;
+      mTimerHeapCapacity = newCapacity;
    }
 
-   // Insert the timer.
-   *previous_ptr = timer;
-   timer->mTimerQueueLink = current;
+   // Append the timer as a new leaf and restore the heap order.
+   setHeapSlot(mTimerHeapSize, timer);
+   mTimerHeapSize++;
+   siftUp(timer->mTimerQueueIndex);
 }
 
 // Remove a timer from the timer queue.
 void OsTimerTask::removeTimer(OsTimer* timer)
 {
-   OsTimer** previous_ptr;
-   OsTimer* current;
-
-   // Scan through the timer queue, looking for this timer.
-   for (previous_ptr = &mTimerQueue, current = mTimerQueue;
-        current && current != timer;
-        previous_ptr = &current->mTimerQueueLink,
-           current = current->mTimerQueueLink)
-   {
-      /* null */
-   }
+   int index = timer->mTimerQueueIndex;
 
-   // Remove the timer, if we found it.
-   if (!current)
+   // Remove the timer, if it is in the queue.
+   if (index < 0 || index >= mTimerHeapSize || mpTimerHeap[index] != timer)
    {
       OsSysLog::add(FAC_KERNEL, PRI_EMERG,
                     "OsTimerTask::removeTimer timer not found in queue");
       // mDeleting is not used if NDEBUG is defined, but we always initialize
       // it to FALSE in the constructors anyway.
       OsSysLog::add(FAC_KERNEL, PRI_EMERG,
-                    "OsTimerTask::removeTimer timer = %p, mApplicationState = %d, mTaskState = %d, mDeleting = %d, mPeriodic = %d, mTimerQueueLink = %p",
+                    "OsTimerTask::removeTimer timer = %p, mApplicationState = %d, mTaskState = %d, mDeleting = %d, mPeriodic = %d, mTimerQueueIndex = %d",
                     timer, timer->mApplicationState, timer->mTaskState, timer->mDeleting,
-                    timer->mPeriodic, timer->mTimerQueueLink);
-      OsTimer* p;
-      for (p = mTimerQueue; p; p = p->mTimerQueueLink)
+                    timer->mPeriodic, timer->mTimerQueueIndex);
+      for (int i = 0; i < mTimerHeapSize; i++)
       {
          OsSysLog::add(FAC_KERNEL, PRI_EMERG,
-                       "OsTimerTask::removeTimer in queue %p", p);
+                       "OsTimerTask::removeTimer in queue %p", mpTimerHeap[i]);
       }
       OsSysLog::add(FAC_KERNEL, PRI_EMERG,
                     "OsTimerTask::removeTimer end of queue");
+      assert(FALSE);
+      return;
+   }
+
+   // Move the last leaf into the vacated slot and restore the heap order.
+   // The moved timer may need to go either up or down; at most one of
+   // the two sifts will move it.
+   mTimerHeapSize--;
+   if (index < mTimerHeapSize)
+   {
+      setHeapSlot(index, mpTimerHeap[mTimerHeapSize]);
+      siftUp(index);
+      siftDown(index);
+   }
+
+   // Mark the timer as not being in the timer queue.
+   timer->mTimerQueueIndex = -1;
+}
+
+// Store a timer into a heap slot, updating its recorded position.
+void OsTimerTask::setHeapSlot(int index, OsTimer* timer)
+{
+   mpTimerHeap[index] = timer;
+   timer->mTimerQueueIndex = index;
+}
+
+// Move the timer in slot index toward the root until the heap is ordered.
+void OsTimerTask::siftUp(int index)
+{
+   OsTimer* timer = mpTimerHeap[index];
+
+   while (index > 0)
+   {
+      int parent = (index - 1) / TIMER_HEAP_ARITY;
+      if (!(timer->mQueuedExpiresAt < mpTimerHeap[parent]->mQueuedExpiresAt))
+      {
+         break;
+      }
+      setHeapSlot(index, mpTimerHeap[parent]);
+      index = parent;
    }
-   assert(current);
+   setHeapSlot(index, timer);
+}
+
+// Move the timer in slot index toward the leaves until the heap is ordered.
+void OsTimerTask::siftDown(int index)
+{
+   OsTimer* timer = mpTimerHeap[index];
 
-   *previous_ptr = timer->mTimerQueueLink;
-   // Clear the timer's mTimerQueueLink to indicate it is not in the
-   // timer queue.
-   timer->mTimerQueueLink = 0;
+   for (;;)
+   {
+      int firstChild = index * TIMER_HEAP_ARITY + 1;
+      if (firstChild >= mTimerHeapSize)
+      {
+         break;
+      }
+
+      // Find the earliest-firing child.
+      int lastChild = firstChild + TIMER_HEAP_ARITY;
+      if (lastChild > mTimerHeapSize)
+      {
+         lastChild = mTimerHeapSize;
+      }
+      int earliest = firstChild;
+      for (int child = firstChild + 1; child < lastChild; child++)
+      {
+         if (mpTimerHeap[child]->mQueuedExpiresAt <
+             mpTimerHeap[earliest]->mQueuedExpiresAt)
+         {
+            earliest = child;
+         }
+      }
+
+      if (!(mpTimerHeap[earliest]->mQueuedExpiresAt < timer->mQueuedExpiresAt))
+      {
+         break;
+      }
+      setHeapSlot(index, mpTimerHeap[earliest]);
+      index = earliest;
+   }
+   setHeapSlot(index, timer);
 }
 
 /* ============================ FUNCTIONS ================================= */
@@ -10,10 +10,16 @@
 
 #include <time.h>
 #include <sys/time.h>
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/syscall.h>
+#endif
 
 /* This function comes from librt.so. We would prefer not to need that library
  * but the RTCP code uses clock_gettime(). Rather than rewrite that code, we
- * just implement clock_gettime() using gettimeofday(). */
+ * just implement clock_gettime() using gettimeofday().
+ * As this replaces the library function for the whole process, the other
+ * clocks (CLOCK_MONOTONIC for the media timers) are read from the kernel. */
 
 #ifdef __APPLE__
 /* we don't even have the typedef on OS X */
@@ -23,6 +29,10 @@ typedef int clockid_t;
 int clock_gettime(clockid_t clock_id, struct timespec * tp)
 {
         struct timeval tv;
+#if defined(__linux__) && defined(SYS_clock_gettime)
+        if(clock_id != CLOCK_REALTIME)
+                return syscall(SYS_clock_gettime, clock_id, tp);
+#endif
         if(gettimeofday(&tv, NULL))
                 return -1;
         tp->tv_sec = tv.tv_sec;
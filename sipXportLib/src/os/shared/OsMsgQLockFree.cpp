@@ -0,0 +1,445 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+
+// SYSTEM INCLUDES
+#include <assert.h>
+
+// APPLICATION INCLUDES
+#include "os/shared/OsMsgQLockFree.h"
+#include "os/OsSysLog.h"
+
+#ifdef OS_MSGQ_LOCK_FREE_SUPPORTED // [
+
+#include <errno.h>
+#include <limits.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/futex.h>
+
+// EXTERNAL FUNCTIONS
+// EXTERNAL VARIABLES
+// CONSTANTS
+#define NSECS_PER_SEC 1000000000LL
+
+// STATIC VARIABLE INITIALIZATIONS
+
+/* //////////////////////////// PUBLIC //////////////////////////////////// */
+
+/* ============================ CREATORS ================================== */
+
+// Constructor
+// If the name is specified but is already in use, throw an exception
+OsMsgQLockFree::OsMsgQLockFree(const int maxMsgs, const UtlString& name)
+: OsMsgQBase(name)
+, mNumMsgs(0)
+, mNotEmptySeq(0)
+, mNotEmptyWaiters(0)
+, mNotFullSeq(0)
+, mNotFullWaiters(0)
+{
+   mMaxMsgs = maxMsgs;
+
+   // Both rings must be able to hold every message, as mNumMsgs is the
+   // only limit on how many messages of each kind may be queued.
+   initRing(mNormal, maxMsgs);
+   initRing(mUrgent, maxMsgs);
+
+#ifdef MSGQ_IS_VALID_CHECK /* [ */
+   mNumInsertEntry = 0;
+   mNumInsertExitOk = 0;
+   mNumInsertExitFail = 0;
+
+   mNumRemoveEntry = 0;
+   mNumRemoveExitOk = 0;
+   mNumRemoveExitFail = 0;
+
+   mLastSuccessTest = 0;
+#endif /* MSGQ_IS_VALID_CHECK ] */
+}
+
+// Destructor
+OsMsgQLockFree::~OsMsgQLockFree()
+{
+   if (numMsgs())
+      flush();    // get rid of any messages in the queue
+
+   delete[] mNormal.mpCells;
+   delete[] mUrgent.mpCells;
+}
+
+/* ============================ MANIPULATORS ============================== */
+
+OsStatus OsMsgQLockFree::send(const OsMsg& rMsg,
+                              const OsTime& rTimeout)
+{
+   return doSend(rMsg, rTimeout, FALSE, TRUE);
+}
+
+OsStatus OsMsgQLockFree::sendNoCopy(OsMsg *pMsg,
+                                    const OsTime& rTimeout)
+{
+   return doSend(*pMsg, rTimeout, FALSE, FALSE);
+}
+
+OsStatus OsMsgQLockFree::sendUrgent(const OsMsg& rMsg,
+                                    const OsTime& rTimeout)
+{
+   return doSend(rMsg, rTimeout, TRUE, TRUE);
+}
+
+OsStatus OsMsgQLockFree::sendFromISR(OsMsg& rMsg)
+{
+   // set a flag in the msg to indicate if the message was sent
+   // from an ISR
+   rMsg.setSentFromISR(TRUE);
+
+   return doSend(rMsg, OsTime::NO_WAIT_TIME, FALSE, FALSE);
+}
+
+// Remove a message from the head of the queue
+// Wait until either a message arrives or the timeout expires.
+// Other than for messages sent from an ISR, the receiver is responsible
+// for freeing the received message.
+OsStatus OsMsgQLockFree::receive(OsMsg*& rpMsg, const OsTime& rTimeout)
+{
+#ifdef MSGQ_IS_VALID_CHECK
+   __atomic_add_fetch(&mNumRemoveEntry, 1, __ATOMIC_RELAXED);
+#endif
+
+   rpMsg = tryReceive();
+   if (rpMsg == NULL && !rTimeout.isNoWait())
+   {
+      long long deadline = getDeadline(rTimeout);
+      OsStatus ret = OS_SUCCESS;
+
+      while (rpMsg == NULL && ret == OS_SUCCESS)
+      {
+         // Register as a waiter before checking the queue again, so a
+         // sender that publishes a message after our check is certain to
+         // see us and bump mNotEmptySeq.
+         int seq = __atomic_load_n(&mNotEmptySeq, __ATOMIC_SEQ_CST);
+         __atomic_add_fetch(&mNotEmptyWaiters, 1, __ATOMIC_SEQ_CST);
+         rpMsg = tryReceive();
+         if (rpMsg == NULL)
+         {
+            ret = waitOn(&mNotEmptySeq, seq, deadline);
+            if (ret != OS_SUCCESS)
+            {
+               // A message may have arrived just as we timed out.
+               rpMsg = tryReceive();
+            }
+         }
+         __atomic_sub_fetch(&mNotEmptyWaiters, 1, __ATOMIC_SEQ_CST);
+      }
+   }
+
+#ifdef MSGQ_IS_VALID_CHECK
+   if (rpMsg != NULL)
+      __atomic_add_fetch(&mNumRemoveExitOk, 1, __ATOMIC_RELAXED);
+   else
+      __atomic_add_fetch(&mNumRemoveExitFail, 1, __ATOMIC_RELAXED);
+#endif
+
+   return rpMsg != NULL ? OS_SUCCESS : OS_WAIT_TIMEOUT;
+}
+
+/* ============================ ACCESSORS ================================= */
+
+// Return the number of messages in the queue
+int OsMsgQLockFree::numMsgs(void)
+{
+   return __atomic_load_n(&mNumMsgs, __ATOMIC_ACQUIRE);
+}
+
+/* ============================ INQUIRY =================================== */
+
+/* //////////////////////////// PROTECTED ///////////////////////////////// */
+
+#ifdef MSGQ_IS_VALID_CHECK
+// Test for message queue integrity
+void OsMsgQLockFree::testMessageQ()
+{
+   // There is no point at which the counters can be compared consistently
+   // without stopping senders, so only check the invariant on mNumMsgs.
+   int numMsgs = __atomic_load_n(&mNumMsgs, __ATOMIC_RELAXED);
+   assert(numMsgs >= 0 && numMsgs <= mMaxMsgs);
+}
+#endif
+
+/* //////////////////////////// PRIVATE /////////////////////////////////// */
+
+OsStatus OsMsgQLockFree::doSend(const OsMsg& rMsg, const OsTime& rTimeout,
+                                const UtlBoolean isUrgent,
+                                const UtlBoolean needCopy)
+{
+   OsStatus ret;
+   OsMsg*   pMsg;
+
+#ifdef MSGQ_IS_VALID_CHECK
+   __atomic_add_fetch(&mNumInsertEntry, 1, __ATOMIC_RELAXED);
+#endif
+
+   if (mSendHookFunc != NULL)
+   {
+      if (mSendHookFunc(rMsg))
+      {
+         // by returning TRUE, the mSendHookFunc indicates that it has handled
+         // the message and there is no need to queue the message.
+#ifdef MSGQ_IS_VALID_CHECK
+         __atomic_add_fetch(&mNumInsertExitOk, 1, __ATOMIC_RELAXED);
+#endif
+         return OS_SUCCESS;
+      }
+   }
+
+   ret = reserveSlot(rTimeout);   // wait for there to be room in the queue
+   if (ret == OS_SUCCESS)
+   {
+      if (!needCopy || rMsg.isMsgReusable())
+      {
+         // Messages sent from an ISR or marked as reusable are queued
+         // as is, just like OsMsgQShared does.
+         pMsg = (OsMsg*) &rMsg;
+      }
+      else
+      {
+         // we place a copy of the message on the queue
+         // so that the caller is free to destroy the original
+         pMsg = rMsg.createCopy();
+      }
+
+      pushRing(isUrgent ? mUrgent : mNormal, pMsg);
+
+      // signal the receiver that a msg is available
+      wakeOne(&mNotEmptySeq, &mNotEmptyWaiters);
+   }
+
+#ifdef MSGQ_IS_VALID_CHECK
+   if (ret == OS_SUCCESS)
+      __atomic_add_fetch(&mNumInsertExitOk, 1, __ATOMIC_RELAXED);
+   else
+      __atomic_add_fetch(&mNumInsertExitFail, 1, __ATOMIC_RELAXED);
+#endif
+
+   return ret;
+}
+
+// Reserve room for one message, blocking up to rTimeout.
+OsStatus OsMsgQLockFree::reserveSlot(const OsTime& rTimeout)
+{
+   long long deadline = -2;   // computed only if we have to block
+   int count = __atomic_load_n(&mNumMsgs, __ATOMIC_RELAXED);
+
+   for (;;)
+   {
+      if (count < mMaxMsgs)
+      {
+         if (__atomic_compare_exchange_n(&mNumMsgs, &count, count + 1,
+                                         TRUE, __ATOMIC_ACQ_REL,
+                                         __ATOMIC_RELAXED))
+         {
+            return OS_SUCCESS;
+         }
+         // count has been reloaded by the failed compare-and-swap.
+         continue;
+      }
+
+      // The queue is full.
+      if (rTimeout.isNoWait())
+      {
+         return OS_WAIT_TIMEOUT;
+      }
+      if (deadline == -2)
+      {
+         deadline = getDeadline(rTimeout);
+      }
+
+      int seq = __atomic_load_n(&mNotFullSeq, __ATOMIC_SEQ_CST);
+      __atomic_add_fetch(&mNotFullWaiters, 1, __ATOMIC_SEQ_CST);
+      OsStatus ret = OS_SUCCESS;
+      if (__atomic_load_n(&mNumMsgs, __ATOMIC_SEQ_CST) >= mMaxMsgs)
+      {
+         ret = waitOn(&mNotFullSeq, seq, deadline);
+      }
+      __atomic_sub_fetch(&mNotFullWaiters, 1, __ATOMIC_SEQ_CST);
+
+      count = __atomic_load_n(&mNumMsgs, __ATOMIC_RELAXED);
+      if (ret != OS_SUCCESS && count >= mMaxMsgs)
+      {
+         return OS_WAIT_TIMEOUT;
+      }
+   }
+}
+
+// Remove a message from the head of the queue without blocking.
+OsMsg* OsMsgQLockFree::tryReceive()
+{
+   OsMsg* pMsg = popRing(mUrgent);
+   if (pMsg == NULL)
+   {
+      pMsg = popRing(mNormal);
+   }
+
+   if (pMsg != NULL)
+   {
+      // Free the slot and let a blocked sender use it.
+      __atomic_sub_fetch(&mNumMsgs, 1, __ATOMIC_SEQ_CST);
+      wakeOne(&mNotFullSeq, &mNotFullWaiters);
+   }
+
+   return pMsg;
+}
+
+// Convert a timeout to an absolute CLOCK_MONOTONIC deadline in nsec.
+long long OsMsgQLockFree::getDeadline(const OsTime& rTimeout)
+{
+   if (rTimeout.isInfinite())
+   {
+      return -1;
+   }
+
+   struct timespec now;
+   clock_gettime(CLOCK_MONOTONIC, &now);
+   return (long long) now.tv_sec * NSECS_PER_SEC + now.tv_nsec
+          + (long long) rTimeout.seconds() * NSECS_PER_SEC
+          + (long long) rTimeout.usecs() * 1000;
+}
+
+// Wait on a futex word while it still holds expectedValue.
+OsStatus OsMsgQLockFree::waitOn(int* pWord, int expectedValue,
+                                long long deadline)
+{
+   struct timespec timeout;
+   struct timespec* pTimeout = NULL;
+
+   if (deadline >= 0)
+   {
+      struct timespec now;
+      clock_gettime(CLOCK_MONOTONIC, &now);
+      long long remaining =
+         deadline - ((long long) now.tv_sec * NSECS_PER_SEC + now.tv_nsec);
+      if (remaining <= 0)
+      {
+         return OS_WAIT_TIMEOUT;
+      }
+      timeout.tv_sec = remaining / NSECS_PER_SEC;
+      timeout.tv_nsec = remaining % NSECS_PER_SEC;
+      pTimeout = &timeout;
+   }
+
+   // FUTEX_WAIT returns at once if *pWord no longer equals expectedValue,
+   // which is how a wakeup between our check and this call is not lost.
+   if (syscall(SYS_futex, pWord, FUTEX_WAIT_PRIVATE, expectedValue,
+               pTimeout, NULL, 0) != 0 && errno == ETIMEDOUT)
+   {
+      return OS_WAIT_TIMEOUT;
+   }
+   return OS_SUCCESS;
+}
+
+// Wake one task blocked on a futex word, if any are waiting.
+void OsMsgQLockFree::wakeOne(int* pWord, int* pWaiters)
+{
+   // Order the publication of the message (or the freeing of a slot)
+   // before the check for waiters.  A waiter increments the waiter count
+   // before checking the queue, so one of the two sides sees the other.
+   __atomic_thread_fence(__ATOMIC_SEQ_CST);
+   if (__atomic_load_n(pWaiters, __ATOMIC_SEQ_CST) > 0)
+   {
+      __atomic_add_fetch(pWord, 1, __ATOMIC_SEQ_CST);
+      syscall(SYS_futex, pWord, FUTEX_WAKE_PRIVATE, 1, NULL, NULL, 0);
+   }
+}
+
+// Allocate the cells of a ring holding at least size messages.
+void OsMsgQLockFree::initRing(Ring& rRing, int size)
+{
+   size_t cells = 2;
+   while (cells < (size_t) size)
+   {
+      cells <<= 1;
+   }
+
+   rRing.mpCells = new Cell[cells];
+   for (size_t i = 0; i < cells; i++)
+   {
+      rRing.mpCells[i].mSequence = i;
+      rRing.mpCells[i].mpMsg = NULL;
+   }
+   rRing.mMask = cells - 1;
+   rRing.mSendPos = 0;
+   rRing.mReceivePos = 0;
+}
+
+// Store a message in a ring.  There must be a free cell.
+void OsMsgQLockFree::pushRing(Ring& rRing, OsMsg* pMsg)
+{
+   size_t pos = __atomic_load_n(&rRing.mSendPos, __ATOMIC_RELAXED);
+   Cell* pCell;
+
+   for (;;)
+   {
+      pCell = &rRing.mpCells[pos & rRing.mMask];
+      size_t seq = __atomic_load_n(&pCell->mSequence, __ATOMIC_ACQUIRE);
+      ptrdiff_t diff = (ptrdiff_t) seq - (ptrdiff_t) pos;
+      if (diff == 0)
+      {
+         // The cell is free for this position; try to claim it.
+         if (__atomic_compare_exchange_n(&rRing.mSendPos, &pos, pos + 1,
+                                         TRUE, __ATOMIC_RELAXED,
+                                         __ATOMIC_RELAXED))
+         {
+            break;
+         }
+      }
+      else if (diff < 0)
+      {
+         // The receiver has not finished with this cell yet.  The slot
+         // reservation guarantees it will very soon.
+         sched_yield();
+         pos = __atomic_load_n(&rRing.mSendPos, __ATOMIC_RELAXED);
+      }
+      else
+      {
+         // Another sender claimed this position first.
+         pos = __atomic_load_n(&rRing.mSendPos, __ATOMIC_RELAXED);
+      }
+   }
+
+   pCell->mpMsg = pMsg;
+   // Publish the message to the receiver.
+   __atomic_store_n(&pCell->mSequence, pos + 1, __ATOMIC_RELEASE);
+}
+
+// Take the oldest message from a ring, or NULL if it is empty.
+OsMsg* OsMsgQLockFree::popRing(Ring& rRing)
+{
+   // There is a single receiver, so mReceivePos needs no compare-and-swap.
+   size_t pos = rRing.mReceivePos;
+   Cell* pCell = &rRing.mpCells[pos & rRing.mMask];
+   size_t seq = __atomic_load_n(&pCell->mSequence, __ATOMIC_ACQUIRE);
+
+   if (seq != pos + 1)
+   {
+      // Empty, or the sender of the next message has not published it yet.
+      return NULL;
+   }
+
+   OsMsg* pMsg = pCell->mpMsg;
+   rRing.mReceivePos = pos + 1;
+   // Hand the cell back to senders for the next lap of the ring.
+   __atomic_store_n(&pCell->mSequence, pos + rRing.mMask + 1, __ATOMIC_RELEASE);
+
+   return pMsg;
+}
+
+/* ============================ FUNCTIONS ================================= */
+
+#endif // OS_MSGQ_LOCK_FREE_SUPPORTED ]
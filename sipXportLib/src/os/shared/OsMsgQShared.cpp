@@ -18,6 +18,7 @@
 // APPLICATION INCLUDES
 #include "os/OsLock.h"
 #include "os/shared/OsMsgQShared.h"
+#include "os/shared/OsMsgQLockFree.h"
 #include "os/OsDateTime.h"
 #include "os/OsSysLog.h"
 
@@ -40,6 +41,7 @@ OsMsgQShared::OsMsgQShared(const int maxMsgs, const int maxMsgLen,
 , mEmpty(OsCSem::Q_PRIORITY, maxMsgs, maxMsgs)
 , mFull(OsCSem::Q_PRIORITY, maxMsgs, 0)
 , mDlist()
+, mpLockFree(NULL)
 #ifdef MSGQ_IS_VALID_CHECK
 , mOptions(options)
 , mHighCnt(0)
@@ -47,6 +49,17 @@ OsMsgQShared::OsMsgQShared(const int maxMsgs, const int maxMsgLen,
 {
    mMaxMsgs = maxMsgs;
 
+   if (options & Q_LOCK_FREE)
+   {
+#ifdef OS_MSGQ_LOCK_FREE_SUPPORTED
+      mpLockFree = new OsMsgQLockFree(maxMsgs);
+#else
+      OsSysLog::add(FAC_KERNEL, PRI_WARNING,
+                    "OsMsgQShared::OsMsgQShared Q_LOCK_FREE is not supported"
+                    " on this platform, using a locked queue");
+#endif
+   }
+
 #ifdef OS_MSGQ_REPORTING
    mIncrementLevel = mMaxMsgs / 20;
    if (mIncrementLevel < 1)
@@ -79,6 +92,10 @@ OsMsgQShared::~OsMsgQShared()
 {
     if (numMsgs())
         flush();    // get rid of any messages in the queue
+
+#ifdef OS_MSGQ_LOCK_FREE_SUPPORTED
+    delete mpLockFree;
+#endif
 }
 
 /* ============================ MANIPULATORS ============================== */
@@ -117,6 +134,12 @@ OsStatus OsMsgQShared::sendFromISR(OsMsg& rMsg)
 // for freeing the received message.
 OsStatus OsMsgQShared::receive(OsMsg*& rpMsg, const OsTime& rTimeout)
 {
+#ifdef OS_MSGQ_LOCK_FREE_SUPPORTED
+   if (mpLockFree)
+   {
+      return mpLockFree->receive(rpMsg, rTimeout);
+   }
+#endif
    return doReceive(rpMsg, rTimeout);
 }
 
@@ -126,6 +149,12 @@ OsStatus OsMsgQShared::receive(OsMsg*& rpMsg, const OsTime& rTimeout)
 // Return the number of messages in the queue
 int OsMsgQShared::numMsgs(void)
 {
+#ifdef OS_MSGQ_LOCK_FREE_SUPPORTED
+   if (mpLockFree)
+   {
+      return mpLockFree->numMsgs();
+   }
+#endif
    OsLock lock(mGuard);
 
    return(mDlist.entries());
@@ -195,6 +224,21 @@ OsStatus OsMsgQShared::doSend(const OsMsg& rMsg, const OsTime& rTimeout,
       }
    }
 
+#ifdef OS_MSGQ_LOCK_FREE_SUPPORTED
+   if (mpLockFree)
+   {
+      // The send hook has already been applied, so pass the message on
+      // as the original send method would.
+      if (isUrgent)
+         ret = mpLockFree->sendUrgent(rMsg, rTimeout);
+      else if (needCopy)
+         ret = mpLockFree->send(rMsg, rTimeout);
+      else
+         ret = mpLockFree->sendNoCopy((OsMsg*) &rMsg, rTimeout);
+      return ret;
+   }
+#endif
+
    ret = mEmpty.acquire(rTimeout);   // wait for there to be room in the queue
    if (ret != OS_SUCCESS)
    {
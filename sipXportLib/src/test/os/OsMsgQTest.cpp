@@ -11,11 +11,20 @@
 // $$
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <stdio.h>
+
+#include <os/OsDateTime.h>
 #include <os/OsExcept.h>
 #include <os/OsMsg.h>
 #include <os/OsMsgQ.h>
+#include <os/OsTask.h>
 #include <sipxunittests.h>
 
+// Number of messages received in each throughput measurement.
+#define THROUGHPUT_MSGS 400000
+// Queue length used in throughput measurements.
+#define THROUGHPUT_QUEUE_LEN 1000
+
 UtlBoolean gMsgReceived;
 
 UtlBoolean msgSendHook(const OsMsg& rOsMsg)
@@ -25,15 +34,150 @@ UtlBoolean msgSendHook(const OsMsg& rOsMsg)
     return FALSE;
 }
 
+/// Thread that sends a fixed number of messages to a queue.
+class MsgQProducer : public OsTask
+{
+public:
+
+   MsgQProducer(OsMsgQ* pQueue, int numMsgs)
+   : OsTask("MsgQProducer-%d")
+   , mpQueue(pQueue)
+   , mNumMsgs(numMsgs)
+   {
+   }
+
+   ~MsgQProducer()
+   {
+      waitUntilShutDown();
+   }
+
+   int run(void* pArg)
+   {
+      OsMsg msg(OsMsg::UNSPECIFIED, 0);
+      for (int i = 0; i < mNumMsgs; i++)
+      {
+         mpQueue->send(msg);
+      }
+      return 0;
+   }
+
+protected:
+   OsMsgQ* mpQueue;
+   int mNumMsgs;
+};
+
 class OsMsgQTest : public SIPX_UNIT_BASE_CLASS
 {
     CPPUNIT_TEST_SUITE(OsMsgQTest);
     CPPUNIT_TEST(testMessageQueue);
+    CPPUNIT_TEST(testLockFreeMessageQueue);
+    CPPUNIT_TEST(testLockFreeUrgentAndTimeout);
+    CPPUNIT_TEST(testThroughput);
     CPPUNIT_TEST_SUITE_END();
 
 public:
 
     void testMessageQueue()
+    {
+        checkMessageQueue(OsMsgQ::Q_PRIORITY);
+    }
+
+    void testLockFreeMessageQueue()
+    {
+        checkMessageQueue(OsMsgQ::Q_PRIORITY | OsMsgQ::Q_LOCK_FREE);
+    }
+
+    void testLockFreeUrgentAndTimeout()
+    {
+        OsMsgQ msgQ(3, OsMsgQ::DEF_MAX_MSG_LEN,
+                    OsMsgQ::Q_PRIORITY | OsMsgQ::Q_LOCK_FREE);
+        OsMsg* pRecvMsg;
+
+        // Receiving from an empty queue times out.
+        CPPUNIT_ASSERT_EQUAL(OS_WAIT_TIMEOUT,
+                             msgQ.receive(pRecvMsg, OsTime::NO_WAIT_TIME));
+        CPPUNIT_ASSERT_EQUAL(OS_WAIT_TIMEOUT,
+                             msgQ.receive(pRecvMsg, OsTime(0, 20000)));
+
+        // Urgent messages are received before normal ones.
+        CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, msgQ.send(OsMsg(OsMsg::UNSPECIFIED, 1)));
+        CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, msgQ.send(OsMsg(OsMsg::UNSPECIFIED, 2)));
+        CPPUNIT_ASSERT_EQUAL(OS_SUCCESS,
+                             msgQ.sendUrgent(OsMsg(OsMsg::UNSPECIFIED, 3)));
+
+        // Sending to a full queue times out.
+        CPPUNIT_ASSERT_EQUAL(3, msgQ.numMsgs());
+        CPPUNIT_ASSERT_EQUAL(OS_WAIT_TIMEOUT,
+                             msgQ.send(OsMsg(OsMsg::UNSPECIFIED, 4),
+                                       OsTime(0, 20000)));
+
+        int expected[] = {3, 1, 2};
+        for (int i = 0; i < 3; i++)
+        {
+            CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, msgQ.receive(pRecvMsg));
+            CPPUNIT_ASSERT_EQUAL(expected[i], (int) pRecvMsg->getMsgSubType());
+            pRecvMsg->releaseMsg();
+        }
+        CPPUNIT_ASSERT(msgQ.isEmpty());
+    }
+
+    // Measure how many messages per second one receiver can take from
+    // 1, 4 and 16 concurrent senders, with and without Q_LOCK_FREE.
+    void testThroughput()
+    {
+        int producers[] = {1, 4, 16};
+        for (int i = 0; i < 3; i++)
+        {
+            double locked = measureThroughput(OsMsgQ::Q_PRIORITY, producers[i]);
+            double lockFree = measureThroughput(OsMsgQ::Q_PRIORITY |
+                                                OsMsgQ::Q_LOCK_FREE,
+                                                producers[i]);
+            printf("      %2d producers: locked %9.0f msgs/sec,"
+                   " lock-free %9.0f msgs/sec\n",
+                   producers[i], locked, lockFree);
+        }
+    }
+
+    double measureThroughput(int options, int numProducers)
+    {
+        OsMsgQ msgQ(THROUGHPUT_QUEUE_LEN, OsMsgQ::DEF_MAX_MSG_LEN, options);
+        MsgQProducer** producers = new MsgQProducer*[numProducers];
+        int perProducer = THROUGHPUT_MSGS / numProducers;
+        int i;
+
+        OsTime start;
+        OsDateTime::getCurTime(start);
+        for (i = 0; i < numProducers; i++)
+        {
+            producers[i] = new MsgQProducer(&msgQ, perProducer);
+            producers[i]->start();
+        }
+
+        OsMsg* pRecvMsg;
+        int received;
+        for (received = 0; received < perProducer * numProducers; received++)
+        {
+            if (msgQ.receive(pRecvMsg, OsTime(10, 0)) != OS_SUCCESS)
+            {
+                break;
+            }
+            pRecvMsg->releaseMsg();
+        }
+
+        OsTime end;
+        OsDateTime::getCurTime(end);
+        CPPUNIT_ASSERT_EQUAL(perProducer * numProducers, received);
+
+        for (i = 0; i < numProducers; i++)
+        {
+            delete producers[i];
+        }
+        delete[] producers;
+
+        return received / (end - start).getDouble();
+    }
+
+    void checkMessageQueue(int options)
     {
         OsMsgQ* pMsgQ1;
         OsMsg* pMsg1;
@@ -41,7 +185,7 @@ public:
         OsMsg* pRecvMsg;
         
         pMsgQ1 = new OsMsgQ(OsMsgQ::DEF_MAX_MSGS, OsMsgQ::DEF_MAX_MSG_LEN,
-                       OsMsgQ::Q_PRIORITY, "MQ1");
+                       options, "MQ1");
 
         pMsg1  = new OsMsg(OsMsg::UNSPECIFIED, 0);
         pMsg2  = new OsMsg(OsMsg::UNSPECIFIED, 0);
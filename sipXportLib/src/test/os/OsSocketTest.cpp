@@ -27,6 +27,7 @@ class SocketsTest : public SIPX_UNIT_BASE_CLASS
     CPPUNIT_TEST_SUITE(SocketsTest);
     CPPUNIT_TEST(testSocketUtils);
     CPPUNIT_TEST(testWriteMsg);
+    CPPUNIT_TEST(testReadBatch);
     CPPUNIT_TEST(testWriteAndAcceptMsg);
     CPPUNIT_TEST(testMulticast);
     CPPUNIT_TEST_SUITE_END();
@@ -80,6 +81,53 @@ public:
         delete s;
     }
 
+    /**
+     * Send datagrams to sockets sharing a port, and read them in batches.
+     */
+    void testReadBatch()
+    {
+        int port = 8022;
+        OsDatagramSocket receiver(0, NULL, port, mLocalHost, TRUE);
+        CPPUNIT_ASSERT(receiver.isOk());
+        OsDatagramSocket sharing(0, NULL, port, mLocalHost, TRUE);
+        CPPUNIT_ASSERT(sharing.isOk());
+        OsDatagramSocket sender(port, mLocalHost);
+        CPPUNIT_ASSERT(sender.isOk());
+
+        // The datagrams from one source all go to one of the sockets
+        char msg[20];
+        for (int i = 0; i < 5; i++)
+        {
+            sprintf(msg, "datagram %d", i);
+            CPPUNIT_ASSERT_EQUAL((int) strlen(msg),
+                                 sender.write(msg, (int) strlen(msg)));
+        }
+        CPPUNIT_ASSERT(receiver.isReadyToRead(1000) || sharing.isReadyToRead(1000));
+        OsDatagramSocket* reader = receiver.isReadyToRead(0) ? &receiver : &sharing;
+
+        // Slots smaller than the datagrams, to show they are separate
+        char buffers[4 * 8];
+        int lengths[4];
+        UtlString addresses[4];
+        int ports[4];
+        CPPUNIT_ASSERT_EQUAL(4, reader->readBatch(buffers, 8, 4, lengths,
+                                                  addresses, ports));
+        for (int i = 0; i < 4; i++)
+        {
+            CPPUNIT_ASSERT(strncmp(buffers + i * 8, "datagram", 8) == 0);
+            ASSERT_STR_EQUAL(mLocalHost.data(), addresses[i].data());
+            CPPUNIT_ASSERT_EQUAL(sender.getLocalHostPort(), ports[i]);
+        }
+
+        // Then the rest, and nothing more without waiting
+        CPPUNIT_ASSERT_EQUAL(1, reader->readBatch(buffers, sizeof(buffers), 1,
+                                                  lengths, NULL, NULL));
+        CPPUNIT_ASSERT_EQUAL(10, lengths[0]);
+        CPPUNIT_ASSERT(strncmp(buffers, "datagram 4", 10) == 0);
+        CPPUNIT_ASSERT_EQUAL(0, reader->readBatch(buffers, sizeof(buffers), 1,
+                                                  lengths, NULL, NULL));
+    }
+
     /**
      * Start a client and server and send 2 messages over TCP thru them
      */
@@ -0,0 +1,148 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+// SYSTEM INCLUDES
+#include <stdio.h>
+
+// APPLICATION INCLUDES
+#include "sipxportlib-buildstamp.h"
+#include "os/OsSysLog.h"
+#include "os/OsTask.h"
+#include "os/OsDateTime.h"
+#include "os/OsFileSystem.h"
+
+// DEFINES
+// MACROS
+// EXTERNAL FUNCTIONS
+// EXTERNAL VARIABLES
+// CONSTANTS
+#define EVENTS_PER_THREAD 20000
+#define MAX_THREADS 8
+#define DEFAULT_LOG_FILE "OsSysLogPerformance.log"
+
+// STRUCTS
+// TYPEDEFS
+// FORWARD DECLARATIONS
+
+// Adds EVENTS_PER_THREAD log events like the ones of a SIP stack at debug
+class doLogThread : public OsTask
+{
+public:
+   int run(void* taskArg)
+      {
+         char callId[40];
+         sprintf(callId, "%08x-%04x@192.168.0.%d", getUserData() * 7919, getUserData(), getUserData());
+
+         OsDateTime::getCurTime(mStart);
+         for (int event = 0; event < EVENTS_PER_THREAD; event++)
+         {
+            OsSysLog::add(FAC_SIP, PRI_DEBUG,
+                          "SipUserAgent::send %s message to %s:%d Call-ID: %s CSeq: %d (%p)",
+                          (event & 1) ? "ACK" : "INVITE", "192.168.0.10", 5060,
+                          callId, event, this);
+         }
+         OsDateTime::getCurTime(mEnd);
+         return 0;
+      }
+
+   UtlBoolean waitUntilShutDown()
+      {
+         this->OsTask::waitUntilShutDown();
+         return TRUE;
+      }
+
+   OsTime mStart;
+   OsTime mEnd;
+};
+
+static double toSeconds(const OsTime& time)
+{
+   return time.seconds() + time.usecs() / 1000000.0;
+}
+
+// Log from 1, 2, 4 ... MAX_THREADS threads with the given options
+static void runLogging(const char* name, int options,
+                       OsSysLogPriority priority, const char* logFile)
+{
+   for (int numThreads = 1; numThreads <= MAX_THREADS; numThreads *= 2)
+   {
+      doLogThread* threads[MAX_THREADS];
+      int n;
+
+      OsSysLog::initialize(0, "OsSysLogPerformance", options);
+      OsSysLog::setOutputFile(0, logFile);
+      OsSysLog::setLoggingPriority(priority);
+      unsigned long droppedBefore = OsSysLog::getDroppedRecords();
+
+      for (n = 0; n < numThreads; n++)
+      {
+         threads[n] = new doLogThread;
+         threads[n]->setUserData(n);
+      }
+      for (n = 0; n < numThreads; n++)
+      {
+         threads[n]->start();
+      }
+      for (n = 0; n < numThreads; n++)
+      {
+         threads[n]->waitUntilShutDown();
+      }
+
+      // Time spent in add() by each thread, and by all of them at once.
+      // waitUntilShutDown() polls, so use the times seen by the threads.
+      OsTime start = threads[0]->mStart;
+      OsTime end = threads[0]->mEnd;
+      double addSeconds = 0;
+      for (n = 0; n < numThreads; n++)
+      {
+         if (threads[n]->mStart < start)
+         {
+            start = threads[n]->mStart;
+         }
+         if (threads[n]->mEnd > end)
+         {
+            end = threads[n]->mEnd;
+         }
+         addSeconds += toSeconds(threads[n]->mEnd - threads[n]->mStart);
+         delete threads[n];
+      }
+
+      OsSysLog::flush();
+      unsigned long dropped = OsSysLog::getDroppedRecords() - droppedBefore;
+      OsSysLog::shutdown();
+
+      int events = numThreads * EVENTS_PER_THREAD;
+      double seconds = toSeconds(end - start);
+      printf("   %-10s %7d   %10.0f   %10.0f   %9lu\n",
+             name, numThreads,
+             addSeconds * 1000000000.0 / events,
+             seconds > 0 ? events / seconds : 0.0,
+             dropped);
+   }
+}
+
+int main(int argc, char* argv[])
+{
+   const char* logFile = (argc > 1) ? argv[1] : DEFAULT_LOG_FILE;
+
+   printf("OsSysLog Performance v=%s %s:\n"
+          "%d events per thread written to %s\n"
+          "   mode       threads   ns per add     adds/sec     dropped\n",
+          SipXportlibVersion, SipXportlibBuildStamp,
+          EVENTS_PER_THREAD, logFile);
+
+   runLogging("filtered", OsSysLog::OPT_NONE, PRI_ERR, logFile);
+   runLogging("formatted", OsSysLog::OPT_NONE, PRI_DEBUG, logFile);
+   runLogging("recorded", OsSysLog::OPT_RECORD_BUFFERS, PRI_DEBUG, logFile);
+
+   if (argc <= 1)
+   {
+      OsFileSystem::remove(DEFAULT_LOG_FILE);
+   }
+
+   return 0;
+}
@@ -0,0 +1,252 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <wchar.h>
+
+#include <os/OsSysLog.h>
+#include <os/OsSysLogRecordBuffer.h>
+#include <os/OsBSem.h>
+#include <utl/UtlString.h>
+#include <sipxunittests.h>
+
+#define TEST_LOG_ENTRIES 64
+
+static OsBSem sCallbackEntered(OsBSem::Q_PRIORITY, OsBSem::EMPTY);
+static OsBSem sCallbackRelease(OsBSem::Q_PRIORITY, OsBSem::EMPTY);
+static UtlBoolean sCallbackBlocks = FALSE;
+
+// Holds up the syslog task at the first entry, until released
+static void blockingCallback(const char* szPriority,
+                             const char* szSource,
+                             const char* szMsg)
+{
+   if (sCallbackBlocks)
+   {
+      sCallbackBlocks = FALSE;
+      sCallbackEntered.release();
+      sCallbackRelease.acquire();
+   }
+}
+
+/**
+ * Unittest for OsSysLog and its record buffers
+ */
+class OsSysLogTest : public SIPX_UNIT_BASE_CLASS
+{
+    CPPUNIT_TEST_SUITE(OsSysLogTest);
+    CPPUNIT_TEST(testFormattedEntries);
+    CPPUNIT_TEST(testRecordFallback);
+#ifdef OSSYSLOG_RECORD_BUFFERS
+    CPPUNIT_TEST(testDroppedRecords);
+#endif
+    CPPUNIT_TEST_SUITE_END();
+
+public:
+
+    void startLog(int options)
+    {
+        OsSysLog::shutdown();
+        CPPUNIT_ASSERT_EQUAL(OS_SUCCESS,
+                             OsSysLog::initialize(TEST_LOG_ENTRIES, "OsSysLogTest", options));
+        OsSysLog::setLoggingPriority(PRI_DEBUG);
+    }
+
+    // Find the content and task name of the latest entry starting with prefix
+    UtlBoolean findEntry(const char* prefix, UtlString& content, UtlString& taskName)
+    {
+        char* entries[TEST_LOG_ENTRIES];
+        int numEntries = 0;
+        UtlBoolean found = FALSE;
+
+        CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, OsSysLog::flush());
+        OsSysLog::getLogEntries(TEST_LOG_ENTRIES, entries, numEntries);
+        for (int i = 0; i < numEntries; i++)
+        {
+            UtlString date, count, facility, priority, host, name, id, process, data;
+            OsSysLog::parseLogString(entries[i], date, count, facility, priority,
+                                     host, name, id, process, data);
+            if (!found && data.index(prefix) == 0)
+            {
+                content = data;
+                taskName = name;
+                found = TRUE;
+            }
+            free(entries[i]);
+        }
+
+        return found;
+    }
+
+    // Log events using all kinds of conversions, and check what is logged
+    void logConversions(const char* prefix)
+    {
+        const char* nullString = NULL;
+        int pointed = 0;
+        char expected[1024];
+        UtlString content;
+        UtlString taskName;
+
+        OsSysLog::add(FAC_LOG, PRI_DEBUG,
+                      "%s1 %d %i %u %x %X %o %c 100%%",
+                      prefix, -42, 42, 4000000000U, 0xbeef, 0xBEEF, 8, 'z');
+        snprintf(expected, sizeof(expected),
+                 "%s1 %d %i %u %x %X %o %c 100%%",
+                 prefix, -42, 42, 4000000000U, 0xbeef, 0xBEEF, 8, 'z');
+        CPPUNIT_ASSERT(findEntry(UtlString(prefix) + "1 ", content, taskName));
+        ASSERT_STR_EQUAL(expected, content.data());
+
+        OsSysLog::add(FAC_LOG, PRI_DEBUG,
+                      "%s2 %hhu %hd %ld %lu %lld %llu %zu %jd",
+                      prefix, 300, 70000, -1234567890L, 3234567890UL,
+                      -1234567890123LL, 12345678901234ULL, (size_t) 77,
+                      (intmax_t) -5);
+        snprintf(expected, sizeof(expected),
+                 "%s2 %hhu %hd %ld %lu %lld %llu %zu %jd",
+                 prefix, 300, 70000, -1234567890L, 3234567890UL,
+                 -1234567890123LL, 12345678901234ULL, (size_t) 77,
+                 (intmax_t) -5);
+        CPPUNIT_ASSERT(findEntry(UtlString(prefix) + "2 ", content, taskName));
+        ASSERT_STR_EQUAL(expected, content.data());
+
+        OsSysLog::add(FAC_LOG, PRI_DEBUG,
+                      "%s3 %5.2f|%e|%g|%-8.3f|%+d|%08x|%#o",
+                      prefix, 3.14159, 1.5e-10, 0.0001, -2.5, 7, 0xabc, 8);
+        snprintf(expected, sizeof(expected),
+                 "%s3 %5.2f|%e|%g|%-8.3f|%+d|%08x|%#o",
+                 prefix, 3.14159, 1.5e-10, 0.0001, -2.5, 7, 0xabc, 8);
+        CPPUNIT_ASSERT(findEntry(UtlString(prefix) + "3 ", content, taskName));
+        ASSERT_STR_EQUAL(expected, content.data());
+
+        OsSysLog::add(FAC_LOG, PRI_DEBUG,
+                      "%s4 %-10s|%10s|%.3s|%*d|%-*.*s|%s|%p",
+                      prefix, "left", "right", "truncated", 6, 42, 8, 2, "xyz",
+                      nullString, &pointed);
+        snprintf(expected, sizeof(expected),
+                 "%s4 %-10s|%10s|%.3s|%*d|%-*.*s|%s|%p",
+                 prefix, "left", "right", "truncated", 6, 42, 8, 2, "xyz",
+                 "(null)", &pointed);
+        CPPUNIT_ASSERT(findEntry(UtlString(prefix) + "4 ", content, taskName));
+        ASSERT_STR_EQUAL(expected, content.data());
+
+        // Quotes and line ends are escaped in the entry
+        OsSysLog::add(FAC_LOG, PRI_DEBUG, "%s5 say \"%s\"\r\n%s",
+                      prefix, "hello", "next line");
+        CPPUNIT_ASSERT(findEntry(UtlString(prefix) + "5 ", content, taskName));
+        ASSERT_STR_EQUAL((UtlString(prefix) + "5 say \"hello\"\r\nnext line").data(),
+                         content.data());
+
+        // The task name is passed on
+        OsSysLog::add("OsSysLogTestTask", 1234, FAC_LOG, PRI_DEBUG, "%s6", prefix);
+        CPPUNIT_ASSERT(findEntry(UtlString(prefix) + "6", content, taskName));
+        ASSERT_STR_EQUAL("OsSysLogTestTask", taskName.data());
+    }
+
+    void testFormattedEntries()
+    {
+        UtlString content;
+        UtlString formattedTask;
+        UtlString recordedTask;
+
+        startLog(OsSysLog::OPT_NONE);
+        logConversions("formatted");
+        OsSysLog::add(FAC_LOG, PRI_DEBUG, "formatted task");
+        CPPUNIT_ASSERT(findEntry("formatted task", content, formattedTask));
+
+        startLog(OsSysLog::OPT_RECORD_BUFFERS);
+        logConversions("recorded");
+        OsSysLog::add(FAC_LOG, PRI_DEBUG, "recorded task");
+        CPPUNIT_ASSERT(findEntry("recorded task", content, recordedTask));
+
+        // Both find the same task for the calling thread
+        ASSERT_STR_EQUAL(formattedTask.data(), recordedTask.data());
+
+        // Filtered events are not recorded
+        OsSysLog::setLoggingPriority(PRI_ERR);
+        CPPUNIT_ASSERT(!OsSysLog::willLog(FAC_LOG, PRI_DEBUG));
+        CPPUNIT_ASSERT(OsSysLog::willLog(FAC_LOG, PRI_ERR));
+        CPPUNIT_ASSERT(!OsSysLog::willLog((OsSysLogFacility) -1, PRI_EMERG));
+        OsSysLog::add(FAC_LOG, PRI_DEBUG, "recorded filtered");
+        CPPUNIT_ASSERT(!findEntry("recorded filtered", content, recordedTask));
+
+        OsSysLog::shutdown();
+    }
+
+    void testRecordFallback()
+    {
+        UtlString content;
+        UtlString taskName;
+
+        startLog(OsSysLog::OPT_RECORD_BUFFERS);
+
+        // Wide strings are not recorded, they are formatted right away
+        OsSysLog::add(FAC_LOG, PRI_DEBUG, "fallback wide %ls", L"string");
+        CPPUNIT_ASSERT(findEntry("fallback wide", content, taskName));
+        ASSERT_STR_EQUAL("fallback wide string", content.data());
+
+        // Neither are events too large for the buffers
+        UtlString large;
+        for (int i = 0; i < OSSYSLOG_RECORD_BUFFER_SIZE / 16; i++)
+        {
+            large.append("0123456789abcdef");
+        }
+        OsSysLog::add(FAC_LOG, PRI_DEBUG, "fallback large %s", large.data());
+        CPPUNIT_ASSERT(findEntry("fallback large", content, taskName));
+        CPPUNIT_ASSERT_EQUAL(strlen("fallback large ") + large.length(),
+                             (size_t) content.length());
+
+        OsSysLog::shutdown();
+    }
+
+    void testDroppedRecords()
+    {
+        UtlString content;
+        UtlString taskName;
+        UtlString filler;
+        for (int i = 0; i < 100; i++)
+        {
+            filler.append("..........");
+        }
+
+        startLog(OsSysLog::OPT_RECORD_BUFFERS);
+        unsigned long droppedBefore = OsSysLog::getDroppedRecords();
+
+        // Hold up the syslog task in the callback of the first entry
+        sCallbackBlocks = TRUE;
+        OsSysLog::setCallbackFunction(blockingCallback);
+        OsSysLog::add(FAC_LOG, PRI_DEBUG, "dropped first");
+        CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, sCallbackEntered.acquire(OsTime(10, 0)));
+
+        // Fill the buffer of this thread, adding never waits
+        int added = 0;
+        for (; added < 4 * OSSYSLOG_RECORD_BUFFER_SIZE / 1000; added++)
+        {
+            OsSysLog::add(FAC_LOG, PRI_DEBUG, "dropped filler %d %s",
+                          added, filler.data());
+        }
+        unsigned long dropped = OsSysLog::getDroppedRecords() - droppedBefore;
+        CPPUNIT_ASSERT(dropped > 0);
+        CPPUNIT_ASSERT(dropped < (unsigned long) added);
+
+        // Once the buffers are emptied, the syslog task tells what was lost
+        sCallbackRelease.release();
+        char expected[100];
+        snprintf(expected, sizeof(expected),
+                 "OsSysLog dropped %lu records because record buffers were full",
+                 dropped);
+        CPPUNIT_ASSERT(findEntry("OsSysLog dropped", content, taskName));
+        ASSERT_STR_EQUAL(expected, content.data());
+        ASSERT_STR_EQUAL("syslog", taskName.data());
+
+        OsSysLog::setCallbackFunction(NULL);
+        OsSysLog::shutdown();
+    }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(OsSysLogTest);
@@ -11,16 +11,62 @@
 // $$
 ///////////////////////////////////////////////////////////////////////////////
 
+#include <stdio.h>
+#include <stdlib.h>
+
 #include <sipxunittests.h>
+#include <os/OsCallback.h>
+#include <os/OsDateTime.h>
+#include <os/OsTimer.h>
 #include <os/OsTimerTask.h>
 
+// Number of timers armed and cancelled by testArmCancelPerformance.
+#define ARM_CANCEL_TIMERS 100000
+// Number of timers fired by testFiringJitter.
+#define JITTER_TIMERS 2000
+// Range over which testFiringJitter spreads the firing times, in msec.
+#define JITTER_SPREAD_MSEC 1000
+
+// Record of one timer fired by testFiringJitter.
+struct JitterEntry
+{
+    OsTime expected;  ///< Time the timer was due to fire.
+    OsTime fired;     ///< Time the timer actually fired.
+    UtlBoolean wasFired;
+};
+
 class OsTimerTaskTest : public SIPX_UNIT_BASE_CLASS
 {
     CPPUNIT_TEST_SUITE(OsTimerTaskTest);
     CPPUNIT_TEST(testTimerTask);
+    CPPUNIT_TEST(testArmCancelPerformance);
+    CPPUNIT_TEST(testFiringJitter);
     CPPUNIT_TEST_SUITE_END();
 
 public:
+    static void nullCallback(const intptr_t userData, const intptr_t eventData)
+    {
+    }
+
+    static void jitterCallback(const intptr_t userData, const intptr_t eventData)
+    {
+        JitterEntry* entry = (JitterEntry*) userData;
+        OsDateTime::getCurTime(entry->fired);
+        entry->wasFired = TRUE;
+    }
+
+    static long long toUsecs(const OsTime& t)
+    {
+        return (long long) t.seconds() * OsTime::USECS_PER_SEC + t.usecs();
+    }
+
+    // Wait until the timer task has processed all previously sent requests.
+    void waitForTimerTask(OsTimer& timer)
+    {
+        timer.oneshotAfter(OsTime(3600, 0));
+        timer.stop(TRUE);
+    }
+
     void testTimerTask()
     {
         OsTimerTask* pTimerTask;
@@ -38,6 +84,111 @@ public:
 
         pTimerTask->destroyTimerTask();
     }
+
+    // Arm a large number of timers far in the future, then cancel them,
+    // and report the cost of each operation as seen by the timer task.
+    void testArmCancelPerformance()
+    {
+        OsCallback notifier((intptr_t) this, nullCallback);
+        OsTimer syncTimer(notifier);
+        OsTimer** timers = new OsTimer*[ARM_CANCEL_TIMERS];
+        int i;
+
+        for (i = 0; i < ARM_CANCEL_TIMERS; i++)
+        {
+            timers[i] = new OsTimer(notifier);
+        }
+        waitForTimerTask(syncTimer);
+
+        // Spread the firing times so the queue is not trivially ordered.
+        OsTime start;
+        OsDateTime::getCurTime(start);
+        for (i = 0; i < ARM_CANCEL_TIMERS; i++)
+        {
+            CPPUNIT_ASSERT(timers[i]->oneshotAfter(
+                              OsTime(3600 + (rand() % 3600), rand() % 1000000))
+                           == OS_SUCCESS);
+        }
+        waitForTimerTask(syncTimer);
+        OsTime armed;
+        OsDateTime::getCurTime(armed);
+
+        // Cancel in a different order than the timers were armed.
+        for (i = 0; i < ARM_CANCEL_TIMERS; i++)
+        {
+            int j = (i * 7919) % ARM_CANCEL_TIMERS;
+            CPPUNIT_ASSERT(timers[j]->stop(FALSE) == OS_SUCCESS);
+        }
+        waitForTimerTask(syncTimer);
+        OsTime cancelled;
+        OsDateTime::getCurTime(cancelled);
+
+        OsTime armTime = armed - start;
+        OsTime cancelTime = cancelled - armed;
+        printf("      %d timers: arm %lld ns/op, cancel %lld ns/op\n",
+               ARM_CANCEL_TIMERS,
+               (long long) toUsecs(armTime) * 1000 / ARM_CANCEL_TIMERS,
+               (long long) toUsecs(cancelTime) * 1000 / ARM_CANCEL_TIMERS);
+
+        for (i = 0; i < ARM_CANCEL_TIMERS; i++)
+        {
+            delete timers[i];
+        }
+        delete[] timers;
+    }
+
+    // Fire timers spread over a short interval and report how late
+    // they fired relative to their scheduled times.
+    void testFiringJitter()
+    {
+        JitterEntry* entries = new JitterEntry[JITTER_TIMERS];
+        OsCallback** notifiers = new OsCallback*[JITTER_TIMERS];
+        OsTimer** timers = new OsTimer*[JITTER_TIMERS];
+        int i;
+
+        for (i = 0; i < JITTER_TIMERS; i++)
+        {
+            OsTime offset(0, (rand() % JITTER_SPREAD_MSEC) * OsTime::USECS_PER_MSEC);
+            entries[i].wasFired = FALSE;
+            notifiers[i] = new OsCallback((intptr_t) &entries[i], jitterCallback);
+            timers[i] = new OsTimer(*notifiers[i]);
+
+            OsTime now;
+            OsDateTime::getCurTime(now);
+            entries[i].expected = now + offset;
+            timers[i]->oneshotAfter(offset);
+        }
+
+        OsTask::delay(JITTER_SPREAD_MSEC + 500);
+
+        int fired = 0;
+        long long sumUsecs = 0;
+        long long maxUsecs = 0;
+        for (i = 0; i < JITTER_TIMERS; i++)
+        {
+            if (entries[i].wasFired)
+            {
+                long long late =
+                   toUsecs(entries[i].fired - entries[i].expected);
+                fired++;
+                sumUsecs += late;
+                if (late > maxUsecs)
+                {
+                    maxUsecs = late;
+                }
+            }
+            delete timers[i];
+            delete notifiers[i];
+        }
+        printf("      %d timers: %d fired, mean lateness %lld us, max %lld us\n",
+               JITTER_TIMERS, fired,
+               fired > 0 ? sumUsecs / fired : 0LL, maxUsecs);
+        CPPUNIT_ASSERT_EQUAL(JITTER_TIMERS, fired);
+
+        delete[] timers;
+        delete[] notifiers;
+        delete[] entries;
+    }
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(OsTimerTaskTest);
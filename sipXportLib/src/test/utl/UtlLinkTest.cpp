@@ -13,6 +13,8 @@
 
 #include "utl/UtlLink.h"
 #include "utl/UtlInt.h"
+#include "utl/UtlSList.h"
+#include "os/OsTask.h"
 #include <sipxunittests.h>
 
 /// Unit test of the UtlLink and UtlLinkPool classes.
@@ -20,6 +22,48 @@
 static UtlInt data1(1);
 static UtlInt data2(2);
 static UtlInt data3(3);
+
+/// Task which takes some links from the pool and returns them.
+class UtlLinkTestTask : public OsTask
+{
+public:
+   UtlLinkTestTask(int numLinks)
+      : mNumLinks(numLinks)
+      , mLinksBefore(0)
+      , mLinksAllocated(0)
+   {
+   }
+
+   ~UtlLinkTestTask()
+   {
+      waitUntilShutDown();
+   }
+
+   UtlBoolean waitUntilShutDown()
+   {
+      return OsTask::waitUntilShutDown();
+   }
+
+   int run(void* pArg)
+   {
+      size_t pairs;
+      UtlLink::threadAllocated(mLinksBefore, pairs);
+
+      UtlSList list;
+      for (int i = 0; i < mNumLinks; i++)
+      {
+         list.append(&data1);
+      }
+      list.removeAll();
+
+      UtlLink::threadAllocated(mLinksAllocated, pairs);
+      return 0;
+   }
+
+   int mNumLinks;
+   size_t mLinksBefore;     ///< links the thread had taken before its loop
+   size_t mLinksAllocated;  ///< links the thread had taken after its loop
+};
    
 
 /// Unit test of the UtlLink, UtlLinkPool, and UtlChain classes.
@@ -40,6 +84,9 @@ class UtlLinkTest :
    CPPUNIT_TEST(testLinkAfter);
    CPPUNIT_TEST(testListAfter);
    CPPUNIT_TEST(testLinkReuse); 
+#ifdef __pingtel_on_posix__
+   CPPUNIT_TEST(testThreadCaches);
+#endif
    CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -409,7 +456,53 @@ public:
             CPPUNIT_ASSERT_MESSAGE(msg, peakPoolSize == totalAllocated());
          }
       }
-   
+
+
+   void testThreadCaches()
+      {
+         size_t startLinks;
+         size_t startPairs;
+         size_t links;
+         size_t pairs;
+         UtlLink::threadAllocated(startLinks, startPairs);
+
+         // Links are counted for the thread which takes them
+         UtlChain start;
+         for (int i = 0; i < 10; i++)
+         {
+            UtlLink::after(&start, &data1);
+         }
+         UtlLink::threadAllocated(links, pairs);
+         CPPUNIT_ASSERT_EQUAL(startLinks + 10, links);
+         CPPUNIT_ASSERT_EQUAL(startPairs, pairs);
+         while (!start.isUnLinked())
+         {
+            start.head()->unlink();
+         }
+
+         // The links taken by another thread are counted for it alone.
+         // (Starting and deleting the task takes links on this thread for
+         // the OsTask bookkeeping, so compare with the task's own counts.)
+         UtlLinkTestTask* task = new UtlLinkTestTask(300);
+         task->start();
+         task->waitUntilShutDown();
+         CPPUNIT_ASSERT_EQUAL((size_t) 300,
+                              task->mLinksAllocated - task->mLinksBefore);
+         delete task;
+
+         // The links cached by each thread go back to the pool when it
+         // exits, so many short lived threads do not need more blocks.
+         size_t startingPoolSize = totalAllocated();
+         for (int i = 0; i < 100; i++)
+         {
+            task = new UtlLinkTestTask(300);
+            task->start();
+            task->waitUntilShutDown();
+            CPPUNIT_ASSERT(task->mLinksAllocated >= 300);
+            delete task;
+         }
+         CPPUNIT_ASSERT(totalAllocated() <= startingPoolSize + UTLLINK_BLOCK_SIZE);
+      }
 
 };
 
@@ -19,6 +19,7 @@
 #include "utl/UtlSListIterator.h"
 #include "os/OsTask.h"
 #include "os/OsTimeLog.h"
+#include "os/OsDateTime.h"
 
 // DEFINES
 // MACROS
@@ -30,6 +31,9 @@ int externalForSideEffects;
 // comparison base values
 #include "UtlPerformanceStrings.h"
 #define NUM_THREADS 5
+// the scaling run does SCALING_PASSES in each of 1, 2, 4 ... MAX_SCALING_THREADS threads
+#define MAX_SCALING_THREADS 16
+#define SCALING_PASSES 5
 
 // STRUCTS
 // TYPEDEFS
@@ -67,12 +71,96 @@ public:
       }
 };
 
+class doScalingThread : public OsTask
+{
+public:
+   int run(void* taskArg)
+      {
+         OsDateTime::getCurTime(mStart);
+         for (int pass = 0; pass < SCALING_PASSES; pass++)
+         {
+            doListOperations();
+         }
+         OsDateTime::getCurTime(mEnd);
+         UtlLink::threadAllocated(mLinks, mPairs);
+         return 0;
+      }
+
+   UtlBoolean waitUntilShutDown()
+      {
+         this->OsTask::waitUntilShutDown();
+         return TRUE;
+      }
+
+   OsTime mStart;
+   OsTime mEnd;
+   size_t mLinks; ///< UtlLinks this thread got from the pool
+   size_t mPairs; ///< UtlPairs this thread got from the pool
+};
+
+// Run the same operations in more and more threads at once
+void runScaling()
+{
+   osPrintf("UtlSlist scaling (%d passes per thread):\n"
+            "   threads   seconds   passes/sec   links/thread\n",
+            SCALING_PASSES);
+
+   for (int numThreads = 1; numThreads <= MAX_SCALING_THREADS; numThreads *= 2)
+   {
+      doScalingThread* threads[MAX_SCALING_THREADS];
+      int n;
+
+      for (n = 0; n < numThreads; n++)
+      {
+         threads[n] = new doScalingThread;
+      }
+
+      for (n = 0; n < numThreads; n++)
+      {
+         threads[n]->start();
+      }
+      for (n = 0; n < numThreads; n++)
+      {
+         threads[n]->waitUntilShutDown();
+      }
+
+      // waitUntilShutDown() polls, so time from the first start to the last
+      // end as seen by the threads
+      OsTime start = threads[0]->mStart;
+      OsTime end = threads[0]->mEnd;
+      size_t allocated = 0;
+      for (n = 0; n < numThreads; n++)
+      {
+         if (threads[n]->mStart < start)
+         {
+            start = threads[n]->mStart;
+         }
+         if (threads[n]->mEnd > end)
+         {
+            end = threads[n]->mEnd;
+         }
+         allocated += threads[n]->mLinks;
+         delete threads[n];
+      }
+
+      OsTime lapse = end - start;
+      double seconds = lapse.seconds() + lapse.usecs() / 1000000.0;
+      osPrintf("   %7d   %7.3f   %10.1f   %12lu\n",
+               numThreads, seconds,
+               seconds > 0 ? numThreads * SCALING_PASSES / seconds : 0.0,
+               (unsigned long)(allocated / numThreads));
+   }
+}
+
 int main()
 {
    doTestThread* threads[NUM_THREADS];
    int n;
 
    UtlSList dummy;
+
+   // the results are printed with osPrintf
+   enableConsoleOutput(TRUE);
    
    for (n = 0; n < NUM_THREADS; n++)
    {
@@ -99,6 +187,8 @@ int main()
             );
    timer.dumpLog();
 
+   runScaling();
+
    return 0;
 }
 
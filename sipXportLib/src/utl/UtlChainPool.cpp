@@ -32,12 +32,34 @@ UtlChainPool::UtlChainPool( allocator* blockAllocator, size_t blockSize ) :
       mAllocations(0),
       mAllocator(blockAllocator)
 {
-
+#ifdef UTLCHAINPOOL_THREAD_CACHE
+   pthread_key_create(&mCacheKey, destroyThreadCache);
+#endif
 }
 
 UtlChain* UtlChainPool::get()
 {
    UtlChain* newChain;
+
+#ifdef UTLCHAINPOOL_THREAD_CACHE
+   ThreadCache* cache = threadCache();
+   if (cache)
+   {
+      if (cache->mFree.isUnLinked())
+      {
+         refill(cache);
+      }
+
+      // pull the first UtlChain off the cache
+      newChain = cache->mFree.listHead();
+      newChain->detachFromList(&cache->mFree);
+      cache->mFreeCount--;
+      cache->mGets++;
+
+      return newChain;
+   }
+#endif
+
    {  // critical section for member variables
       OsLock poolLock(mLock);
 
@@ -60,18 +82,61 @@ UtlChain* UtlChainPool::get()
 
 void UtlChainPool::release( UtlChain* freeChain )
 {
+#ifdef UTLCHAINPOOL_THREAD_CACHE
+   ThreadCache* cache = threadCache();
+   if (cache)
+   {
+      // put this freed object on the tail of the cache, as for the pool
+      freeChain->listBefore(&cache->mFree, NULL);
+      cache->mFreeCount++;
+
+      if (cache->mFreeCount >= 2 * UTLCHAINPOOL_CACHE_BATCH)
+      {
+         drain(cache, UTLCHAINPOOL_CACHE_BATCH);
+      }
+      return;
+   }
+#endif
+
    OsLock poolLock(mLock);
 
    // put this freed object on the tail of the pool list
    freeChain->listBefore(&mPool, NULL);
 }
 
+size_t UtlChainPool::threadAllocated()
+{
+#ifdef UTLCHAINPOOL_THREAD_CACHE
+   ThreadCache* cache = threadCache();
+   return cache ? cache->mGets : 0;
+#else
+   return 0;
+#endif
+}
+
 /* //////////////////////////// PRIVATE /////////////////////////////////// */
 
 UtlChainPool::~UtlChainPool()
 {
+#ifdef UTLCHAINPOOL_THREAD_CACHE
+   // Once the key is deleted, the threads still running no longer return
+   // their caches when they exit, so delete the caches here.  The instances
+   // in them are all in mBlocks.  A pool is destroyed only when nothing uses
+   // it any more, so no thread is in the middle of returning its cache.
+   pthread_key_delete(mCacheKey);
+#endif
+
    OsLock poolLock(mLock);
 
+#ifdef UTLCHAINPOOL_THREAD_CACHE
+   while (!mCaches.isUnLinked())
+   {
+      ThreadCache* cache =
+         static_cast<ThreadCache*>(mCaches.listHead()->detachFromList(&mCaches));
+      delete cache;
+   }
+#endif
+
    UtlChain* block;
    while (!mBlocks.isUnLinked()) // blocks still on block list
    {
@@ -80,4 +145,80 @@ UtlChainPool::~UtlChainPool()
    }
 }
 
+#ifdef UTLCHAINPOOL_THREAD_CACHE
+
+UtlChainPool::ThreadCache* UtlChainPool::threadCache()
+{
+   ThreadCache* cache = static_cast<ThreadCache*>(pthread_getspecific(mCacheKey));
+   if (!cache)
+   {
+      cache = new ThreadCache;
+      cache->mpPool = this;
+      cache->mFreeCount = 0;
+      cache->mGets = 0;
+      if (pthread_setspecific(mCacheKey, cache) != 0)
+      {
+         // use the pool directly
+         delete cache;
+         cache = NULL;
+      }
+      else
+      {
+         OsLock poolLock(mLock);
+         cache->listBefore(&mCaches, NULL);
+      }
+   }
+   return cache;
+}
+
+void UtlChainPool::refill(ThreadCache* cache)
+{
+   OsLock poolLock(mLock);
+
+   for (size_t i = 0; i < UTLCHAINPOOL_CACHE_BATCH; i++)
+   {
+      if (mPool.isUnLinked()) // are there available objects in the pool?
+      {
+         // no - get the subclass to allocate some more
+         mAllocator(mBlockSize, &mBlocks, &mPool);
+         mAllocations++;
+      }
+
+      // move the first UtlChain of the mPool to the tail of the cache
+      UtlChain* freeChain = mPool.listHead();
+      freeChain->detachFromList(&mPool);
+      freeChain->listBefore(&cache->mFree, NULL);
+      cache->mFreeCount++;
+   }
+}
+
+void UtlChainPool::drain(ThreadCache* cache, size_t keep)
+{
+   OsLock poolLock(mLock);
+
+   // the cache and the pool are both in first in, first out order, so
+   // the oldest ones in the cache go to the tail of the pool
+   for (; cache->mFreeCount > keep; cache->mFreeCount--)
+   {
+      UtlChain* freeChain = cache->mFree.listHead();
+      freeChain->detachFromList(&cache->mFree);
+      freeChain->listBefore(&mPool, NULL);
+   }
+}
+
+void UtlChainPool::destroyThreadCache(void* cache)
+{
+   ThreadCache* threadCache = static_cast<ThreadCache*>(cache);
+   UtlChainPool* pool = threadCache->mpPool;
+
+   pool->drain(threadCache, 0);
+   {
+      OsLock poolLock(pool->mLock);
+      threadCache->detachFromList(&pool->mCaches);
+   }
+   delete threadCache;
+}
+
+#endif
+
 /* ============================ FUNCTIONS ================================= */
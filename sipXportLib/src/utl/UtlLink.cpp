@@ -228,6 +228,12 @@ size_t UtlLink::totalAllocated()
    return spLinkPool->totalAllocated();
 }
 
+void UtlLink::threadAllocated(size_t& links, size_t& pairs)
+{
+   links = spLinkPool->threadAllocated();
+   pairs = UtlPair::spPairPool->threadAllocated();
+}
+
 /* //////////////////////////// PRIVATE /////////////////////////////////// */
 
 void UtlLink::allocate(size_t    blocksize, ///< number of instances to allocate
@@ -68,7 +68,9 @@ LOCAL_SRC_FILES := \
   src/net/HttpBody.cpp \
   src/net/HttpConnection.cpp \
   src/net/HttpConnectionMap.cpp \
+  src/net/HttpHeaderIndex.cpp \
   src/net/HttpMessage.cpp \
+  src/net/HttpMessageReader.cpp \
   src/net/HttpRequestContext.cpp \
   src/net/HttpServer.cpp \
   src/net/HttpService.cpp \
@@ -82,6 +84,7 @@ LOCAL_SRC_FILES := \
   src/net/SdpBody.cpp \
   src/net/SdpHelper.cpp \
   src/net/SipClient.cpp \
+  src/net/SipClientReactor.cpp \
   src/net/SipContactDb.cpp \
   src/net/SipDialog.cpp \
   src/net/SipDialogEvent.cpp \
@@ -95,6 +98,7 @@ LOCAL_SRC_FILES := \
   src/net/SipMessage.cpp \
   src/net/SipMessageEvent.cpp \
   src/net/SipMessageList.cpp \
+  src/net/SipMessageView.cpp \
   src/net/SipNonceDb.cpp \
   src/net/SipNotifyStateTask.cpp \
   src/net/SipObserverCriteria.cpp \
@@ -198,11 +202,13 @@ LOCAL_SRC_FILES := \
     src/test/net/NetBase64CodecTest.cpp \
     src/test/net/NetMd5CodecTest.cpp \
     src/test/net/SdpBodyTest.cpp \
+    src/test/net/SipClientReactorTest.cpp \
     src/test/net/SipContactDbTest.cpp \
     src/test/net/SipDialogEventTest.cpp \
     src/test/net/SipDialogMonitorTest.cpp \
     src/test/net/SipDialogTest.cpp \
     src/test/net/SipMessageTest.cpp \
+    src/test/net/SipMessageViewTest.cpp \
     src/test/net/SipPresenceEventTest.cpp \
     src/test/net/SipProxyMessageTest.cpp \
     src/test/net/SipPublishContentMgrTest.cpp \
@@ -297,11 +303,13 @@ LOCAL_SRC_FILES := \
     src/test/net/NetBase64CodecTest.cpp \
     src/test/net/NetMd5CodecTest.cpp \
     src/test/net/SdpBodyTest.cpp \
+    src/test/net/SipClientReactorTest.cpp \
     src/test/net/SipContactDbTest.cpp \
     src/test/net/SipDialogEventTest.cpp \
     src/test/net/SipDialogMonitorTest.cpp \
     src/test/net/SipDialogTest.cpp \
     src/test/net/SipMessageTest.cpp \
+    src/test/net/SipMessageViewTest.cpp \
     src/test/net/SipPresenceEventTest.cpp \
     src/test/net/SipProxyMessageTest.cpp \
     src/test/net/SipPublishContentMgrTest.cpp \
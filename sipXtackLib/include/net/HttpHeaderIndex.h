@@ -0,0 +1,111 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _HttpHeaderIndex_h_
+#define _HttpHeaderIndex_h_
+
+// SYSTEM INCLUDES
+
+// APPLICATION INCLUDES
+#include <os/OsDefs.h>
+#include <utl/UtlDList.h>
+#include <utl/UtlHashMap.h>
+
+// DEFINES
+// MACROS
+// EXTERNAL FUNCTIONS
+// EXTERNAL VARIABLES
+// CONSTANTS
+// STRUCTS
+// TYPEDEFS
+// FORWARD DECLARATIONS
+class NameValuePair;
+
+//:Index of the header fields of an HttpMessage by header name
+// The header fields stay in the UtlDList of NameValuePairs of the message;
+// the index only refers to them, grouped by name in message order.
+// The most used HTTP and SIP headers have fixed slots which are found
+// without hashing or allocating.  All other names are hashed, upper case,
+// to slots which are allocated as they are found.
+//
+// Names are matched case insensitively and exactly as
+// HttpMessage::getHeaderValue() does: compact and long forms of a SIP
+// header are different names.
+//
+// The index must be invalidated whenever a field is added to or removed
+// from the list, or a field name is changed.
+class HttpHeaderIndex
+{
+/* //////////////////////////// PUBLIC //////////////////////////////////// */
+public:
+
+/* ============================ CREATORS ================================== */
+
+   HttpHeaderIndex();
+     //:Default constructor, the index is invalid
+
+   virtual
+   ~HttpHeaderIndex();
+     //:Destructor
+
+/* ============================ MANIPULATORS ============================== */
+
+   void build(const UtlDList& headerFields);
+     //:Index the NameValuePair header fields of the list
+
+   void invalidate();
+     //:Mark the index out of date
+     // The memory of the index is kept for the next build().
+
+/* ============================ ACCESSORS ================================= */
+
+   NameValuePair* getField(const char* name, int index) const;
+     //:Get the index'th field with the given name
+     //!returns: NULL if there are not so many fields with the name
+
+   int getFieldCount(const char* name) const;
+     //:Number of fields with the given name
+
+/* ============================ INQUIRY =================================== */
+
+   UtlBoolean isValid() const;
+     //:Is the index up to date with the header list it was built from?
+
+/* //////////////////////////// PROTECTED ///////////////////////////////// */
+protected:
+
+   static int getKnownSlot(const char* name);
+     //:Fixed slot of a known header name, or -1
+
+   int getSlot(const char* name) const;
+     //:Slot of any header name, or -1 if there is no field with the name
+
+/* //////////////////////////// PRIVATE /////////////////////////////////// */
+private:
+
+   UtlBoolean mValid;
+   UtlHashMap mOtherSlots;      // UtlString upper case name -> UtlInt slot
+   int mNumSlots;               // Known slots plus the other names found
+   int* mpSlotStart;            // Slot -> first field in mpFields
+   int* mpSlotCount;            // Slot -> number of fields
+   int mSlotCapacity;
+   NameValuePair** mpFields;    // Fields grouped by slot, in message order
+   int* mpFieldSlots;           // Slot of every field in message order
+   int mFieldCapacity;
+
+   HttpHeaderIndex(const HttpHeaderIndex& rHttpHeaderIndex);
+     //:disable Copy constructor
+
+   HttpHeaderIndex& operator=(const HttpHeaderIndex& rhs);
+     //:disable Assignment operator
+
+};
+
+/* ============================ INLINE METHODS ============================ */
+
+#endif  // _HttpHeaderIndex_h_
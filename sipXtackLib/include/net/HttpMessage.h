@@ -22,6 +22,7 @@
 #include <os/OsDefs.h>
 
 #include <net/HttpBody.h>
+#include <net/HttpHeaderIndex.h>
 #include <net/NameValuePair.h>
 #include <os/OsSocket.h>
 #include <os/OsTimeLog.h>
@@ -40,6 +41,10 @@
 
 #define HTTP_LONG_INT_CHARS 20
 
+// Number of lookups of header fields by name after the fields were changed
+// which builds the index of the fields (see HttpHeaderIndex).
+#define HTTP_HEADER_INDEX_MIN_LOOKUPS 2
+
 #define HTTP_PROTOCOL_VERSION     "HTTP/1.0"
 #define HTTP_PROTOCOL_VERSION_1_1 "HTTP/1.1"
 
@@ -77,6 +82,7 @@
 #define HTTP_CONTENT_TRANSFER_ENCODING_FIELD "CONTENT-TRANSFER-ENCODING"
 #define HTTP_CONTENT_LENGTH_FIELD "CONTENT-LENGTH"
 #define HTTP_CONTENT_TYPE_FIELD "CONTENT-TYPE"
+#define HTTP_TRANSFER_ENCODING_FIELD "TRANSFER-ENCODING"
 #define HTTP_CONTENT_ID_FIELD "CONTENT-ID"
 #define HTTP_LOCATION_FIELD "LOCATION"
 #define HTTP_PROXY_AUTHENTICATE_FIELD "PROXY-AUTHENTICATE"
@@ -88,6 +94,9 @@
 #define HTTP_ACCEPT_FIELD "ACCEPT"
 #define HTTP_CONNECTION_FIELD "CONNECTION"
 
+// Transfer codings
+#define HTTP_TRANSFER_ENCODING_CHUNKED "chunked"
+
 // Authentication Constants
 //    these are by specification case-independant tokens,
 //    but we always send the case as used in the examples in
@@ -192,6 +201,7 @@ class HttpMessage
 {
 /* //////////////////////////// PUBLIC //////////////////////////////////// */
 public:
+    friend class HttpMessageReader;
 
     enum HttpEndpointEnum
     {
@@ -701,6 +711,17 @@ public:
 
 /* ============================ INQUIRY =================================== */
 
+     //! Check whether a buffer read from a stream begins with a complete message
+     /*! Used to frame messages read incrementally from TCP or TLS.
+      *  \param numberBytesChecked - set to the length of the first line and
+      *         headers (including the blank line), or -1 if the end of the
+      *         headers is not in the buffer yet.
+      *  \param contentLength - set to the value of the Content-Length (or "l")
+      *         header, 0 if there is none, or -1 if the end of the headers is
+      *         not in the buffer yet.
+      *  \return TRUE if the buffer holds at least
+      *          numberBytesChecked + contentLength bytes.
+      */
      static UtlBoolean isWholeMessage(const char* messageBuffer,
                               int bufferLength,
                               int& numberBytesChecked,
@@ -714,6 +735,12 @@ protected:
    UtlString mFirstHeaderLine;
    UtlBoolean mHeaderCacheClean;
 
+   //! Invalidate the index of mNameValues
+   /*! Must be called whenever a field is added to or removed from
+    *  mNameValues, or the name of a field is changed.
+    */
+   void invalidateHeaderIndex();
+
 /* //////////////////////////// PRIVATE /////////////////////////////////// */
 private:
 
@@ -727,6 +754,8 @@ private:
    int mSendPort;
    OsMsgQ* mpResponseListenerQueue;
    void* mResponseListenerData;
+   HttpHeaderIndex mHeaderIndex;
+   int mUnindexedHeaderLookups; // Lookups by name since mNameValues changed
 #ifdef HTTP_TIMELOG
    OsTimeLog mTimeLog;
 #endif
@@ -0,0 +1,172 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _HttpMessageReader_h_
+#define _HttpMessageReader_h_
+
+// SYSTEM INCLUDES
+
+// APPLICATION INCLUDES
+#include <os/OsDefs.h>
+#include <os/OsSocket.h>
+#include <net/HttpMessage.h>
+
+// DEFINES
+#define HTTP_MESSAGE_READER_TIMEOUT_MSECS 30000    // Wait for more bytes
+#define HTTP_MESSAGE_READER_MAX_HEADER_SIZE (1024 * 64)
+#define HTTP_MESSAGE_READER_MAX_CONTENT_LENGTH 6000000
+#define HTTP_MESSAGE_READER_MAX_CHUNK_LINE 1024    // Chunk size and extensions
+
+// MACROS
+// EXTERNAL FUNCTIONS
+// EXTERNAL VARIABLES
+// CONSTANTS
+// STRUCTS
+// TYPEDEFS
+// FORWARD DECLARATIONS
+
+//:Reads HTTP messages from a stream socket through a buffer
+// The reader keeps one buffer for the life of the connection.  Each read
+// from the socket takes as many bytes as are available, up to the free
+// space in the buffer, and the headers and the body of a message are
+// parsed right out of it.  Bytes read past the end of a message stay in
+// the buffer and are the start of the next message, so pipelined
+// requests are not lost.
+//
+// The end of the body is found from the Content-Length header, from
+// chunked transfer coding (RFC 7230), or, for a response with neither, by
+// the other side closing the connection.  Chunked bodies are decoded in
+// place in the buffer.  A message read with read() gets a Content-Length
+// header instead of its Transfer-Encoding header.
+//
+// A reader is meant for TCP and TLS sockets.  It must not be used at the
+// same time as another reader or HttpMessage::read() on the same socket.
+class HttpMessageReader
+{
+/* //////////////////////////// PUBLIC //////////////////////////////////// */
+public:
+
+/* ============================ CREATORS ================================== */
+
+   HttpMessageReader(OsSocket* pSocket,
+                     int maxContentLength = HTTP_MESSAGE_READER_MAX_CONTENT_LENGTH,
+                     int readSize = HTTP_DEFAULT_SOCKET_BUFFER_SIZE);
+     //:Constructor
+     //!param: pSocket - the socket to read, not owned by the reader
+     //!param: maxContentLength - the largest body accepted.  The socket
+     //        is closed if a message announces or sends more.
+     //!param: readSize - the least free space in the buffer for a read
+
+   virtual
+   ~HttpMessageReader();
+     //:Destructor
+
+/* ============================ MANIPULATORS ============================== */
+
+   int read(HttpMessage& message,
+            long waitMilliseconds = HTTP_MESSAGE_READER_TIMEOUT_MSECS);
+     //:Read the next whole message, body included
+     //!param: waitMilliseconds - how long to wait for each part of the
+     //        message to arrive
+     //!returns: the number of bytes the message took on the socket, or 0
+     //          if the socket was closed, failed or timed out, or the
+     //          message was malformed or too big.
+
+   int readHeaders(HttpMessage& message,
+                   long waitMilliseconds = HTTP_MESSAGE_READER_TIMEOUT_MSECS);
+     //:Read the first line and headers of the next message
+     // The body is left for readBody().
+     //!returns: the length of the first line and headers, or 0 as read().
+
+   int readBody(HttpMessage& message,
+                GetDataCallbackProc callbackProc,
+                void* pOptionalData,
+                long waitMilliseconds = HTTP_MESSAGE_READER_TIMEOUT_MSECS);
+     //:Pass the body of the message read by readHeaders() to a callback
+     // The (decoded) body is passed as it arrives, in pieces, straight
+     // from the buffer.  The callback is then called with a NULL pointer
+     // and a length of -1 to signal the end, as by HttpMessage::get().
+     // If the callback returns FALSE, the rest of the body is not read and
+     // the socket is closed.
+     //!returns: the number of body bytes passed to the callback.
+
+/* ============================ ACCESSORS ================================= */
+
+   int getBufferedLength() const;
+     //:Number of bytes read from the socket but not consumed yet
+
+/* ============================ INQUIRY =================================== */
+
+   UtlBoolean isReadyToRead(long waitMilliseconds);
+     //:Is there the start of a message in the buffer or on the socket?
+
+/* //////////////////////////// PROTECTED ///////////////////////////////// */
+protected:
+
+/* //////////////////////////// PRIVATE /////////////////////////////////// */
+private:
+
+   enum BodyFraming
+   {
+      BODY_NONE,          // No message read, or its body is consumed
+      BODY_LENGTH,        // mBodyRemaining more bytes
+      BODY_CHUNKED,       // Chunked transfer coding
+      BODY_UNTIL_CLOSE    // Up to the end of the connection
+   };
+
+   OsSocket* mpSocket;
+   char* mpBuffer;
+   int mCapacity;
+   int mInitialCapacity;   // Capacity to return to between messages
+   int mStart;             // First byte not consumed yet
+   int mEnd;               // End of the bytes read
+   int mMaxContentLength;
+   int mReadSize;
+   BodyFraming mBodyFraming;
+   int mBodyRemaining;     // Bytes of the body (or chunk) still to come
+
+   UtlBoolean reserve(int length);
+     //:Make room for length bytes from mStart on
+     // The bytes from mStart on are kept, but may be moved.
+
+   int fill(long waitMilliseconds);
+     //:Read what is available from the socket into the buffer
+     // The bytes from mStart on are kept, but may be moved.
+     //!returns: the number of bytes read, 0 or -1 if none were.
+
+   int findLineEnd(int offset, long waitMilliseconds);
+     //:Offset (from mStart) after the end of the line starting at offset
+     // Reads more when the line is not all in the buffer.
+     //!returns: -1 if there is no line end within
+     //          HTTP_MESSAGE_READER_MAX_CHUNK_LINE bytes or the socket
+     //          was closed first.
+
+   int readChunkSize(int& offset, long waitMilliseconds);
+     //:Parse the chunk size line at offset and move offset past it
+     //!returns: the chunk size, or -1 if it is malformed or too big
+
+   UtlBoolean isEmptyLine(int offset, int lineEnd) const;
+     //:Is the line from offset to lineEnd only a line end?
+
+   UtlBoolean skipTrailer(int& offset, long waitMilliseconds);
+     //:Move offset past the trailer fields and the blank line after them
+
+   void fail(const char* reason);
+     //:Log the reason, close the socket and forget the buffered bytes
+
+   HttpMessageReader(const HttpMessageReader& rHttpMessageReader);
+     //:disable Copy constructor
+
+   HttpMessageReader& operator=(const HttpMessageReader& rhs);
+     //:disable Assignment operator
+
+};
+
+/* ============================ INLINE METHODS ============================ */
+
+#endif  // _HttpMessageReader_h_
@@ -21,6 +21,7 @@
 #include <os/OsServerTask.h>
 #include <os/OsBSem.h>
 #include <net/SipMessage.h>
+#include <net/SipClientReactor.h>
 
 // DEFINES
 // MACROS
@@ -32,6 +33,8 @@
 // FORWARD DECLARATIONS
 class SipUserAgentBase;
 class OsEvent;
+class SipClientReactor;
+class SipClientReactorTask;
 
 //:Class short description which may consist of multiple lines (note the ':')
 // Class detailed description which may extend to multiple lines
@@ -81,6 +84,15 @@ public:
 
     void setSharedSocket(UtlBoolean bShared) ;
 
+#ifdef SIP_TCP_USE_REACTOR
+    UtlBoolean readAvailable();
+    //: Read the data that has arrived and dispatch complete messages
+    // Used instead of run() when the client is served by a
+    // SipClientReactor.  Does not block.
+    //!returns: FALSE if the connection was closed by the other side or
+    //          failed.
+#endif
+
 /* ============================ ACCESSORS ================================= */
 
     //void getHostIp(UtlString* hostAddress) const;
@@ -89,6 +101,16 @@ public:
     //int getHostPort() const;
     const UtlString& getLocalIp();
 
+    OsSocket::IpProtocolSocketType getSocketType() const { return(mSocketType); }
+    //: Transport protocol of the client's socket
+
+    void getBatchReadStats(long& wakeups, long& packets, int& maxPackets) const;
+    //: Counts of the datagrams read by run() with batched UDP reads
+    //!param: wakeups - times the socket became readable and was read
+    //!param: packets - SIP datagrams read (STUN and TURN not included)
+    //!param: maxPackets - most SIP datagrams read in a single wakeup
+    // All are 0 unless built with SIP_UDP_BATCH_READS.
+
     void markInUseForWrite();
     void markAvailbleForWrite();
 
@@ -101,6 +123,13 @@ public:
 
     int isInUseForWrite();
 
+    UtlBoolean isReadByCurrentTask();
+    //: Is the calling task the one reading this client's socket?
+    // A client must not be deleted by the task reading it.
+
+    UtlBoolean isServedByReactor() const { return(mpReactor != NULL); }
+    //: Is the socket read by a SipClientReactor instead of run()?
+
 /* //////////////////////////// PROTECTED ///////////////////////////////// */
 protected:
 
@@ -112,6 +141,20 @@ private:
     // Wait until the socket is ready to read (or has an error).
     UtlBoolean waitForReadyToRead();
 
+#ifdef SIP_UDP_BATCH_READS
+    // Read and dispatch UDP datagrams in batches, instead of the read loop
+    // of run().  Returns FALSE, without reading, if the batch buffers
+    // cannot be allocated.
+    UtlBoolean runBatchReads();
+#endif
+
+    // Log and dispatch a message read from the socket to the user agent.
+    void dispatchMessage(SipMessage* message,
+                         const char* messageBytes,
+                         int messageLength,
+                         const UtlString& fromIpAddress,
+                         int fromPort);
+
     OsSocket* clientSocket;
     OsSocket::IpProtocolSocketType mSocketType;
     SipUserAgentBase* sipUserAgent;
@@ -129,6 +172,20 @@ private:
     UtlSList* mWaitingList;  // Events waiting until this is available
     UtlBoolean mbSharedSocket; // Shared socket-- do not delete or close (UDP / rport)
 
+    // State of a client served by a SipClientReactor, owned by the reactor
+    friend class SipClientReactor;
+    friend class SipClientReactorTask;
+    SipClientReactor* mpReactor;  // Reactor reading the socket, or NULL
+    SipClientReactorTask* mpReactorTask; // I/O thread reading the socket
+    int64_t mReactorId;     // Key of this client in the I/O thread, 0 once removed
+    int mReactorBusy;       // Non-zero while readAvailable() is running
+    UtlString mReadBuffer;  // Bytes read but not yet framed into a message
+
+    // Batched UDP reads, updated by run() only
+    long mBatchWakeups;     // Times the socket was read until drained
+    long mBatchPackets;     // SIP datagrams read
+    int mBatchMaxPackets;   // Most SIP datagrams read in one wakeup
+
     SipClient(const SipClient& rSipClient);
      //:disable Copy constructor
 
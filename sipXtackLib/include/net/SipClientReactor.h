@@ -0,0 +1,113 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _SipClientReactor_h_
+#define _SipClientReactor_h_
+
+// SYSTEM INCLUDES
+
+// APPLICATION INCLUDES
+#include <os/OsDefs.h>
+#include <os/OsMutex.h>
+#include <os/OsTask.h>
+#include <utl/UtlHashMap.h>
+
+// DEFINES
+// Define SIP_TCP_USE_REACTOR (configure --enable-sip-reactor) to serve all
+// SIP TCP connections of a SipTcpServer from a small, fixed pool of epoll
+// threads instead of one SipClient thread per connection.  Linux only.
+#if defined(SIP_TCP_USE_REACTOR) && !defined(__linux__)
+#  undef SIP_TCP_USE_REACTOR
+#endif
+
+#define SIP_CLIENT_REACTOR_THREADS 2      // I/O threads per reactor
+#define SIP_CLIENT_REACTOR_EVENTS 64      // Events taken per epoll_wait()
+#define SIP_CLIENT_REACTOR_READ_QUOTA (64 * 1024) // Bytes read from one
+                                          // connection before serving others
+
+// MACROS
+// EXTERNAL FUNCTIONS
+// EXTERNAL VARIABLES
+// CONSTANTS
+// STRUCTS
+// TYPEDEFS
+// FORWARD DECLARATIONS
+class SipClient;
+class SipClientReactorTask;
+
+#ifdef SIP_TCP_USE_REACTOR // [
+
+//:Multiplexes the sockets of many SipClients over a few I/O threads
+// Each registered SipClient is assigned to one of the I/O threads, which
+// waits for its socket to become readable with epoll.  The thread then
+// calls SipClient::readAvailable() to read what has arrived without
+// blocking, frame complete SIP messages and dispatch them to the
+// SipUserAgent.  Connections which are closed by the other side or fail
+// are taken out of the reactor and their sockets closed, so that
+// SipProtocolServerBase::removeOldClients() deletes the SipClient.
+//
+// Sending is not affected: SipClient::send() still writes from the thread
+// of the caller.
+class SipClientReactor
+{
+/* //////////////////////////// PUBLIC //////////////////////////////////// */
+public:
+
+/* ============================ CREATORS ================================== */
+
+   SipClientReactor(const char* name,
+                    int numThreads = SIP_CLIENT_REACTOR_THREADS);
+     //:Constructor, starts the I/O threads
+
+   virtual
+   ~SipClientReactor();
+     //:Destructor, stops the I/O threads
+     // All clients must have been removed.
+
+/* ============================ MANIPULATORS ============================== */
+
+   UtlBoolean addClient(SipClient* client);
+     //:Start serving reads for the client's socket
+     //!returns: FALSE if the socket could not be added to an epoll set.
+
+   void removeClient(SipClient* client);
+     //:Stop serving reads for the client
+     // When this returns, no I/O thread is or will be using the client.
+     // Must not be called by the I/O thread while it reads this client;
+     // see SipClient::isReadByCurrentTask().
+
+/* ============================ ACCESSORS ================================= */
+
+   int getClientCount();
+     //:Number of clients currently served
+
+/* ============================ INQUIRY =================================== */
+
+/* //////////////////////////// PROTECTED ///////////////////////////////// */
+protected:
+
+/* //////////////////////////// PRIVATE /////////////////////////////////// */
+private:
+
+    int mNumThreads;
+    SipClientReactorTask** mpTasks;
+    int mNextTask;   // Task which gets the next client (round robin)
+
+    SipClientReactor(const SipClientReactor& rSipClientReactor);
+     //:disable Copy constructor
+
+    SipClientReactor& operator=(const SipClientReactor& rhs);
+     //:disable Assignment operator
+
+};
+
+#endif // SIP_TCP_USE_REACTOR ]
+
+/* ============================ INLINE METHODS ============================ */
+
+#endif  // _SipClientReactor_h_
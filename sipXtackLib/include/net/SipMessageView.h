@@ -0,0 +1,221 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+
+#ifndef _SipMessageView_h_
+#define _SipMessageView_h_
+
+// SYSTEM INCLUDES
+
+// APPLICATION INCLUDES
+#include <os/OsDefs.h>
+#include <utl/UtlString.h>
+
+// DEFINES
+#define SIP_MESSAGE_VIEW_INLINE_FIELDS 32
+
+// MACROS
+// EXTERNAL FUNCTIONS
+// EXTERNAL VARIABLES
+// CONSTANTS
+// STRUCTS
+// TYPEDEFS
+// FORWARD DECLARATIONS
+
+//:Read-only view of a SIP message in a receive buffer
+// parse() scans the first line and the header fields once and records
+// where the name and the value of every field are in the buffer.
+// Nothing is copied: the view refers to the buffer, which must stay
+// unchanged and allocated as long as the view is used.  The field spans
+// are kept in an array inside the view, so parsing a message with up to
+// SIP_MESSAGE_VIEW_INLINE_FIELDS header fields does not allocate at all,
+// and a view re-used for the next message keeps any larger array.
+//
+// Values are decoded only when asked for: comma separated sub-fields,
+// header parameters (e.g. the Via branch or the To tag) and the CSeq
+// are found by scanning the value span of the field at that time.
+//
+// Header names are matched case insensitively and the compact and long
+// forms of a SIP header are the same name, as they are for a SipMessage,
+// which replaces the compact names when it is constructed.  Values of
+// folded fields span the continuation lines; use getHeaderValue() with
+// a UtlString to get them unfolded.
+//
+// This is meant for the receive path, to look at the few fields needed
+// to dispatch a message (e.g. Call-ID, CSeq and the top Via branch)
+// without building a SipMessage, which copies and allocates every field.
+class SipMessageView
+{
+/* //////////////////////////// PUBLIC //////////////////////////////////// */
+public:
+
+   struct Span
+   {
+      const char* mpStart;
+      int mLength;
+
+      UtlBoolean isNull() const { return(mLength <= 0); }
+        //:Is the span empty?
+
+      UtlBoolean equals(const char* text) const;
+        //:Is the span the same as the text?  Case sensitive.
+
+      UtlBoolean equalsIgnoreCase(const char* text) const;
+        //:Is the span the same as the text?  Case insensitive.
+
+      void toString(UtlString& text) const;
+        //:Copy the span to a string
+   };
+     //:Part of the message buffer
+
+/* ============================ CREATORS ================================== */
+
+   SipMessageView();
+     //:Default constructor, the view is empty until parse() is called
+
+   SipMessageView(const char* messageBytes, int byteCount);
+     //:Construct a view and parse() the message
+
+   virtual
+   ~SipMessageView();
+     //:Destructor
+
+/* ============================ MANIPULATORS ============================== */
+
+   UtlBoolean parse(const char* messageBytes, int byteCount);
+     //:Scan the first line and the header fields of a message
+     // The message ends at byteCount or at the first null character.
+     //!returns: TRUE if there is a first line and the header ends with
+     //!         an empty line, so getHeaderLength() is valid
+
+/* ============================ ACCESSORS ================================= */
+
+   int getHeaderLength() const;
+     //:Bytes from the start of the message to the start of the body
+
+   int getContentLength() const;
+     //:Value of the Content-Length field, -1 if there is none
+
+   Span getBody() const;
+     //:Body of the message
+     // The body is Content-Length bytes long if there is a Content-Length
+     // field and the rest of the buffer otherwise.  It is truncated to
+     // the end of the buffer.
+
+   Span getFirstHeaderLinePart(int partIndex) const;
+     //:Space separated part of the first line
+     // Parts 0, 1 and 2 are the method, request URI and protocol of a
+     // request and the protocol, status code and the reason phrase of
+     // a response.  The reason phrase is the rest of the line.
+
+   int getResponseStatusCode() const;
+     //:Status code of a response, -1 for a request
+
+   int getFieldCount() const;
+     //:Number of header fields (not including continuation lines)
+
+   UtlBoolean getField(int fieldIndex, Span& name, Span& value) const;
+     //:Name and value of the fieldIndex'th header field in message order
+
+   int getFieldCount(const char* name) const;
+     //:Number of header fields with the given name
+
+   UtlBoolean getHeaderValue(int index, const char* name, Span& value) const;
+     //:Value of the index'th header field with the given name
+     // The leading white space of the value is skipped.
+
+   UtlBoolean getHeaderValue(int index, const char* name,
+                             UtlString& value) const;
+     //:Value of the index'th header field with the name, unfolded
+     // Line ends of continuation lines are removed, as HttpMessage does.
+
+   UtlBoolean getFieldSubfield(const char* name, int subfieldIndex,
+                               Span& subfield) const;
+     //:Get the subfieldIndex'th comma separated sub-field of a header
+     // Sub-fields are counted across all the fields with the name, like
+     // SipMessage::getFieldSubfield() does.  Commas in quoted strings and
+     // in <> are not separators.  White space around the sub-field is
+     // not part of it.
+
+   UtlBoolean getHeaderParameter(const char* name, int subfieldIndex,
+                                 const char* parameterName,
+                                 Span& parameterValue) const;
+     //:Get a header parameter of a sub-field
+     // Header parameters are the ';' separated parameters after the
+     // closing '>' of a name-addr, or after the first ';' when there is
+     // no <> (e.g. Via or an addr-spec).  A parameter without a value
+     // is found with an empty value.
+
+   UtlBoolean getCallIdField(Span& callId) const;
+     //:Value of the Call-ID field
+
+   UtlBoolean getCSeqField(int* sequenceNum, Span* sequenceMethod) const;
+     //:Sequence number and method of the CSeq field
+
+   UtlBoolean getTopViaBranch(Span& branch) const;
+     //:Branch parameter of the first Via
+
+   UtlBoolean getFromTag(Span& tag) const;
+     //:Tag parameter of the From field
+
+   UtlBoolean getToTag(Span& tag) const;
+     //:Tag parameter of the To field
+
+/* ============================ INQUIRY =================================== */
+
+   UtlBoolean isValid() const;
+     //:Did the last parse() find a complete header?
+
+   UtlBoolean isResponse() const;
+     //:Is the first line a status line?
+
+/* //////////////////////////// PROTECTED ///////////////////////////////// */
+protected:
+
+   struct FieldSpan
+   {
+      int mNameStart;
+      int mNameLength;
+      int mValueStart;
+      int mValueLength;
+      int mNameId;           // Known name, or -1
+   };
+
+   static int getKnownNameId(const char* name, int nameLength);
+     //:Known name id of a header name, or -1
+     // The compact and long form of a SIP header have the same id.
+
+   const FieldSpan* findField(int index, const char* name) const;
+     //:The index'th field with the given name, or NULL
+
+   void addField(const FieldSpan& field);
+     //:Append a field, growing the field array if it is full
+
+/* //////////////////////////// PRIVATE /////////////////////////////////// */
+private:
+
+   const char* mpMessage;
+   int mMessageLength;
+   int mFirstLineLength;
+   int mHeaderLength;
+   UtlBoolean mValid;
+   FieldSpan mInlineFields[SIP_MESSAGE_VIEW_INLINE_FIELDS];
+   FieldSpan* mpFields;         // mInlineFields or allocated when it is full
+   int mFieldCapacity;
+   int mNumFields;
+
+   SipMessageView(const SipMessageView& rSipMessageView);
+     //:disable Copy constructor
+
+   SipMessageView& operator=(const SipMessageView& rhs);
+     //:disable Assignment operator
+
+};
+
+/* ============================ INLINE METHODS ============================ */
+
+#endif  // _SipMessageView_h_
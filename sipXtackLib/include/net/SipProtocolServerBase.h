@@ -17,6 +17,7 @@
 
 // APPLICATION INCLUDES
 #include <net/SipClient.h>
+#include <net/SipClientReactor.h>
 #include <os/OsServerSocket.h>
 #include <os/OsTask.h>
 #include <os/OsServerTask.h>
@@ -88,6 +89,11 @@ protected:
 
     void releaseClient(SipClient* client);
 
+    UtlBoolean startClient(SipClient* client);
+    //: Start reading the client's socket
+    // TCP clients are handed to mpClientReactor if there is one, all
+    // others get their own thread.
+
     void startClients();
 
     void shutdownClients();
@@ -106,6 +112,7 @@ protected:
     UtlHashMap mServerPortMap;
     UtlHashMap mServers;
     SipServerBrokerListener* mpServerBrokerListener;
+    SipClientReactor* mpClientReactor; // Reads TCP clients if not NULL
     
 
 
@@ -45,6 +45,18 @@ class server_t;
 typedef struct s_res_response
     res_response;
 
+/// Function to which an asynchronous SipSrvLookup::servers() result is given.
+typedef void (*SipSrvLookupCallback)(server_t* servers,
+                                     ///< result of SipSrvLookup::servers()
+                                     void* userData
+                                     ///< userData given to serversAsync()
+   );
+/**<
+ * The callback owns the array of servers and must delete[] it.
+ * It is called on the thread of the lookup task, so it should only
+ * record the result or post a message to the task which asked for it.
+ */
+
 /**
  * A class (with no members) whose 'servers' method implements the RFC
  * 3263 process for determining a list of server entries for a SIP
@@ -111,6 +123,11 @@ public:
       OptionCodeCNAMELimit,     ///< Max. number of CNAMEs to follow.
       OptionCodeNoDefaultTCP,   /**< If 1, do not add TCP contacts by default,
                                  *   for better RFC 3263 conformance. */
+      OptionCodeIgnoreCache,    ///< If 1, do not use or fill the DNS cache.
+      OptionCodeCacheMaxTTL,    /**< Max. seconds to cache a DNS answer,
+                                 *   whatever its TTL. */
+      OptionCodeNegativeCacheTTL, /**< Seconds to cache a negative answer
+                                 *   which has no SOA record. */
       OptionCodeLast            ///< End of range
    };
    /**<
@@ -162,6 +179,55 @@ public:
 
    ///< Defaults are: timeout = 5, retries = 4.
 
+   /// Get the list of server entries without waiting for DNS.
+   static void serversAsync(const char *domain,
+                            ///< SIP domain name or host name
+                            const char *service,
+                            ///< "sip" or "sips"
+                            OsSocket::IpProtocolSocketType socketType,
+                            ///< types of transport
+                            int port,
+                            ///< port number from URI, or PORT_NONE
+                            const char* srcIp,
+                            ///< the outgoing interface ip to send the request on
+                            SipSrvLookupCallback callback,
+                            ///< function to give the result to
+                            void* userData
+                            ///< passed to callback
+      );
+   /**<
+    * Queues the lookup to the lookup task, which calls servers() and
+    * gives the result to the callback.  The lookup task is started by the
+    * first call.  If the same lookup is already queued or in progress,
+    * no other lookup is queued; every caller gets its own copy of the
+    * result of the single lookup.
+    */
+
+   /// Stop the lookup task of serversAsync(), if it has been started.
+   static void destroyLookupTask();
+   /**<
+    * Lookups which are already queued are finished first.
+    */
+
+   /// Remove all the DNS answers from the cache.
+   static void clearCache();
+
+   /// Function which does a DNS query, with the arguments of res_query().
+   typedef int (*ResQueryFunction)(const char* name, int rclass, int type,
+                                   unsigned char* answer, int answerSize);
+
+   /// Replace res_query() for the DNS queries of the lookups.
+   static void setResQueryFunction(ResQueryFunction function
+                                   ///< query function, or NULL for res_query()
+      );
+   /**<
+    * Allows the lookups to be tested against a local stand-in for DNS.
+    * Like res_query(), the function returns the length of the answer
+    * on success and -1 on failure.  If the failure is due to an answer
+    * from DNS (e.g. NXDOMAIN), that answer must be in the buffer,
+    * so the negative answer can be cached.
+    */
+
    /// Perform a DNS query and parse the results.  Follows CNAME records.
    static void res_query_and_parse(const char* in_name,
                                    ///< domain name to look up
@@ -191,6 +257,12 @@ public:
     * The caller is responsible for freeing out_name if it is non-NULL
     * and != in_name.  The caller is responsible for freeing out_response if it
     * is non-NULL and != in_response.
+    *
+    * Answers, including negative ones, are cached for their TTL (up to
+    * OptionCodeCacheMaxTTL seconds), so a lookup which has been done
+    * recently is answered without a DNS query.  If another thread is
+    * already doing the same query, its answer is awaited and used instead
+    * of doing the query again.
     */
 
 /* //////////////////////////// PROTECTED ///////////////////////////////// */
@@ -198,6 +270,11 @@ protected:
 
    /// Mutex to keep the routines thread-safe.
    static OsMutex sMutex;
+   /**<
+    * On Linux the resolver state is per thread and lookups on different
+    * threads run concurrently.  On the other platforms, the resolver is
+    * not reentrant and every servers() call holds sMutex.
+    */
 
    /// The array of option values.
    static int options[OptionCodeLast+1];
@@ -134,6 +134,14 @@ public:
                             SipMessage*& delayedDispatchedMessage,
                             SIPX_TRANSPORT_DATA* pTransport);
 
+    void handleDnsSrvLookup(server_t* servers,
+                            SipUserAgent& userAgent,
+                            SipTransactionList& transactionList,
+                            SipMessage*& delayedDispatchedMessage);
+    //: Creates and pursues the DNS SRV children once the lookup is done
+    //! param: servers - result of the lookup, owned by the transaction
+    //! param: delayedDispatchedMessage - set to the final response to dispatch when no child could be sent
+
     UtlBoolean handleIncoming(SipMessage& incomingMessage,
                              SipUserAgent& userAgent,
                              enum messageRelationship relationship,
@@ -179,6 +187,22 @@ public:
                           UtlBoolean isOutgoing,
                           UtlString& hash);
 
+    static UtlBoolean buildBranchKey(const SipMessage& message,
+                                     UtlBoolean isOutgoing,
+                                     UtlString& key);
+    //: Build the RFC 3261 transaction key of a message
+    // The key is the branch and the sent-by of the top Via and the
+    // method, as in RFC 3261 sections 17.1.3 and 17.2.3.  The sent-by
+    // is only part of server transaction keys; the branch of a client
+    // transaction was made by this stack and is unique.  ACK and CANCEL
+    // have the key of the INVITE as they are kept in its transaction.
+    //! returns: FALSE (and an empty key) if the top Via branch does not
+    //!          start with the RFC 3261 magic cookie
+
+    const UtlString& getBranchKey() const;
+    //: The RFC 3261 key of this transaction, empty if it has none
+    // See buildBranchKey()
+
     SipTransaction* getTopMostParent() const;
 
     void getCallId(UtlString& callId) const;
@@ -305,6 +329,11 @@ protected:
                               SIPX_TRANSPORT_DATA* pTransport);
     //: Starts search on any immediate DNS SRV children of the highest unpursued Q value
 
+    void createDnsSrvChildren(SipUserAgent& userAgent,
+                              SipTransactionList& transactionList,
+                              SIPX_TRANSPORT_DATA* pTransport);
+    //: Creates a child for each of the DNS SRV records
+
     UtlBoolean findBestResponse(SipMessage& bestResponse);
     // Finds the best final response to return the the server transaction
 
@@ -319,6 +348,13 @@ protected:
 
     void doMarkBusy(int markValue);
 
+    static void composeBranchKey(const UtlString& branch,
+                                 const UtlString& sentBy,
+                                 const UtlString& method,
+                                 UtlBoolean isServerTransaction,
+                                 UtlString& key);
+    //: Put the parts of a buildBranchKey() key together
+
 /* //////////////////////////// PRIVATE /////////////////////////////////// */
 private:
     SipTransaction(const SipTransaction& rSipTransaction);
@@ -351,6 +387,7 @@ private:
     // the parent UtlString
     UtlString mCallId;
     UtlString mBranchId;
+    UtlString mBranchKey;               ///< See buildBranchKey()
     UtlString mRequestUri;
     Url mFromField;
     Url mToField;
@@ -387,6 +424,7 @@ private:
     UtlBoolean mIsCanceled;
     UtlBoolean mIsRecursing;   ///< TRUE if any braches have not be pursued
     UtlBoolean mIsDnsSrvChild; ///< This CT pursues one of the SRV records of the parent CT
+    UtlBoolean mDnsSrvLookupPending; ///< Waiting for the DNS SRV records
     double mQvalue;            ///< Recurse order.  equal values are recursed in parallel
     int mExpires;              ///< Maximum time (seconds) to wait for a final outcome
     UtlBoolean mIsBusy;
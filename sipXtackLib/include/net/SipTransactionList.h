@@ -15,12 +15,12 @@
 // SYSTEM INCLUDES
 
 // APPLICATION INCLUDES
-#include <utl/UtlHashBag.h>
+#include <utl/UtlSList.h>
 
 #include <os/OsDefs.h>
-#include <os/OsMutex.h>
 
 // DEFINES
+#define SIP_TRANSACTION_LIST_SHARDS 16
 // MACROS
 // EXTERNAL FUNCTIONS
 // EXTERNAL VARIABLES
@@ -30,9 +30,23 @@
 // FORWARD DECLARATIONS
 
 class SipMessage;
-
-//:Class short description which may consist of multiple lines (note the ':')
-// Class detailed description which may extend to multiple lines
+class SipTransactionListEntry;
+class SipTransactionListShard;
+
+//:List of the SIP transactions of a user agent
+// Transactions are hashed by Call-ID and CSeq (see
+// SipTransaction::buildHash()).  Transactions with an RFC 3261 branch
+// are also indexed by SipTransaction::getBranchKey(), so that most
+// messages are matched by looking at one transaction instead of all
+// the transactions with the same Call-ID and CSeq.  Every transaction
+// is also on an expiry queue in the order it was last touched, so
+// removeOldTransactions() only looks at the expired ones.
+//
+// The transactions are kept in SIP_TRANSACTION_LIST_SHARDS shards by
+// Call-ID, each with its own lock, so messages of different calls are
+// matched and marked busy or available concurrently.  All the
+// transactions of a transaction tree have the same Call-ID, so they are
+// in one shard and the busy mark of the tree is kept under one lock.
 class SipTransactionList {
 /* //////////////////////////// PUBLIC //////////////////////////////////// */
 public:
@@ -63,8 +77,8 @@ public:
     UtlBoolean transactionExists(const SipTransaction* transaction,
                                 const UtlString& hash);
     //: Used to confirm a transaction is still good and has not been deleted
-    // Note: this should only be used inside of a lock to prevent any sort
-    // of delete race.
+    // Note: this is only certain inside of the lock of the shard of the
+    // transaction, it may be deleted right after it is looked for.
 
     UtlBoolean waitUntilAvailable(SipTransaction* transaction,
                                  const UtlString& hash);
@@ -77,8 +91,11 @@ public:
     //: Marks the transaction as available
 
     void removeOldTransactions(long oldTransaction,
-                               long oldTcpTransaction);
+                               long oldInviteTransaction);
     //: Remove transactions not accessed after given time
+    // Non-INVITE transactions not touched since oldTransaction and
+    // all transactions not touched since oldInviteTransaction are
+    // removed, unless they are busy.
 
     void stopTransactionTimers();
     void startTransactionTimers();
@@ -95,13 +112,47 @@ public:
 
 /* ============================ INQUIRY =================================== */
 
+    int getTransactionCount();
+    //: Number of transactions in the list
+
 /* //////////////////////////// PROTECTED ///////////////////////////////// */
 protected:
-    void lock();
-    //: Locks the list for iteration, reading or writing
+    SipTransactionListShard& getShard(const char* callId,
+                                      int callIdLength);
+    //: Shard of the transactions with the Call-ID
 
-    void unlock();
-    //: Unlock
+    SipTransactionListShard& getShardForHash(const UtlString& hash);
+    //: Shard of the transactions with a SipTransaction::buildHash() key
+
+    UtlBoolean transactionExists(SipTransactionListShard& shard,
+                                 const SipTransaction* transaction,
+                                 const UtlString& hash);
+    //: transactionExists() with the lock of the shard held
+
+    UtlBoolean waitUntilAvailable(SipTransactionListShard& shard,
+                                  SipTransaction* transaction,
+                                  const UtlString& hash);
+    //: waitUntilAvailable() in the shard of the transaction
+
+    static UtlBoolean isTransactionFor(SipTransaction* transaction,
+                                       const SipMessage& message,
+                                       UtlBoolean isOutgoing,
+                                       const SipTransaction* messageTransaction,
+                                       enum SipTransaction::messageRelationship& relationship);
+    //: Is the message part of the transaction?
+    // messageTransaction is the transaction the message knows it is
+    // part of, or NULL.  It is only compared, never dereferenced.
+
+    static void removeExpired(SipTransactionListShard& shard,
+                              UtlSList& expiryQueue,
+                              long oldestTime,
+                              SipTransaction**& transactionsToBeDeleted,
+                              int& deleteCount,
+                              int& busyCount);
+    //: Remove the transactions of an expiry queue not touched since oldestTime
+    // The lock of the shard must be held.  Transactions removed from the
+    // shard are added to transactionsToBeDeleted, which is allocated if
+    // it is NULL.
 
 /* //////////////////////////// PRIVATE /////////////////////////////////// */
     private:
@@ -111,8 +162,7 @@ protected:
     SipTransactionList& operator=(const SipTransactionList& rhs);
     //:Assignment operator
 
-    UtlHashBag mTransactions;
-    OsMutex mListMutex;
+    SipTransactionListShard* mpShards[SIP_TRANSACTION_LIST_SHARDS];
 
 };
 
@@ -19,6 +19,10 @@
 #include <os/OsRWMutex.h>
 
 // DEFINES
+#ifndef SIP_UDP_DEFAULT_RECEIVERS
+#  define SIP_UDP_DEFAULT_RECEIVERS 1   // Sockets and tasks reading each UDP port
+#endif
+
 // MACROS
 // EXTERNAL FUNCTIONS
 // EXTERNAL VARIABLES
@@ -48,6 +52,13 @@ class OsTimer;
  * OsMsgQueue).  The SipUdpServer never listens for responses, however, 
  * the SipUserAgent itself pays attention to rport results and notifies 
  * the OsNatAgentTask of local ip -> remote IP NAT bindings.
+ *
+ * With numReceivers greater than 1, each local address gets that many
+ * sockets bound to the same port with SO_REUSEPORT, each read by its own
+ * SipClient task, and the kernel spreads the incoming datagrams over them
+ * by source address.  Messages are sent from the first socket only, and
+ * only the first one does STUN, so do not combine this with enableStun().
+ * SO_REUSEPORT also lets other processes of the same user bind the port.
  */
 class SipUdpServer : public SipProtocolServerBase
 {
@@ -60,7 +71,8 @@ public:
        SipUserAgent* userAgent = NULL,
        int udpReadBufferSize = -1,
        UtlBoolean bUseNextAvailablePort = FALSE,
-       const char* szBoundIp = NULL);
+       const char* szBoundIp = NULL,
+       int numReceivers = SIP_UDP_DEFAULT_RECEIVERS);
      //:Default constructor
 
 
@@ -72,6 +84,8 @@ public:
 
     int run(void* pArg);
 
+    UtlBoolean startListener();
+
     void shutdownListener();
 
     void enableStun(const char* szStunServer, 
@@ -136,6 +150,11 @@ public:
 
     void printStatus();
 
+    void getReceiveStats(long& wakeups, long& packets, int& maxPackets);
+      //:Batched read counts of all the UDP receivers
+      // See SipClient::getBatchReadStats().  packets / wakeups is the
+      // average number of datagrams read per wakeup.
+
     int getServerPort(const char* szLocalIp = NULL) ;
 
     UtlBoolean getStunAddress(UtlString* pIpAddress,
@@ -173,6 +192,8 @@ private:
     int mStunPort ;
     UtlSList mSipKeepAliveBindings ;
     OsRWMutex mKeepAliveMutex ;
+    int mNumReceivers ;
+    UtlSList mReceivers ;  // UtlVoidPtr to the SipClients of the extra sockets
 
     OsStatus createServerSocket(const char* localIp,
                                  int& localPort,
@@ -18,6 +18,7 @@
 // APPLICATION INCLUDES
 #include <utl/UtlHashBag.h>
 #include <os/OsServerTask.h>
+#include <os/OsMutex.h>
 #include <net/SipUserAgentBase.h>
 #include <net/SipMessage.h>
 #include <net/SipMessageEvent.h>
@@ -170,7 +171,8 @@ public:
     {
         UNSPECIFIED = 0,
         SHUTDOWN_MESSAGE = 10,
-        KEEPALIVE_MESSAGE
+        KEEPALIVE_MESSAGE,
+        DNS_SRV_LOOKUP_MESSAGE
     };
 
 /* ============================ CREATORS ================================== */
@@ -699,6 +701,20 @@ protected:
                              int& port,
                              UtlString& srcIp);
 
+    /// Look up the servers for a transaction without blocking the user agent.
+    void lookupServersAsync(SipMessage* request,
+                            ///< copy of the transaction request, owned by the lookup
+                            const char* domain,
+                            const char* service,
+                            OsSocket::IpProtocolSocketType socketType,
+                            int port,
+                            const char* srcIp);
+    /**<
+     * The servers are found with SipSrvLookup::serversAsync() and posted
+     * back to the user agent, which gives them to the transaction of
+     * request with SipTransaction::handleDnsSrvLookup().
+     */
+
     int getReliableTransportTimeout();
 
     int getFirstResendTimeout();
@@ -795,6 +811,17 @@ private:
     void queueMessageToObservers(SipMessage* message,
                                  int messageType);
 
+    /// Dispatch the final response a transaction has given up with.
+    void dispatchDelayedMessage(const SipMessage& sipMessage,
+                                SipMessage* delayedDispatchMessage);
+
+    /// Posts the result of lookupServersAsync() to the user agent.
+    static void dnsSrvLookupDone(server_t* servers, void* userData);
+
+    //! lookups of lookupServersAsync() which have not called back yet
+    int mDnsSrvLookupsPending;
+    OsMutex mDnsSrvLookupMutex;
+
     //! timer that sends events to the queue periodically
     OsTimer* mpTimer;
 
@@ -506,6 +506,16 @@ public:
 
    /// Set the scheme to be used (also see setUrlType).
    void setScheme(Scheme scheme);
+
+   /// Enable or disable the scanner used before the regular expressions.
+   static void setFastParse(UtlBoolean enabled);
+   /**<
+    * Common sip: and sips: name-addr and addr-spec strings are parsed by a
+    * single pass scanner which gives the same result as the regular
+    * expressions; anything else is passed on to the regular expressions.
+    * The scanner is enabled by default; disabling it is meant for
+    * comparing the two in tests.
+    */
    
 
 /* //////////////////////////// PROTECTED ///////////////////////////////// */
@@ -520,6 +530,16 @@ private:
                                                     *   is valid. */
                     );
 
+   /// parse the common forms of sip: and sips: URLs without the regular expressions
+   UtlBoolean parseFast(const char* urlString, UtlBoolean isAddrSpec);
+   /**<
+    * Sets the components exactly as the regular expressions in parseString
+    * would.  Nothing is changed if the string is not in a form it knows,
+    * in which case it returns FALSE and parseString goes on.
+    */
+
+   static UtlBoolean sFastParse;
+
    Scheme    mScheme;
 
    UtlString mDisplayName;
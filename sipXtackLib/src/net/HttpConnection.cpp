@@ -26,6 +26,7 @@
 // APPLICATION INCLUDES
 #include <net/HttpMessage.h>
 #include <net/HttpConnection.h>
+#include <net/HttpMessageReader.h>
 #include <net/NameValuePair.h>
 // Needed for SIP_SHORT_CONTENT_LENGTH_FIELD.
 #include <net/SipMessage.h>
@@ -80,6 +81,8 @@ HttpConnection::~HttpConnection()
 int HttpConnection::run(void* runArg)
 {
     HttpMessage request;
+    // Keeps the start of a pipelined request read with the one before it
+    HttpMessageReader reader(mpRequestSocket);
     bool bConnected = true;
 
     if (!mpRequestSocket || !mpRequestSocket->isOk())
@@ -90,9 +93,9 @@ int HttpConnection::run(void* runArg)
     while(!isShuttingDown() && mpRequestSocket && mpRequestSocket->isOk() && bConnected)
     {
         // Read a http request from the socket
-        if (mpRequestSocket->isReadyToRead(HTTP_READ_TIMEOUT_MSECS))
+        if (reader.isReadyToRead(HTTP_READ_TIMEOUT_MSECS))
         {
-            int bytesRead = request.read(mpRequestSocket);
+            int bytesRead = reader.read(request);
          
             if (bytesRead > 0)
             {
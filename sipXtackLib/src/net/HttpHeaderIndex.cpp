@@ -0,0 +1,248 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+
+// SYSTEM INCLUDES
+#include <assert.h>
+#include <string.h>
+#include <ctype.h>
+
+// APPLICATION INCLUDES
+#include <net/HttpHeaderIndex.h>
+#include <net/NameValuePair.h>
+#include <net/SipMessage.h>
+#include <utl/UtlDListIterator.h>
+#include <utl/UtlInt.h>
+#include <utl/UtlString.h>
+
+// EXTERNAL FUNCTIONS
+// EXTERNAL VARIABLES
+// CONSTANTS
+
+// Header names with fixed slots: the ones looked up for nearly every
+// message by the SIP stack and the HTTP transports.  The length is kept
+// to reject most names without calling strcasecmp().
+#define KNOWN_HEADER(name) { name, sizeof(name) - 1 }
+static const struct
+{
+   const char* mName;
+   int mLength;
+} sKnownHeaders[] =
+{
+   KNOWN_HEADER(SIP_VIA_FIELD),
+   KNOWN_HEADER(SIP_SHORT_VIA_FIELD),
+   KNOWN_HEADER(SIP_CALLID_FIELD),
+   KNOWN_HEADER(SIP_SHORT_CALLID_FIELD),
+   KNOWN_HEADER(SIP_CSEQ_FIELD),
+   KNOWN_HEADER(SIP_FROM_FIELD),
+   KNOWN_HEADER(SIP_SHORT_FROM_FIELD),
+   KNOWN_HEADER(SIP_TO_FIELD),
+   KNOWN_HEADER(SIP_SHORT_TO_FIELD),
+   KNOWN_HEADER(SIP_CONTACT_FIELD),
+   KNOWN_HEADER(SIP_SHORT_CONTACT_FIELD),
+   KNOWN_HEADER(HTTP_CONTENT_LENGTH_FIELD),
+   KNOWN_HEADER(SIP_SHORT_CONTENT_LENGTH_FIELD),
+   KNOWN_HEADER(HTTP_CONTENT_TYPE_FIELD),
+   KNOWN_HEADER(SIP_SHORT_CONTENT_TYPE_FIELD),
+   KNOWN_HEADER(SIP_ROUTE_FIELD),
+   KNOWN_HEADER(SIP_RECORD_ROUTE_FIELD),
+   KNOWN_HEADER(SIP_MAX_FORWARDS_FIELD),
+   KNOWN_HEADER(SIP_EXPIRES_FIELD),
+   KNOWN_HEADER(SIP_EVENT_FIELD),
+   KNOWN_HEADER(SIP_SHORT_EVENT_FIELD),
+   KNOWN_HEADER(SIP_SUPPORTED_FIELD),
+   KNOWN_HEADER(SIP_SHORT_SUPPORTED_FIELD),
+   KNOWN_HEADER(SIP_REQUIRE_FIELD),
+   KNOWN_HEADER(SIP_ALLOW_FIELD),
+   KNOWN_HEADER(HTTP_USER_AGENT_FIELD),
+   KNOWN_HEADER(HTTP_AUTHORIZATION_FIELD),
+   KNOWN_HEADER(HTTP_PROXY_AUTHORIZATION_FIELD),
+   KNOWN_HEADER(HTTP_WWW_AUTHENTICATE_FIELD),
+   KNOWN_HEADER(HTTP_PROXY_AUTHENTICATE_FIELD),
+   KNOWN_HEADER(SIP_SESSION_EXPIRES_FIELD),
+   KNOWN_HEADER(SIP_SUBSCRIPTION_STATE_FIELD)
+};
+#define NUM_KNOWN_HEADERS ((int)(sizeof(sKnownHeaders)/sizeof(sKnownHeaders[0])))
+
+// STATIC VARIABLE INITIALIZATIONS
+
+/* //////////////////////////// PUBLIC //////////////////////////////////// */
+
+/* ============================ CREATORS ================================== */
+
+// Constructor
+HttpHeaderIndex::HttpHeaderIndex()
+: mValid(FALSE)
+, mNumSlots(0)
+, mpSlotStart(NULL)
+, mpSlotCount(NULL)
+, mSlotCapacity(0)
+, mpFields(NULL)
+, mpFieldSlots(NULL)
+, mFieldCapacity(0)
+{
+}
+
+// Destructor
+HttpHeaderIndex::~HttpHeaderIndex()
+{
+   mOtherSlots.destroyAll();
+   delete[] mpSlotStart;
+   delete[] mpSlotCount;
+   delete[] mpFields;
+   delete[] mpFieldSlots;
+}
+
+/* ============================ MANIPULATORS ============================== */
+
+void HttpHeaderIndex::build(const UtlDList& headerFields)
+{
+   int numFields = headerFields.entries();
+   if (numFields > mFieldCapacity)
+   {
+      delete[] mpFields;
+      delete[] mpFieldSlots;
+      mFieldCapacity = numFields * 2;
+      mpFields = new NameValuePair*[mFieldCapacity];
+      mpFieldSlots = new int[mFieldCapacity];
+   }
+
+   // Find the slot of every field
+   mOtherSlots.destroyAll();
+   mNumSlots = NUM_KNOWN_HEADERS;
+   UtlDListIterator iterator((UtlDList&)headerFields);
+   NameValuePair* headerField;
+   int fieldIndex = 0;
+   while ((headerField = (NameValuePair*) iterator()))
+   {
+      int slot = getKnownSlot(headerField->data());
+      if (slot < 0)
+      {
+         UtlString upperName(*headerField);
+         upperName.toUpper();
+         UtlInt* otherSlot = (UtlInt*) mOtherSlots.findValue(&upperName);
+         if (otherSlot)
+         {
+            slot = otherSlot->getValue();
+         }
+         else
+         {
+            slot = mNumSlots++;
+            mOtherSlots.insertKeyAndValue(new UtlString(upperName),
+                                          new UtlInt(slot));
+         }
+      }
+      mpFieldSlots[fieldIndex++] = slot;
+   }
+
+   if (mNumSlots > mSlotCapacity)
+   {
+      delete[] mpSlotStart;
+      delete[] mpSlotCount;
+      mSlotCapacity = mNumSlots * 2;
+      mpSlotStart = new int[mSlotCapacity];
+      mpSlotCount = new int[mSlotCapacity];
+   }
+
+   // Group the fields by slot, keeping their order within each slot
+   memset(mpSlotCount, 0, mNumSlots * sizeof(int));
+   for (fieldIndex = 0; fieldIndex < numFields; fieldIndex++)
+   {
+      mpSlotCount[mpFieldSlots[fieldIndex]]++;
+   }
+   int start = 0;
+   for (int slot = 0; slot < mNumSlots; slot++)
+   {
+      mpSlotStart[slot] = start;
+      start += mpSlotCount[slot];
+      mpSlotCount[slot] = 0;
+   }
+
+   iterator.reset();
+   fieldIndex = 0;
+   while ((headerField = (NameValuePair*) iterator()))
+   {
+      int slot = mpFieldSlots[fieldIndex++];
+      mpFields[mpSlotStart[slot] + mpSlotCount[slot]++] = headerField;
+   }
+
+   mValid = TRUE;
+}
+
+void HttpHeaderIndex::invalidate()
+{
+   mValid = FALSE;
+}
+
+/* ============================ ACCESSORS ================================= */
+
+NameValuePair* HttpHeaderIndex::getField(const char* name, int index) const
+{
+   int slot = getSlot(name);
+   if (slot < 0 || index < 0 || index >= mpSlotCount[slot])
+   {
+      return(NULL);
+   }
+
+   return(mpFields[mpSlotStart[slot] + index]);
+}
+
+int HttpHeaderIndex::getFieldCount(const char* name) const
+{
+   int slot = getSlot(name);
+   return(slot < 0 ? 0 : mpSlotCount[slot]);
+}
+
+/* ============================ INQUIRY =================================== */
+
+UtlBoolean HttpHeaderIndex::isValid() const
+{
+   return(mValid);
+}
+
+/* //////////////////////////// PROTECTED ///////////////////////////////// */
+
+int HttpHeaderIndex::getKnownSlot(const char* name)
+{
+   int nameLength = strlen(name);
+   char firstChar = toupper(name[0]);
+
+   for (int slot = 0; slot < NUM_KNOWN_HEADERS; slot++)
+   {
+      if (sKnownHeaders[slot].mLength == nameLength &&
+          toupper(sKnownHeaders[slot].mName[0]) == firstChar &&
+          strcasecmp(sKnownHeaders[slot].mName, name) == 0)
+      {
+         return(slot);
+      }
+   }
+
+   return(-1);
+}
+
+int HttpHeaderIndex::getSlot(const char* name) const
+{
+   assert(mValid);
+
+   int slot = getKnownSlot(name);
+   if (slot < 0 && mOtherSlots.entries() > 0)
+   {
+      UtlString upperName(name);
+      upperName.toUpper();
+      UtlInt* otherSlot = (UtlInt*) mOtherSlots.findValue(&upperName);
+      if (otherSlot)
+      {
+         slot = otherSlot->getValue();
+      }
+   }
+
+   return(slot);
+}
+
+/* //////////////////////////// PRIVATE /////////////////////////////////// */
+
+/* ============================ FUNCTIONS ================================= */
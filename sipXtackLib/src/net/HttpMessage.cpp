@@ -22,10 +22,12 @@
 
 #include <stdlib.h>
 #include <stdio.h>
+#include <limits.h>
 #include "utl/UtlDListIterator.h"
 
 // APPLICATION INCLUDES
 #include <net/HttpMessage.h>
+#include <net/HttpMessageReader.h>
 #include <net/NameValuePair.h>
 // Needed for SIP_SHORT_CONTENT_LENGTH_FIELD.
 #include <net/SipMessage.h>
@@ -77,6 +79,7 @@ HttpMessage::HttpMessage(const char* messageBytes, int byteCount)
    smHttpMessageCount++;
 
    mHeaderCacheClean = FALSE;
+   mUnindexedHeaderLookups = 0;
 
    //nameValues = new UtlHashBag(100);
    body = NULL;
@@ -101,6 +104,7 @@ HttpMessage::HttpMessage(OsSocket* inSocket, int bufferSize)
    smHttpMessageCount++;
 
    mHeaderCacheClean = FALSE;
+   mUnindexedHeaderLookups = 0;
 
    //mNameValues = new UtlHashBag(100);
    body = NULL;
@@ -127,6 +131,7 @@ HttpMessage::HttpMessage(const HttpMessage& rHttpMessage)
    //UtlString messageBytes;
    //int len;
    mHeaderCacheClean = rHttpMessage.mHeaderCacheClean;
+   mUnindexedHeaderLookups = 0;
    mFirstHeaderLine = rHttpMessage.mFirstHeaderLine;
    body = NULL;
    if(rHttpMessage.body)
@@ -215,6 +220,7 @@ HttpMessage::operator=(const HttpMessage& rHttpMessage)
       delete headerField;
       headerField = NULL;
    }
+   invalidateHeaderIndex();
 
    if(body)
    {
@@ -321,6 +327,7 @@ int HttpMessage::parseFirstLine(const char* messageBytesPtr, int byteCount)
 void HttpMessage::parseMessage(const char* messageBytes, int byteCount)
 {
    mHeaderCacheClean = FALSE;
+   invalidateHeaderIndex();
 
    if(byteCount <= 0)
    {
@@ -637,18 +644,11 @@ OsStatus HttpMessage::get(Url& httpUrl,
    // Handle the response
    if(bytesSent > 0 && httpSocket->isReadyToRead(iMaxWaitMilliSeconds))
    {
-      UtlString buffer ;
+      HttpMessageReader reader(httpSocket);
 
-      int iRead = readHeader(httpSocket, buffer) ;
-      if (iRead > 0)
+      if (reader.readHeaders(*this) > 0)
       {
-         mHeaderCacheClean = FALSE;
-         int iHeaderLength = parseFirstLine(buffer.data(), iRead) ;
-         parseHeaders(&buffer.data()[iHeaderLength], iRead-iHeaderLength, mNameValues) ;
-
-         int iContentLength = getContentLength() ;
-         if (iContentLength > 0)
-            iRead = readBody(httpSocket, iContentLength, pCallbackProc, pOptionalData) ;
+         reader.readBody(*this, pCallbackProc, pOptionalData) ;
       }
    }
    else
@@ -835,7 +835,8 @@ int HttpMessage::get(Url& httpUrl,
         else if(   bytesSent > 0
                 && httpSocket->isReadyToRead(maxWaitMilliSeconds))
         {
-            bytesRead = read(httpSocket);
+            HttpMessageReader reader(httpSocket);
+            bytesRead = reader.read(*this);
 
             // Close a non-persistent connection
             if (pConnectionMap == NULL)
@@ -963,6 +964,7 @@ int HttpMessage::get(Url& httpUrl,
 
                 // Clear out the data in the previous response
                 mHeaderCacheClean = FALSE;
+                invalidateHeaderIndex();
                 mNameValues.destroyAll();
                     if(body)
                     {
@@ -974,7 +976,8 @@ int HttpMessage::get(Url& httpUrl,
                 if(bytesSent > 0 &&
                     httpAuthSocket->isReadyToRead(maxWaitMilliSeconds))
                 {
-                    bytesRead = read(httpAuthSocket);
+                    HttpMessageReader reader(httpAuthSocket);
+                    bytesRead = reader.read(*this);
                     httpAuthSocket->close();
                 }
 
@@ -1114,6 +1117,7 @@ int HttpMessage::read(OsSocket* inSocket, int bufferSize,
    //
 
    mHeaderCacheClean = FALSE;
+   invalidateHeaderIndex();
    // Remember to empty the list of parsed header values, as we will use it
    // to parse the headers on the HTTP response we are going to read.
    mNameValues.destroyAll();
@@ -1956,6 +1960,25 @@ int HttpMessage::getCountHeaderFields(const char* name) const
 
 NameValuePair* HttpMessage::getHeaderField(int index, const char* name) const
 {
+    // Look named fields up in the index.  It is built only when the fields
+    // are looked up repeatedly without being changed in between, so that
+    // building a message with alternating sets and gets does not rebuild
+    // it every time.  The casts are a bit of a hack so that the const
+    // signature does not have to change.
+    if(name)
+    {
+        if(!mHeaderIndex.isValid() &&
+           ++((HttpMessage*)this)->mUnindexedHeaderLookups >= HTTP_HEADER_INDEX_MIN_LOOKUPS)
+        {
+            ((HttpMessage*)this)->mHeaderIndex.build(mNameValues);
+        }
+
+        if(mHeaderIndex.isValid())
+        {
+            return(mHeaderIndex.getField(name, index));
+        }
+    }
+
         UtlDListIterator iterator((UtlDList&)mNameValues);
         //NameValuePair* headerFieldName = NULL;
         NameValuePair* headerField = NULL;
@@ -2018,6 +2041,12 @@ NameValuePair* HttpMessage::getHeaderField(int index, const char* name) const
         return(headerField);
 }
 
+void HttpMessage::invalidateHeaderIndex()
+{
+    mHeaderIndex.invalidate();
+    mUnindexedHeaderLookups = 0;
+}
+
 const char* HttpMessage::getHeaderValue(int index, const char* name) const
 {
         const char* value = NULL;
@@ -2050,6 +2079,7 @@ void HttpMessage::setHeaderValue(const char* name, const char* newValue, int ind
 UtlBoolean HttpMessage::removeHeader(const char* name, int index)
 {
    mHeaderCacheClean = FALSE;
+   invalidateHeaderIndex();
    UtlBoolean foundHeader = FALSE;
    UtlDListIterator iterator((UtlDList&)mNameValues);
    NameValuePair* headerFieldName = NULL;
@@ -2102,6 +2132,7 @@ UtlBoolean HttpMessage::removeHeader(const char* name, int index)
 void HttpMessage::addHeaderField(const char* name, const char* value)
 {
     mHeaderCacheClean = FALSE;
+    invalidateHeaderIndex();
     NameValuePair* headerField =
         new NameValuePair(name ? name : "", value);
     headerField->toUpper();
@@ -2113,6 +2144,7 @@ void HttpMessage::insertHeaderField(const char* name,
                                     int index)
 {
     mHeaderCacheClean = FALSE;
+    invalidateHeaderIndex();
     NameValuePair* headerField =
         new NameValuePair(name ? name : "", value);
     headerField->toUpper();
@@ -3554,7 +3586,99 @@ UtlBoolean HttpMessage::isWholeMessage(const char* messageBuffer,
                               int& numberBytesChecked,
                               int& contentLength)
 {
-    return(FALSE);
+    contentLength = -1;
+    numberBytesChecked = findHeaderEnd(messageBuffer, bufferLength);
+    if (numberBytesChecked <= 0)
+    {
+        // The end of the headers has not been received yet.
+        numberBytesChecked = -1;
+        return(FALSE);
+    }
+
+    // Look for a Content-Length (or its SIP short form "l") header at the
+    // start of each header line.  A message without one has no body.
+    contentLength = 0;
+    int lineStart = 0;
+    while (lineStart < numberBytesChecked)
+    {
+        int lineEnd = lineStart;
+        while (lineEnd < numberBytesChecked &&
+               messageBuffer[lineEnd] != NEWLINE &&
+               messageBuffer[lineEnd] != CARRIAGE_RETURN)
+        {
+            lineEnd++;
+        }
+
+        int nameEnd = lineStart;
+        while (nameEnd < lineEnd &&
+               messageBuffer[nameEnd] != ':' &&
+               messageBuffer[nameEnd] != ' ' &&
+               messageBuffer[nameEnd] != '\t')
+        {
+            nameEnd++;
+        }
+        int colon = nameEnd;
+        while (colon < lineEnd &&
+               (messageBuffer[colon] == ' ' || messageBuffer[colon] == '\t'))
+        {
+            colon++;
+        }
+
+        if (colon < lineEnd && messageBuffer[colon] == ':')
+        {
+            int nameLength = nameEnd - lineStart;
+            UtlBoolean isContentLength =
+               (nameLength == 1 &&
+                tolower(messageBuffer[lineStart]) ==
+                   SIP_SHORT_CONTENT_LENGTH_FIELD[0]);
+            if (nameLength == (int)sizeof(HTTP_CONTENT_LENGTH_FIELD) - 1)
+            {
+                isContentLength = TRUE;
+                for (int i = 0; i < nameLength && isContentLength; i++)
+                {
+                    isContentLength =
+                       toupper(messageBuffer[lineStart + i]) ==
+                          HTTP_CONTENT_LENGTH_FIELD[i];
+                }
+            }
+
+            if (isContentLength)
+            {
+                int value = 0;
+                int digit = colon + 1;
+                while (digit < lineEnd &&
+                       (messageBuffer[digit] == ' ' || messageBuffer[digit] == '\t'))
+                {
+                    digit++;
+                }
+                while (digit < lineEnd &&
+                       messageBuffer[digit] >= '0' && messageBuffer[digit] <= '9' &&
+                       value <= (INT_MAX - 9) / 10)
+                {
+                    value = value * 10 + (messageBuffer[digit] - '0');
+                    digit++;
+                }
+                contentLength = value;
+                break;
+            }
+        }
+
+        // Skip the line terminator
+        lineStart = lineEnd;
+        if (lineStart < numberBytesChecked &&
+            messageBuffer[lineStart] == CARRIAGE_RETURN)
+        {
+            lineStart++;
+        }
+        if (lineStart < numberBytesChecked &&
+            messageBuffer[lineStart] == NEWLINE)
+        {
+            lineStart++;
+        }
+    }
+
+    // Compared this way round so that a huge Content-Length cannot overflow.
+    return(contentLength <= bufferLength - numberBytesChecked);
 }
 
 UtlBoolean HttpMessage::isFirstSend() const
@@ -0,0 +1,615 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+
+// SYSTEM INCLUDES
+#include <stdlib.h>
+#include <string.h>
+
+// APPLICATION INCLUDES
+#include <net/HttpMessageReader.h>
+// Needed for SIP_SHORT_CONTENT_LENGTH_FIELD.
+#include <net/SipMessage.h>
+#include <os/OsSysLog.h>
+
+// EXTERNAL FUNCTIONS
+// EXTERNAL VARIABLES
+// CONSTANTS
+// STATIC VARIABLE INITIALIZATIONS
+
+// Callback to read past a body nobody asked for
+static UtlBoolean discardBody(char* pData, int iLength,
+                              void* pOptionalData, HttpMessage* pMsg)
+{
+   return TRUE;
+}
+
+/* //////////////////////////// PUBLIC //////////////////////////////////// */
+
+/* ============================ CREATORS ================================== */
+
+// Constructor
+HttpMessageReader::HttpMessageReader(OsSocket* pSocket,
+                                     int maxContentLength,
+                                     int readSize)
+: mpSocket(pSocket)
+, mpBuffer(NULL)
+, mCapacity(0)
+, mInitialCapacity(2 * readSize)
+, mStart(0)
+, mEnd(0)
+, mMaxContentLength(maxContentLength)
+, mReadSize(readSize)
+, mBodyFraming(BODY_NONE)
+, mBodyRemaining(0)
+{
+   // One spare byte after mEnd is kept null, as HttpMessage::findHeaderEnd()
+   // may look one byte past the end of what it is given.
+   mpBuffer = (char*) malloc(mInitialCapacity + 1);
+   if (mpBuffer)
+   {
+      mCapacity = mInitialCapacity;
+      mpBuffer[0] = '\0';
+   }
+}
+
+// Destructor
+HttpMessageReader::~HttpMessageReader()
+{
+   free(mpBuffer);
+}
+
+/* ============================ MANIPULATORS ============================== */
+
+int HttpMessageReader::read(HttpMessage& message, long waitMilliseconds)
+{
+   int headerLength = readHeaders(message, waitMilliseconds);
+   if (headerLength <= 0)
+   {
+      return 0;
+   }
+
+   int bodyLength = 0;
+   int wireLength = 0;
+
+   switch (mBodyFraming)
+   {
+   case BODY_LENGTH:
+      if (!reserve(mBodyRemaining))
+      {
+         fail("read no memory for body");
+         return 0;
+      }
+      while (mEnd - mStart < mBodyRemaining)
+      {
+         if (fill(waitMilliseconds) <= 0)
+         {
+            fail("read body cut short");
+            return 0;
+         }
+      }
+      bodyLength = mBodyRemaining;
+      wireLength = mBodyRemaining;
+      break;
+
+   case BODY_CHUNKED:
+   {
+      // Decode in place: the data of each chunk is moved down over the
+      // chunk size lines before it.
+      int offset = 0;
+      int chunkSize;
+      while ((chunkSize = readChunkSize(offset, waitMilliseconds)) > 0)
+      {
+         if (bodyLength + chunkSize > mMaxContentLength)
+         {
+            fail("read chunked body too big");
+            return 0;
+         }
+         if (!reserve(offset + chunkSize + 2))
+         {
+            fail("read no memory for chunk");
+            return 0;
+         }
+         while (mEnd - mStart < offset + chunkSize)
+         {
+            if (fill(waitMilliseconds) <= 0)
+            {
+               fail("read chunk cut short");
+               return 0;
+            }
+         }
+         memmove(mpBuffer + mStart + bodyLength,
+                 mpBuffer + mStart + offset, chunkSize);
+         bodyLength += chunkSize;
+         offset += chunkSize;
+
+         int lineEnd = findLineEnd(offset, waitMilliseconds);
+         if (lineEnd < 0 || !isEmptyLine(offset, lineEnd))
+         {
+            fail("read no line end after chunk");
+            return 0;
+         }
+         offset = lineEnd;
+      }
+      if (chunkSize < 0 || !skipTrailer(offset, waitMilliseconds))
+      {
+         fail("read bad chunk");
+         return 0;
+      }
+      wireLength = offset;
+
+      // The body is no longer chunked once it is in the message
+      message.removeHeader(HTTP_TRANSFER_ENCODING_FIELD, 0);
+      message.setContentLength(bodyLength);
+      break;
+   }
+
+   case BODY_UNTIL_CLOSE:
+      while (fill(waitMilliseconds) > 0)
+      {
+         if (mEnd - mStart > mMaxContentLength)
+         {
+            fail("read body too big");
+            return 0;
+         }
+      }
+      bodyLength = mEnd - mStart;
+      wireLength = bodyLength;
+      break;
+
+   case BODY_NONE:
+      break;
+   }
+
+   if (bodyLength > 0)
+   {
+      message.parseBody(mpBuffer + mStart, bodyLength);
+   }
+   mStart += wireLength;
+   mBodyFraming = BODY_NONE;
+   mBodyRemaining = 0;
+
+   return headerLength + wireLength;
+}
+
+int HttpMessageReader::readHeaders(HttpMessage& message, long waitMilliseconds)
+{
+   if (mBodyFraming != BODY_NONE)
+   {
+      // The body of the last message was never read
+      readBody(message, discardBody, NULL, waitMilliseconds);
+   }
+
+   int headerEnd = -1;
+   while (headerEnd < 0)
+   {
+      // Line ends between messages are ignored (RFC 7230 section 3.5)
+      while (mStart < mEnd &&
+             (mpBuffer[mStart] == '\r' || mpBuffer[mStart] == '\n'))
+      {
+         mStart++;
+      }
+
+      int available = mEnd - mStart;
+      if (available > 0)
+      {
+         headerEnd = HttpMessage::findHeaderEnd(mpBuffer + mStart, available);
+
+         // A CR at the very end may be the first half of the last CRLF
+         if (headerEnd == available && mpBuffer[mEnd - 1] == '\r')
+         {
+            headerEnd = -1;
+         }
+         if (headerEnd < 0 && available > HTTP_MESSAGE_READER_MAX_HEADER_SIZE)
+         {
+            fail("readHeaders headers too big");
+            return 0;
+         }
+      }
+
+      if (headerEnd < 0 && fill(waitMilliseconds) <= 0)
+      {
+         if (mEnd > mStart)
+         {
+            fail("readHeaders headers cut short");
+         }
+         return 0;
+      }
+   }
+
+   // Forget the last message read into this one
+   message.mNameValues.destroyAll();
+   message.setBody(NULL);
+
+   const char* headerBytes = mpBuffer + mStart;
+   int firstLineEnd = message.parseFirstLine(headerBytes, headerEnd);
+   HttpMessage::parseHeaders(headerBytes + firstLineEnd,
+                             headerEnd - firstLineEnd,
+                             message.mNameValues);
+   message.mHeaderCacheClean = FALSE;
+   message.invalidateHeaderIndex();
+   mStart += headerEnd;
+
+   UtlString remoteHost;
+   int remotePort;
+   mpSocket->getRemoteHostIp(&remoteHost, &remotePort);
+   message.setSendProtocol(mpSocket->getIpProtocol());
+   message.setSendAddress(remoteHost.data(), remotePort);
+
+   // Find how the end of the body is marked (RFC 7230 section 3.3.3)
+   UtlBoolean isResponse =
+      strncmp(message.getFirstHeaderLine(), "HTTP/", 5) == 0;
+   int statusCode = isResponse ? message.getResponseStatusCode() : 0;
+   const char* transferEncoding =
+      message.getHeaderValue(0, HTTP_TRANSFER_ENCODING_FIELD);
+   const char* contentLength =
+      message.getHeaderValue(0, HTTP_CONTENT_LENGTH_FIELD);
+   if (contentLength == NULL)
+   {
+      contentLength = message.getHeaderValue(0, SIP_SHORT_CONTENT_LENGTH_FIELD);
+   }
+
+   mBodyRemaining = 0;
+   if (isResponse &&
+       ((statusCode >= 100 && statusCode < 200) ||
+        statusCode == 204 || statusCode == 304))
+   {
+      mBodyFraming = BODY_NONE;
+   }
+   else if (transferEncoding)
+   {
+      UtlString codings(transferEncoding);
+      codings.toLower();
+      codings.strip(UtlString::both);
+      int chunked = codings.length() - strlen(HTTP_TRANSFER_ENCODING_CHUNKED);
+      if (chunked >= 0 &&
+          strcmp(codings.data() + chunked, HTTP_TRANSFER_ENCODING_CHUNKED) == 0)
+      {
+         mBodyFraming = BODY_CHUNKED;
+      }
+      else if (isResponse)
+      {
+         mBodyFraming = BODY_UNTIL_CLOSE;
+      }
+      else
+      {
+         fail("readHeaders request body not chunked");
+         return 0;
+      }
+   }
+   else if (contentLength)
+   {
+      mBodyRemaining = atoi(contentLength);
+      if (mBodyRemaining < 0 || mBodyRemaining > mMaxContentLength)
+      {
+         OsSysLog::add(FAC_HTTP, PRI_WARNING,
+                       "HttpMessageReader::readHeaders Content-Length: %s",
+                       contentLength);
+         fail("readHeaders Content-Length too big");
+         return 0;
+      }
+      mBodyFraming = mBodyRemaining > 0 ? BODY_LENGTH : BODY_NONE;
+   }
+   else
+   {
+      mBodyFraming = isResponse ? BODY_UNTIL_CLOSE : BODY_NONE;
+   }
+
+   return headerEnd;
+}
+
+int HttpMessageReader::readBody(HttpMessage& message,
+                                GetDataCallbackProc callbackProc,
+                                void* pOptionalData,
+                                long waitMilliseconds)
+{
+   int bodyLength = 0;
+   UtlBoolean more = TRUE;
+
+   while (more && mBodyFraming != BODY_NONE)
+   {
+      if (mBodyFraming == BODY_CHUNKED && mBodyRemaining == 0)
+      {
+         int offset = 0;
+         int chunkSize = readChunkSize(offset, waitMilliseconds);
+         if (chunkSize == 0 && skipTrailer(offset, waitMilliseconds))
+         {
+            mStart += offset;
+            mBodyFraming = BODY_NONE;
+            break;
+         }
+         if (chunkSize <= 0 || bodyLength + chunkSize > mMaxContentLength)
+         {
+            fail("readBody bad chunk");
+            break;
+         }
+         mStart += offset;
+         mBodyRemaining = chunkSize;
+      }
+
+      if (mStart == mEnd && fill(waitMilliseconds) <= 0)
+      {
+         if (mBodyFraming == BODY_UNTIL_CLOSE)
+         {
+            mBodyFraming = BODY_NONE;
+         }
+         else
+         {
+            fail("readBody body cut short");
+         }
+         break;
+      }
+
+      // Pass on what is in the buffer, as far as the end of the chunk
+      int piece = mEnd - mStart;
+      if (mBodyFraming != BODY_UNTIL_CLOSE && piece > mBodyRemaining)
+      {
+         piece = mBodyRemaining;
+      }
+      else if (mBodyFraming == BODY_UNTIL_CLOSE &&
+               bodyLength + piece > mMaxContentLength)
+      {
+         fail("readBody body too big");
+         break;
+      }
+      more = (*callbackProc)(mpBuffer + mStart, piece, pOptionalData, &message);
+      mStart += piece;
+      bodyLength += piece;
+
+      if (mBodyFraming != BODY_UNTIL_CLOSE)
+      {
+         mBodyRemaining -= piece;
+         if (mBodyRemaining == 0)
+         {
+            if (mBodyFraming == BODY_LENGTH)
+            {
+               mBodyFraming = BODY_NONE;
+            }
+            else
+            {
+               int lineEnd = findLineEnd(0, waitMilliseconds);
+               if (lineEnd < 0 || !isEmptyLine(0, lineEnd))
+               {
+                  fail("readBody no line end after chunk");
+                  break;
+               }
+               mStart += lineEnd;
+            }
+         }
+      }
+   }
+
+   if (!more && mBodyFraming != BODY_NONE)
+   {
+      // The rest of the body is not wanted, and the connection cannot be
+      // used for another message without reading it.
+      mpSocket->close();
+      mStart = mEnd = 0;
+      mBodyFraming = BODY_NONE;
+      mBodyRemaining = 0;
+   }
+
+   // Signal callback proc that data transfer is complete
+   (*callbackProc)(NULL, -1, pOptionalData, &message);
+
+   return bodyLength;
+}
+
+/* ============================ ACCESSORS ================================= */
+
+int HttpMessageReader::getBufferedLength() const
+{
+   return mEnd - mStart;
+}
+
+/* ============================ INQUIRY =================================== */
+
+UtlBoolean HttpMessageReader::isReadyToRead(long waitMilliseconds)
+{
+   while (mStart < mEnd &&
+          (mpBuffer[mStart] == '\r' || mpBuffer[mStart] == '\n'))
+   {
+      mStart++;
+   }
+
+   return mStart < mEnd ||
+          (mpSocket->isOk() && mpSocket->isReadyToRead(waitMilliseconds));
+}
+
+/* //////////////////////////// PROTECTED ///////////////////////////////// */
+
+/* //////////////////////////// PRIVATE /////////////////////////////////// */
+
+UtlBoolean HttpMessageReader::reserve(int length)
+{
+   if (mStart + length <= mCapacity)
+   {
+      return TRUE;
+   }
+
+   // Move the bytes still wanted to the front
+   if (mStart > 0)
+   {
+      memmove(mpBuffer, mpBuffer + mStart, mEnd - mStart);
+      mEnd -= mStart;
+      mStart = 0;
+      mpBuffer[mEnd] = '\0';
+   }
+
+   if (length > mCapacity)
+   {
+      int capacity = 2 * mCapacity;
+      if (capacity < length)
+      {
+         capacity = length;
+      }
+      char* buffer = (char*) realloc(mpBuffer, capacity + 1);
+      if (buffer == NULL)
+      {
+         return FALSE;
+      }
+      mpBuffer = buffer;
+      mCapacity = capacity;
+   }
+
+   return TRUE;
+}
+
+int HttpMessageReader::fill(long waitMilliseconds)
+{
+   if (mStart == mEnd)
+   {
+      mStart = mEnd = 0;
+
+      // Give back the memory taken by a big message
+      if (mCapacity > mInitialCapacity &&
+          mCapacity > HTTP_MESSAGE_READER_MAX_HEADER_SIZE)
+      {
+         char* buffer = (char*) realloc(mpBuffer, mInitialCapacity + 1);
+         if (buffer)
+         {
+            mpBuffer = buffer;
+            mCapacity = mInitialCapacity;
+         }
+      }
+   }
+
+   if (mpBuffer == NULL || !reserve(mEnd - mStart + mReadSize))
+   {
+      return -1;
+   }
+
+   if (!mpSocket->isOk() || !mpSocket->isReadyToRead(waitMilliseconds))
+   {
+      return 0;
+   }
+
+   int bytesRead = mpSocket->read(mpBuffer + mEnd, mCapacity - mEnd);
+   if (bytesRead > 0)
+   {
+      mEnd += bytesRead;
+      mpBuffer[mEnd] = '\0';
+   }
+
+   return bytesRead;
+}
+
+int HttpMessageReader::findLineEnd(int offset, long waitMilliseconds)
+{
+   int index = offset;
+   for (;;)
+   {
+      for (; mStart + index < mEnd; index++)
+      {
+         if (mpBuffer[mStart + index] == '\n')
+         {
+            return index + 1;
+         }
+      }
+
+      if (index - offset > HTTP_MESSAGE_READER_MAX_CHUNK_LINE ||
+          fill(waitMilliseconds) <= 0)
+      {
+         return -1;
+      }
+   }
+}
+
+int HttpMessageReader::readChunkSize(int& offset, long waitMilliseconds)
+{
+   int lineEnd = findLineEnd(offset, waitMilliseconds);
+   if (lineEnd < 0)
+   {
+      return -1;
+   }
+
+   // The size is in hex, and may be followed by chunk extensions
+   int chunkSize = 0;
+   int digits = 0;
+   for (int index = offset; index < lineEnd; index++, digits++)
+   {
+      char c = mpBuffer[mStart + index];
+      int digit;
+      if (c >= '0' && c <= '9')
+      {
+         digit = c - '0';
+      }
+      else if (c >= 'a' && c <= 'f')
+      {
+         digit = c - 'a' + 10;
+      }
+      else if (c >= 'A' && c <= 'F')
+      {
+         digit = c - 'A' + 10;
+      }
+      else
+      {
+         break;
+      }
+
+      chunkSize = chunkSize * 16 + digit;
+      if (chunkSize > mMaxContentLength)
+      {
+         return -1;
+      }
+   }
+
+   if (digits == 0)
+   {
+      return -1;
+   }
+
+   offset = lineEnd;
+   return chunkSize;
+}
+
+UtlBoolean HttpMessageReader::isEmptyLine(int offset, int lineEnd) const
+{
+   return lineEnd - offset == 1 ||
+          (lineEnd - offset == 2 && mpBuffer[mStart + offset] == '\r');
+}
+
+UtlBoolean HttpMessageReader::skipTrailer(int& offset, long waitMilliseconds)
+{
+   // Trailer fields are read past, but not added to the message
+   for (int lines = 0; lines < HTTP_MESSAGE_READER_MAX_CHUNK_LINE; lines++)
+   {
+      int lineEnd = findLineEnd(offset, waitMilliseconds);
+      if (lineEnd < 0)
+      {
+         return FALSE;
+      }
+
+      UtlBoolean lastLine = isEmptyLine(offset, lineEnd);
+      offset = lineEnd;
+      if (lastLine)
+      {
+         return TRUE;
+      }
+   }
+
+   return FALSE;
+}
+
+void HttpMessageReader::fail(const char* reason)
+{
+   UtlString remoteHost;
+   int remotePort;
+   mpSocket->getRemoteHostIp(&remoteHost, &remotePort);
+   OsSysLog::add(FAC_HTTP, PRI_WARNING,
+                 "HttpMessageReader::%s, closing socket type: %d to %s:%d",
+                 reason, mpSocket->getIpProtocol(),
+                 remoteHost.data(), remotePort);
+
+   // Shut it all down, as the end of the message cannot be found
+   mpSocket->close();
+   mStart = mEnd = 0;
+   mBodyFraming = BODY_NONE;
+   mBodyRemaining = 0;
+}
+
+/* ============================ FUNCTIONS ================================= */
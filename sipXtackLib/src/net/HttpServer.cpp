@@ -47,6 +47,7 @@
 #include <os/OsConfigDb.h>
 #include <utl/UtlVoidPtr.h>
 #include <net/HttpMessage.h>
+#include <net/HttpMessageReader.h>
 #include <net/HttpServer.h>
 #include <net/HttpService.h>
 #include <net/HttpBody.h>
@@ -289,7 +290,8 @@ int HttpServer::run(void* runArg)
                     HttpMessage request;
                     HttpMessage response;
                     // Read the http request from the socket
-                    request.read(requestSocket);
+                    HttpMessageReader reader(requestSocket);
+                    reader.read(request);
                     
                     // Send out of resources message
                     response.setResponseFirstHeaderLine(HTTP_PROTOCOL_VERSION,
@@ -305,7 +307,8 @@ int HttpServer::run(void* runArg)
             {
             HttpMessage request;
             // Read a http request from the socket
-            request.read(requestSocket);
+            HttpMessageReader reader(requestSocket);
+            reader.read(request);
 
              UtlString remoteIp;
             requestSocket->getRemoteHostIp(&remoteIp);
@@ -13,6 +13,7 @@
 
 // SYSTEM INCLUDES
 #include <stdio.h>
+#include <stdlib.h>
 
 //#define TEST_PRINT
 
@@ -27,6 +28,11 @@
 #include <os/OsSysLog.h>
 #include <os/OsEvent.h>
 #include <utl/UtlVoidPtr.h>
+#ifdef SIP_TCP_USE_REACTOR
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <errno.h>
+#endif
 #ifdef SIP_TLS
 #include "os/OsTLSConnectionSocket.h"
 #include "os/OsTLSClientConnectionSocket.h"
@@ -53,6 +59,13 @@ l: 0 \n\r
 // However to be tolerant of malformed messages we allow smaller:
 #define MINIMUM_SIP_MESSAGE_SIZE 30
 #define MAX_UDP_PACKET_SIZE (1024 * 64)
+// Limits for messages framed by readAvailable(), beyond which the
+// connection is considered abusive.  Same Content-Length limit as
+// HttpMessage::read().
+#define SIP_CLIENT_MAX_HEADER_SIZE (1024 * 64)
+#define SIP_CLIENT_MAX_CONTENT_LENGTH 6000000
+// Datagrams read with a single readBatch() by runBatchReads()
+#define SIP_UDP_BATCH_SIZE 32
 
 // STATIC VARIABLE INITIALIZATIONS
 #define TEST_PRINT
@@ -73,7 +86,14 @@ SipClient::SipClient(OsSocket* socket) :
    mFirstResendTimeoutMs(SIP_DEFAULT_RTT * 4), // for first transaction time out
    mInUseForWrite(0),
    mWaitingList(NULL),
-   mbSharedSocket(FALSE)
+   mbSharedSocket(FALSE),
+   mpReactor(NULL),
+   mpReactorTask(NULL),
+   mReactorId(0),
+   mReactorBusy(0),
+   mBatchWakeups(0),
+   mBatchPackets(0),
+   mBatchMaxPackets(0)
  {
    touch();
 
@@ -109,6 +129,14 @@ SipClient::~SipClient()
 
     // Do not delete the event listers they are not subordinate
 
+#ifdef SIP_TCP_USE_REACTOR // [
+    // Make sure no reactor thread uses this client or its socket any more
+    if(mpReactor)
+    {
+        mpReactor->removeClient(this);
+    }
+#endif // SIP_TCP_USE_REACTOR ]
+
     // Free the socket
     if(clientSocket)
     {
@@ -202,6 +230,14 @@ int SipClient::run(void* runArg)
         readBufferSize = MAX_UDP_PACKET_SIZE;
     }
 
+#ifdef SIP_UDP_BATCH_READS
+    // Use the read loop below if the batch reads cannot be done.
+    if(mSocketType == OsSocket::UDP && clientSocket && runBatchReads())
+    {
+        return(0);
+    }
+#endif
+
     while(   !isShuttingDown()
             && !internalShutdown
             && clientSocket
@@ -350,169 +386,19 @@ int SipClient::run(void* runArg)
 #endif
                 if(sipUserAgent)
                 {
-                    UtlString socketRemoteHost;
-                    UtlString lastAddress;
-                    UtlString lastProtocol;
-                    int lastPort;
-
-                    // Only bother processing if the logs are enabled
-                    if (sipUserAgent->isMessageLoggingEnabled() ||
-                            OsSysLog::willLog(FAC_SIP_INCOMING, PRI_INFO))
-                    {
-                       UtlString logMessage;
-                       logMessage.append("Read SIP message:\n");
-                       logMessage.append("----Remote Host:");
-                       logMessage.append(fromIpAddress);
-                       logMessage.append("---- Port: ");
-                       char buff[10];
-                       sprintf(buff, "%d",
-                               !portIsValid(fromPort) ? 5060 : fromPort);
-                       logMessage.append(buff);
-                       logMessage.append("----\n");
-
-                       logMessage.append(buffer.data(), bytesRead);
-                       UtlString messageString;
-                       logMessage.append(messageString);
-                       logMessage.append("====================END====================\n");
-
-                       sipUserAgent->logMessage(logMessage.data(), logMessage.length());
-                       OsSysLog::add(FAC_SIP_INCOMING, PRI_INFO, "%s", logMessage.data());
-                    }
-
-#ifdef DEBUG_POLL_NO_BYTES
-                    OsSysLog::add(FAC_SIP, PRI_DEBUG, "SipClient line: %d", __LINE__);
+#ifdef LOG_TIME
+                    eventTimes.addEvent("dispatching");
 #endif
-                    // Set the date field if not present
-                    long epochDate;
-                    if(!message->getDateField(&epochDate))
-                    {
-                        message->setDateField();
-                    }
-
-#ifdef DEBUG_POLL_NO_BYTES
-                    OsSysLog::add(FAC_SIP, PRI_DEBUG, "SipClient line: %d", __LINE__);
+                    dispatchMessage(message, buffer.data(), bytesRead,
+                                    fromIpAddress, fromPort);
+                    message = NULL;
+#ifdef LOG_TIME
+                    eventTimes.addEvent("dispatched");
 #endif
-                    message->setSendProtocol(mSocketType);
-                    message->setTransportTime(touchedTime);
-                    clientSocket->getRemoteHostIp(&socketRemoteHost);
-
-                    // Keep track of where this message came from
-                    message->setSendAddress(fromIpAddress.data(), fromPort);
-                    
-                    // Keep track of the interface on which this message was
-                    // received.               
-                    message->setLocalIp(clientSocket->getLocalIp());
-
-                    if(mReceivedAddress.isNull())
-                    {
-                        mReceivedAddress = fromIpAddress;
-                        mRemoteReceivedPort = fromPort;
-                    }
-
-#ifdef DEBUG_POLL_NO_BYTES
-                    OsSysLog::add(FAC_SIP, PRI_DEBUG, "SipClient line: %d", __LINE__);
-#endif
-                    // If this is a request
-                    if(!message->isResponse())
-                    {
-                       int receivedPort;
-                       UtlBoolean receivedSet;
-                       UtlBoolean maddrSet;
-                       UtlBoolean receivedPortSet;
-
-                       // fill in 'received' and 'rport' in top via if needed.
-                       message->setReceivedViaParams(fromIpAddress, fromPort);
-
-                       // get the addresses from the topmost via.
-                       message->getLastVia(&lastAddress, &lastPort, &lastProtocol,
-                                           &receivedPort, &receivedSet, &maddrSet,
-                                           &receivedPortSet);
-
-                        if (   (   mSocketType == OsSocket::TCP
-                                || mSocketType == OsSocket::SSL_SOCKET
-                                )
-                            && !receivedPortSet
-                            )
-                        {
-                            // we can use this socket as if it were
-                            // connected to the port specified in the
-                            // via field
-                            mRemoteReceivedPort = lastPort;
-                        }
-
-                        // Keep track of the address the other
-                        // side said they sent from.  Note, this cannot
-                        // be trusted unless this transaction is
-                        // authenticated
-                        if(mRemoteViaAddress.isNull())
-                        {
-                            mRemoteViaAddress = lastAddress;
-                            mRemoteViaPort = portIsValid(lastPort) ? lastPort : 5060;
-                        }
-                    }
 
                     // We read a whole message whether it is a valid one or
                     // not does not matter
                     readAMessage = TRUE;
-
-                    // Check that we have the minimum data to define a transaction
-                    UtlString callId;
-                    UtlString fromField;
-                    UtlString toField;
-                    message->getCallIdField(&callId);
-                    message->getFromField(&fromField);
-                    message->getToField(&toField);
-#ifdef DEBUG_POLL_NO_BYTES
-                    OsSysLog::add(FAC_SIP, PRI_DEBUG, "SipClient line: %d", __LINE__);
-                    OsSysLog::flush();
-#endif
-                    if(!(   callId.isNull()
-                         || fromField.isNull()
-                         || toField.isNull()))
-                    {
-#ifdef DEBUG_POLL_NO_BYTES
-                        OsSysLog::add(FAC_SIP, PRI_DEBUG, "SipClient line: %d", __LINE__);
-                        OsSysLog::flush();
-#endif
-#ifdef LOG_TIME
-                        eventTimes.addEvent("dispatching");
-#endif
-                        sipUserAgent->dispatch(message);
-#ifdef DEBUG_POLL_NO_BYTES
-                        OsSysLog::add(FAC_SIP, PRI_DEBUG, "SipClient line: %d", __LINE__);
-                        OsSysLog::flush();
-#endif
-#ifdef LOG_TIME
-                        eventTimes.addEvent("dispatched");
-#endif
-
-                        message = NULL; // protect the dispatched message from deletion below
-                    }
-                    else
-                    {
-#ifdef DEBUG_POLL_NO_BYTES
-                        OsSysLog::add(FAC_SIP, PRI_DEBUG, "SipClient line: %d", __LINE__);
-                        OsSysLog::flush();
-#endif
-                       // Only bother processing if the logs are enabled
-                       if (sipUserAgent->isMessageLoggingEnabled())
-                       {
-                          UtlString msgBytes;
-                                    int msgLen;
-                                    message->getBytes(&msgBytes, &msgLen);
-                                    msgBytes.insert(0, "Received incomplete message (missing To, From or Call-Id header)\n");
-                                    msgBytes.append("++++++++++++++++++++END++++++++++++++++++++\n");
-                                    sipUserAgent->logMessage(msgBytes.data(), msgBytes.length());
-                       }
-#ifdef DEBUG_POLL_NO_BYTES
-                        OsSysLog::add(FAC_SIP, PRI_DEBUG, "SipClient line: %d", __LINE__);
-                        OsSysLog::flush();
-#endif
-
-                       delete message;
-                       message = NULL;
-                    }
-
                 } //if sipuseragent
 
                 // Get rid of the consumed stuff in the buffer so it
@@ -568,6 +454,378 @@ int SipClient::run(void* runArg)
     return(0);
 }
 
+#ifdef SIP_UDP_BATCH_READS // [
+// Each time the socket becomes readable, read the datagrams waiting on it
+// SIP_UDP_BATCH_SIZE at a time (one recvmmsg() each) until it is drained,
+// then dispatch them.  Run by run() for UDP clients.
+UtlBoolean SipClient::runBatchReads()
+{
+    // The receive buffers are reused for every batch.  Each slot can hold
+    // the largest datagram, but only the pages actually written by
+    // datagrams get committed.
+    char* buffers = (char*) malloc(SIP_UDP_BATCH_SIZE * MAX_UDP_PACKET_SIZE);
+    if (buffers == NULL)
+    {
+        OsSysLog::add(FAC_SIP, PRI_CRIT,
+                      "SipClient::runBatchReads %p cannot allocate %d bytes "
+                      "of batch buffers, reading socket %d one datagram at a time",
+                      this, SIP_UDP_BATCH_SIZE * MAX_UDP_PACKET_SIZE,
+                      clientSocket->getSocketDescriptor());
+        return(FALSE);
+    }
+    int packetLengths[SIP_UDP_BATCH_SIZE];
+    UtlString fromAddresses[SIP_UDP_BATCH_SIZE];
+    int fromPorts[SIP_UDP_BATCH_SIZE];
+    OsDatagramSocket* pSocket = (OsDatagramSocket*) clientSocket;
+    int numFailures = 0;
+
+    while(   !isShuttingDown()
+          && clientSocket->isOk()
+          && waitForReadyToRead())
+    {
+        int wakeupPackets = 0;
+        int numRead;
+
+        do
+        {
+            mSocketLock.acquire();
+            numRead = pSocket->readBatch(buffers, MAX_UDP_PACKET_SIZE,
+                                         SIP_UDP_BATCH_SIZE, packetLengths,
+                                         fromAddresses, fromPorts);
+            mSocketLock.release();
+
+            UtlBoolean touched = FALSE;
+            for (int i = 0; i < numRead; i++)
+            {
+                // STUN and TURN packets come back with no data
+                if (packetLengths[i] <= 0)
+                {
+                    continue;
+                }
+                wakeupPackets++;
+
+                // Stamp the read time before dispatching, as the
+                // single-read path does.
+                if (!touched)
+                {
+                    touch();
+                    touched = TRUE;
+                }
+
+                if (sipUserAgent)
+                {
+                    const char* packet = buffers + i * MAX_UDP_PACKET_SIZE;
+                    SipMessage* message = new SipMessage(packet, packetLengths[i]);
+                    message->setFromThisSide(false);
+                    message->replaceShortFieldNames();
+                    dispatchMessage(message, packet, packetLengths[i],
+                                    fromAddresses[i], fromPorts[i]);
+                }
+            }
+        } while (numRead == SIP_UDP_BATCH_SIZE && !isShuttingDown());
+
+        if (numRead < 0)
+        {
+            numFailures++;
+            if (numFailures > 12 || !clientSocket->isOk())
+            {
+                OsSysLog::add(FAC_SIP, PRI_ERR,
+                              "SipClient::runBatchReads %p shutting down, "
+                              "reading socket %d failed",
+                              this, clientSocket->getSocketDescriptor());
+                clientSocket->close();
+                break;
+            }
+        }
+        else
+        {
+            numFailures = 0;
+        }
+
+        if (wakeupPackets > 0)
+        {
+            mBatchWakeups++;
+            mBatchPackets += wakeupPackets;
+            if (wakeupPackets > mBatchMaxPackets)
+            {
+                mBatchMaxPackets = wakeupPackets;
+            }
+        }
+    }
+
+    free(buffers);
+    return(TRUE);
+}
+#endif // SIP_UDP_BATCH_READS ]
+
+// Log and dispatch a message read from the socket to the user agent.
+// Takes ownership of the message.
+void SipClient::dispatchMessage(SipMessage* message,
+                                const char* messageBytes,
+                                int messageLength,
+                                const UtlString& fromIpAddress,
+                                int fromPort)
+{
+    UtlString socketRemoteHost;
+    UtlString lastAddress;
+    UtlString lastProtocol;
+    int lastPort;
+
+    // Only bother processing if the logs are enabled
+    if (sipUserAgent->isMessageLoggingEnabled() ||
+            OsSysLog::willLog(FAC_SIP_INCOMING, PRI_INFO))
+    {
+       UtlString logMessage;
+       logMessage.append("Read SIP message:\n");
+       logMessage.append("----Remote Host:");
+       logMessage.append(fromIpAddress);
+       logMessage.append("---- Port: ");
+       char buff[10];
+       sprintf(buff, "%d",
+               !portIsValid(fromPort) ? 5060 : fromPort);
+       logMessage.append(buff);
+       logMessage.append("----\n");
+
+       logMessage.append(messageBytes, messageLength);
+       UtlString messageString;
+       logMessage.append(messageString);
+       logMessage.append("====================END====================\n");
+
+       sipUserAgent->logMessage(logMessage.data(), logMessage.length());
+       OsSysLog::add(FAC_SIP_INCOMING, PRI_INFO, "%s", logMessage.data());
+    }
+
+#ifdef DEBUG_POLL_NO_BYTES
+    OsSysLog::add(FAC_SIP, PRI_DEBUG, "SipClient line: %d", __LINE__);
+#endif
+    // Set the date field if not present
+    long epochDate;
+    if(!message->getDateField(&epochDate))
+    {
+        message->setDateField();
+    }
+
+#ifdef DEBUG_POLL_NO_BYTES
+    OsSysLog::add(FAC_SIP, PRI_DEBUG, "SipClient line: %d", __LINE__);
+#endif
+    message->setSendProtocol(mSocketType);
+    message->setTransportTime(touchedTime);
+    clientSocket->getRemoteHostIp(&socketRemoteHost);
+
+    // Keep track of where this message came from
+    message->setSendAddress(fromIpAddress.data(), fromPort);
+    
+    // Keep track of the interface on which this message was
+    // received.               
+    message->setLocalIp(clientSocket->getLocalIp());
+
+    if(mReceivedAddress.isNull())
+    {
+        mReceivedAddress = fromIpAddress;
+        mRemoteReceivedPort = fromPort;
+    }
+
+#ifdef DEBUG_POLL_NO_BYTES
+    OsSysLog::add(FAC_SIP, PRI_DEBUG, "SipClient line: %d", __LINE__);
+#endif
+    // If this is a request
+    if(!message->isResponse())
+    {
+       int receivedPort;
+       UtlBoolean receivedSet;
+       UtlBoolean maddrSet;
+       UtlBoolean receivedPortSet;
+
+       // fill in 'received' and 'rport' in top via if needed.
+       message->setReceivedViaParams(fromIpAddress, fromPort);
+
+       // get the addresses from the topmost via.
+       message->getLastVia(&lastAddress, &lastPort, &lastProtocol,
+                           &receivedPort, &receivedSet, &maddrSet,
+                           &receivedPortSet);
+
+        if (   (   mSocketType == OsSocket::TCP
+                || mSocketType == OsSocket::SSL_SOCKET
+                )
+            && !receivedPortSet
+            )
+        {
+            // we can use this socket as if it were
+            // connected to the port specified in the
+            // via field
+            mRemoteReceivedPort = lastPort;
+        }
+
+        // Keep track of the address the other
+        // side said they sent from.  Note, this cannot
+        // be trusted unless this transaction is
+        // authenticated
+        if(mRemoteViaAddress.isNull())
+        {
+            mRemoteViaAddress = lastAddress;
+            mRemoteViaPort = portIsValid(lastPort) ? lastPort : 5060;
+        }
+    }
+
+    // Check that we have the minimum data to define a transaction
+    UtlString callId;
+    UtlString fromField;
+    UtlString toField;
+    message->getCallIdField(&callId);
+    message->getFromField(&fromField);
+    message->getToField(&toField);
+#ifdef DEBUG_POLL_NO_BYTES
+    OsSysLog::add(FAC_SIP, PRI_DEBUG, "SipClient line: %d", __LINE__);
+    OsSysLog::flush();
+#endif
+    if(!(   callId.isNull()
+         || fromField.isNull()
+         || toField.isNull()))
+    {
+#ifdef DEBUG_POLL_NO_BYTES
+        OsSysLog::add(FAC_SIP, PRI_DEBUG, "SipClient line: %d", __LINE__);
+        OsSysLog::flush();
+#endif
+        sipUserAgent->dispatch(message);
+#ifdef DEBUG_POLL_NO_BYTES
+        OsSysLog::add(FAC_SIP, PRI_DEBUG, "SipClient line: %d", __LINE__);
+        OsSysLog::flush();
+#endif
+    }
+    else
+    {
+#ifdef DEBUG_POLL_NO_BYTES
+        OsSysLog::add(FAC_SIP, PRI_DEBUG, "SipClient line: %d", __LINE__);
+        OsSysLog::flush();
+#endif
+       // Only bother processing if the logs are enabled
+       if (sipUserAgent->isMessageLoggingEnabled())
+       {
+          UtlString msgBytes;
+                    int msgLen;
+                    message->getBytes(&msgBytes, &msgLen);
+                    msgBytes.insert(0, "Received incomplete message (missing To, From or Call-Id header)\n");
+                    msgBytes.append("++++++++++++++++++++END++++++++++++++++++++\n");
+                    sipUserAgent->logMessage(msgBytes.data(), msgBytes.length());
+       }
+#ifdef DEBUG_POLL_NO_BYTES
+        OsSysLog::add(FAC_SIP, PRI_DEBUG, "SipClient line: %d", __LINE__);
+        OsSysLog::flush();
+#endif
+
+       delete message;
+       message = NULL;
+    }
+}
+
+#ifdef SIP_TCP_USE_REACTOR // [
+// Read what has arrived on the socket without blocking and dispatch the
+// complete messages.  Called by the reactor I/O thread serving this client.
+UtlBoolean SipClient::readAvailable()
+{
+    char readBuffer[HTTP_DEFAULT_SOCKET_BUFFER_SIZE];
+    int socketDescriptor = clientSocket->getSocketDescriptor();
+    UtlBoolean connectionOk = TRUE;
+    int bytesTotal = 0;
+
+    // Level-triggered, so stopping at the quota only defers the rest of
+    // the data to the next pass over the ready sockets.
+    while (bytesTotal < SIP_CLIENT_REACTOR_READ_QUOTA)
+    {
+        ssize_t bytesRead = ::recv(socketDescriptor, readBuffer,
+                                   sizeof(readBuffer), MSG_DONTWAIT);
+        if (bytesRead > 0)
+        {
+            mReadBuffer.append(readBuffer, bytesRead);
+            bytesTotal += bytesRead;
+        }
+        else if (bytesRead < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        else
+        {
+            if (bytesRead == 0 ||
+                (errno != EAGAIN && errno != EWOULDBLOCK))
+            {
+                // Closed by the other side, or failed
+                connectionOk = FALSE;
+            }
+            break;
+        }
+    }
+
+    if (bytesTotal > 0)
+    {
+        touch();
+    }
+
+    // Frame and dispatch each complete message in the buffer
+    while (mReadBuffer.length() > 0)
+    {
+        // Skip CRLF keep-alives (RFC 5626) between messages
+        size_t skip = 0;
+        while (skip < mReadBuffer.length() &&
+               (mReadBuffer(skip) == '\r' || mReadBuffer(skip) == '\n'))
+        {
+            skip++;
+        }
+        if (skip > 0)
+        {
+            mReadBuffer.remove(0, skip);
+            continue;
+        }
+
+        int headerLength;
+        int contentLength;
+        UtlBoolean wholeMessage =
+           HttpMessage::isWholeMessage(mReadBuffer.data(),
+                                       mReadBuffer.length(),
+                                       headerLength, contentLength);
+        // Check the limits before framing, so that a huge Content-Length
+        // can never be used as a message length.
+        if (   !wholeMessage
+            || contentLength > SIP_CLIENT_MAX_CONTENT_LENGTH)
+        {
+            if (   (headerLength < 0
+                    && mReadBuffer.length() > SIP_CLIENT_MAX_HEADER_SIZE)
+                || contentLength > SIP_CLIENT_MAX_CONTENT_LENGTH)
+            {
+                // Shut it all down, because it may be an abusive sender.
+                OsSysLog::add(FAC_SIP, PRI_WARNING,
+                              "SipClient::readAvailable %p dropping %s connection "
+                              "from %s:%d, message too big (%d bytes buffered, "
+                              "Content-Length %d)",
+                              this, OsSocket::ipProtocolString(mSocketType),
+                              mRemoteSocketAddress.data(), mRemoteHostPort,
+                              (int) mReadBuffer.length(), contentLength);
+                mReadBuffer.remove(0);
+                connectionOk = FALSE;
+            }
+            break;
+        }
+
+        int messageLength = headerLength + contentLength;
+        SipMessage* message = new SipMessage(mReadBuffer.data(), messageLength);
+        message->setFromThisSide(false);
+        message->replaceShortFieldNames();
+
+        if (sipUserAgent)
+        {
+            dispatchMessage(message, mReadBuffer.data(), messageLength,
+                            mRemoteSocketAddress, mRemoteHostPort);
+        }
+        else
+        {
+            delete message;
+        }
+        mReadBuffer.remove(0, messageLength);
+    }
+
+    return(connectionOk);
+}
+#endif // SIP_TCP_USE_REACTOR ]
+
 // Test whether the socket is ready to read. (Does not block.)
 UtlBoolean SipClient::isReadyToRead()
 {
@@ -876,6 +1134,22 @@ int SipClient::isInUseForWrite(void)
 
 /* ============================ INQUIRY =================================== */
 
+UtlBoolean SipClient::isReadByCurrentTask()
+{
+    OsTask* pCallingTask = OsTask::getCurrentTask();
+
+#ifdef SIP_TCP_USE_REACTOR // [
+    if (mpReactorTask)
+    {
+        // Only the reactor thread can be inside readAvailable() for us.
+        return(   mReactorBusy > 0
+               && pCallingTask == (OsTask*) mpReactorTask);
+    }
+#endif // SIP_TCP_USE_REACTOR ]
+
+    return(pCallingTask == this);
+}
+
 UtlBoolean SipClient::isOk()
 {
         return(clientSocket->isOk() && !isShuttingDown());
@@ -926,6 +1200,14 @@ void SipClient::markAvailbleForWrite()
     signalNextAvailableForWrite();
 }
 
+void SipClient::getBatchReadStats(long& wakeups, long& packets,
+                                  int& maxPackets) const
+{
+    wakeups = mBatchWakeups;
+    packets = mBatchPackets;
+    maxPackets = mBatchMaxPackets;
+}
+
 const UtlString& SipClient::getLocalIp()
 {
     return clientSocket->getLocalIp();
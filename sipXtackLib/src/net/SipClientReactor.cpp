@@ -0,0 +1,333 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+
+// SYSTEM INCLUDES
+#include <os/OsIntTypes.h>
+#include <assert.h>
+
+// APPLICATION INCLUDES
+#include <net/SipClientReactor.h>
+
+#ifdef SIP_TCP_USE_REACTOR // [
+
+#include <sys/epoll.h>
+#include <unistd.h>
+#include <errno.h>
+#include <limits.h>
+#include <string.h>
+
+#include <net/SipClient.h>
+#include <os/OsCSem.h>
+#include <os/OsLock.h>
+#include <os/OsSysLog.h>
+#include <utl/UtlLongLongInt.h>
+#include <utl/UtlVoidPtr.h>
+
+// EXTERNAL FUNCTIONS
+// EXTERNAL VARIABLES
+// CONSTANTS
+// Time an I/O thread waits for events before checking for shutdown
+#define SIP_CLIENT_REACTOR_WAIT_MSECS 200
+
+// STATIC VARIABLE INITIALIZATIONS
+
+//:One I/O thread of a SipClientReactor and the clients assigned to it
+class SipClientReactorTask : public OsTask
+{
+public:
+    SipClientReactorTask(const char* name);
+    ~SipClientReactorTask();
+
+    virtual int run(void* pArg);
+
+    UtlBoolean addClient(SipClient* client);
+    void removeClient(SipClient* client);
+    int getClientCount();
+
+private:
+    // Take the client out of the epoll set and the client map.
+    // mLock must be held.
+    void unregister(SipClient* client);
+
+    // Let the client read and handle its socket being ready
+    void serveClient(int64_t clientId);
+
+    int mEpollFd;
+    OsMutex mLock;       // Protects mClients and the reactor state of the clients
+    UtlHashMap mClients; // UtlLongLongInt id -> UtlVoidPtr(SipClient*)
+    int64_t mLastId;
+    OsCSem mReadDoneSem; // Released for each removeClient() waiting on a read
+    int mRemoveWaiters;  // Tasks waiting on mReadDoneSem, protected by mLock
+};
+
+SipClientReactorTask::SipClientReactorTask(const char* name)
+: OsTask(name)
+, mEpollFd(-1)
+, mLock(OsMutex::Q_FIFO)
+, mLastId(0)
+, mReadDoneSem(OsCSem::Q_FIFO, INT_MAX, 0)
+, mRemoveWaiters(0)
+{
+    mEpollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (mEpollFd < 0)
+    {
+        OsSysLog::add(FAC_SIP, PRI_ERR,
+                      "SipClientReactorTask epoll_create1 failed, errno: %d",
+                      errno);
+    }
+}
+
+SipClientReactorTask::~SipClientReactorTask()
+{
+    waitUntilShutDown();
+
+    if (mClients.entries() > 0)
+    {
+        OsSysLog::add(FAC_SIP, PRI_WARNING,
+                      "SipClientReactorTask::~ %d clients still registered",
+                      (int) mClients.entries());
+    }
+    mClients.destroyAll();
+
+    if (mEpollFd >= 0)
+    {
+        ::close(mEpollFd);
+    }
+}
+
+int SipClientReactorTask::run(void*)
+{
+    struct epoll_event events[SIP_CLIENT_REACTOR_EVENTS];
+
+    while (!isShuttingDown() && mEpollFd >= 0)
+    {
+        int numEvents = epoll_wait(mEpollFd, events, SIP_CLIENT_REACTOR_EVENTS,
+                                   SIP_CLIENT_REACTOR_WAIT_MSECS);
+        if (numEvents < 0)
+        {
+            if (errno != EINTR)
+            {
+                OsSysLog::add(FAC_SIP, PRI_ERR,
+                              "SipClientReactorTask::run epoll_wait failed, errno: %d",
+                              errno);
+                delay(SIP_CLIENT_REACTOR_WAIT_MSECS);
+            }
+            continue;
+        }
+
+        for (int i = 0; i < numEvents; i++)
+        {
+            serveClient((int64_t) events[i].data.u64);
+        }
+    }
+
+    return 0;
+}
+
+void SipClientReactorTask::serveClient(int64_t clientId)
+{
+    SipClient* client = NULL;
+
+    // Look the client up by id rather than by pointer: it may have been
+    // removed, and even deleted, after epoll_wait() returned its event.
+    {
+        OsLock lock(mLock);
+        UtlLongLongInt key(clientId);
+        UtlVoidPtr* clientContainer = (UtlVoidPtr*) mClients.findValue(&key);
+        if (clientContainer == NULL)
+        {
+            return;
+        }
+        client = (SipClient*) clientContainer->getValue();
+        client->mReactorBusy++;
+    }
+
+    // Do not hold the lock while reading: dispatching the messages may take
+    // locks that a task removing one of our clients is holding.
+    UtlBoolean connectionOk = client->readAvailable();
+
+    OsLock lock(mLock);
+    client->mReactorBusy--;
+
+    // Only one client is read at a time, so whoever waits is waiting for us.
+    while (mRemoveWaiters > 0)
+    {
+        mRemoveWaiters--;
+        mReadDoneSem.release();
+    }
+
+    if (!connectionOk && client->mReactorId != 0)
+    {
+        OsSysLog::add(FAC_SIP, PRI_DEBUG,
+                      "SipClientReactorTask::serveClient closing client %p socket %d",
+                      client, client->clientSocket->getSocketDescriptor());
+
+        // Unregister before closing, as the descriptor may be reused
+        // as soon as it is closed.  The client is deleted later by
+        // SipProtocolServerBase::removeOldClients() as it is not ok.
+        unregister(client);
+        client->clientSocket->close();
+    }
+}
+
+UtlBoolean SipClientReactorTask::addClient(SipClient* client)
+{
+    OsLock lock(mLock);
+
+    int64_t clientId = ++mLastId;
+    struct epoll_event event;
+    memset(&event, 0, sizeof(event));
+    event.events = EPOLLIN | EPOLLRDHUP;
+    event.data.u64 = (uint64_t) clientId;
+
+    mClients.insertKeyAndValue(new UtlLongLongInt(clientId),
+                               new UtlVoidPtr(client));
+    client->mpReactorTask = this;
+    client->mReactorId = clientId;
+
+    if (epoll_ctl(mEpollFd, EPOLL_CTL_ADD,
+                  client->clientSocket->getSocketDescriptor(), &event) != 0)
+    {
+        OsSysLog::add(FAC_SIP, PRI_ERR,
+                      "SipClientReactorTask::addClient epoll_ctl failed for socket %d, errno: %d",
+                      client->clientSocket->getSocketDescriptor(), errno);
+        UtlLongLongInt key(clientId);
+        mClients.destroy(&key);
+        client->mpReactorTask = NULL;
+        client->mReactorId = 0;
+        return FALSE;
+    }
+
+    return TRUE;
+}
+
+void SipClientReactorTask::removeClient(SipClient* client)
+{
+    mLock.acquire();
+    if (client->mReactorId != 0)
+    {
+        unregister(client);
+    }
+
+    // Wait for a read in progress to finish.  No new read can start,
+    // as the client is no longer in mClients.
+    while (client->mReactorBusy > 0)
+    {
+        mRemoveWaiters++;
+        mLock.release();
+        mReadDoneSem.acquire();
+        mLock.acquire();
+    }
+    client->mpReactorTask = NULL;
+    mLock.release();
+}
+
+int SipClientReactorTask::getClientCount()
+{
+    OsLock lock(mLock);
+    return(mClients.entries());
+}
+
+void SipClientReactorTask::unregister(SipClient* client)
+{
+    epoll_ctl(mEpollFd, EPOLL_CTL_DEL,
+              client->clientSocket->getSocketDescriptor(), NULL);
+
+    UtlLongLongInt key(client->mReactorId);
+    mClients.destroy(&key);
+    client->mReactorId = 0;
+}
+
+/* //////////////////////////// PUBLIC //////////////////////////////////// */
+
+/* ============================ CREATORS ================================== */
+
+// Constructor
+SipClientReactor::SipClientReactor(const char* name, int numThreads)
+: mNumThreads(numThreads > 0 ? numThreads : 1)
+, mpTasks(NULL)
+, mNextTask(0)
+{
+    UtlString taskName(name);
+    taskName.append("-%d");
+
+    mpTasks = new SipClientReactorTask*[mNumThreads];
+    for (int i = 0; i < mNumThreads; i++)
+    {
+        mpTasks[i] = new SipClientReactorTask(taskName);
+        UtlBoolean started = mpTasks[i]->start();
+        assert(started);
+    }
+}
+
+// Destructor
+SipClientReactor::~SipClientReactor()
+{
+    for (int i = 0; i < mNumThreads; i++)
+    {
+        mpTasks[i]->requestShutdown();
+    }
+    for (int i = 0; i < mNumThreads; i++)
+    {
+        delete mpTasks[i];
+    }
+    delete[] mpTasks;
+}
+
+/* ============================ MANIPULATORS ============================== */
+
+UtlBoolean SipClientReactor::addClient(SipClient* client)
+{
+    assert(client->mpReactor == NULL);
+
+    // Spread the clients over the I/O threads.  Clients may be added by
+    // several tasks at once; a race here only unbalances the threads.
+    SipClientReactorTask* pTask = mpTasks[mNextTask];
+    mNextTask = (mNextTask + 1) % mNumThreads;
+
+    UtlBoolean added = pTask->addClient(client);
+    if (added)
+    {
+        client->mpReactor = this;
+    }
+
+    return(added);
+}
+
+void SipClientReactor::removeClient(SipClient* client)
+{
+    SipClientReactorTask* pTask = client->mpReactorTask;
+    if (pTask)
+    {
+        pTask->removeClient(client);
+    }
+    client->mpReactor = NULL;
+}
+
+/* ============================ ACCESSORS ================================= */
+
+int SipClientReactor::getClientCount()
+{
+    int numClients = 0;
+    for (int i = 0; i < mNumThreads; i++)
+    {
+        numClients += mpTasks[i]->getClientCount();
+    }
+
+    return(numClients);
+}
+
+/* ============================ INQUIRY =================================== */
+
+/* //////////////////////////// PROTECTED ///////////////////////////////// */
+
+/* //////////////////////////// PRIVATE /////////////////////////////////// */
+
+/* ============================ FUNCTIONS ================================= */
+
+#endif // SIP_TCP_USE_REACTOR ]
@@ -206,6 +206,7 @@ void SipMessage::replaceShortFieldNames()
       {
          // There is a long form for this name, so replace it.
          mHeaderCacheClean = FALSE;
+         invalidateHeaderIndex();
          NameValuePair* modified;
 
          /*
@@ -233,6 +234,7 @@ void SipMessage::replaceLongFieldNames()
       if(getShortName(nvPair->data(), &shortName))
       {
          mHeaderCacheClean = FALSE;
+         invalidateHeaderIndex();
          nvPair->remove(0);
          nvPair->append(shortName.data());
       }
@@ -2122,6 +2124,7 @@ void SipMessage::addVia(const char* domainName,
 void SipMessage::addViaField(const char* viaField, UtlBoolean afterOtherVias)
 {
     mHeaderCacheClean = FALSE;
+    invalidateHeaderIndex();
 
    NameValuePair* nv = new NameValuePair(SIP_VIA_FIELD, viaField);
     // Look for other via fields
@@ -2147,6 +2150,7 @@ void SipMessage::addViaField(const char* viaField, UtlBoolean afterOtherVias)
     }
 
     mHeaderCacheClean = FALSE;
+    invalidateHeaderIndex();
 
     if(fieldIndex == UTL_NOT_FOUND || !afterOtherVias)
     {
@@ -3099,6 +3103,7 @@ UtlBoolean SipMessage::removeLastVia()
    if(nv)
    {
         mHeaderCacheClean = FALSE;
+        invalidateHeaderIndex();
       mNameValues.destroy(nv);
       nv = NULL;
       fieldFound = TRUE;
@@ -3718,6 +3723,7 @@ void SipMessage::addRecordRouteUri(const char* recordRouteUri)
         recordRouteUriString.data());
 
     mHeaderCacheClean = FALSE;
+    invalidateHeaderIndex();
    mNameValues.insertAt(0, headerField);
 }
 
@@ -4481,6 +4487,7 @@ void SipMessage::addDiversionField(const char* diversionField, UtlBoolean afterO
     if(NULL != diversionField)
     {
        mHeaderCacheClean = FALSE;
+       invalidateHeaderIndex();
 
        NameValuePair* nv = new NameValuePair(SIP_DIVERSION_FIELD, diversionField);
        // Look for other diversion fields
@@ -4501,6 +4508,7 @@ void SipMessage::addDiversionField(const char* diversionField, UtlBoolean afterO
 #  endif
 
     mHeaderCacheClean = FALSE;
+    invalidateHeaderIndex();
 
     if(fieldIndex == UTL_NOT_FOUND || afterOtherDiversions)
     {
@@ -0,0 +1,777 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+
+// SYSTEM INCLUDES
+#include <string.h>
+#include <ctype.h>
+
+// APPLICATION INCLUDES
+#include <net/SipMessageView.h>
+#include <net/SipMessage.h>
+
+// EXTERNAL FUNCTIONS
+// EXTERNAL VARIABLES
+// CONSTANTS
+
+// Header names which are compared by id instead of by text.  The SIP
+// headers with a compact form have it in mShortName, the others are
+// here because the stack looks them up for nearly every message.
+#define KNOWN_NAME(longName, shortName) { longName, sizeof(longName) - 1, shortName }
+static const struct
+{
+   const char* mLongName;
+   int mLongLength;
+   const char* mShortName;
+} sKnownNames[] =
+{
+   KNOWN_NAME(SIP_VIA_FIELD, SIP_SHORT_VIA_FIELD),
+   KNOWN_NAME(SIP_CALLID_FIELD, SIP_SHORT_CALLID_FIELD),
+   KNOWN_NAME(SIP_CSEQ_FIELD, NULL),
+   KNOWN_NAME(SIP_FROM_FIELD, SIP_SHORT_FROM_FIELD),
+   KNOWN_NAME(SIP_TO_FIELD, SIP_SHORT_TO_FIELD),
+   KNOWN_NAME(SIP_CONTACT_FIELD, SIP_SHORT_CONTACT_FIELD),
+   KNOWN_NAME(SIP_CONTENT_LENGTH_FIELD, SIP_SHORT_CONTENT_LENGTH_FIELD),
+   KNOWN_NAME(SIP_CONTENT_TYPE_FIELD, SIP_SHORT_CONTENT_TYPE_FIELD),
+   KNOWN_NAME(SIP_CONTENT_ENCODING_FIELD, SIP_SHORT_CONTENT_ENCODING_FIELD),
+   KNOWN_NAME(SIP_EVENT_FIELD, SIP_SHORT_EVENT_FIELD),
+   KNOWN_NAME(SIP_SUPPORTED_FIELD, SIP_SHORT_SUPPORTED_FIELD),
+   KNOWN_NAME(SIP_SUBJECT_FIELD, SIP_SHORT_SUBJECT_FIELD),
+   KNOWN_NAME(SIP_REFER_TO_FIELD, SIP_SHORT_REFER_TO_FIELD),
+   KNOWN_NAME(SIP_REFERRED_BY_FIELD, SIP_SHORT_REFERRED_BY_FIELD),
+   KNOWN_NAME(SIP_ROUTE_FIELD, NULL),
+   KNOWN_NAME(SIP_RECORD_ROUTE_FIELD, NULL),
+   KNOWN_NAME(SIP_MAX_FORWARDS_FIELD, NULL),
+   KNOWN_NAME(SIP_EXPIRES_FIELD, NULL)
+};
+#define NUM_KNOWN_NAMES ((int)(sizeof(sKnownNames)/sizeof(sKnownNames[0])))
+
+// STATIC VARIABLE INITIALIZATIONS
+
+/* ============================ FUNCTIONS ================================= */
+
+static inline UtlBoolean isWhiteSpace(char c)
+{
+   return(c == ' ' || c == '\t' || c == '\r' || c == '\n');
+}
+
+// Find the next sub-field of a value, starting at position.  Commas in
+// quoted strings and in <> do not separate sub-fields.  Empty sub-fields
+// are skipped.
+static UtlBoolean nextSubfield(const char* value, int valueLength,
+                               int& position,
+                               SipMessageView::Span& subfield)
+{
+   while (position < valueLength)
+   {
+      int start = position;
+      UtlBoolean inQuotes = FALSE;
+      UtlBoolean inAngles = FALSE;
+      for (; position < valueLength; position++)
+      {
+         char c = value[position];
+         if (inQuotes)
+         {
+            if (c == '\\' && position + 1 < valueLength)
+            {
+               position++;
+            }
+            else if (c == '"')
+            {
+               inQuotes = FALSE;
+            }
+         }
+         else if (c == '"')
+         {
+            inQuotes = TRUE;
+         }
+         else if (c == '<')
+         {
+            inAngles = TRUE;
+         }
+         else if (c == '>')
+         {
+            inAngles = FALSE;
+         }
+         else if (c == ',' && !inAngles)
+         {
+            break;
+         }
+      }
+
+      int end = position;
+      if (position < valueLength)
+      {
+         // Skip the comma
+         position++;
+      }
+
+      while (start < end && isWhiteSpace(value[start]))
+      {
+         start++;
+      }
+      while (end > start && isWhiteSpace(value[end - 1]))
+      {
+         end--;
+      }
+
+      if (end > start)
+      {
+         subfield.mpStart = &value[start];
+         subfield.mLength = end - start;
+         return(TRUE);
+      }
+   }
+
+   return(FALSE);
+}
+
+/* //////////////////////////// PUBLIC //////////////////////////////////// */
+
+/* ============================ CREATORS ================================== */
+
+UtlBoolean SipMessageView::Span::equals(const char* text) const
+{
+   return((int)strlen(text) == mLength &&
+          strncmp(mpStart, text, mLength) == 0);
+}
+
+UtlBoolean SipMessageView::Span::equalsIgnoreCase(const char* text) const
+{
+   return((int)strlen(text) == mLength &&
+          strncasecmp(mpStart, text, mLength) == 0);
+}
+
+void SipMessageView::Span::toString(UtlString& text) const
+{
+   text.remove(0);
+   if (mLength > 0)
+   {
+      text.append(mpStart, mLength);
+   }
+}
+
+// Constructor
+SipMessageView::SipMessageView()
+: mpMessage("")
+, mMessageLength(0)
+, mFirstLineLength(0)
+, mHeaderLength(0)
+, mValid(FALSE)
+, mpFields(mInlineFields)
+, mFieldCapacity(SIP_MESSAGE_VIEW_INLINE_FIELDS)
+, mNumFields(0)
+{
+}
+
+SipMessageView::SipMessageView(const char* messageBytes, int byteCount)
+: mpMessage("")
+, mMessageLength(0)
+, mFirstLineLength(0)
+, mHeaderLength(0)
+, mValid(FALSE)
+, mpFields(mInlineFields)
+, mFieldCapacity(SIP_MESSAGE_VIEW_INLINE_FIELDS)
+, mNumFields(0)
+{
+   parse(messageBytes, byteCount);
+}
+
+// Destructor
+SipMessageView::~SipMessageView()
+{
+   if (mpFields != mInlineFields)
+   {
+      delete[] mpFields;
+   }
+}
+
+/* ============================ MANIPULATORS ============================== */
+
+UtlBoolean SipMessageView::parse(const char* messageBytes, int byteCount)
+{
+   mpMessage = messageBytes ? messageBytes : "";
+   mMessageLength = byteCount > 0 ? byteCount : 0;
+   const char* nullChar = (const char*) memchr(mpMessage, '\0', mMessageLength);
+   if (nullChar)
+   {
+      mMessageLength = nullChar - mpMessage;
+   }
+   mFirstLineLength = 0;
+   mHeaderLength = mMessageLength;
+   mValid = FALSE;
+   mNumFields = 0;
+
+   const char* message = mpMessage;
+   int position = 0;
+   UtlBoolean firstLine = TRUE;
+
+   while (position < mMessageLength)
+   {
+      // Find the end of the line and the start of the next one
+      const char* lineFeed = (const char*) memchr(&message[position], '\n',
+                                                  mMessageLength - position);
+      int lineEnd = lineFeed ? lineFeed - message : mMessageLength;
+      int nextLine = lineFeed ? lineEnd + 1 : mMessageLength;
+      if (lineEnd > position && message[lineEnd - 1] == '\r')
+      {
+         lineEnd--;
+      }
+
+      if (firstLine)
+      {
+         mFirstLineLength = lineEnd - position;
+         firstLine = FALSE;
+      }
+
+      // An empty line ends the header
+      else if (lineEnd == position)
+      {
+         mHeaderLength = nextLine;
+         mValid = mFirstLineLength > 0;
+         break;
+      }
+
+      // A continuation line extends the value of the previous field
+      else if ((message[position] == ' ' || message[position] == '\t') &&
+               mNumFields > 0)
+      {
+         FieldSpan& previous = mpFields[mNumFields - 1];
+         int valueEnd = lineEnd;
+         while (valueEnd > position && isWhiteSpace(message[valueEnd - 1]))
+         {
+            valueEnd--;
+         }
+         if (valueEnd > position)
+         {
+            if (previous.mValueLength == 0)
+            {
+               int valueStart = position;
+               while (isWhiteSpace(message[valueStart]))
+               {
+                  valueStart++;
+               }
+               previous.mValueStart = valueStart;
+            }
+            previous.mValueLength = valueEnd - previous.mValueStart;
+         }
+      }
+
+      // A header field.  As for HttpMessage, a line without a colon is a
+      // field with an empty value.
+      else
+      {
+         const char* colon = (const char*) memchr(&message[position], ':',
+                                                  lineEnd - position);
+         int nameStart = position;
+         int nameEnd = colon ? colon - message : lineEnd;
+         int valueStart = colon ? nameEnd + 1 : lineEnd;
+         int valueEnd = lineEnd;
+
+         while (nameStart < nameEnd && isWhiteSpace(message[nameStart]))
+         {
+            nameStart++;
+         }
+         while (nameEnd > nameStart && isWhiteSpace(message[nameEnd - 1]))
+         {
+            nameEnd--;
+         }
+         while (valueStart < valueEnd && isWhiteSpace(message[valueStart]))
+         {
+            valueStart++;
+         }
+         while (valueEnd > valueStart && isWhiteSpace(message[valueEnd - 1]))
+         {
+            valueEnd--;
+         }
+
+         FieldSpan field;
+         field.mNameStart = nameStart;
+         field.mNameLength = nameEnd - nameStart;
+         field.mValueStart = valueStart;
+         field.mValueLength = valueEnd - valueStart;
+         field.mNameId = getKnownNameId(&message[nameStart],
+                                        field.mNameLength);
+         addField(field);
+      }
+
+      position = nextLine;
+   }
+
+   return(mValid);
+}
+
+/* ============================ ACCESSORS ================================= */
+
+int SipMessageView::getHeaderLength() const
+{
+   return(mHeaderLength);
+}
+
+int SipMessageView::getContentLength() const
+{
+   Span value;
+   if (!getHeaderValue(0, SIP_CONTENT_LENGTH_FIELD, value) ||
+       value.isNull() || !isdigit(value.mpStart[0]))
+   {
+      return(-1);
+   }
+
+   int contentLength = 0;
+   for (int i = 0; i < value.mLength && isdigit(value.mpStart[i]); i++)
+   {
+      contentLength = contentLength * 10 + (value.mpStart[i] - '0');
+   }
+
+   return(contentLength);
+}
+
+SipMessageView::Span SipMessageView::getBody() const
+{
+   Span body;
+   body.mpStart = &mpMessage[mHeaderLength];
+   body.mLength = 0;
+
+   if (mValid)
+   {
+      body.mLength = mMessageLength - mHeaderLength;
+      int contentLength = getContentLength();
+      if (contentLength >= 0 && contentLength < body.mLength)
+      {
+         body.mLength = contentLength;
+      }
+   }
+
+   return(body);
+}
+
+SipMessageView::Span SipMessageView::getFirstHeaderLinePart(int partIndex) const
+{
+   const char* line = mpMessage;
+   int position = 0;
+   Span part;
+   part.mpStart = line;
+   part.mLength = 0;
+
+   for (int index = 0; index <= partIndex && index <= 2; index++)
+   {
+      while (position < mFirstLineLength && isWhiteSpace(line[position]))
+      {
+         position++;
+      }
+
+      int start = position;
+      if (index == 2)
+      {
+         // The reason phrase is the rest of the line
+         position = mFirstLineLength;
+         while (position > start && isWhiteSpace(line[position - 1]))
+         {
+            position--;
+         }
+      }
+      else
+      {
+         while (position < mFirstLineLength && !isWhiteSpace(line[position]))
+         {
+            position++;
+         }
+      }
+
+      if (index == partIndex)
+      {
+         part.mpStart = &line[start];
+         part.mLength = position - start;
+      }
+   }
+
+   return(part);
+}
+
+int SipMessageView::getResponseStatusCode() const
+{
+   if (!isResponse())
+   {
+      return(-1);
+   }
+
+   Span code = getFirstHeaderLinePart(1);
+   int statusCode = 0;
+   for (int i = 0; i < code.mLength && isdigit(code.mpStart[i]); i++)
+   {
+      statusCode = statusCode * 10 + (code.mpStart[i] - '0');
+   }
+
+   return(statusCode);
+}
+
+int SipMessageView::getFieldCount() const
+{
+   return(mNumFields);
+}
+
+UtlBoolean SipMessageView::getField(int fieldIndex, Span& name, Span& value) const
+{
+   if (fieldIndex < 0 || fieldIndex >= mNumFields)
+   {
+      return(FALSE);
+   }
+
+   const FieldSpan& field = mpFields[fieldIndex];
+   name.mpStart = &mpMessage[field.mNameStart];
+   name.mLength = field.mNameLength;
+   value.mpStart = &mpMessage[field.mValueStart];
+   value.mLength = field.mValueLength;
+
+   return(TRUE);
+}
+
+int SipMessageView::getFieldCount(const char* name) const
+{
+   int count = 0;
+   while (findField(count, name))
+   {
+      count++;
+   }
+
+   return(count);
+}
+
+UtlBoolean SipMessageView::getHeaderValue(int index, const char* name,
+                                          Span& value) const
+{
+   const FieldSpan* field = findField(index, name);
+   if (field == NULL)
+   {
+      return(FALSE);
+   }
+
+   value.mpStart = &mpMessage[field->mValueStart];
+   value.mLength = field->mValueLength;
+
+   return(TRUE);
+}
+
+UtlBoolean SipMessageView::getHeaderValue(int index, const char* name,
+                                          UtlString& value) const
+{
+   Span valueSpan;
+   value.remove(0);
+   if (!getHeaderValue(index, name, valueSpan))
+   {
+      return(FALSE);
+   }
+
+   // Copy the value without the line ends of the continuation lines
+   int start = 0;
+   for (int i = 0; i < valueSpan.mLength; i++)
+   {
+      char c = valueSpan.mpStart[i];
+      if (c == '\r' || c == '\n')
+      {
+         value.append(&valueSpan.mpStart[start], i - start);
+         start = i + 1;
+      }
+   }
+   value.append(&valueSpan.mpStart[start], valueSpan.mLength - start);
+
+   return(TRUE);
+}
+
+UtlBoolean SipMessageView::getFieldSubfield(const char* name, int subfieldIndex,
+                                            Span& subfield) const
+{
+   int index = 0;
+   const FieldSpan* field;
+   for (int fieldIndex = 0; (field = findField(fieldIndex, name)); fieldIndex++)
+   {
+      const char* value = &mpMessage[field->mValueStart];
+      int position = 0;
+      while (nextSubfield(value, field->mValueLength, position, subfield))
+      {
+         if (index++ == subfieldIndex)
+         {
+            return(TRUE);
+         }
+      }
+   }
+
+   subfield.mpStart = mpMessage;
+   subfield.mLength = 0;
+   return(FALSE);
+}
+
+UtlBoolean SipMessageView::getHeaderParameter(const char* name,
+                                              int subfieldIndex,
+                                              const char* parameterName,
+                                              Span& parameterValue) const
+{
+   parameterValue.mpStart = mpMessage;
+   parameterValue.mLength = 0;
+
+   Span subfield;
+   if (!getFieldSubfield(name, subfieldIndex, subfield))
+   {
+      return(FALSE);
+   }
+
+   // Find the end of the name-addr or of the address, outside of quotes
+   const char* text = subfield.mpStart;
+   int length = subfield.mLength;
+   int position = 0;
+   UtlBoolean inQuotes = FALSE;
+   UtlBoolean inAngles = FALSE;
+   for (; position < length; position++)
+   {
+      char c = text[position];
+      if (inQuotes)
+      {
+         if (c == '\\' && position + 1 < length)
+         {
+            position++;
+         }
+         else if (c == '"')
+         {
+            inQuotes = FALSE;
+         }
+      }
+      else if (c == '"')
+      {
+         inQuotes = TRUE;
+      }
+      else if (c == '<')
+      {
+         inAngles = TRUE;
+      }
+      else if (c == '>')
+      {
+         inAngles = FALSE;
+      }
+      else if (c == ';' && !inAngles)
+      {
+         break;
+      }
+   }
+
+   // Look at every ';' separated parameter
+   int parameterNameLength = strlen(parameterName);
+   while (position < length)
+   {
+      // Skip the ';'
+      position++;
+
+      int nameStart = position;
+      while (position < length && text[position] != '=' && text[position] != ';')
+      {
+         position++;
+      }
+      int nameEnd = position;
+      while (nameStart < nameEnd && isWhiteSpace(text[nameStart]))
+      {
+         nameStart++;
+      }
+      while (nameEnd > nameStart && isWhiteSpace(text[nameEnd - 1]))
+      {
+         nameEnd--;
+      }
+
+      int valueStart = position;
+      int valueEnd = position;
+      if (position < length && text[position] == '=')
+      {
+         position++;
+         valueStart = position;
+         inQuotes = FALSE;
+         for (; position < length && (inQuotes || text[position] != ';'); position++)
+         {
+            if (text[position] == '\\' && inQuotes && position + 1 < length)
+            {
+               position++;
+            }
+            else if (text[position] == '"')
+            {
+               inQuotes = !inQuotes;
+            }
+         }
+         valueEnd = position;
+         while (valueStart < valueEnd && isWhiteSpace(text[valueStart]))
+         {
+            valueStart++;
+         }
+         while (valueEnd > valueStart && isWhiteSpace(text[valueEnd - 1]))
+         {
+            valueEnd--;
+         }
+      }
+
+      if (nameEnd - nameStart == parameterNameLength &&
+          strncasecmp(&text[nameStart], parameterName, parameterNameLength) == 0)
+      {
+         parameterValue.mpStart = &text[valueStart];
+         parameterValue.mLength = valueEnd - valueStart;
+         return(TRUE);
+      }
+   }
+
+   return(FALSE);
+}
+
+UtlBoolean SipMessageView::getCallIdField(Span& callId) const
+{
+   return(getHeaderValue(0, SIP_CALLID_FIELD, callId));
+}
+
+UtlBoolean SipMessageView::getCSeqField(int* sequenceNum,
+                                        Span* sequenceMethod) const
+{
+   Span value;
+   if (!getHeaderValue(0, SIP_CSEQ_FIELD, value))
+   {
+      return(FALSE);
+   }
+
+   int position = 0;
+   int number = 0;
+   while (position < value.mLength && isdigit(value.mpStart[position]))
+   {
+      number = number * 10 + (value.mpStart[position] - '0');
+      position++;
+   }
+   if (position == 0)
+   {
+      return(FALSE);
+   }
+   while (position < value.mLength && isWhiteSpace(value.mpStart[position]))
+   {
+      position++;
+   }
+   int methodStart = position;
+   while (position < value.mLength && !isWhiteSpace(value.mpStart[position]))
+   {
+      position++;
+   }
+
+   if (sequenceNum)
+   {
+      *sequenceNum = number;
+   }
+   if (sequenceMethod)
+   {
+      sequenceMethod->mpStart = &value.mpStart[methodStart];
+      sequenceMethod->mLength = position - methodStart;
+   }
+
+   return(TRUE);
+}
+
+UtlBoolean SipMessageView::getTopViaBranch(Span& branch) const
+{
+   return(getHeaderParameter(SIP_VIA_FIELD, 0, "branch", branch));
+}
+
+UtlBoolean SipMessageView::getFromTag(Span& tag) const
+{
+   return(getHeaderParameter(SIP_FROM_FIELD, 0, "tag", tag));
+}
+
+UtlBoolean SipMessageView::getToTag(Span& tag) const
+{
+   return(getHeaderParameter(SIP_TO_FIELD, 0, "tag", tag));
+}
+
+/* ============================ INQUIRY =================================== */
+
+UtlBoolean SipMessageView::isValid() const
+{
+   return(mValid);
+}
+
+UtlBoolean SipMessageView::isResponse() const
+{
+   int protocolLength = sizeof(SIP_PROTOCOL_VERSION) - 1;
+   return(mFirstLineLength >= protocolLength &&
+          strncmp(mpMessage, SIP_PROTOCOL_VERSION, protocolLength) == 0);
+}
+
+/* //////////////////////////// PROTECTED ///////////////////////////////// */
+
+int SipMessageView::getKnownNameId(const char* name, int nameLength)
+{
+   if (nameLength == 1)
+   {
+      char shortName = tolower(name[0]);
+      for (int id = 0; id < NUM_KNOWN_NAMES; id++)
+      {
+         if (sKnownNames[id].mShortName &&
+             sKnownNames[id].mShortName[0] == shortName)
+         {
+            return(id);
+         }
+      }
+   }
+   else
+   {
+      char firstChar = toupper(name[0]);
+      for (int id = 0; id < NUM_KNOWN_NAMES; id++)
+      {
+         if (sKnownNames[id].mLongLength == nameLength &&
+             sKnownNames[id].mLongName[0] == firstChar &&
+             strncasecmp(sKnownNames[id].mLongName, name, nameLength) == 0)
+         {
+            return(id);
+         }
+      }
+   }
+
+   return(-1);
+}
+
+const SipMessageView::FieldSpan* SipMessageView::findField(int index,
+                                                           const char* name) const
+{
+   int nameLength = strlen(name);
+   int nameId = getKnownNameId(name, nameLength);
+
+   for (int fieldIndex = 0; fieldIndex < mNumFields; fieldIndex++)
+   {
+      const FieldSpan& field = mpFields[fieldIndex];
+      if (nameId >= 0 ?
+          field.mNameId == nameId :
+          (field.mNameId < 0 &&
+           field.mNameLength == nameLength &&
+           strncasecmp(&mpMessage[field.mNameStart], name, nameLength) == 0))
+      {
+         if (index-- == 0)
+         {
+            return(&field);
+         }
+      }
+   }
+
+   return(NULL);
+}
+
+void SipMessageView::addField(const FieldSpan& field)
+{
+   if (mNumFields == mFieldCapacity)
+   {
+      FieldSpan* fields = new FieldSpan[mFieldCapacity * 2];
+      memcpy(fields, mpFields, mNumFields * sizeof(FieldSpan));
+      if (mpFields != mInlineFields)
+      {
+         delete[] mpFields;
+      }
+      mpFields = fields;
+      mFieldCapacity *= 2;
+   }
+
+   mpFields[mNumFields++] = field;
+}
+
+/* //////////////////////////// PRIVATE /////////////////////////////////// */
+
+/* ============================ FUNCTIONS ================================= */
@@ -36,6 +36,8 @@ SipProtocolServerBase::SipProtocolServerBase(SipUserAgent* userAgent,
                                              const char* protocolString,
                                              const char* taskName) :
      OsTask(taskName),
+     mpServerBrokerListener(NULL),
+     mpClientReactor(NULL),
      mClientLock(OsMutex::Q_FIFO)
 {
    mSipUserAgent = userAgent;
@@ -66,6 +68,13 @@ SipProtocolServerBase::~SipProtocolServerBase()
     }
     mClientList.releaseIteratorHandle(iteratorHandle);
     mClientLock.releaseWrite();
+
+#ifdef SIP_TCP_USE_REACTOR
+    // All clients are gone, so the reactor is no longer needed
+    delete mpClientReactor;
+    mpClientReactor = NULL;
+#endif
+
     mDataGuard.release();
 }
 
@@ -100,17 +109,8 @@ UtlBoolean SipProtocolServerBase::send(SipMessage* message,
         sendOk = client->sendTo(*message, hostAddress, hostPort);
         if(!sendOk)
         {
-            OsTask* pCallingTask = OsTask::getCurrentTask();
-            OsTaskId_t callingTaskId = -1;
-            OsTaskId_t clientTaskId = -1;
-
-            if ( pCallingTask )
-            {
-               pCallingTask->id(callingTaskId);
-            }
-            client->id(clientTaskId);
-
-            if (clientTaskId != callingTaskId)
+            // The task reading the client cannot delete it
+            if (!client->isReadByCurrentTask())
             {
                // Do not need to clientLock.acquireWrite();
                // as deleteClient uses the locking list lock
@@ -294,7 +294,7 @@ SipClient* SipProtocolServerBase::createClient(const char* hostAddress,
             if (clientSocket->getIpProtocol() != OsSocket::UDP)
             {
                 //osPrintf("starting client\n");
-                clientStarted = client->start();
+                clientStarted = startClient(client);
                 if(!clientStarted)
                 {
                     osPrintf("SIP %s client failed to start\n",
@@ -651,13 +651,30 @@ SipProtocolServerBase::operator=(const SipProtocolServerBase& rhs)
    return *this;
 }
 
+UtlBoolean SipProtocolServerBase::startClient(SipClient* client)
+{
+#ifdef SIP_TCP_USE_REACTOR
+    if (mpClientReactor &&
+        client->getSocketType() == OsSocket::TCP &&
+        mpClientReactor->addClient(client))
+    {
+        return(TRUE);
+    }
+#endif
+
+    return(client->start());
+}
+
 void SipProtocolServerBase::startClients()
 {
         int iteratorHandle = mClientList.getIteratorHandle();
     SipClient* client = NULL;
     while ((client = (SipClient*)mClientList.next(iteratorHandle)))
     {
-        client->start();
+        if (!client->isServedByReactor())
+        {
+            client->start();
+        }
     }
     mClientList.releaseIteratorHandle(iteratorHandle);
 }
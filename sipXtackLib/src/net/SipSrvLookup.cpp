@@ -71,6 +71,13 @@ extern struct __res_state _sip_res;
 #include <os/OsDefs.h>
 #include <os/OsSocket.h>
 #include <os/OsLock.h>
+#include <os/OsBSem.h>
+#include <os/OsDateTime.h>
+#include <os/OsPtrMsg.h>
+#include <os/OsServerTask.h>
+#include <utl/UtlHashBag.h>
+#include <utl/UtlHashBagIterator.h>
+#include <utl/UtlString.h>
 #include <net/SipSrvLookup.h>
 
 #include <os/OsSysLog.h>
@@ -82,6 +89,20 @@ extern struct __res_state _sip_res;
 // The initial value of OptionCodeCNAMELImit.
 #define DEFAULT_CNAME_LIMIT 5
 
+// The initial values of OptionCodeCacheMaxTTL and OptionCodeNegativeCacheTTL.
+#define DEFAULT_CACHE_MAX_TTL 3600
+#define DEFAULT_NEGATIVE_CACHE_TTL 60
+
+// Expired answers are removed from the cache when it has this many.
+#define DNS_CACHE_PURGE_ENTRIES 1024
+
+// The resolver of glibc keeps its state per thread, so lookups on
+// different threads can run concurrently.  The other resolvers are not
+// reentrant and all lookups are serialized on SipSrvLookup::sMutex.
+#if defined(__linux__) && !defined(ANDROID)
+#  define RESOLVER_IS_REENTRANT
+#endif
+
 // Forward references
 
 // All of these functions are made forward references here rather than
@@ -220,6 +241,32 @@ static int server_compare(const void* a, const void* b);
 
 static void sort_answers(res_response* response);
 
+/**
+ * Do a DNS query with res_query(), or with the answer in the cache.
+ * Takes the arguments of res_query(), except that the class is C_IN,
+ * and returns what it returned.
+ */
+static int cached_res_query(const char* name, int type,
+                            unsigned char* answer, int answerSize);
+
+#if !defined(ANDROID) && defined(__pingtel_on_posix__)
+/// Set the timeouts of setDnsSrvTimeouts() in _res of the calling thread.
+static void apply_dns_timeouts();
+#endif
+
+/// Do a DNS query with res_query() or the function which replaces it.
+static int do_res_query(const char* name, int type,
+                        unsigned char* answer, int answerSize);
+
+/**
+ * Number of seconds to cache the result of a DNS query, from the TTLs
+ * of its RRs, or 0 if it must not be cached.
+ */
+static long answer_ttl(int length, unsigned char* answer, int answerSize);
+
+/// Copy a list of servers returned by SipSrvLookup::servers().
+static server_t* copy_server_list(const server_t* list);
+
 static int rr_compare(const void* a, const void* b);
 
 /**
@@ -236,9 +283,185 @@ int SipSrvLookup::options[OptionCodeLast+1] = {
    0,                           // OptionCodePrintAnswers
    DEFAULT_CNAME_LIMIT,         // OptionCodeCNAMELimit
    0,                           // OptionCodeNoDefaultTCP
+   0,                           // OptionCodeIgnoreCache
+   DEFAULT_CACHE_MAX_TTL,       // OptionCodeCacheMaxTTL
+   DEFAULT_NEGATIVE_CACHE_TTL,  // OptionCodeNegativeCacheTTL
    0                            // OptionCodeLast
 };
 
+/**
+ * Answer to one DNS query in the cache, keyed by "type:name" (lower case).
+ */
+class DnsCacheEntry : public UtlString
+{
+public:
+   DnsCacheEntry(const UtlString& key) :
+      UtlString(key),
+      mpAnswer(NULL),
+      mAnswerLength(-1),
+      mExpires(0),
+      mInFlight(FALSE),
+      mWaiters(0),
+      mDone(OsBSem::Q_FIFO, OsBSem::FULL)
+   {
+   }
+
+   ~DnsCacheEntry()
+   {
+      free(mpAnswer);
+   }
+
+   unsigned char* mpAnswer;     ///< Answer, or NULL if the query failed
+   int mAnswerLength;           ///< What res_query() returned
+   long mExpires;               ///< Seconds since boot
+   UtlBoolean mInFlight;        ///< Is a thread doing the query?
+   int mWaiters;                ///< Threads waiting for mInFlight query
+   OsBSem mDone;                ///< Taken while mInFlight
+};
+
+/**
+ * The cache of DNS answers, DnsCacheEntry's.
+ * It is allocated when first used and never freed, so that it is not
+ * destroyed after the UtlContainer locks at exit.
+ */
+static UtlHashBag* spDnsCache = NULL;
+/// Protects spDnsCache and the entries in it.
+static OsMutex sDnsCacheMutex(OsMutex::Q_FIFO);
+/// Function used instead of res_query(), or NULL.
+static SipSrvLookup::ResQueryFunction sResQueryFunction = NULL;
+#if !defined(ANDROID) && defined(__pingtel_on_posix__)
+/**
+ * Timeouts set by SipSrvLookup::setDnsSrvTimeouts(), or 0 for the resolver
+ * default.  _res is per thread, so they are applied by the thread doing
+ * each query.
+ */
+static int sDnsRetrans = 0;
+static int sDnsRetry = 0;
+#endif
+
+/**
+ * A lookup queued by SipSrvLookup::serversAsync() and the callers waiting
+ * for its result, keyed by the arguments of servers().
+ */
+class SrvLookupRequest : public UtlString
+{
+public:
+   struct Waiter
+   {
+      SipSrvLookupCallback mCallback;
+      void* mUserData;
+      Waiter* mpNext;
+   };
+
+   SrvLookupRequest(const UtlString& key,
+                    const char* domain,
+                    const char* service,
+                    OsSocket::IpProtocolSocketType socketType,
+                    int port,
+                    const char* srcIp) :
+      UtlString(key),
+      mDomain(domain),
+      mService(service),
+      mSocketType(socketType),
+      mPort(port),
+      mSrcIp(srcIp ? srcIp : ""),
+      mHasSrcIp(srcIp != NULL),
+      mpWaiters(NULL)
+   {
+   }
+
+   ~SrvLookupRequest()
+   {
+      while (mpWaiters)
+      {
+         Waiter* next = mpWaiters->mpNext;
+         delete mpWaiters;
+         mpWaiters = next;
+      }
+   }
+
+   /// Add a caller to the end of the list of waiters.
+   void addWaiter(SipSrvLookupCallback callback, void* userData)
+   {
+      Waiter* waiter = new Waiter;
+      waiter->mCallback = callback;
+      waiter->mUserData = userData;
+      waiter->mpNext = NULL;
+
+      Waiter** last = &mpWaiters;
+      while (*last)
+      {
+         last = &(*last)->mpNext;
+      }
+      *last = waiter;
+   }
+
+   /// Do the lookup and give the result to all the waiters.
+   void complete(server_t* servers)
+   {
+      for (Waiter* waiter = mpWaiters; waiter; waiter = waiter->mpNext)
+      {
+         waiter->mCallback(waiter->mpNext ? copy_server_list(servers) : servers,
+                           waiter->mUserData);
+      }
+   }
+
+   UtlString mDomain;
+   UtlString mService;
+   OsSocket::IpProtocolSocketType mSocketType;
+   int mPort;
+   UtlString mSrcIp;
+   UtlBoolean mHasSrcIp;
+   Waiter* mpWaiters;
+};
+
+/**
+ * Task which does the lookups of SipSrvLookup::serversAsync().
+ */
+class SipSrvLookupTask : public OsServerTask
+{
+public:
+   SipSrvLookupTask() :
+      OsServerTask("SipSrvLookupTask-%d")
+   {
+   }
+
+   ~SipSrvLookupTask()
+   {
+      waitUntilShutDown();
+   }
+
+   UtlBoolean handleMessage(OsMsg& rMsg);
+};
+
+/// The task of serversAsync(), or NULL if it has not been started.
+static SipSrvLookupTask* spLookupTask = NULL;
+/// SrvLookupRequest's queued to spLookupTask or in progress, allocated
+/// when first used like spDnsCache.
+static UtlHashBag* spPendingLookups = NULL;
+/// Protects spLookupTask and spPendingLookups.
+static OsMutex sLookupTaskMutex(OsMutex::Q_FIFO);
+
+/// spDnsCache, the caller must hold sDnsCacheMutex.
+static UtlHashBag& dnsCache()
+{
+   if (spDnsCache == NULL)
+   {
+      spDnsCache = new UtlHashBag;
+   }
+   return *spDnsCache;
+}
+
+/// spPendingLookups, the caller must hold sLookupTaskMutex.
+static UtlHashBag& pendingLookups()
+{
+   if (spPendingLookups == NULL)
+   {
+      spPendingLookups = new UtlHashBag;
+   }
+   return *spPendingLookups;
+}
+
 /* //////////////////////////// PUBLIC //////////////////////////////////// */
 
 /// Get the list of server entries for SIP domain name 'domain'.
@@ -267,8 +490,10 @@ server_t* SipSrvLookup::servers(const char* domain,
    // Initialize the list of servers.
    server_list_initialize(list, list_length_allocated, list_length_used);
 
+#ifndef RESOLVER_IS_REENTRANT
    // Seize the lock.
    OsLock lock(sMutex);
+#endif
 
    // Case 0: Eliminate contradictory combinations of service and type.
    
@@ -403,6 +628,124 @@ server_t* SipSrvLookup::servers(const char* domain,
    return list;
 }
 
+// Get the list of server entries without waiting for DNS.
+void SipSrvLookup::serversAsync(const char* domain,
+                                const char* service,
+                                OsSocket::IpProtocolSocketType socketType,
+                                int port,
+                                const char* srcIp,
+                                SipSrvLookupCallback callback,
+                                void* userData)
+{
+   char portString[16];
+   sprintf(portString, "%d", port);
+   UtlString key(service);
+   key.append(':');
+   key.append(OsSocket::ipProtocolString(socketType));
+   key.append(':');
+   key.append(portString);
+   key.append(':');
+   key.append(srcIp ? srcIp : "");
+   key.append(':');
+   key.append(domain);
+
+   OsLock lock(sLookupTaskMutex);
+
+   SrvLookupRequest* request = (SrvLookupRequest*) pendingLookups().find(&key);
+   if (request)
+   {
+      // The same lookup is queued already, just wait for its result.
+      OsSysLog::add(FAC_SIP, PRI_DEBUG,
+                    "SipSrvLookup::serversAsync joining lookup '%s'",
+                    key.data());
+      request->addWaiter(callback, userData);
+      return;
+   }
+
+   if (spLookupTask == NULL)
+   {
+      spLookupTask = new SipSrvLookupTask();
+      spLookupTask->start();
+   }
+
+   request = new SrvLookupRequest(key, domain, service, socketType, port, srcIp);
+   request->addWaiter(callback, userData);
+   pendingLookups().insert(request);
+
+   OsPtrMsg msg(OsMsg::USER_START, 0, request);
+   spLookupTask->postMessage(msg);
+}
+
+// Stop the lookup task of serversAsync(), if it has been started.
+void SipSrvLookup::destroyLookupTask()
+{
+   sLookupTaskMutex.acquire();
+   SipSrvLookupTask* task = spLookupTask;
+   spLookupTask = NULL;
+   sLookupTaskMutex.release();
+
+   if (task)
+   {
+      task->requestShutdown();
+      delete task;
+   }
+
+   // The task does not handle the lookups still queued when it stops,
+   // do them here so every caller gets its result.
+   while (TRUE)
+   {
+      SrvLookupRequest* request;
+      {
+         OsLock lock(sLookupTaskMutex);
+         UtlHashBagIterator iterator(pendingLookups());
+         request = (SrvLookupRequest*) iterator();
+         if (request)
+         {
+            pendingLookups().removeReference(request);
+         }
+      }
+      if (request == NULL)
+      {
+         break;
+      }
+
+      request->complete(servers(request->mDomain, request->mService,
+                                request->mSocketType, request->mPort,
+                                request->mHasSrcIp ? request->mSrcIp.data() : NULL));
+      delete request;
+   }
+}
+
+// Remove all the DNS answers from the cache.
+void SipSrvLookup::clearCache()
+{
+   OsLock lock(sDnsCacheMutex);
+
+   // Entries in use by other threads are only marked expired.
+   UtlHashBagIterator iterator(dnsCache());
+   DnsCacheEntry* entry;
+   while ((entry = (DnsCacheEntry*) iterator()))
+   {
+      if (entry->mInFlight || entry->mWaiters > 0)
+      {
+         entry->mExpires = 0;
+      }
+      else
+      {
+         dnsCache().removeReference(entry);
+         delete entry;
+      }
+   }
+}
+
+// Replace res_query() for the DNS queries of the lookups.
+void SipSrvLookup::setResQueryFunction(ResQueryFunction function)
+{
+   OsLock lock(sDnsCacheMutex);
+
+   sResQueryFunction = function;
+}
+
 /// Set an option value.
 void SipSrvLookup::setOption(OptionCode option, int value)
 {
@@ -425,7 +768,7 @@ void SipSrvLookup::setDnsSrvTimeouts(int initialTimeoutInSecs, int retries)
    if (initialTimeoutInSecs > 0)
    {
 #  if defined(__pingtel_on_posix__)
-      _res.retrans = initialTimeoutInSecs;
+      sDnsRetrans = initialTimeoutInSecs;
 #  else
       _sip_res.retrans = initialTimeoutInSecs;
 #  endif
@@ -434,7 +777,7 @@ void SipSrvLookup::setDnsSrvTimeouts(int initialTimeoutInSecs, int retries)
    if (retries > 0)
    {
 #  if defined(__pingtel_on_posix__)
-      _res.retry = retries;
+      sDnsRetry = retries;
 #  else
       _sip_res.retry = retries;
 #  endif
@@ -451,7 +794,13 @@ void  SipSrvLookup::getDnsSrvTimeouts(int& initialTimeoutInSecs, int& retries)
 #else
 
 #  if defined(__pingtel_on_posix__)
-   initialTimeoutInSecs = _res.retrans;
+   // Report what the next query will use, without initializing _res of
+   // the calling thread: queries apply the timeouts themselves.
+   UtlBoolean resInit = (_res.options & RES_INIT) != 0;
+   initialTimeoutInSecs = sDnsRetrans > 0 ? sDnsRetrans
+                          : resInit ? _res.retrans : RES_TIMEOUT;
+   retries = sDnsRetry > 0 ? sDnsRetry
+             : resInit ? _res.retry : RES_DFLRETRY;
 #  else
    initialTimeoutInSecs = _sip_res.retrans;
 #  endif
@@ -840,8 +1189,8 @@ void SipSrvLookup::res_query_and_parse(const char* in_name,
       }
       // Use res_query, not res_search, so defaulting rules are not
       // applied to the domain.
-      if (res_query(name, C_IN, type,
-                    (unsigned char*) answer, sizeof (answer)) == -1)
+      if (cached_res_query(name, type,
+                           (unsigned char*) answer, sizeof (answer)) == -1)
       {
          // res_query failed, return.
          break;
@@ -872,6 +1221,250 @@ void SipSrvLookup::res_query_and_parse(const char* in_name,
    out_response = response;
 }
 
+// Do a DNS query with res_query(), or with the answer in the cache.
+int cached_res_query(const char* name, int type,
+                     unsigned char* answer, int answerSize)
+{
+   if (SipSrvLookup::getOption(SipSrvLookup::OptionCodeIgnoreCache))
+   {
+      return do_res_query(name, type, answer, answerSize);
+   }
+
+   char typeString[16];
+   sprintf(typeString, "%d:", type);
+   UtlString key(typeString);
+   key.append(name);
+   key.toLower();
+
+   OsTime now;
+   OsDateTime::getCurTimeSinceBoot(now);
+
+   sDnsCacheMutex.acquire();
+
+   // If another thread is doing the same query, wait for its answer.
+   DnsCacheEntry* entry = (DnsCacheEntry*) dnsCache().find(&key);
+   UtlBoolean waited = FALSE;
+   while (entry && entry->mInFlight)
+   {
+      entry->mWaiters++;
+      sDnsCacheMutex.release();
+      entry->mDone.acquire();
+      entry->mDone.release();
+      sDnsCacheMutex.acquire();
+      entry->mWaiters--;
+      waited = TRUE;
+   }
+
+   // Use the answer we waited for even if it is not cacheable.
+   if (entry && (waited || now.seconds() < entry->mExpires))
+   {
+      int length = entry->mAnswerLength;
+      if (entry->mpAnswer)
+      {
+         memcpy(answer, entry->mpAnswer,
+                length < answerSize ? length : answerSize);
+      }
+      sDnsCacheMutex.release();
+      return length;
+   }
+
+   if (entry == NULL)
+   {
+      // Make room by removing the expired answers.
+      if (dnsCache().entries() >= DNS_CACHE_PURGE_ENTRIES)
+      {
+         UtlHashBagIterator iterator(dnsCache());
+         DnsCacheEntry* oldEntry;
+         while ((oldEntry = (DnsCacheEntry*) iterator()))
+         {
+            if (!oldEntry->mInFlight && oldEntry->mWaiters == 0 &&
+                now.seconds() >= oldEntry->mExpires)
+            {
+               dnsCache().removeReference(oldEntry);
+               delete oldEntry;
+            }
+         }
+      }
+      entry = new DnsCacheEntry(key);
+      dnsCache().insert(entry);
+   }
+   entry->mInFlight = TRUE;
+   entry->mDone.acquire();
+   sDnsCacheMutex.release();
+
+   // Clear the header, so a failure answered by DNS can be told from
+   // a failure to get any answer.
+   memset(answer, 0, sizeof (HEADER));
+   int length = do_res_query(name, type, answer, answerSize);
+   long ttl = answer_ttl(length, answer, answerSize);
+   OsDateTime::getCurTimeSinceBoot(now);
+
+   sDnsCacheMutex.acquire();
+   free(entry->mpAnswer);
+   entry->mpAnswer = NULL;
+   entry->mAnswerLength = length;
+   if (length > 0 && length <= answerSize)
+   {
+      entry->mpAnswer = (unsigned char*) malloc(length);
+      memcpy(entry->mpAnswer, answer, length);
+   }
+   entry->mExpires = now.seconds() + ttl;
+   entry->mInFlight = FALSE;
+   entry->mDone.release();
+   sDnsCacheMutex.release();
+
+   return length;
+}
+
+#if !defined(ANDROID) && defined(__pingtel_on_posix__)
+// Set the timeouts of setDnsSrvTimeouts() in _res of the calling thread.
+void apply_dns_timeouts()
+{
+   if (!(_res.options & RES_INIT))
+   {
+      res_init();
+   }
+   if (sDnsRetrans > 0)
+   {
+      _res.retrans = sDnsRetrans;
+   }
+   if (sDnsRetry > 0)
+   {
+      _res.retry = sDnsRetry;
+   }
+}
+#endif
+
+// Do a DNS query with res_query() or the function which replaces it.
+int do_res_query(const char* name, int type,
+                 unsigned char* answer, int answerSize)
+{
+#if !defined(ANDROID) && defined(__pingtel_on_posix__)
+   // The query may run on the lookup task, and res_init() resets _res.
+   apply_dns_timeouts();
+#endif
+   if (sResQueryFunction)
+   {
+      return sResQueryFunction(name, C_IN, type, answer, answerSize);
+   }
+   return res_query(name, C_IN, type, answer, answerSize);
+}
+
+// Number of seconds to cache the result of a DNS query.
+long answer_ttl(int length, unsigned char* answer, int answerSize)
+{
+   HEADER* header = (HEADER*) answer;
+   long maxTtl = SipSrvLookup::getOption(SipSrvLookup::OptionCodeCacheMaxTTL);
+   long ttl = -1;
+
+   // Do not cache a truncated answer, or a failure which is not
+   // an answer from DNS that the name or RRs do not exist (RFC 2308).
+   if (length > answerSize ||
+       (length < 0 &&
+        (!header->qr ||
+         (header->rcode != NXDOMAIN && header->rcode != NOERROR))))
+   {
+      return 0;
+   }
+
+   res_response* response = res_parse((char*) answer);
+   if (response == NULL)
+   {
+      return 0;
+   }
+
+   unsigned int i;
+   if (length >= 0)
+   {
+      // The TTL of the answer is the smallest TTL of its RRs.
+      for (i = 0; i < response->header.ancount; i++)
+      {
+         if (ttl < 0 || (long) response->answer[i]->ttl < ttl)
+         {
+            ttl = response->answer[i]->ttl;
+         }
+      }
+      for (i = 0; i < response->header.arcount; i++)
+      {
+         if (ttl < 0 || (long) response->additional[i]->ttl < ttl)
+         {
+            ttl = response->additional[i]->ttl;
+         }
+      }
+   }
+   else
+   {
+      // A negative answer is cached for the TTL of the SOA record in it,
+      // but at most for the SOA minimum field.
+      for (i = 0; i < response->header.nscount; i++)
+      {
+         if (response->authority[i]->type == T_SOA)
+         {
+            ttl = response->authority[i]->ttl;
+            if ((long) response->authority[i]->rdata.soa.minimum < ttl)
+            {
+               ttl = response->authority[i]->rdata.soa.minimum;
+            }
+         }
+      }
+      if (ttl < 0)
+      {
+         ttl = SipSrvLookup::getOption(SipSrvLookup::OptionCodeNegativeCacheTTL);
+      }
+   }
+   res_free(response);
+
+   if (ttl < 0)
+   {
+      ttl = 0;
+   }
+   return ttl < maxTtl ? ttl : maxTtl;
+}
+
+// Do a lookup queued by serversAsync().
+UtlBoolean SipSrvLookupTask::handleMessage(OsMsg& rMsg)
+{
+   if (rMsg.getMsgType() != OsMsg::USER_START)
+   {
+      return FALSE;
+   }
+
+   SrvLookupRequest* request = (SrvLookupRequest*) ((OsPtrMsg&) rMsg).getPtr();
+   server_t* servers =
+      SipSrvLookup::servers(request->mDomain, request->mService,
+                            request->mSocketType, request->mPort,
+                            request->mHasSrcIp ? request->mSrcIp.data() : NULL);
+
+   // Callers which ask for the same lookup from now on start a new one.
+   sLookupTaskMutex.acquire();
+   pendingLookups().removeReference(request);
+   sLookupTaskMutex.release();
+
+   request->complete(servers);
+   delete request;
+
+   return TRUE;
+}
+
+// Copy a list of servers returned by SipSrvLookup::servers().
+server_t* copy_server_list(const server_t* list)
+{
+   int length = 0;
+   while (list[length].host != NULL)
+   {
+      length++;
+   }
+   // Copy the ending empty element too.
+   length++;
+
+   server_t* copy = new server_t[length];
+   for (int i = 0; i < length; i++)
+   {
+      copy[i] = list[i];
+   }
+   return copy;
+}
+
 union u_rdata* look_for(res_response* response, const char* name,
                         int type)
 {
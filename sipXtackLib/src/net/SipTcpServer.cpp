@@ -50,6 +50,11 @@ SipTcpServer::SipTcpServer(int port,
 
    mServerPort = port ;
    mpServerBrokerListener = new SipServerBrokerListener(this);
+#ifdef SIP_TCP_USE_REACTOR
+   // Read all TCP connections from a few epoll threads instead of
+   // a thread per connection.
+   mpClientReactor = new SipClientReactor("SipTcpReactor");
+#endif
 
 #ifdef _DISABLE_MULTIPLE_INTERFACE_SUPPORT
    szBindAddr = "0.0.0.0" ;
@@ -314,7 +319,7 @@ UtlBoolean SipServerBrokerListener::handleMessage(OsMsg& eventMessage)
             OsSysLog::add(FAC_SIP, PRI_DEBUG, "Sip%sServer::run client: %p %s:%d",
                 mpOwner->mProtocolString.data(), client, hostAddress.data(), hostPort);
 
-            UtlBoolean clientStarted = client->start();
+            UtlBoolean clientStarted = mpOwner->startClient(client);
             if(!clientStarted)
             {
                 OsSysLog::add(FAC_SIP, PRI_ERR, "SIP %s Client failed to start", mpOwner->mProtocolString.data());
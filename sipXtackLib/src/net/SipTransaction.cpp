@@ -21,6 +21,7 @@
 #include <os/OsTimer.h>
 #include <os/OsQueuedEvent.h>
 #include <os/OsEvent.h>
+#include <utl/UtlNameValueTokenizer.h>
 #include <net/SipTransaction.h>
 #include <net/SipMessage.h>
 #include <net/SipUserAgent.h>
@@ -74,6 +75,7 @@ SipTransaction::SipTransaction(SipMessage* request,
    mProvisionalSdp = FALSE;
    mpDnsSrvRecords = NULL;
    mIsDnsSrvChild = FALSE;
+   mDnsSrvLookupPending = FALSE;
    mSendToPort = PORT_NONE;
    mSendToProtocol = OsSocket::UNKNOWN;
 
@@ -125,6 +127,11 @@ SipTransaction::SipTransaction(SipMessage* request,
        {
            // Yes - create a new branch id
            getNewBranchId(*request, mBranchId);           
+           if(mBranchId.index(BRANCH_ID_PREFIX) == 0)
+           {
+               composeBranchKey(mBranchId, "", mRequestMethod, FALSE,
+                                mBranchKey);
+           }
        }
        else
        {
@@ -133,6 +140,7 @@ SipTransaction::SipTransaction(SipMessage* request,
            UtlString viaField;
            request->getViaFieldSubField(&viaField, 0);
            SipMessage::getViaTag(viaField.data(), "branch", mBranchId);
+           buildBranchKey(*request, isOutgoing, mBranchKey);
        }
    }
    else
@@ -2383,6 +2391,12 @@ UtlBoolean SipTransaction::startSequentialSearch(SipUserAgent& userAgent,
 {
     if (!mpTransport) mpTransport = pTransport;
 
+    // The DNS SRV children are not created until the lookup is done
+    if(mDnsSrvLookupPending)
+    {
+        return(mIsRecursing);
+    }
+
     UtlSListIterator iterator(mChildTransactions);
     SipTransaction* childTransaction = NULL;
     UtlBoolean childStillProceeding = FALSE;
@@ -2541,13 +2555,6 @@ UtlBoolean SipTransaction::recurseDnsSrvChildren(SipUserAgent& userAgent,
         {
             mTransactionState = TRANSACTION_CONFIRMED;
 
-            // Do the DNS SRV lookup for the request destination
-            mpDnsSrvRecords = SipSrvLookup::servers(mSendToAddress.data(),
-                                                "sip",
-                                                 mSendToProtocol,
-                                                 mSendToPort,
-                                                 this->getRequest()->getLocalIp().data());
-
             // HACK:
             // Add a via to this request so when we set a timer it is
             // identified (by branchId) which transaction it is related to
@@ -2618,111 +2625,32 @@ UtlBoolean SipTransaction::recurseDnsSrvChildren(SipUserAgent& userAgent,
             OsTime expiresTime(expireSeconds, 0);
             expiresTimer->oneshotAfter(expiresTime);
 
-            if (pTransport)
+            if (pTransport || OsSocket::isIp4Address(mSendToAddress))
             {
-                SipTransaction* childTransaction =
-                    new SipTransaction(mpRequest,
-                                        TRUE, // outgoing
-                                        mIsUaTransaction); // same as parent
-
-                if(childTransaction)
-                {
-                    // Set the q values of the child based upon the parent
-                    // As DNS SRV is recursed serially the Q values are decremented
-                    // by a factor of the record index
-
-                    // Inherit the expiration from the parent
-                    childTransaction->mExpires = mExpires;
-
-                    // Mark this as a DNS SRV child
-                    childTransaction->mIsDnsSrvChild = TRUE;
-
-                    childTransaction->mIsBusy = mIsBusy;
-
-                    // Add it to the list
-                    transactionList.addTransaction(childTransaction);
-
-                    // Link it in to this parent
-                    this->linkChild(*childTransaction);
-                }
-
+                // No DNS query is needed, so look up right away
+                mpDnsSrvRecords = SipSrvLookup::servers(mSendToAddress.data(),
+                                                        "sip",
+                                                        mSendToProtocol,
+                                                        mSendToPort,
+                                                        mpRequest->getLocalIp().data());
+                createDnsSrvChildren(userAgent, transactionList, pTransport);
             }
-            else if(mpDnsSrvRecords)
-            {
-                int numSrvRecords = 0;
-                int maxSrvRecords = userAgent.getMaxSrvRecords();
-
-                // Create child transactions for each SRV record
-                // up to the maximum
-                while(numSrvRecords < maxSrvRecords &&
-                    mpDnsSrvRecords[numSrvRecords].isValidServerT())
-                {
-                    SipTransaction* childTransaction =
-                        new SipTransaction(mpRequest,
-                                            TRUE, // outgoing
-                                            mIsUaTransaction); // same as parent
-
-                    mpDnsSrvRecords[numSrvRecords].
-                       getIpAddressFromServerT(childTransaction->mSendToAddress);
-
-                    childTransaction->mSendToPort =
-                        mpDnsSrvRecords[numSrvRecords].getPortFromServerT();
-
-                    childTransaction->mSendToProtocol =
-                        mpDnsSrvRecords[numSrvRecords].getProtocolFromServerT();
-
-#                        ifdef ROUTE_DEBUG
-                         {
-                            UtlString protoString;
-                            SipMessage::convertProtocolEnumToString(childTransaction->mSendToProtocol,
-                                                                    protoString);
-                            OsSysLog::add(FAC_SIP, PRI_DEBUG,
-                                          "SipTransaction::recurseDnsSrvChildren "
-                                          "new DNS SRV child %s:%d via '%s'",
-                                          childTransaction->mSendToAddress.data(),
-                                          childTransaction->mSendToPort,
-                                          protoString.data());
-                         }
-#                        endif
-                    // Do not create child for unsupported protocol types
-                    if(childTransaction->mSendToProtocol ==
-                        OsSocket::UNKNOWN)
-                    {
-                        maxSrvRecords++;
-                        delete childTransaction;
-                        childTransaction = NULL;
-                    }
-
-                    if(childTransaction)
-                    {
-                        // Set the q values of the child based upon the parent
-                        // As DNS SRV is recursed serially the Q values are decremented
-                        // by a factor of the record index
-                        childTransaction->mQvalue = mQvalue - numSrvRecords * 0.0001;
-
-                        // Inherit the expiration from the parent
-                        childTransaction->mExpires = mExpires;
-
-                        // Mark this as a DNS SRV child
-                        childTransaction->mIsDnsSrvChild = TRUE;
-
-                        childTransaction->mIsBusy = mIsBusy;
-
-                        // Add it to the list
-                        transactionList.addTransaction(childTransaction);
-
-                        // Link it in to this parent
-                        this->linkChild(*childTransaction);
-                    }
-
-                    numSrvRecords++;
-                }
-            }
-
-            // We got no DNS SRV records back
             else
             {
-                OsSysLog::add(FAC_SIP, PRI_ERR, "SipTransaction::recurseDnsSrvChildren no DNS SRV records");
+                // Do the DNS SRV lookup for the request destination without
+                // blocking the user agent.  The result comes back in
+                // handleDnsSrvLookup(), which creates the children.
+                // The copy of the request, with the via added above,
+                // identifies this transaction to the user agent.
+                mDnsSrvLookupPending = TRUE;
+                mIsRecursing = TRUE;
+                userAgent.lookupServersAsync(new SipMessage(*mpRequest),
+                                             mSendToAddress.data(),
+                                             "sip",
+                                             mSendToProtocol,
+                                             mSendToPort,
+                                             mpRequest->getLocalIp().data());
+                return(TRUE);
             }
         }
     }
@@ -2812,6 +2740,157 @@ UtlBoolean SipTransaction::recurseDnsSrvChildren(SipUserAgent& userAgent,
     return(childRecursed);
 }
 
+void SipTransaction::handleDnsSrvLookup(server_t* servers,
+                                        SipUserAgent& userAgent,
+                                        SipTransactionList& transactionList,
+                                        SipMessage*& delayedDispatchedMessage)
+{
+    mDnsSrvLookupPending = FALSE;
+    if(mpDnsSrvRecords)
+    {
+        delete[] mpDnsSrvRecords;
+    }
+    mpDnsSrvRecords = servers;
+
+    UtlBoolean childSent = FALSE;
+    if(!mIsCanceled && mpLastFinalResponse == NULL)
+    {
+        createDnsSrvChildren(userAgent, transactionList, NULL);
+        childSent = recurseDnsSrvChildren(userAgent, transactionList, NULL);
+    }
+
+    if(!childSent)
+    {
+        // Canceled while waiting for DNS, or no child could be sent.
+        // Give up now, as a child which fails does, rather than when
+        // the transaction expires.
+        mIsRecursing = FALSE;
+        int nextTimeout = -1;
+        handleChildTimeoutEvent(*this,
+                                *mpRequest,
+                                userAgent,
+                                MESSAGE_DUPLICATE,
+                                transactionList,
+                                nextTimeout,
+                                delayedDispatchedMessage,
+                                mpTransport);
+    }
+
+    touch();
+}
+
+void SipTransaction::createDnsSrvChildren(SipUserAgent& userAgent,
+                                          SipTransactionList& transactionList,
+                                          SIPX_TRANSPORT_DATA* pTransport)
+{
+    if (pTransport)
+    {
+        SipTransaction* childTransaction =
+            new SipTransaction(mpRequest,
+                                TRUE, // outgoing
+                                mIsUaTransaction); // same as parent
+
+        if(childTransaction)
+        {
+            // Set the q values of the child based upon the parent
+            // As DNS SRV is recursed serially the Q values are decremented
+            // by a factor of the record index
+
+            // Inherit the expiration from the parent
+            childTransaction->mExpires = mExpires;
+
+            // Mark this as a DNS SRV child
+            childTransaction->mIsDnsSrvChild = TRUE;
+
+            childTransaction->mIsBusy = mIsBusy;
+
+            // Add it to the list
+            transactionList.addTransaction(childTransaction);
+
+            // Link it in to this parent
+            this->linkChild(*childTransaction);
+        }
+
+    }
+    else if(mpDnsSrvRecords)
+    {
+        int numSrvRecords = 0;
+        int maxSrvRecords = userAgent.getMaxSrvRecords();
+
+        // Create child transactions for each SRV record
+        // up to the maximum
+        while(numSrvRecords < maxSrvRecords &&
+            mpDnsSrvRecords[numSrvRecords].isValidServerT())
+        {
+            SipTransaction* childTransaction =
+                new SipTransaction(mpRequest,
+                                    TRUE, // outgoing
+                                    mIsUaTransaction); // same as parent
+
+            mpDnsSrvRecords[numSrvRecords].
+               getIpAddressFromServerT(childTransaction->mSendToAddress);
+
+            childTransaction->mSendToPort =
+                mpDnsSrvRecords[numSrvRecords].getPortFromServerT();
+
+            childTransaction->mSendToProtocol =
+                mpDnsSrvRecords[numSrvRecords].getProtocolFromServerT();
+
+#                ifdef ROUTE_DEBUG
+                 {
+                    UtlString protoString;
+                    SipMessage::convertProtocolEnumToString(childTransaction->mSendToProtocol,
+                                                            protoString);
+                    OsSysLog::add(FAC_SIP, PRI_DEBUG,
+                                  "SipTransaction::createDnsSrvChildren "
+                                  "new DNS SRV child %s:%d via '%s'",
+                                  childTransaction->mSendToAddress.data(),
+                                  childTransaction->mSendToPort,
+                                  protoString.data());
+                 }
+#                endif
+            // Do not create child for unsupported protocol types
+            if(childTransaction->mSendToProtocol ==
+                OsSocket::UNKNOWN)
+            {
+                maxSrvRecords++;
+                delete childTransaction;
+                childTransaction = NULL;
+            }
+
+            if(childTransaction)
+            {
+                // Set the q values of the child based upon the parent
+                // As DNS SRV is recursed serially the Q values are decremented
+                // by a factor of the record index
+                childTransaction->mQvalue = mQvalue - numSrvRecords * 0.0001;
+
+                // Inherit the expiration from the parent
+                childTransaction->mExpires = mExpires;
+
+                // Mark this as a DNS SRV child
+                childTransaction->mIsDnsSrvChild = TRUE;
+
+                childTransaction->mIsBusy = mIsBusy;
+
+                // Add it to the list
+                transactionList.addTransaction(childTransaction);
+
+                // Link it in to this parent
+                this->linkChild(*childTransaction);
+            }
+
+            numSrvRecords++;
+        }
+    }
+
+    // We got no DNS SRV records back
+    else
+    {
+        OsSysLog::add(FAC_SIP, PRI_ERR, "SipTransaction::createDnsSrvChildren no DNS SRV records");
+    }
+}
+
 UtlBoolean SipTransaction::recurseChildren(SipUserAgent& userAgent,
                                    SipTransactionList& transactionList)
 {
@@ -4648,6 +4727,59 @@ void SipTransaction::buildHash(const SipMessage& message,
     hash.append(cSeqString);
 }
 
+UtlBoolean SipTransaction::buildBranchKey(const SipMessage& message,
+                                          UtlBoolean isOutgoing,
+                                          UtlString& key)
+{
+    key.remove(0);
+
+    UtlString viaField;
+    UtlString branch;
+    if(!message.getViaFieldSubField(&viaField, 0) ||
+       !SipMessage::getViaTag(viaField.data(), "branch", branch) ||
+       branch.index(BRANCH_ID_PREFIX) != 0)
+    {
+        // Not an RFC 3261 branch, it is only unique with the tags
+        return(FALSE);
+    }
+
+    UtlBoolean isServerTransaction =
+        message.isServerTransaction(isOutgoing);
+
+    // The sent-by is the token after the protocol, up to the parameters
+    UtlString sentBy;
+    if(isServerTransaction)
+    {
+        UtlNameValueTokenizer::getSubField(viaField, 1,
+                                           SIP_SUBFIELD_SEPARATORS, &sentBy);
+        int paramIndex = sentBy.index(';');
+        if(paramIndex >= 0)
+        {
+            sentBy.remove(paramIndex);
+        }
+    }
+
+    UtlString method;
+    if(message.isResponse())
+    {
+        int cSeq;
+        message.getCSeqField(&cSeq, &method);
+    }
+    else
+    {
+        message.getRequestMethod(&method);
+    }
+
+    composeBranchKey(branch, sentBy, method, isServerTransaction, key);
+
+    return(TRUE);
+}
+
+const UtlString& SipTransaction::getBranchKey() const
+{
+    return(mBranchKey);
+}
+
 SipTransaction* SipTransaction::getTopMostParent() const
 {
     SipTransaction* topParent = NULL;
@@ -5359,6 +5491,31 @@ UtlBoolean SipTransaction::isUriRecursedChildren(UtlString& uriString)
 
 /* //////////////////////////// PROTECTED ///////////////////////////////// */
 
+void SipTransaction::composeBranchKey(const UtlString& branch,
+                                      const UtlString& sentBy,
+                                      const UtlString& method,
+                                      UtlBoolean isServerTransaction,
+                                      UtlString& key)
+{
+    key = branch;
+    key.append(' ');
+    key.append(sentBy);
+    key.append(' ');
+
+    // ACK for a non-2xx final response and CANCEL are handled by the
+    // INVITE transaction
+    if(method.compareTo(SIP_ACK_METHOD) == 0 ||
+       method.compareTo(SIP_CANCEL_METHOD) == 0)
+    {
+        key.append(SIP_INVITE_METHOD);
+    }
+    else
+    {
+        key.append(method);
+    }
+    key.append(isServerTransaction ? 's' : 'c');
+}
+
 /* //////////////////////////// PRIVATE /////////////////////////////////// */
 
 /* ============================ FUNCTIONS ================================= */
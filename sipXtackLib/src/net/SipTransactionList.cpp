@@ -11,9 +11,11 @@
 
 // SYSTEM INCLUDES
 #include <assert.h>
+#include <ctype.h>
 
 // APPLICATION INCLUDES
 #include <utl/UtlString.h>
+#include <utl/UtlHashBag.h>
 #include <utl/UtlHashBagIterator.h>
 
 #include <net/SipTransaction.h>
@@ -21,6 +23,7 @@
 #include <net/SipMessage.h>
 #include <os/OsTask.h>
 #include <os/OsEvent.h>
+#include <os/OsMutex.h>
 
 // EXTERNAL FUNCTIONS
 // EXTERNAL VARIABLES
@@ -33,27 +36,96 @@
 
 // STATIC VARIABLE INITIALIZATIONS
 
+// The entry of a transaction in the branch index and in an expiry queue.
+// The string is the branch key of the transaction.  The queues are kept
+// in mQueueTime order; mQueueTime is never after the last time the
+// transaction was touched, as a transaction may be touched any time
+// without the list knowing.
+class SipTransactionListEntry : public UtlString
+{
+public:
+    SipTransactionListEntry(SipTransaction* transaction) :
+        UtlString(transaction->getBranchKey()),
+        mpTransaction(transaction),
+        mQueueTime(transaction->getTimeStamp())
+    {
+    }
+
+    SipTransaction* mpTransaction;
+    long mQueueTime;
+};
+
+// Append an entry to an expiry queue, keeping the queue in time order
+static void appendToExpiryQueue(UtlSList& expiryQueue,
+                                SipTransactionListEntry* entry)
+{
+    SipTransactionListEntry* lastEntry =
+        (SipTransactionListEntry*) expiryQueue.last();
+    if(lastEntry && lastEntry->mQueueTime > entry->mQueueTime)
+    {
+        // Seen a bit later than it could be, which is harmless
+        entry->mQueueTime = lastEntry->mQueueTime;
+    }
+    expiryQueue.append(entry);
+}
+
+// The transactions with the Call-IDs of one shard and their lock
+class SipTransactionListShard
+{
+public:
+    SipTransactionListShard() :
+        mMutex(OsMutex::Q_FIFO)
+    {
+    }
+
+    ~SipTransactionListShard()
+    {
+        // The entries are on the queues and some are also in the index
+        mBranchIndex.removeAll();
+        mExpiryQueue.destroyAll();
+        mInviteExpiryQueue.destroyAll();
+        mTransactions.destroyAll();
+    }
+
+    void lock() { mMutex.acquire(); }
+    void unlock() { mMutex.release(); }
+
+    UtlHashBag mTransactions;
+    UtlHashBag mBranchIndex;       // SipTransactionListEntry by branch key
+    UtlSList mExpiryQueue;         // non-INVITE SipTransactionListEntry
+    UtlSList mInviteExpiryQueue;   // INVITE SipTransactionListEntry
+    OsMutex mMutex;
+};
+
 /* //////////////////////////// PUBLIC //////////////////////////////////// */
 
 /* ============================ CREATORS ================================== */
 
 // Constructor
-SipTransactionList::SipTransactionList() :
-mTransactions(),
-mListMutex(OsMutex::Q_FIFO)
+SipTransactionList::SipTransactionList()
 {
+    for(int shardIndex = 0; shardIndex < SIP_TRANSACTION_LIST_SHARDS; shardIndex++)
+    {
+        mpShards[shardIndex] = new SipTransactionListShard();
+    }
 }
 
 // Copy constructor
-SipTransactionList::SipTransactionList(const SipTransactionList& rSipTransactionList) :
-mListMutex(OsMutex::Q_FIFO)
+SipTransactionList::SipTransactionList(const SipTransactionList& rSipTransactionList)
 {
+    for(int shardIndex = 0; shardIndex < SIP_TRANSACTION_LIST_SHARDS; shardIndex++)
+    {
+        mpShards[shardIndex] = new SipTransactionListShard();
+    }
 }
 
 // Destructor
 SipTransactionList::~SipTransactionList()
 {
-    mTransactions.destroyAll();
+    for(int shardIndex = 0; shardIndex < SIP_TRANSACTION_LIST_SHARDS; shardIndex++)
+    {
+        delete mpShards[shardIndex];
+    }
 }
 
 /* ============================ MANIPULATORS ============================== */
@@ -71,9 +143,22 @@ SipTransactionList::operator=(const SipTransactionList& rhs)
 void SipTransactionList::addTransaction(SipTransaction* transaction,
                                         UtlBoolean lockList)
 {
-    if(lockList) lock();
+    UtlString callId;
+    transaction->getCallId(callId);
+    SipTransactionListShard& shard = getShard(callId.data(), callId.length());
 
-    mTransactions.insert(transaction);
+    if(lockList) shard.lock();
+
+    shard.mTransactions.insert(transaction);
+
+    SipTransactionListEntry* entry = new SipTransactionListEntry(transaction);
+    if(!entry->isNull())
+    {
+        shard.mBranchIndex.insert(entry);
+    }
+    appendToExpiryQueue(transaction->isMethod(SIP_INVITE_METHOD) ?
+                           shard.mInviteExpiryQueue : shard.mExpiryQueue,
+                        entry);
 
 #ifdef TEST_PRINT
     osPrintf("***************************************\n");
@@ -81,7 +166,7 @@ void SipTransactionList::addTransaction(SipTransaction* transaction,
     osPrintf("***************************************\n");
 #endif
 
-    if(lockList) unlock();
+    if(lockList) shard.unlock();
 }
 
 //: Find a transaction for the given message
@@ -94,51 +179,53 @@ SipTransactionList::findTransactionFor(const SipMessage& message,
     UtlString callId;
     SipTransaction::buildHash(message, isOutgoing, callId);
 
-    lock();
+    // Only transactions with the same Call-ID can match
+    UtlString msgCallId;
+    message.getCallIdField(&msgCallId);
+    SipTransactionListShard& shard = getShard(msgCallId.data(),
+                                              msgCallId.length());
+
+    shard.lock();
 
     // See if the message knows its transaction
     // DO NOT TOUCH THE CONTENTS of this transaction as it may no
     // longer exist.  It can only be used as an ID for the transaction.
     SipTransaction* messageTransaction = message.getSipTransaction();
 
-    UtlString matchTransaction(callId);
-
-    UtlHashBagIterator iterator(mTransactions, &matchTransaction);
-
     relationship = SipTransaction::MESSAGE_UNKNOWN;
-    while ((transactionFound = (SipTransaction*) iterator()))
-    {
-        // If the message knows its SIP transaction
-        // and the found transaction pointer does not match, skip the
-        // expensive relationship calculation
-        // The messageTransaction MUST BE TREATED AS OPAQUE
-        // as it may have been deleted.
-        if(   messageTransaction && transactionFound != messageTransaction )
-        {
-           continue;
-        }
 
-        // If the transaction has never sent the original rquest
-        // it should never get a match for any messages.
-        if(   messageTransaction == NULL // this message does not point to this TX
-           && ((transactionFound->getState()) == SipTransaction::TRANSACTION_LOCALLY_INIITATED)
-           )
+    // Messages from RFC 3261 peers have a branch which identifies the
+    // transaction without the tags, look for it in the index first
+    UtlString branchKey;
+    if(SipTransaction::buildBranchKey(message, isOutgoing, branchKey))
+    {
+        UtlHashBagIterator branchIterator(shard.mBranchIndex, &branchKey);
+        SipTransactionListEntry* entry;
+        while ((entry = (SipTransactionListEntry*) branchIterator()))
         {
-            continue;
+            if(isTransactionFor(entry->mpTransaction, message, isOutgoing,
+                                messageTransaction, relationship))
+            {
+                transactionFound = entry->mpTransaction;
+                break;
+            }
         }
+    }
 
-        relationship = transactionFound->whatRelation(message, isOutgoing);
-        if(relationship == SipTransaction::MESSAGE_REQUEST ||
-            relationship ==  SipTransaction::MESSAGE_PROVISIONAL ||
-            relationship ==  SipTransaction::MESSAGE_FINAL ||
-            relationship ==  SipTransaction::MESSAGE_NEW_FINAL ||
-            relationship ==  SipTransaction::MESSAGE_CANCEL ||
-            relationship ==  SipTransaction::MESSAGE_CANCEL_RESPONSE ||
-            relationship ==  SipTransaction::MESSAGE_ACK ||
-            relationship ==  SipTransaction::MESSAGE_2XX_ACK ||
-            relationship ==  SipTransaction::MESSAGE_DUPLICATE)
+    // Requests without a Via yet, ACKs for 2xx responses and messages
+    // from RFC 2543 peers are only matched by looking at all the
+    // transactions with the same Call-ID and CSeq
+    if(transactionFound == NULL)
+    {
+        UtlString matchTransaction(callId);
+        UtlHashBagIterator iterator(shard.mTransactions, &matchTransaction);
+        while ((transactionFound = (SipTransaction*) iterator()))
         {
-            break;
+            if(isTransactionFor(transactionFound, message, isOutgoing,
+                                messageTransaction, relationship))
+            {
+                break;
+            }
         }
     }
 
@@ -157,12 +244,12 @@ SipTransactionList::findTransactionFor(const SipMessage& message,
         }
     }
 
-    unlock();
+    shard.unlock();
 
     if(transactionFound && isBusy)
     {
         // If we cannot lock it, it does not exist
-        if(!waitUntilAvailable(transactionFound, callId))
+        if(!waitUntilAvailable(shard, transactionFound, callId))
         {
             if (OsSysLog::willLog(FAC_SIP, PRI_WARNING))
             {
@@ -205,8 +292,6 @@ SipTransactionList::findTransactionFor(const SipMessage& message,
 void SipTransactionList::removeOldTransactions(long oldTransaction,
                                                long oldInviteTransaction)
 {
-    SipTransaction** transactionsToBeDeleted = NULL;
-    int deleteCount = 0;
     int busyCount = 0;
 
 #   ifdef TIME_LOG
@@ -214,90 +299,50 @@ void SipTransactionList::removeOldTransactions(long oldTransaction,
     gcTimes.addEvent("start");
 #   endif
 
-    lock();
-
-    int numTransactions = mTransactions.entries();
-    if(numTransactions > 0)
+    int numTransactions = 0;
+    int totalDeleteCount = 0;
+    for(int shardIndex = 0; shardIndex < SIP_TRANSACTION_LIST_SHARDS; shardIndex++)
     {
-        UtlHashBagIterator iterator(mTransactions);
-        SipTransaction* transactionFound = NULL;
-        long transTime;
+        SipTransactionListShard& shard = *mpShards[shardIndex];
+        SipTransaction** transactionsToBeDeleted = NULL;
+        int deleteCount = 0;
 
+        shard.lock();
 
-        // Pull all of the transactions to be deleted out of the list
-        while((transactionFound = (SipTransaction*) iterator()))
-        {
-            if(transactionFound->isBusy()) busyCount++;
-
-            transTime = transactionFound->getTimeStamp();
-            // Invites need to be kept longer than other transactions
-            if(((!transactionFound->isMethod(SIP_INVITE_METHOD) &&
-                transTime < oldTransaction) ||
-                transTime < oldInviteTransaction) &&
-                ! transactionFound->isBusy())
-            {
-                // Remove it from the list
-                mTransactions.removeReference(transactionFound);
-
-                OsSysLog::add(FAC_SIP, PRI_DEBUG, "removing transaction %p\n",transactionFound);
+        numTransactions += shard.mTransactions.entries();
 
-                // Make sure we have a pointer array to hold it
-                if(transactionsToBeDeleted == NULL)
-                {
-                     transactionsToBeDeleted =
-                        new SipTransaction*[numTransactions];
-                }
+        // Invites need to be kept longer than other transactions
+        removeExpired(shard, shard.mExpiryQueue,
+                      oldTransaction > oldInviteTransaction ?
+                         oldTransaction : oldInviteTransaction,
+                      transactionsToBeDeleted, deleteCount, busyCount);
+        removeExpired(shard, shard.mInviteExpiryQueue, oldInviteTransaction,
+                      transactionsToBeDeleted, deleteCount, busyCount);
 
-                // Put it in the pointer array
-                transactionsToBeDeleted[deleteCount] = transactionFound;
-                deleteCount++;
+        shard.unlock();
 
-                // Make sure the events waiting for the transaction
-                // to be available are signaled before we delete
-                // any of the transactions or we end up with
-                // incomplete transaction trees (i.e. deleted branches)
-                transactionFound->signalAllAvailable();
-                transactionFound = NULL;
+        // We do not need the lock if the transactions have been
+        // removed from the list
+        if (transactionsToBeDeleted)
+        {
+            for(int txIndex = 0; txIndex < deleteCount; txIndex++)
+            {
+                delete transactionsToBeDeleted[txIndex];
+#               ifdef TIME_LOG
+                gcTimes.addEvent("transaction deleted");
+#               endif
             }
+
+            delete[] transactionsToBeDeleted;
+            transactionsToBeDeleted = NULL;
         }
+        totalDeleteCount += deleteCount;
     }
 
-    unlock();
-
-    // We do not need the lock if the transactions have been
-    // removed from the list
-    if ( deleteCount || busyCount ) // do not log 'doing nothing when nothing to do', even at debug level
+    if ( totalDeleteCount || busyCount ) // do not log 'doing nothing when nothing to do', even at debug level
     {
         OsSysLog::add(FAC_SIP, PRI_DEBUG, "SipTransactionList::removeOldTransactions deleting %d of %d transactions (%d busy)\n",
-                      deleteCount , numTransactions, busyCount);
-    }
-
-    // Delete the transactions in the array
-    if (transactionsToBeDeleted)
-    {
-#       ifdef TIME_LOG
-        gcTimes.addEvent("start delete");
-#       endif
-
-        for(int txIndex = 0; txIndex < deleteCount; txIndex++)
-        {
-            delete transactionsToBeDeleted[txIndex];
-#           ifdef TIME_LOG
-            gcTimes.addEvent("transaction deleted");
-#           endif
-       }
-
-#      ifdef TIME_LOG
-       gcTimes.addEvent("finish delete");
-#      endif
-/*
-        while((transactionFound = (SipTransaction*) iterator()))
-        {
-            transactionFound->stopTimers();
-        }
-*/
-       delete[] transactionsToBeDeleted;
-       transactionsToBeDeleted = NULL;
+                      totalDeleteCount , numTransactions, busyCount);
     }
 
 #   ifdef TIME_LOG
@@ -311,125 +356,236 @@ void SipTransactionList::removeOldTransactions(long oldTransaction,
 
 void SipTransactionList::stopTransactionTimers()
 {
-    lock();
-
-    int numTransactions = mTransactions.entries();
-    if(numTransactions > 0)
+    for(int shardIndex = 0; shardIndex < SIP_TRANSACTION_LIST_SHARDS; shardIndex++)
     {
-        UtlHashBagIterator iterator(mTransactions);
+        SipTransactionListShard& shard = *mpShards[shardIndex];
+        shard.lock();
+
+        UtlHashBagIterator iterator(shard.mTransactions);
         SipTransaction* transactionFound = NULL;
 
         while((transactionFound = (SipTransaction*) iterator()))
         {
             transactionFound->stopTimers();
         }
-    }
 
-    unlock();
+        shard.unlock();
+    }
 }
 
 void SipTransactionList::startTransactionTimers()
 {
-    lock();
-
-    int numTransactions = mTransactions.entries();
-    if(numTransactions > 0)
+    for(int shardIndex = 0; shardIndex < SIP_TRANSACTION_LIST_SHARDS; shardIndex++)
     {
-        UtlHashBagIterator iterator(mTransactions);
+        SipTransactionListShard& shard = *mpShards[shardIndex];
+        shard.lock();
+
+        UtlHashBagIterator iterator(shard.mTransactions);
         SipTransaction* transactionFound = NULL;
 
         while((transactionFound = (SipTransaction*) iterator()))
         {
             transactionFound->startTimers();
         }
-    }
 
-    unlock();
+        shard.unlock();
+    }
 }
 
 void SipTransactionList::deleteTransactionTimers()
 {
-    lock();
-
-    int numTransactions = mTransactions.entries();
-    if(numTransactions > 0)
+    for(int shardIndex = 0; shardIndex < SIP_TRANSACTION_LIST_SHARDS; shardIndex++)
     {
-        UtlHashBagIterator iterator(mTransactions);
+        SipTransactionListShard& shard = *mpShards[shardIndex];
+        shard.lock();
+
+        UtlHashBagIterator iterator(shard.mTransactions);
         SipTransaction* transactionFound = NULL;
 
         while((transactionFound = (SipTransaction*) iterator()))
         {
             transactionFound->deleteTimers();
         }
-    }
 
-    unlock();
+        shard.unlock();
+    }
 }
 
 void SipTransactionList::toString(UtlString& string)
 {
-    lock();
-
     string.remove(0);
 
-    UtlHashBagIterator iterator(mTransactions);
-    SipTransaction* transactionFound = NULL;
     UtlString oneTransactionString;
-
-    while((transactionFound = (SipTransaction*) iterator()))
+    for(int shardIndex = 0; shardIndex < SIP_TRANSACTION_LIST_SHARDS; shardIndex++)
     {
-        transactionFound->toString(oneTransactionString, FALSE);
-        string.append(oneTransactionString);
-        oneTransactionString.remove(0);
-    }
+        SipTransactionListShard& shard = *mpShards[shardIndex];
+        shard.lock();
 
-    unlock();
+        UtlHashBagIterator iterator(shard.mTransactions);
+        SipTransaction* transactionFound = NULL;
+
+        while((transactionFound = (SipTransaction*) iterator()))
+        {
+            transactionFound->toString(oneTransactionString, FALSE);
+            string.append(oneTransactionString);
+            oneTransactionString.remove(0);
+        }
+
+        shard.unlock();
+    }
 }
 
 void SipTransactionList::toStringWithRelations(UtlString& string,
                                                SipMessage& message,
                                                UtlBoolean isOutGoing)
 {
-    lock();
-
     string.remove(0);
 
-    UtlHashBagIterator iterator(mTransactions);
-    SipTransaction* transactionFound = NULL;
     UtlString oneTransactionString;
     SipTransaction::messageRelationship relation;
     UtlString relationString;
 
-    while((transactionFound = (SipTransaction*) iterator()))
+    for(int shardIndex = 0; shardIndex < SIP_TRANSACTION_LIST_SHARDS; shardIndex++)
     {
-        relation = transactionFound->whatRelation(message, isOutGoing);
-        SipTransaction::getRelationshipString(relation, relationString);
-        string.append(relationString);
-        string.append(" ");
+        SipTransactionListShard& shard = *mpShards[shardIndex];
+        shard.lock();
 
+        UtlHashBagIterator iterator(shard.mTransactions);
+        SipTransaction* transactionFound = NULL;
 
-        transactionFound->toString(oneTransactionString, FALSE);
-        string.append(oneTransactionString);
-        oneTransactionString.remove(0);
+        while((transactionFound = (SipTransaction*) iterator()))
+        {
+            relation = transactionFound->whatRelation(message, isOutGoing);
+            SipTransaction::getRelationshipString(relation, relationString);
+            string.append(relationString);
+            string.append(" ");
 
-        string.append("\n");
-    }
 
-    unlock();
+            transactionFound->toString(oneTransactionString, FALSE);
+            string.append(oneTransactionString);
+            oneTransactionString.remove(0);
+
+            string.append("\n");
+        }
+
+        shard.unlock();
+    }
 }
 
-void SipTransactionList::lock()
+void SipTransactionList::removeExpired(SipTransactionListShard& shard,
+                                       UtlSList& expiryQueue,
+                                       long oldestTime,
+                                       SipTransaction**& transactionsToBeDeleted,
+                                       int& deleteCount,
+                                       int& busyCount)
 {
-    mListMutex.acquire();
+    UtlSList busyEntries;
+    SipTransactionListEntry* entry;
+
+    while((entry = (SipTransactionListEntry*) expiryQueue.first()) &&
+          entry->mQueueTime < oldestTime)
+    {
+        expiryQueue.get();
+        SipTransaction* transactionFound = entry->mpTransaction;
+        long transTime = transactionFound->getTimeStamp();
+
+        if(transTime >= oldestTime)
+        {
+            // Touched since it was queued, queue it again
+            entry->mQueueTime = transTime;
+            appendToExpiryQueue(expiryQueue, entry);
+        }
+        else if(transactionFound->isBusy())
+        {
+            // Look at it again next time
+            busyCount++;
+            busyEntries.append(entry);
+        }
+        else
+        {
+            // Remove it from the list
+            shard.mTransactions.removeReference(transactionFound);
+            if(!entry->isNull())
+            {
+                shard.mBranchIndex.removeReference(entry);
+            }
+            delete entry;
+
+            OsSysLog::add(FAC_SIP, PRI_DEBUG, "removing transaction %p\n",transactionFound);
+
+            // Make sure we have a pointer array to hold it
+            if(transactionsToBeDeleted == NULL)
+            {
+                 transactionsToBeDeleted =
+                    new SipTransaction*[shard.mTransactions.entries() + 1];
+            }
+
+            // Put it in the pointer array
+            transactionsToBeDeleted[deleteCount] = transactionFound;
+            deleteCount++;
+
+            // Make sure the events waiting for the transaction
+            // to be available are signaled before we delete
+            // any of the transactions or we end up with
+            // incomplete transaction trees (i.e. deleted branches)
+            transactionFound->signalAllAvailable();
+        }
+    }
+
+    // Busy transactions are older than the rest of the queue
+    int busyIndex = 0;
+    while((entry = (SipTransactionListEntry*) busyEntries.get()))
+    {
+        expiryQueue.insertAt(busyIndex++, entry);
+    }
 }
 
-void SipTransactionList::unlock()
+UtlBoolean SipTransactionList::isTransactionFor(SipTransaction* transaction,
+                                                const SipMessage& message,
+                                                UtlBoolean isOutgoing,
+                                                const SipTransaction* messageTransaction,
+                                                enum SipTransaction::messageRelationship& relationship)
 {
-    mListMutex.release();
+    // If the message knows its SIP transaction
+    // and the found transaction pointer does not match, skip the
+    // expensive relationship calculation
+    // The messageTransaction MUST BE TREATED AS OPAQUE
+    // as it may have been deleted.
+    if(   messageTransaction && transaction != messageTransaction )
+    {
+       return(FALSE);
+    }
+
+    // If the transaction has never sent the original rquest
+    // it should never get a match for any messages.
+    if(   messageTransaction == NULL // this message does not point to this TX
+       && ((transaction->getState()) == SipTransaction::TRANSACTION_LOCALLY_INIITATED)
+       )
+    {
+        return(FALSE);
+    }
+
+    relationship = transaction->whatRelation(message, isOutgoing);
+    return(relationship == SipTransaction::MESSAGE_REQUEST ||
+           relationship ==  SipTransaction::MESSAGE_PROVISIONAL ||
+           relationship ==  SipTransaction::MESSAGE_FINAL ||
+           relationship ==  SipTransaction::MESSAGE_NEW_FINAL ||
+           relationship ==  SipTransaction::MESSAGE_CANCEL ||
+           relationship ==  SipTransaction::MESSAGE_CANCEL_RESPONSE ||
+           relationship ==  SipTransaction::MESSAGE_ACK ||
+           relationship ==  SipTransaction::MESSAGE_2XX_ACK ||
+           relationship ==  SipTransaction::MESSAGE_DUPLICATE);
 }
 
 UtlBoolean SipTransactionList::waitUntilAvailable(SipTransaction* transaction,
                                                  const UtlString& hash)
+{
+    return(waitUntilAvailable(getShardForHash(hash), transaction, hash));
+}
+
+UtlBoolean SipTransactionList::waitUntilAvailable(SipTransactionListShard& shard,
+                                                 SipTransaction* transaction,
+                                                 const UtlString& hash)
 {
     UtlBoolean exists;
     UtlBoolean busy = FALSE;
@@ -439,8 +595,8 @@ UtlBoolean SipTransactionList::waitUntilAvailable(SipTransaction* transaction,
     {
         numTries++;
 
-        lock();
-        exists = transactionExists(transaction, hash);
+        shard.lock();
+        exists = transactionExists(shard, transaction, hash);
 
         if(exists)
         {
@@ -448,7 +604,7 @@ UtlBoolean SipTransactionList::waitUntilAvailable(SipTransaction* transaction,
             if(!busy)
             {
                 transaction->markBusy();
-                unlock();
+                shard.unlock();
 //#ifdef TEST_PRINT
                 OsSysLog::add(FAC_SIP, PRI_DEBUG, "SipTransactionList::waitUntilAvailable %p locked after %d tries\n",
                     transaction, numTries);
@@ -462,7 +618,7 @@ UtlBoolean SipTransactionList::waitUntilAvailable(SipTransaction* transaction,
                 transaction->notifyWhenAvailable(waitEvent);
 
                 // Must unlock while we wait or there is a dead lock
-                unlock();
+                shard.unlock();
 
 //#ifdef TEST_PRINT
                 OsSysLog::add(FAC_SIP, PRI_DEBUG, "SipTransactionList::waitUntilAvailable %p waiting on: %p after %d tries\n",
@@ -521,7 +677,7 @@ UtlBoolean SipTransactionList::waitUntilAvailable(SipTransaction* transaction,
         }
         else
         {
-            unlock();
+            shard.unlock();
 //#ifdef TEST_PRINT
             OsSysLog::add(FAC_SIP, PRI_DEBUG, "SipTransactionList::waitUntilAvailable %p gone after %d tries\n",
                     transaction, numTries);
@@ -535,7 +691,11 @@ UtlBoolean SipTransactionList::waitUntilAvailable(SipTransaction* transaction,
 
 void SipTransactionList::markAvailable(SipTransaction& transaction)
 {
-    lock();
+    UtlString callId;
+    transaction.getCallId(callId);
+    SipTransactionListShard& shard = getShard(callId.data(), callId.length());
+
+    shard.lock();
 
     if(!transaction.isBusy())
     {
@@ -549,7 +709,7 @@ void SipTransactionList::markAvailable(SipTransaction& transaction)
         transaction.markAvailable();
     }
 
-    unlock();
+    shard.unlock();
 }
 
 /* ============================ ACCESSORS ================================= */
@@ -558,11 +718,73 @@ void SipTransactionList::markAvailable(SipTransaction& transaction)
 
 UtlBoolean SipTransactionList::transactionExists(const SipTransaction* transaction,
                                                 const UtlString& hash)
+{
+    SipTransactionListShard& shard = getShardForHash(hash);
+
+    shard.lock();
+    UtlBoolean foundTransaction = transactionExists(shard, transaction, hash);
+    shard.unlock();
+
+    return(foundTransaction);
+}
+
+int SipTransactionList::getTransactionCount()
+{
+    int numTransactions = 0;
+    for(int shardIndex = 0; shardIndex < SIP_TRANSACTION_LIST_SHARDS; shardIndex++)
+    {
+        SipTransactionListShard& shard = *mpShards[shardIndex];
+        shard.lock();
+        numTransactions += shard.mTransactions.entries();
+        shard.unlock();
+    }
+
+    return(numTransactions);
+}
+
+/* //////////////////////////// PROTECTED ///////////////////////////////// */
+
+SipTransactionListShard& SipTransactionList::getShard(const char* callId,
+                                                      int callIdLength)
+{
+    // Same as UtlString::hash(), mixed as the shard count is small
+    unsigned hashValue = 0;
+    for(int charIndex = 0; charIndex < callIdLength; charIndex++)
+    {
+        hashValue = (hashValue << 5) - hashValue + callId[charIndex];
+    }
+    hashValue ^= hashValue >> 16;
+
+    return(*mpShards[hashValue % SIP_TRANSACTION_LIST_SHARDS]);
+}
+
+SipTransactionListShard& SipTransactionList::getShardForHash(const UtlString& hash)
+{
+    // The hash is the Call-ID, 's' or 'c' and the CSeq number
+    const char* hashData = hash.data();
+    int callIdLength = hash.length();
+    while(callIdLength > 0 &&
+          (isdigit(hashData[callIdLength - 1]) ||
+           hashData[callIdLength - 1] == '-'))
+    {
+        callIdLength--;
+    }
+    if(callIdLength > 0)
+    {
+        callIdLength--;
+    }
+
+    return(getShard(hashData, callIdLength));
+}
+
+UtlBoolean SipTransactionList::transactionExists(SipTransactionListShard& shard,
+                                                const SipTransaction* transaction,
+                                                const UtlString& hash)
 {
     UtlBoolean foundTransaction = FALSE;
     SipTransaction* aTransaction = NULL;
     UtlString matchTransaction(hash);
-    UtlHashBagIterator iterator(mTransactions, &matchTransaction);
+    UtlHashBagIterator iterator(shard.mTransactions, &matchTransaction);
 
     while ((aTransaction = (SipTransaction*) iterator()))
     {
@@ -582,8 +804,6 @@ UtlBoolean SipTransactionList::transactionExists(const SipTransaction* transacti
     return(foundTransaction);
 }
 
-/* //////////////////////////// PROTECTED ///////////////////////////////// */
-
 /* //////////////////////////// PRIVATE /////////////////////////////////// */
 
 /* ============================ FUNCTIONS ================================= */
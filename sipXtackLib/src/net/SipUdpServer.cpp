@@ -180,12 +180,14 @@ SipUdpServer::SipUdpServer(int port,
                            SipUserAgent* userAgent,
                            int udpReadBufferSize,
                            UtlBoolean bUseNextAvailablePort,
-                           const char* szBoundIp) :
+                           const char* szBoundIp,
+                           int numReceivers) :
    SipProtocolServerBase(userAgent, "UDP", "SipUdpServer-%d"),
    mStunRefreshSecs(28), 
    mStunPort(PORT_NONE),
         mKeepAliveMutex(OsRWMutex::Q_FIFO),
-   mMapLock(OsMutex::Q_FIFO)   
+   mMapLock(OsMutex::Q_FIFO),
+   mNumReceivers(numReceivers > 1 ? numReceivers : 1)
 {
     OsSysLog::add(FAC_SIP, PRI_DEBUG,
                   "SipUdpServer::_ port = %d, bUseNextAvailablePort = %d, szBoundIp = '%s'",
@@ -248,6 +250,16 @@ SipUdpServer::~SipUdpServer()
         }
     }
 
+    UtlSListIterator receiverIterator(mReceivers);
+    UtlVoidPtr* pReceiverContainer = NULL;
+    while ((pReceiverContainer = (UtlVoidPtr*)receiverIterator()))
+    {
+        pServer = (SipClient*)pReceiverContainer->getValue();
+        pServer->requestShutdown();
+        delete pServer;
+    }
+
+    mReceivers.destroyAll();
     mServers.destroyAll();
     mServerPortMap.destroyAll();    
     mServerSocketMap.destroyAll();
@@ -261,8 +273,9 @@ OsStatus SipUdpServer::createServerSocket(const char* szBoundIp,
                                           int udpReadBufferSize)
 {
     OsStatus rc = OS_FAILED;
+    UtlBoolean bReusePort = (mNumReceivers > 1);
     OsNatDatagramSocket* pSocket =
-      new OsNatDatagramSocket(0, NULL, port, szBoundIp, NULL);
+      new OsNatDatagramSocket(0, NULL, port, szBoundIp, NULL, bReusePort);
    
     if (pSocket)
     {
@@ -273,7 +286,8 @@ OsStatus SipUdpServer::createServerSocket(const char* szBoundIp,
             for (int i=1; i<=SIP_MAX_PORT_RANGE; i++)
             {
                 delete pSocket ;
-                pSocket = new OsNatDatagramSocket(0, NULL, port+i, szBoundIp, NULL);
+                pSocket = new OsNatDatagramSocket(0, NULL, port+i, szBoundIp,
+                                                  NULL, bReusePort);
                 if (pSocket->isOk())
                 {
                     break ;
@@ -341,6 +355,32 @@ OsStatus SipUdpServer::createServerSocket(const char* szBoundIp,
                         sockbufsize, size);
         #endif /* LOG_SIZE */
         }
+
+        // More sockets on the same port, each read by its own SipClient
+        for (int i = 1; i < mNumReceivers && pSocket->isOk(); i++)
+        {
+            OsNatDatagramSocket* pReceiverSocket =
+                new OsNatDatagramSocket(0, NULL, port, szBoundIp, NULL, TRUE);
+            if (!pReceiverSocket->isOk())
+            {
+                OsSysLog::add(FAC_SIP, PRI_ERR,
+                              "SipUdpServer::createServerSocket cannot add receiver %d on %s:%d",
+                              i, szBoundIp, port);
+                delete pReceiverSocket;
+                break;
+            }
+
+            pReceiverSocket->enableTransparentReads(false);
+            if(udpReadBufferSize > 0)
+            {
+                setsockopt(pReceiverSocket->getSocketDescriptor(),
+                           SOL_SOCKET,
+                           SO_RCVBUF,
+                           (char*)&udpReadBufferSize,
+                           sizeof(int));
+            }
+            mReceivers.append(new UtlVoidPtr(new SipClient(pReceiverSocket)));
+        }
     }
     return rc;
 }
@@ -354,6 +394,30 @@ int SipUdpServer::run(void* runArg)
 }
 
 
+UtlBoolean SipUdpServer::startListener()
+{
+    UtlBoolean bStarted = SipProtocolServerBase::startListener();
+
+    OsLock lock(mMapLock);
+    UtlSListIterator iterator(mReceivers);
+    UtlVoidPtr* pReceiverContainer = NULL;
+    while ((pReceiverContainer = (UtlVoidPtr*)iterator()))
+    {
+        SipClient* pReceiver = (SipClient*)pReceiverContainer->getValue();
+        if (mSipUserAgent)
+        {
+            pReceiver->setUserAgent(mSipUserAgent);
+        }
+        if (!pReceiver->isStarted())
+        {
+            pReceiver->start();
+        }
+    }
+
+    return bStarted;
+}
+
+
 void SipUdpServer::enableStun(const char* szStunServer,
                               int iStunPort,
                               const char* szLocalIp, 
@@ -456,6 +520,13 @@ void SipUdpServer::shutdownListener()
             pServer->requestShutdown();
         }
     }
+
+    UtlSListIterator receiverIterator(mReceivers);
+    while ((pServerContainer = (UtlVoidPtr*)receiverIterator()))
+    {
+        pServer = (SipClient*)pServerContainer->getValue();
+        pServer->requestShutdown();
+    }
 }
 
 
@@ -822,6 +893,11 @@ void SipUdpServer::updateSipKeepAlive(const char* szLocalIp,
 
 void SipUdpServer::printStatus()
 {
+    long wakeups;
+    long packets;
+    int maxPackets;
+    getReceiveStats(wakeups, packets, maxPackets);
+
     OsLock lock(mMapLock);
     SipClient* pServer = NULL;
     UtlHashMapIterator iterator(mServers);
@@ -847,6 +923,50 @@ void SipUdpServer::printStatus()
             SipProtocolServerBase::printStatus();
         }
     }
+
+    osPrintf("UDP server %p receivers: %d wakeups: %ld packets: %ld max per wakeup: %d\n",
+        this, mNumReceivers, wakeups, packets, maxPackets);
+}
+
+// Add the batched read counts of the SipClient in pServerContainer
+static void addBatchReadStats(UtlVoidPtr* pServerContainer,
+                              long& wakeups, long& packets, int& maxPackets)
+{
+    long clientWakeups;
+    long clientPackets;
+    int clientMaxPackets;
+    SipClient* pServer = (SipClient*)pServerContainer->getValue();
+
+    pServer->getBatchReadStats(clientWakeups, clientPackets, clientMaxPackets);
+    wakeups += clientWakeups;
+    packets += clientPackets;
+    if (clientMaxPackets > maxPackets)
+    {
+        maxPackets = clientMaxPackets;
+    }
+}
+
+void SipUdpServer::getReceiveStats(long& wakeups, long& packets, int& maxPackets)
+{
+    OsLock lock(mMapLock);
+    UtlHashMapIterator iterator(mServers);
+    UtlSListIterator receiverIterator(mReceivers);
+    UtlVoidPtr* pServerContainer = NULL;
+
+    wakeups = 0;
+    packets = 0;
+    maxPackets = 0;
+
+    // The SipClient of the first socket of each address, then the others
+    while (iterator())
+    {
+        addBatchReadStats((UtlVoidPtr*)iterator.value(),
+                          wakeups, packets, maxPackets);
+    }
+    while ((pServerContainer = (UtlVoidPtr*)receiverIterator()))
+    {
+        addBatchReadStats(pServerContainer, wakeups, packets, maxPackets);
+    }
 }
 
 int SipUdpServer::getServerPort(const char* szLocalIp) 
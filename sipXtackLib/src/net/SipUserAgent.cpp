@@ -54,6 +54,7 @@
 #include <os/OsRpcMsg.h>
 #include <os/OsConfigDb.h>
 #include <os/OsRWMutex.h>
+#include <os/OsLock.h>
 #include <os/OsReadLock.h>
 #include <os/OsWriteLock.h>
 #ifndef _WIN32
@@ -153,6 +154,8 @@ SipUserAgent::SipUserAgent(int sipTcpPort,
         , mbShortNames(false)
         , mAcceptLanguage()
         , mpLastSipMessage(NULL)
+        , mDnsSrvLookupsPending(0)
+        , mDnsSrvLookupMutex(OsMutex::Q_FIFO)
 {    
    OsSysLog::add(FAC_SIP, PRI_DEBUG,
                  "SipUserAgent::_ sipTcpPort = %d, sipUdpPort = %d, sipTlsPort = %d",
@@ -431,6 +434,8 @@ SipUserAgent::SipUserAgent(const SipUserAgent& rSipUserAgent) :
         , mbShortNames(false)
         , mAcceptLanguage()
         , mRegisterTimeoutSeconds(4)
+        , mDnsSrvLookupsPending(0)
+        , mDnsSrvLookupMutex(OsMutex::Q_FIFO)
 {
 }
 
@@ -449,6 +454,20 @@ SipUserAgent::~SipUserAgent()
     // might access something we are about to delete here.
     waitUntilShutDown();
 
+    // Lookups of lookupServersAsync() post to our queue when they are
+    // done, wait for those still going.
+    while (TRUE)
+    {
+       {
+          OsLock lock(mDnsSrvLookupMutex);
+          if (mDnsSrvLookupsPending == 0)
+          {
+             break;
+          }
+       }
+       OsTask::delay(10);
+    }
+
     if(mSipTcpServer)
     {
        OsSysLog::add(FAC_SIP, PRI_INFO,
@@ -2324,6 +2343,50 @@ void SipUserAgent::queueMessageToObservers(SipMessage* message,
    message = NULL;
 }
 
+void SipUserAgent::dispatchDelayedMessage(const SipMessage& sipMessage,
+                                          SipMessage* delayedDispatchMessage)
+{
+   // Only bother processing if the logs are enabled
+   if (    isMessageLoggingEnabled() ||
+       OsSysLog::willLog(FAC_SIP_INCOMING_PARSED, PRI_DEBUG))
+   {
+      UtlString delayMsgString;
+      int delayMsgLen;
+      delayedDispatchMessage->getBytes(&delayMsgString,
+                                       &delayMsgLen);
+      delayMsgString.insert(0, "SIP User agent delayed dispatch message:\n");
+      delayMsgString.append("++++++++++++++++++++END++++++++++++++++++++\n");
+#ifdef TEST_PRINT
+      osPrintf("%s", delayMsgString.data());
+#endif
+      logMessage(delayMsgString.data(), delayMsgString.length());
+      OsSysLog::add(FAC_SIP_INCOMING_PARSED, PRI_DEBUG,"%s",
+                    delayMsgString.data());
+   }
+
+   // wdn - if the request has a responseQueue, post the response.
+   OsMsgQ* responseQ = NULL;
+   responseQ =  sipMessage.getResponseListenerQueue();
+   if ( responseQ &&
+        !sipMessage.isResponse() &&
+        delayedDispatchMessage->isResponse())
+   {
+       SipMessage *messageToQ = new SipMessage(*delayedDispatchMessage);
+
+       messageToQ->setResponseListenerData(sipMessage.getResponseListenerData());
+       SipMessageEvent eventMsg(messageToQ);
+       eventMsg.setMessageStatus(SipMessageEvent::APPLICATION);
+       responseQ->send(eventMsg);
+       // The SipMessage gets freed with the SipMessageEvent
+       messageToQ = NULL;
+   }
+
+   // delayedDispatchMessage gets freed in queueMessageToObservers
+   queueMessageToObservers(delayedDispatchMessage,
+                           SipMessageEvent::APPLICATION
+                           );
+}
+
 void SipUserAgent::queueMessageToInterestedObservers(SipMessageEvent& event,
                                                      const UtlString& method)
 {
@@ -2497,6 +2560,55 @@ UtlBoolean SipUserAgent::handleMessage(OsMsg& eventMessage)
              pUdpServer->sendSipKeepAlive(pTimer) ;
           }
       } 
+      // A lookup of lookupServersAsync() is done
+      else if (msgSubType == SipUserAgent::DNS_SRV_LOOKUP_MESSAGE)
+      {
+         OsPtrMsg& msg = (OsPtrMsg&) eventMessage;
+         SipMessage* request = (SipMessage*) msg.getPtr();
+         server_t* servers = (server_t*) msg.getPtr2();
+
+         // The request carries the via which identifies the transaction,
+         // as for the timers.  It may have ended while waiting for DNS.
+         enum SipTransaction::messageRelationship relationship;
+         SipTransaction* transaction =
+            mSipTransactions.findTransactionFor(*request,
+                                                TRUE, // outgoing
+                                                relationship);
+         if(transaction && mbShuttingDown)
+         {
+            mSipTransactions.markAvailable(*transaction);
+            transaction = NULL;
+         }
+
+         if(transaction)
+         {
+            SipMessage* delayedDispatchMessage = NULL;
+            transaction->handleDnsSrvLookup(servers,
+                                            *this,
+                                            mSipTransactions,
+                                            delayedDispatchMessage);
+            // The transaction owns the servers now
+            servers = NULL;
+
+            mSipTransactions.markAvailable(*transaction);
+
+            if(delayedDispatchMessage)
+            {
+               // delayedDispatchMessage gets freed in dispatchDelayedMessage
+               dispatchDelayedMessage(*request, delayedDispatchMessage);
+               delayedDispatchMessage = NULL;
+            }
+         }
+         else
+         {
+            OsSysLog::add(FAC_SIP, PRI_DEBUG,
+                          "SipUserAgent::handleMessage "
+                          "DNS SRV lookup done with no matching transaction");
+         }
+
+         delete[] servers;
+         delete request;
+      }
       else
       {
          SipMessage* sipMsg = (SipMessage*)((SipMessageEvent&)eventMessage).getMessage();
@@ -2784,47 +2896,8 @@ UtlBoolean SipUserAgent::handleMessage(OsMsg& eventMessage)
 
                   if(delayedDispatchMessage)
                   {
-                     // Only bother processing if the logs are enabled
-                     if (    isMessageLoggingEnabled() ||
-                         OsSysLog::willLog(FAC_SIP_INCOMING_PARSED, PRI_DEBUG))
-                     {
-                        UtlString delayMsgString;
-                        int delayMsgLen;
-                        delayedDispatchMessage->getBytes(&delayMsgString,
-                                                         &delayMsgLen);
-                        delayMsgString.insert(0, "SIP User agent delayed dispatch message:\n");
-                        delayMsgString.append("++++++++++++++++++++END++++++++++++++++++++\n");
-#ifdef TEST_PRINT
-                        osPrintf("%s", delayMsgString.data());
-#endif
-                        logMessage(delayMsgString.data(), delayMsgString.length());
-                        OsSysLog::add(FAC_SIP_INCOMING_PARSED, PRI_DEBUG,"%s",
-                                      delayMsgString.data());
-                     }
-
-                     // wdn - if the request has a responseQueue, post the response.
-                     OsMsgQ* responseQ = NULL;
-                     responseQ =  sipMessage->getResponseListenerQueue();
-                     if ( responseQ &&
-                          !sipMessage->isResponse() &&
-                          delayedDispatchMessage->isResponse())
-                     {
-                         SipMessage *messageToQ = new SipMessage(*delayedDispatchMessage);
-
-                         messageToQ->setResponseListenerData(sipMessage->getResponseListenerData());
-                         SipMessageEvent eventMsg(messageToQ);
-                         eventMsg.setMessageStatus(SipMessageEvent::APPLICATION);
-                         responseQ->send(eventMsg);
-                         // The SipMessage gets freed with the SipMessageEvent
-                         messageToQ = NULL;
-                     }
-
-                     // delayedDispatchMessage gets freed in queueMessageToObservers
-                     queueMessageToObservers(delayedDispatchMessage,
-                                             SipMessageEvent::APPLICATION
-                                             );
-
-                     //delayedDispatchMessage gets freed in queueMessageToObservers
+                     // delayedDispatchMessage gets freed in dispatchDelayedMessage
+                     dispatchDelayedMessage(*sipMessage, delayedDispatchMessage);
                      delayedDispatchMessage = NULL;
                   }
                }
@@ -4128,6 +4201,55 @@ UtlBoolean SipUserAgent::resendWithAuthorization(SipMessage* response,
     return(requestResent);
 }
 
+/// A lookup of SipUserAgent::lookupServersAsync() which has not called back.
+struct SipUserAgentDnsSrvLookup
+{
+   SipUserAgent* mpUserAgent;
+   SipMessage* mpRequest;
+};
+
+void SipUserAgent::lookupServersAsync(SipMessage* request,
+                                      const char* domain,
+                                      const char* service,
+                                      OsSocket::IpProtocolSocketType socketType,
+                                      int port,
+                                      const char* srcIp)
+{
+   SipUserAgentDnsSrvLookup* lookup = new SipUserAgentDnsSrvLookup;
+   lookup->mpUserAgent = this;
+   lookup->mpRequest = request;
+   {
+      OsLock lock(mDnsSrvLookupMutex);
+      mDnsSrvLookupsPending++;
+   }
+
+   SipSrvLookup::serversAsync(domain, service, socketType, port, srcIp,
+                              dnsSrvLookupDone, lookup);
+}
+
+void SipUserAgent::dnsSrvLookupDone(server_t* servers, void* userData)
+{
+   SipUserAgentDnsSrvLookup* lookup = (SipUserAgentDnsSrvLookup*) userData;
+   SipUserAgent* userAgent = lookup->mpUserAgent;
+   SipMessage* request = lookup->mpRequest;
+   delete lookup;
+
+   // The user agent is not deleted while a lookup is pending, see
+   // ~SipUserAgent().  Do not wait for room in the queue once it stops.
+   OsLock lock(userAgent->mDnsSrvLookupMutex);
+   OsPtrMsg msg(OsMsg::PHONE_APP, DNS_SRV_LOOKUP_MESSAGE, request, servers);
+   if (userAgent->postMessage(msg,
+                              userAgent->mbShuttingDown ?
+                              OsTime::NO_WAIT_TIME : OsTime::OS_INFINITY) != OS_SUCCESS)
+   {
+      OsSysLog::add(FAC_SIP, PRI_ERR,
+                    "SipUserAgent::dnsSrvLookupDone could not post the result");
+      delete[] servers;
+      delete request;
+   }
+   userAgent->mDnsSrvLookupsPending--;
+}
+
 void SipUserAgent::lookupSRVSipAddress(UtlString protocol, UtlString& sipAddress, int& port, UtlString& srcIp)
 {
     OsSocket::IpProtocolSocketType transport = OsSocket::UNKNOWN;
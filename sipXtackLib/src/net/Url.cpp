@@ -196,8 +196,83 @@ const RegEx AllDigits("^\\+?[0-9*]++$");
 // The end of the value (allowing optional whitespace)
 const RegEx TheEnd("^" SWS "$");
 
+/* =========================================================================
+ * Character classes of the regular expressions above, used by parseFast.
+ * If you change a regular expression, change the matching class and run
+ * the testFastParseDifferential test in ../test/net/UrlTest.cpp.
+ * ========================================================================= */
+
+// Longer strings are left to the regular expressions, whose results
+// depend on the recursion limit for long enough components.
+#define FAST_PARSE_MAX_LENGTH 256
+
+// \s, except that parseFast gives up on '\v' and '\n'
+static inline UtlBoolean isSws(char c)
+{
+   return c == ' ' || c == '\t' || c == '\r' || c == '\f';
+}
+
+static inline UtlBoolean isAlnum(char c)
+{
+   return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9');
+}
+
+static inline UtlBoolean isHex(char c)
+{
+   return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+// SIP_TOKEN
+static inline UtlBoolean isSipTokenChar(char c)
+{
+   return isAlnum(c) || (c != '\0' && strchr(".!%*#_+`'~-", c) != NULL);
+}
+
+// The user part of UsernameAndPassword, not including escapes
+static inline UtlBoolean isUserChar(char c)
+{
+   return isAlnum(c) || (c != '\0' && strchr("_.!~*#'()&=+$,;?/-", c) != NULL);
+}
+
+// The password part of UsernameAndPassword, not including escapes
+static inline UtlBoolean isPasswordChar(char c)
+{
+   return isAlnum(c) || (c != '\0' && strchr("_.!~*#'()&=+$,-", c) != NULL);
+}
+
+// Skip a run of user or password characters and "%" HEX HEX escapes
+static int skipUserChars(const char* s, int i, UtlBoolean password)
+{
+   for (;;)
+   {
+      if (password ? isPasswordChar(s[i]) : isUserChar(s[i]))
+      {
+         i++;
+      }
+      else if (s[i] == '%' && isHex(s[i+1]) && isHex(s[i+2]))
+      {
+         i += 3;
+      }
+      else
+      {
+         return i;
+      }
+   }
+}
+
+static inline int skipSws(const char* s, int i)
+{
+   while (isSws(s[i]))
+   {
+      i++;
+   }
+   return i;
+}
+
 // STATIC VARIABLE INITIALIZATIONS
 
+UtlBoolean Url::sFastParse = TRUE;
+
 /* //////////////////////////// PUBLIC //////////////////////////////////// */
 
 /* ============================ CREATORS ================================== */
@@ -363,6 +438,11 @@ void Url::setScheme(Url::Scheme scheme)
    mScheme = scheme;
 }
 
+void Url::setFastParse(UtlBoolean enabled)
+{
+   sFastParse = enabled;
+}
+
 void Url::setUrlType(const char* urlProtocol)
 {
    if (urlProtocol)
@@ -1259,6 +1339,12 @@ void Url::parseString(const char* urlString, UtlBoolean isAddrSpec)
                     urlString);
    }
 
+   // Most URLs are parsed by the scanner without any regular expression
+   if (sFastParse && parseFast(urlString, isAddrSpec))
+   {
+      return;
+   }
+
    int workingOffset = 0; // begin at the beginning...
    
    size_t afterAngleBrackets = UTL_NOT_FOUND;
@@ -1559,6 +1645,343 @@ void Url::parseString(const char* urlString, UtlBoolean isAddrSpec)
 #  endif
 }
 
+UtlBoolean Url::parseFast(const char* urlString, UtlBoolean isAddrSpec)
+{
+   // Each step below is the regular expression step in parseString
+   // written out for the cases where the result is simple to know.
+   // Whenever it is not, give up before changing any component.
+
+   int angleBrackets = 0;
+   int length;
+   for (length = 0; urlString[length]; length++)
+   {
+      if (   length >= FAST_PARSE_MAX_LENGTH
+          || urlString[length] == '\n' // '.' in FieldParams does not match it
+          || urlString[length] == '\v' // \s may or may not match it
+          )
+      {
+         return FALSE;
+      }
+      if (urlString[length] == '<')
+      {
+         angleBrackets++;
+      }
+   }
+   // DisplayName and AngleBrackets search for any '<', so there must be
+   // just the one around the URI, and none in an addr-spec.
+   if (angleBrackets > (isAddrSpec ? 0 : 1))
+   {
+      return FALSE;
+   }
+
+   int workingOffset = 0;
+   int displayNameStart = -1;
+   int displayNameEnd = -1;
+   UtlBoolean displayNameQuoted = FALSE;
+   int afterAngleBrackets = -1;
+
+   if (angleBrackets)
+   {
+      // DisplayName: a quoted string or a sequence of tokens, then '<'
+      workingOffset = skipSws(urlString, 0);
+      if (urlString[workingOffset] == '"')
+      {
+         int i = workingOffset + 1;
+         while (urlString[i] != '"')
+         {
+            if (urlString[i] == '\0')
+            {
+               return FALSE;
+            }
+            else if (urlString[i] == '\\')
+            {
+               if (urlString[i+1] != '"' && urlString[i+1] != '\\')
+               {
+                  return FALSE;
+               }
+               i += 2;
+            }
+            else
+            {
+               i++;
+            }
+         }
+         displayNameQuoted = TRUE;
+         displayNameStart = workingOffset + 1;
+         displayNameEnd = i;
+         workingOffset = i + 1;
+      }
+      else if (isSipTokenChar(urlString[workingOffset]))
+      {
+         displayNameStart = workingOffset;
+         int i = workingOffset;
+         for (;;)
+         {
+            while (isSipTokenChar(urlString[i]))
+            {
+               i++;
+            }
+            displayNameEnd = i;
+            i = skipSws(urlString, i);
+            if (i == displayNameEnd || !isSipTokenChar(urlString[i]))
+            {
+               break;
+            }
+         }
+         workingOffset = displayNameEnd;
+      }
+
+      // AngleBrackets
+      int open = skipSws(urlString, workingOffset);
+      if (urlString[open] != '<')
+      {
+         return FALSE;
+      }
+      const char* close = strchr(urlString + open + 1, '>');
+      if (close == NULL || close == urlString + open + 1)
+      {
+         return FALSE;
+      }
+      workingOffset = open + 1;
+      afterAngleBrackets = close - urlString + 1;
+   }
+
+   // SupportedScheme: only sip and sips, or no scheme for an implied sip
+   Scheme scheme = UnknownUrlScheme;
+   if (isSws(urlString[workingOffset]))
+   {
+      return FALSE;
+   }
+   int schemeEnd = workingOffset;
+   while (   (urlString[schemeEnd] >= 'a' && urlString[schemeEnd] <= 'z')
+          || (urlString[schemeEnd] >= 'A' && urlString[schemeEnd] <= 'Z'))
+   {
+      schemeEnd++;
+   }
+   if (urlString[schemeEnd] == ':')
+   {
+      for (int i = SipUrlScheme; i < NUM_SUPPORTED_URL_SCHEMES; i++)
+      {
+         int nameLength = strlen(SchemeName[i]);
+         if (   nameLength == schemeEnd - workingOffset
+             && strncasecmp(SchemeName[i], urlString + workingOffset, nameLength) == 0)
+         {
+            if (i != SipUrlScheme && i != SipsUrlScheme)
+            {
+               return FALSE;
+            }
+            scheme = static_cast<Scheme>(i);
+            workingOffset = schemeEnd + 1;
+            break;
+         }
+      }
+   }
+   else if (isSws(urlString[schemeEnd]))
+   {
+      return FALSE;
+   }
+
+   // UsernameAndPassword
+   int userStart = workingOffset;
+   int userEnd = skipUserChars(urlString, userStart, FALSE);
+   int passwordStart = -1;
+   int passwordEnd = -1;
+   if (userEnd > userStart && urlString[userEnd] == '@')
+   {
+      workingOffset = userEnd + 1;
+   }
+   else if (userEnd > userStart && urlString[userEnd] == ':')
+   {
+      passwordStart = userEnd + 1;
+      passwordEnd = skipUserChars(urlString, passwordStart, TRUE);
+      if (urlString[passwordEnd] == '@')
+      {
+         workingOffset = passwordEnd + 1;
+      }
+      else
+      {
+         userEnd = userStart;
+         passwordStart = -1;
+      }
+   }
+   else
+   {
+      userEnd = userStart;
+   }
+
+   // HostAndPort: DNS names, which include IPv4 addresses, and IPv6 references.
+   // If there is no host, parseString logs the error.
+   int hostStart = workingOffset;
+   int hostEnd;
+   if (isAlnum(urlString[hostStart]))
+   {
+      // labels, each ending with the last alphanumeric of a run of alphanumerics
+      // and '-', separated by '.'; a '.' not followed by a label ends the name
+      int i = hostStart;
+      for (;;)
+      {
+         int labelEnd = i + 1;
+         for (int j = i + 1; isAlnum(urlString[j]) || urlString[j] == '-'; j++)
+         {
+            if (urlString[j] != '-')
+            {
+               labelEnd = j + 1;
+            }
+         }
+         i = labelEnd;
+         if (urlString[i] == '.')
+         {
+            i++;
+            if (isAlnum(urlString[i]))
+            {
+               continue;
+            }
+         }
+         break;
+      }
+      hostEnd = i;
+   }
+   else if (urlString[hostStart] == '[')
+   {
+      int i = hostStart + 1;
+      while (isHex(urlString[i]) || urlString[i] == ':' || urlString[i] == '.')
+      {
+         i++;
+      }
+      if (i == hostStart + 1 || urlString[i] != ']')
+      {
+         return FALSE;
+      }
+      hostEnd = i + 1;
+   }
+   else
+   {
+      return FALSE;
+   }
+   workingOffset = hostEnd;
+
+   int port = PORT_NONE;
+   if (urlString[hostEnd] == ':' && urlString[hostEnd+1] >= '0' && urlString[hostEnd+1] <= '9')
+   {
+      port = 0;
+      int i;
+      for (i = hostEnd + 1;
+           i < hostEnd + 7 && urlString[i] >= '0' && urlString[i] <= '9';
+           i++)
+      {
+         port = port * 10 + (urlString[i] - '0');
+      }
+      workingOffset = i;
+   }
+
+   // UrlParams, in an addr-spec or within angle brackets
+   int urlParamsStart = -1;
+   int urlParamsEnd = -1;
+   if (isAddrSpec || afterAngleBrackets >= 0)
+   {
+      int i = skipSws(urlString, workingOffset);
+      if (urlString[i] == ';')
+      {
+         int j = i + 1;
+         while (urlString[j] && urlString[j] != '?' && urlString[j] != '>')
+         {
+            j++;
+         }
+         if (j > i + 1)
+         {
+            urlParamsStart = i + 1;
+            urlParamsEnd = j;
+            workingOffset = j;
+         }
+      }
+   }
+
+   // HeaderOrQueryParams
+   int headerParamsStart = -1;
+   int headerParamsEnd = -1;
+   {
+      int i = skipSws(urlString, workingOffset);
+      if (urlString[i] == '?')
+      {
+         int j = i + 1;
+         while (urlString[j] && urlString[j] != '>')
+         {
+            j++;
+         }
+         if (j > i + 1)
+         {
+            headerParamsStart = i + 1;
+            headerParamsEnd = j;
+            workingOffset = urlString[j] == '>' ? j + 1 : j;
+         }
+      }
+   }
+
+   // FieldParams, after the angle brackets if there are any
+   int fieldParamsStart = -1;
+   if (!isAddrSpec)
+   {
+      if (afterAngleBrackets >= 0)
+      {
+         workingOffset = afterAngleBrackets;
+      }
+      int i = skipSws(urlString, workingOffset);
+      if (urlString[i] == ';' && urlString[i+1] != '\0')
+      {
+         fieldParamsStart = i + 1;
+      }
+   }
+
+   // The string has been scanned, now set the components
+   if (isAddrSpec)
+   {
+      mAngleBracketsIncluded = FALSE;
+   }
+   else
+   {
+      mDisplayName.remove(0);
+      if (displayNameStart >= 0)
+      {
+         if (displayNameQuoted)
+         {
+            mDisplayName.append("\"");
+         }
+         mDisplayName.append(urlString + displayNameStart, displayNameEnd - displayNameStart);
+         if (displayNameQuoted)
+         {
+            mDisplayName.append("\"");
+         }
+      }
+   }
+   // an implied scheme is sip once the host is found
+   mScheme = (scheme == UnknownUrlScheme) ? SipUrlScheme : scheme;
+   mUserId.append(urlString + userStart, userEnd - userStart);
+   if (passwordStart >= 0)
+   {
+      mPassword.append(urlString + passwordStart, passwordEnd - passwordStart);
+   }
+   mHostAddress.append(urlString + hostStart, hostEnd - hostStart);
+   if (port != PORT_NONE)
+   {
+      mHostPort = port;
+   }
+   if (urlParamsStart >= 0)
+   {
+      mRawUrlParameters.append(urlString + urlParamsStart, urlParamsEnd - urlParamsStart);
+   }
+   if (headerParamsStart >= 0)
+   {
+      mRawHeaderOrQueryParameters.append(urlString + headerParamsStart,
+                                         headerParamsEnd - headerParamsStart);
+   }
+   if (fieldParamsStart >= 0)
+   {
+      mRawFieldParameters.append(urlString + fieldParamsStart, length - fieldParamsStart);
+   }
+
+   return TRUE;
+}
+
 UtlBoolean Url::isUserHostPortEqual(const Url &url,
                                     int impliedPort
                                     ) const
@@ -14,11 +14,32 @@
 #include <sipxunit/TestUtilities.h>
 
 #include <os/OsDefs.h>
+#include <os/OsServerSocket.h>
+#include <os/OsConnectionSocket.h>
 #include <utl/UtlHashMapIterator.h>
 #include <net/HttpMessage.h>
+#include <net/HttpMessageReader.h>
 #include <net/SdpBody.h>
 #include <net/HttpBody.h>
 
+#define READER_TEST_PORT 8025
+#define READER_TEST_WAIT 2000
+
+// Collects the body passed by HttpMessageReader::readBody()
+static UtlBoolean collectBody(char* pData, int iLength,
+                              void* pOptionalData, HttpMessage* pMsg)
+{
+   UtlString* collected = (UtlString*) pOptionalData;
+   if (iLength < 0)
+   {
+      collected->append("<end>");
+   }
+   else
+   {
+      collected->append(pData, iLength);
+   }
+   return TRUE;
+}
 
 /**
  * Unittest for HttpMessage
@@ -34,6 +55,10 @@ class HttpMessageTest : public SIPX_UNIT_BASE_CLASS
     CPPUNIT_TEST(testMd5Digest);
     CPPUNIT_TEST(testEscape);
     CPPUNIT_TEST(testNoHeaders);
+    CPPUNIT_TEST(testIsWholeMessage);
+    CPPUNIT_TEST(testReaderPipelined);
+    CPPUNIT_TEST(testReaderChunked);
+    CPPUNIT_TEST(testReaderStreamed);
     CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -688,6 +713,255 @@ public:
     CPPUNIT_ASSERT_MESSAGE("message should be 4 bytes", messageLength == 4);
   }
 
+
+  void testIsWholeMessage()
+  {
+    int bytesChecked;
+    int contentLength;
+
+    // Headers not complete yet
+    const char* partialHeaders =
+       "INVITE sip:a@b SIP/2.0\r\n"
+       "Content-Length: 4\r\n";
+    CPPUNIT_ASSERT(!HttpMessage::isWholeMessage(partialHeaders,
+                                                strlen(partialHeaders),
+                                                bytesChecked, contentLength));
+    CPPUNIT_ASSERT_EQUAL(-1, bytesChecked);
+    CPPUNIT_ASSERT_EQUAL(-1, contentLength);
+
+    // Complete headers, body still being received
+    const char* partialBody =
+       "INVITE sip:a@b SIP/2.0\r\n"
+       "content-length: 4\r\n"
+       "\r\n"
+       "ab";
+    CPPUNIT_ASSERT(!HttpMessage::isWholeMessage(partialBody,
+                                                strlen(partialBody),
+                                                bytesChecked, contentLength));
+    CPPUNIT_ASSERT_EQUAL((int)strlen(partialBody) - 2, bytesChecked);
+    CPPUNIT_ASSERT_EQUAL(4, contentLength);
+
+    // Short form of Content-Length, followed by the start of another message
+    const char* twoMessages =
+       "SIP/2.0 200 OK\r\n"
+       "Via: SIP/2.0/TCP 10.1.1.1\r\n"
+       "l : 2\r\n"
+       "\r\n"
+       "okSIP/2.0 180 Ringing\r\n";
+    CPPUNIT_ASSERT(HttpMessage::isWholeMessage(twoMessages,
+                                               strlen(twoMessages),
+                                               bytesChecked, contentLength));
+    CPPUNIT_ASSERT_EQUAL(2, contentLength);
+    ASSERT_STR_EQUAL("SIP/2.0 180 Ringing\r\n",
+                     twoMessages + bytesChecked + contentLength);
+
+    // No Content-Length means no body
+    const char* noLength =
+       "OPTIONS sip:a@b SIP/2.0\r\n"
+       "Call-Id: 1234\r\n"
+       "\r\n";
+    CPPUNIT_ASSERT(HttpMessage::isWholeMessage(noLength, strlen(noLength),
+                                               bytesChecked, contentLength));
+    CPPUNIT_ASSERT_EQUAL((int)strlen(noLength), bytesChecked);
+    CPPUNIT_ASSERT_EQUAL(0, contentLength);
+
+    // A Content-Length near INT_MAX must not wrap around to a whole message
+    const char* hugeLength =
+       "INVITE sip:a@b SIP/2.0\r\n"
+       "Content-Length: 2147483600\r\n"
+       "\r\n"
+       "abc";
+    CPPUNIT_ASSERT(!HttpMessage::isWholeMessage(hugeLength,
+                                                strlen(hugeLength),
+                                                bytesChecked, contentLength));
+    CPPUNIT_ASSERT_EQUAL((int)strlen(hugeLength) - 3, bytesChecked);
+    CPPUNIT_ASSERT_EQUAL(2147483600, contentLength);
+  }
+
+  // Connect a client socket to a server socket on the local host
+  void connectSockets(OsServerSocket*& server, OsSocket*& client,
+                      OsSocket*& serverClient)
+  {
+    server = new OsServerSocket(5, READER_TEST_PORT, "127.0.0.1");
+    client = new OsConnectionSocket(READER_TEST_PORT, "127.0.0.1", FALSE);
+    serverClient = server->accept();
+    CPPUNIT_ASSERT(serverClient);
+    client->makeBlocking();
+  }
+
+  void getBody(const HttpMessage& message, UtlString& body)
+  {
+    int length;
+    body.remove(0);
+    CPPUNIT_ASSERT(message.getBody());
+    message.getBody()->getBytes(&body, &length);
+  }
+
+  void testReaderPipelined()
+  {
+    OsServerSocket* server;
+    OsSocket* client;
+    OsSocket* serverClient;
+    connectSockets(server, client, serverClient);
+
+    // Two whole requests and the start of a third in one write
+    const char* requests =
+       "POST /a HTTP/1.1\r\n"
+       "Content-Length: 5\r\n"
+       "\r\n"
+       "hello"
+       "GET /b HTTP/1.1\r\n"
+       "Host: b\r\n"
+       "\r\n"
+       "\r\n"
+       "POST /c HTTP/1.1\r\n"
+       "Content-Length: 3\r\n"
+       "\r\n"
+       "ab";
+    client->write(requests, strlen(requests));
+
+    HttpMessageReader reader(serverClient);
+    HttpMessage request;
+    UtlString body;
+    int bytesRead = reader.read(request, READER_TEST_WAIT);
+    CPPUNIT_ASSERT_EQUAL(44, bytesRead);
+    ASSERT_STR_EQUAL("POST /a HTTP/1.1", request.getFirstHeaderLine());
+    getBody(request, body);
+    ASSERT_STR_EQUAL("hello", body.data());
+    CPPUNIT_ASSERT(reader.getBufferedLength() > 0);
+
+    // Read out of the buffer, without waiting for the socket
+    CPPUNIT_ASSERT(reader.isReadyToRead(0));
+    bytesRead = reader.read(request, READER_TEST_WAIT);
+    CPPUNIT_ASSERT_EQUAL(28, bytesRead);
+    ASSERT_STR_EQUAL("GET /b HTTP/1.1", request.getFirstHeaderLine());
+    ASSERT_STR_EQUAL("b", request.getHeaderValue(0, HTTP_HOST_FIELD));
+    CPPUNIT_ASSERT(request.getBody() == NULL);
+    CPPUNIT_ASSERT(request.getHeaderValue(0, HTTP_CONTENT_LENGTH_FIELD) == NULL);
+
+    // The rest of the third body comes later
+    client->write("c", 1);
+    CPPUNIT_ASSERT(reader.read(request, READER_TEST_WAIT) > 0);
+    ASSERT_STR_EQUAL("POST /c HTTP/1.1", request.getFirstHeaderLine());
+    getBody(request, body);
+    ASSERT_STR_EQUAL("abc", body.data());
+    CPPUNIT_ASSERT_EQUAL(0, reader.getBufferedLength());
+
+    // A body bigger than allowed closes the connection
+    HttpMessageReader smallReader(serverClient, 10);
+    const char* tooBig =
+       "POST /d HTTP/1.1\r\n"
+       "Content-Length: 11\r\n"
+       "\r\n";
+    client->write(tooBig, strlen(tooBig));
+    bytesRead = smallReader.read(request, READER_TEST_WAIT);
+    CPPUNIT_ASSERT_EQUAL(0, bytesRead);
+    CPPUNIT_ASSERT(!serverClient->isOk());
+
+    delete client;
+    delete serverClient;
+    delete server;
+  }
+
+  void testReaderChunked()
+  {
+    OsServerSocket* server;
+    OsSocket* client;
+    OsSocket* serverClient;
+    connectSockets(server, client, serverClient);
+
+    const char* responses =
+       "HTTP/1.1 200 OK\r\n"
+       "Content-Type: text/plain\r\n"
+       "Transfer-Encoding: chunked\r\n"
+       "\r\n"
+       "5;name=value\r\n"
+       "hello\r\n"
+       "7\r\n"
+       ", world\r\n"
+       "0\r\n"
+       "X-Trailer: ignored\r\n"
+       "\r\n"
+       "HTTP/1.1 204 No Content\r\n"
+       "\r\n"
+       "HTTP/1.1 200 OK\r\n"
+       "Transfer-Encoding: chunked\r\n"
+       "\r\n"
+       "zz\r\n";
+    client->write(responses, strlen(responses));
+
+    HttpMessageReader reader(serverClient);
+    HttpMessage response;
+    UtlString body;
+    CPPUNIT_ASSERT(reader.read(response, READER_TEST_WAIT) > 0);
+    CPPUNIT_ASSERT_EQUAL(200, response.getResponseStatusCode());
+    getBody(response, body);
+    ASSERT_STR_EQUAL("hello, world", body.data());
+    CPPUNIT_ASSERT_EQUAL(12, response.getContentLength());
+    CPPUNIT_ASSERT(response.getHeaderValue(0, HTTP_TRANSFER_ENCODING_FIELD) == NULL);
+
+    // No body, whatever follows
+    CPPUNIT_ASSERT(reader.read(response, READER_TEST_WAIT) > 0);
+    CPPUNIT_ASSERT_EQUAL(204, response.getResponseStatusCode());
+    CPPUNIT_ASSERT(response.getBody() == NULL);
+
+    // A bad chunk size closes the connection
+    int bytesRead = reader.read(response, READER_TEST_WAIT);
+    CPPUNIT_ASSERT_EQUAL(0, bytesRead);
+    CPPUNIT_ASSERT(!serverClient->isOk());
+
+    delete client;
+    delete serverClient;
+    delete server;
+  }
+
+  void testReaderStreamed()
+  {
+    OsServerSocket* server;
+    OsSocket* client;
+    OsSocket* serverClient;
+    connectSockets(server, client, serverClient);
+
+    const char* chunked =
+       "HTTP/1.1 200 OK\r\n"
+       "Transfer-Encoding: gzip, chunked\r\n"
+       "\r\n"
+       "3\r\n"
+       "abc\r\n"
+       "A\r\n"
+       "0123456789\r\n"
+       "0\r\n"
+       "\r\n";
+    client->write(chunked, strlen(chunked));
+
+    HttpMessageReader reader(serverClient);
+    HttpMessage response;
+    UtlString collected;
+    CPPUNIT_ASSERT(reader.readHeaders(response, READER_TEST_WAIT) > 0);
+    int bodyLength = reader.readBody(response, collectBody, &collected,
+                                     READER_TEST_WAIT);
+    CPPUNIT_ASSERT_EQUAL(13, bodyLength);
+    ASSERT_STR_EQUAL("abc0123456789<end>", collected.data());
+
+    // Without a length, the body of a response ends with the connection
+    const char* untilClose =
+       "HTTP/1.0 200 OK\r\n"
+       "\r\n"
+       "all of it";
+    client->write(untilClose, strlen(untilClose));
+    client->close();
+    collected.remove(0);
+    CPPUNIT_ASSERT(reader.readHeaders(response, READER_TEST_WAIT) > 0);
+    bodyLength = reader.readBody(response, collectBody, &collected,
+                                 READER_TEST_WAIT);
+    CPPUNIT_ASSERT_EQUAL(9, bodyLength);
+    ASSERT_STR_EQUAL("all of it<end>", collected.data());
+
+    delete client;
+    delete serverClient;
+    delete server;
+  }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(HttpMessageTest);
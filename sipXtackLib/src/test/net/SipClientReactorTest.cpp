@@ -0,0 +1,370 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+#include <sipxunittests.h>
+#include <sipxunit/TestUtilities.h>
+
+#include <limits.h>
+#include <string.h>
+
+#include <os/OsDefs.h>
+#include <os/OsBSem.h>
+#include <os/OsCSem.h>
+#include <os/OsLock.h>
+#include <os/OsMutex.h>
+#include <os/OsTask.h>
+#include <os/OsConnectionSocket.h>
+#include <os/OsServerSocket.h>
+#include <net/SipClient.h>
+#include <net/SipClientReactor.h>
+#include <net/SipUserAgentBase.h>
+
+#ifdef SIP_TCP_USE_REACTOR // [
+
+#define REACTOR_TEST_CLIENTS 4
+#define REACTOR_TEST_WAIT_SECS 5
+
+// Format a request that the client dispatches, with the given Call-ID.
+static void reactorTestRequest(UtlString& request, int callNum)
+{
+   char callId[32];
+   sprintf(callId, "reactor-%d@127.0.0.1", callNum);
+
+   request = "OPTIONS sip:bob@127.0.0.1 SIP/2.0\r\n"
+             "Via: SIP/2.0/TCP 127.0.0.1;branch=z9hG4bK-reactor\r\n"
+             "To: <sip:bob@127.0.0.1>\r\n"
+             "From: <sip:alice@127.0.0.1>;tag=reactor\r\n"
+             "Call-ID: ";
+   request.append(callId);
+   request.append("\r\n"
+                  "CSeq: 1 OPTIONS\r\n"
+                  "Content-Length: 5\r\n"
+                  "\r\n"
+                  "hello");
+}
+
+// User agent recording the messages dispatched by the clients, and the
+// task that read each of them.  Dispatching can be held to keep a read
+// in progress.
+class ReactorTestUserAgent : public SipUserAgentBase
+{
+public:
+   ReactorTestUserAgent()
+      : SipUserAgentBase(PORT_NONE, PORT_NONE, PORT_NONE)
+      , mMutex(OsMutex::Q_FIFO)
+      , mDispatched(OsCSem::Q_FIFO, INT_MAX, 0)
+      , mDispatchEntered(OsBSem::Q_FIFO, OsBSem::EMPTY)
+      , mDispatchRelease(OsBSem::Q_FIFO, OsBSem::EMPTY)
+      , mHoldDispatch(FALSE)
+      , mNumDispatched(0)
+   {
+   }
+
+   UtlBoolean handleMessage(OsMsg& eventMessage) { return FALSE; }
+   void addMessageConsumer(OsServerTask* messageConsumer) {}
+   UtlBoolean send(SipMessage& message, OsMsgQ* responseListener,
+                   void* responseListenerData, SIPX_TRANSPORT_DATA* pTransport)
+   {
+      return FALSE;
+   }
+   void logMessage(const char* message, int messageLength) {}
+   UtlBoolean isMessageLoggingEnabled() { return FALSE; }
+
+   void dispatch(SipMessage* message, int messageType,
+                 SIPX_TRANSPORT_DATA* pTransport)
+   {
+      if (mHoldDispatch)
+      {
+         mDispatchEntered.release();
+         mDispatchRelease.acquire();
+      }
+
+      {
+         OsLock lock(mMutex);
+         if (mNumDispatched < REACTOR_TEST_CLIENTS)
+         {
+            message->getCallIdField(&mCallIds[mNumDispatched]);
+            UtlString body;
+            int bodyLength;
+            message->getBody()->getBytes(&body, &bodyLength);
+            mBodies[mNumDispatched] = body;
+            mReaders[mNumDispatched] = OsTask::getCurrentTask();
+         }
+         mNumDispatched++;
+      }
+      delete message;
+      mDispatched.release();
+   }
+
+   // Wait for the next message to be dispatched.
+   UtlBoolean waitForDispatch()
+   {
+      return mDispatched.acquire(OsTime(REACTOR_TEST_WAIT_SECS, 0))
+             == OS_SUCCESS;
+   }
+
+   int numDispatched()
+   {
+      OsLock lock(mMutex);
+      return mNumDispatched;
+   }
+
+   // Task which read the message with the Call-ID, or NULL.
+   OsTaskBase* readerOf(const UtlString& callId)
+   {
+      OsLock lock(mMutex);
+      for (int i = 0; i < mNumDispatched && i < REACTOR_TEST_CLIENTS; i++)
+      {
+         if (mCallIds[i] == callId)
+         {
+            return mReaders[i];
+         }
+      }
+      return NULL;
+   }
+
+   OsMutex mMutex;
+   OsCSem mDispatched;
+   OsBSem mDispatchEntered;
+   OsBSem mDispatchRelease;
+   volatile UtlBoolean mHoldDispatch;
+   int mNumDispatched;
+   UtlString mCallIds[REACTOR_TEST_CLIENTS];
+   UtlString mBodies[REACTOR_TEST_CLIENTS];
+   OsTaskBase* mReaders[REACTOR_TEST_CLIENTS];
+};
+
+// Removes a client from the reactor, and tells when it is done.
+class ReactorTestRemover : public OsTask
+{
+public:
+   ReactorTestRemover(SipClientReactor& reactor, SipClient& client)
+      : mReactor(reactor)
+      , mClient(client)
+      , mDone(OsBSem::Q_FIFO, OsBSem::EMPTY)
+   {
+   }
+
+   ~ReactorTestRemover()
+   {
+      waitUntilShutDown();
+   }
+
+   int run(void* pArg)
+   {
+      mReactor.removeClient(&mClient);
+      mDone.release();
+      return 0;
+   }
+
+   SipClientReactor& mReactor;
+   SipClient& mClient;
+   OsBSem mDone;
+};
+
+/**
+ * Unit test for SipClientReactor and SipClient::readAvailable()
+ */
+class SipClientReactorTest : public SIPX_UNIT_BASE_CLASS
+{
+   CPPUNIT_TEST_SUITE(SipClientReactorTest);
+   CPPUNIT_TEST(testSpreadClients);
+   CPPUNIT_TEST(testRemoveDuringRead);
+   CPPUNIT_TEST(testPartialMessage);
+   CPPUNIT_TEST(testHugeContentLength);
+   CPPUNIT_TEST_SUITE_END();
+
+public:
+
+   void setUp()
+   {
+      mpServer = new OsServerSocket(REACTOR_TEST_CLIENTS, PORT_DEFAULT,
+                                    "127.0.0.1");
+      CPPUNIT_ASSERT(mpServer->isOk());
+      for (int i = 0; i < REACTOR_TEST_CLIENTS; i++)
+      {
+         mpPeers[i] = NULL;
+         mpClients[i] = NULL;
+      }
+   }
+
+   void tearDown()
+   {
+      for (int i = 0; i < REACTOR_TEST_CLIENTS; i++)
+      {
+         delete mpClients[i];
+         delete mpPeers[i];
+      }
+      delete mpServer;
+   }
+
+   // Connect a client served by the reactor to a peer socket.
+   void connectClient(int index, SipClientReactor& reactor,
+                      SipUserAgentBase& userAgent)
+   {
+      mpPeers[index] = new OsConnectionSocket(mpServer->getLocalHostPort(),
+                                              "127.0.0.1");
+      CPPUNIT_ASSERT(mpPeers[index]->isOk());
+      OsConnectionSocket* accepted = mpServer->accept();
+      CPPUNIT_ASSERT(accepted != NULL);
+
+      mpClients[index] = new SipClient(accepted);
+      mpClients[index]->setUserAgent(&userAgent);
+      CPPUNIT_ASSERT(reactor.addClient(mpClients[index]));
+      CPPUNIT_ASSERT(mpClients[index]->isServedByReactor());
+   }
+
+   void testSpreadClients()
+   {
+      ReactorTestUserAgent userAgent;
+      SipClientReactor reactor("ReactorTest", 2);
+      UtlString request;
+      UtlString callIds[REACTOR_TEST_CLIENTS];
+      int i;
+
+      for (i = 0; i < REACTOR_TEST_CLIENTS; i++)
+      {
+         connectClient(i, reactor, userAgent);
+      }
+      CPPUNIT_ASSERT_EQUAL(REACTOR_TEST_CLIENTS, reactor.getClientCount());
+
+      for (i = 0; i < REACTOR_TEST_CLIENTS; i++)
+      {
+         reactorTestRequest(request, i);
+         CPPUNIT_ASSERT_EQUAL((int) request.length(),
+                              mpPeers[i]->write(request.data(),
+                                                request.length()));
+         CPPUNIT_ASSERT(userAgent.waitForDispatch());
+
+         char callId[32];
+         sprintf(callId, "reactor-%d@127.0.0.1", i);
+         callIds[i] = callId;
+      }
+
+      // The clients are assigned to the two threads in turn.
+      OsTaskBase* readers[REACTOR_TEST_CLIENTS];
+      for (i = 0; i < REACTOR_TEST_CLIENTS; i++)
+      {
+         readers[i] = userAgent.readerOf(callIds[i]);
+         CPPUNIT_ASSERT(readers[i] != NULL);
+      }
+      CPPUNIT_ASSERT(readers[0] != readers[1]);
+      CPPUNIT_ASSERT(readers[0] == readers[2]);
+      CPPUNIT_ASSERT(readers[1] == readers[3]);
+
+      for (i = 0; i < REACTOR_TEST_CLIENTS; i++)
+      {
+         reactor.removeClient(mpClients[i]);
+         CPPUNIT_ASSERT(!mpClients[i]->isServedByReactor());
+      }
+      CPPUNIT_ASSERT_EQUAL(0, reactor.getClientCount());
+   }
+
+   void testRemoveDuringRead()
+   {
+      ReactorTestUserAgent userAgent;
+      SipClientReactor reactor("ReactorTest", 1);
+      UtlString request;
+
+      connectClient(0, reactor, userAgent);
+
+      // Hold the I/O thread in the middle of reading the client.
+      userAgent.mHoldDispatch = TRUE;
+      reactorTestRequest(request, 0);
+      CPPUNIT_ASSERT_EQUAL((int) request.length(),
+                           mpPeers[0]->write(request.data(),
+                                             request.length()));
+      CPPUNIT_ASSERT_EQUAL(OS_SUCCESS,
+         userAgent.mDispatchEntered.acquire(OsTime(REACTOR_TEST_WAIT_SECS, 0)));
+
+      // Removing the client takes it out of the reactor at once, but waits
+      // for the read to complete.
+      ReactorTestRemover remover(reactor, *mpClients[0]);
+      CPPUNIT_ASSERT(remover.start());
+      OsTask::delay(100);
+      CPPUNIT_ASSERT_EQUAL(0, reactor.getClientCount());
+      CPPUNIT_ASSERT_EQUAL(OS_BUSY, remover.mDone.tryAcquire());
+
+      userAgent.mDispatchRelease.release();
+      CPPUNIT_ASSERT_EQUAL(OS_SUCCESS,
+         remover.mDone.acquire(OsTime(REACTOR_TEST_WAIT_SECS, 0)));
+      CPPUNIT_ASSERT(userAgent.waitForDispatch());
+      CPPUNIT_ASSERT_EQUAL(1, userAgent.numDispatched());
+      CPPUNIT_ASSERT(!mpClients[0]->isServedByReactor());
+
+      // Nothing more is read from the removed client.
+      userAgent.mHoldDispatch = FALSE;
+      reactorTestRequest(request, 1);
+      mpPeers[0]->write(request.data(), request.length());
+      OsTask::delay(100);
+      CPPUNIT_ASSERT_EQUAL(1, userAgent.numDispatched());
+   }
+
+   void testPartialMessage()
+   {
+      ReactorTestUserAgent userAgent;
+      SipClientReactor reactor("ReactorTest", 1);
+      UtlString request;
+
+      connectClient(0, reactor, userAgent);
+      reactorTestRequest(request, 0);
+
+      // The first read ends in the middle of the headers: nothing is
+      // dispatched until the rest arrives.
+      int split = request.index("Call-ID") + 3;
+      CPPUNIT_ASSERT_EQUAL(split, mpPeers[0]->write(request.data(), split));
+      OsTask::delay(100);
+      CPPUNIT_ASSERT_EQUAL(0, userAgent.numDispatched());
+
+      CPPUNIT_ASSERT_EQUAL((int) request.length() - split,
+                           mpPeers[0]->write(request.data() + split,
+                                             request.length() - split));
+      CPPUNIT_ASSERT(userAgent.waitForDispatch());
+      CPPUNIT_ASSERT_EQUAL(1, userAgent.numDispatched());
+      ASSERT_STR_EQUAL("reactor-0@127.0.0.1", userAgent.mCallIds[0].data());
+      ASSERT_STR_EQUAL("hello", userAgent.mBodies[0].data());
+
+      reactor.removeClient(mpClients[0]);
+   }
+
+   void testHugeContentLength()
+   {
+      ReactorTestUserAgent userAgent;
+      SipClientReactor reactor("ReactorTest", 1);
+      UtlString request;
+
+      connectClient(0, reactor, userAgent);
+
+      // A Content-Length near INT_MAX is refused, not framed, and the
+      // connection is dropped.
+      reactorTestRequest(request, 0);
+      request.replace(request.index("Content-Length: 5"),
+                      strlen("Content-Length: 5"),
+                      "Content-Length: 2147483600");
+      CPPUNIT_ASSERT_EQUAL((int) request.length(),
+                           mpPeers[0]->write(request.data(),
+                                             request.length()));
+      for (int i = 0;
+           i < REACTOR_TEST_WAIT_SECS * 100 && reactor.getClientCount() > 0;
+           i++)
+      {
+         OsTask::delay(10);
+      }
+      CPPUNIT_ASSERT_EQUAL(0, reactor.getClientCount());
+      CPPUNIT_ASSERT_EQUAL(0, userAgent.numDispatched());
+      CPPUNIT_ASSERT(!mpClients[0]->isOk());
+   }
+
+private:
+   OsServerSocket* mpServer;
+   OsConnectionSocket* mpPeers[REACTOR_TEST_CLIENTS];
+   SipClient* mpClients[REACTOR_TEST_CLIENTS];
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SipClientReactorTest);
+
+#endif // SIP_TCP_USE_REACTOR ]
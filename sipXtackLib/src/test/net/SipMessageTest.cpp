@@ -17,6 +17,7 @@
 #include <os/OsDefs.h>
 #include <net/SipMessage.h>
 #include <net/SipUserAgent.h>
+#include <os/OsDateTime.h>
 
 #if 0
 #include <stdio.h>
@@ -53,6 +54,8 @@ class SipMessageTest : public SIPX_UNIT_BASE_CLASS
       CPPUNIT_TEST(testCompactNames);
       CPPUNIT_TEST(testHeaderFieldAccessors);
       CPPUNIT_TEST(testApplyTargetUriHeaderParams);
+      CPPUNIT_TEST(testHeaderIndex);
+      CPPUNIT_TEST(testParseAndAccessPerformance);
       CPPUNIT_TEST_SUITE_END();
 
       public:
@@ -1781,6 +1784,187 @@ Content-Length: 0\n\
           }
           CPPUNIT_ASSERT( messageBytes.compareTo(expectedMessage) == 0);
       }
+
+      void testHeaderIndex()
+      {
+         const char* message =
+            "INVITE sip:fred@example.com SIP/2.0\r\n"
+            "Via: SIP/2.0/UDP 10.1.1.1:5060;branch=z9hG4bK-1\r\n"
+            "v: SIP/2.0/UDP 10.1.1.2:5060;branch=z9hG4bK-2\r\n"
+            "VIA: SIP/2.0/UDP 10.1.1.3:5060;branch=z9hG4bK-3\r\n"
+            "From: sip:betty@example.com;tag=1\r\n"
+            "To: sip:fred@example.com\r\n"
+            "Call-Id: 1234\r\n"
+            "CSeq: 3 INVITE\r\n"
+            "X-Custom: one\r\n"
+            "x-custom: two\r\n"
+            "Content-Length: 0\r\n"
+            "\r\n";
+         SipMessage testMsg(message, strlen(message));
+         UtlString value;
+
+         // Look the fields up more than once, so that the index is used.
+         for (int i = 0; i < 3; i++)
+         {
+            CPPUNIT_ASSERT(testMsg.getViaField(&value, 0));
+            ASSERT_STR_EQUAL("SIP/2.0/UDP 10.1.1.1:5060;branch=z9hG4bK-1", value.data());
+            CPPUNIT_ASSERT(testMsg.getViaField(&value, 1));
+            ASSERT_STR_EQUAL("SIP/2.0/UDP 10.1.1.2:5060;branch=z9hG4bK-2", value.data());
+            CPPUNIT_ASSERT(testMsg.getViaField(&value, 2));
+            ASSERT_STR_EQUAL("SIP/2.0/UDP 10.1.1.3:5060;branch=z9hG4bK-3", value.data());
+            CPPUNIT_ASSERT(!testMsg.getViaField(&value, 3));
+
+            testMsg.getCallIdField(&value);
+            ASSERT_STR_EQUAL("1234", value.data());
+
+            ASSERT_STR_EQUAL("one", testMsg.getHeaderValue(0, "X-CUSTOM"));
+            ASSERT_STR_EQUAL("two", testMsg.getHeaderValue(1, "x-Custom"));
+            CPPUNIT_ASSERT(testMsg.getHeaderValue(2, "X-Custom") == NULL);
+            CPPUNIT_ASSERT(testMsg.getHeaderValue(0, "X-Missing") == NULL);
+            CPPUNIT_ASSERT(testMsg.getHeaderValue(0, SIP_ROUTE_FIELD) == NULL);
+         }
+
+         // Changes to the fields must be seen by the following lookups.
+         testMsg.addHeaderField("X-Custom", "three");
+         testMsg.addHeaderField(SIP_SHORT_SUBJECT_FIELD, "compact");
+         testMsg.removeHeader(SIP_VIA_FIELD, 0);
+         testMsg.setHeaderValue(SIP_CALLID_FIELD, "5678", 0);
+         for (int i = 0; i < 3; i++)
+         {
+            CPPUNIT_ASSERT(testMsg.getViaField(&value, 0));
+            ASSERT_STR_EQUAL("SIP/2.0/UDP 10.1.1.2:5060;branch=z9hG4bK-2", value.data());
+            CPPUNIT_ASSERT(testMsg.getViaField(&value, 1));
+            ASSERT_STR_EQUAL("SIP/2.0/UDP 10.1.1.3:5060;branch=z9hG4bK-3", value.data());
+            CPPUNIT_ASSERT(!testMsg.getViaField(&value, 2));
+
+            testMsg.getCallIdField(&value);
+            ASSERT_STR_EQUAL("5678", value.data());
+
+            ASSERT_STR_EQUAL("three", testMsg.getHeaderValue(2, "X-Custom"));
+
+            // Compact and long names are different names here.
+            ASSERT_STR_EQUAL("compact", testMsg.getHeaderValue(0, "s"));
+            CPPUNIT_ASSERT(testMsg.getHeaderValue(0, SIP_SUBJECT_FIELD) == NULL);
+         }
+
+         // Compact names replaced by long ones are found by the long name.
+         testMsg.replaceShortFieldNames();
+         ASSERT_STR_EQUAL("compact", testMsg.getHeaderValue(0, SIP_SUBJECT_FIELD));
+         CPPUNIT_ASSERT(testMsg.getHeaderValue(0, "s") == NULL);
+
+         // A copy has its own index.
+         SipMessage copyMsg(testMsg);
+         testMsg.removeHeader(SIP_VIA_FIELD, 0);
+         for (int i = 0; i < 3; i++)
+         {
+            CPPUNIT_ASSERT(copyMsg.getViaField(&value, 1));
+            CPPUNIT_ASSERT(testMsg.getViaField(&value, 0));
+            CPPUNIT_ASSERT(!testMsg.getViaField(&value, 1));
+         }
+      }
+
+      void testParseAndAccessPerformance()
+      {
+         // Parse typical messages and get the fields which the transaction
+         // and call layers look at for every message.
+         const char* messages[] =
+         {
+            "INVITE sip:bob@biloxi.example.com SIP/2.0\r\n"
+            "Via: SIP/2.0/UDP pc33.atlanta.example.com;branch=z9hG4bKnashds8\r\n"
+            "Max-Forwards: 70\r\n"
+            "To: Bob <sip:bob@biloxi.example.com>\r\n"
+            "From: Alice <sip:alice@atlanta.example.com>;tag=1928301774\r\n"
+            "Call-ID: a84b4c76e66710@pc33.atlanta.example.com\r\n"
+            "CSeq: 314159 INVITE\r\n"
+            "Contact: <sip:alice@pc33.atlanta.example.com>\r\n"
+            "Allow: INVITE, ACK, CANCEL, OPTIONS, BYE, REFER, NOTIFY, MESSAGE, SUBSCRIBE, INFO\r\n"
+            "Supported: replaces, timer\r\n"
+            "User-Agent: sipXtapi\r\n"
+            "Content-Type: application/sdp\r\n"
+            "Content-Length: 142\r\n"
+            "\r\n"
+            "v=0\r\n"
+            "o=alice 2890844526 2890844526 IN IP4 pc33.atlanta.example.com\r\n"
+            "s=-\r\n"
+            "c=IN IP4 pc33.atlanta.example.com\r\n"
+            "t=0 0\r\n"
+            "m=audio 49172 RTP/AVP 0\r\n"
+            "a=rtpmap:0 PCMU/8000\r\n",
+
+            "SIP/2.0 200 OK\r\n"
+            "Via: SIP/2.0/UDP server10.biloxi.example.com;branch=z9hG4bKnashds8;received=192.0.2.3\r\n"
+            "Via: SIP/2.0/UDP bigbox3.site3.atlanta.example.com;branch=z9hG4bK77ef4c2312983.1;received=192.0.2.2\r\n"
+            "Via: SIP/2.0/UDP pc33.atlanta.example.com;branch=z9hG4bK776asdhds;received=192.0.2.1\r\n"
+            "Record-Route: <sip:server10.biloxi.example.com;lr>\r\n"
+            "Record-Route: <sip:bigbox3.site3.atlanta.example.com;lr>\r\n"
+            "To: Bob <sip:bob@biloxi.example.com>;tag=a6c85cf\r\n"
+            "From: Alice <sip:alice@atlanta.example.com>;tag=1928301774\r\n"
+            "Call-ID: a84b4c76e66710@pc33.atlanta.example.com\r\n"
+            "CSeq: 314159 INVITE\r\n"
+            "Contact: <sip:bob@192.0.2.4>\r\n"
+            "Content-Length: 0\r\n"
+            "\r\n",
+
+            "REGISTER sip:registrar.biloxi.example.com SIP/2.0\r\n"
+            "Via: SIP/2.0/UDP bobspc.biloxi.example.com:5060;branch=z9hG4bKnashds7\r\n"
+            "Max-Forwards: 70\r\n"
+            "To: Bob <sip:bob@biloxi.example.com>\r\n"
+            "From: Bob <sip:bob@biloxi.example.com>;tag=456248\r\n"
+            "Call-ID: 843817637684230@998sdasdh09\r\n"
+            "CSeq: 1826 REGISTER\r\n"
+            "Contact: <sip:bob@192.0.2.4>\r\n"
+            "Expires: 7200\r\n"
+            "Authorization: Digest username=\"bob\", realm=\"biloxi.example.com\", "
+            "nonce=\"dcd98b7102dd2f0e8b11d0f600bfb0c093\", uri=\"sip:biloxi.example.com\", "
+            "response=\"245f23415f11432b3434341c022\"\r\n"
+            "Content-Length: 0\r\n"
+            "\r\n"
+         };
+         const int numMessages = sizeof(messages)/sizeof(messages[0]);
+         const int numIterations = 5000;
+
+         OsTime start;
+         OsTime end;
+         OsDateTime::getCurTime(start);
+         for (int i = 0; i < numIterations; i++)
+         {
+            for (int m = 0; m < numMessages; m++)
+            {
+               SipMessage msg(messages[m], strlen(messages[m]));
+
+               UtlString callId;
+               UtlString via;
+               UtlString viaSubField;
+               UtlString cseqMethod;
+               UtlString field;
+               int cseq;
+               msg.getCallIdField(&callId);
+               msg.getCSeqField(&cseq, &cseqMethod);
+               msg.getViaField(&via, 0);
+               msg.getViaFieldSubField(&viaSubField, 0);
+               msg.getFromField(&field);
+               msg.getToField(&field);
+               msg.getContactField(0, field);
+               msg.getContentLength();
+               msg.getCallIdField(&callId);
+               msg.getCSeqField(&cseq, &cseqMethod);
+               msg.getExpiresField(&cseq);
+               msg.getHeaderValue(0, SIP_RECORD_ROUTE_FIELD);
+               msg.getHeaderValue(0, SIP_ROUTE_FIELD);
+               msg.getHeaderValue(0, SIP_MAX_FORWARDS_FIELD);
+
+               CPPUNIT_ASSERT(!callId.isNull());
+               CPPUNIT_ASSERT(!via.isNull());
+            }
+         }
+         OsDateTime::getCurTime(end);
+
+         OsTime lapse = end - start;
+         printf("parse and access %d messages: %ld.%06ld sec\n",
+                numIterations * numMessages,
+                lapse.seconds(),
+                lapse.usecs());
+      }
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(SipMessageTest);
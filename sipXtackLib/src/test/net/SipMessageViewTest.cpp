@@ -0,0 +1,416 @@
+//
+// Copyright (C) 2026 SIPez LLC.  All rights reserved.
+// Licensed to SIPfoundry under a Contributor Agreement.
+//
+// $$
+///////////////////////////////////////////////////////////////////////////////
+
+#include <sipxunittests.h>
+#include <sipxunit/TestUtilities.h>
+
+#include <os/OsDefs.h>
+#include <os/OsDateTime.h>
+#include <net/SipMessage.h>
+#include <net/SipMessageView.h>
+#include <net/Url.h>
+
+// Typical messages of a call setup and a registration
+static const char* sTestMessages[] =
+{
+   "INVITE sip:bob@biloxi.example.com SIP/2.0\r\n"
+   "Via: SIP/2.0/UDP pc33.atlanta.example.com;branch=z9hG4bKnashds8\r\n"
+   "Max-Forwards: 70\r\n"
+   "To: Bob <sip:bob@biloxi.example.com>\r\n"
+   "From: Alice <sip:alice@atlanta.example.com>;tag=1928301774\r\n"
+   "Call-ID: a84b4c76e66710@pc33.atlanta.example.com\r\n"
+   "CSeq: 314159 INVITE\r\n"
+   "Contact: <sip:alice@pc33.atlanta.example.com>\r\n"
+   "Allow: INVITE, ACK, CANCEL, OPTIONS, BYE, REFER, NOTIFY, MESSAGE, SUBSCRIBE, INFO\r\n"
+   "Supported: replaces, timer\r\n"
+   "User-Agent: sipXtapi\r\n"
+   "Content-Type: application/sdp\r\n"
+   "Content-Length: 162\r\n"
+   "\r\n"
+   "v=0\r\n"
+   "o=alice 2890844526 2890844526 IN IP4 pc33.atlanta.example.com\r\n"
+   "s=-\r\n"
+   "c=IN IP4 pc33.atlanta.example.com\r\n"
+   "t=0 0\r\n"
+   "m=audio 49172 RTP/AVP 0\r\n"
+   "a=rtpmap:0 PCMU/8000\r\n",
+
+   "SIP/2.0 200 OK\r\n"
+   "Via: SIP/2.0/UDP server10.biloxi.example.com;branch=z9hG4bKnashds8;received=192.0.2.3\r\n"
+   "Via: SIP/2.0/UDP bigbox3.site3.atlanta.example.com;branch=z9hG4bK77ef4c2312983.1;received=192.0.2.2\r\n"
+   "Via: SIP/2.0/UDP pc33.atlanta.example.com;branch=z9hG4bK776asdhds;received=192.0.2.1\r\n"
+   "Record-Route: <sip:server10.biloxi.example.com;lr>\r\n"
+   "Record-Route: <sip:bigbox3.site3.atlanta.example.com;lr>\r\n"
+   "To: Bob <sip:bob@biloxi.example.com>;tag=a6c85cf\r\n"
+   "From: Alice <sip:alice@atlanta.example.com>;tag=1928301774\r\n"
+   "Call-ID: a84b4c76e66710@pc33.atlanta.example.com\r\n"
+   "CSeq: 314159 INVITE\r\n"
+   "Contact: <sip:bob@192.0.2.4>\r\n"
+   "Content-Length: 0\r\n"
+   "\r\n",
+
+   "REGISTER sip:registrar.biloxi.example.com SIP/2.0\r\n"
+   "v: SIP/2.0/UDP bobspc.biloxi.example.com:5060;branch=z9hG4bKnashds7,\r\n"
+   " SIP/2.0/UDP relay.biloxi.example.com;branch=z9hG4bK1d32\r\n"
+   "Max-Forwards: 70\r\n"
+   "t: Bob <sip:bob@biloxi.example.com>\r\n"
+   "f: Bob <sip:bob@biloxi.example.com>;tag=456248\r\n"
+   "i: 843817637684230@998sdasdh09\r\n"
+   "CSeq: 1826 REGISTER\r\n"
+   "m: <sip:bob@192.0.2.4>;expires=3600, <sip:bob@192.0.2.5>\r\n"
+   "Expires: 7200\r\n"
+   "Authorization: Digest username=\"bob\", realm=\"biloxi.example.com\", "
+   "nonce=\"dcd98b7102dd2f0e8b11d0f600bfb0c093\", uri=\"sip:biloxi.example.com\", "
+   "response=\"245f23415f11432b3434341c022\"\r\n"
+   "l: 0\r\n"
+   "\r\n"
+};
+static const int sNumTestMessages = sizeof(sTestMessages)/sizeof(sTestMessages[0]);
+
+/**
+ * Unittest for SipMessageView
+ */
+class SipMessageViewTest : public SIPX_UNIT_BASE_CLASS
+{
+      CPPUNIT_TEST_SUITE(SipMessageViewTest);
+      CPPUNIT_TEST(testFirstLine);
+      CPPUNIT_TEST(testHeaderFields);
+      CPPUNIT_TEST(testSubfieldsAndParameters);
+      CPPUNIT_TEST(testManyFields);
+      CPPUNIT_TEST(testIncomplete);
+      CPPUNIT_TEST(testSameAsSipMessage);
+      CPPUNIT_TEST(testParseThroughput);
+      CPPUNIT_TEST_SUITE_END();
+
+      public:
+
+   void testFirstLine()
+      {
+         SipMessageView request(sTestMessages[0], strlen(sTestMessages[0]));
+         UtlString part;
+
+         CPPUNIT_ASSERT(request.isValid());
+         CPPUNIT_ASSERT(!request.isResponse());
+         CPPUNIT_ASSERT_EQUAL(-1, request.getResponseStatusCode());
+         CPPUNIT_ASSERT(request.getFirstHeaderLinePart(0).equals("INVITE"));
+         request.getFirstHeaderLinePart(1).toString(part);
+         ASSERT_STR_EQUAL("sip:bob@biloxi.example.com", part.data());
+         CPPUNIT_ASSERT(request.getFirstHeaderLinePart(2).equals("SIP/2.0"));
+
+         const char* responseBytes =
+            "SIP/2.0 486 Busy Here  \n"
+            "Call-ID: 1234\n"
+            "\n";
+         SipMessageView response(responseBytes, strlen(responseBytes));
+         CPPUNIT_ASSERT(response.isValid());
+         CPPUNIT_ASSERT(response.isResponse());
+         CPPUNIT_ASSERT_EQUAL(486, response.getResponseStatusCode());
+         CPPUNIT_ASSERT(response.getFirstHeaderLinePart(2).equals("Busy Here"));
+         CPPUNIT_ASSERT_EQUAL((int)strlen(responseBytes),
+                              response.getHeaderLength());
+      }
+
+   void testHeaderFields()
+      {
+         const char* messageBytes =
+            "OPTIONS sip:carol@chicago.example.com SIP/2.0\r\n"
+            "Subject:   lunch  \r\n"
+            "X-Folded: first,\r\n"
+            "\tsecond\r\n"
+            "  , third\r\n"
+            "CONTENT-length : 4\r\n"
+            "i:abc@host\r\n"
+            "\r\n"
+            "bodyand garbage";
+         SipMessageView view(messageBytes, strlen(messageBytes));
+         SipMessageView::Span name;
+         SipMessageView::Span value;
+         UtlString text;
+
+         CPPUNIT_ASSERT(view.isValid());
+         CPPUNIT_ASSERT_EQUAL(4, view.getFieldCount());
+         CPPUNIT_ASSERT(view.getField(0, name, value));
+         CPPUNIT_ASSERT(name.equals("Subject"));
+         CPPUNIT_ASSERT(value.equals("lunch"));
+         CPPUNIT_ASSERT(!view.getField(4, name, value));
+
+         // Spans point into the message buffer
+         CPPUNIT_ASSERT(value.mpStart > messageBytes &&
+                        value.mpStart < messageBytes + strlen(messageBytes));
+
+         // Compact and long names are the same, in any case
+         CPPUNIT_ASSERT(view.getHeaderValue(0, "s", value));
+         CPPUNIT_ASSERT(value.equals("lunch"));
+         CPPUNIT_ASSERT(view.getHeaderValue(0, SIP_CALLID_FIELD, value));
+         CPPUNIT_ASSERT(value.equals("abc@host"));
+         CPPUNIT_ASSERT(view.getHeaderValue(0, "x-folded", text));
+         ASSERT_STR_EQUAL("first,\tsecond  , third", text.data());
+         CPPUNIT_ASSERT(!view.getHeaderValue(1, "X-Folded", value));
+         CPPUNIT_ASSERT(!view.getHeaderValue(0, "X-Fold", value));
+
+         CPPUNIT_ASSERT_EQUAL(4, view.getContentLength());
+         CPPUNIT_ASSERT(view.getBody().equals("body"));
+
+         CPPUNIT_ASSERT(view.getFieldSubfield("X-Folded", 2, value));
+         CPPUNIT_ASSERT(value.equals("third"));
+      }
+
+   void testSubfieldsAndParameters()
+      {
+         const char* messageBytes =
+            "NOTIFY sip:carol@chicago.example.com SIP/2.0\r\n"
+            "Via: SIP/2.0/TCP first.example.com;branch=z9hG4bK1;rport, "
+            "SIP/2.0/UDP second.example.com;received=10.0.0.1;branch=z9hG4bK2\r\n"
+            "Via: SIP/2.0/UDP third.example.com ; branch = z9hG4bK3\r\n"
+            "From: \"Doe, John; Jr.\" <sip:john@example.com;tag=uri>;tag=abc\r\n"
+            "To: sip:carol@chicago.example.com;tag=xyz\r\n"
+            "Contact: <sip:a@example.com>,,<sip:b@example.com;x=1,2>\r\n"
+            "CSeq:  27  NOTIFY\r\n"
+            "\r\n";
+         SipMessageView view(messageBytes, strlen(messageBytes));
+         SipMessageView::Span value;
+         int sequenceNum = 0;
+
+         CPPUNIT_ASSERT(view.getTopViaBranch(value));
+         CPPUNIT_ASSERT(value.equals("z9hG4bK1"));
+         CPPUNIT_ASSERT(view.getHeaderParameter(SIP_VIA_FIELD, 0, "rport", value));
+         CPPUNIT_ASSERT(value.isNull());
+         CPPUNIT_ASSERT(view.getHeaderParameter(SIP_VIA_FIELD, 1, "BRANCH", value));
+         CPPUNIT_ASSERT(value.equals("z9hG4bK2"));
+         CPPUNIT_ASSERT(view.getHeaderParameter(SIP_VIA_FIELD, 2, "branch", value));
+         CPPUNIT_ASSERT(value.equals("z9hG4bK3"));
+         CPPUNIT_ASSERT(!view.getHeaderParameter(SIP_VIA_FIELD, 3, "branch", value));
+         CPPUNIT_ASSERT(!view.getHeaderParameter(SIP_VIA_FIELD, 0, "received", value));
+
+         // Quoted commas and semicolons and URI parameters are skipped
+         CPPUNIT_ASSERT_EQUAL(1, view.getFieldCount(SIP_FROM_FIELD));
+         CPPUNIT_ASSERT(view.getFromTag(value));
+         CPPUNIT_ASSERT(value.equals("abc"));
+         CPPUNIT_ASSERT(view.getToTag(value));
+         CPPUNIT_ASSERT(value.equals("xyz"));
+
+         CPPUNIT_ASSERT(view.getFieldSubfield(SIP_CONTACT_FIELD, 1, value));
+         CPPUNIT_ASSERT(value.equals("<sip:b@example.com;x=1,2>"));
+         CPPUNIT_ASSERT(!view.getFieldSubfield(SIP_CONTACT_FIELD, 2, value));
+
+         CPPUNIT_ASSERT(view.getCSeqField(&sequenceNum, &value));
+         CPPUNIT_ASSERT_EQUAL(27, sequenceNum);
+         CPPUNIT_ASSERT(value.equals("NOTIFY"));
+      }
+
+   void testManyFields()
+      {
+         // More fields than fit in the view itself, parsed twice by the
+         // same view
+         UtlString messageBytes("MESSAGE sip:bob@example.com SIP/2.0\r\n");
+         const int numFields = SIP_MESSAGE_VIEW_INLINE_FIELDS * 3;
+         char line[64];
+         for (int i = 0; i < numFields; i++)
+         {
+            sprintf(line, "X-Field-%d: %d\r\n", i % 5, i);
+            messageBytes.append(line);
+         }
+         messageBytes.append("\r\n");
+
+         SipMessageView view;
+         for (int pass = 0; pass < 2; pass++)
+         {
+            SipMessageView::Span value;
+            UtlString text;
+            CPPUNIT_ASSERT(view.parse(messageBytes.data(), messageBytes.length()));
+            CPPUNIT_ASSERT_EQUAL(numFields, view.getFieldCount());
+            CPPUNIT_ASSERT_EQUAL((numFields + 1) / 5, view.getFieldCount("X-Field-3"));
+            CPPUNIT_ASSERT(view.getHeaderValue(10, "x-field-3", text));
+            ASSERT_STR_EQUAL("53", text.data());
+         }
+
+         CPPUNIT_ASSERT(view.parse(sTestMessages[1], strlen(sTestMessages[1])));
+         CPPUNIT_ASSERT_EQUAL(11, view.getFieldCount());
+      }
+
+   void testIncomplete()
+      {
+         const char* messageBytes =
+            "INVITE sip:bob@biloxi.example.com SIP/2.0\r\n"
+            "Via: SIP/2.0/UDP pc33.atlanta.example.com;branch=z9hG4bKnashds8\r\n"
+            "Call-ID: a84b4c76e66710\r\n";
+         SipMessageView view(messageBytes, strlen(messageBytes));
+         SipMessageView::Span value;
+
+         // The fields found are usable, but the header has no end
+         CPPUNIT_ASSERT(!view.isValid());
+         CPPUNIT_ASSERT(view.getCallIdField(value));
+         CPPUNIT_ASSERT(value.equals("a84b4c76e66710"));
+         CPPUNIT_ASSERT(view.getBody().isNull());
+
+         // Stops at a null character
+         view.parse(messageBytes, strlen(messageBytes) + 100);
+         CPPUNIT_ASSERT_EQUAL((int)strlen(messageBytes), view.getHeaderLength());
+
+         view.parse(NULL, 0);
+         CPPUNIT_ASSERT(!view.isValid());
+         CPPUNIT_ASSERT_EQUAL(0, view.getFieldCount());
+         CPPUNIT_ASSERT(view.getFirstHeaderLinePart(0).isNull());
+      }
+
+   void testSameAsSipMessage()
+      {
+         for (int m = 0; m < sNumTestMessages; m++)
+         {
+            SipMessage message(sTestMessages[m], strlen(sTestMessages[m]));
+            SipMessageView view(sTestMessages[m], strlen(sTestMessages[m]));
+            SipMessageView::Span span;
+            UtlString expected;
+            UtlString actual;
+            int expectedNum;
+            int actualNum;
+
+            CPPUNIT_ASSERT(view.isValid());
+            CPPUNIT_ASSERT_EQUAL(message.isResponse(), view.isResponse());
+
+            message.getCallIdField(&expected);
+            CPPUNIT_ASSERT(view.getCallIdField(span));
+            span.toString(actual);
+            ASSERT_STR_EQUAL(expected.data(), actual.data());
+
+            message.getCSeqField(&expectedNum, &expected);
+            CPPUNIT_ASSERT(view.getCSeqField(&actualNum, &span));
+            span.toString(actual);
+            CPPUNIT_ASSERT_EQUAL(expectedNum, actualNum);
+            ASSERT_STR_EQUAL(expected.data(), actual.data());
+
+            UtlString via;
+            for (int i = 0; message.getViaFieldSubField(&via, i); i++)
+            {
+               // SipMessage does not strip the sub-fields
+               via.strip(UtlString::both);
+               CPPUNIT_ASSERT(view.getFieldSubfield(SIP_VIA_FIELD, i, span));
+               span.toString(actual);
+               ASSERT_STR_EQUAL(via.data(), actual.data());
+
+               SipMessage::getViaTag(via, "branch", expected);
+               CPPUNIT_ASSERT(view.getHeaderParameter(SIP_VIA_FIELD, i,
+                                                      "branch", span));
+               span.toString(actual);
+               ASSERT_STR_EQUAL(expected.data(), actual.data());
+            }
+
+            for (int i = 0;
+                 message.getFieldSubfield(SIP_CONTACT_FIELD, i, &expected);
+                 i++)
+            {
+               expected.strip(UtlString::both);
+               CPPUNIT_ASSERT(view.getFieldSubfield(SIP_CONTACT_FIELD, i, span));
+               span.toString(actual);
+               ASSERT_STR_EQUAL(expected.data(), actual.data());
+            }
+
+            Url fromUrl;
+            message.getFromUrl(fromUrl);
+            fromUrl.getFieldParameter("tag", expected);
+            view.getFromTag(span);
+            span.toString(actual);
+            ASSERT_STR_EQUAL(expected.data(), actual.data());
+
+            Url toUrl;
+            message.getToUrl(toUrl);
+            toUrl.getFieldParameter("tag", expected);
+            view.getToTag(span);
+            span.toString(actual);
+            ASSERT_STR_EQUAL(expected.data(), actual.data());
+
+            CPPUNIT_ASSERT_EQUAL(message.getContentLength(),
+                                 view.getContentLength());
+            const HttpBody* body = message.getBody();
+            CPPUNIT_ASSERT_EQUAL(body ? body->getLength() : 0,
+                                 (int)view.getBody().mLength);
+         }
+      }
+
+   void testParseThroughput()
+      {
+         // Parse messages and get the fields used to dispatch them to a
+         // transaction: Call-ID, CSeq, top Via branch, From and To tags.
+         const int numIterations = 20000;
+         const int numMessages = numIterations * sNumTestMessages;
+         int messageLengths[sNumTestMessages];
+         for (int m = 0; m < sNumTestMessages; m++)
+         {
+            messageLengths[m] = strlen(sTestMessages[m]);
+         }
+
+         OsTime start;
+         OsTime end;
+         OsDateTime::getCurTime(start);
+         for (int i = 0; i < numIterations; i++)
+         {
+            for (int m = 0; m < sNumTestMessages; m++)
+            {
+               SipMessage message(sTestMessages[m], messageLengths[m]);
+               UtlString callId;
+               UtlString method;
+               UtlString via;
+               UtlString branch;
+               UtlString tag;
+               int cseq;
+               Url url;
+
+               message.getCallIdField(&callId);
+               message.getCSeqField(&cseq, &method);
+               message.getViaFieldSubField(&via, 0);
+               SipMessage::getViaTag(via, "branch", branch);
+               message.getFromUrl(url);
+               url.getFieldParameter("tag", tag);
+               message.getToUrl(url);
+               url.getFieldParameter("tag", tag);
+
+               CPPUNIT_ASSERT(!branch.isNull());
+            }
+         }
+         OsDateTime::getCurTime(end);
+         OsTime sipMessageLapse = end - start;
+
+         SipMessageView view;
+         OsDateTime::getCurTime(start);
+         for (int i = 0; i < numIterations; i++)
+         {
+            for (int m = 0; m < sNumTestMessages; m++)
+            {
+               SipMessageView::Span callId;
+               SipMessageView::Span method;
+               SipMessageView::Span branch;
+               SipMessageView::Span tag;
+               int cseq;
+
+               view.parse(sTestMessages[m], messageLengths[m]);
+               view.getCallIdField(callId);
+               view.getCSeqField(&cseq, &method);
+               view.getTopViaBranch(branch);
+               view.getFromTag(tag);
+               view.getToTag(tag);
+
+               CPPUNIT_ASSERT(!branch.isNull());
+            }
+         }
+         OsDateTime::getCurTime(end);
+         OsTime viewLapse = end - start;
+
+         double sipMessageSeconds = sipMessageLapse.seconds() +
+                                    sipMessageLapse.usecs() / 1000000.0;
+         double viewSeconds = viewLapse.seconds() + viewLapse.usecs() / 1000000.0;
+         printf("parse and dispatch %d messages on one thread:\n"
+                "   SipMessage:     %ld.%06ld sec, %.0f msgs/sec\n"
+                "   SipMessageView: %ld.%06ld sec, %.0f msgs/sec\n",
+                numMessages,
+                sipMessageLapse.seconds(), sipMessageLapse.usecs(),
+                sipMessageSeconds > 0 ? numMessages / sipMessageSeconds : 0.0,
+                viewLapse.seconds(), viewLapse.usecs(),
+                viewSeconds > 0 ? numMessages / viewSeconds : 0.0);
+      }
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(SipMessageViewTest);
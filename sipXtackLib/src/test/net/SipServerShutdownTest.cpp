@@ -21,6 +21,8 @@
 #include <net/SipLineMgr.h>
 #include <net/SipRefreshMgr.h>
 #include <net/SipTcpServer.h>
+#include <net/SipUdpServer.h>
+#include <os/OsDatagramSocket.h>
 
 #define SIP_SHUTDOWN_ITERATIONS 3
 
@@ -31,6 +33,7 @@ class SipServerShutdownTest : public SIPX_UNIT_BASE_CLASS
 {
       CPPUNIT_TEST_SUITE(SipServerShutdownTest);
       CPPUNIT_TEST(testTcpShutdown);
+      CPPUNIT_TEST(testUdpReceiversShutdown);
       CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -66,6 +69,63 @@ public:
 
    };
 
+   void testUdpReceiversShutdown()
+   {
+      SipUserAgent sipUA( PORT_NONE
+                         ,PORT_NONE
+                         ,PORT_NONE
+                         ,NULL     // default publicAddress
+                         ,NULL     // default defaultUser
+                         ,"127.0.0.1"     // default defaultSipAddress
+         );
+      // Stray responses, so that nothing is sent back
+      const char* response =
+         "SIP/2.0 200 OK\r\n"
+         "Via: SIP/2.0/UDP 127.0.0.1:5093;branch=z9hG4bK-shutdown\r\n"
+         "To: sip:server@127.0.0.1:5092\r\n"
+         "From: sip:client@127.0.0.1:5093;tag=1\r\n"
+         "Call-ID: shutdown@127.0.0.1\r\n"
+         "CSeq: 1 OPTIONS\r\n"
+         "Content-Length: 0\r\n"
+         "\r\n";
+
+      for (int i=0; i<SIP_SHUTDOWN_ITERATIONS; ++i)
+      {
+         SipUdpServer udpServer(5092, &sipUA, -1, FALSE, "127.0.0.1", 4);
+         udpServer.startListener();
+         CPPUNIT_ASSERT_EQUAL(5092, udpServer.getServerPort("127.0.0.1"));
+
+         // Messages from several sources, spread over the receivers
+         for (int source = 0; source < 8; source++)
+         {
+            OsDatagramSocket sender(5092, "127.0.0.1");
+            CPPUNIT_ASSERT(sender.isOk());
+            for (int n = 0; n < 4; n++)
+            {
+               sender.write(response, (int) strlen(response));
+            }
+         }
+
+#ifdef SIP_UDP_BATCH_READS
+         long wakeups = 0;
+         long packets = 0;
+         int maxPackets = 0;
+         for (int wait = 0; wait < 50 && packets < 32; wait++)
+         {
+            OsTask::delay(100);
+            udpServer.getReceiveStats(wakeups, packets, maxPackets);
+         }
+         CPPUNIT_ASSERT_EQUAL(32L, packets);
+         CPPUNIT_ASSERT(wakeups > 0 && wakeups <= packets);
+         CPPUNIT_ASSERT(maxPackets >= 1 && maxPackets <= 32);
+#else
+         OsTask::delay(1000);
+#endif
+
+         udpServer.shutdownListener();
+      }
+   };
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(SipServerShutdownTest);
@@ -28,6 +28,8 @@
 #endif 
 
 #include <stdlib.h>
+#include <stdio.h>
+#include <ctype.h>
 #ifndef WINCE
 #include <signal.h>
 #endif
@@ -36,10 +38,24 @@
 #include "net/SipSrvLookup.h"
 #include "os/OsSocket.h"
 #include <os/OsSysLog.h>
+#include <os/OsBSem.h>
+#include <os/OsLock.h>
+#include <os/OsMutex.h>
+#include <os/OsTask.h>
+#include <os/OsDatagramSocket.h>
+#include <os/OsDateTime.h>
+#include <os/OsMsgQ.h>
+#include <net/SipMessage.h>
+#include <net/SipMessageEvent.h>
+#include <net/SipUserAgent.h>
 
 // Defines
 #define TEST_PRINT
 
+// Ports of the user agent and of the server it sends to
+#define TRANSACTION_UA_PORT 5094
+#define TRANSACTION_SERVER_PORT 5095
+
 // Expects g++ to have defined TESTDIR as the name of the directory
 // containing sipXtackLib/src/test, so SipSrvLookupTest.cpp can find
 // its auxiliary files.
@@ -55,6 +71,254 @@
 // Get a printable representation of a protocol value.
 const char* printable_proto(OsSocket::IpProtocolSocketType type);
 
+// The stand-in for DNS answers queries from the records of the zone file
+// of the named tests, without a name server.
+#if defined(TESTDIR) && !defined(_WIN32) && !defined(WINCE) && !defined(_VXWORKS)
+#define STAND_IN_DNS
+
+#define STAND_IN_MAX_RECORDS 200
+
+struct StandInRecord
+{
+   char name[64];
+   int type;
+   long ttl;
+   char rdata[128];
+};
+
+static StandInRecord sStandInZone[STAND_IN_MAX_RECORDS];
+static int sStandInZoneSize = 0;
+// Number of queries answered and delay before answering each.
+static int sStandInQueries = 0;
+static int sStandInDelayMs = 0;
+// Resolver timeouts seen by the last query.
+static int sStandInRetrans = 0;
+static int sStandInRetry = 0;
+static OsMutex sStandInMutex(OsMutex::Q_FIFO);
+
+// Read the records of the zone file.  Only the record types used by the
+// tests are read, and names are relative to the root.
+static UtlBoolean standInLoadZone(const char* fileName)
+{
+   FILE* f = fopen(fileName, "r");
+   if (f == NULL)
+   {
+      return FALSE;
+   }
+
+   char line[256];
+   sStandInZoneSize = 0;
+   while (fgets(line, sizeof (line), f) && sStandInZoneSize < STAND_IN_MAX_RECORDS)
+   {
+      char name[64];
+      char ttl[16];
+      char rclass[8];
+      char type[16];
+      int rdataStart;
+      if (sscanf(line, "%63s %15s %7s %15s %n", name, ttl, rclass, type,
+                 &rdataStart) != 4 ||
+          line[0] == ';' || line[0] == '$' || isspace(line[0]) ||
+          strcmp(rclass, "IN") != 0)
+      {
+         continue;
+      }
+
+      StandInRecord& record = sStandInZone[sStandInZoneSize];
+      if (strcmp(type, "A") == 0)
+      {
+         record.type = T_A;
+      }
+      else if (strcmp(type, "CNAME") == 0)
+      {
+         record.type = T_CNAME;
+      }
+      else if (strcmp(type, "SRV") == 0)
+      {
+         record.type = T_SRV;
+      }
+      else
+      {
+         continue;
+      }
+
+      strcpy(record.name, name);
+      record.ttl = atol(ttl) * (strchr(ttl, 'D') ? 86400 :
+                                strchr(ttl, 'H') ? 3600 : 1);
+      strncpy(record.rdata, line + rdataStart, sizeof (record.rdata) - 1);
+      record.rdata[sizeof (record.rdata) - 1] = '\0';
+      // Remove the line end and any trailing dot of a target name.
+      for (char* end = record.rdata + strlen(record.rdata) - 1;
+           end >= record.rdata && (isspace(*end) || *end == '.');
+           end--)
+      {
+         *end = '\0';
+      }
+      sStandInZoneSize++;
+   }
+
+   fclose(f);
+   return sStandInZoneSize > 0;
+}
+
+static unsigned char* standInPutShort(unsigned char* p, int value)
+{
+   p[0] = (value >> 8) & 0xFF;
+   p[1] = value & 0xFF;
+   return p + 2;
+}
+
+static unsigned char* standInPutLong(unsigned char* p, long value)
+{
+   p = standInPutShort(p, (value >> 16) & 0xFFFF);
+   return standInPutShort(p, value & 0xFFFF);
+}
+
+static unsigned char* standInPutName(unsigned char* p, const char* name)
+{
+   while (*name)
+   {
+      const char* dot = strchr(name, '.');
+      int length = dot ? dot - name : strlen(name);
+      *p++ = length;
+      memcpy(p, name, length);
+      p += length;
+      name += dot ? length + 1 : length;
+   }
+   *p++ = 0;
+   return p;
+}
+
+static unsigned char* standInPutRecord(unsigned char* p,
+                                       const StandInRecord& record)
+{
+   p = standInPutName(p, record.name);
+   p = standInPutShort(p, record.type);
+   p = standInPutShort(p, C_IN);
+   p = standInPutLong(p, record.ttl);
+   unsigned char* rdlength = p;
+   p += 2;
+   unsigned char* rdata = p;
+
+   if (record.type == T_A)
+   {
+      struct in_addr address;
+      inet_aton(record.rdata, &address);
+      memcpy(p, &address, 4);
+      p += 4;
+   }
+   else if (record.type == T_CNAME)
+   {
+      p = standInPutName(p, record.rdata);
+   }
+   else if (record.type == T_SRV)
+   {
+      int priority, weight, port;
+      char target[64];
+      sscanf(record.rdata, "%d %d %d %63s", &priority, &weight, &port, target);
+      p = standInPutShort(p, priority);
+      p = standInPutShort(p, weight);
+      p = standInPutShort(p, port);
+      p = standInPutName(p, target);
+   }
+
+   standInPutShort(rdlength, p - rdata);
+   return p;
+}
+
+// Answer a query as the name server of the zone would, in place of
+// res_query().
+static int standInResQuery(const char* name, int rclass, int type,
+                           unsigned char* answer, int answerSize)
+{
+   {
+      OsLock lock(sStandInMutex);
+      sStandInQueries++;
+      sStandInRetrans = _res.retrans;
+      sStandInRetry = _res.retry;
+   }
+   if (sStandInDelayMs > 0)
+   {
+      OsTask::delay(sStandInDelayMs);
+   }
+
+   HEADER* header = (HEADER*) answer;
+   memset(header, 0, sizeof (HEADER));
+   header->qr = 1;
+   header->aa = 1;
+   header->qdcount = htons(1);
+   unsigned char* p = answer + sizeof (HEADER);
+   p = standInPutName(p, name);
+   p = standInPutShort(p, type);
+   p = standInPutShort(p, rclass);
+
+   // The RRs of the type, or else a CNAME for the name
+   int ancount = 0;
+   UtlBoolean nameFound = FALSE;
+   for (int pass = 0; pass < 2 && ancount == 0; pass++)
+   {
+      for (int i = 0; i < sStandInZoneSize; i++)
+      {
+         if (strcasecmp(sStandInZone[i].name, name) == 0)
+         {
+            nameFound = TRUE;
+            if (sStandInZone[i].type == (pass == 0 ? type : T_CNAME))
+            {
+               p = standInPutRecord(p, sStandInZone[i]);
+               ancount++;
+            }
+         }
+      }
+   }
+   header->ancount = htons(ancount);
+   if (ancount > 0)
+   {
+      return p - answer;
+   }
+
+   // A negative answer has the SOA of the zone
+   header->rcode = nameFound ? NOERROR : NXDOMAIN;
+   header->nscount = htons(1);
+   p = standInPutName(p, "");
+   p = standInPutShort(p, T_SOA);
+   p = standInPutShort(p, C_IN);
+   p = standInPutLong(p, 86400);
+   unsigned char* rdlength = p;
+   p += 2;
+   unsigned char* rdata = p;
+   p = standInPutName(p, "");
+   p = standInPutName(p, "worley.ariadne.com");
+   p = standInPutLong(p, 2005060702);
+   p = standInPutLong(p, 86400);
+   p = standInPutLong(p, 3600);
+   p = standInPutLong(p, 604800);
+   p = standInPutLong(p, 86400);
+   standInPutShort(rdlength, p - rdata);
+
+   return -1;
+}
+
+static int standInQueries()
+{
+   OsLock lock(sStandInMutex);
+   return sStandInQueries;
+}
+
+// Result of an asynchronous lookup.
+struct AsyncResult
+{
+   server_t* servers;
+   OsBSem* done;
+};
+
+static void asyncLookupDone(server_t* servers, void* userData)
+{
+   AsyncResult* result = (AsyncResult*) userData;
+   result->servers = servers;
+   result->done->release();
+}
+
+#endif /* STAND_IN_DNS */
+
 /**
  * Unit test for SipSrvLookup
  */
@@ -63,11 +327,299 @@ class SipSrvLookupTest : public SIPX_UNIT_BASE_CLASS
    CPPUNIT_TEST_SUITE(SipSrvLookupTest);
 #ifndef WIN32
     CPPUNIT_TEST(lookup);
+#endif
+#ifdef STAND_IN_DNS
+    CPPUNIT_TEST(standInLookup);
+    CPPUNIT_TEST(cache);
+    CPPUNIT_TEST(asyncLookup);
+    CPPUNIT_TEST(asyncTimeouts);
+    CPPUNIT_TEST(transactionLookup);
 #endif
    CPPUNIT_TEST_SUITE_END();
 
 public:
 
+#ifdef STAND_IN_DNS
+   void setUp()
+   {
+      CPPUNIT_ASSERT(standInLoadZone(TESTDIR "/SipSrvLookupTest.named.zone"));
+      SipSrvLookup::setResQueryFunction(standInResQuery);
+      SipSrvLookup::setOption(SipSrvLookup::OptionCodeSortAnswers, 1);
+      SipSrvLookup::clearCache();
+      sStandInDelayMs = 0;
+   }
+
+   void tearDown()
+   {
+      SipSrvLookup::destroyLookupTask();
+      SipSrvLookup::setResQueryFunction(NULL);
+      SipSrvLookup::setOption(SipSrvLookup::OptionCodeSortAnswers, 0);
+      SipSrvLookup::setOption(SipSrvLookup::OptionCodeIgnoreCache, 0);
+      SipSrvLookup::setOption(SipSrvLookup::OptionCodeCacheMaxTTL, 3600);
+      SipSrvLookup::clearCache();
+   }
+
+   // Results of servers() in the format of the lookup test:
+   // "IP:port,weight,score,priority,proto\n" for each result.
+   void serversString(server_t* list, UtlString& result)
+   {
+      char entry[100];
+      result.remove(0);
+      for (server_t* q = list; q->isValidServerT(); q++)
+      {
+         UtlString ip_addr;
+         q->getIpAddressFromServerT(ip_addr);
+         sprintf(entry, "%s:%d,%u,%u,%s\n",
+                 ip_addr.data(),
+                 q->getPortFromServerT(),
+                 q->getWeightFromServerT(),
+                 q->getPriorityFromServerT(),
+                 printable_proto(q->getProtocolFromServerT()));
+         result.append(entry);
+      }
+   }
+
+   void lookupString(const char* name, int port, UtlString& result)
+   {
+      srand(1);
+      server_t* list = SipSrvLookup::servers(name, "sip", OsSocket::UNKNOWN,
+                                             port, NULL);
+      serversString(list, result);
+      delete[] list;
+   }
+
+   void standInLookup()
+   {
+      UtlString result;
+
+      // Some cases of the lookup test, without named.
+      lookupString("test2", -1, result);
+      ASSERT_STR_EQUAL("1.2.1.0:5060,0,0,UDP\n"
+                       "1.2.1.0:5060,0,0,TCP\n", result.data());
+      lookupString("test3", 103, result);
+      ASSERT_STR_EQUAL("1.3.1.0:103,0,0,UDP\n"
+                       "1.3.1.1:103,0,0,UDP\n"
+                       "1.3.1.0:103,0,0,TCP\n"
+                       "1.3.1.1:103,0,0,TCP\n", result.data());
+      lookupString("test4", -1, result);
+      ASSERT_STR_EQUAL("2.1.4.0:5060,1,1,UDP\n", result.data());
+      lookupString("test12", -1, result);
+      ASSERT_STR_EQUAL("2.1.6.0:666,1,1,UDP\n"
+                       "2.1.6.1:667,1,1,TCP\n", result.data());
+      // CNAMEs are followed
+      lookupString("c3.test25", -1, result);
+      ASSERT_STR_EQUAL("1.25.1.0:5060,0,0,UDP\n"
+                       "1.25.1.0:5060,0,0,TCP\n", result.data());
+      lookupString("test26", -1, result);
+      ASSERT_STR_EQUAL("1.25.1.0:5060,1,1,UDP\n", result.data());
+      // No such name
+      lookupString("nonexistent", -1, result);
+      ASSERT_STR_EQUAL("", result.data());
+   }
+
+   void cache()
+   {
+      UtlString first;
+      UtlString result;
+
+      // The second lookup is answered from the cache.
+      int queries = standInQueries();
+      lookupString("test6", -1, first);
+      int lookupQueries = standInQueries() - queries;
+      CPPUNIT_ASSERT(lookupQueries > 0);
+      lookupString("test6", -1, result);
+      ASSERT_STR_EQUAL(first.data(), result.data());
+      CPPUNIT_ASSERT_EQUAL(queries + lookupQueries, standInQueries());
+
+      // Negative answers are cached too.
+      lookupString("nonexistent", -1, result);
+      queries = standInQueries();
+      lookupString("nonexistent", -1, result);
+      ASSERT_STR_EQUAL("", result.data());
+      CPPUNIT_ASSERT_EQUAL(queries, standInQueries());
+
+      // The cache can be bypassed and cleared.
+      SipSrvLookup::setOption(SipSrvLookup::OptionCodeIgnoreCache, 1);
+      lookupString("test6", -1, result);
+      CPPUNIT_ASSERT_EQUAL(queries + lookupQueries, standInQueries());
+      SipSrvLookup::setOption(SipSrvLookup::OptionCodeIgnoreCache, 0);
+      SipSrvLookup::clearCache();
+      lookupString("test6", -1, result);
+      ASSERT_STR_EQUAL(first.data(), result.data());
+      CPPUNIT_ASSERT_EQUAL(queries + 2 * lookupQueries, standInQueries());
+
+      // Answers expire after their TTL, limited by OptionCodeCacheMaxTTL.
+      SipSrvLookup::setOption(SipSrvLookup::OptionCodeCacheMaxTTL, 1);
+      SipSrvLookup::clearCache();
+      queries = standInQueries();
+      lookupString("test6", -1, result);
+      lookupString("nonexistent", -1, result);
+      int expiringQueries = standInQueries() - queries;
+      lookupString("test6", -1, result);
+      lookupString("nonexistent", -1, result);
+      CPPUNIT_ASSERT_EQUAL(queries + expiringQueries, standInQueries());
+      OsTask::delay(2100);
+      lookupString("test6", -1, result);
+      lookupString("nonexistent", -1, result);
+      CPPUNIT_ASSERT_EQUAL(queries + 2 * expiringQueries, standInQueries());
+   }
+
+   void asyncLookup()
+   {
+      const int numLookups = 5;
+      OsBSem done(OsBSem::Q_FIFO, OsBSem::EMPTY);
+      AsyncResult results[numLookups];
+      UtlString expected;
+      UtlString result;
+
+      // Find how many queries a lookup takes.
+      int queries = standInQueries();
+      lookupString("test20", -1, expected);
+      int lookupQueries = standInQueries() - queries;
+      SipSrvLookup::clearCache();
+
+      // With a slow DNS, the same lookup asked for by several callers and
+      // by another thread is done once.
+      sStandInDelayMs = 100;
+      queries = standInQueries();
+      for (int i = 0; i < numLookups; i++)
+      {
+         results[i].servers = NULL;
+         results[i].done = &done;
+         SipSrvLookup::serversAsync("test20", "sip", OsSocket::UNKNOWN, -1,
+                                    NULL, asyncLookupDone, &results[i]);
+      }
+      // Wait for the lookup task to start the first query
+      OsTask::delay(50);
+      lookupString("test20", -1, result);
+      ASSERT_STR_EQUAL(expected.data(), result.data());
+
+      for (int i = 0; i < numLookups; i++)
+      {
+         CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, done.acquire(OsTime(10, 0)));
+      }
+      CPPUNIT_ASSERT_EQUAL(queries + lookupQueries, standInQueries());
+
+      for (int i = 0; i < numLookups; i++)
+      {
+         CPPUNIT_ASSERT(results[i].servers != NULL);
+         serversString(results[i].servers, result);
+         ASSERT_STR_EQUAL(expected.data(), result.data());
+         // Every caller has its own copy
+         for (int j = 0; j < i; j++)
+         {
+            CPPUNIT_ASSERT(results[i].servers != results[j].servers);
+         }
+         delete[] results[i].servers;
+      }
+   }
+
+   void asyncTimeouts()
+   {
+      OsBSem done(OsBSem::Q_FIFO, OsBSem::EMPTY);
+      AsyncResult asyncResult;
+      int initialTimeout;
+      int retries;
+
+      // The timeouts set on this thread apply to the lookup task too.
+      SipSrvLookup::getDnsSrvTimeouts(initialTimeout, retries);
+      SipSrvLookup::setDnsSrvTimeouts(initialTimeout + 2, retries + 3);
+
+      asyncResult.servers = NULL;
+      asyncResult.done = &done;
+      SipSrvLookup::serversAsync("test20", "sip", OsSocket::UNKNOWN, -1,
+                                 NULL, asyncLookupDone, &asyncResult);
+      CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, done.acquire(OsTime(10, 0)));
+      CPPUNIT_ASSERT(asyncResult.servers != NULL);
+      delete[] asyncResult.servers;
+      {
+         OsLock lock(sStandInMutex);
+         CPPUNIT_ASSERT_EQUAL(initialTimeout + 2, sStandInRetrans);
+         CPPUNIT_ASSERT_EQUAL(retries + 3, sStandInRetry);
+      }
+
+      SipSrvLookup::setDnsSrvTimeouts(initialTimeout, retries);
+   }
+
+   // Time of send() of a request from the user agent.
+   long sendTimeMs(SipUserAgent& userAgent, const char* requestUri,
+                   const char* callId)
+   {
+      char request[512];
+      sprintf(request,
+              "OPTIONS %s SIP/2.0\r\n"
+              "To: <%s>\r\n"
+              "From: <sip:client@127.0.0.1:%d>;tag=1\r\n"
+              "Call-ID: %s\r\n"
+              "CSeq: 1 OPTIONS\r\n"
+              "Content-Length: 0\r\n"
+              "\r\n",
+              requestUri, requestUri, TRANSACTION_UA_PORT, callId);
+      SipMessage message(request);
+
+      OsTime start;
+      OsTime end;
+      OsDateTime::getCurTime(start);
+      CPPUNIT_ASSERT(userAgent.send(message));
+      OsDateTime::getCurTime(end);
+      return (end - start).cvtToMsecs();
+   }
+
+   void transactionLookup()
+   {
+      // A name for the server the request is sent to.
+      StandInRecord& server = sStandInZone[sStandInZoneSize++];
+      strcpy(server.name, "uaserver");
+      server.type = T_A;
+      server.ttl = 60;
+      strcpy(server.rdata, "127.0.0.1");
+
+      OsDatagramSocket serverSocket(0, NULL, TRANSACTION_SERVER_PORT,
+                                    "127.0.0.1");
+      CPPUNIT_ASSERT(serverSocket.isOk());
+
+      SipUserAgent userAgent(PORT_NONE, TRANSACTION_UA_PORT, PORT_NONE,
+                             NULL, NULL, "127.0.0.1");
+      userAgent.start();
+      OsMsgQ responses;
+      userAgent.addMessageObserver(responses, SIP_OPTIONS_METHOD,
+                                   FALSE, // no requests
+                                   TRUE); // responses
+
+      // The user agent does not wait for the slow DNS.  A name with no
+      // address fails the request once the lookup is done, well before
+      // the transaction expires.
+      sStandInDelayMs = 1000;
+      CPPUNIT_ASSERT(sendTimeMs(userAgent, "sip:server@nonexistent",
+                                "lookup-1") < 500);
+      OsMsg* msg = NULL;
+      CPPUNIT_ASSERT_EQUAL(OS_SUCCESS, responses.receive(msg, OsTime(5, 0)));
+      const SipMessage* response = ((SipMessageEvent*) msg)->getMessage();
+      CPPUNIT_ASSERT(response != NULL);
+      CPPUNIT_ASSERT_EQUAL(SIP_REQUEST_TIMEOUT_CODE,
+                           response->getResponseStatusCode());
+      UtlString callId;
+      response->getCallIdField(&callId);
+      ASSERT_STR_EQUAL("lookup-1", callId.data());
+      msg->releaseMsg();
+
+      // The request goes out once the lookup task has the address.
+      char requestUri[64];
+      sprintf(requestUri, "sip:server@uaserver:%d", TRANSACTION_SERVER_PORT);
+      CPPUNIT_ASSERT(sendTimeMs(userAgent, requestUri, "lookup-2") < 500);
+      CPPUNIT_ASSERT(serverSocket.isReadyToRead(10000));
+      char received[2048];
+      int length = serverSocket.read(received, sizeof(received) - 1);
+      CPPUNIT_ASSERT(length > 0);
+      received[length] = '\0';
+      CPPUNIT_ASSERT(strncmp(received, "OPTIONS ", 8) == 0);
+      CPPUNIT_ASSERT(strstr(received, "lookup-2") != NULL);
+
+      userAgent.removeMessageObserver(responses);
+      userAgent.shutdown(TRUE);
+   }
+#endif /* STAND_IN_DNS */
+
    void lookup()
    {
 #ifdef NAMED_PROGRAM
@@ -20,13 +20,129 @@
 #include <os/OsTimerTask.h>
 #include <os/OsProcess.h>
 #include <os/OsNatAgentTask.h>
+#include <os/OsDateTime.h>
 #include <net/SipMessage.h>
+#include <net/SipTransaction.h>
+#include <net/SipTransactionList.h>
 #include <net/SipUserAgent.h>
 #include <net/SipLineMgr.h>
 #include <net/SipRefreshMgr.h>
 #include <net/SipMessageEvent.h>
 
 #define SHUTDOWN_TEST_ITERATIONS 3
+#define TRANSACTION_LOAD_COUNT 100000
+#define TRANSACTION_LOAD_FORKS 10      // Transactions per Call-ID and CSeq
+#define TRANSACTION_CONCURRENT_TASKS 4
+#define TRANSACTION_CONCURRENT_COUNT 64
+#define TRANSACTION_CONCURRENT_FINDS 2000
+
+// Server transaction which has received its request, as
+// SipTransaction::handleIncoming() leaves it
+class SipUserAgentTestTransaction : public SipTransaction
+{
+public:
+   SipUserAgentTestTransaction(SipMessage& request)
+   : SipTransaction(&request, FALSE, TRUE)
+   {
+      SipMessage* requestCopy = new SipMessage(request);
+      addResponse(requestCopy, FALSE, MESSAGE_REQUEST);
+   }
+};
+
+// Requests from RFC 3261 peers, TRANSACTION_LOAD_FORKS of them with
+// the same Call-ID and CSeq but different branches, as they come to
+// a UA behind a forking proxy.
+static void buildLoadRequest(int index, UtlString& request)
+{
+   char buffer[512];
+   sprintf(buffer,
+           "%s sip:1@192.168.0.6 SIP/2.0\r\n"
+           "Via: SIP/2.0/UDP 10.1.%d.%d:5060;branch=z9hG4bK-load-%d\r\n"
+           "From: <sip:888@10.1.1.144>;tag=load%d\r\n"
+           "To: <sip:1@192.168.0.6>\r\n"
+           "Call-Id: load-%d\r\n"
+           "Cseq: 1 %s\r\n"
+           "Content-Length: 0\r\n"
+           "\r\n",
+           index % 2 ? SIP_OPTIONS_METHOD : SIP_INVITE_METHOD,
+           (index / 250) % 250, index % 250, index,
+           index / TRANSACTION_LOAD_FORKS,
+           index / TRANSACTION_LOAD_FORKS,
+           index % 2 ? SIP_OPTIONS_METHOD : SIP_INVITE_METHOD);
+   request = buffer;
+}
+
+// Finds transactions of a list and checks that nobody else has them
+// until it marks them available again.
+class SipTransactionListTestTask : public OsTask
+{
+public:
+   SipTransactionListTestTask(SipTransactionList& transactionList,
+                              SipTransaction** transactions,
+                              SipTransactionListTestTask* volatile* holders,
+                              int transactionCount,
+                              int seed)
+      : mTransactionList(transactionList)
+      , mpTransactions(transactions)
+      , mpHolders(holders)
+      , mTransactionCount(transactionCount)
+      , mSeed(seed)
+      , mFailures(0)
+   {
+   }
+
+   ~SipTransactionListTestTask()
+   {
+      waitUntilShutDown();
+   }
+
+   UtlBoolean waitUntilShutDown()
+   {
+      return OsTask::waitUntilShutDown();
+   }
+
+   int run(void* pArg)
+   {
+      UtlString requestText;
+      for (int i = 0; i < TRANSACTION_CONCURRENT_FINDS; i++)
+      {
+         int index = (i * 7 + mSeed) % mTransactionCount;
+         buildLoadRequest(index, requestText);
+         SipMessage retransmission(requestText.data(), requestText.length());
+         enum SipTransaction::messageRelationship relationship;
+         SipTransaction* transaction =
+            mTransactionList.findTransactionFor(retransmission, FALSE,
+                                                relationship);
+         if (transaction != mpTransactions[index])
+         {
+            mFailures++;
+            continue;
+         }
+
+         if (mpHolders[index] != NULL)
+         {
+            mFailures++;
+         }
+         mpHolders[index] = this;
+         OsTask::yield();
+         if (mpHolders[index] != this)
+         {
+            mFailures++;
+         }
+         mpHolders[index] = NULL;
+
+         mTransactionList.markAvailable(*transaction);
+      }
+      return 0;
+   }
+
+   SipTransactionList& mTransactionList;
+   SipTransaction** mpTransactions;
+   SipTransactionListTestTask* volatile* mpHolders;
+   int mTransactionCount;
+   int mSeed;
+   int mFailures;
+};
 
 /**
  * Unittest for SipUserAgent
@@ -37,6 +153,8 @@ class SipUserAgentTest : public SIPX_UNIT_BASE_CLASS
       CPPUNIT_TEST(testRefreshMgrTimeouts);
       CPPUNIT_TEST(testShutdownBlocking);
       CPPUNIT_TEST(testShutdownNonBlocking);
+      CPPUNIT_TEST(testTransactionListLoad);
+      CPPUNIT_TEST(testTransactionListConcurrency);
       CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -431,6 +549,172 @@ public:
       }
    };
 
+   void testTransactionListLoad()
+   {
+      SipTransactionList transactionList;
+      SipTransaction** transactions = new SipTransaction*[TRANSACTION_LOAD_COUNT];
+      UtlString requestText;
+      OsTime start;
+      OsTime end;
+      int index;
+
+      OsDateTime::getCurTimeSinceBoot(start);
+      for(index = 0; index < TRANSACTION_LOAD_COUNT; index++)
+      {
+         buildLoadRequest(index, requestText);
+         SipMessage request(requestText.data(), requestText.length());
+         transactions[index] = new SipUserAgentTestTransaction(request);
+         transactionList.addTransaction(transactions[index]);
+      }
+      OsDateTime::getCurTimeSinceBoot(end);
+      printf("added %d transactions in %ld ms\n", TRANSACTION_LOAD_COUNT,
+             (end - start).cvtToMsecs());
+      CPPUNIT_ASSERT_EQUAL(TRANSACTION_LOAD_COUNT,
+                           transactionList.getTransactionCount());
+
+      // Every retransmission finds its own transaction
+      OsDateTime::getCurTimeSinceBoot(start);
+      for(index = 0; index < TRANSACTION_LOAD_COUNT; index++)
+      {
+         buildLoadRequest(index, requestText);
+         SipMessage retransmission(requestText.data(), requestText.length());
+         enum SipTransaction::messageRelationship relationship;
+         SipTransaction* transaction =
+            transactionList.findTransactionFor(retransmission, FALSE,
+                                               relationship);
+         CPPUNIT_ASSERT(transaction == transactions[index]);
+         CPPUNIT_ASSERT_EQUAL(SipTransaction::MESSAGE_DUPLICATE, relationship);
+         transactionList.markAvailable(*transaction);
+      }
+      OsDateTime::getCurTimeSinceBoot(end);
+      printf("found %d transactions in %ld ms\n", TRANSACTION_LOAD_COUNT,
+             (end - start).cvtToMsecs());
+
+      // A response from this UA is part of the server transaction
+      {
+         buildLoadRequest(4, requestText);
+         SipMessage request(requestText.data(), requestText.length());
+         SipMessage response;
+         response.setOkResponseData(&request);
+         enum SipTransaction::messageRelationship relationship;
+         SipTransaction* transaction =
+            transactionList.findTransactionFor(response, TRUE, relationship);
+         CPPUNIT_ASSERT(transaction == transactions[4]);
+         CPPUNIT_ASSERT_EQUAL(SipTransaction::MESSAGE_FINAL, relationship);
+         transactionList.markAvailable(*transaction);
+      }
+
+      // The same branch from another sent-by is another transaction
+      {
+         buildLoadRequest(5, requestText);
+         requestText.replace(requestText.index("10.1.0.5"), 8, "10.2.0.5");
+         SipMessage request(requestText.data(), requestText.length());
+         UtlString requestKey;
+         CPPUNIT_ASSERT(SipTransaction::buildBranchKey(request, FALSE,
+                                                       requestKey));
+         CPPUNIT_ASSERT(requestKey.compareTo(transactions[5]->getBranchKey()) != 0);
+      }
+
+      // Nothing has expired yet and garbage collection looks at nothing
+      OsDateTime::getCurTimeSinceBoot(start);
+      transactionList.removeOldTransactions(start.seconds() - 60,
+                                            start.seconds() - 180);
+      OsDateTime::getCurTimeSinceBoot(end);
+      printf("garbage collected %d live transactions in %ld ms\n",
+             TRANSACTION_LOAD_COUNT, (end - start).cvtToMsecs());
+      CPPUNIT_ASSERT_EQUAL(TRANSACTION_LOAD_COUNT,
+                           transactionList.getTransactionCount());
+
+      // Only the non-INVITE transactions expire, except the busy one
+      enum SipTransaction::messageRelationship busyRelationship;
+      buildLoadRequest(1, requestText);
+      SipMessage busyRequest(requestText.data(), requestText.length());
+      SipTransaction* busyTransaction =
+         transactionList.findTransactionFor(busyRequest, FALSE,
+                                            busyRelationship);
+      CPPUNIT_ASSERT(busyTransaction == transactions[1]);
+
+      OsDateTime::getCurTimeSinceBoot(start);
+      transactionList.removeOldTransactions(start.seconds() + 1,
+                                            start.seconds() - 180);
+      CPPUNIT_ASSERT_EQUAL(TRANSACTION_LOAD_COUNT / 2 + 1,
+                           transactionList.getTransactionCount());
+
+      {
+         // The rest of the transactions are still found
+         buildLoadRequest(2, requestText);
+         SipMessage retransmission(requestText.data(), requestText.length());
+         enum SipTransaction::messageRelationship relationship;
+         SipTransaction* transaction =
+            transactionList.findTransactionFor(retransmission, FALSE,
+                                               relationship);
+         CPPUNIT_ASSERT(transaction == transactions[2]);
+         transactionList.markAvailable(*transaction);
+
+         buildLoadRequest(3, requestText);
+         SipMessage removedRetransmission(requestText.data(),
+                                          requestText.length());
+         transaction =
+            transactionList.findTransactionFor(removedRetransmission, FALSE,
+                                               relationship);
+         CPPUNIT_ASSERT(transaction == NULL);
+      }
+
+      // All expire once the busy one is available
+      transactionList.markAvailable(*busyTransaction);
+      OsDateTime::getCurTimeSinceBoot(end);
+      transactionList.removeOldTransactions(end.seconds() + 1,
+                                            end.seconds() + 1);
+      CPPUNIT_ASSERT_EQUAL(0, transactionList.getTransactionCount());
+
+      delete[] transactions;
+   }
+
+   // Tasks find the same transactions at the same time, only one of
+   // them has a transaction until it marks it available again.
+   void testTransactionListConcurrency()
+   {
+      SipTransactionList transactionList;
+      SipTransaction* transactions[TRANSACTION_CONCURRENT_COUNT];
+      SipTransactionListTestTask* volatile holders[TRANSACTION_CONCURRENT_COUNT];
+      UtlString requestText;
+      int index;
+
+      for(index = 0; index < TRANSACTION_CONCURRENT_COUNT; index++)
+      {
+         buildLoadRequest(index, requestText);
+         SipMessage request(requestText.data(), requestText.length());
+         transactions[index] = new SipUserAgentTestTransaction(request);
+         transactionList.addTransaction(transactions[index]);
+         holders[index] = NULL;
+      }
+
+      SipTransactionListTestTask* tasks[TRANSACTION_CONCURRENT_TASKS];
+      for(index = 0; index < TRANSACTION_CONCURRENT_TASKS; index++)
+      {
+         tasks[index] = new SipTransactionListTestTask(transactionList,
+                                                       transactions,
+                                                       holders,
+                                                       TRANSACTION_CONCURRENT_COUNT,
+                                                       index);
+         tasks[index]->start();
+      }
+
+      for(index = 0; index < TRANSACTION_CONCURRENT_TASKS; index++)
+      {
+         tasks[index]->waitUntilShutDown();
+         CPPUNIT_ASSERT_EQUAL(0, tasks[index]->mFailures);
+         delete tasks[index];
+      }
+
+      // Nothing is left busy
+      OsTime now;
+      OsDateTime::getCurTimeSinceBoot(now);
+      transactionList.removeOldTransactions(now.seconds() + 1,
+                                            now.seconds() + 1);
+      CPPUNIT_ASSERT_EQUAL(0, transactionList.getTransactionCount());
+   }
+
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(SipUserAgentTest);
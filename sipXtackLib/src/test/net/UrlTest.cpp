@@ -20,6 +20,7 @@
 #include <utl/UtlTokenizer.h>
 
 #include "os/OsTimeLog.h"
+#include "os/OsDateTime.h"
 
 #define MISSING_PARAM  "---missing---"
 
@@ -114,6 +115,8 @@ class UrlTest : public SIPX_UNIT_BASE_CLASS
     CPPUNIT_TEST(testBigUriUser);
     CPPUNIT_TEST(testBigUriNoSchemeUser);
     CPPUNIT_TEST(testBigUriHost);
+    CPPUNIT_TEST(testFastParseDifferential);
+    CPPUNIT_TEST(testFastParseThroughput);
     CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -1772,6 +1775,190 @@ public:
          printf("Finish testBigUriHost\n");
       }
 
+    /*
+     * Url::parseString scans the common forms of sip: URLs itself and uses
+     * the regular expressions for everything else.  The scanner must give
+     * exactly the same components as the regular expressions, so parse
+     * random strings made of URL pieces and stray characters both ways.
+     */
+    void assertSameParse(const char* urlString, UtlBoolean isAddrSpec)
+    {
+        Url::setFastParse(TRUE);
+        Url fast(urlString, isAddrSpec);
+        Url::setFastParse(FALSE);
+        Url regex(urlString, isAddrSpec);
+        Url::setFastParse(TRUE);
+
+        char msg[1024];
+        snprintf(msg, sizeof(msg), "'%s' isAddrSpec=%d", urlString, isAddrSpec);
+
+        UtlString fastValue;
+        UtlString regexValue;
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(msg, (int) regex.getScheme(), (int) fast.getScheme());
+        regex.getDisplayName(regexValue);
+        fast.getDisplayName(fastValue);
+        ASSERT_STR_EQUAL_MESSAGE(msg, regexValue.data(), fastValue.data());
+        regex.getUserId(regexValue);
+        fast.getUserId(fastValue);
+        ASSERT_STR_EQUAL_MESSAGE(msg, regexValue.data(), fastValue.data());
+        regex.getPassword(regexValue);
+        fast.getPassword(fastValue);
+        ASSERT_STR_EQUAL_MESSAGE(msg, regexValue.data(), fastValue.data());
+        regex.getHostAddress(regexValue);
+        fast.getHostAddress(fastValue);
+        ASSERT_STR_EQUAL_MESSAGE(msg, regexValue.data(), fastValue.data());
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(msg, regex.getHostPort(), fast.getHostPort());
+        regex.toString(regexValue);
+        fast.toString(fastValue);
+        ASSERT_STR_EQUAL_MESSAGE(msg, regexValue.data(), fastValue.data());
+
+        UtlString names[10];
+        UtlString values[10];
+        int regexCount;
+        int fastCount;
+        regex.getUrlParameters(10, names, values, regexCount);
+        fast.getUrlParameters(10, names, values, fastCount);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(msg, regexCount, fastCount);
+        regex.getHeaderParameters(10, names, values, regexCount);
+        fast.getHeaderParameters(10, names, values, fastCount);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(msg, regexCount, fastCount);
+        regex.getFieldParameters(10, names, values, regexCount);
+        fast.getFieldParameters(10, names, values, fastCount);
+        CPPUNIT_ASSERT_EQUAL_MESSAGE(msg, regexCount, fastCount);
+    }
+
+    void testFastParseDifferential()
+    {
+        static const char* displayNames[] =
+           { "", "", "Display Name ", "Name", "\"Quoted Name\" ", "\"a\\\"b\\\\c\"",
+             "\"\" ", "  tok+en%x ", "\"bad\\q\" ", "\"open " };
+        static const char* opens[] = { "", "<", "<", " <", "< " };
+        static const char* schemes[] =
+           { "", "sip:", "sip:", "sips:", "SIP:", "Sips:", "http://", "tel:",
+             "sip :", "mailto:", "sipx:", ":" };
+        static const char* users[] =
+           { "", "", "user@", "user:pass@", "u%41b@", "u%4@", "a;b=c?d/e@",
+             "+1-555-1234@", "user:@", "us er@", "user:pa;ss@", "@" };
+        static const char* hosts[] =
+           { "example.com", "example.com", "10.1.2.3", "[::1]", "[fe80::1:2]",
+             "a-b.c.", "host-", "h..x", "", "-bad", "ex_ample.com", "a.b-.c",
+             "[]", "[::1", "1.2.3.4.5", "EXAMPLE.COM." };
+        static const char* ports[] =
+           { "", "", ":5060", ":", ":1234567", ":x", ":0" };
+        static const char* urlParams[] =
+           { "", "", ";transport=tcp", ";lr", ";", " ;x=y", ";a=b;c",
+             ";maddr=1.2.3.4;ttl=5" };
+        static const char* headerParams[] =
+           { "", "", "?h=v", "?", "?a=b&c=d", " ?x=y" };
+        static const char* closes[] = { "", ">", ">", " >" };
+        static const char* fieldParams[] =
+           { "", "", ";tag=abc", " ;tag=1", ";", ";a=b;c=d", "  ", ";q=0.5;expires=60" };
+        static const char strayChars[] = " \t<>\"@:;?=%.[]\\-+#&\r\n\v/";
+
+#define PICK(array) array[rand() % (sizeof(array) / sizeof(array[0]))]
+
+        srand(1);
+        for (int i = 0; i < 20000; i++)
+        {
+            UtlString urlString;
+            urlString.append(PICK(displayNames));
+            urlString.append(PICK(opens));
+            urlString.append(PICK(schemes));
+            urlString.append(PICK(users));
+            urlString.append(PICK(hosts));
+            urlString.append(PICK(ports));
+            urlString.append(PICK(urlParams));
+            urlString.append(PICK(headerParams));
+            urlString.append(PICK(closes));
+            urlString.append(PICK(fieldParams));
+
+            // Insert, replace or remove a few characters in half of them
+            for (int mutations = rand() % 6 - 2; mutations > 0; mutations--)
+            {
+                size_t position = rand() % (urlString.length() + 1);
+                char stray[2] = { PICK(strayChars), '\0' };
+                switch (rand() % 3)
+                {
+                case 0:
+                    urlString.insert(position, stray);
+                    break;
+                case 1:
+                    if (position < urlString.length())
+                    {
+                        urlString.replace(position, 1, stray);
+                    }
+                    break;
+                default:
+                    if (position < urlString.length())
+                    {
+                        urlString.remove(position, 1);
+                    }
+                    break;
+                }
+            }
+
+            assertSameParse(urlString.data(), FALSE);
+            assertSameParse(urlString.data(), TRUE);
+        }
+#undef PICK
+
+        // Long names around the length the scanner gives up at
+        UtlString longName("sip:user@");
+        while (longName.length() < 300)
+        {
+            longName.append("a.");
+            assertSameParse(longName.data(), FALSE);
+            longName.append("b-1");
+            assertSameParse(longName.data(), TRUE);
+        }
+    }
+
+    void testFastParseThroughput()
+    {
+        static const char* urls[] =
+        {
+            "\"Alice Smith\" <sip:alice@atlanta.example.com>;tag=1928301774",
+            "Bob <sip:bob@biloxi.example.com:5060>",
+            "<sip:carol@192.0.2.4;transport=tcp>;expires=3600",
+            "sip:bob@biloxi.example.com",
+            "<sip:ss2.biloxi.example.com;lr>"
+        };
+        const int numUrls = sizeof(urls) / sizeof(urls[0]);
+        const int numIterations = 20000;
+        OsTime lapse[2];
+
+        for (int fast = 0; fast < 2; fast++)
+        {
+            Url::setFastParse(fast);
+            OsTime start;
+            OsTime end;
+            OsDateTime::getCurTime(start);
+            for (int i = 0; i < numIterations; i++)
+            {
+                for (int u = 0; u < numUrls; u++)
+                {
+                    Url url(urls[u]);
+                    CPPUNIT_ASSERT(url.getScheme() == Url::SipUrlScheme);
+                }
+            }
+            OsDateTime::getCurTime(end);
+            lapse[fast] = end - start;
+        }
+        Url::setFastParse(TRUE);
+
+        int numParsed = numIterations * numUrls;
+        double regexSeconds = lapse[0].seconds() + lapse[0].usecs() / 1000000.0;
+        double fastSeconds = lapse[1].seconds() + lapse[1].usecs() / 1000000.0;
+        printf("parse %d URLs on one thread:\n"
+               "   regular expressions: %ld.%06ld sec, %.0f urls/sec\n"
+               "   scanner:             %ld.%06ld sec, %.0f urls/sec\n",
+               numParsed,
+               lapse[0].seconds(), lapse[0].usecs(),
+               regexSeconds > 0 ? numParsed / regexSeconds : 0.0,
+               lapse[1].seconds(), lapse[1].usecs(),
+               fastSeconds > 0 ? numParsed / fastSeconds : 0.0);
+    }
+
     /////////////////////////
     // Helper Methods
 